@@ -0,0 +1,61 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/24bits.h"
+
+#if defined(__SSSE3__)
+  #include <tmmintrin.h>
+#endif
+
+namespace base {
+
+void write24bitsBuffer(uint8_t* dst, const uint32_t* src, const size_t n)
+{
+  size_t i = 0;
+
+#if defined(__SSSE3__) && defined(LAF_LITTLE_ENDIAN)
+  // Pack 4 pixels (16 bytes) -> 12 bytes per iteration dropping every
+  // 4th byte. The 16-byte store writes 4 bytes of garbage past the
+  // packed data, so we stop while at least 2 more pixels (6 output
+  // bytes) are pending and let the tail rewrite them.
+  const __m128i mask = _mm_setr_epi8(
+    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  for (; i+6 <= n; i += 4) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)(src+i));
+    _mm_storeu_si128((__m128i*)(dst+3*i), _mm_shuffle_epi8(in, mask));
+  }
+#endif
+
+  for (; i<n; ++i)
+    write24bits(dst+3*i, src[i]);
+}
+
+void read24bitsBuffer(uint32_t* dst, const uint8_t* src, const size_t n)
+{
+  size_t i = 0;
+
+#if defined(__SSSE3__) && defined(LAF_LITTLE_ENDIAN)
+  // Expand 12 bytes -> 4 pixels per iteration (top byte zeroed by
+  // the shuffle). The 16-byte load reads 4 bytes past the consumed
+  // data, so we stop while at least 2 more pixels (6 input bytes)
+  // are pending.
+  const __m128i mask = _mm_setr_epi8(
+    0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  for (; i+6 <= n; i += 4) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)(src+3*i));
+    _mm_storeu_si128((__m128i*)(dst+i), _mm_shuffle_epi8(in, mask));
+  }
+#endif
+
+  for (; i<n; ++i)
+    dst[i] = read24bits(src+3*i);
+}
+
+} // namespace base
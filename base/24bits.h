@@ -11,6 +11,8 @@
 #include "base/config.h"
 #include "base/ints.h"
 
+#include <cstddef>
+
 namespace base {
 
 #ifdef LAF_LITTLE_ENDIAN
@@ -22,6 +24,13 @@ namespace base {
     ((uint8_t*)ptr)[2] = value >> 16;
   }
 
+  template<typename PTR>
+  inline uint32_t read24bits(const PTR* ptr) {
+    return (uint32_t(((const uint8_t*)ptr)[0]) |
+            (uint32_t(((const uint8_t*)ptr)[1]) << 8) |
+            (uint32_t(((const uint8_t*)ptr)[2]) << 16));
+  }
+
 #elif defined(LAF_BIG_ENDIAN)
 
   template<typename PTR, typename VALUE>
@@ -31,8 +40,23 @@ namespace base {
     ((uint8_t*)ptr)[2] = value;
   }
 
+  template<typename PTR>
+  inline uint32_t read24bits(const PTR* ptr) {
+    return ((uint32_t(((const uint8_t*)ptr)[0]) << 16) |
+            (uint32_t(((const uint8_t*)ptr)[1]) << 8) |
+            uint32_t(((const uint8_t*)ptr)[2]));
+  }
+
 #endif
 
+  // Bulk repacking between 32-bit pixels and packed 24-bit data
+  // (e.g. exporting RGB24 frames). SIMD byte shuffles where
+  // available, equivalent to calling write24bits()/read24bits() per
+  // pixel. "dst"/"src" buffers must hold 3*n and 4*n bytes
+  // respectively (and vice versa for reading).
+  void write24bitsBuffer(uint8_t* dst, const uint32_t* src, size_t n);
+  void read24bitsBuffer(uint32_t* dst, const uint8_t* src, size_t n);
+
 } // namespace base
 
 #endif
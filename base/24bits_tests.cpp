@@ -0,0 +1,54 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/24bits.h"
+
+#include <vector>
+
+using namespace base;
+
+TEST(Base24bits, SingleValue)
+{
+  uint8_t buf[3];
+  write24bits(buf, 0x123456);
+  EXPECT_EQ(0x123456, read24bits(buf));
+}
+
+TEST(Base24bits, BufferRoundtrip)
+{
+  // Sizes chosen to hit the SIMD body and the scalar tail (and both
+  // empty and tail-only buffers).
+  for (size_t n : { size_t(0), size_t(1), size_t(5), size_t(6),
+                    size_t(7), size_t(16), size_t(100) }) {
+    std::vector<uint32_t> src(n);
+    for (size_t i=0; i<n; ++i)
+      src[i] = uint32_t(0x010203*i) & 0xffffff;
+
+    std::vector<uint8_t> packed(3*n);
+    write24bitsBuffer(packed.data(), src.data(), n);
+
+    // Byte-compatible with the per-pixel function
+    for (size_t i=0; i<n; ++i) {
+      uint8_t one[3];
+      write24bits(one, src[i]);
+      EXPECT_EQ(one[0], packed[3*i]);
+      EXPECT_EQ(one[1], packed[3*i+1]);
+      EXPECT_EQ(one[2], packed[3*i+2]);
+    }
+
+    std::vector<uint32_t> back(n);
+    read24bitsBuffer(back.data(), packed.data(), n);
+    EXPECT_EQ(src, back);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
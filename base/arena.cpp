@@ -0,0 +1,21 @@
+// LAF Base Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/arena.h"
+
+namespace base {
+
+arena& thread_arena()
+{
+  thread_local arena a;
+  return a;
+}
+
+} // namespace base
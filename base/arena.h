@@ -0,0 +1,135 @@
+// LAF Base Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_ARENA_H_INCLUDED
+#define BASE_ARENA_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "base/memory.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+  // Bump allocator for short-lived objects (region op temporaries,
+  // event objects): alloc() is a pointer increment inside large
+  // blocks, and everything is released at once with reset() (or a
+  // scope, see below) instead of per-object frees. Destructors of
+  // allocated objects are NOT run, so use it for trivially
+  // destructible types or call them yourself.
+  class arena {
+  public:
+    explicit arena(const size_t blockSize = 64*1024)
+      : m_blockSize(blockSize) {
+    }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    void* alloc(const size_t bytes,
+                const size_t alignment = base_alignment) {
+      while (m_current < m_blocks.size()) {
+        block& b = m_blocks[m_current];
+        // Align the absolute address, not just the offset
+        uint8_t* base = b.data.get();
+        const size_t used =
+          align_up(size_t(base) + b.used, alignment) - size_t(base);
+        if (used + bytes <= b.size) {
+          b.used = used + bytes;
+          return base + used;
+        }
+        // The current block is full, try the next one (kept from a
+        // previous reset) or allocate a new one
+        if (++m_current == m_blocks.size())
+          add_block(bytes + alignment);
+      }
+      add_block(bytes + alignment);
+      return alloc(bytes, alignment);
+    }
+
+    // Allocates and constructs an object inside the arena (its
+    // destructor will not be called).
+    template<typename T, typename... Args>
+    T* make(Args&&... args) {
+      return new (alloc(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+    }
+
+    // Releases all the allocations at once. The blocks are kept for
+    // reuse, so a steady-state arena stops hitting the heap at all.
+    void reset() {
+      for (block& b : m_blocks)
+        b.used = 0;
+      m_current = 0;
+    }
+
+    // Bytes currently allocated (without block padding).
+    size_t used() const {
+      size_t total = 0;
+      for (const block& b : m_blocks)
+        total += b.used;
+      return total;
+    }
+
+    // Rewinds the arena to the position it had when the scope was
+    // created, so nested temporary lifetimes can share one arena.
+    class scope {
+    public:
+      explicit scope(arena& a)
+        : m_arena(a)
+        , m_block(a.m_current)
+        , m_used(a.m_current < a.m_blocks.size() ?
+                 a.m_blocks[a.m_current].used: 0) {
+      }
+      ~scope() {
+        for (size_t i=m_block+1; i<m_arena.m_blocks.size(); ++i)
+          m_arena.m_blocks[i].used = 0;
+        if (m_block < m_arena.m_blocks.size())
+          m_arena.m_blocks[m_block].used = m_used;
+        m_arena.m_current = m_block;
+      }
+      scope(const scope&) = delete;
+      scope& operator=(const scope&) = delete;
+    private:
+      arena& m_arena;
+      size_t m_block;
+      size_t m_used;
+    };
+
+  private:
+    struct block {
+      std::unique_ptr<uint8_t[]> data;
+      size_t size = 0;
+      size_t used = 0;
+    };
+
+    static constexpr size_t align_up(const size_t n, const size_t alignment) {
+      return (n + alignment-1) & ~(alignment-1);
+    }
+
+    void add_block(const size_t atLeast) {
+      block b;
+      b.size = (atLeast > m_blockSize ? atLeast: m_blockSize);
+      b.data = std::make_unique<uint8_t[]>(b.size);
+      m_blocks.push_back(std::move(b));
+    }
+
+    size_t m_blockSize;
+    size_t m_current = 0;
+    std::vector<block> m_blocks;
+  };
+
+  // Per-thread arena for transient allocations. Pair it with
+  // arena::scope so each user rewinds what it allocated.
+  arena& thread_arena();
+
+} // namespace base
+
+#endif
@@ -13,7 +13,11 @@
 #include "base/debug.h"
 #include "base/ints.h"
 
-#include <cmath>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define LAF_BASE64_WITH_SIMD 1
+  #include <cpuid.h>
+  #include <immintrin.h>
+#endif
 
 namespace base {
 
@@ -50,59 +54,147 @@ static inline int base64Inv(int asciiChar)
   return 0;
 }
 
+#if LAF_BASE64_WITH_SIMD
+
+static bool base64_simd_supported()
+{
+  static const bool supported = []{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+      return false;
+    return (ecx & (1u << 9)) != 0; // SSSE3 bit
+  }();
+  return supported;
+}
+
+// Encodes 12 input bytes into 16 output chars per iteration (the
+// SSSE3 shuffle/multiply technique from Mula & Lemire, "Faster Base64
+// Encoding and Decoding using AVX2 Instructions"). Returns how many
+// input bytes were consumed (a multiple of 12); the scalar code
+// finishes the tail.
+__attribute__((target("ssse3")))
+static size_t encode_base64_simd(const char* input, size_t n, char* out)
+{
+  const __m128i shiftLUT = _mm_setr_epi8(
+    'a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+    '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '+'-62,
+    '/'-63, 'A', 0, 0);
+
+  size_t i = 0;
+  // Each iteration loads 16 bytes (uses the first 12), so stay 16
+  // bytes inside the input
+  for (; i+16 <= n; i += 12, out += 16) {
+    __m128i in = _mm_loadu_si128((const __m128i*)(input+i));
+
+    // Split the 12 bytes into 16 6-bit indices
+    in = _mm_shuffle_epi8(
+      in, _mm_set_epi8(10,11, 9,10, 7,8, 6,7, 4,5, 3,4, 1,2, 0,1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    // Translate the indices to ASCII with a per-range offset
+    __m128i offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    offsets = _mm_or_si128(offsets, _mm_and_si128(less, _mm_set1_epi8(13)));
+    offsets = _mm_shuffle_epi8(shiftLUT, offsets);
+
+    _mm_storeu_si128((__m128i*)out, _mm_add_epi8(offsets, indices));
+  }
+  return i;
+}
+
+// Decodes 16 input chars into 12 output bytes per iteration. Invalid
+// characters produce garbage (just like the scalar table does), '='
+// padding is left to the scalar tail. Returns how many input chars
+// were consumed (a multiple of 16).
+__attribute__((target("ssse3")))
+static size_t decode_base64_simd(const char* input, size_t n, uint8_t* out)
+{
+  // ASCII -> 6-bit value offset indexed by the character's high nibble
+  const __m128i shiftLUT = _mm_setr_epi8(
+    0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i packLUT = _mm_setr_epi8(
+    2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1);
+
+  size_t i = 0;
+  // Leave at least 8 chars (incl. any '=' padding) to the scalar
+  // loop, and keep the 16-byte output store inside the buffer
+  for (; i+24 <= n; i += 16, out += 12) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)(input+i));
+
+    const __m128i higherNibble =
+      _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+    const __m128i eq2F = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f)); // '/'
+    __m128i values = _mm_add_epi8(in, _mm_shuffle_epi8(shiftLUT, higherNibble));
+    values = _mm_add_epi8(values, _mm_and_si128(eq2F, _mm_set1_epi8(-3)));
+
+    // Pack the 16 6-bit values into 12 bytes
+    const __m128i merged16 = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i merged32 = _mm_madd_epi16(merged16, _mm_set1_epi32(0x00011000));
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(merged32, packLUT));
+  }
+  return i;
+}
+
+#endif // LAF_BASE64_WITH_SIMD
+
 void encode_base64(const char* input, size_t n, std::string& output)
 {
-  const size_t size = 4*int(std::ceil(n/3.0)); // Estimate encoded string size
+  const size_t size = 4*((n+2)/3); // Exact encoded string size
   output.resize(size);
+  if (n == 0)
+    return;
 
-  auto outIt = output.begin();
-  auto outEnd = output.end();
-  uint8_t next = 0;
+  char* out = &output[0];
   size_t i = 0;
-  size_t j = 0;
-  for (; i<n; ++i, ++input) {
-    auto inputValue = *input;
-    switch (j) {
-      case 0:
-        *outIt = base64Char((inputValue & 0b11111100) >> 2);
-        ++outIt;
-        next |= (inputValue & 0b00000011) << 4;
-        ++j;
-        break;
-      case 1:
-        *outIt = base64Char(((inputValue & 0b11110000) >> 4) | next);
-        ++outIt;
-        next = (inputValue & 0b00001111) << 2;
-        ++j;
-        break;
-      case 2:
-        *outIt = base64Char(((inputValue & 0b11000000) >> 6) | next);
-        ++outIt;
-        *outIt = base64Char(inputValue & 0b00111111);
-        ++outIt;
-        next = 0;
-        j = 0;
-        break;
-    }
+
+#if LAF_BASE64_WITH_SIMD
+  if (n >= 16 && base64_simd_supported()) {
+    i = encode_base64_simd(input, n, out);
+    out += 4*i/3;
   }
+#endif
 
-  if (outIt != outEnd) {
-    if (next) {
-      *outIt = base64Char(next);
-      ++outIt;
-    }
-    for (; outIt!=outEnd; ++outIt)
-      *outIt = '=';            // Padding
+  for (; i+3 <= n; i += 3, out += 4) {
+    const uint32_t v = (uint32_t(uint8_t(input[i  ])) << 16) |
+                       (uint32_t(uint8_t(input[i+1])) <<  8) |
+                        uint32_t(uint8_t(input[i+2]));
+    out[0] = base64Char( v >> 18        );
+    out[1] = base64Char((v >> 12) & 0x3f);
+    out[2] = base64Char((v >>  6) & 0x3f);
+    out[3] = base64Char( v        & 0x3f);
+  }
+
+  if (i < n) {
+    const int a = uint8_t(input[i]);
+    const int b = (i+1 < n ? uint8_t(input[i+1]): 0);
+    out[0] = base64Char(a >> 2);
+    out[1] = base64Char(((a & 0b11) << 4) | (b >> 4));
+    out[2] = (i+1 < n ? base64Char((b & 0b1111) << 2): '=');
+    out[3] = '=';                // Padding
   }
 }
 
 void decode_base64(const char* input, size_t n, buffer& output)
 {
-  size_t size = 3*int(std::ceil(n/4.0)); // Estimate decoded buffer size
+  size_t size = 3*((n+3)/4); // Estimate decoded buffer size
   output.resize(size);
 
-  auto outIt = output.begin();
   size_t i = 0;
+  auto outIt = output.begin();
+
+#if LAF_BASE64_WITH_SIMD
+  if (n >= 24 && base64_simd_supported()) {
+    const size_t done = decode_base64_simd(input, n, &output[0]);
+    i = done;
+    input += done;
+    outIt += 3*done/4;
+  }
+#endif
+
   for (; i+3<n; i+=4, input+=4) {
     *outIt = (((base64Inv(input[0])           ) << 2) |
               ((base64Inv(input[1]) & 0b110000) >> 4));
@@ -34,6 +34,29 @@ TEST(Base64, Decode)
   EXPECT_EQ("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", decode_base64s("5pel5pys6Kqe")); // "日本語"
 }
 
+TEST(Base64, ZeroBytes)
+{
+  EXPECT_EQ("AA==", encode_base64(buffer{0}));
+  EXPECT_EQ("AAA=", encode_base64(buffer{0, 0}));
+  EXPECT_EQ(buffer({0}), decode_base64("AA=="));
+}
+
+TEST(Base64, LongRoundtrip)
+{
+  // Long inputs of every length modulo 3/4 to exercise the
+  // vectorized kernels plus their scalar tails
+  for (size_t n : { size_t(47), size_t(48), size_t(49), size_t(50),
+                    size_t(1021), size_t(64*1024) }) {
+    buffer input(n);
+    for (size_t i=0; i<n; ++i)
+      input[i] = uint8_t(i*31 + 7);
+
+    const std::string encoded = encode_base64(input);
+    EXPECT_EQ(4*((n+2)/3), encoded.size());
+    EXPECT_EQ(input, decode_base64(encoded));
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
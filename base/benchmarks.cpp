@@ -0,0 +1,187 @@
+// LAF Base Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Microbenchmarks for the laf-base hot paths (run the
+// laf-base-benchmarks target, optionally passing a name substring to
+// filter). Self-contained harness in the google-benchmark style so we
+// don't drag a new third party dependency into the tree: each
+// benchmark receives the number of iterations to run, the harness
+// scales the count until the run is long enough to time reliably.
+
+#include "base/base64.h"
+#include "base/concurrent_queue.h"
+#include "base/serialization.h"
+#include "base/sha1.h"
+#include "base/string.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Benchmark {
+  std::string name;
+  std::function<void(size_t)> func;
+  double bytesPerIter = 0.0;    // To report throughput when it applies
+};
+
+std::vector<Benchmark>& benchmarks()
+{
+  static std::vector<Benchmark> list;
+  return list;
+}
+
+void add_benchmark(const std::string& name,
+                   std::function<void(size_t)> func,
+                   const double bytesPerIter = 0.0)
+{
+  benchmarks().push_back({ name, std::move(func), bytesPerIter });
+}
+
+double time_seconds(const std::function<void(size_t)>& func,
+                    const size_t iters)
+{
+  const auto start = std::chrono::steady_clock::now();
+  func(iters);
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void run_benchmark(const Benchmark& bench)
+{
+  // Scale the iteration count until the run takes at least ~200ms
+  size_t iters = 1;
+  double secs = time_seconds(bench.func, iters);
+  while (secs < 0.2 && iters < (size_t(1) << 40)) {
+    iters *= (secs < 0.01 ? 16: 2);
+    secs = time_seconds(bench.func, iters);
+  }
+
+  const double nsPerIter = 1e9 * secs / double(iters);
+  if (bench.bytesPerIter > 0.0) {
+    const double mbPerSec =
+      (bench.bytesPerIter * double(iters) / secs) / (1024.0*1024.0);
+    std::printf("%-32s %12.1f ns/iter %10.1f MB/s\n",
+                bench.name.c_str(), nsPerIter, mbPerSec);
+  }
+  else {
+    std::printf("%-32s %12.1f ns/iter\n",
+                bench.name.c_str(), nsPerIter);
+  }
+}
+
+void register_benchmarks()
+{
+  // concurrent_queue: one push+pop per iteration
+  add_benchmark("ConcurrentQueue/mutex", [](size_t n) {
+    base::concurrent_queue<int> queue;
+    int value;
+    for (size_t i=0; i<n; ++i) {
+      queue.push(int(i));
+      queue.try_pop(value);
+    }
+  });
+  add_benchmark("ConcurrentQueue/lock_free", [](size_t n) {
+    base::concurrent_queue<int, base::queue_policy::lock_free> queue;
+    int value;
+    for (size_t i=0; i<n; ++i) {
+      queue.push(int(i));
+      queue.try_pop(value);
+    }
+  });
+
+  // thread_pool: schedule n empty tasks and wait for all of them
+  add_benchmark("ThreadPool/execute", [](size_t n) {
+    static base::thread_pool pool(4);
+    std::atomic<size_t> done(0);
+    for (size_t i=0; i<n; ++i)
+      pool.execute([&done]{ ++done; });
+    pool.wait_all();
+  });
+
+  // UTF-8 conversions over a mixed ASCII/multi-byte string
+  {
+    std::string utf8;
+    for (int i=0; i<64; ++i)
+      utf8 += "filename_0123456789.png \xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E ";
+    const std::wstring wide = base::from_utf8(utf8);
+    add_benchmark("String/from_utf8", [utf8](size_t n) {
+      for (size_t i=0; i<n; ++i)
+        base::from_utf8(utf8);
+    }, double(utf8.size()));
+    add_benchmark("String/to_utf8", [wide](size_t n) {
+      for (size_t i=0; i<n; ++i)
+        base::to_utf8(wide);
+    }, double(wide.size()*sizeof(wchar_t)));
+  }
+
+  // base64 over a 64KB blob
+  {
+    base::buffer blob(64*1024);
+    for (size_t i=0; i<blob.size(); ++i)
+      blob[i] = uint8_t(i*31);
+    const std::string encoded = base::encode_base64(blob);
+    add_benchmark("Base64/encode", [blob](size_t n) {
+      std::string out;
+      for (size_t i=0; i<n; ++i)
+        base::encode_base64((const char*)&blob[0], blob.size(), out);
+    }, double(blob.size()));
+    add_benchmark("Base64/decode", [encoded](size_t n) {
+      base::buffer out;
+      for (size_t i=0; i<n; ++i)
+        base::decode_base64(encoded.c_str(), encoded.size(), out);
+    }, double(encoded.size()));
+  }
+
+  // serialization: 1000 32-bit values per iteration
+  add_benchmark("Serialization/iostream", [](size_t n) {
+    for (size_t i=0; i<n; ++i) {
+      std::stringstream os;
+      for (int j=0; j<1000; ++j)
+        base::serialization::little_endian::write32(os, j);
+    }
+  }, 4000.0);
+  add_benchmark("Serialization/buffer", [](size_t n) {
+    base::buffer buf;
+    for (size_t i=0; i<n; ++i) {
+      buf.clear();
+      base::serialization::serializer s(buf);
+      s.reserve_ahead(4000);
+      for (int j=0; j<1000; ++j)
+        s.write32(j);
+    }
+  }, 4000.0);
+
+  // SHA-1 over a 1MB string
+  {
+    const std::string text(1024*1024, 'x');
+    add_benchmark("Sha1/calculate", [text](size_t n) {
+      for (size_t i=0; i<n; ++i)
+        base::Sha1::calculateFromString(text);
+    }, double(text.size()));
+  }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  const std::string filter = (argc > 1 ? argv[1]: "");
+
+  register_benchmarks();
+  for (const Benchmark& bench : benchmarks()) {
+    if (filter.empty() ||
+        bench.name.find(filter) != std::string::npos)
+      run_benchmark(bench);
+  }
+  return 0;
+}
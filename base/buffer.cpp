@@ -0,0 +1,21 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/buffer.h"
+
+namespace base {
+
+buffer& scratch_buffer()
+{
+  thread_local buffer scratch;
+  return scratch;
+}
+
+} // namespace base
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
 // Copyright (c) 2015-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,11 +10,165 @@
 #pragma once
 
 #include "base/ints.h"
+
+#include <cstring>
+#include <memory>
 #include <vector>
 
 namespace base {
 
-typedef std::vector<uint8_t> buffer;
+// Allocator that default-initializes elements instead of
+// value-initializing them, so buffer.resize(n) doesn't zero-fill
+// multi-MB blocks that are going to be overwritten right away (e.g.
+// read_file_content()). resize(n, 0) still zero-fills explicitly.
+template<typename T>
+class default_init_allocator : public std::allocator<T> {
+public:
+  template<typename U>
+  struct rebind {
+    using other = default_init_allocator<U>;
+  };
+
+  using std::allocator<T>::allocator;
+
+  template<typename U>
+  void construct(U* p) noexcept(noexcept(::new((void*)p) U)) {
+    ::new((void*)p) U;
+  }
+  template<typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    std::allocator<T>::construct(p, std::forward<Args>(args)...);
+  }
+};
+
+typedef std::vector<uint8_t, default_init_allocator<uint8_t>> buffer;
+
+// Explicit spelling for call sites where skipping the zero-fill is
+// the whole point of the call.
+inline void resize_uninitialized(buffer& buf, const size_t size) {
+  buf.resize(size);
+}
+
+// Reusable per-thread scratch buffer for transient conversions
+// (base64, hex, temporary serialization) so they don't heap-allocate
+// on every call. Don't keep references across calls to code that may
+// use it too.
+buffer& scratch_buffer();
+
+// Byte buffer with inline storage for the first N bytes: small blobs
+// (clipboard headers, short packets) never touch the heap. Spills to
+// the heap when it grows beyond N. Not a std::vector replacement,
+// just data()/size() plus the few growth operations we need.
+template<size_t N>
+class small_buffer {
+public:
+  small_buffer() { }
+  explicit small_buffer(const size_t size) { resize_uninitialized(size); }
+
+  small_buffer(const small_buffer& other) { assign(other.data(), other.size()); }
+  small_buffer(small_buffer&& other) noexcept { move_from(std::move(other)); }
+
+  ~small_buffer() {
+    if (m_data != m_inline)
+      delete[] m_data;
+  }
+
+  small_buffer& operator=(const small_buffer& other) {
+    if (this != &other)
+      assign(other.data(), other.size());
+    return *this;
+  }
+
+  small_buffer& operator=(small_buffer&& other) noexcept {
+    if (this != &other) {
+      if (m_data != m_inline)
+        delete[] m_data;
+      move_from(std::move(other));
+    }
+    return *this;
+  }
+
+  uint8_t* data() { return m_data; }
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_capacity; }
+  bool empty() const { return m_size == 0; }
+  bool inline_storage() const { return m_data == m_inline; }
+
+  uint8_t& operator[](const size_t i) { return m_data[i]; }
+  const uint8_t& operator[](const size_t i) const { return m_data[i]; }
+
+  uint8_t* begin() { return m_data; }
+  uint8_t* end() { return m_data + m_size; }
+  const uint8_t* begin() const { return m_data; }
+  const uint8_t* end() const { return m_data + m_size; }
+
+  void clear() { m_size = 0; }
+
+  void reserve(const size_t capacity) {
+    if (capacity > m_capacity)
+      grow(capacity);
+  }
+
+  void resize_uninitialized(const size_t size) {
+    reserve(size);
+    m_size = size;
+  }
+
+  void resize(const size_t size) {
+    const size_t oldSize = m_size;
+    resize_uninitialized(size);
+    if (size > oldSize)
+      std::memset(m_data + oldSize, 0, size - oldSize);
+  }
+
+  void assign(const uint8_t* data, const size_t size) {
+    resize_uninitialized(size);
+    if (size > 0)
+      std::memcpy(m_data, data, size);
+  }
+
+  void push_back(const uint8_t value) {
+    if (m_size == m_capacity)
+      grow(m_size + 1);
+    m_data[m_size++] = value;
+  }
+
+private:
+  void grow(const size_t needed) {
+    size_t capacity = m_capacity;
+    while (capacity < needed)
+      capacity *= 2;
+
+    auto* data = new uint8_t[capacity];
+    std::memcpy(data, m_data, m_size);
+    if (m_data != m_inline)
+      delete[] m_data;
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  void move_from(small_buffer&& other) noexcept {
+    if (other.m_data == other.m_inline) {
+      m_data = m_inline;
+      m_capacity = N;
+      std::memcpy(m_inline, other.m_inline, other.m_size);
+    }
+    else {
+      m_data = other.m_data;
+      m_capacity = other.m_capacity;
+      other.m_data = other.m_inline;
+      other.m_capacity = N;
+    }
+    m_size = other.m_size;
+    other.m_size = 0;
+  }
+
+  uint8_t m_inline[N];
+  uint8_t* m_data = m_inline;
+  size_t m_size = 0;
+  size_t m_capacity = N;
+};
 
 } // namespace base
 
@@ -0,0 +1,89 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/buffer.h"
+
+using namespace base;
+
+TEST(Buffer, ResizeStillZeroFillsExplicitly)
+{
+  buffer buf;
+  buf.resize(16, 0);
+  for (uint8_t b : buf)
+    EXPECT_EQ(0, b);
+
+  // resize_uninitialized() just has to give us writable bytes
+  resize_uninitialized(buf, 1024);
+  EXPECT_EQ(1024, buf.size());
+  buf[1023] = 0xff;
+}
+
+TEST(Buffer, ScratchBufferIsReused)
+{
+  buffer& a = scratch_buffer();
+  a.resize(128, 1);
+  buffer& b = scratch_buffer();
+  EXPECT_EQ(&a, &b);
+  EXPECT_EQ(128, b.size());
+}
+
+TEST(SmallBuffer, InlineThenHeap)
+{
+  small_buffer<16> buf;
+  EXPECT_TRUE(buf.inline_storage());
+  EXPECT_TRUE(buf.empty());
+
+  for (int i=0; i<16; ++i)
+    buf.push_back(i);
+  EXPECT_TRUE(buf.inline_storage());
+  EXPECT_EQ(16, buf.size());
+
+  buf.push_back(16);
+  EXPECT_FALSE(buf.inline_storage());
+  EXPECT_EQ(17, buf.size());
+  for (int i=0; i<17; ++i)
+    EXPECT_EQ(i, buf[i]);
+}
+
+TEST(SmallBuffer, CopyAndMove)
+{
+  small_buffer<8> a(4);
+  for (int i=0; i<4; ++i)
+    a[i] = 10+i;
+
+  small_buffer<8> b = a;
+  EXPECT_EQ(4, b.size());
+  EXPECT_EQ(13, b[3]);
+
+  small_buffer<8> c = std::move(b);
+  EXPECT_EQ(4, c.size());
+  EXPECT_EQ(10, c[0]);
+  EXPECT_EQ(0, b.size());
+
+  // Heap-allocated move steals the pointer
+  small_buffer<8> d(100);
+  d[99] = 42;
+  const uint8_t* p = d.data();
+  small_buffer<8> e = std::move(d);
+  EXPECT_EQ(p, e.data());
+  EXPECT_EQ(42, e[99]);
+}
+
+TEST(SmallBuffer, ResizeZeroFills)
+{
+  small_buffer<4> buf;
+  buf.resize(32);
+  for (size_t i=0; i<buf.size(); ++i)
+    EXPECT_EQ(0, buf[i]);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
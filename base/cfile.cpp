@@ -8,7 +8,11 @@
 #include "config.h"
 #endif
 
+#include "base/cfile.h"
+
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 namespace base {
 
@@ -280,4 +284,193 @@ int fputd(double l, FILE* file)
   return -1;
 }
 
+size_t fread_bytes(uint8_t* buf, size_t size, FILE* file)
+{
+  return fread(buf, 1, size, file);
+}
+
+size_t fwrite_bytes(const uint8_t* buf, size_t size, FILE* file)
+{
+  return fwrite(buf, 1, size, file);
+}
+
+#ifdef LAF_LITTLE_ENDIAN
+
+// In little-endian hosts the file and memory layouts match, one
+// fread()/fwrite() is enough.
+
+size_t fread_u16v(uint16_t* values, size_t n, FILE* file)
+{
+  return fread(values, 2, n, file);
+}
+
+size_t fread_u32v(uint32_t* values, size_t n, FILE* file)
+{
+  return fread(values, 4, n, file);
+}
+
+size_t fread_u64v(uint64_t* values, size_t n, FILE* file)
+{
+  return fread(values, 8, n, file);
+}
+
+size_t fwrite_u16v(const uint16_t* values, size_t n, FILE* file)
+{
+  return fwrite(values, 2, n, file);
+}
+
+size_t fwrite_u32v(const uint32_t* values, size_t n, FILE* file)
+{
+  return fwrite(values, 4, n, file);
+}
+
+size_t fwrite_u64v(const uint64_t* values, size_t n, FILE* file)
+{
+  return fwrite(values, 8, n, file);
+}
+
+#else  // LAF_BIG_ENDIAN
+
+// On big-endian hosts we still do one bulk fread()/fwrite() and swap
+// the bytes of each value in memory.
+
+template<typename T>
+static T swap_bytes(T value)
+{
+  uint8_t in[sizeof(T)], out[sizeof(T)];
+  std::memcpy(in, &value, sizeof(T));
+  for (size_t i=0; i<sizeof(T); ++i)
+    out[i] = in[sizeof(T)-1-i];
+  std::memcpy(&value, out, sizeof(T));
+  return value;
+}
+
+template<typename T>
+static size_t fread_values(T* values, size_t n, FILE* file)
+{
+  const size_t read = fread(values, sizeof(T), n, file);
+  for (size_t i=0; i<read; ++i)
+    values[i] = swap_bytes(values[i]);
+  return read;
+}
+
+template<typename T>
+static size_t fwrite_values(const T* values, size_t n, FILE* file)
+{
+  size_t written = 0;
+  T chunk[1024];
+  while (n > 0) {
+    const size_t m = std::min(n, size_t(1024));
+    for (size_t i=0; i<m; ++i)
+      chunk[i] = swap_bytes(values[i]);
+    const size_t w = fwrite(chunk, sizeof(T), m, file);
+    written += w;
+    if (w < m)
+      break;
+    values += m;
+    n -= m;
+  }
+  return written;
+}
+
+size_t fread_u16v(uint16_t* values, size_t n, FILE* file) { return fread_values(values, n, file); }
+size_t fread_u32v(uint32_t* values, size_t n, FILE* file) { return fread_values(values, n, file); }
+size_t fread_u64v(uint64_t* values, size_t n, FILE* file) { return fread_values(values, n, file); }
+size_t fwrite_u16v(const uint16_t* values, size_t n, FILE* file) { return fwrite_values(values, n, file); }
+size_t fwrite_u32v(const uint32_t* values, size_t n, FILE* file) { return fwrite_values(values, n, file); }
+size_t fwrite_u64v(const uint64_t* values, size_t n, FILE* file) { return fwrite_values(values, n, file); }
+
+#endif
+
+buffered_file_reader::buffered_file_reader(FILE* file,
+                                           const size_t bufferSize)
+  : m_file(file)
+  , m_buffer(bufferSize)
+{
+}
+
+void buffered_file_reader::fill()
+{
+  m_pos = 0;
+  m_end = fread(&m_buffer[0], 1, m_buffer.size(), m_file);
+}
+
+int buffered_file_reader::getc()
+{
+  if (m_pos == m_end) {
+    fill();
+    if (m_pos == m_end)
+      return EOF;
+  }
+  return m_buffer[m_pos++];
+}
+
+int buffered_file_reader::getw()
+{
+  int b1, b2;
+
+  if ((b1 = getc()) == EOF)
+    return EOF;
+
+  if ((b2 = getc()) == EOF)
+    return EOF;
+
+  // Little endian.
+  return ((b2 << 8) | b1);
+}
+
+long buffered_file_reader::getl()
+{
+  int b1, b2, b3, b4;
+
+  if ((b1 = getc()) == EOF)
+    return EOF;
+
+  if ((b2 = getc()) == EOF)
+    return EOF;
+
+  if ((b3 = getc()) == EOF)
+    return EOF;
+
+  if ((b4 = getc()) == EOF)
+    return EOF;
+
+  // Little endian.
+  return ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
+}
+
+long long buffered_file_reader::getq()
+{
+  long long value = 0;
+  for (int i=0; i<8; ++i) {
+    const int b = getc();
+    if (b == EOF)
+      return EOF;
+    value |= ((long long)b << (8*i)); // Little endian.
+  }
+  return value;
+}
+
+size_t buffered_file_reader::read_bytes(uint8_t* buf, size_t size)
+{
+  size_t total = 0;
+
+  // First consume what we've already buffered
+  const size_t buffered = std::min(size, m_end - m_pos);
+  if (buffered > 0) {
+    std::memcpy(buf, &m_buffer[m_pos], buffered);
+    m_pos += buffered;
+    buf += buffered;
+    size -= buffered;
+    total += buffered;
+  }
+
+  // Read big remainders directly from the FILE* (no point in going
+  // through our buffer)
+  if (size > 0)
+    total += fread(buf, 1, size, m_file);
+
+  return total;
+}
+
 } // namespace base
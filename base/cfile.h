@@ -8,6 +8,9 @@
 #define BASE_CFILE_H_INCLUDED
 #pragma once
 
+#include "base/buffer.h"
+#include "base/ints.h"
+
 #include <cstdio>
 
 namespace base {
@@ -23,6 +26,49 @@ namespace base {
   int fputf(float l, FILE* file);
   int fputd(double l, FILE* file);
 
+  // Block-oriented helpers: read/write whole arrays of values with
+  // one fread()/fwrite() call instead of one libc call per byte
+  // (values use little-endian byte ordering like fgetw/fgetl/fgetq).
+  // They return the number of complete values read/written.
+  size_t fread_bytes(uint8_t* buf, size_t size, FILE* file);
+  size_t fwrite_bytes(const uint8_t* buf, size_t size, FILE* file);
+  size_t fread_u16v(uint16_t* values, size_t n, FILE* file);
+  size_t fread_u32v(uint32_t* values, size_t n, FILE* file);
+  size_t fread_u64v(uint64_t* values, size_t n, FILE* file);
+  size_t fwrite_u16v(const uint16_t* values, size_t n, FILE* file);
+  size_t fwrite_u32v(const uint32_t* values, size_t n, FILE* file);
+  size_t fwrite_u64v(const uint64_t* values, size_t n, FILE* file);
+
+  // User-space buffering wrapper on top of a FILE*: format parsers
+  // built on the byte-oriented accessors do a few big fread() calls
+  // instead of millions of getc() round-trips into libc. Don't mix
+  // accesses through the wrapper and the raw FILE* (the wrapper
+  // reads ahead).
+  class buffered_file_reader {
+  public:
+    explicit buffered_file_reader(FILE* file,
+                                  const size_t bufferSize = 64*1024);
+
+    // Same semantics as getc()/fgetw()/fgetl()/fgetq() (little-endian,
+    // EOF on end of file).
+    int getc();
+    int getw();
+    long getl();
+    long long getq();
+
+    // Returns the number of bytes actually read.
+    size_t read_bytes(uint8_t* buf, size_t size);
+
+  private:
+    // Refills the internal buffer from the FILE*.
+    void fill();
+
+    FILE* m_file;
+    buffer m_buffer;
+    size_t m_pos = 0;
+    size_t m_end = 0;
+  };
+
 } // namespace base
 
 #endif
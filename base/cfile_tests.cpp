@@ -0,0 +1,89 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/cfile.h"
+
+#include "base/file_handle.h"
+
+#include <vector>
+
+using namespace base;
+
+TEST(CFile, BulkValuesRoundtrip)
+{
+  const char* fn = "_cfile_.tmp";
+
+  std::vector<uint16_t> v16 = { 0x0102, 0xfffe, 0x00ff };
+  std::vector<uint32_t> v32 = { 0x01020304, 0xfffefdfc };
+  std::vector<uint64_t> v64 = { 0x0102030405060708ull };
+
+  {
+    FileHandle f(open_file(fn, "wb"));
+    EXPECT_EQ(3, fwrite_u16v(&v16[0], v16.size(), f.get()));
+    EXPECT_EQ(2, fwrite_u32v(&v32[0], v32.size(), f.get()));
+    EXPECT_EQ(1, fwrite_u64v(&v64[0], v64.size(), f.get()));
+  }
+  {
+    // The bulk writers must match the byte-oriented readers
+    // (little-endian)
+    FileHandle f(open_file(fn, "rb"));
+    EXPECT_EQ(0x0102, fgetw(f.get()));
+    EXPECT_EQ(0xfffe, fgetw(f.get()));
+    EXPECT_EQ(0x00ff, fgetw(f.get()));
+    EXPECT_EQ(0x01020304, fgetl(f.get()));
+    EXPECT_EQ((int32_t)0xfffefdfc, (int32_t)fgetl(f.get()));
+    EXPECT_EQ(0x0102030405060708ll, fgetq(f.get()));
+  }
+  {
+    FileHandle f(open_file(fn, "rb"));
+    std::vector<uint16_t> r16(3);
+    std::vector<uint32_t> r32(2);
+    std::vector<uint64_t> r64(1);
+    EXPECT_EQ(3, fread_u16v(&r16[0], 3, f.get()));
+    EXPECT_EQ(2, fread_u32v(&r32[0], 2, f.get()));
+    EXPECT_EQ(1, fread_u64v(&r64[0], 1, f.get()));
+    EXPECT_EQ(v16, r16);
+    EXPECT_EQ(v32, r32);
+    EXPECT_EQ(v64, r64);
+  }
+}
+
+TEST(CFile, BufferedFileReader)
+{
+  const char* fn = "_cfile2_.tmp";
+
+  {
+    FileHandle f(open_file(fn, "wb"));
+    fputw(0x0102, f.get());
+    fputl(0x03040506, f.get());
+    fputq(0x0708090a0b0c0d0ell, f.get());
+    for (int i=0; i<1000; ++i)
+      fputc(i & 0xff, f.get());
+  }
+
+  FileHandle f(open_file(fn, "rb"));
+
+  // Tiny buffer to exercise refills
+  buffered_file_reader r(f.get(), 8);
+  EXPECT_EQ(0x0102, r.getw());
+  EXPECT_EQ(0x03040506, r.getl());
+  EXPECT_EQ(0x0708090a0b0c0d0ell, r.getq());
+
+  std::vector<uint8_t> bytes(1000);
+  EXPECT_EQ(1000, r.read_bytes(&bytes[0], bytes.size()));
+  for (int i=0; i<1000; ++i)
+    ASSERT_EQ(i & 0xff, bytes[i]);
+
+  EXPECT_EQ(EOF, r.getc());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,27 +1,30 @@
-// LAF Base Library
-// Copyright (c) 2001-2016 David Capello
-//
-// This file is released under the terms of the MIT license.
-// Read LICENSE.txt for more information.
-
-#ifndef BASE_CHRONO_H_INCLUDED
-#define BASE_CHRONO_H_INCLUDED
-#pragma once
-
-namespace base {
-
-  class Chrono {
-  public:
-    Chrono();
-    ~Chrono();
-    void reset();
-    double elapsed() const;
-
-  private:
-    class ChronoImpl;
-    ChronoImpl* m_impl;
-  };
-
-} // namespace base
-
-#endif // BASE_CHRONO_H_INCLUDED
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2001-2016 David Capello
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_CHRONO_H_INCLUDED
+#define BASE_CHRONO_H_INCLUDED
+#pragma once
+
+#include "base/time.h"
+
+namespace base {
+
+  // Measures elapsed time in seconds over the monotonic nanosecond
+  // clock (now_ns()).
+  class Chrono {
+  public:
+    Chrono() { reset(); }
+    void reset() { m_point = now_ns(); }
+    double elapsed() const { return double(now_ns() - m_point) / 1.0e9; }
+
+  private:
+    uint64_t m_point;
+  };
+
+} // namespace base
+
+#endif // BASE_CHRONO_H_INCLUDED
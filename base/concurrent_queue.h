@@ -10,12 +10,25 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <utility>
 
 namespace base {
 
-  template<typename T>
+  // Policy to select the internal implementation of a
+  // concurrent_queue<> (a mutex-guarded deque, or a lock-free bounded
+  // ring-buffer for hot paths like event/task queues).
+  enum class queue_policy {
+    mutex,
+    lock_free,
+  };
+
+  template<typename T, queue_policy Policy = queue_policy::mutex>
   class concurrent_queue {
   public:
     concurrent_queue() { }
@@ -51,6 +64,30 @@ namespace base {
       m_queue.push_back(value);
     }
 
+    void push(T&& value) {
+      const std::lock_guard lock(m_mutex);
+      m_queue.push_back(std::move(value));
+    }
+
+    // Pushes the value or coalesces it into the last queued element:
+    // merger(last, value) can merge the new value into the existing
+    // last element and return true, in which case nothing is
+    // pushed. The lock is kept for the whole operation so other
+    // producers cannot interleave between the merge and the push.
+    template<typename Merger>
+    void push(const T& value, Merger merger) {
+      const std::lock_guard lock(m_mutex);
+      if (m_queue.empty() || !merger(m_queue.back(), value))
+        m_queue.push_back(value);
+    }
+
+    // Pushes a whole range of elements taking the lock just once.
+    template<typename Iterator>
+    void push_all(Iterator first, Iterator last) {
+      const std::lock_guard lock(m_mutex);
+      m_queue.insert(m_queue.end(), first, last);
+    }
+
     bool try_pop(T& value) {
       if (!m_mutex.try_lock())
         return false;
@@ -59,7 +96,7 @@ namespace base {
       if (m_queue.empty())
         return false;
 
-      value = m_queue.front();
+      value = std::move(m_queue.front());
       m_queue.pop_front();
       return true;
     }
@@ -81,6 +118,269 @@ namespace base {
     mutable std::mutex m_mutex;
   };
 
+  // Lock-free MPMC variant based on a bounded ring-buffer where each
+  // cell carries a sequence number (Dmitry Vyukov's algorithm).
+  // Multiple producers and consumers can push()/try_pop() concurrently
+  // without ever taking a lock; when the ring is full push() yields
+  // until a consumer makes room (backpressure instead of unbounded
+  // growth).
+  template<typename T>
+  class concurrent_queue<T, queue_policy::lock_free> {
+  public:
+    explicit concurrent_queue(const size_t capacity = 4096)
+      : m_mask(round_up_pow2(capacity)-1)
+      , m_cells(std::make_unique<cell[]>(m_mask+1))
+      , m_pushPos(0)
+      , m_popPos(0) {
+      for (size_t i=0; i<=m_mask; ++i)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    concurrent_queue(const concurrent_queue&) = delete;
+    concurrent_queue& operator=(const concurrent_queue&) = delete;
+    ~concurrent_queue() { }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    void clear() {
+      T value;
+      while (try_pop(value))
+        ;
+    }
+
+    // Just an approximation, other threads can push/pop elements
+    // while we compute this value.
+    size_t size() const {
+      const size_t pushPos = m_pushPos.load(std::memory_order_acquire);
+      const size_t popPos = m_popPos.load(std::memory_order_acquire);
+      return (pushPos > popPos ? pushPos - popPos: 0);
+    }
+
+    void push(const T& value) {
+      while (!try_push(value))
+        std::this_thread::yield();
+    }
+
+    // Lock-free pushes are already independent per-cell, this is
+    // just a convenience to mirror the mutex-based variant.
+    template<typename Iterator>
+    void push_all(Iterator first, Iterator last) {
+      for (; first != last; ++first)
+        push(*first);
+    }
+
+    bool try_push(const T& value) {
+      size_t pos = m_pushPos.load(std::memory_order_relaxed);
+      while (true) {
+        cell& c = m_cells[pos & m_mask];
+        const size_t seq = c.sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0) {
+          if (m_pushPos.compare_exchange_weak(pos, pos+1,
+                                              std::memory_order_relaxed)) {
+            c.value = value;
+            c.sequence.store(pos+1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0) {
+          // The ring is full
+          return false;
+        }
+        else {
+          pos = m_pushPos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    bool try_pop(T& value) {
+      size_t pos = m_popPos.load(std::memory_order_relaxed);
+      while (true) {
+        cell& c = m_cells[pos & m_mask];
+        const size_t seq = c.sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos+1);
+        if (diff == 0) {
+          if (m_popPos.compare_exchange_weak(pos, pos+1,
+                                             std::memory_order_relaxed)) {
+            value = std::move(c.value);
+            c.sequence.store(pos+m_mask+1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0) {
+          // The ring is empty
+          return false;
+        }
+        else {
+          pos = m_popPos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+  private:
+    struct cell {
+      std::atomic<size_t> sequence;
+      T value;
+    };
+
+    static constexpr size_t round_up_pow2(size_t n) {
+      size_t p = 1;
+      while (p < n)
+        p <<= 1;
+      return p;
+    }
+
+    const size_t m_mask;
+    std::unique_ptr<cell[]> m_cells;
+
+    // Producer/consumer cursors in separated cache lines to avoid
+    // false sharing.
+    alignas(64) std::atomic<size_t> m_pushPos;
+    alignas(64) std::atomic<size_t> m_popPos;
+  };
+
+  // What a bounded_concurrent_queue<> does when push() finds the
+  // queue full: block the producer until a consumer makes room
+  // (backpressure), or drop the oldest queued element (e.g. live
+  // capture stages where a fresh element is worth more than a stale
+  // one).
+  enum class full_queue_policy {
+    block,
+    drop_oldest,
+  };
+
+  // Bounded queue with blocking push()/pop() (condition-variable
+  // wakeups, so consumers don't spin on try_pop() and producers
+  // cannot balloon memory when a stage stalls). close() wakes every
+  // blocked thread: push() stops accepting elements and pop() keeps
+  // draining the queued ones, returning false once it's empty, which
+  // gives pipelines a clean shutdown sequence.
+  template<typename T>
+  class bounded_concurrent_queue {
+  public:
+    explicit bounded_concurrent_queue(
+      const size_t capacity,
+      const full_queue_policy policy = full_queue_policy::block)
+      : m_capacity(capacity)
+      , m_policy(policy) {
+    }
+    bounded_concurrent_queue(const bounded_concurrent_queue&) = delete;
+    bounded_concurrent_queue& operator=(const bounded_concurrent_queue&) = delete;
+    ~bounded_concurrent_queue() { }
+
+    bool empty() const {
+      const std::lock_guard lock(m_mutex);
+      return m_queue.empty();
+    }
+
+    size_t size() const {
+      const std::lock_guard lock(m_mutex);
+      return m_queue.size();
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    void clear() {
+      {
+        const std::lock_guard lock(m_mutex);
+        m_queue.clear();
+      }
+      m_notFull.notify_all();
+    }
+
+    // Returns false if the queue was closed (the element is not
+    // queued). With full_queue_policy::drop_oldest it never blocks:
+    // when the queue is full the front element is discarded to make
+    // room.
+    bool push(const T& value) { return pushImpl(value); }
+    bool push(T&& value) { return pushImpl(std::move(value)); }
+
+    // Non-blocking push, returns false if the queue is full or
+    // closed (the full-queue policy is not applied).
+    bool try_push(const T& value) {
+      {
+        const std::lock_guard lock(m_mutex);
+        if (m_closed || m_queue.size() >= m_capacity)
+          return false;
+        m_queue.push_back(value);
+      }
+      m_notEmpty.notify_one();
+      return true;
+    }
+
+    // Blocks until an element is available, returns false when the
+    // queue was closed and fully drained.
+    bool pop(T& value) {
+      std::unique_lock lock(m_mutex);
+      m_notEmpty.wait(lock, [this]{ return m_closed || !m_queue.empty(); });
+      if (m_queue.empty())
+        return false;
+
+      value = std::move(m_queue.front());
+      m_queue.pop_front();
+      lock.unlock();
+      m_notFull.notify_one();
+      return true;
+    }
+
+    bool try_pop(T& value) {
+      {
+        const std::lock_guard lock(m_mutex);
+        if (m_queue.empty())
+          return false;
+
+        value = std::move(m_queue.front());
+        m_queue.pop_front();
+      }
+      m_notFull.notify_one();
+      return true;
+    }
+
+    void close() {
+      {
+        const std::lock_guard lock(m_mutex);
+        m_closed = true;
+      }
+      m_notEmpty.notify_all();
+      m_notFull.notify_all();
+    }
+
+    bool closed() const {
+      const std::lock_guard lock(m_mutex);
+      return m_closed;
+    }
+
+  private:
+    template<typename U>
+    bool pushImpl(U&& value) {
+      {
+        std::unique_lock lock(m_mutex);
+        if (m_policy == full_queue_policy::block) {
+          m_notFull.wait(lock, [this]{
+            return m_closed || m_queue.size() < m_capacity;
+          });
+        }
+        if (m_closed)
+          return false;
+
+        if (m_queue.size() >= m_capacity) // drop_oldest
+          m_queue.pop_front();
+        m_queue.push_back(std::forward<U>(value));
+      }
+      m_notEmpty.notify_one();
+      return true;
+    }
+
+    const size_t m_capacity;
+    const full_queue_policy m_policy;
+    std::deque<T> m_queue;
+    bool m_closed = false;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+  };
+
 } // namespace base
 
 #endif
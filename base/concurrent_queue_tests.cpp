@@ -0,0 +1,202 @@
+// LAF Base Library
+// Copyright (c) 2022 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/concurrent_queue.h"
+
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+TEST(ConcurrentQueue, MutexPolicy)
+{
+  concurrent_queue<int> q;
+  EXPECT_TRUE(q.empty());
+
+  q.push(1);
+  q.push(2);
+  q.push(3);
+  EXPECT_EQ(3, q.size());
+
+  q.prioritize([](int v){ return v == 3; });
+
+  int v;
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ(3, v);
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ(1, v);
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ(2, v);
+  EXPECT_FALSE(q.try_pop(v));
+}
+
+TEST(ConcurrentQueue, PushAll)
+{
+  std::vector<int> values = { 1, 2, 3, 4 };
+
+  concurrent_queue<int> a;
+  a.push_all(values.begin(), values.end());
+  EXPECT_EQ(4, a.size());
+
+  concurrent_queue<int, queue_policy::lock_free> b(8);
+  b.push_all(values.begin(), values.end());
+  EXPECT_EQ(4, b.size());
+
+  int va, vb;
+  for (int i=1; i<=4; ++i) {
+    EXPECT_TRUE(a.try_pop(va));
+    EXPECT_TRUE(b.try_pop(vb));
+    EXPECT_EQ(i, va);
+    EXPECT_EQ(i, vb);
+  }
+}
+
+TEST(ConcurrentQueue, PushWithMerger)
+{
+  concurrent_queue<int> q;
+
+  // Merge consecutive values of the same sign into the last element
+  auto merger = [](int& last, int value) {
+    if ((last < 0) != (value < 0))
+      return false;
+    last += value;
+    return true;
+  };
+
+  q.push(1, merger);
+  q.push(2, merger);
+  q.push(-1, merger);
+  q.push(-2, merger);
+  q.push(4, merger);
+  EXPECT_EQ(3, q.size());
+
+  int v;
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ(3, v);
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ(-3, v);
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ(4, v);
+  EXPECT_FALSE(q.try_pop(v));
+}
+
+TEST(ConcurrentQueue, LockFreePolicy)
+{
+  concurrent_queue<int, queue_policy::lock_free> q(8);
+  EXPECT_TRUE(q.empty());
+
+  // The ring is rounded up to a power of two (8), so we can push 8
+  // elements without blocking.
+  for (int i=0; i<8; ++i)
+    EXPECT_TRUE(q.try_push(i));
+  EXPECT_FALSE(q.try_push(8));
+  EXPECT_EQ(8, q.size());
+
+  int v;
+  for (int i=0; i<8; ++i) {
+    EXPECT_TRUE(q.try_pop(v));
+    EXPECT_EQ(i, v);
+  }
+  EXPECT_FALSE(q.try_pop(v));
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(ConcurrentQueue, LockFreeMultipleProducersConsumers)
+{
+  concurrent_queue<int, queue_policy::lock_free> q(128);
+
+  const int kProducers = 4;
+  const int kConsumers = 4;
+  const int kPerProducer = 10000;
+
+  std::atomic<int> popped(0);
+  std::vector<std::vector<int>> results(kConsumers);
+  std::vector<std::thread> threads;
+
+  for (int i=0; i<kProducers; ++i) {
+    threads.emplace_back(
+      [&q, i]{
+        for (int j=0; j<kPerProducer; ++j)
+          q.push(i*kPerProducer + j);
+      });
+  }
+  for (int i=0; i<kConsumers; ++i) {
+    threads.emplace_back(
+      [&q, &popped, &results, i]{
+        int v;
+        while (popped.load() < kProducers*kPerProducer) {
+          if (q.try_pop(v)) {
+            results[i].push_back(v);
+            ++popped;
+          }
+          else
+            std::this_thread::yield();
+        }
+      });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  // Each pushed value must be popped exactly once
+  std::set<int> all;
+  for (const auto& r : results)
+    all.insert(r.begin(), r.end());
+  EXPECT_EQ(kProducers*kPerProducer, int(all.size()));
+}
+
+TEST(ConcurrentQueue, BoundedBlocking)
+{
+  bounded_concurrent_queue<int> q(2);
+
+  EXPECT_TRUE(q.try_push(1));
+  EXPECT_TRUE(q.try_push(2));
+  EXPECT_FALSE(q.try_push(3)); // Full
+
+  // A blocked producer must resume when the consumer makes room
+  std::thread producer([&q]{ EXPECT_TRUE(q.push(3)); });
+  int v;
+  EXPECT_TRUE(q.pop(v));
+  EXPECT_EQ(1, v);
+  producer.join();
+
+  EXPECT_TRUE(q.pop(v));
+  EXPECT_EQ(2, v);
+  EXPECT_TRUE(q.pop(v));
+  EXPECT_EQ(3, v);
+
+  // close() drains pending elements and then pop() returns false
+  q.push(4);
+  q.close();
+  EXPECT_FALSE(q.push(5));
+  EXPECT_TRUE(q.pop(v));
+  EXPECT_EQ(4, v);
+  EXPECT_FALSE(q.pop(v));
+}
+
+TEST(ConcurrentQueue, BoundedDropOldest)
+{
+  bounded_concurrent_queue<int> q(2, full_queue_policy::drop_oldest);
+
+  EXPECT_TRUE(q.push(1));
+  EXPECT_TRUE(q.push(2));
+  EXPECT_TRUE(q.push(3)); // Drops 1 without blocking
+  EXPECT_EQ(2, q.size());
+
+  int v;
+  EXPECT_TRUE(q.pop(v));
+  EXPECT_EQ(2, v);
+  EXPECT_TRUE(q.pop(v));
+  EXPECT_EQ(3, v);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
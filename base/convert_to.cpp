@@ -14,45 +14,106 @@
 #include "base/sha1.h"
 #include "base/uuid.h"
 
+#include <charconv>
 #include <cstdio>
 #include <cstdlib>
 
 namespace base {
 
+// std::from_chars() doesn't skip leading whitespace or accept a '+'
+// sign like the strtol() family does, so we do it ourselves to keep
+// accepting the same inputs as before.
+static std::string_view trim_number_prefix(std::string_view from)
+{
+  size_t i = 0;
+  while (i < from.size() && (from[i] == ' ' || (from[i] >= '\t' && from[i] <= '\r')))
+    ++i;
+  if (i < from.size() && from[i] == '+')
+    ++i;
+  return from.substr(i);
+}
+
+template<typename T>
+static T from_chars_value(const std::string_view& from)
+{
+  const std::string_view s = trim_number_prefix(from);
+  T result = T(0);
+  std::from_chars(s.data(), s.data()+s.size(), result);
+  return result;
+}
+
+template<> int convert_to(const std::string_view& from)
+{
+  return from_chars_value<int>(from);
+}
+
 template<> int convert_to(const std::string& from)
 {
-  return std::strtol(from.c_str(), NULL, 10);
+  return from_chars_value<int>(from);
 }
 
 template<> std::string convert_to(const int& from)
 {
   char buf[32];
-  std::snprintf(buf, sizeof(buf), "%d", from);
-  return buf;
+  return std::string(convert_to_chars(buf, sizeof(buf), from));
+}
+
+template<> uint32_t convert_to(const std::string_view& from)
+{
+  return from_chars_value<uint32_t>(from);
 }
 
 template<> uint32_t convert_to(const std::string& from)
 {
-  return std::strtoul(from.c_str(), NULL, 10);
+  return from_chars_value<uint32_t>(from);
 }
 
 template<> std::string convert_to(const uint32_t& from)
 {
   char buf[32];
-  std::snprintf(buf, sizeof(buf), "%u", from);
-  return buf;
+  return std::string(convert_to_chars(buf, sizeof(buf), from));
+}
+
+template<> double convert_to(const std::string_view& from)
+{
+  return from_chars_value<double>(from);
 }
 
 template<> double convert_to(const std::string& from)
 {
-  return std::strtod(from.c_str(), NULL);
+  return from_chars_value<double>(from);
 }
 
 template<> std::string convert_to(const double& from)
 {
   char buf[32];
-  std::snprintf(buf, sizeof(buf), "%g", from);
-  return buf;
+  return std::string(convert_to_chars(buf, sizeof(buf), from));
+}
+
+std::string_view convert_to_chars(char* buf, const size_t size, const int value)
+{
+  const auto result = std::to_chars(buf, buf+size, value);
+  if (result.ec != std::errc())
+    return std::string_view();
+  return std::string_view(buf, result.ptr-buf);
+}
+
+std::string_view convert_to_chars(char* buf, const size_t size, const uint32_t value)
+{
+  const auto result = std::to_chars(buf, buf+size, value);
+  if (result.ec != std::errc())
+    return std::string_view();
+  return std::string_view(buf, result.ptr-buf);
+}
+
+std::string_view convert_to_chars(char* buf, const size_t size, const double value)
+{
+  // Keep the "%g" format so stored settings don't change, just
+  // without going through a std::string allocation.
+  const int n = std::snprintf(buf, size, "%g", value);
+  if (n < 0 || size_t(n) >= size)
+    return std::string_view();
+  return std::string_view(buf, n);
 }
 
 template<> Sha1 convert_to(const std::string& from)
@@ -71,16 +132,7 @@ template<> Sha1 convert_to(const std::string& from)
 
 template<> std::string convert_to(const Sha1& from)
 {
-  char buf[3];
-  std::string res;
-  res.reserve(2*Sha1::HashSize);
-
-  for(int c=0; c<Sha1::HashSize; ++c) {
-    snprintf(buf, sizeof(buf), "%02x", from[c]);
-    res += buf;
-  }
-
-  return res;
+  return to_hex(from.digest(), Sha1::HashSize);
 }
 
 template<> Uuid convert_to(const std::string& from)
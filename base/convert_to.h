@@ -12,6 +12,7 @@
 #include "base/base.h"
 #include "base/ints.h"
 #include <string>
+#include <string_view>
 
 namespace base {
 
@@ -29,12 +30,15 @@ namespace base {
 
   template<> int convert_to(const std::string& from);
   template<> std::string convert_to(const int& from);
+  template<> int convert_to(const std::string_view& from);
 
   template<> uint32_t convert_to(const std::string& from);
   template<> std::string convert_to(const uint32_t& from);
+  template<> uint32_t convert_to(const std::string_view& from);
 
   template<> double convert_to(const std::string& from);
   template<> std::string convert_to(const double& from);
+  template<> double convert_to(const std::string_view& from);
 
   template<> Sha1 convert_to(const std::string& from);
   template<> std::string convert_to(const Sha1& from);
@@ -42,6 +46,13 @@ namespace base {
   template<> Uuid convert_to(const std::string& from);
   template<> std::string convert_to(const Uuid& from);
 
+  // Allocation-free variants: write the textual representation into
+  // the given caller-owned buffer and return a view of it (empty view
+  // if the buffer is too small).
+  std::string_view convert_to_chars(char* buf, size_t size, int value);
+  std::string_view convert_to_chars(char* buf, size_t size, uint32_t value);
+  std::string_view convert_to_chars(char* buf, size_t size, double value);
+
 }
 
 #endif
@@ -0,0 +1,58 @@
+// LAF Base Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/convert_to.h"
+
+using namespace base;
+
+TEST(ConvertTo, IntAndString)
+{
+  EXPECT_EQ(0, convert_to<int>(std::string("")));
+  EXPECT_EQ(42, convert_to<int>(std::string("42")));
+  EXPECT_EQ(-7, convert_to<int>(std::string("-7")));
+  EXPECT_EQ(32, convert_to<int>(std::string(" +32")));
+  EXPECT_EQ(10, convert_to<int>(std::string("10abc")));
+  EXPECT_EQ("42", convert_to<std::string>(42));
+  EXPECT_EQ("-7", convert_to<std::string>(-7));
+
+  EXPECT_EQ(4294967295u, convert_to<uint32_t>(std::string("4294967295")));
+  EXPECT_EQ("4294967295", convert_to<std::string>(uint32_t(4294967295u)));
+}
+
+TEST(ConvertTo, StringView)
+{
+  EXPECT_EQ(123, convert_to<int>(std::string_view("123")));
+  EXPECT_EQ(0.25, convert_to<double>(std::string_view("0.25")));
+}
+
+TEST(ConvertTo, Double)
+{
+  EXPECT_EQ(0.0, convert_to<double>(std::string("")));
+  EXPECT_EQ(1.5, convert_to<double>(std::string("1.5")));
+  EXPECT_EQ(-0.125, convert_to<double>(std::string("-0.125")));
+  EXPECT_EQ("1.5", convert_to<std::string>(1.5));
+  EXPECT_EQ("1e+10", convert_to<std::string>(1e10));
+}
+
+TEST(ConvertTo, CallerBuffer)
+{
+  char buf[32];
+  EXPECT_EQ("-123", convert_to_chars(buf, sizeof(buf), -123));
+  EXPECT_EQ("123456789", convert_to_chars(buf, sizeof(buf), uint32_t(123456789)));
+  EXPECT_EQ("0.5", convert_to_chars(buf, sizeof(buf), 0.5));
+
+  // Too-small buffer returns an empty view instead of truncating
+  char small[2];
+  EXPECT_EQ("", convert_to_chars(small, sizeof(small), -123));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -9,18 +9,70 @@
 #pragma once
 
 #include <cstddef>
-#include <limits>
+#include <type_traits>
 
 namespace base {
 
+  // Number of set bits in one value. Hardware popcount where the
+  // compiler offers it (std::popcount needs C++20), Kernighan's loop
+  // elsewhere.
   template<typename T>
   constexpr inline size_t count_bits(const T v) {
+    using U = typename std::make_unsigned<T>::type;
+#if defined(__GNUC__) || defined(__clang__)
+    return size_t(__builtin_popcountll((unsigned long long)U(v)));
+#else
     size_t n = 0;
-    for (size_t b=0; b<sizeof(T)*8; ++b) {
-      if (v & (T(1) << b))
-        ++n;
-    }
+    for (U u = U(v); u; u &= u-1)
+      ++n;
     return n;
+#endif
+  }
+
+  // Number of set bits in a span of words (e.g. a whole dirty-tile
+  // bitset).
+  template<typename T>
+  inline size_t count_bits(const T* words, const size_t n) {
+    size_t count = 0;
+    for (size_t i=0; i<n; ++i)
+      count += count_bits(words[i]);
+    return count;
+  }
+
+  // Calls fn(size_t bit) for each set bit in the span, in increasing
+  // order. Zero words cost one compare and set bits are found with a
+  // count-trailing-zeros, so scanning a sparse map touches only the
+  // dirty entries.
+  template<typename T, typename Fn>
+  inline void for_each_set_bit(const T* words, const size_t n, Fn&& fn) {
+    using U = typename std::make_unsigned<T>::type;
+    constexpr size_t bitsPerWord = sizeof(T)*8;
+    for (size_t i=0; i<n; ++i) {
+      for (U w = U(words[i]); w; w &= w-1) {
+#if defined(__GNUC__) || defined(__clang__)
+        const size_t b = size_t(__builtin_ctzll((unsigned long long)w));
+#else
+        size_t b = 0;
+        while (!(w & (U(1) << b)))
+          ++b;
+#endif
+        fn(i*bitsPerWord + b);
+      }
+    }
+  }
+
+  // In-place word-wise merges between bitset spans (both must hold
+  // "n" words). Plain loops that the compiler vectorizes.
+  template<typename T>
+  inline void bits_or(T* dst, const T* src, const size_t n) {
+    for (size_t i=0; i<n; ++i)
+      dst[i] = T(dst[i] | src[i]);
+  }
+
+  template<typename T>
+  inline void bits_and(T* dst, const T* src, const size_t n) {
+    for (size_t i=0; i<n; ++i)
+      dst[i] = T(dst[i] & src[i]);
   }
 
 }
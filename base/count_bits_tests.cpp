@@ -9,6 +9,8 @@
 #include "base/ints.h"
 #include "base/count_bits.h"
 
+#include <vector>
+
 using namespace base;
 
 TEST(CountBits, CommonCases)
@@ -38,6 +40,37 @@ TEST(CountBits, Rgb30bpp)
   EXPECT_EQ(10, count_bits<unsigned long>(0x3ff00000));
 }
 
+TEST(CountBits, Span)
+{
+  const uint64_t words[] = { 0, 0x3, 0, 0x8000000000000000ull };
+  EXPECT_EQ(3, count_bits(words, 4));
+  EXPECT_EQ(0, count_bits(words, 1));
+}
+
+TEST(CountBits, ForEachSetBit)
+{
+  const uint64_t words[] = { 0x5, 0, 0x8000000000000001ull };
+  std::vector<size_t> bits;
+  for_each_set_bit(words, 3, [&bits](size_t b) { bits.push_back(b); });
+  ASSERT_EQ(4, bits.size());
+  EXPECT_EQ(0, bits[0]);
+  EXPECT_EQ(2, bits[1]);
+  EXPECT_EQ(128, bits[2]);
+  EXPECT_EQ(191, bits[3]);
+}
+
+TEST(CountBits, Merges)
+{
+  uint32_t a[] = { 0x0f, 0xf0 };
+  const uint32_t b[] = { 0x03, 0xff };
+  bits_or(a, b, 2);
+  EXPECT_EQ(0x0f, a[0]);
+  EXPECT_EQ(0xff, a[1]);
+  bits_and(a, b, 2);
+  EXPECT_EQ(0x03, a[0]);
+  EXPECT_EQ(0xff, a[1]);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -16,3 +16,97 @@
 #else
   #include "base/dll_unix.h"
 #endif
+
+#include "base/ints.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+namespace base {
+
+int get_dll_procs(dll lib, dll_proc_item* items, const size_t count)
+{
+  int resolved = 0;
+  for (size_t i=0; i<count; ++i) {
+    *items[i].addr = get_dll_proc_base(lib, items[i].name);
+    if (*items[i].addr)
+      ++resolved;
+  }
+  return resolved;
+}
+
+int get_dll_procs(dll lib, dll_proc_item* items, const size_t count,
+                  const std::string& cacheFilename,
+                  const std::string& dllIdentity)
+{
+  if (count == 0)
+    return 0;
+
+  // Try the cache first: one identity line and then "name offset"
+  // pairs, where offsets are relative to the dll base address (so
+  // they survive ASLR, being constant for a given dll build).
+  if (FILE* f = std::fopen(cacheFilename.c_str(), "r")) {
+    char line[1024];
+    std::map<std::string, uint64_t> offsets;
+    bool valid = false;
+    if (std::fgets(line, sizeof(line), f)) {
+      line[std::strcspn(line, "\r\n")] = 0;
+      valid = (dllIdentity == line);
+    }
+    while (valid && std::fgets(line, sizeof(line), f)) {
+      char name[256];
+      unsigned long long offset = 0;
+      if (std::sscanf(line, "%255s %llx", name, &offset) == 2)
+        offsets[name] = offset;
+    }
+    std::fclose(f);
+
+    if (valid) {
+      // Resolve the first symbol with the real loader: it gives us
+      // the base address and double-checks the cache (a stale cache
+      // whose anchor offset doesn't match is discarded).
+      const dll_proc anchor = get_dll_proc_base(lib, items[0].name);
+      const uint8_t* base = dll_base_address(lib, anchor);
+      auto it = offsets.find(items[0].name);
+      if (anchor && base &&
+          it != offsets.end() &&
+          (const uint8_t*)anchor == base + it->second) {
+        int resolved = 0;
+        for (size_t i=0; i<count; ++i) {
+          it = offsets.find(items[i].name);
+          *items[i].addr =
+            (it != offsets.end() ? (dll_proc)(base + it->second):
+                                   nullptr);
+          if (*items[i].addr)
+            ++resolved;
+        }
+        return resolved;
+      }
+    }
+  }
+
+  // Cache miss/mismatch: resolve everything and rewrite the cache
+  const int resolved = get_dll_procs(lib, items, count);
+
+  dll_proc anchor = nullptr;
+  for (size_t i=0; i<count && !anchor; ++i)
+    anchor = *items[i].addr;
+
+  if (const uint8_t* base = dll_base_address(lib, anchor)) {
+    if (FILE* f = std::fopen(cacheFilename.c_str(), "w")) {
+      std::fprintf(f, "%s\n", dllIdentity.c_str());
+      for (size_t i=0; i<count; ++i) {
+        if (*items[i].addr) {
+          std::fprintf(
+            f, "%s %llx\n", items[i].name,
+            (unsigned long long)((const uint8_t*)*items[i].addr - base));
+        }
+      }
+      std::fclose(f);
+    }
+  }
+  return resolved;
+}
+
+} // namespace base
@@ -25,6 +25,29 @@ inline T get_dll_proc(dll lib, const char* procName) {
   return reinterpret_cast<T>(get_dll_proc_base(lib, procName));
 }
 
+// One symbol of a batch resolution (see get_dll_procs()). "addr" is
+// filled with the resolved address, or nullptr if the symbol is
+// missing.
+struct dll_proc_item {
+  const char* name;
+  dll_proc* addr;
+};
+
+// Resolves a whole group of symbols at once. Returns how many were
+// found.
+int get_dll_procs(dll lib, dll_proc_item* items, size_t count);
+
+// Same but backed by a persistent cache file: when the cache was
+// written for the same dll (the identity string should include the
+// dll filename+version) the addresses are rebuilt from their stored
+// offsets relative to the dll base with a single loader round-trip
+// (the first symbol, used as anchor and to validate the cache),
+// instead of one dlsym/GetProcAddress per symbol. On any mismatch
+// the symbols are resolved normally and the cache rewritten.
+int get_dll_procs(dll lib, dll_proc_item* items, size_t count,
+                  const std::string& cacheFilename,
+                  const std::string& dllIdentity);
+
 #if LAF_WINDOWS
 class Version;
 // TODO get_dll_filename() could be implemented on Linux with the
@@ -5,6 +5,7 @@
 // Read LICENSE.txt for more information.
 
 #include "base/config.h"
+#include "base/ints.h"
 #include "base/string.h"
 
 #ifdef HAVE_DLFCN_H
@@ -30,4 +31,16 @@ dll_proc get_dll_proc_base(dll lib, const char* procName)
   return dlsym(lib, procName);
 }
 
+// Base address of the module containing the given symbol, used by
+// the proc cache to store relocatable offsets (the dlopen handle is
+// opaque, so the base is recovered from a resolved symbol).
+static const uint8_t* dll_base_address(dll lib, dll_proc anyProc)
+{
+  (void)lib;
+  Dl_info info;
+  if (anyProc && dladdr(anyProc, &info))
+    return (const uint8_t*)info.dli_fbase;
+  return nullptr;
+}
+
 } // namespace base
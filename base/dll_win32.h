@@ -7,6 +7,7 @@
 
 #include "base/debug.h"
 #include "base/fs.h"
+#include "base/ints.h"
 #include "base/string.h"
 #include "base/version.h"
 
@@ -30,6 +31,14 @@ dll_proc get_dll_proc_base(dll lib, const char* procName)
     GetProcAddress((HMODULE)lib, procName));
 }
 
+// Base address of the module, used by the proc cache to store
+// relocatable offsets (an HMODULE is the mapped base address).
+static const uint8_t* dll_base_address(dll lib, dll_proc anyProc)
+{
+  (void)anyProc;
+  return (const uint8_t*)lib;
+}
+
 static bool get_dll_filename_wchar(dll lib, std::vector<wchar_t>& buf)
 {
   while (true) {
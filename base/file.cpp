@@ -0,0 +1,340 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if LAF_WINDOWS
+  #include "base/string.h"
+
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/stat.h>
+  #include <sys/uio.h>
+  #include <unistd.h>
+#endif
+
+namespace base {
+
+#if LAF_WINDOWS
+  static const file::native_handle kInvalidHandle = INVALID_HANDLE_VALUE;
+#else
+  static const file::native_handle kInvalidHandle = -1;
+#endif
+
+file::file()
+  : m_handle(kInvalidHandle)
+{
+}
+
+file::file(const std::string& path, const mode m)
+  : m_handle(kInvalidHandle)
+{
+  open(path, m);
+}
+
+file::file(file&& other) noexcept
+  : m_handle(kInvalidHandle)
+{
+  *this = std::move(other);
+}
+
+file::~file()
+{
+  close();
+}
+
+file& file::operator=(file&& other) noexcept
+{
+  if (this != &other) {
+    close();
+    std::swap(m_handle, other.m_handle);
+    m_buffer = std::move(other.m_buffer);
+    m_bufferLimit = other.m_bufferLimit;
+    other.m_buffer.clear();
+    other.m_bufferLimit = 0;
+  }
+  return *this;
+}
+
+bool file::open(const std::string& path, const mode m)
+{
+  close();
+
+#if LAF_WINDOWS
+
+  DWORD access = GENERIC_READ;
+  DWORD disposition = OPEN_EXISTING;
+  switch (m) {
+    case mode::read:
+      break;
+    case mode::write:
+      access = GENERIC_WRITE;
+      disposition = CREATE_ALWAYS;
+      break;
+    case mode::append:
+      access = FILE_APPEND_DATA;
+      disposition = OPEN_ALWAYS;
+      break;
+    case mode::read_write:
+      access = GENERIC_READ | GENERIC_WRITE;
+      disposition = OPEN_ALWAYS;
+      break;
+  }
+
+  m_handle = CreateFileW(from_utf8(path).c_str(), access,
+                         FILE_SHARE_READ, nullptr, disposition,
+                         FILE_ATTRIBUTE_NORMAL, nullptr);
+
+#else
+
+  int flags = O_RDONLY;
+  switch (m) {
+    case mode::read:       break;
+    case mode::write:      flags = O_WRONLY | O_CREAT | O_TRUNC; break;
+    case mode::append:     flags = O_WRONLY | O_CREAT | O_APPEND; break;
+    case mode::read_write: flags = O_RDWR | O_CREAT; break;
+  }
+
+  m_handle = ::open(path.c_str(), flags | O_CLOEXEC, 0666);
+
+#endif
+
+  return is_open();
+}
+
+void file::close()
+{
+  if (!is_open())
+    return;
+
+  flush_buffer();
+
+#if LAF_WINDOWS
+  CloseHandle(m_handle);
+#else
+  ::close(m_handle);
+#endif
+  m_handle = kInvalidHandle;
+}
+
+bool file::is_open() const
+{
+  return (m_handle != kInvalidHandle);
+}
+
+size_t file::read(void* buf, const size_t size)
+{
+  if (!is_open())
+    return 0;
+
+#if LAF_WINDOWS
+  DWORD bytes = 0;
+  if (!ReadFile(m_handle, buf, DWORD(size), &bytes, nullptr))
+    return 0;
+  return bytes;
+#else
+  const ssize_t bytes = ::read(m_handle, buf, size);
+  return (bytes > 0 ? size_t(bytes): 0);
+#endif
+}
+
+size_t file::write(const void* buf, const size_t size)
+{
+  if (!is_open())
+    return 0;
+
+  if (m_bufferLimit > 0 && size < m_bufferLimit) {
+    if (m_buffer.size() + size > m_bufferLimit &&
+        !flush_buffer()) {
+      return 0;
+    }
+    const auto* data = (const uint8_t*)buf;
+    m_buffer.insert(m_buffer.end(), data, data+size);
+    return size;
+  }
+
+  if (!flush_buffer())
+    return 0;
+  return write_raw(buf, size);
+}
+
+size_t file::write_raw(const void* buf, const size_t size)
+{
+#if LAF_WINDOWS
+  DWORD bytes = 0;
+  if (!WriteFile(m_handle, buf, DWORD(size), &bytes, nullptr))
+    return 0;
+  return bytes;
+#else
+  const ssize_t bytes = ::write(m_handle, buf, size);
+  return (bytes > 0 ? size_t(bytes): 0);
+#endif
+}
+
+size_t file::pread(const uint64_t offset, void* buf, const size_t size)
+{
+  if (!is_open())
+    return 0;
+
+#if LAF_WINDOWS
+  OVERLAPPED ov;
+  memset(&ov, 0, sizeof(ov));
+  ov.Offset = DWORD(offset);
+  ov.OffsetHigh = DWORD(offset >> 32);
+  DWORD bytes = 0;
+  if (!ReadFile(m_handle, buf, DWORD(size), &bytes, &ov))
+    return 0;
+  return bytes;
+#else
+  const ssize_t bytes = ::pread(m_handle, buf, size, off_t(offset));
+  return (bytes > 0 ? size_t(bytes): 0);
+#endif
+}
+
+size_t file::pwrite(const uint64_t offset, const void* buf, const size_t size)
+{
+  if (!is_open() || !flush_buffer())
+    return 0;
+
+#if LAF_WINDOWS
+  OVERLAPPED ov;
+  memset(&ov, 0, sizeof(ov));
+  ov.Offset = DWORD(offset);
+  ov.OffsetHigh = DWORD(offset >> 32);
+  DWORD bytes = 0;
+  if (!WriteFile(m_handle, buf, DWORD(size), &bytes, &ov))
+    return 0;
+  return bytes;
+#else
+  const ssize_t bytes = ::pwrite(m_handle, buf, size, off_t(offset));
+  return (bytes > 0 ? size_t(bytes): 0);
+#endif
+}
+
+size_t file::write_vectored(const io_vec* vecs, const int nvecs)
+{
+  if (!is_open() || !flush_buffer())
+    return 0;
+
+#if LAF_WINDOWS
+
+  // Windows has no writev() for regular synchronous handles
+  // (WriteFileGather needs page-aligned buffers), a loop is the
+  // best we can do.
+  size_t total = 0;
+  for (int i=0; i<nvecs; ++i) {
+    const size_t bytes = write_raw(vecs[i].data, vecs[i].size);
+    total += bytes;
+    if (bytes < vecs[i].size)
+      break;
+  }
+  return total;
+
+#else
+
+  std::vector<iovec> iov(nvecs);
+  for (int i=0; i<nvecs; ++i) {
+    iov[i].iov_base = const_cast<void*>(vecs[i].data);
+    iov[i].iov_len = vecs[i].size;
+  }
+  const ssize_t bytes = ::writev(m_handle, iov.data(), nvecs);
+  return (bytes > 0 ? size_t(bytes): 0);
+
+#endif
+}
+
+int64_t file::seek(const int64_t offset)
+{
+  if (!is_open() || !flush_buffer())
+    return -1;
+
+#if LAF_WINDOWS
+  LARGE_INTEGER pos, newPos;
+  pos.QuadPart = offset;
+  if (!SetFilePointerEx(m_handle, pos, &newPos, FILE_BEGIN))
+    return -1;
+  return newPos.QuadPart;
+#else
+  return int64_t(lseek(m_handle, off_t(offset), SEEK_SET));
+#endif
+}
+
+int64_t file::tell() const
+{
+  if (!is_open())
+    return -1;
+
+#if LAF_WINDOWS
+  LARGE_INTEGER zero, pos;
+  zero.QuadPart = 0;
+  if (!SetFilePointerEx(m_handle, zero, &pos, FILE_CURRENT))
+    return -1;
+  return pos.QuadPart + int64_t(m_buffer.size());
+#else
+  const off_t pos = lseek(m_handle, 0, SEEK_CUR);
+  if (pos < 0)
+    return -1;
+  return int64_t(pos) + int64_t(m_buffer.size());
+#endif
+}
+
+int64_t file::size() const
+{
+  if (!is_open())
+    return -1;
+
+#if LAF_WINDOWS
+  LARGE_INTEGER sz;
+  if (!GetFileSizeEx(m_handle, &sz))
+    return -1;
+  return sz.QuadPart;
+#else
+  struct stat sts;
+  if (fstat(m_handle, &sts) != 0)
+    return -1;
+  return int64_t(sts.st_size);
+#endif
+}
+
+void file::set_buffer(const size_t size)
+{
+  flush_buffer();
+  m_bufferLimit = size;
+  m_buffer.reserve(size);
+}
+
+bool file::flush()
+{
+  if (!is_open() || !flush_buffer())
+    return false;
+
+#if LAF_WINDOWS
+  return (FlushFileBuffers(m_handle) != 0);
+#else
+  return (fsync(m_handle) == 0);
+#endif
+}
+
+bool file::flush_buffer()
+{
+  if (m_buffer.empty())
+    return true;
+
+  const size_t size = m_buffer.size();
+  const size_t written = write_raw(m_buffer.data(), size);
+  m_buffer.clear();
+  return (written == size);
+}
+
+} // namespace base
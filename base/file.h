@@ -0,0 +1,107 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_FILE_H_INCLUDED
+#define BASE_FILE_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace base {
+
+  // Thin RAII wrapper over a native file descriptor/HANDLE: takes
+  // UTF-8 paths directly (no FSTREAM_PATH round-trip), does one
+  // syscall per operation without the iostream buffering+virtual
+  // layer, and offers positioned (pread/pwrite) and vectored I/O.
+  // Writes are unbuffered unless an explicit buffer is requested
+  // with set_buffer(). Errors are reported through return values
+  // (short/zero counts), not exceptions.
+  class file {
+  public:
+#if LAF_WINDOWS
+    using native_handle = void*; // HANDLE
+#else
+    using native_handle = int;  // File descriptor
+#endif
+
+    enum class mode {
+      read,                     // Open an existing file for reading
+      write,                    // Create/truncate for writing
+      append,                   // Create/append for writing
+      read_write,               // Create (if needed) for read+write
+    };
+
+    // One chunk of a vectored write (see write_vectored()).
+    struct io_vec {
+      const void* data;
+      size_t size;
+    };
+
+    file();
+    file(const std::string& path, mode m);
+    file(file&& other) noexcept;
+    ~file();
+
+    file& operator=(file&& other) noexcept;
+
+    file(const file&) = delete;
+    file& operator=(const file&) = delete;
+
+    bool open(const std::string& path, mode m);
+    void close();
+
+    bool is_open() const;
+    explicit operator bool() const { return is_open(); }
+
+    native_handle handle() const { return m_handle; }
+
+    // Sequential I/O at the current file position. Both return the
+    // number of bytes actually transferred (0 on EOF/error).
+    size_t read(void* buf, size_t size);
+    size_t write(const void* buf, size_t size);
+
+    // Positioned I/O: reads/writes at the given absolute offset
+    // without using the sequential position, so several threads can
+    // access one file concurrently.
+    size_t pread(uint64_t offset, void* buf, size_t size);
+    size_t pwrite(uint64_t offset, const void* buf, size_t size);
+
+    // Writes all the chunks with one writev() syscall on POSIX
+    // (a loop of writes on Windows). Returns the total written.
+    size_t write_vectored(const io_vec* vecs, int nvecs);
+
+    // Absolute positioning/size. Return -1 on error.
+    int64_t seek(int64_t offset);
+    int64_t tell() const;
+    int64_t size() const;
+
+    // Coalesces writes smaller than the buffer into one buffer
+    // flushed when it fills up (and on flush()/close()). A zero size
+    // goes back to unbuffered writes. Useful to batch lots of small
+    // sequential writes (e.g. a serializer) into few syscalls.
+    void set_buffer(size_t size);
+
+    // Writes any buffered data and flushes the OS caches to disk
+    // (fsync/FlushFileBuffers). Returns false on failure.
+    bool flush();
+
+  private:
+    // Writes the internal buffer content (if any)
+    bool flush_buffer();
+    size_t write_raw(const void* buf, size_t size);
+
+    native_handle m_handle;
+    std::vector<uint8_t> m_buffer; // Pending buffered writes
+    size_t m_bufferLimit = 0;      // 0 = unbuffered
+  };
+
+} // namespace base
+
+#endif
@@ -11,6 +11,7 @@
 #include "base/file_content.h"
 
 #include "base/file_handle.h"
+#include "base/process.h"
 
 #include <algorithm>
 #include <cstdio>
@@ -19,6 +20,14 @@
 #if LAF_WINDOWS
   #include <fcntl.h>
   #include <io.h>
+  #include <windows.h>
+
+  #include "base/string.h"
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
 #endif
 
 namespace base {
@@ -51,6 +60,57 @@ buffer read_file_content(const std::string& filename)
   return buffer();
 }
 
+buffer read_file_content(const std::string& filename,
+                         const uint64_t offset, const size_t size)
+{
+  buffer buf(size);
+  size_t pos = 0;
+
+#if LAF_WINDOWS
+
+  HANDLE file = CreateFileW(from_utf8(filename).c_str(),
+                            GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file != INVALID_HANDLE_VALUE) {
+    while (pos < size) {
+      // Positioned read: the offset travels in the OVERLAPPED
+      // structure, there is no file pointer to seek
+      OVERLAPPED ov = {};
+      const uint64_t p = offset + pos;
+      ov.Offset = DWORD(p);
+      ov.OffsetHigh = DWORD(p >> 32);
+
+      DWORD read_bytes = 0;
+      if (!ReadFile(file, &buf[pos],
+                    DWORD(std::min<size_t>(size-pos, kChunkSize)),
+                    &read_bytes, &ov) ||
+          read_bytes == 0)
+        break;
+      pos += read_bytes;
+    }
+    CloseHandle(file);
+  }
+
+#else
+
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    while (pos < size) {
+      const ssize_t read_bytes =
+        pread(fd, &buf[pos], size-pos, off_t(offset+pos));
+      if (read_bytes <= 0)
+        break;
+      pos += size_t(read_bytes);
+    }
+    close(fd);
+  }
+
+#endif
+
+  buf.resize(pos);
+  return buf;
+}
+
 void write_file_content(FILE* file, const uint8_t* buf, size_t size)
 {
   for (size_t pos=0; pos < size; ) {
@@ -70,6 +130,325 @@ void write_file_content(const std::string& filename, const uint8_t* buf, size_t
     write_file_content(f.get(), buf, size);
 }
 
+mapped_file::mapped_file(mapped_file&& other) noexcept
+{
+  *this = std::move(other);
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+  if (this != &other) {
+    unmap();
+
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_mapped = other.m_mapped;
+#if LAF_WINDOWS
+    m_file = other.m_file;
+    m_mapping = other.m_mapping;
+    other.m_file = nullptr;
+    other.m_mapping = nullptr;
+#endif
+    m_buffer = std::move(other.m_buffer);
+
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_mapped = false;
+  }
+  return *this;
+}
+
+mapped_file::~mapped_file()
+{
+  unmap();
+}
+
+void mapped_file::unmap()
+{
+  if (!m_mapped)
+    return;
+
+#if LAF_WINDOWS
+  UnmapViewOfFile((LPCVOID)m_data);
+  CloseHandle((HANDLE)m_mapping);
+  CloseHandle((HANDLE)m_file);
+  m_file = nullptr;
+  m_mapping = nullptr;
+#else
+  munmap((void*)m_data, m_size);
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_mapped = false;
+}
+
+mapped_file map_file_content(const std::string& filename)
+{
+  mapped_file result;
+
+#if LAF_WINDOWS
+
+  HANDLE file = CreateFileW(from_utf8(filename).c_str(),
+                            GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file != INVALID_HANDLE_VALUE) {
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+      HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY,
+                                          0, 0, nullptr);
+      if (mapping) {
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data) {
+          result.m_data = (const uint8_t*)data;
+          result.m_size = (size_t)size.QuadPart;
+          result.m_mapped = true;
+          result.m_file = file;
+          result.m_mapping = mapping;
+          return result;
+        }
+        CloseHandle(mapping);
+      }
+    }
+    CloseHandle(file);
+  }
+
+#else
+
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        result.m_data = (const uint8_t*)data;
+        result.m_size = (size_t)st.st_size;
+        result.m_mapped = true;
+      }
+    }
+    // The mapping (if any) stays valid after closing the descriptor
+    close(fd);
+    if (result.m_mapped)
+      return result;
+  }
+
+#endif
+
+  // Fallback: read the whole content into a buffer
+  result.m_buffer = read_file_content(filename);
+  result.m_data = (result.m_buffer.empty() ? nullptr: &result.m_buffer[0]);
+  result.m_size = result.m_buffer.size();
+  return result;
+}
+
+// Flushes a file that was fully written, honoring the durability
+// level. Returns false if the flush failed.
+static bool sync_file(FILE* file, const durability d)
+{
+  if (d == durability::none)
+    return true;
+
+#if LAF_WINDOWS
+
+  return (FlushFileBuffers((HANDLE)_get_osfhandle(_fileno(file))) != 0);
+
+#elif defined(__APPLE__)
+
+  // macOS doesn't have fdatasync() and its fsync() doesn't reach the
+  // disk anyway; F_FULLFSYNC is the real flush for the "full" level.
+  if (d == durability::full)
+    return (fcntl(fileno(file), F_FULLFSYNC) == 0 ||
+            fsync(fileno(file)) == 0);
+  return (fsync(fileno(file)) == 0);
+
+#else
+
+  if (d == durability::full)
+    return (fsync(fileno(file)) == 0);
+  return (fdatasync(fileno(file)) == 0);
+
+#endif
+}
+
+bool atomic_write_file(const std::string& filename,
+                       const std::vector<buffer>& chunks,
+                       const durability d)
+{
+  // Temp file in the same directory (same filesystem) so the final
+  // rename is really a rename. The pid makes concurrent writers of
+  // different processes not step on each other's temp file.
+  const std::string tmp =
+    filename + ".tmp" + std::to_string(get_current_process_id());
+
+  try {
+    {
+      const FileHandle f(open_file(tmp, "wb"));
+      if (!f)
+        return false;
+
+      for (const buffer& chunk : chunks)
+        write_file_content(f.get(), chunk);
+
+      if (std::fflush(f.get()) != 0 ||
+          !sync_file(f.get(), d)) {
+        throw std::runtime_error("Cannot flush file content");
+      }
+    } // Closes the temp file before renaming it
+
+#if LAF_WINDOWS
+    // MoveFileEx() (and not std::rename()) to replace an existing
+    // destination; WRITE_THROUGH makes the rename itself durable.
+    if (!MoveFileExW(from_utf8(tmp).c_str(),
+                     from_utf8(filename).c_str(),
+                     MOVEFILE_REPLACE_EXISTING |
+                     (d == durability::full ? MOVEFILE_WRITE_THROUGH: 0)))
+      throw std::runtime_error("Cannot rename temp file");
+#else
+    if (std::rename(tmp.c_str(), filename.c_str()) != 0)
+      throw std::runtime_error("Cannot rename temp file");
+
+    // The rename is durable only when the directory entry reaches
+    // the disk too.
+    if (d == durability::full) {
+      std::string dir = filename;
+      if (auto i = dir.find_last_of("/\\"); i != std::string::npos)
+        dir.erase(i);
+      else
+        dir = ".";
+      const int dirfd = open(dir.c_str(), O_RDONLY);
+      if (dirfd >= 0) {
+        fsync(dirfd);
+        close(dirfd);
+      }
+    }
+#endif
+    return true;
+  }
+  catch (const std::exception&) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+}
+
+bool atomic_write_file(const std::string& filename,
+                       const uint8_t* data, const size_t size,
+                       const durability d)
+{
+  std::vector<buffer> chunks(1);
+  chunks[0].assign(data, data+size);
+  return atomic_write_file(filename, chunks, d);
+}
+
+async_file_writer::async_file_writer(const std::string& filename,
+                                     thread_pool& pool)
+  : m_pool(pool)
+  , m_file(open_file(filename, "wb"))
+{
+  if (!m_file)
+    m_ok = false;
+}
+
+async_file_writer::~async_file_writer()
+{
+  wait();
+}
+
+void async_file_writer::write(const uint8_t* data, const size_t size)
+{
+  write(buffer(data, data+size));
+}
+
+void async_file_writer::write(buffer&& chunk)
+{
+  const std::unique_lock lock(m_mutex);
+  ASSERT(!m_closed);
+  if (m_token.canceled() || !m_ok)
+    return;
+
+  m_chunks.push_back(std::move(chunk));
+  schedule_flush();
+}
+
+void async_file_writer::close()
+{
+  const std::unique_lock lock(m_mutex);
+  if (m_closed)
+    return;
+
+  m_closed = true;
+  // No flush in-flight and nothing pending: complete right now
+  if (!m_flushing) {
+    m_file.reset();
+    m_completed = true;
+    m_cv.notify_all();
+  }
+}
+
+void async_file_writer::wait()
+{
+  close();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this]() -> bool { return m_completed; });
+}
+
+bool async_file_writer::completed() const
+{
+  const std::unique_lock lock(m_mutex);
+  return m_completed;
+}
+
+bool async_file_writer::ok() const
+{
+  const std::unique_lock lock(m_mutex);
+  return m_ok;
+}
+
+void async_file_writer::schedule_flush()
+{
+  if (m_flushing || m_completed)
+    return;
+
+  m_flushing = true;
+  m_pool.execute([this]{ flush_worker(); });
+}
+
+void async_file_writer::flush_worker()
+{
+  while (true) {
+    buffer chunk;
+    {
+      const std::unique_lock lock(m_mutex);
+
+      if (m_token.canceled())
+        m_chunks.clear();
+
+      if (m_chunks.empty()) {
+        m_flushing = false;
+        if (m_closed) {
+          m_file.reset(); // Closes the FILE handle
+          m_completed = true;
+          m_cv.notify_all();
+        }
+        return;
+      }
+
+      chunk = std::move(m_chunks.front());
+      m_chunks.pop_front();
+    }
+
+    if (m_file && !chunk.empty()) {
+      try {
+        write_file_content(m_file.get(), &chunk[0], chunk.size());
+      }
+      catch (const std::exception&) {
+        const std::unique_lock lock(m_mutex);
+        m_ok = false;
+        m_chunks.clear();
+      }
+    }
+  }
+}
+
 void set_write_binary_file_content(FILE* file)
 {
 #if LAF_WINDOWS
@@ -9,9 +9,14 @@
 #pragma once
 
 #include "base/buffer.h"
+#include "base/file_handle.h"
 #include "base/ints.h"
+#include "base/task.h"
 
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <mutex>
 #include <string>
 
 namespace base {
@@ -19,6 +24,15 @@ namespace base {
   buffer read_file_content(FILE* file);
   buffer read_file_content(const std::string& filename);
 
+  // Reads just [offset, offset+size) of the file with a positioned
+  // read (pread()/equivalent, no seek state), so chunked loaders can
+  // issue concurrent ranged reads from a thread pool instead of
+  // reading the whole file to get one chunk. Returns a buffer
+  // shorter than "size" (possibly empty) if the range goes past the
+  // end of the file or the file cannot be read.
+  buffer read_file_content(const std::string& filename,
+                           uint64_t offset, size_t size);
+
   void write_file_content(FILE* file, const uint8_t* data, size_t size);
   void write_file_content(const std::string& filename, const uint8_t* data, size_t size);
 
@@ -32,6 +46,120 @@ namespace base {
       write_file_content(filename, &buf[0], buf.size());
   }
 
+  // Read-only zero-copy view of a whole file content. When possible
+  // the file is memory-mapped (so pages are loaded lazily by the OS
+  // without copying them into a growing buffer), in other case it
+  // falls back to read_file_content() into an owned buffer.
+  class mapped_file {
+  public:
+    mapped_file() { }
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    // True if the content is really memory-mapped (false for the
+    // buffer fallback or an empty/unreadable file).
+    bool mapped() const { return m_mapped; }
+
+  private:
+    friend mapped_file map_file_content(const std::string& filename);
+
+    void unmap();
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+#if LAF_WINDOWS
+    void* m_file = nullptr;    // HANDLE of the file
+    void* m_mapping = nullptr; // HANDLE of the file mapping
+#endif
+    buffer m_buffer;           // Fallback storage when we cannot map
+  };
+
+  mapped_file map_file_content(const std::string& filename);
+
+  // How hard atomic_write_file() flushes before renaming the temp
+  // file over the destination.
+  enum class durability {
+    none,   // No explicit flush: fastest, the rename is still atomic
+            // but after a power loss the new content may be lost
+    data,   // Flush file data only (fdatasync): the content survives
+            // a crash without paying the metadata flush
+    full,   // Flush data+metadata and the parent directory (fsync)
+  };
+
+  // Writes the chunks to a temporary file in the same directory as
+  // "filename" (so the final rename cannot cross filesystems) and
+  // renames it over the destination, so readers and crashes see
+  // either the complete old or the complete new content, never a
+  // partial file. Returns false on failure, leaving the destination
+  // untouched and removing the temp file.
+  bool atomic_write_file(const std::string& filename,
+                         const std::vector<buffer>& chunks,
+                         durability d = durability::data);
+  bool atomic_write_file(const std::string& filename,
+                         const uint8_t* data, size_t size,
+                         durability d = durability::data);
+
+  // Streaming file writer that flushes queued chunks from a
+  // thread_pool worker, so producers (e.g. an autosave) can keep
+  // generating data without blocking on disk I/O. Call close() when
+  // no more chunks will be written and wait() (or poll completed())
+  // for the final flush; canceling the token discards the pending
+  // chunks.
+  class async_file_writer {
+  public:
+    async_file_writer(const std::string& filename, thread_pool& pool);
+    ~async_file_writer();
+
+    async_file_writer(const async_file_writer&) = delete;
+    async_file_writer& operator=(const async_file_writer&) = delete;
+
+    void write(const uint8_t* data, const size_t size);
+    void write(buffer&& chunk);
+
+    // Signals that no more chunks will arrive.
+    void close();
+
+    // Blocks until every queued chunk was written (or discarded if
+    // the token was canceled). Implies close().
+    void wait();
+
+    bool completed() const;
+
+    // False if some chunk could not be fully written.
+    bool ok() const;
+
+    task_token& token() { return m_token; }
+
+  private:
+    // Flushes queued chunks in a worker thread.
+    void flush_worker();
+
+    // Schedules the flush task if it isn't already running. The
+    // caller must hold m_mutex.
+    void schedule_flush();
+
+    thread_pool& m_pool;
+    FileHandle m_file;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<buffer> m_chunks;
+    bool m_flushing = false;
+    bool m_closed = false;
+    bool m_completed = false;
+    bool m_ok = true;
+    task_token m_token;
+  };
+
   // Can be used on Windows to write binary content to stdout or other
   // FILE handles.
   void set_write_binary_file_content(FILE* file);
@@ -8,6 +8,12 @@
 
 #include "base/file_content.h"
 
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
 using namespace base;
 
 TEST(FileContent, ReadWrite)
@@ -26,6 +32,122 @@ TEST(FileContent, ReadWrite)
   }
 }
 
+TEST(FileContent, MapFileContent)
+{
+  const char* fn = "_test_map_.tmp";
+
+  buffer buf(1024*64*3+4);
+  for (int i=0; i<buf.size(); ++i)
+    buf[i] = i;
+  write_file_content(fn, buf);
+
+  mapped_file view = map_file_content(fn);
+  ASSERT_EQ(buf.size(), view.size());
+  EXPECT_TRUE(std::equal(buf.begin(), buf.end(), view.data()));
+
+  // Moving the view keeps the content valid
+  mapped_file view2(std::move(view));
+  ASSERT_EQ(buf.size(), view2.size());
+  EXPECT_TRUE(std::equal(buf.begin(), buf.end(), view2.data()));
+  EXPECT_EQ(0, view.size());
+
+  // Mapping a non-existent file gives an empty view
+  mapped_file none = map_file_content("_does_not_exist_.tmp");
+  EXPECT_TRUE(none.empty());
+  EXPECT_FALSE(none.mapped());
+}
+
+TEST(FileContent, RangedRead)
+{
+  const char* fn = "_test_ranged_.tmp";
+
+  buffer buf(1024*64*2+100);
+  for (int i=0; i<buf.size(); ++i)
+    buf[i] = i;
+  write_file_content(fn, buf);
+
+  // A middle chunk (crossing the internal chunk size)
+  buffer chunk = read_file_content(fn, 1024*64-50, 100);
+  ASSERT_EQ(100, chunk.size());
+  EXPECT_TRUE(std::equal(chunk.begin(), chunk.end(),
+                         buf.begin()+1024*64-50));
+
+  // A range past the end of the file is truncated
+  chunk = read_file_content(fn, buf.size()-10, 100);
+  ASSERT_EQ(10, chunk.size());
+  EXPECT_TRUE(std::equal(chunk.begin(), chunk.end(),
+                         buf.end()-10));
+
+  // A range fully past the end, and a missing file, give an empty
+  // buffer
+  EXPECT_TRUE(read_file_content(fn, buf.size()+1, 100).empty());
+  EXPECT_TRUE(read_file_content("_does_not_exist_.tmp", 0, 100).empty());
+
+  // Concurrent ranged reads of independent chunks (no shared seek
+  // state)
+  thread_pool pool(4);
+  std::atomic<int> badChunks(0);
+  for (size_t pos=0; pos<buf.size(); pos+=1024) {
+    pool.execute([&, pos]{
+      const size_t len = std::min<size_t>(1024, buf.size()-pos);
+      const buffer chunk = read_file_content(fn, pos, len);
+      if (chunk.size() != len ||
+          !std::equal(chunk.begin(), chunk.end(), buf.begin()+pos))
+        ++badChunks;
+    });
+  }
+  pool.wait_all();
+  EXPECT_EQ(0, badChunks);
+}
+
+TEST(FileContent, AsyncFileWriter)
+{
+  const char* fn = "_test_async_.tmp";
+
+  buffer buf(1024*128);
+  for (int i=0; i<buf.size(); ++i)
+    buf[i] = i;
+
+  thread_pool pool(2);
+  {
+    async_file_writer writer(fn, pool);
+    for (size_t pos=0; pos<buf.size(); pos+=1024)
+      writer.write(&buf[pos], 1024);
+    writer.wait();
+    EXPECT_TRUE(writer.completed());
+    EXPECT_TRUE(writer.ok());
+  }
+
+  EXPECT_EQ(buf, read_file_content(fn));
+}
+
+TEST(FileContent, AtomicWriteFile)
+{
+  const char* fn = "_test_atomic_.tmp";
+
+  std::vector<buffer> chunks(3);
+  buffer all;
+  for (int i=0; i<3; ++i) {
+    chunks[i].resize(1000+i);
+    for (int j=0; j<chunks[i].size(); ++j)
+      chunks[i][j] = i+j;
+    all.insert(all.end(), chunks[i].begin(), chunks[i].end());
+  }
+
+  // Creates a new file...
+  EXPECT_TRUE(atomic_write_file(fn, chunks));
+  EXPECT_EQ(all, read_file_content(fn));
+
+  // ...and replaces an existing one
+  const buffer small = { 1, 2, 3 };
+  EXPECT_TRUE(atomic_write_file(fn, &small[0], small.size(),
+                                durability::none));
+  EXPECT_EQ(small, read_file_content(fn));
+
+  // A failed write (unwritable directory) keeps the old content
+  EXPECT_FALSE(atomic_write_file("_no_such_dir_/f", chunks));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
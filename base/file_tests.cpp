@@ -0,0 +1,80 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file.h"
+
+#include <cstring>
+
+using namespace base;
+
+TEST(File, ReadWriteSeek)
+{
+  const char* fn = "_file_.tmp";
+
+  {
+    file f(fn, file::mode::write);
+    ASSERT_TRUE(f.is_open());
+    EXPECT_EQ(5, f.write("hello", 5));
+    EXPECT_EQ(6, f.write(" world", 6));
+    EXPECT_EQ(11, f.tell());
+  }
+
+  file f(fn, file::mode::read);
+  ASSERT_TRUE(f.is_open());
+  EXPECT_EQ(11, f.size());
+
+  char buf[16] = { 0 };
+  EXPECT_EQ(11, f.read(buf, sizeof(buf)));
+  EXPECT_STREQ("hello world", buf);
+
+  // Positioned reads don't need seeking and can run concurrently
+  std::memset(buf, 0, sizeof(buf));
+  EXPECT_EQ(5, f.pread(6, buf, 5));
+  EXPECT_STREQ("world", buf);
+
+  EXPECT_EQ(0, f.seek(0));
+  EXPECT_EQ(5, f.read(buf, 5));
+}
+
+TEST(File, VectoredAndBuffered)
+{
+  const char* fn = "_file2_.tmp";
+
+  {
+    file f(fn, file::mode::write);
+    const file::io_vec vecs[] = { { "ab", 2 }, { "cd", 2 }, { "ef", 2 } };
+    EXPECT_EQ(6, f.write_vectored(vecs, 3));
+
+    // Buffered small writes coalesce into one syscall at flush/close
+    f.set_buffer(1024);
+    for (int i=0; i<4; ++i)
+      f.write("x", 1);
+    EXPECT_EQ(10, f.tell());
+  }
+
+  file f(fn, file::mode::read);
+  char buf[16] = { 0 };
+  EXPECT_EQ(10, f.read(buf, sizeof(buf)));
+  EXPECT_STREQ("abcdefxxxx", buf);
+}
+
+TEST(File, Errors)
+{
+  file f;
+  EXPECT_FALSE(f.is_open());
+  EXPECT_EQ(0, f.write("x", 1));
+  EXPECT_EQ(-1, f.size());
+
+  EXPECT_FALSE(f.open("_no_such_dir_/f", file::mode::read));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
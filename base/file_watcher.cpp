@@ -0,0 +1,42 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/file_watcher.h"
+
+#if LAF_WINDOWS
+  #include "base/file_watcher_win32.h"
+#elif LAF_LINUX
+  #include "base/file_watcher_linux.h"
+#else
+  #include "base/file_watcher_generic.h"
+#endif
+
+namespace base {
+
+file_watcher::file_watcher()
+  : m_impl(std::make_unique<impl>(m_queue))
+{
+}
+
+file_watcher::~file_watcher()
+{
+}
+
+bool file_watcher::add(const std::string& dir)
+{
+  return m_impl->add(dir);
+}
+
+void file_watcher::remove(const std::string& dir)
+{
+  m_impl->remove(dir);
+}
+
+} // namespace base
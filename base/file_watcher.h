@@ -0,0 +1,61 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_FILE_WATCHER_H_INCLUDED
+#define BASE_FILE_WATCHER_H_INCLUDED
+#pragma once
+
+#include "base/concurrent_queue.h"
+
+#include <memory>
+#include <string>
+
+namespace base {
+
+  // Watches directories for external changes using the native OS
+  // facility (inotify on Linux, ReadDirectoryChangesW on Windows, a
+  // low-frequency polling thread elsewhere) and delivers the events
+  // through a concurrent_queue, so clients can replace per-file
+  // modification time polling with a try_pop() in their loop.
+  class file_watcher {
+  public:
+    enum class event_type {
+      added,
+      removed,
+      modified,
+    };
+
+    struct event {
+      event_type type = event_type::modified;
+      std::string path;         // Full path of the affected file
+    };
+
+    using event_queue = concurrent_queue<event>;
+
+    file_watcher();
+    ~file_watcher();
+
+    file_watcher(const file_watcher&) = delete;
+    file_watcher& operator=(const file_watcher&) = delete;
+
+    // Starts watching the given directory (non-recursive). Returns
+    // false if the directory cannot be watched.
+    bool add(const std::string& dir);
+    void remove(const std::string& dir);
+
+    // Queue where the events are delivered from the watcher thread.
+    event_queue& events() { return m_queue; }
+
+  private:
+    class impl;
+
+    event_queue m_queue;
+    std::unique_ptr<impl> m_impl;
+  };
+
+} // namespace base
+
+#endif
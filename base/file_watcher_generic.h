@@ -0,0 +1,106 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include "base/fs.h"
+#include "base/thread.h"
+#include "base/time.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace base {
+
+// Generic fallback for platforms without a native watcher API
+// integration yet: one background thread re-scans the watched
+// directories a couple of times per second and diffs the modification
+// times (still a lot cheaper than per-file polling from the client
+// side, and behind the same event_queue interface).
+class file_watcher::impl {
+  using snapshot = std::map<std::string, Time>;
+
+public:
+  impl(event_queue& queue)
+    : m_queue(queue)
+    , m_thread([this]{ run(); }) {
+  }
+
+  ~impl() {
+    m_running = false;
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  bool add(const std::string& dir) {
+    if (!is_directory(dir))
+      return false;
+
+    const std::lock_guard lock(m_mutex);
+    m_dirs[dir] = scan(dir);
+    return true;
+  }
+
+  void remove(const std::string& dir) {
+    const std::lock_guard lock(m_mutex);
+    m_dirs.erase(dir);
+  }
+
+private:
+  snapshot scan(const std::string& dir) {
+    snapshot result;
+    dir_iterator it(dir);
+    while (it.next()) {
+      const std::string fullpath = join_path(dir, it.name());
+      result[it.name()] = get_modification_time(fullpath);
+    }
+    return result;
+  }
+
+  void run() {
+    while (m_running) {
+      this_thread::sleep_for(0.5);
+
+      const std::lock_guard lock(m_mutex);
+      for (auto& kv : m_dirs) {
+        const std::string& dir = kv.first;
+        snapshot& old = kv.second;
+        snapshot now = scan(dir);
+
+        for (const auto& e : now) {
+          auto it = old.find(e.first);
+          if (it == old.end())
+            push(event_type::added, dir, e.first);
+          else if (!(it->second == e.second))
+            push(event_type::modified, dir, e.first);
+        }
+        for (const auto& e : old) {
+          if (now.find(e.first) == now.end())
+            push(event_type::removed, dir, e.first);
+        }
+
+        old = std::move(now);
+      }
+    }
+  }
+
+  void push(const event_type type,
+            const std::string& dir,
+            const std::string& name) {
+    event e;
+    e.type = type;
+    e.path = join_path(dir, name);
+    m_queue.push(e);
+  }
+
+  event_queue& m_queue;
+  std::atomic<bool> m_running = { true };
+  std::mutex m_mutex;
+  std::map<std::string, snapshot> m_dirs;
+  std::thread m_thread;
+};
+
+} // namespace base
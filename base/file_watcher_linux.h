@@ -0,0 +1,113 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include "base/fs.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace base {
+
+// inotify-based implementation: one background thread polls the
+// inotify descriptor and pushes the events into the queue.
+class file_watcher::impl {
+public:
+  impl(event_queue& queue)
+    : m_queue(queue)
+    , m_fd(inotify_init1(IN_NONBLOCK)) {
+    if (m_fd >= 0)
+      m_thread = std::thread([this]{ run(); });
+  }
+
+  ~impl() {
+    m_running = false;
+    if (m_thread.joinable())
+      m_thread.join();
+    if (m_fd >= 0)
+      close(m_fd);
+  }
+
+  bool add(const std::string& dir) {
+    if (m_fd < 0)
+      return false;
+
+    const int wd = inotify_add_watch(
+      m_fd, dir.c_str(),
+      IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MODIFY |
+      IN_MOVED_FROM | IN_MOVED_TO);
+    if (wd < 0)
+      return false;
+
+    const std::lock_guard lock(m_mutex);
+    m_dirs[wd] = dir;
+    return true;
+  }
+
+  void remove(const std::string& dir) {
+    const std::lock_guard lock(m_mutex);
+    for (auto it=m_dirs.begin(); it!=m_dirs.end(); ++it) {
+      if (it->second == dir) {
+        inotify_rm_watch(m_fd, it->first);
+        m_dirs.erase(it);
+        break;
+      }
+    }
+  }
+
+private:
+  void run() {
+    char buf[4096] __attribute__((aligned(__alignof__(inotify_event))));
+
+    while (m_running) {
+      pollfd pfd = { m_fd, POLLIN, 0 };
+      if (poll(&pfd, 1, 200) <= 0)
+        continue;
+
+      const ssize_t len = read(m_fd, buf, sizeof(buf));
+      for (ssize_t i=0; i<len; ) {
+        auto* ev = (const inotify_event*)&buf[i];
+        i += sizeof(inotify_event) + ev->len;
+
+        if (ev->len == 0)
+          continue;
+
+        std::string dir;
+        {
+          const std::lock_guard lock(m_mutex);
+          auto it = m_dirs.find(ev->wd);
+          if (it == m_dirs.end())
+            continue;
+          dir = it->second;
+        }
+
+        event e;
+        if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+          e.type = event_type::added;
+        else if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+          e.type = event_type::removed;
+        else
+          e.type = event_type::modified;
+        e.path = join_path(dir, ev->name);
+        m_queue.push(e);
+      }
+    }
+  }
+
+  event_queue& m_queue;
+  int m_fd;
+  std::atomic<bool> m_running = { true };
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::map<int, std::string> m_dirs; // inotify wd -> directory
+};
+
+} // namespace base
@@ -0,0 +1,66 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_watcher.h"
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/thread.h"
+
+#include <set>
+
+using namespace base;
+
+namespace {
+
+// Waits up to ~5 seconds for the expected paths/types to arrive.
+bool wait_events(file_watcher& watcher,
+                 std::set<std::pair<file_watcher::event_type, std::string>> expected)
+{
+  for (int i=0; i<100 && !expected.empty(); ++i) {
+    file_watcher::event ev;
+    while (watcher.events().try_pop(ev))
+      expected.erase(std::make_pair(ev.type, ev.path));
+    if (!expected.empty())
+      this_thread::sleep_for(0.05);
+  }
+  return expected.empty();
+}
+
+} // anonymous namespace
+
+TEST(FileWatcher, AddModifyRemove)
+{
+  using event_type = file_watcher::event_type;
+
+  make_all_directories("watched");
+
+  file_watcher watcher;
+  ASSERT_TRUE(watcher.add("watched"));
+  EXPECT_FALSE(watcher.add("_no_such_dir_"));
+
+  const std::string fn = join_path("watched", "f.txt");
+
+  write_file_content(fn, (const uint8_t*)"a", 1);
+  EXPECT_TRUE(wait_events(watcher, { { event_type::added, fn } }));
+
+  write_file_content(fn, (const uint8_t*)"bc", 2);
+  EXPECT_TRUE(wait_events(watcher, { { event_type::modified, fn } }));
+
+  delete_file(fn);
+  EXPECT_TRUE(wait_events(watcher, { { event_type::removed, fn } }));
+
+  watcher.remove("watched");
+  remove_directory("watched");
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,126 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include "base/fs.h"
+#include "base/string.h"
+
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <windows.h>
+
+namespace base {
+
+// ReadDirectoryChangesW-based implementation: one thread per watched
+// directory blocks on ReadDirectoryChangesW() and pushes the events
+// into the queue. Closing the directory handle wakes up and finishes
+// the thread.
+class file_watcher::impl {
+  struct watch {
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    std::thread thread;
+  };
+
+public:
+  impl(event_queue& queue) : m_queue(queue) { }
+
+  ~impl() {
+    std::map<std::string, std::unique_ptr<watch>> watches;
+    {
+      const std::lock_guard lock(m_mutex);
+      watches.swap(m_watches);
+    }
+    for (auto& kv : watches)
+      stop_watch(kv.second.get());
+  }
+
+  bool add(const std::string& dir) {
+    HANDLE handle = CreateFileW(
+      from_utf8(dir).c_str(),
+      FILE_LIST_DIRECTORY,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr, OPEN_EXISTING,
+      FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+      return false;
+
+    auto w = std::make_unique<watch>();
+    w->handle = handle;
+    w->thread = std::thread([this, handle, dir]{ run(handle, dir); });
+
+    const std::lock_guard lock(m_mutex);
+    m_watches[dir] = std::move(w);
+    return true;
+  }
+
+  void remove(const std::string& dir) {
+    std::unique_ptr<watch> w;
+    {
+      const std::lock_guard lock(m_mutex);
+      auto it = m_watches.find(dir);
+      if (it == m_watches.end())
+        return;
+      w = std::move(it->second);
+      m_watches.erase(it);
+    }
+    stop_watch(w.get());
+  }
+
+private:
+  void stop_watch(watch* w) {
+    CancelIoEx(w->handle, nullptr);
+    CloseHandle(w->handle);
+    if (w->thread.joinable())
+      w->thread.join();
+  }
+
+  void run(HANDLE handle, const std::string dir) {
+    alignas(DWORD) char buf[8192];
+    DWORD bytes;
+
+    while (ReadDirectoryChangesW(
+             handle, buf, sizeof(buf), FALSE,
+             FILE_NOTIFY_CHANGE_FILE_NAME |
+             FILE_NOTIFY_CHANGE_DIR_NAME |
+             FILE_NOTIFY_CHANGE_SIZE |
+             FILE_NOTIFY_CHANGE_LAST_WRITE,
+             &bytes, nullptr, nullptr)) {
+      for (DWORD i=0; i<bytes; ) {
+        auto* fni = (const FILE_NOTIFY_INFORMATION*)&buf[i];
+
+        event e;
+        switch (fni->Action) {
+          case FILE_ACTION_ADDED:
+          case FILE_ACTION_RENAMED_NEW_NAME:
+            e.type = event_type::added;
+            break;
+          case FILE_ACTION_REMOVED:
+          case FILE_ACTION_RENAMED_OLD_NAME:
+            e.type = event_type::removed;
+            break;
+          default:
+            e.type = event_type::modified;
+            break;
+        }
+        e.path = join_path(
+          dir, to_utf8(fni->FileName,
+                       fni->FileNameLength / sizeof(WCHAR)));
+        m_queue.push(e);
+
+        if (fni->NextEntryOffset == 0)
+          break;
+        i += fni->NextEntryOffset;
+      }
+    }
+  }
+
+  event_queue& m_queue;
+  std::mutex m_mutex;
+  std::map<std::string, std::unique_ptr<watch>> m_watches;
+};
+
+} // namespace base
@@ -24,6 +24,8 @@
 #include <cctype>
 #include <cstdlib>
 #include <iterator>
+#include <mutex>
+#include <unordered_map>
 
 namespace base {
 
@@ -243,8 +245,34 @@ std::string fix_path_separators(const std::string& filename)
 
 std::string normalize_path(const std::string& filename)
 {
+  // get_canonical_path() asks the OS (realpath()/GetFullPathName())
+  // each time, so repeated lookups from recursive scans are memoized.
+  // Only absolute inputs are cached: the canonical form of a relative
+  // path depends on the current directory.
+  const bool cacheable =
+    (!filename.empty() &&
+     (is_path_separator(filename[0]) ||
+      (filename.size() >= 2 && filename[1] == ':')));
+
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::string> cache;
+
+  if (cacheable) {
+    const std::lock_guard lock(mutex);
+    auto it = cache.find(filename);
+    if (it != cache.end())
+      return it->second;
+  }
+
   std::string fn = base::get_canonical_path(filename);
   fn = base::fix_path_separators(fn);
+
+  if (cacheable) {
+    const std::lock_guard lock(mutex);
+    if (cache.size() >= 4096)   // Keep the cache bounded
+      cache.clear();
+    cache[filename] = fn;
+  }
   return fn;
 }
 
@@ -314,4 +342,77 @@ int compare_filenames(const std::string& a, const std::string& b)
   return 1;
 }
 
+filename_key::filename_key(const std::string& filename)
+{
+  utf8_decode dec(filename);
+  while (const int chr = dec.next())
+    m_chars.push_back(std::tolower(chr));
+
+  m_nums.resize(m_chars.size(), -1);
+  for (size_t i=0; i<m_chars.size(); ) {
+    if (m_chars[i] < '0' || m_chars[i] > '9') {
+      ++i;
+      continue;
+    }
+    size_t j = i;
+    while (j < m_chars.size() && m_chars[j] >= '0' && m_chars[j] <= '9')
+      ++j;
+    // compare_filenames() re-reads the digit run from each position
+    // it reaches, so the key stores the value of the run suffix
+    // starting at every digit.
+    for (size_t k=i; k<j; ++k) {
+      int num = 0;
+      for (size_t m=k; m<j; ++m)
+        num = (num*10 + (m_chars[m] - '0'));
+      m_nums[k] = num;
+    }
+    i = j;
+  }
+}
+
+int filename_key::compare(const filename_key& other) const
+{
+  // Same logic as compare_filenames(), but over the precomputed code
+  // points and digit-run values (both sides advance one code point
+  // per iteration there, so one index is enough here).
+  const size_t a_len = m_chars.size();
+  const size_t b_len = other.m_chars.size();
+  size_t i = 0;
+
+  for (; i<a_len && i<b_len; ++i) {
+    const int a_chr = m_chars[i];
+    const int b_chr = other.m_chars[i];
+
+    if ((a_chr >= '0') && (a_chr <= '9') && (b_chr >= '0') && (b_chr <= '9')) {
+      if (m_nums[i] != other.m_nums[i])
+        return m_nums[i] < other.m_nums[i] ? -1: 1;
+    }
+    else if (is_path_separator(a_chr) && is_path_separator(b_chr)) {
+      // Go to next char
+    }
+    else if (a_chr != b_chr)
+      return a_chr - b_chr < 0 ? -1: 1;
+  }
+
+  if (i == a_len && i == b_len)
+    return 0;
+  return (i == a_len ? -1: 1);
+}
+
+void sort_filenames(std::vector<std::string>& filenames)
+{
+  std::vector<std::pair<filename_key, std::string>> items;
+  items.reserve(filenames.size());
+  for (auto& fn : filenames)
+    items.emplace_back(filename_key(fn), std::move(fn));
+
+  std::stable_sort(items.begin(), items.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.first < b.first;
+                   });
+
+  for (size_t i=0; i<items.size(); ++i)
+    filenames[i] = std::move(items[i].second);
+}
+
 } // namespace base
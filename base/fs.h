@@ -10,13 +10,14 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "base/paths.h"
+#include "base/time.h"
 
 namespace base {
 
-  class Time;
-
   // Default path separator (on Windows it is '\' and on Unix-like systems it is '/').
   extern const std::string::value_type path_separator;
 
@@ -55,6 +56,57 @@ namespace base {
 
   paths list_files(const std::string& path);
 
+  // One directory entry with the metadata that the OS enumeration
+  // already provides (see list_files_with_details()).
+  struct file_details {
+    std::string name;
+    bool isDirectory = false;
+    size_t size = 0;
+    Time modificationTime;
+  };
+
+  // Like list_files() but captures size/mtime/kind while enumerating
+  // (WIN32_FIND_DATA on Windows, one fstatat() per entry on POSIX)
+  // instead of the three stat round-trips that calling
+  // is_directory()+file_size()+get_modification_time() per entry
+  // costs, which is what hurts on network mounts.
+  std::vector<file_details> list_files_with_details(const std::string& path);
+
+  // Lazy directory scanner: yields one entry per next() call so
+  // callers can early-out (or stream a huge directory) without
+  // materializing the whole file list like list_files() does. The
+  // "." and ".." entries are skipped.
+  class dir_iterator {
+  public:
+    explicit dir_iterator(const std::string& path);
+    ~dir_iterator();
+
+    dir_iterator(const dir_iterator&) = delete;
+    dir_iterator& operator=(const dir_iterator&) = delete;
+
+    // Advances to the next entry, returns false when there are no
+    // more entries (name()/is_directory() are valid after a true
+    // result).
+    bool next();
+
+    const std::string& name() const { return m_name; }
+
+    // Uses the metadata that the OS already gave us with the entry
+    // (dirent d_type / WIN32_FIND_DATA attributes) so it doesn't cost
+    // one extra stat per file.
+    bool is_directory() const { return m_isDir; }
+
+  private:
+    void* m_handle = nullptr;
+    std::string m_path;
+    std::string m_name;
+    bool m_isDir = false;
+#if LAF_WINDOWS
+    void* m_data = nullptr;     // WIN32_FIND_DATA of the current entry
+    bool m_first = false;
+#endif
+  };
+
   // Returns true if the given character is a valud path separator
   // (any of '\' or '/' characters).
   bool is_path_separator(std::string::value_type chr);
@@ -78,6 +130,23 @@ namespace base {
   // Joins two paths or a path and a file name with a path-separator.
   std::string join_path(const std::string& path, const std::string& file);
 
+  // Joins any number of path components in one pass: the final size
+  // is measured once and the result written once, instead of the
+  // pairwise copies that chained join_path() calls produce.
+  template<typename... Parts>
+  std::string join_paths(const std::string_view first, const Parts&... parts) {
+    std::string result;
+    result.reserve(first.size() + (std::size_t(0) + ... + (1 + std::string_view(parts).size())));
+    result += first;
+    const auto append = [&result](const std::string_view part) {
+      if (!result.empty() && !is_path_separator(result.back()))
+        result.push_back(path_separator);
+      result += part;
+    };
+    (append(std::string_view(parts)), ...);
+    return result;
+  }
+
   // Removes the trailing separator from the given path.
   std::string remove_path_separator(const std::string& path);
 
@@ -95,6 +164,33 @@ namespace base {
 
   int compare_filenames(const std::string& a, const std::string& b);
 
+  // Precomputed sort key for compare_filenames(): the UTF-8 decoding,
+  // case folding, and digit-run values are resolved once at
+  // construction, so sorting a big listing doesn't redo that work on
+  // each comparison. compare() returns the same result as
+  // compare_filenames() on the original strings.
+  class filename_key {
+  public:
+    filename_key() { }
+    explicit filename_key(const std::string& filename);
+
+    int compare(const filename_key& other) const;
+    bool operator<(const filename_key& other) const {
+      return compare(other) < 0;
+    }
+
+  private:
+    std::vector<int> m_chars;   // Case-folded code points
+    std::vector<int> m_nums;    // Value of the digit run starting at
+                                // each position (-1 on non-digits)
+  };
+
+  // Sorts filenames in compare_filenames() order building one
+  // filename_key per item instead of re-decoding both strings on
+  // every comparison (keeps the relative order of filenames that
+  // compare equal, e.g. same name with different case).
+  void sort_filenames(std::vector<std::string>& filenames);
+
 #if LAF_WINDOWS
   class Version;
   Version get_file_version(const std::string& filename);
@@ -6,8 +6,11 @@
 
 #include <gtest/gtest.h>
 
+#include "base/file_content.h"
 #include "base/fs.h"
 
+#include <set>
+
 using namespace base;
 
 TEST(FS, MakeDirectory)
@@ -215,6 +218,116 @@ TEST(FS, CompareFilenames)
   EXPECT_EQ(1, compare_filenames("a1-64-10.png", "a1-64-9.png"));
 }
 
+TEST(FS, FilenameKey)
+{
+  // filename_key must reproduce compare_filenames() for any pair
+  const char* names[] = { "a", "A", "b", "aa", "a0", "a1", "a1B",
+                          "a0.png", "a1.png", "a1-1.png", "a1-2.png",
+                          "a1-10.png", "a1-64-2.png", "a1-64-10.png",
+                          "a32.txt", "a32l.txt", "a32-16.txt32",
+                          "dir/file", "dir\\file", "001", "1", "01a", "1a" };
+  for (const char* a : names) {
+    for (const char* b : names) {
+      EXPECT_EQ(compare_filenames(a, b),
+                filename_key(a).compare(filename_key(b)))
+        << "  comparing " << a << " with " << b;
+    }
+  }
+
+  std::vector<std::string> fns = { "a1-10.png", "b", "a1-2.png",
+                                   "A", "a1-1.png" };
+  sort_filenames(fns);
+  ASSERT_EQ(5, fns.size());
+  EXPECT_EQ("A", fns[0]);
+  EXPECT_EQ("a1-1.png", fns[1]);
+  EXPECT_EQ("a1-2.png", fns[2]);
+  EXPECT_EQ("a1-10.png", fns[3]);
+  EXPECT_EQ("b", fns[4]);
+}
+
+TEST(FS, DirIterator)
+{
+  make_all_directories("dit/sub");
+  ASSERT_TRUE(is_directory("dit/sub"));
+  write_file_content("dit/f1.txt", (const uint8_t*)"a", 1);
+  write_file_content("dit/f2.txt", (const uint8_t*)"b", 1);
+
+  std::set<std::string> found;
+  int ndirs = 0;
+  dir_iterator it("dit");
+  while (it.next()) {
+    found.insert(it.name());
+    if (it.is_directory())
+      ++ndirs;
+  }
+
+  EXPECT_EQ(3, found.size());
+  EXPECT_EQ(1, ndirs);
+  EXPECT_TRUE(found.find("sub") != found.end());
+  EXPECT_TRUE(found.find("f1.txt") != found.end());
+  EXPECT_TRUE(found.find("f2.txt") != found.end());
+
+  // Iterating a non-existent directory yields nothing
+  dir_iterator none("_no_such_dir_");
+  EXPECT_FALSE(none.next());
+
+  delete_file("dit/f1.txt");
+  delete_file("dit/f2.txt");
+  remove_directory("dit/sub");
+  remove_directory("dit");
+}
+
+TEST(FS, ListFilesWithDetails)
+{
+  make_all_directories("lfd/sub");
+  ASSERT_TRUE(is_directory("lfd/sub"));
+  write_file_content("lfd/f1.txt", (const uint8_t*)"ab", 2);
+
+  auto files = list_files_with_details("lfd");
+  ASSERT_EQ(2, files.size());
+  for (const auto& f : files) {
+    if (f.name == "sub") {
+      EXPECT_TRUE(f.isDirectory);
+    }
+    else {
+      EXPECT_EQ("f1.txt", f.name);
+      EXPECT_FALSE(f.isDirectory);
+      EXPECT_EQ(2, f.size);
+      // Must match the metadata of the per-file queries
+      EXPECT_EQ(get_modification_time("lfd/f1.txt"), f.modificationTime);
+    }
+  }
+
+  EXPECT_TRUE(list_files_with_details("_no_such_dir_").empty());
+
+  delete_file("lfd/f1.txt");
+  remove_directory("lfd/sub");
+  remove_directory("lfd");
+}
+
+TEST(FS, JoinPaths)
+{
+#if LAF_WINDOWS
+  EXPECT_EQ("a\\b\\c\\d.png", join_paths("a", "b", "c", "d.png"));
+#else
+  EXPECT_EQ("a/b/c/d.png", join_paths("a", "b", "c", "d.png"));
+#endif
+
+  // Must compose exactly like chained join_path() calls
+  const std::string chained =
+    join_path(join_path(join_path("base", "gfx"), "os"), "file.h");
+  EXPECT_EQ(chained, join_paths("base", "gfx", "os", "file.h"));
+  EXPECT_EQ(join_path("", "file"), join_paths("", "file"));
+  EXPECT_EQ(join_path("dir/", "file"), join_paths("dir/", "file"));
+}
+
+TEST(FS, NormalizePathIsStable)
+{
+  const std::string cwd = get_current_path();
+  // Twice to hit the cache the second time
+  EXPECT_EQ(normalize_path(cwd), normalize_path(cwd));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
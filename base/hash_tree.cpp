@@ -0,0 +1,71 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/hash_tree.h"
+
+#include "base/fs.h"
+#include "base/parallel.h"
+
+#include <algorithm>
+
+namespace base {
+
+static void collect_files(const std::string& dir,
+                          const std::string& relPrefix,
+                          std::vector<std::string>& files)
+{
+  dir_iterator it(dir);
+  while (it.next()) {
+    // "/" as separator even on Windows so the manifest (and its root
+    // digest) is identical across platforms.
+    const std::string rel =
+      (relPrefix.empty() ? it.name():
+                           relPrefix + "/" + it.name());
+    if (it.is_directory())
+      collect_files(join_path(dir, it.name()), rel, files);
+    else
+      files.push_back(rel);
+  }
+}
+
+tree_manifest hash_tree(const std::string& dir)
+{
+  tree_manifest manifest;
+
+  std::vector<std::string> files;
+  collect_files(dir, std::string(), files);
+
+  // Sorted before hashing so the manifest order (and the root
+  // digest) doesn't depend on the enumeration order of the OS.
+  std::sort(files.begin(), files.end());
+
+  manifest.files.resize(files.size());
+  // Grain of one file per chunk: file sizes vary wildly, a fixed
+  // grain would serialize several big files on one worker.
+  parallel_for(
+    files.size(), 1,
+    [&manifest, &files, &dir](const size_t i){
+      manifest.files[i].path = std::move(files[i]);
+      manifest.files[i].hash =
+        Sha1::calculateFromFile(join_path(dir, manifest.files[i].path));
+    });
+
+  Sha1::Stream stream;
+  for (const auto& file : manifest.files) {
+    stream.update((const uint8_t*)file.path.c_str(),
+                  file.path.size()+1); // Includes the null char as separator
+    stream.update(file.hash.digest(), Sha1::HashSize);
+  }
+  manifest.root = stream.digest();
+
+  return manifest;
+}
+
+} // namespace base
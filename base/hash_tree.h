@@ -0,0 +1,47 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_HASH_TREE_H_INCLUDED
+#define BASE_HASH_TREE_H_INCLUDED
+#pragma once
+
+#include "base/sha1.h"
+
+#include <string>
+#include <vector>
+
+namespace base {
+
+  // Manifest of a whole directory tree: one SHA-1 per regular file,
+  // with paths relative to the hashed root (always using "/" as
+  // separator and sorted), plus a root digest calculated over the
+  // sorted (path, hash) pairs so two trees can be compared with a
+  // single Sha1 comparison.
+  struct tree_manifest {
+    struct file_t {
+      std::string path;
+      Sha1 hash;
+    };
+    std::vector<file_t> files;
+    Sha1 root;
+
+    bool operator==(const tree_manifest& other) const {
+      return root == other.root;
+    }
+    bool operator!=(const tree_manifest& other) const {
+      return root != other.root;
+    }
+  };
+
+  // Walks the given directory recursively with the lazy dir_iterator
+  // and hashes every regular file in parallel on the shared thread
+  // pool, so verifying a multi-thousand-file asset tree takes the
+  // time of the largest files instead of the sum of all of them.
+  tree_manifest hash_tree(const std::string& dir);
+
+} // namespace base
+
+#endif
@@ -0,0 +1,67 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/hash_tree.h"
+
+using namespace base;
+
+TEST(HashTree, Manifest)
+{
+  make_all_directories("ht/sub");
+  ASSERT_TRUE(is_directory("ht/sub"));
+  write_file_content("ht/a.txt", (const uint8_t*)"hello", 5);
+  write_file_content("ht/sub/b.txt", (const uint8_t*)"world", 5);
+
+  const tree_manifest manifest = hash_tree("ht");
+  ASSERT_EQ(2, manifest.files.size());
+
+  // Sorted relative paths with "/" separators
+  EXPECT_EQ("a.txt", manifest.files[0].path);
+  EXPECT_EQ("sub/b.txt", manifest.files[1].path);
+
+  // Per-file hashes match the one-at-a-time calculation
+  EXPECT_EQ(Sha1::calculateFromFile("ht/a.txt"), manifest.files[0].hash);
+  EXPECT_EQ(Sha1::calculateFromFile("ht/sub/b.txt"), manifest.files[1].hash);
+
+  // Hashing the same tree again gives the same root digest...
+  EXPECT_EQ(manifest, hash_tree("ht"));
+
+  // ...and changing one file changes it
+  write_file_content("ht/a.txt", (const uint8_t*)"HELLO", 5);
+  EXPECT_NE(manifest, hash_tree("ht"));
+
+  delete_file("ht/a.txt");
+  delete_file("ht/sub/b.txt");
+  remove_directory("ht/sub");
+  remove_directory("ht");
+}
+
+TEST(HashTree, BigTree)
+{
+  make_directory("ht2");
+  for (int i=0; i<200; ++i) {
+    const std::string fn = "ht2/f" + std::to_string(i);
+    write_file_content(fn, (const uint8_t*)fn.c_str(), fn.size());
+  }
+
+  const tree_manifest manifest = hash_tree("ht2");
+  EXPECT_EQ(200, manifest.files.size());
+  EXPECT_EQ(manifest.root, hash_tree("ht2").root);
+
+  for (int i=0; i<200; ++i)
+    delete_file("ht2/f" + std::to_string(i));
+  remove_directory("ht2");
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,74 @@
+// LAF Base Library
+// Copyright (c) 2022 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/hex.h"
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace base {
+
+std::string to_hex(const uint8_t* data, const size_t size)
+{
+  std::string result;
+  result.resize(2*size);
+  if (size == 0)
+    return result;
+
+  char* out = &result[0];
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  // Convert 16 bytes -> 32 chars per iteration: split each byte in
+  // nibbles and add '0' or ('a'-10) depending on the nibble value
+  const __m128i mask0F = _mm_set1_epi8(0x0f);
+  const __m128i char0 = _mm_set1_epi8('0');
+  const __m128i nine = _mm_set1_epi8(9);
+  const __m128i gap = _mm_set1_epi8('a'-'0'-10);
+  for (; i+16 <= size; i += 16, out += 32) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)(data+i));
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), mask0F);
+    const __m128i lo = _mm_and_si128(in, mask0F);
+
+    const __m128i hiChars = _mm_add_epi8(
+      _mm_add_epi8(hi, char0),
+      _mm_and_si128(_mm_cmpgt_epi8(hi, nine), gap));
+    const __m128i loChars = _mm_add_epi8(
+      _mm_add_epi8(lo, char0),
+      _mm_and_si128(_mm_cmpgt_epi8(lo, nine), gap));
+
+    _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(hiChars, loChars));
+    _mm_storeu_si128((__m128i*)(out+16), _mm_unpackhi_epi8(hiChars, loChars));
+  }
+#endif
+
+  for (; i<size; ++i) {
+    static const char digits[] = "0123456789abcdef";
+    *out++ = digits[data[i] >> 4];
+    *out++ = digits[data[i] & 0x0f];
+  }
+  return result;
+}
+
+buffer from_hex(const std::string_view hex)
+{
+  const size_t size = hex.size()/2;
+  buffer result;
+  result.resize(size);
+
+  for (size_t i=0; i<size; ++i) {
+    result[i] = uint8_t((hex_to_int(hex[2*i]) << 4) |
+                        hex_to_int(hex[2*i+1]));
+  }
+  return result;
+}
+
+} // namespace base
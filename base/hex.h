@@ -9,6 +9,11 @@
 #define BASE_HEX_H_INCLUDED
 #pragma once
 
+#include "base/buffer.h"
+
+#include <string>
+#include <string_view>
+
 namespace base {
 
   inline bool is_hex_digit(const char c) {
@@ -24,6 +29,18 @@ namespace base {
     return 0;
   }
 
+  // Bulk conversions with one upfront allocation (lowercase digits,
+  // no separators), for hashes/blobs in session files.
+  std::string to_hex(const uint8_t* data, size_t size);
+
+  inline std::string to_hex(const buffer& buf) {
+    return to_hex(buf.data(), buf.size());
+  }
+
+  // Decodes pairs of hex digits; non-hex characters count as 0, like
+  // hex_to_int(). An odd trailing digit is ignored.
+  buffer from_hex(std::string_view hex);
+
 } // namespace base
 
 #endif
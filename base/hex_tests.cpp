@@ -0,0 +1,47 @@
+// LAF Base Library
+// Copyright (c) 2022 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/hex.h"
+
+using namespace base;
+
+TEST(Hex, ToHex)
+{
+  EXPECT_EQ("", to_hex(buffer()));
+  EXPECT_EQ("00ff10ab", to_hex(buffer{0x00, 0xff, 0x10, 0xab}));
+
+  // Long buffer to exercise the bulk kernel and its tail
+  buffer buf(41);
+  for (size_t i=0; i<buf.size(); ++i)
+    buf[i] = uint8_t(i*7 + 3);
+  const std::string hex = to_hex(buf);
+  ASSERT_EQ(82, hex.size());
+  for (size_t i=0; i<buf.size(); ++i) {
+    EXPECT_EQ(hex_to_int(hex[2*i]), buf[i] >> 4);
+    EXPECT_EQ(hex_to_int(hex[2*i+1]), buf[i] & 0x0f);
+  }
+}
+
+TEST(Hex, FromHex)
+{
+  EXPECT_EQ(buffer(), from_hex(""));
+  EXPECT_EQ(buffer({0x00, 0xff, 0x10, 0xab}), from_hex("00ff10ab"));
+  EXPECT_EQ(buffer({0x00, 0xff, 0x10, 0xab}), from_hex("00FF10AB"));
+
+  // Roundtrip
+  buffer buf(100);
+  for (size_t i=0; i<buf.size(); ++i)
+    buf[i] = uint8_t(255-i);
+  EXPECT_EQ(buf, from_hex(to_hex(buf)));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -13,6 +13,7 @@
 #include "base/fs.h"
 #include "base/launcher.h"
 #include "base/string.h"
+#include "base/thread_pool.h"
 
 #include <cstdlib>
 
@@ -136,5 +137,40 @@ bool open_folder(const std::string& _file)
 #endif
 }
 
+// Shared spawn context for the *_async() variants: the first call
+// pays the worker-thread creation, later launches just enqueue on
+// it, and it exits again after a few seconds of inactivity.
+static thread_pool& spawn_pool()
+{
+  static thread_pool pool(1, std::chrono::seconds(5),
+                          thread_pool::policy{ "launcher" });
+  return pool;
+}
+
+void open_url_async(const std::string& url, callback cb)
+{
+  open_file_async(url, std::move(cb));
+}
+
+void open_file_async(const std::string& file, callback cb)
+{
+  spawn_pool().execute(
+    [file, cb = std::move(cb)]{
+      const bool ok = open_file(file);
+      if (cb)
+        cb(ok);
+    });
+}
+
+void open_folder_async(const std::string& file, callback cb)
+{
+  spawn_pool().execute(
+    [file, cb = std::move(cb)]{
+      const bool ok = open_folder(file);
+      if (cb)
+        cb(ok);
+    });
+}
+
 } // namespace launcher
 } // namespace base
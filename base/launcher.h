@@ -8,6 +8,7 @@
 #define BASE_LAUNCHER_H_INCLUDED
 #pragma once
 
+#include <functional>
 #include <string>
 
 namespace base {
@@ -17,6 +18,21 @@ bool open_url(const std::string& url);
 bool open_file(const std::string& file);
 bool open_folder(const std::string& file);
 
+// Result callback for the *_async() variants below. Invoked from the
+// launcher worker thread right after the spawn call finishes, with
+// the same value the blocking variant returns.
+using callback = std::function<void(bool ok)>;
+
+// Like open_url()/open_file()/open_folder() but spawning from a
+// shared worker thread, so the caller (usually the UI thread) never
+// blocks on process creation (fork/exec or ShellExecuteEx can take
+// hundreds of milliseconds). Launches run in call order; the worker
+// is created on the first call, reused across launches, and exits
+// after a few seconds of inactivity.
+void open_url_async(const std::string& url, callback cb = nullptr);
+void open_file_async(const std::string& file, callback cb = nullptr);
+void open_folder_async(const std::string& file, callback cb = nullptr);
+
 } // namespace launcher
 } // namespace base
 
@@ -11,17 +11,18 @@
 
 #include "base/log.h"
 
+#include "base/concurrent_queue.h"
 #include "base/debug.h"
-#include "base/fstream_path.h"
+#include "base/file.h"
 
 #include <atomic>
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
-#include <fstream>
-#include <iostream>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -30,23 +31,71 @@ namespace {
 // errors and fatal errors.
 std::atomic<LogLevel> log_level(LogLevel::ERROR);
 std::mutex log_mutex;
-std::ofstream log_stream;
-std::ostream* log_ostream = &std::cerr;
+base::file log_file;
 std::string log_filename;
 
+void write_log_message(const char* data, const size_t size)
+{
+  const std::lock_guard lock(log_mutex);
+  if (log_file.is_open()) {
+    // One unbuffered write syscall per message, no stream
+    // buffer+flush round-trip
+    log_file.write(data, size);
+  }
+  else {
+    std::fwrite(data, 1, size, stderr);
+    std::fflush(stderr);
+  }
+}
+
+// Background writer used in asynchronous mode: messages are dropped
+// (and counted) when the bounded queue is full, so the producer
+// threads never stall on I/O.
+struct AsyncLogger {
+  base::concurrent_queue<std::string,
+                         base::queue_policy::lock_free> queue;
+  std::atomic<bool> running = { true };
+  std::thread thread;
+
+  AsyncLogger() : thread([this]{ run(); }) { }
+
+  ~AsyncLogger() {
+    running = false;
+    thread.join();
+  }
+
+  void run() {
+    std::string msg;
+    while (running) {
+      bool wrote = false;
+      while (queue.try_pop(msg)) {
+        write_log_message(msg.data(), msg.size());
+        wrote = true;
+      }
+      if (!wrote)
+        std::this_thread::sleep_for(std::chrono::milliseconds(4));
+    }
+    // Drain whatever is left before finishing
+    while (queue.try_pop(msg))
+      write_log_message(msg.data(), msg.size());
+  }
+};
+
+std::mutex async_logger_mutex;
+std::unique_ptr<AsyncLogger> async_logger;
+std::atomic<bool> log_async(false);
+std::atomic<size_t> log_dropped(0);
+
 } // anonymous namespace
 
 void base::set_log_filename(const char* filename)
 {
-  if (log_stream.is_open()) {
-    log_stream.close();
-    log_ostream = &std::cerr;
-  }
+  const std::lock_guard lock(log_mutex);
+  log_file.close();
 
   if (filename) {
     log_filename = filename;
-    log_stream.open(FSTREAM_PATH(log_filename));
-    log_ostream = &log_stream;
+    log_file.open(log_filename, base::file::mode::write);
   }
   else {
     log_filename = std::string();
@@ -63,6 +112,48 @@ LogLevel base::get_log_level()
   return log_level;
 }
 
+void base::set_log_async(const bool async)
+{
+  const std::lock_guard lock(async_logger_mutex);
+  if (async && !async_logger) {
+    // The writer is created once and kept for the whole process life
+    // (destroyed/drained at exit), so producers can check the
+    // log_async flag and use the queue without any lock.
+    async_logger = std::make_unique<AsyncLogger>();
+  }
+  log_async = (async && async_logger != nullptr);
+}
+
+size_t base::get_log_dropped_count()
+{
+  return log_dropped;
+}
+
+static void emit_log_message(const char* data, const size_t size)
+{
+  if (log_async) {
+    // The AsyncLogger is never destroyed while the flag is set, so no
+    // lock is needed here
+    if (!async_logger->queue.try_push(std::string(data, size)))
+      ++log_dropped;
+  }
+  else {
+    write_log_message(data, size);
+  }
+
+#ifdef _DEBUG
+  fwrite(data, 1, size, stderr);
+  fflush(stderr);
+#endif
+}
+
+void base::log_text(const LogLevel level, const char* data, const size_t size)
+{
+  if (log_level < level || !data || size == 0)
+    return;
+  emit_log_message(data, size);
+}
+
 static void LOGva(const char* format, va_list ap)
 {
   va_list apTmp;
@@ -75,17 +166,7 @@ static void LOGva(const char* format, va_list ap)
   std::vector<char> buf(size+1);
   std::vsnprintf(buf.data(), buf.size(), format, ap);
 
-  {
-    const std::lock_guard lock(log_mutex);
-    ASSERT(log_ostream);
-    log_ostream->write(buf.data(), size);
-    log_ostream->flush();
-  }
-
-#ifdef _DEBUG
-  fputs(buf.data(), stderr);
-  fflush(stderr);
-#endif
+  emit_log_message(buf.data(), size);
 }
 
 void LOG(const char* format, ...)
@@ -27,8 +27,20 @@ enum LogLevel {
   VERBOSE = 5, // Information step by step
 };
 
+// Maximum level compiled into the binary: CLOG()/LOG_FIELDS() calls
+// above this level are removed entirely at compile time. Can be
+// overridden from the build, e.g. -DLAF_COMPILED_LOG_LEVEL=INFO to
+// strip VERBOSE logging from release builds.
+#ifndef LAF_COMPILED_LOG_LEVEL
+#define LAF_COMPILED_LOG_LEVEL VERBOSE
+#endif
+
 #ifdef __cplusplus
+#include <charconv>
 #include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 namespace base {
 
@@ -36,12 +48,95 @@ namespace base {
   void set_log_level(LogLevel level);
   LogLevel get_log_level();
 
+  // Asynchronous mode: messages are formatted in the calling thread,
+  // pushed into a bounded lock-free queue and written/flushed by a
+  // background thread, so LOG() never blocks on file I/O. If the
+  // queue is full the message is dropped and counted instead of
+  // stalling the caller.
+  void set_log_async(bool async);
+  size_t get_log_dropped_count();
+
+  // Writes an already-formatted message to the log sink if the
+  // runtime level allows it (honoring the async mode).
+  void log_text(LogLevel level, const char* data, size_t size);
+
+  namespace details {
+
+    inline void append_log_value(std::string& out, const char* value) {
+      out += value;
+    }
+    inline void append_log_value(std::string& out, const std::string& value) {
+      out += value;
+    }
+    template<typename T>
+    inline void append_log_value(std::string& out, const T value) {
+      static_assert(std::is_arithmetic_v<T>, "Unsupported log field type");
+      if constexpr (std::is_same_v<T, bool>) {
+        out += (value ? "true": "false");
+      }
+      else {
+        // std::to_chars instead of ostream/printf formatting
+        char buf[32];
+        const auto result = std::to_chars(buf, buf+sizeof(buf), value);
+        out.append(buf, result.ptr);
+      }
+    }
+
+    inline void append_log_fields(std::string&) { }
+
+    template<typename Value, typename... Rest>
+    void append_log_fields(std::string& out,
+                           const char* key,
+                           const Value& value,
+                           Rest&&... rest) {
+      out.push_back(' ');
+      out += key;
+      out.push_back('=');
+      append_log_value(out, value);
+      append_log_fields(out, std::forward<Rest>(rest)...);
+    }
+
+  } // namespace details
+
+  // Structured fast path: log_fields(INFO, "frame", "ms", 16.6,
+  // "draws", 120) writes "frame ms=16.6 draws=120\n" formatting the
+  // numeric fields with std::to_chars (no ostream, no printf).
+  template<typename... Fields>
+  void log_fields(const LogLevel level,
+                  const char* event,
+                  Fields&&... fields) {
+    if (get_log_level() < level)
+      return;
+    std::string msg;
+    msg.reserve(64);
+    msg += event;
+    details::append_log_fields(msg, std::forward<Fields>(fields)...);
+    msg.push_back('\n');
+    log_text(level, msg.data(), msg.size());
+  }
+
 } // namespace base
 
 // E.g. LOG("text in information log level\n");
 void LOG(const char* format, ...);
 void LOG(LogLevel level, const char* format, ...);
 
+// Compile-time gated variants: when the level is above
+// LAF_COMPILED_LOG_LEVEL the whole statement is discarded at compile
+// time, so hot loops can keep VERBOSE logging with zero cost in
+// builds that strip it.
+#define CLOG(level, ...)                                \
+  do {                                                  \
+    if constexpr ((level) <= LAF_COMPILED_LOG_LEVEL)    \
+      LOG(level, __VA_ARGS__);                          \
+  } while (0)
+
+#define LOG_FIELDS(level, ...)                          \
+  do {                                                  \
+    if constexpr ((level) <= LAF_COMPILED_LOG_LEVEL)    \
+      base::log_fields(level, __VA_ARGS__);             \
+  } while (0)
+
 inline void LOG(int) {
   // This is in case LOG() is used with an integer value instead of
   // LogLevel, an error must be triggered (e.g. on wingdi.h ERROR is
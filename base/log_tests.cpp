@@ -0,0 +1,94 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/log.h"
+
+#include <thread>
+#include <vector>
+
+TEST(Log, SyncBasic)
+{
+  const char* fn = "_log_test_.txt";
+  base::set_log_filename(fn);
+  base::set_log_level(LogLevel::INFO);
+
+  LOG("hello %d\n", 42);
+  LOG(VERBOSE, "this should be filtered out\n");
+
+  base::set_log_filename(nullptr);
+
+  const base::buffer buf = base::read_file_content(fn);
+  const std::string content((const char*)buf.data(), buf.size());
+  EXPECT_NE(std::string::npos, content.find("hello 42"));
+  EXPECT_EQ(std::string::npos, content.find("filtered"));
+}
+
+TEST(Log, AsyncModeWritesEverything)
+{
+  const char* fn = "_log_async_test_.txt";
+  base::set_log_filename(fn);
+  base::set_log_level(LogLevel::INFO);
+  base::set_log_async(true);
+
+  std::vector<std::thread> threads;
+  for (int i=0; i<4; ++i) {
+    threads.emplace_back([i]{
+      for (int j=0; j<100; ++j)
+        LOG("thread %d message %d\n", i, j);
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  base::set_log_async(false);
+
+  // Give the background writer a moment to drain
+  int lines = 0;
+  for (int retry=0; retry<100; ++retry) {
+    const base::buffer buf = base::read_file_content(fn);
+    lines = 0;
+    for (const uint8_t chr : buf)
+      if (chr == '\n')
+        ++lines;
+    if (lines + int(base::get_log_dropped_count()) >= 400)
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  base::set_log_filename(nullptr);
+  EXPECT_EQ(400, lines + int(base::get_log_dropped_count()));
+}
+
+TEST(Log, CompileTimeGateAndFields)
+{
+  const char* fn = "_log_fields_test_.txt";
+  base::set_log_filename(fn);
+  base::set_log_level(LogLevel::INFO);
+
+  LOG_FIELDS(INFO, "frame", "ms", 16.5, "draws", 120, "vsync", true);
+  CLOG(INFO, "compiled in\n");
+
+  // VERBOSE is filtered at runtime here (and would be removed at
+  // compile time with -DLAF_COMPILED_LOG_LEVEL=INFO)
+  LOG_FIELDS(VERBOSE, "hidden", "x", 1);
+
+  base::set_log_filename(nullptr);
+
+  const base::buffer buf = base::read_file_content(fn);
+  const std::string content((const char*)buf.data(), buf.size());
+  EXPECT_NE(std::string::npos, content.find("frame ms=16.5 draws=120 vsync=true"));
+  EXPECT_NE(std::string::npos, content.find("compiled in"));
+  EXPECT_EQ(std::string::npos, content.find("hidden"));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -9,34 +9,134 @@
 #include "config.h"
 #endif
 
+#include "base/memory.h"
+
+#include <atomic>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <mutex>
 
+#if LAF_WINDOWS
+  #include <malloc.h>           // _msize()
+#elif __APPLE__
+  #include <malloc/malloc.h>    // malloc_size()
+#else
+  #include <malloc.h>           // malloc_usable_size()
+#endif
+
 using namespace std;
 
+//////////////////////////////////////////////////////////////////////
+// Always-on allocation counters (see base_alloc_stats). Sizes are
+// taken from the allocator itself so base_free() can account the
+// block without carrying the size around.
+
+static std::atomic<size_t> g_inUse(0);
+static std::atomic<size_t> g_peak(0);
+static std::atomic<size_t> g_count(0);
+static std::atomic<size_t> g_buckets[base_alloc_stats::kBuckets];
+
+static inline size_t block_size(void* mem)
+{
+#if LAF_WINDOWS
+  return _msize(mem);
+#elif __APPLE__
+  return malloc_size(mem);
+#else
+  return malloc_usable_size(mem);
+#endif
+}
+
+static inline int size_bucket(const size_t size)
+{
+  int i = 0;
+  while (i < base_alloc_stats::kBuckets-1 && (size_t(1) << i) < size)
+    ++i;
+  return i;
+}
+
+static inline void track_alloc(void* mem)
+{
+  const size_t size = block_size(mem);
+  const size_t inUse =
+    g_inUse.fetch_add(size, std::memory_order_relaxed) + size;
+  g_count.fetch_add(1, std::memory_order_relaxed);
+  g_buckets[size_bucket(size)].fetch_add(1, std::memory_order_relaxed);
+
+  size_t peak = g_peak.load(std::memory_order_relaxed);
+  while (inUse > peak &&
+         !g_peak.compare_exchange_weak(peak, inUse,
+                                       std::memory_order_relaxed))
+    ;
+}
+
+static inline void track_free_size(const size_t size)
+{
+  g_inUse.fetch_sub(size, std::memory_order_relaxed);
+  g_buckets[size_bucket(size)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+static inline void track_free(void* mem)
+{
+  track_free_size(block_size(mem));
+}
+
+base_alloc_stats base_get_alloc_stats()
+{
+  base_alloc_stats stats;
+  stats.inUse = g_inUse.load(std::memory_order_relaxed);
+  stats.peak = g_peak.load(std::memory_order_relaxed);
+  stats.count = g_count.load(std::memory_order_relaxed);
+  for (int i=0; i<base_alloc_stats::kBuckets; ++i)
+    stats.buckets[i] = g_buckets[i].load(std::memory_order_relaxed);
+  return stats;
+}
+
+void base_reset_alloc_stats()
+{
+  g_peak.store(g_inUse.load(std::memory_order_relaxed),
+               std::memory_order_relaxed);
+  g_count.store(0, std::memory_order_relaxed);
+}
+
 #if !defined LAF_MEMLEAK            // Without leak detection
 
 void* base_malloc(size_t bytes)
 {
-  return malloc(bytes);
+  void* mem = malloc(bytes);
+  if (mem)
+    track_alloc(mem);
+  return mem;
 }
 
 void* base_malloc0(size_t bytes)
 {
-  return calloc(1, bytes);
+  void* mem = calloc(1, bytes);
+  if (mem)
+    track_alloc(mem);
+  return mem;
 }
 
 void* base_realloc(void* mem, size_t bytes)
 {
-  return realloc(mem, bytes);
+  // The old block size must be read before realloc() invalidates the
+  // pointer, but only accounted if the reallocation succeeds.
+  const size_t oldSize = (mem ? block_size(mem): 0);
+  void* newmem = realloc(mem, bytes);
+  if (newmem) {
+    if (mem)
+      track_free_size(oldSize);
+    track_alloc(newmem);
+  }
+  return newmem;
 }
 
 void base_free(void* mem)
 {
   assert(mem);
+  track_free(mem);
   free(mem);
 }
 
@@ -44,10 +144,13 @@ char* base_strdup(const char* string)
 {
   assert(string);
 #ifdef _MSC_VER
-  return _strdup(string);
+  char* mem = _strdup(string);
 #else
-  return strdup(string);
+  char* mem = strdup(string);
 #endif
+  if (mem)
+    track_alloc(mem);
+  return mem;
 }
 
 #else  // With leak detection
@@ -69,9 +172,20 @@ struct slot_t {
   struct slot_t* next;
 };
 
+// The tracking list is sharded by pointer hash so concurrent
+// allocations from several threads don't serialize on a single lock.
+#define MEMLEAK_SHARDS 64
+
 static bool memleak_status = false;
-static slot_t* headslot;
-static std::mutex g_mutex;
+static slot_t* headslot[MEMLEAK_SHARDS];
+static std::mutex g_mutex[MEMLEAK_SHARDS];
+
+static inline int slot_shard(void* ptr)
+{
+  // Mix the address bits a little, allocations are aligned
+  const size_t v = reinterpret_cast<size_t>(ptr);
+  return int((v >> 4) ^ (v >> 10)) & (MEMLEAK_SHARDS-1);
+}
 
 void base_memleak_init()
 {
@@ -84,7 +198,8 @@ void base_memleak_init()
 
   assert(!memleak_status);
 
-  headslot = NULL;
+  for (int i=0; i<MEMLEAK_SHARDS; ++i)
+    headslot[i] = NULL;
 
   memleak_status = true;
 }
@@ -121,7 +236,8 @@ void base_memleak_exit()
 #endif
 
     // Memory leaks
-    for (it=headslot; it!=NULL; it=it->next) {
+    for (int shard=0; shard<MEMLEAK_SHARDS; ++shard)
+    for (it=headslot[shard]; it!=NULL; it=it->next) {
       fprintf(f, "\nLEAK address: %p, size: %lu\n", it->ptr, it->size);
 
       for (int c=0; c<BACKTRACE_LEVELS; ++c) {
@@ -180,9 +296,10 @@ static void addslot(void* ptr, size_t size)
   p->ptr = ptr;
   p->size = size;
 
-  const std::lock_guard lock(g_mutex);
-  p->next = headslot;
-  headslot = p;
+  const int shard = slot_shard(ptr);
+  const std::lock_guard lock(g_mutex[shard]);
+  p->next = headslot[shard];
+  headslot[shard] = p;
 }
 
 static void delslot(void* ptr)
@@ -194,14 +311,15 @@ static void delslot(void* ptr)
 
   assert(ptr);
 
-  const std::lock_guard lock(g_mutex);
+  const int shard = slot_shard(ptr);
+  const std::lock_guard lock(g_mutex[shard]);
 
-  for (it=headslot; it!=nullptr; prev=it, it=it->next) {
+  for (it=headslot[shard]; it!=nullptr; prev=it, it=it->next) {
     if (it->ptr == ptr) {
       if (prev)
         prev->next = it->next;
       else
-        headslot = it->next;
+        headslot[shard] = it->next;
 
       free(it);
       break;
@@ -213,6 +331,7 @@ void* base_malloc(size_t bytes)
 {
   void* mem = malloc(bytes);
   if (mem) {
+    track_alloc(mem);
     addslot(mem, bytes);
     return mem;
   }
@@ -224,6 +343,7 @@ void* base_malloc0(size_t bytes)
 {
   void* mem = calloc(1, bytes);
   if (mem) {
+    track_alloc(mem);
     addslot(mem, bytes);
     return mem;
   }
@@ -233,11 +353,15 @@ void* base_malloc0(size_t bytes)
 
 void* base_realloc(void* mem, size_t bytes)
 {
+  const size_t oldSize = (mem ? block_size(mem): 0);
   void* newmem = realloc(mem, bytes);
   if (newmem) {
-    if (mem)
+    if (mem) {
+      track_free_size(oldSize);
       delslot(mem);
+    }
 
+    track_alloc(newmem);
     addslot(newmem, bytes);
     return newmem;
   }
@@ -249,6 +373,7 @@ void base_free(void* mem)
 {
   assert(mem);
   if (mem) {
+    track_free(mem);
     delslot(mem);
     free(mem);
   }
@@ -259,8 +384,10 @@ char* base_strdup(const char* string)
   assert(string);
 
   char* mem = strdup(string);
-  if (mem)
+  if (mem) {
+    track_alloc(mem);
     addslot(mem, strlen(mem) + 1);
+  }
 
   return mem;
 }
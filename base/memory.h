@@ -33,6 +33,27 @@ void* base_realloc(void* mem, std::size_t bytes);
 void  base_free   (void* mem);
 char* base_strdup (const char* string);
 
+// Always-on allocation counters over base_malloc()/base_free(),
+// maintained with relaxed atomics so they are cheap enough for
+// production builds (unlike the LAF_MEMLEAK tracking list) and can be
+// sampled at runtime to watch the memory behavior of long sessions.
+struct base_alloc_stats {
+  // Power-of-two size classes: buckets[i] counts the live
+  // allocations of (2^(i-1), 2^i] bytes.
+  static constexpr int kBuckets = 32;
+
+  std::size_t inUse;           // Bytes currently allocated
+  std::size_t peak;            // Highest inUse seen since reset
+  std::size_t count;           // Allocations since reset (sample it
+                               // periodically to get the rate)
+  std::size_t buckets[kBuckets];
+};
+
+base_alloc_stats base_get_alloc_stats();
+
+// Resets peak (to the current inUse) and count.
+void base_reset_alloc_stats();
+
 #ifdef __cplusplus
   void* base_aligned_alloc(std::size_t bytes, std::size_t alignment = base_alignment);
 #else
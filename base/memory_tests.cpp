@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 
+#include "base/arena.h"
 #include "base/memory.h"
 
 TEST(Memory, AlignedAlloc)
@@ -27,6 +28,72 @@ TEST(Memory, AlignedAlloc)
   base_aligned_free(e);
 }
 
+TEST(Memory, ArenaBasic)
+{
+  base::arena arena(256);
+
+  void* a = arena.alloc(96);
+  void* b = arena.alloc(96);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(192, arena.used());
+
+  // Forces a second block
+  void* c = arena.alloc(1024);
+  EXPECT_NE(nullptr, c);
+  EXPECT_EQ(192+1024, arena.used());
+
+  arena.reset();
+  EXPECT_EQ(0, arena.used());
+
+  // Blocks are reused after reset
+  EXPECT_EQ(a, arena.alloc(96));
+}
+
+TEST(Memory, ArenaScope)
+{
+  base::arena arena(256);
+  arena.alloc(64);
+  {
+    base::arena::scope scope(arena);
+    arena.alloc(64);
+    arena.alloc(1024);
+    EXPECT_EQ(64+64+1024, arena.used());
+  }
+  EXPECT_EQ(64, arena.used());
+}
+
+TEST(Memory, ArenaMakeAndAlignment)
+{
+  base::arena& arena = base::thread_arena();
+  base::arena::scope scope(arena);
+
+  struct Point { int x, y; };
+  Point* pt = arena.make<Point>(Point{ 1, 2 });
+  EXPECT_EQ(1, pt->x);
+  EXPECT_EQ(2, pt->y);
+
+  arena.alloc(1);
+  void* aligned = arena.alloc(8, 32);
+  EXPECT_EQ(0, (size_t(aligned) % 32));
+}
+
+TEST(Memory, AllocStats)
+{
+  base_reset_alloc_stats();
+  const base_alloc_stats before = base_get_alloc_stats();
+
+  void* a = base_malloc(1000);
+  const base_alloc_stats during = base_get_alloc_stats();
+  EXPECT_GE(during.inUse, before.inUse + 1000);
+  EXPECT_GE(during.peak, during.inUse);
+  EXPECT_EQ(before.count + 1, during.count);
+
+  base_free(a);
+  const base_alloc_stats after = base_get_alloc_stats();
+  EXPECT_EQ(before.inUse, after.inUse);
+  EXPECT_GE(after.peak, during.inUse);  // Peak survives the free
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
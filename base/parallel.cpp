@@ -0,0 +1,27 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/parallel.h"
+
+namespace base {
+
+thread_pool& shared_thread_pool()
+{
+  using namespace std::chrono_literals;
+
+  // One worker per hardware thread, spawned on demand and parked
+  // when idle (the calling thread of parallel_for() also does work,
+  // so no work is ever stuck if workers are exiting/spawning).
+  static thread_pool pool(
+    std::max<size_t>(1, std::thread::hardware_concurrency()), 30s);
+  return pool;
+}
+
+} // namespace base
@@ -0,0 +1,167 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_PARALLEL_H_INCLUDED
+#define BASE_PARALLEL_H_INCLUDED
+#pragma once
+
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace base {
+
+  // Shared pool used by the parallel algorithms below (created
+  // lazily with one worker per hardware thread, workers are parked
+  // when they are idle).
+  thread_pool& shared_thread_pool();
+
+  namespace details {
+
+    // Calls fn(begin, end) for consecutive ranges of grain elements
+    // covering [0, n). The calling thread consumes ranges too (helper
+    // workers just accelerate it), so this can be called from a
+    // worker thread of the shared pool without deadlocking.
+    template<typename F>
+    void parallel_for_ranges(const size_t n, size_t grain, F&& fn) {
+      if (n == 0)
+        return;
+      if (grain < 1)
+        grain = 1;
+
+      const size_t chunks = (n + grain - 1) / grain;
+      if (chunks == 1) {
+        fn(size_t(0), n);
+        return;
+      }
+
+      // Shared state between the caller and the helper tasks. We
+      // wait until all chunks were *executed* (not until all helpers
+      // ran): a queued helper might never get a worker (e.g. if all
+      // workers are busy in a nested parallel_for), in that case it
+      // just finds no chunk to claim when it finally runs and the
+      // shared_ptr keeps this state alive for it.
+      struct state_t {
+        std::atomic<size_t> next = { 0 };
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t done = 0;        // Executed chunks (guarded by mutex)
+      };
+      auto st = std::make_shared<state_t>();
+
+      auto run_chunks = [st, &fn, n, grain, chunks]() -> size_t {
+        size_t executed = 0;
+        while (true) {
+          const size_t c = st->next++;
+          if (c >= chunks)
+            break;
+          fn(c*grain, std::min(n, (c+1)*grain));
+          ++executed;
+        }
+        return executed;
+      };
+
+      thread_pool& pool = shared_thread_pool();
+      const size_t helpers =
+        std::min<size_t>(chunks-1, std::thread::hardware_concurrency());
+
+      for (size_t h=0; h<helpers; ++h) {
+        pool.execute([st, run_chunks, chunks]{
+          const size_t executed = run_chunks();
+          if (executed > 0) {
+            bool all;
+            {
+              const std::unique_lock lock(st->mutex);
+              st->done += executed;
+              all = (st->done == chunks);
+            }
+            if (all)
+              st->cv.notify_all();
+          }
+        });
+      }
+
+      const size_t executed = run_chunks();
+
+      std::unique_lock<std::mutex> lock(st->mutex);
+      st->done += executed;
+      st->cv.wait(lock, [&st, chunks]() -> bool {
+                          return st->done == chunks;
+                        });
+    }
+
+    inline size_t default_grain(const size_t n) {
+      // About 4 chunks per hardware thread so faster workers can
+      // steal remaining ones without too much scheduling overhead.
+      const size_t chunks = 4*std::max<size_t>(1, std::thread::hardware_concurrency());
+      return std::max<size_t>(1, n / chunks);
+    }
+
+  } // namespace details
+
+  // Calls fn(i) for each i in [0, n) distributing chunks of grain
+  // elements between the calling thread and the shared pool workers.
+  // Blocks until all the elements were processed.
+  template<typename F>
+  void parallel_for(const size_t n, const size_t grain, F&& fn) {
+    details::parallel_for_ranges(
+      n, grain,
+      [&fn](const size_t begin, const size_t end){
+        for (size_t i=begin; i<end; ++i)
+          fn(i);
+      });
+  }
+
+  template<typename F>
+  void parallel_for(const size_t n, F&& fn) {
+    parallel_for(n, details::default_grain(n), std::forward<F>(fn));
+  }
+
+  // Parallel version of std::transform() for random access iterators
+  // (dstIt must point to a range with the same number of elements).
+  template<typename SrcIt, typename DstIt, typename F>
+  void parallel_transform(SrcIt srcIt, SrcIt srcEnd, DstIt dstIt, F&& fn) {
+    const size_t n = srcEnd - srcIt;
+    parallel_for(
+      n, details::default_grain(n),
+      [&srcIt, &dstIt, &fn](const size_t i){
+        dstIt[i] = fn(srcIt[i]);
+      });
+  }
+
+  // Reduces fn(0), fn(1), ..., fn(n-1) with the given (associative)
+  // reduce function, starting from the identity value.
+  template<typename T, typename F, typename R>
+  T parallel_reduce(const size_t n, const T& identity, F&& fn, R&& reduce) {
+    const size_t grain = details::default_grain(n);
+    if (grain < 1 || n == 0)
+      return identity;
+
+    const size_t chunks = (n + grain - 1) / grain;
+    std::vector<T> partial(chunks, identity);
+
+    details::parallel_for_ranges(
+      n, grain,
+      [&partial, &fn, &reduce, grain](const size_t begin, const size_t end){
+        T value = partial[begin/grain];
+        for (size_t i=begin; i<end; ++i)
+          value = reduce(value, fn(i));
+        partial[begin/grain] = value;
+      });
+
+    T result = identity;
+    for (const T& value : partial)
+      result = reduce(result, value);
+    return result;
+  }
+
+} // namespace base
+
+#endif
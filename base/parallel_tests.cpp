@@ -0,0 +1,69 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/parallel.h"
+
+#include <numeric>
+#include <vector>
+
+using namespace base;
+
+TEST(Parallel, ParallelFor)
+{
+  std::vector<int> v(100000, 0);
+  parallel_for(v.size(), [&v](size_t i){ v[i] = int(i); });
+  for (size_t i=0; i<v.size(); ++i)
+    ASSERT_EQ(int(i), v[i]);
+}
+
+TEST(Parallel, ParallelForExplicitGrain)
+{
+  std::vector<int> v(1000, 0);
+  parallel_for(v.size(), 64, [&v](size_t i){ v[i] = 2*int(i); });
+  for (size_t i=0; i<v.size(); ++i)
+    ASSERT_EQ(2*int(i), v[i]);
+}
+
+TEST(Parallel, ParallelTransform)
+{
+  std::vector<int> src(50000);
+  std::vector<int> dst(src.size(), 0);
+  std::iota(src.begin(), src.end(), 0);
+
+  parallel_transform(src.begin(), src.end(), dst.begin(),
+                     [](int v){ return v+1; });
+  for (size_t i=0; i<dst.size(); ++i)
+    ASSERT_EQ(int(i)+1, dst[i]);
+}
+
+TEST(Parallel, ParallelReduce)
+{
+  const size_t n = 100000;
+  const uint64_t sum =
+    parallel_reduce<uint64_t>(n, 0,
+                              [](size_t i){ return uint64_t(i); },
+                              [](uint64_t a, uint64_t b){ return a+b; });
+  EXPECT_EQ(uint64_t(n)*(n-1)/2, sum);
+}
+
+TEST(Parallel, NestedParallelFor)
+{
+  // parallel_for() can be called from tasks running in the shared
+  // pool without deadlocking (the caller consumes chunks too).
+  std::atomic<int> c(0);
+  parallel_for(8, 1, [&c](size_t){
+    parallel_for(1000, 10, [&c](size_t){ ++c; });
+  });
+  EXPECT_EQ(8000, c);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,10 +14,22 @@
   #include <windows.h>
 
   typedef LONG (WINAPI* RtlGetVersion_Func)(OSVERSIONINFOEX*);
+
+  #include <vector>
+#elif LAF_MACOS
+  #include <sys/sysctl.h>
 #elif LAF_LINUX  // Unix-like system
   #include <sys/utsname.h>
+
+  #include <cstdio>
+  #include <cstdlib>
+  #include <cstring>
+  #include <set>
 #endif
 
+#include <algorithm>
+#include <thread>
+
 namespace base {
 
 Platform get_platform()
@@ -126,4 +138,176 @@ Platform get_platform()
   return p;
 }
 
+#if LAF_LINUX
+
+// Reads one small sysfs file (e.g. a core id or a cache size),
+// returns an empty string if it doesn't exist.
+static std::string read_sysfs(const std::string& fn)
+{
+  FILE* f = std::fopen(fn.c_str(), "r");
+  if (!f)
+    return std::string();
+
+  char buf[64];
+  std::string value;
+  if (std::fgets(buf, sizeof(buf), f)) {
+    buf[std::strcspn(buf, "\r\n")] = 0;
+    value = buf;
+  }
+  std::fclose(f);
+  return value;
+}
+
+// Cache sizes in sysfs look like "512K" or "32M"
+static uint64_t parse_cache_size(const std::string& value)
+{
+  if (value.empty())
+    return 0;
+
+  uint64_t size = std::strtoull(value.c_str(), nullptr, 10);
+  switch (value[value.size()-1]) {
+    case 'K': size *= 1024; break;
+    case 'M': size *= 1024*1024; break;
+  }
+  return size;
+}
+
+#endif // LAF_LINUX
+
+static CpuTopology detect_cpu_topology()
+{
+  CpuTopology topo;
+  topo.logicalCores =
+    std::max<int>(1, std::thread::hardware_concurrency());
+
+#if LAF_WINDOWS
+
+  DWORD len = 0;
+  GetLogicalProcessorInformationEx(RelationAll, nullptr, &len);
+  std::vector<BYTE> buf(len);
+  auto* info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buf.data();
+  if (len > 0 && GetLogicalProcessorInformationEx(RelationAll, info, &len)) {
+    // Cores per efficiency class: on hybrid CPUs the highest class
+    // is the performance cluster, everything below is efficiency.
+    int coresPerClass[256] = { 0 };
+    int maxClass = 0;
+
+    for (BYTE* p=buf.data(); p<buf.data()+len; ) {
+      info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)p;
+      switch (info->Relationship) {
+        case RelationProcessorCore: {
+          ++topo.physicalCores;
+          const int cls = info->Processor.EfficiencyClass;
+          ++coresPerClass[cls];
+          maxClass = std::max(maxClass, cls);
+          break;
+        }
+        case RelationCache:
+          if (info->Cache.Level == 2)
+            topo.l2CacheSize = std::max<uint64_t>(topo.l2CacheSize,
+                                                  info->Cache.CacheSize);
+          else if (info->Cache.Level == 3)
+            topo.l3CacheSize = std::max<uint64_t>(topo.l3CacheSize,
+                                                  info->Cache.CacheSize);
+          break;
+      }
+      p += info->Size;
+    }
+
+    if (maxClass > 0) {
+      topo.performanceCores = coresPerClass[maxClass];
+      topo.efficiencyCores = topo.physicalCores - topo.performanceCores;
+    }
+  }
+
+#elif LAF_MACOS
+
+  auto sysctl_value = [](const char* name) -> uint64_t {
+    uint64_t value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname(name, &value, &size, nullptr, 0) != 0)
+      return 0;
+    return value;
+  };
+
+  if (const auto n = sysctl_value("hw.physicalcpu"))
+    topo.physicalCores = int(n);
+
+  // perflevel0/1 are the P/E clusters of Apple silicon (both absent
+  // on Intel Macs)
+  topo.performanceCores = int(sysctl_value("hw.perflevel0.physicalcpu"));
+  topo.efficiencyCores = int(sysctl_value("hw.perflevel1.physicalcpu"));
+  if (!topo.efficiencyCores)
+    topo.performanceCores = 0;  // Uniform CPU
+
+  topo.l2CacheSize = sysctl_value("hw.perflevel0.l2cachesize");
+  if (!topo.l2CacheSize)
+    topo.l2CacheSize = sysctl_value("hw.l2cachesize");
+  topo.l3CacheSize = sysctl_value("hw.l3cachesize");
+
+#elif LAF_LINUX
+
+  // Count unique (package, core) pairs to get physical cores
+  std::set<std::pair<int, int>> cores;
+  for (int i=0; i<topo.logicalCores; ++i) {
+    const std::string cpu =
+      "/sys/devices/system/cpu/cpu" + std::to_string(i);
+    const std::string pkg = read_sysfs(cpu + "/topology/physical_package_id");
+    const std::string core = read_sysfs(cpu + "/topology/core_id");
+    if (pkg.empty() || core.empty())
+      continue;
+    cores.insert(std::make_pair(std::atoi(pkg.c_str()),
+                                std::atoi(core.c_str())));
+  }
+  topo.physicalCores = int(cores.size());
+
+  // Cache levels of cpu0 (data/unified caches only)
+  for (int i=0; i<8; ++i) {
+    const std::string index =
+      "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i);
+    const std::string level = read_sysfs(index + "/level");
+    const std::string type = read_sysfs(index + "/type");
+    if (level.empty() || type == "Instruction")
+      continue;
+
+    const uint64_t size = parse_cache_size(read_sysfs(index + "/size"));
+    if (level == "2")
+      topo.l2CacheSize = size;
+    else if (level == "3")
+      topo.l3CacheSize = size;
+  }
+
+#endif
+
+  return topo;
+}
+
+int CpuTopology::defaultPoolSize() const
+{
+  return std::max(1, (physicalCores > 0 ? physicalCores:
+                                          logicalCores));
+}
+
+size_t CpuTopology::cacheAwareGrain(const size_t bytesPerItem,
+                                    const size_t n) const
+{
+  // Half the L2 so the chunk's data survives the working set of the
+  // processing loop itself (256 KB when the cache size is unknown).
+  const uint64_t target = (l2CacheSize ? l2CacheSize/2:
+                                         uint64_t(256*1024));
+  const size_t grain = size_t(target / std::max<size_t>(1, bytesPerItem));
+
+  // At least ~4 chunks per worker so faster cores can steal work
+  const size_t maxGrain =
+    std::max<size_t>(1, n / (4*size_t(defaultPoolSize())));
+
+  return std::max<size_t>(1, std::min(grain, maxGrain));
+}
+
+const CpuTopology& get_cpu_topology()
+{
+  static const CpuTopology topo = detect_cpu_topology();
+  return topo;
+}
+
 } // namespace base
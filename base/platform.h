@@ -77,6 +77,37 @@ struct Platform {
 
 Platform get_platform();
 
+// CPU topology for thread-pool sizing and cache-aware tiling.
+// Fields that the OS doesn't report are left in zero.
+struct CpuTopology {
+  int logicalCores = 1;         // Hardware threads
+  int physicalCores = 0;        // Cores (without SMT siblings)
+
+  // Hybrid CPUs only: physical cores of the performance and
+  // efficiency clusters (both zero on uniform CPUs or when the OS
+  // doesn't expose the core types).
+  int performanceCores = 0;
+  int efficiencyCores = 0;
+
+  uint64_t l2CacheSize = 0;     // Per core/cluster, in bytes
+  uint64_t l3CacheSize = 0;     // Shared, in bytes
+
+  // Default worker count for a general-purpose pool: the physical
+  // core count when known (SMT siblings rarely help the typical
+  // memory-bound pixel work), the logical one otherwise.
+  int defaultPoolSize() const;
+
+  // Number of items (of bytesPerItem bytes each) that one
+  // parallel_for() chunk should take so the chunk's data stays
+  // resident in the per-core L2 cache, keeping at least a few chunks
+  // per worker for load balancing when n items are processed.
+  size_t cacheAwareGrain(size_t bytesPerItem, size_t n) const;
+};
+
+// Returns the topology of the CPU we are running on (detected once
+// and cached).
+const CpuTopology& get_cpu_topology();
+
 #if LAF_WINDOWS
 
   bool is_wow64();
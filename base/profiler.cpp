@@ -0,0 +1,162 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace base {
+namespace profiler {
+
+// Zones kept per thread. With 64K entries the ring covers several
+// seconds of a busy frame loop before wrapping.
+static const size_t kZonesPerThread = 65536;
+
+namespace {
+
+struct Zone {
+  const char* name;
+  uint64_t start, end;
+  int depth;
+};
+
+// Ring buffer of the zones captured by one thread. The registry
+// keeps it alive (shared_ptr) after the thread exits so the capture
+// can still be exported.
+struct ThreadBuffer {
+  int tid;
+  std::vector<Zone> zones;
+  size_t next = 0;              // Next slot to write
+  size_t count = 0;             // Written zones (saturates at size)
+  int depth = 0;                // Current nesting inside this thread
+
+  void add(const char* name, const uint64_t start, const uint64_t end) {
+    if (zones.empty())
+      zones.resize(kZonesPerThread);
+    Zone& zone = zones[next];
+    zone.name = name;
+    zone.start = start;
+    zone.end = end;
+    zone.depth = depth;
+    next = (next+1) % zones.size();
+    count = std::min(count+1, zones.size());
+  }
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  int nextTid = 1;
+};
+
+Registry& registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+std::atomic<bool> g_enabled(false);
+
+ThreadBuffer& thread_buffer()
+{
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto b = std::make_shared<ThreadBuffer>();
+    Registry& reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    b->tid = reg.nextTid++;
+    reg.buffers.push_back(b);
+    return b;
+  }();
+  return *buffer;
+}
+
+} // anonymous namespace
+
+void set_enabled(const bool enabled)
+{
+  g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool is_enabled()
+{
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+void clear()
+{
+  Registry& reg = registry();
+  const std::lock_guard<std::mutex> lock(reg.mutex);
+  for (auto& buffer : reg.buffers) {
+    buffer->next = buffer->count = 0;
+    buffer->depth = 0;
+  }
+}
+
+uint64_t enter_zone()
+{
+  ++thread_buffer().depth;
+  return now_ns();
+}
+
+void leave_zone(const char* name, const uint64_t start)
+{
+  const uint64_t end = now_ns();
+  ThreadBuffer& buffer = thread_buffer();
+  // Entries are recorded at zone exit with the depth they ran at
+  // (children before their parent; the "X" complete events of
+  // chrome://tracing accept any order and re-derive the nesting from
+  // the timestamps anyway).
+  buffer.add(name, start, end);
+  --buffer.depth;
+}
+
+void write_trace(std::ostream& os)
+{
+  Registry& reg = registry();
+  const std::lock_guard<std::mutex> lock(reg.mutex);
+
+  os << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& buffer : reg.buffers) {
+    for (size_t i=0; i<buffer->count; ++i) {
+      const Zone& zone = buffer->zones[i];
+      if (!first)
+        os << ",";
+      first = false;
+      // chrome://tracing timestamps/durations are in microseconds
+      os << "{\"name\":\"" << zone.name << "\""
+         << ",\"ph\":\"X\""
+         << ",\"ts\":" << zone.start / 1000
+         << ",\"dur\":" << (zone.end - zone.start) / 1000
+         << ",\"pid\":1"
+         << ",\"tid\":" << buffer->tid
+         << "}";
+    }
+  }
+  os << "]}";
+}
+
+bool save_trace(const std::string& filename)
+{
+  std::ofstream os(filename);
+  if (!os)
+    return false;
+  write_trace(os);
+  return os.good();
+}
+
+} // namespace profiler
+} // namespace base
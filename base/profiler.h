@@ -0,0 +1,77 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_PROFILER_H_INCLUDED
+#define BASE_PROFILER_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "base/time.h"
+
+#include <iosfwd>
+#include <string>
+
+namespace base {
+namespace profiler {
+
+  // Hierarchical profiling zones: wrap a scope with LAF_ZONE("name")
+  // and every execution records a (start, end, nesting depth) entry
+  // into a per-thread ring buffer. Capturing is off by default and a
+  // disabled zone costs a single relaxed atomic load, so the macros
+  // can stay in production code. The captured timeline can be saved
+  // with save_trace() in the chrome://tracing JSON format (also
+  // readable by Perfetto).
+  //
+  //   base::profiler::set_enabled(true);
+  //   ... run the frames to capture ...
+  //   base::profiler::save_trace("frame.json");
+
+  // Starts/stops capturing zones (zones already captured are kept).
+  void set_enabled(bool enabled);
+  bool is_enabled();
+
+  // Discards everything captured so far (call it with capturing
+  // disabled).
+  void clear();
+
+  // Writes the captured zones of all threads as chrome://tracing
+  // "traceEvents" JSON. save_trace() returns false if the file
+  // cannot be created.
+  void write_trace(std::ostream& os);
+  bool save_trace(const std::string& filename);
+
+  // Internals used by LAF_ZONE(): enter_zone() bumps the nesting
+  // depth of the calling thread and returns the start timestamp,
+  // leave_zone() records the entry. The name must be a string
+  // literal (only the pointer is stored).
+  uint64_t enter_zone();
+  void leave_zone(const char* name, uint64_t start);
+
+  class ScopedZone {
+  public:
+    ScopedZone(const char* name)
+      : m_name(is_enabled() ? name: nullptr) {
+      if (m_name)
+        m_start = enter_zone();
+    }
+    ~ScopedZone() {
+      if (m_name)
+        leave_zone(m_name, m_start);
+    }
+  private:
+    const char* m_name;
+    uint64_t m_start;
+  };
+
+} // namespace profiler
+} // namespace base
+
+#define LAF_ZONE_CONCAT2(a, b) a##b
+#define LAF_ZONE_CONCAT(a, b) LAF_ZONE_CONCAT2(a, b)
+#define LAF_ZONE(name) \
+  base::profiler::ScopedZone LAF_ZONE_CONCAT(laf_zone_, __LINE__)(name)
+
+#endif
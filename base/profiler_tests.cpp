@@ -0,0 +1,57 @@
+// LAF Base Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/profiler.h"
+
+#include <sstream>
+
+using namespace base;
+
+static std::string trace()
+{
+  std::stringstream os;
+  profiler::write_trace(os);
+  return os.str();
+}
+
+TEST(Profiler, DisabledZonesRecordNothing)
+{
+  profiler::clear();
+  ASSERT_FALSE(profiler::is_enabled());
+  {
+    LAF_ZONE("ignored");
+  }
+  EXPECT_EQ(std::string::npos, trace().find("ignored"));
+}
+
+TEST(Profiler, NestedZones)
+{
+  profiler::clear();
+  profiler::set_enabled(true);
+  {
+    LAF_ZONE("parent");
+    {
+      LAF_ZONE("child");
+    }
+  }
+  profiler::set_enabled(false);
+
+  const std::string json = trace();
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"parent\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"child\""));
+  EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+
+  profiler::clear();
+  EXPECT_EQ("{\"traceEvents\":[]}", trace());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
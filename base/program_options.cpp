@@ -17,24 +17,6 @@
 
 namespace base {
 
-
-struct same_name {
-  const std::string& name;
-  same_name(const std::string& name) : name(name) { }
-  bool operator()(const ProgramOptions::Option* a) {
-    return (a->name() == name ||
-            a->alias() == name);
-  }
-};
-
-struct same_mnemonic {
-  char mnemonic;
-  same_mnemonic(char mnemonic) : mnemonic(mnemonic) { }
-  bool operator()(const ProgramOptions::Option* a) const {
-    return a->mnemonic() == mnemonic;
-  }
-};
-
 ProgramOptions::ProgramOptions()
 {
 }
@@ -55,12 +37,26 @@ ProgramOptions::Option& ProgramOptions::add(const std::string& name)
 
 void ProgramOptions::parse(int argc, const char* argv[])
 {
+  // (Re)build the hashed lookup tables, so each argv token costs one
+  // hash lookup instead of a linear search through the option list.
+  m_byName.clear();
+  m_byMnemonic.clear();
+  for (Option* option : m_options) {
+    m_byName[option->name()] = option;
+    if (!option->alias().empty())
+      m_byName[option->alias()] = option;
+    if (option->mnemonic() != 0)
+      m_byMnemonic[option->mnemonic()] = option;
+  }
+
   for (int i=1; i<argc; ++i) {
-    std::string arg(argv[i]);
+    // A view over the argv token, values are stored as sub-views of
+    // it without copying.
+    const std::string_view arg(argv[i]);
 
     // n = number of dashes ('-') at the beginning of the argument.
     size_t n = 0;
-    for (; arg[n] == '-'; ++n)
+    for (; n < arg.size() && arg[n] == '-'; ++n)
       ;
     const size_t len = arg.size()-n;
 
@@ -72,11 +68,11 @@ void ProgramOptions::parse(int argc, const char* argv[])
 
     if ((n > 0) && (len > 0)) {
       // First we try to find the -optionName=optionValue pair
-      std::string optionName;
-      std::string optionValue;
+      std::string_view optionName;
+      std::string_view optionValue;
       const size_t equalSignPos = arg.find('=', n);
 
-      if (equalSignPos != std::string::npos) {
+      if (equalSignPos != std::string_view::npos) {
         optionName = arg.substr(n, equalSignPos-n);
         optionValue = arg.substr(equalSignPos+1);
       }
@@ -84,17 +80,16 @@ void ProgramOptions::parse(int argc, const char* argv[])
         optionName = arg.substr(n);
       }
 
-      const OptionList::iterator it =
-        find_if(m_options.begin(), m_options.end(), same_name(optionName));
+      const auto it = m_byName.find(optionName);
 
       // If we've found the -optionName or --optionName, we use it
-      if (it != m_options.end()) {
-        Option* option = *it;
+      if (it != m_byName.end()) {
+        Option* option = it->second;
 
         if (option->doesRequireValue()) {
           // If the option was specified without '=', we can get the
           // value from the next argument.
-          if (equalSignPos == std::string::npos) {
+          if (equalSignPos == std::string_view::npos) {
             if (i+1 >= argc) {
               std::stringstream msg;
               msg << "Missing value in '--" << optionName
@@ -113,10 +108,9 @@ void ProgramOptions::parse(int argc, const char* argv[])
         char usedBy = 0;
 
         for (size_t j=1; j<arg.size(); ++j) {
-          const OptionList::iterator it =
-            find_if(m_options.begin(), m_options.end(), same_mnemonic(arg[j]));
+          const auto it = m_byMnemonic.find(arg[j]);
 
-          if (it == m_options.end()) {
+          if (it == m_byMnemonic.end()) {
             std::stringstream msg;
             // Show the whole option (arg) as invalid just in case the
             // user specified a "-long-option" with one "-" (instead
@@ -125,8 +119,8 @@ void ProgramOptions::parse(int argc, const char* argv[])
             throw InvalidProgramOption(msg.str());
           }
 
-          Option* option = *it;
-          std::string optionValue;
+          Option* option = it->second;
+          std::string_view optionValue;
 
           if (option->doesRequireValue()) {
             if (usedBy != 0) {
@@ -183,7 +177,7 @@ std::string ProgramOptions::value_of(const Option& option) const
 {
   for (const auto& value : m_values) {
     if (value.option() == &option)
-      return value.value();
+      return std::string(value.value());
   }
   return "";
 }
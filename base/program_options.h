@@ -9,6 +9,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <iosfwd>
 #include <stdexcept>
@@ -68,15 +70,15 @@ namespace base {
 
     class Value {
     public:
-      Value(Option* option, const std::string& value)
+      Value(Option* option, const std::string_view& value)
         : m_option(option)
         , m_value(value) {
       }
       const Option* option() const { return m_option; }
-      const std::string& value() const { return m_value; }
+      const std::string_view& value() const { return m_value; }
     private:
       Option* m_option;
-      std::string m_value;
+      std::string_view m_value; // View into the parsed argv (zero-copy)
     };
 
     typedef std::vector<Option*> OptionList;
@@ -94,6 +96,8 @@ namespace base {
     Option& add(const std::string& name);
 
     // Detects which options where specified in the command line.
+    // Values are stored as views into the given argv, so it must
+    // outlive the parsed values() (true for the main() arguments).
     void parse(int argc, const char* argv[]);
 
     // Reset all option values/flags.
@@ -109,6 +113,13 @@ namespace base {
     std::string value_of(const Option& option) const;
 
   private:
+    // Hashed lookup tables rebuilt at the beginning of parse() (the
+    // buckets are reused between parses). Keys are views into the
+    // Option strings, which are stable because the Options are
+    // heap-allocated and configured before parsing.
+    std::unordered_map<std::string_view, Option*> m_byName;
+    std::unordered_map<char, Option*> m_byMnemonic;
+
     OptionList m_options;
     ValueList m_values;
   };
@@ -15,7 +15,33 @@
 
 namespace base {
 
-  template<typename T>
+  // Counter policies for RefCountT. The default atomic one makes
+  // ref()/unref() safe to call from any thread.
+  struct AtomicRefCounter {
+    AtomicRefCounter(const uint32_t value) : m_value(value) { }
+    void increment() { m_value.fetch_add(1, std::memory_order_relaxed); }
+    // Returns true when the last reference was released.
+    bool decrement() { return m_value.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+    uint32_t count() const { return m_value; }
+  private:
+    std::atomic<uint32_t> m_value;
+  };
+
+  // Unsynchronized policy for objects whose whole lifetime stays in
+  // one thread (e.g. per-frame object graphs churning refs in tight
+  // loops), removing the interlocked operation from every
+  // ref()/unref() pair.
+  struct LocalRefCounter {
+    LocalRefCounter(const uint32_t value) : m_value(value) { }
+    void increment() { ++m_value; }
+    bool decrement() { return --m_value == 0; }
+    uint32_t count() const { return m_value; }
+  private:
+    uint32_t m_value;
+  };
+
+  template<typename T,
+           typename Counter = AtomicRefCounter>
   class RefCountT {
   public:
     RefCountT() : m_ref(1) { }
@@ -23,29 +49,31 @@ namespace base {
     ~RefCountT() {
       // m_ref can be 1 in case that RefCountT() was created in the
       // stack, and 0 when it's deleted from unref().
-      ASSERT(m_ref == 0 || m_ref == 1);
+      ASSERT(m_ref.count() == 0 || m_ref.count() == 1);
     }
 
     RefCountT(const RefCountT&) : m_ref(1) { }
     RefCountT& operator=(const RefCountT&) { return *this; }
 
     void ref() {
-      ASSERT(m_ref > 0);
-      m_ref.fetch_add(1, std::memory_order_relaxed);
+      ASSERT(m_ref.count() > 0);
+      m_ref.increment();
     }
 
     void unref() {
-      ASSERT(m_ref > 0);
-      if (m_ref.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      ASSERT(m_ref.count() > 0);
+      if (m_ref.decrement())
         delete (T*)this;
     }
 
-#ifdef _DEBUG   // For debugging purposes only (TRACE, TRACEARGS, etc.)
-    uint32_t ref_count() const { return m_ref; }
-#endif
+    // Number of active references. Useful for debugging (TRACE,
+    // TRACEARGS, etc.) and to detect unshared objects (count == 1
+    // means the caller holds the only reference, e.g. a free entry
+    // in a pool of reusable objects).
+    uint32_t ref_count() const { return m_ref.count(); }
 
   private:
-    std::atomic<uint32_t> m_ref;
+    Counter m_ref;
   };
 
   class RefCount : public RefCountT<RefCount> {
@@ -60,6 +88,20 @@ namespace base {
     RefCount& operator=(RefCount&&) = delete;
   };
 
+  // Like RefCount but with the unsynchronized counter: use it as
+  // base class for objects that are created, shared, and destroyed
+  // in a single thread.
+  class RefCountLocal : public RefCountT<RefCountLocal, LocalRefCounter> {
+  public:
+    RefCountLocal() { }
+    virtual ~RefCountLocal() { }
+
+    RefCountLocal(const RefCountLocal&) = delete;
+    RefCountLocal(RefCountLocal&&) = delete;
+    RefCountLocal& operator=(const RefCountLocal&) = delete;
+    RefCountLocal& operator=(RefCountLocal&&) = delete;
+  };
+
   // Smart pointer for RefCountT objects
   template<typename T>
   class Ref {
@@ -103,6 +103,28 @@ TEST(RefCount, Virtual)
   EXPECT_EQ(1, b_dtors);
 }
 
+class ALocal : public RefCountT<ALocal, LocalRefCounter> {
+public:
+  ALocal(int v) : v(v) { ++ctors; }
+  ~ALocal() { ++dtors; }
+  int v = 0;
+};
+
+TEST(RefCountLocal, UnsynchronizedCounter)
+{
+  ctors = dtors = 0;
+  {
+    auto a = make_ref<ALocal>(1);
+    EXPECT_EQ(1, a->ref_count());
+    auto b = a;
+    EXPECT_EQ(2, a->ref_count());
+    b.reset();
+    EXPECT_EQ(1, a->ref_count());
+  }
+  EXPECT_EQ(1, ctors);
+  EXPECT_EQ(1, dtors);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -30,6 +30,7 @@ RWLock::~RWLock()
 {
   ASSERT(!m_write_lock);
   ASSERT(m_write_thread == std::thread::id());
+  ASSERT(m_upgrading_thread == std::thread::id());
   ASSERT(m_read_locks == 0);
   ASSERT(m_weak_lock == nullptr);
 }
@@ -51,6 +52,18 @@ bool RWLock::canWriteLockFromRead() const
 
 RWLock::LockResult RWLock::lock(LockType lockType, int timeout)
 {
+  // Contention-free fast path for readers: we announce the reader
+  // optimistically with one atomic increment, and confirm that there
+  // is no writer. If a writer announced itself in-between we back
+  // out and fall to the slow path (both operations are seq_cst so
+  // either we see the writer flag or the writer sees our increment).
+  if (lockType == ReadLock) {
+    ++m_read_locks;
+    if (!m_write_lock)
+      return LockResult::OK;
+    --m_read_locks;
+  }
+
   // Check for re-entrant write locks (multiple write-lock in the same
   // thread are allowed).
   // if (lockType == WriteLock) {
@@ -89,16 +102,23 @@ RWLock::LockResult RWLock::lock(LockType lockType, int timeout)
             ASSERT(*m_weak_lock == WeakUnlocked);
           }
 
-          // If no body is reading and writing...
-          if (m_read_locks == 0 && !m_write_lock) {
-            // We can start writing the object...
+          // If no body is writing, announce our write intention
+          // first (so optimistic readers back out) and then check
+          // that there are no readers...
+          if (!m_write_lock) {
             m_write_lock = true;
-            m_write_thread = std::this_thread::get_id();
+            if (m_read_locks == 0) {
+              // We can start writing the object...
+              m_write_thread = std::this_thread::get_id();
 
 #ifdef DEBUG_OBJECT_LOCKS
-            TRACE("LCK: lock: Locked <%p> to write\n", this);
+              TRACE("LCK: lock: Locked <%p> to write\n", this);
 #endif
-            return LockResult::OK;
+              return LockResult::OK;
+            }
+            // Readers are still present (or backing out), retract
+            // the announcement and retry/fail.
+            m_write_lock = false;
           }
           break;
 
@@ -136,12 +156,14 @@ void RWLock::downgradeToRead(LockResult lockResult)
 
   const std::lock_guard lock(m_mutex);
 
-  ASSERT(m_read_locks == 0);
+  // Note: m_read_locks can be != 0 here, optimistic readers can
+  // transiently increment it (and back out) while we hold the write
+  // lock.
   ASSERT(m_write_lock);
 
-  m_write_lock = false;
   m_write_thread = std::thread::id();
-  m_read_locks = 1;
+  ++m_read_locks;
+  m_write_lock = false;
 }
 
 void RWLock::unlock(LockResult lockResult)
@@ -149,18 +171,29 @@ void RWLock::unlock(LockResult lockResult)
   if (lockResult != LockResult::OK)
     return; // Do nothing for failed or reentrant locks
 
-  const std::lock_guard lock(m_mutex);
-
-  if (m_write_lock) {
-    m_write_lock = false;
-    m_write_thread = std::thread::id();
-  }
-  else if (m_read_locks > 0) {
+  // Fast path for readers: if there is no writer this can only be a
+  // read unlock (a writer only acquires the lock when there are no
+  // readers left).
+  if (!m_write_lock) {
+    ASSERT(m_read_locks > 0);
     --m_read_locks;
+    return;
   }
-  else {
-    ASSERT(false);
+
+  {
+    const std::lock_guard lock(m_mutex);
+    if (m_write_lock &&
+        m_write_thread == std::this_thread::get_id()) {
+      m_write_thread = std::thread::id();
+      m_write_lock = false;
+      return;
+    }
   }
+
+  // m_write_lock was just a transient write announcement of other
+  // thread, we are a reader anyway.
+  ASSERT(m_read_locks > 0);
+  --m_read_locks;
 }
 
 bool RWLock::weakLock(std::atomic<WeakLock>* weak_lock_flag)
@@ -218,12 +251,33 @@ RWLock::LockResult RWLock::upgradeToWrite(int timeout)
         ASSERT(*m_weak_lock == WeakUnlocked);
       }
 
-      // this only is possible if there are just one reader
-      if (m_read_locks == 1) {
-        ASSERT(!m_write_lock);
-        m_read_locks = 0;
-        m_write_lock = true;
+      // Announce the upgrade intention (and keep it announced while
+      // waiting): new readers and writers back out, so the upgrade
+      // completes as soon as the current readers unwind and cannot be
+      // starved by incoming locks.
+      if (m_upgrading_thread == std::thread::id()) {
+        if (!m_write_lock) {
+          m_write_lock = true;
+          m_upgrading_thread = std::this_thread::get_id();
+        }
+      }
+      else if (m_upgrading_thread != std::this_thread::get_id()) {
+        // Another reader is already upgrading. Waiting for it would
+        // deadlock (it waits for our read lock while we'd wait for
+        // its write lock), so fail immediately: the caller should
+        // unlock its read lock and retry as a plain writer.
+#ifdef DEBUG_OBJECT_LOCKS
+        TRACE("LCK: upgradeToWrite: Upgrade of <%p> already in progress\n", this);
+#endif
+        return LockResult::Fail;
+      }
+
+      if (m_upgrading_thread == std::this_thread::get_id() &&
+          m_read_locks == 1) {
+        // Only our own read lock is left, complete the upgrade
+        --m_read_locks;
         m_write_thread = std::this_thread::get_id();
+        m_upgrading_thread = std::thread::id();
 
 #ifdef DEBUG_OBJECT_LOCKS
         TRACE("LCK: upgradeToWrite: Locked <%p> to write\n", this);
@@ -249,6 +303,15 @@ RWLock::LockResult RWLock::upgradeToWrite(int timeout)
       break;
   }
 
+  // Timeout: retract the announcement so readers/writers can continue
+  {
+    const std::lock_guard lock(m_mutex);
+    if (m_upgrading_thread == std::this_thread::get_id()) {
+      m_upgrading_thread = std::thread::id();
+      m_write_lock = false;
+    }
+  }
+
 #ifdef DEBUG_OBJECT_LOCKS
   TRACE("LCK: upgradeToWrite: Cannot lock <%p> to write (has %d read locks and %d write locks)\n",
     this, m_read_locks, m_write_lock);
@@ -257,4 +320,32 @@ RWLock::LockResult RWLock::upgradeToWrite(int timeout)
   return LockResult::Fail;
 }
 
+RWLock::LockResult RWLock::tryUpgradeToWrite()
+{
+  const std::lock_guard lock(m_mutex);
+
+  if (m_write_lock) {
+    if (m_write_thread == std::this_thread::get_id())
+      return LockResult::Reentrant;
+    return LockResult::Fail;    // Other writer or upgrade in progress
+  }
+
+  // Don't kick the weak lock out for a non-blocking attempt
+  if (m_weak_lock && *m_weak_lock != WeakUnlocked)
+    return LockResult::Fail;
+
+  if (m_read_locks != 1)        // Other readers present
+    return LockResult::Fail;
+
+  --m_read_locks;
+  m_write_lock = true;
+  m_write_thread = std::this_thread::get_id();
+
+#ifdef DEBUG_OBJECT_LOCKS
+  TRACE("LCK: tryUpgradeToWrite: Locked <%p> to write\n", this);
+#endif
+
+  return LockResult::OK;
+}
+
 } // namespace base
@@ -55,9 +55,20 @@ namespace base {
     LockResult lock(LockType lockType, int timeout);
 
     // If you've locked the object to read, using this method you can
-    // raise your access level to write it.
+    // raise your access level to write it. The upgrade intention is
+    // announced while we wait for the other readers to unwind, so it
+    // cannot be starved by incoming read/write locks. If another
+    // thread is already upgrading, this fails immediately (waiting
+    // would deadlock: each upgrader would wait for the other's read
+    // lock), and the caller should unlock its read lock and retry as
+    // a plain writer.
     LockResult upgradeToWrite(int timeout);
 
+    // Non-blocking upgradeToWrite(): succeeds only if we are the only
+    // reader and nobody is writing or weakly locking the object (the
+    // weak lock is not kicked out, unlike upgradeToWrite()).
+    LockResult tryUpgradeToWrite();
+
     // If we've locked the object to write, using this method we can
     // lower our access to read-only.
     void downgradeToRead(LockResult lockResult);
@@ -75,15 +86,24 @@ namespace base {
     void weakUnlock();
 
   private:
-    // Mutex to modify the 'locked' flag.
+    // Mutex used in the slow path (writers, upgrades, weak locks).
     mutable std::mutex m_mutex;
 
-    // True if some thread is writing the object.
-    bool m_write_lock = false;
+    // True if some thread is writing the object (or is announcing
+    // its intention to write it, so optimistic readers back out).
+    std::atomic<bool> m_write_lock = { false };
     std::thread::id m_write_thread = {};
 
-    // Greater than zero when one or more threads are reading the object.
-    int m_read_locks = 0;
+    // Thread that announced a read->write upgrade and is waiting for
+    // the other readers to unwind (it keeps m_write_lock set in the
+    // meantime so no new locks sneak in).
+    std::thread::id m_upgrading_thread = {};
+
+    // Greater than zero when one or more threads are reading the
+    // object. Readers increment this counter optimistically without
+    // taking m_mutex (and decrement it again if a writer announced
+    // itself), so uncontended read locks are just two atomic ops.
+    std::atomic<int> m_read_locks = { 0 };
 
     // If this isn' nullptr, it means that it points to an unique
     // "weak" lock that can be unlocked from other thread. E.g. the
@@ -78,6 +78,53 @@ TEST(RWLock, UpgradeToWrite)
   a.unlock(res[0]);
 }
 
+TEST(RWLock, TryUpgradeToWrite)
+{
+  RWLock a;
+  LockResult res[3];
+
+  // With other readers present the try-upgrade fails without blocking
+  EXPECT_OK(res[0] = a.lock(RWLock::ReadLock, 0));
+  EXPECT_OK(res[1] = a.lock(RWLock::ReadLock, 0));
+  EXPECT_FAIL(a.tryUpgradeToWrite());
+  a.unlock(res[1]);
+
+  // As the only reader we get the write lock
+  EXPECT_OK(res[1] = a.tryUpgradeToWrite());
+  BGTHREAD(EXPECT_FAIL(a.lock(RWLock::ReadLock, 0)));
+  EXPECT_REENTRANT(res[2] = a.tryUpgradeToWrite());
+  a.unlock(res[2]);
+  a.downgradeToRead(res[1]);
+  a.unlock(res[0]);
+}
+
+TEST(RWLock, ConcurrentUpgradesFailFast)
+{
+  RWLock a;
+  LockResult res[2];
+
+  EXPECT_OK(res[0] = a.lock(RWLock::ReadLock, 0));
+  EXPECT_OK(res[1] = a.lock(RWLock::ReadLock, 0));
+
+  // Two readers upgrading at the same time would deadlock waiting for
+  // each other, so while our upgrade waits for the second reader, an
+  // upgrade from another thread must fail immediately.
+  // This upgrade consumes the res[0] read lock when it completes
+  std::thread upgrader([&a]{
+    EXPECT_OK(a.upgradeToWrite(1000));
+    a.downgradeToRead(LockResult::OK);
+    a.unlock(LockResult::OK);
+  });
+  while (a.lock(RWLock::ReadLock, 0) == LockResult::OK) {
+    // Transient window until the upgrader announces itself: retry
+    a.unlock(LockResult::OK);
+    std::this_thread::yield();
+  }
+  BGTHREAD(EXPECT_FAIL(a.upgradeToWrite(0)));
+  a.unlock(res[1]);             // Let the upgrader finish
+  upgrader.join();
+}
+
 TEST(RWLock, WeakLock)
 {
   RWLock a;
@@ -26,6 +26,44 @@ uint8_t read8(std::istream& is)
   return (uint8_t)is.get();
 }
 
+std::ostream& write_varuint(std::ostream& os, uint64_t value)
+{
+  while (value >= 0x80) {
+    os.put(char(0x80 | (value & 0x7f)));
+    value >>= 7;
+  }
+  os.put(char(value));
+  return os;
+}
+
+uint64_t read_varuint(std::istream& is)
+{
+  uint64_t value = 0;
+  int shift = 0;
+  while (shift < 64) {
+    const int byte = is.get();
+    if (byte == EOF)
+      break;
+    value |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      break;
+    shift += 7;
+  }
+  return value;
+}
+
+std::ostream& write_varint(std::ostream& os, const int64_t value)
+{
+  // Zig-zag: -1 -> 1, 1 -> 2, -2 -> 3, ...
+  return write_varuint(os, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+int64_t read_varint(std::istream& is)
+{
+  const uint64_t zz = read_varuint(is);
+  return int64_t(zz >> 1) ^ -int64_t(zz & 1);
+}
+
 std::ostream& little_endian::write16(std::ostream& os, uint16_t word)
 {
   os.put((int)((word & 0x00ff)));
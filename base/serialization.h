@@ -8,8 +8,13 @@
 #define BASE_SERIALIZATION_H_INCLUDED
 #pragma once
 
+#include "base/buffer.h"
+#include "base/config.h"
 #include "base/ints.h"
+
+#include <cstring>
 #include <iosfwd>
+#include <iterator>
 
 namespace base {
 namespace serialization {
@@ -17,6 +22,45 @@ namespace serialization {
   std::ostream& write8(std::ostream& os, uint8_t byte);
   uint8_t read8(std::istream& is);
 
+  // LEB128 variable-length integers (7 bits per byte, small values
+  // take one byte) and the zig-zag signed variant (so small negative
+  // values stay small). Used by compact formats like the region
+  // encoding in gfx/region_io.h.
+  std::ostream& write_varuint(std::ostream& os, uint64_t value);
+  uint64_t read_varuint(std::istream& is);
+  std::ostream& write_varint(std::ostream& os, int64_t value);
+  int64_t read_varint(std::istream& is);
+
+  // Delta-encoded integer spans: the element count as a varuint and
+  // then each element as the zig-zag varint difference with the
+  // previous one (the first one with zero). Monotonic or
+  // slowly-varying sequences (sorted offsets, polyline coordinates)
+  // shrink to about one byte per element.
+  template<typename Iterator>
+  std::ostream& write_delta_span(std::ostream& os, Iterator begin, Iterator end) {
+    write_varuint(os, uint64_t(std::distance(begin, end)));
+    int64_t prev = 0;
+    for (; begin != end; ++begin) {
+      const int64_t value = int64_t(*begin);
+      write_varint(os, value - prev);
+      prev = value;
+    }
+    return os;
+  }
+
+  // Reads a write_delta_span() span into the given output iterator
+  // (e.g. a std::back_inserter), returning the element count.
+  template<typename OutputIterator>
+  size_t read_delta_span(std::istream& is, OutputIterator out) {
+    const size_t n = size_t(read_varuint(is));
+    int64_t prev = 0;
+    for (size_t i=0; i<n; ++i) {
+      prev += read_varint(is);
+      *out++ = prev;
+    }
+    return n;
+  }
+
   namespace little_endian {
 
     std::ostream& write16(std::ostream& os, uint16_t word);
@@ -47,6 +91,153 @@ namespace serialization {
 
   } // big_endian namespace
 
+  // Serializer writing primitives directly into a base::buffer
+  // (little-endian, like the session file formats), bypassing the
+  // per-byte virtual dispatch of std::ostream::put(). On
+  // little-endian hosts every write is a plain memcpy append.
+  class serializer {
+  public:
+    explicit serializer(buffer& buf) : m_buf(buf) { }
+
+    // Pre-grows the internal buffer for the next "bytes" bytes.
+    void reserve_ahead(const size_t bytes) {
+      m_buf.reserve(m_buf.size() + bytes);
+    }
+
+    void write8(const uint8_t value) { m_buf.push_back(value); }
+    void write16(const uint16_t value) { write_value(value); }
+    void write32(const uint32_t value) { write_value(value); }
+    void write64(const uint64_t value) { write_value(value); }
+    void write_float(const float value) {
+      uint32_t b;
+      std::memcpy(&b, &value, 4);
+      write_value(b);
+    }
+    void write_double(const double value) {
+      uint64_t b;
+      std::memcpy(&b, &value, 8);
+      write_value(b);
+    }
+    // Same LEB128/zig-zag encoding as the stream-based
+    // write_varuint()/write_varint()
+    void write_varuint(uint64_t value) {
+      while (value >= 0x80) {
+        m_buf.push_back(uint8_t(0x80 | (value & 0x7f)));
+        value >>= 7;
+      }
+      m_buf.push_back(uint8_t(value));
+    }
+    void write_varint(const int64_t value) {
+      write_varuint((uint64_t(value) << 1) ^ uint64_t(value >> 63));
+    }
+
+    void write_bytes(const uint8_t* data, const size_t size) {
+      const size_t n = m_buf.size();
+      m_buf.resize(n + size);
+      if (size > 0)
+        std::memcpy(&m_buf[n], data, size);
+    }
+
+    size_t size() const { return m_buf.size(); }
+
+  private:
+    template<typename T>
+    void write_value(const T value) {
+      const size_t n = m_buf.size();
+      m_buf.resize(n + sizeof(T));
+#ifdef LAF_LITTLE_ENDIAN
+      std::memcpy(&m_buf[n], &value, sizeof(T));
+#else
+      for (size_t i=0; i<sizeof(T); ++i)
+        m_buf[n+i] = uint8_t(value >> (8*i));
+#endif
+    }
+
+    buffer& m_buf;
+  };
+
+  // Counterpart of the serializer reading from a raw span of bytes.
+  // Reads past the end return zero and turn ok() false instead of
+  // throwing (check ok() when the whole read ends).
+  class deserializer {
+  public:
+    deserializer(const uint8_t* data, const size_t size)
+      : m_data(data), m_end(data+size) { }
+    explicit deserializer(const buffer& buf)
+      : deserializer(buf.empty() ? nullptr: &buf[0], buf.size()) { }
+
+    uint8_t read8() { return read_value<uint8_t>(); }
+    uint16_t read16() { return read_value<uint16_t>(); }
+    uint32_t read32() { return read_value<uint32_t>(); }
+    uint64_t read64() { return read_value<uint64_t>(); }
+    float read_float() {
+      const uint32_t b = read_value<uint32_t>();
+      float value;
+      std::memcpy(&value, &b, 4);
+      return value;
+    }
+    double read_double() {
+      const uint64_t b = read_value<uint64_t>();
+      double value;
+      std::memcpy(&value, &b, 8);
+      return value;
+    }
+    uint64_t read_varuint() {
+      uint64_t value = 0;
+      int shift = 0;
+      while (shift < 64) {
+        const uint8_t byte = read8();
+        if (!m_ok)
+          break;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+          break;
+        shift += 7;
+      }
+      return value;
+    }
+    int64_t read_varint() {
+      const uint64_t zz = read_varuint();
+      return int64_t(zz >> 1) ^ -int64_t(zz & 1);
+    }
+
+    size_t read_bytes(uint8_t* data, size_t size) {
+      size = std::min<size_t>(size, m_end - m_data);
+      if (size > 0) {
+        std::memcpy(data, m_data, size);
+        m_data += size;
+      }
+      return size;
+    }
+
+    size_t remaining() const { return m_end - m_data; }
+    bool ok() const { return m_ok; }
+
+  private:
+    template<typename T>
+    T read_value() {
+      if (m_data + sizeof(T) > m_end) {
+        m_data = m_end;
+        m_ok = false;
+        return T(0);
+      }
+      T value;
+#ifdef LAF_LITTLE_ENDIAN
+      std::memcpy(&value, m_data, sizeof(T));
+#else
+      value = T(0);
+      for (size_t i=0; i<sizeof(T); ++i)
+        value |= T(m_data[i]) << (8*i);
+#endif
+      m_data += sizeof(T);
+      return value;
+    }
+
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+    bool m_ok = true;
+  };
+
 } // serialization namespace
 } // base namespace
 
@@ -0,0 +1,146 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/serialization.h"
+
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using namespace base;
+using namespace base::serialization;
+
+TEST(Serialization, BufferRoundtrip)
+{
+  buffer buf;
+  serializer s(buf);
+  s.reserve_ahead(64);
+  s.write8(0x01);
+  s.write16(0x0203);
+  s.write32(0x04050607);
+  s.write64(0x08090a0b0c0d0e0full);
+  s.write_float(1.5f);
+  s.write_double(-2.25);
+  const uint8_t raw[] = { 9, 8, 7 };
+  s.write_bytes(raw, 3);
+
+  deserializer d(buf);
+  EXPECT_EQ(0x01, d.read8());
+  EXPECT_EQ(0x0203, d.read16());
+  EXPECT_EQ(0x04050607, d.read32());
+  EXPECT_EQ(0x08090a0b0c0d0e0full, d.read64());
+  EXPECT_EQ(1.5f, d.read_float());
+  EXPECT_EQ(-2.25, d.read_double());
+  uint8_t raw2[3] = { 0, 0, 0 };
+  EXPECT_EQ(3, d.read_bytes(raw2, 3));
+  EXPECT_EQ(9, raw2[0]);
+  EXPECT_EQ(7, raw2[2]);
+  EXPECT_TRUE(d.ok());
+  EXPECT_EQ(0, d.remaining());
+
+  // Reading past the end doesn't crash, just clears ok()
+  EXPECT_EQ(0, d.read32());
+  EXPECT_FALSE(d.ok());
+}
+
+TEST(Serialization, MatchesOstreamFormat)
+{
+  // The buffer-based serializer must be byte-compatible with the
+  // little_endian iostream-based functions.
+  std::stringstream os;
+  little_endian::write16(os, 0x0102);
+  little_endian::write32(os, 0x03040506);
+  little_endian::write64(os, 0x0708090a0b0c0d0eull);
+
+  buffer buf;
+  serializer s(buf);
+  s.write16(0x0102);
+  s.write32(0x03040506);
+  s.write64(0x0708090a0b0c0d0eull);
+
+  const std::string bytes = os.str();
+  ASSERT_EQ(bytes.size(), buf.size());
+  EXPECT_TRUE(std::memcmp(bytes.data(), &buf[0], buf.size()) == 0);
+}
+
+TEST(Serialization, Varints)
+{
+  std::stringstream os;
+  const uint64_t uvalues[] = {
+    0, 1, 127, 128, 300, 16383, 16384,
+    0xffffffffull, 0xffffffffffffffffull };
+  const int64_t svalues[] = {
+    0, 1, -1, 63, -64, 64, -65, 1000000, -1000000,
+    INT64_MAX, INT64_MIN };
+
+  for (uint64_t v : uvalues)
+    write_varuint(os, v);
+  for (int64_t v : svalues)
+    write_varint(os, v);
+
+  // Small values must really be small
+  {
+    std::stringstream ss;
+    write_varuint(ss, 127);
+    EXPECT_EQ(1, ss.str().size());
+    write_varint(ss, -64);
+    EXPECT_EQ(2, ss.str().size());
+  }
+
+  std::stringstream is(os.str());
+  for (uint64_t v : uvalues)
+    EXPECT_EQ(v, read_varuint(is));
+  for (int64_t v : svalues)
+    EXPECT_EQ(v, read_varint(is));
+  EXPECT_TRUE(bool(is));
+
+  // Reading past the end fails the stream instead of looping
+  read_varuint(is);
+  EXPECT_FALSE(bool(is));
+}
+
+TEST(Serialization, DeltaSpans)
+{
+  // Monotonic coordinates: one byte for the count and around one
+  // byte per element
+  const std::vector<int> xs = { 100000, 100003, 100005, 100010,
+                                100010, 100007, 100064 };
+
+  std::stringstream ss;
+  write_delta_span(ss, xs.begin(), xs.end());
+  EXPECT_EQ(1+3+6, ss.str().size()); // count + first value + 6 one-byte deltas
+
+  std::vector<int> read;
+  EXPECT_EQ(xs.size(), read_delta_span(ss, std::back_inserter(read)));
+  EXPECT_EQ(xs, read);
+
+  // Buffer-based serializer/deserializer varints match the stream
+  // format
+  buffer buf;
+  serializer s(buf);
+  s.write_varuint(300);
+  s.write_varint(-1000000);
+
+  std::stringstream os;
+  write_varuint(os, 300);
+  write_varint(os, -1000000);
+  const std::string bytes = os.str();
+  ASSERT_EQ(bytes.size(), buf.size());
+  EXPECT_TRUE(std::memcmp(bytes.data(), &buf[0], buf.size()) == 0);
+
+  deserializer d(buf);
+  EXPECT_EQ(300, d.read_varuint());
+  EXPECT_EQ(-1000000, d.read_varint());
+  EXPECT_TRUE(d.ok());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,6 +9,7 @@
 #define BASE_SHA1_H_INCLUDED
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -24,6 +26,28 @@ namespace base {
     Sha1();
     explicit Sha1(const std::vector<uint8_t>& digest);
 
+    // Incremental SHA-1 calculation: feed the data in chunks with
+    // update() and finish with digest(), so multi-GB files can be
+    // hashed while they are being read instead of requiring the whole
+    // content in memory.
+    class Stream {
+    public:
+      Stream();
+      ~Stream();
+
+      Stream(const Stream&) = delete;
+      Stream& operator=(const Stream&) = delete;
+
+      void update(const uint8_t* data, size_t size);
+
+      // Finishes the calculation and returns the digest. The stream
+      // cannot be updated anymore after this.
+      Sha1 digest();
+
+    private:
+      std::unique_ptr<SHA1Context> m_context;
+    };
+
     // Calculates the SHA1 of the given file or string.
     static Sha1 calculateFromFile(const std::string& fileName);
     static Sha1 calculateFromString(const std::string& text);
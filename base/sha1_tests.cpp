@@ -0,0 +1,70 @@
+// LAF Base Library
+// Copyright (C) 2022  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/sha1.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace base;
+
+namespace {
+
+std::string hex(const Sha1& sha)
+{
+  std::string result;
+  for (size_t i=0; i<sha.size(); ++i) {
+    char buf[3];
+    std::snprintf(buf, sizeof(buf), "%02x", sha[int(i)]);
+    result += buf;
+  }
+  return result;
+}
+
+} // anonymous namespace
+
+TEST(Sha1, KnownVectors)
+{
+  EXPECT_EQ("da39a3ee5e6b4b0d3255bfef95601890afd80709",
+            hex(Sha1::calculateFromString("")));
+  EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d",
+            hex(Sha1::calculateFromString("abc")));
+  EXPECT_EQ("84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+            hex(Sha1::calculateFromString(
+              "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")));
+
+  // 1 million 'a' (exercises the bulk block path)
+  EXPECT_EQ("34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+            hex(Sha1::calculateFromString(std::string(1000000, 'a'))));
+}
+
+TEST(Sha1, StreamMatchesOneShot)
+{
+  std::string text;
+  for (int i=0; i<100000; ++i)
+    text.push_back(char('a' + (i % 26)));
+
+  const Sha1 oneShot = Sha1::calculateFromString(text);
+
+  // Feed the same data in odd-sized chunks so partial blocks and bulk
+  // blocks are mixed
+  for (size_t chunkSize : { size_t(1), size_t(7), size_t(64), size_t(1000), size_t(4097) }) {
+    Sha1::Stream stream;
+    for (size_t i=0; i<text.size(); i+=chunkSize) {
+      const size_t n = std::min(chunkSize, text.size()-i);
+      stream.update((const uint8_t*)&text[i], n);
+    }
+    EXPECT_TRUE(oneShot == stream.digest()) << "chunkSize=" << chunkSize;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
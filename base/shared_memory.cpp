@@ -0,0 +1,206 @@
+// LAF Base Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/shared_memory.h"
+
+#include "base/process.h"
+
+#include <atomic>
+#include <cstdio>
+
+#if LAF_WINDOWS
+  #include <windows.h>
+
+  #include "base/string.h"
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace base {
+
+#if !LAF_WINDOWS
+// shm_open() requires a name of the form "/segment" (one leading
+// slash and no other).
+static std::string posix_name(const std::string& name)
+{
+  if (!name.empty() && name[0] == '/')
+    return name;
+  return '/' + name;
+}
+#endif
+
+shared_memory::shared_memory(shared_memory&& other) noexcept
+{
+  *this = std::move(other);
+}
+
+shared_memory& shared_memory::operator=(shared_memory&& other) noexcept
+{
+  if (this != &other) {
+    close();
+
+    m_name = std::move(other.m_name);
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_owner = other.m_owner;
+#if LAF_WINDOWS
+    m_mapping = other.m_mapping;
+    other.m_mapping = nullptr;
+#endif
+
+    other.m_name.clear();
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_owner = false;
+  }
+  return *this;
+}
+
+shared_memory::~shared_memory()
+{
+  close();
+}
+
+void shared_memory::close()
+{
+  if (!m_data)
+    return;
+
+#if LAF_WINDOWS
+  UnmapViewOfFile((LPCVOID)m_data);
+  CloseHandle((HANDLE)m_mapping);
+  m_mapping = nullptr;
+#else
+  munmap((void*)m_data, m_size);
+  if (m_owner)
+    shm_unlink(posix_name(m_name).c_str());
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_owner = false;
+}
+
+shared_memory create_shared_memory(const std::string& name, const size_t size)
+{
+  shared_memory result;
+  if (size == 0)
+    return result;
+
+#if LAF_WINDOWS
+
+  HANDLE mapping = CreateFileMappingW(
+    INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+    DWORD(uint64_t(size) >> 32), DWORD(size), from_utf8(name).c_str());
+  if (mapping) {
+    // The name was already in use (by us or another process)
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+      CloseHandle(mapping);
+      return result;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (data) {
+      result.m_name = name;
+      result.m_data = (uint8_t*)data;
+      result.m_size = size;
+      result.m_owner = true;
+      result.m_mapping = mapping;
+      return result;
+    }
+    CloseHandle(mapping);
+  }
+
+#else
+
+  const std::string shmName = posix_name(name);
+  const int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd >= 0) {
+    if (ftruncate(fd, off_t(size)) == 0) {
+      void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED) {
+        result.m_name = name;
+        result.m_data = (uint8_t*)data;
+        result.m_size = size;
+        result.m_owner = true;
+      }
+    }
+    // The mapping (if any) stays valid after closing the descriptor
+    ::close(fd);
+    if (!result.valid())
+      shm_unlink(shmName.c_str());
+  }
+
+#endif
+
+  return result;
+}
+
+shared_memory open_shared_memory(const std::string& name)
+{
+  shared_memory result;
+
+#if LAF_WINDOWS
+
+  HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE,
+                                    from_utf8(name).c_str());
+  if (mapping) {
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data) {
+      MEMORY_BASIC_INFORMATION info;
+      if (VirtualQuery(data, &info, sizeof(info)) == sizeof(info)) {
+        result.m_name = name;
+        result.m_data = (uint8_t*)data;
+        result.m_size = size_t(info.RegionSize);
+        result.m_mapping = mapping;
+        return result;
+      }
+      UnmapViewOfFile(data);
+    }
+    CloseHandle(mapping);
+  }
+
+#else
+
+  const int fd = shm_open(posix_name(name).c_str(), O_RDONLY, 0);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* data = mmap(nullptr, size_t(st.st_size), PROT_READ,
+                        MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED) {
+        result.m_name = name;
+        result.m_data = (uint8_t*)data;
+        result.m_size = size_t(st.st_size);
+      }
+    }
+    ::close(fd);
+  }
+
+#endif
+
+  return result;
+}
+
+std::string make_shared_memory_name(const std::string& prefix)
+{
+  static std::atomic<uint32_t> counter(0);
+
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "-%u-%u",
+                uint32_t(get_current_process_id()),
+                counter.fetch_add(1) + 1);
+  return prefix + buf;
+}
+
+} // namespace base
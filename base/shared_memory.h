@@ -0,0 +1,76 @@
+// LAF Base Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_SHARED_MEMORY_H_INCLUDED
+#define BASE_SHARED_MEMORY_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <string>
+
+namespace base {
+
+  // Named shared-memory segment mapped in this process, to pass
+  // bulk data (e.g. pixels) to a helper process without copying it
+  // through a pipe. Created with create_shared_memory() (read/write,
+  // the creator owns the name and removes it when this object dies)
+  // or opened with open_shared_memory() (read-only view of a segment
+  // created by another process, which must keep its own object alive
+  // until the peer has opened the name). Move-only, like
+  // base::mapped_file.
+  class shared_memory {
+  public:
+    shared_memory() { }
+    shared_memory(shared_memory&& other) noexcept;
+    shared_memory& operator=(shared_memory&& other) noexcept;
+    ~shared_memory();
+
+    shared_memory(const shared_memory&) = delete;
+    shared_memory& operator=(const shared_memory&) = delete;
+
+    // Name to send to the peer process (as given to
+    // create_shared_memory()).
+    const std::string& name() const { return m_name; }
+
+    uint8_t* data() { return m_data; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool valid() const { return m_data != nullptr; }
+
+  private:
+    friend shared_memory create_shared_memory(const std::string& name, size_t size);
+    friend shared_memory open_shared_memory(const std::string& name);
+
+    void close();
+
+    std::string m_name;
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_owner = false;
+#if LAF_WINDOWS
+    void* m_mapping = nullptr;  // HANDLE of the file mapping
+#endif
+  };
+
+  // Creates a new read/write segment of the given size (zeroed).
+  // Returns an invalid object on failure (e.g. the name is already
+  // in use).
+  shared_memory create_shared_memory(const std::string& name, size_t size);
+
+  // Opens a read-only view of a segment created (and still held) by
+  // another process. The mapped size can be rounded up to a page
+  // boundary, so the payload should carry its own length if it
+  // matters. Returns an invalid object if the name doesn't exist.
+  shared_memory open_shared_memory(const std::string& name);
+
+  // Returns a name unlikely to collide ("<prefix>-<pid>-<counter>")
+  // for create_shared_memory().
+  std::string make_shared_memory_name(const std::string& prefix);
+
+} // namespace base
+
+#endif
@@ -0,0 +1,79 @@
+// LAF Base Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/shared_memory.h"
+
+#include <cstring>
+#include <utility>
+
+using namespace base;
+
+TEST(SharedMemory, CreateWriteOpenRead)
+{
+  const std::string name = make_shared_memory_name("laf-test");
+
+  shared_memory owner = create_shared_memory(name, 4096);
+  ASSERT_TRUE(owner.valid());
+  EXPECT_EQ(name, owner.name());
+  EXPECT_EQ(4096, owner.size());
+
+  for (size_t i=0; i<owner.size(); ++i)
+    owner.data()[i] = uint8_t(i);
+
+  shared_memory view = open_shared_memory(name);
+  ASSERT_TRUE(view.valid());
+  ASSERT_GE(view.size(), owner.size());
+  EXPECT_EQ(0, std::memcmp(owner.data(), view.data(), owner.size()));
+}
+
+TEST(SharedMemory, DuplicateNameFails)
+{
+  const std::string name = make_shared_memory_name("laf-test");
+
+  shared_memory first = create_shared_memory(name, 1024);
+  ASSERT_TRUE(first.valid());
+
+  shared_memory second = create_shared_memory(name, 1024);
+  EXPECT_FALSE(second.valid());
+}
+
+TEST(SharedMemory, NameRemovedWithOwner)
+{
+  const std::string name = make_shared_memory_name("laf-test");
+  {
+    shared_memory owner = create_shared_memory(name, 1024);
+    ASSERT_TRUE(owner.valid());
+  }
+  shared_memory view = open_shared_memory(name);
+  EXPECT_FALSE(view.valid());
+}
+
+TEST(SharedMemory, Move)
+{
+  const std::string name = make_shared_memory_name("laf-test");
+
+  shared_memory a = create_shared_memory(name, 1024);
+  ASSERT_TRUE(a.valid());
+  a.data()[0] = 42;
+
+  shared_memory b = std::move(a);
+  EXPECT_FALSE(a.valid());
+  ASSERT_TRUE(b.valid());
+  EXPECT_EQ(name, b.name());
+  EXPECT_EQ(42, b.data()[0]);
+
+  // The segment must still be alive (only one owner after the move)
+  shared_memory view = open_shared_memory(name);
+  EXPECT_TRUE(view.valid());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
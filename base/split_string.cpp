@@ -56,3 +56,20 @@ void base::split_string(const std::string& string,
     }
   }
 }
+
+void base::split_string(const std::string_view string,
+                        std::vector<std::string_view>& parts,
+                        const std::string_view separators)
+{
+  const std::size_t elements =
+    1 + std::count_if(string.begin(), string.end(),
+                      [separators](const char chr) {
+                        return (separators.find(chr) != std::string_view::npos);
+                      });
+  parts.reserve(elements);
+
+  for_each_token(string, separators,
+                 [&parts](const std::string_view token) {
+                   parts.push_back(token);
+                 });
+}
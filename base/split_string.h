@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace base {
@@ -17,6 +18,32 @@ namespace base {
                     std::vector<std::string>& parts,
                     const std::string& separators);
 
+  // Zero-copy variant: the tokens are views into "string", valid as
+  // long as the original string is.
+  void split_string(std::string_view string,
+                    std::vector<std::string_view>& parts,
+                    std::string_view separators);
+
+  // Allocation-free variant: calls onToken with a std::string_view
+  // for each token (including empty ones, like split_string() does).
+  template<typename OnToken>
+  void for_each_token(std::string_view string,
+                      std::string_view separators,
+                      OnToken&& onToken) {
+    std::size_t beg = 0;
+    while (true) {
+      const std::size_t end = string.find_first_of(separators, beg);
+      if (end != std::string_view::npos) {
+        onToken(string.substr(beg, end - beg));
+        beg = end+1;
+      }
+      else {
+        onToken(string.substr(beg));
+        break;
+      }
+    }
+  }
+
 }
 
 #endif
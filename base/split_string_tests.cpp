@@ -46,6 +46,35 @@ TEST(SplitString, MultipleSeparators)
   EXPECT_EQ("ld", result[2]);
 }
 
+TEST(SplitString, StringViewParts)
+{
+  const std::string str = "dog,cat,,bird";
+  std::vector<std::string_view> parts;
+  base::split_string(str, parts, ",");
+
+  ASSERT_EQ(4, parts.size());
+  EXPECT_EQ("dog", parts[0]);
+  EXPECT_EQ("cat", parts[1]);
+  EXPECT_EQ("", parts[2]);
+  EXPECT_EQ("bird", parts[3]);
+
+  // The views point into the original string
+  EXPECT_EQ(str.data(), parts[0].data());
+}
+
+TEST(SplitString, ForEachToken)
+{
+  std::vector<std::string> result;
+  base::for_each_token("a/b:c", "/:",
+                       [&result](const std::string_view token) {
+                         result.push_back(std::string(token));
+                       });
+  ASSERT_EQ(3, result.size());
+  EXPECT_EQ("a", result[0]);
+  EXPECT_EQ("b", result[1]);
+  EXPECT_EQ("c", result[2]);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
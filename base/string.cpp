@@ -16,6 +16,10 @@
 #include <cctype>
 #include <vector>
 
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
 #ifdef LAF_WINDOWS
   #include <windows.h>
 #endif
@@ -91,11 +95,11 @@ std::string to_utf8(const wchar_t* src, const size_t n)
   return std::string(&buf[0]);
 }
 
-std::wstring from_utf8(const std::string& src)
+std::wstring from_utf8(const std::string_view src)
 {
   int required_size =
     MultiByteToWideChar(CP_UTF8, 0,
-      src.c_str(), (int)src.size(),
+      src.data(), (int)src.size(),
       NULL, 0);
 
   if (required_size == 0)
@@ -104,7 +108,7 @@ std::wstring from_utf8(const std::string& src)
   std::vector<wchar_t> buf(++required_size);
 
   ::MultiByteToWideChar(CP_UTF8, 0,
-    src.c_str(), (int)src.size(),
+    src.data(), (int)src.size(),
     &buf[0], required_size);
 
   return std::wstring(&buf[0]);
@@ -112,82 +116,128 @@ std::wstring from_utf8(const std::string& src)
 
 #else
 
-// Based on Allegro Unicode code (allegro/src/unicode.c)
-static std::size_t insert_utf8_char(std::string* result, wchar_t chr)
+// Decodes a single UTF-8 character from [p, end). Returns the new
+// position and the code point in chr (-1 if the sequence is invalid,
+// same cases that utf8_decode::next() flags).
+static inline const char* decode_utf8_char(const char* p,
+                                           const char* end,
+                                           int& chr)
 {
-  int size, bits, b, i;
-
-  if (chr < 128) {
-    if (result)
-      result->push_back(chr);
-    return 1;
-  }
-
-  bits = 7;
-  while (chr >= (1<<bits))
-    bits++;
-
-  size = 2;
-  b = 11;
-
-  while (b < bits) {
-    size++;
-    b += 5;
-  }
-
-  if (result) {
-    b -= (7-size);
-    int firstbyte = chr>>b;
-    for (i=0; i<size; i++)
-      firstbyte |= (0x80>>i);
+  int c = uint8_t(*p);
+  ++p;
+
+  if (c & 0b1000'0000) {
+    int n = 0;
+    int f = 0b0100'0000;
+    while (c & f) {
+      ++n;
+      f >>= 1;
+    }
 
-    result->push_back(firstbyte);
+    if (n == 0) {
+      chr = -1;                 // Invalid continuation byte alone
+      return p;
+    }
 
-    for (i=1; i<size; i++) {
-      b -= 6;
-      result->push_back(0x80 | ((chr>>b)&0x3F));
+    c &= (0b0001'1111 >> (n-1));
+
+    while (n--) {
+      if (p == end) {
+        chr = -1;               // Missing continuation bytes
+        return p;
+      }
+      const int extra = uint8_t(*p);
+      if ((extra & 0b1100'0000) != 0b1000'0000) {
+        chr = -1;               // Invalid continuation byte
+        return p;
+      }
+      ++p;
+      c = (c << 6) | (extra & 0b0011'1111);
     }
   }
 
-  return size;
+  chr = c;
+  return p;
 }
 
 std::string to_utf8(const wchar_t* src, const size_t n)
 {
-  // Get required size to reserve a string so string::push_back()
-  // doesn't need to reallocate its data.
+  // Cheap arithmetic pass to get the exact output size (instead of
+  // simulating the whole encoding), so the write pass below never
+  // reallocates or checks capacity.
   std::size_t required_size = 0;
-  const auto* p = src;
-  for (size_t i=0; i<n; ++i, ++p)
-    required_size += insert_utf8_char(nullptr, *p);
+  for (size_t i=0; i<n; ++i) {
+    const uint32_t chr = uint32_t(src[i]);
+    required_size += (chr < 0x80    ? 1:
+                      chr < 0x800   ? 2:
+                      chr < 0x10000 ? 3: 4);
+  }
   if (!required_size)
     return "";
 
   std::string result;
-  result.reserve(++required_size);
-  p = src;
-  for (int i=0; i<n; ++i, ++p)
-    insert_utf8_char(&result, *p);
+  result.resize(required_size);
+  char* out = &result[0];
+  for (size_t i=0; i<n; ++i) {
+    const uint32_t chr = uint32_t(src[i]);
+    if (chr < 0x80) {
+      *out++ = char(chr);
+    }
+    else if (chr < 0x800) {
+      *out++ = char(0b1100'0000 | (chr >> 6));
+      *out++ = char(0b1000'0000 | (chr & 0x3f));
+    }
+    else if (chr < 0x10000) {
+      *out++ = char(0b1110'0000 | (chr >> 12));
+      *out++ = char(0b1000'0000 | ((chr >> 6) & 0x3f));
+      *out++ = char(0b1000'0000 | (chr & 0x3f));
+    }
+    else {
+      *out++ = char(0b1111'0000 | (chr >> 18));
+      *out++ = char(0b1000'0000 | ((chr >> 12) & 0x3f));
+      *out++ = char(0b1000'0000 | ((chr >> 6) & 0x3f));
+      *out++ = char(0b1000'0000 | (chr & 0x3f));
+    }
+  }
   return result;
 }
 
-std::wstring from_utf8(const std::string& src)
+std::wstring from_utf8(const std::string_view src)
 {
-  int required_size = utf8_length(src);
-  std::vector<wchar_t> buf(++required_size);
-  std::vector<wchar_t>::iterator buf_it = buf.begin();
-#ifdef _DEBUG
-  std::vector<wchar_t>::iterator buf_end = buf.end();
+  // One wchar_t per input byte is the upper bound, decode in a single
+  // pass and shrink at the end (the old version walked the string
+  // twice, once just to measure).
+  std::wstring result;
+  result.resize(src.size());
+  wchar_t* out = (result.empty() ? nullptr: &result[0]);
+
+  const char* p = src.data();
+  const char* end = p + src.size();
+  while (p < end) {
+#if defined(__SSE2__)
+    // Widen runs of ASCII 16 bytes at a time
+    while (end-p >= 16) {
+      const __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+      if (_mm_movemask_epi8(chunk) != 0)
+        break;
+      for (int i=0; i<16; ++i)
+        out[i] = wchar_t(uint8_t(p[i]));
+      p += 16;
+      out += 16;
+    }
+    if (p == end)
+      break;
 #endif
-  utf8_decode decode(src);
 
-  while (const int chr = decode.next()) {
-    ASSERT(buf_it != buf_end);
-    *buf_it = chr;
-    ++buf_it;
+    int chr;
+    p = decode_utf8_char(p, end, chr);
+    if (chr <= 0)   // Stop on invalid sequences or an embedded NUL,
+      break;        // like utf8_decode::next() does
+    *out++ = wchar_t(chr);
   }
 
-  return std::wstring(buf.data());
+  result.resize(out - (result.empty() ? nullptr: &result[0]));
+  return result;
 }
 
 #endif
@@ -12,6 +12,7 @@
 #include <cstdarg>
 #include <iterator>
 #include <string>
+#include <string_view>
 
 namespace base {
 
@@ -23,11 +24,11 @@ namespace base {
 
   std::string to_utf8(const wchar_t* src, size_t n);
 
-  inline std::string to_utf8(const std::wstring& widestring) {
-   return to_utf8(widestring.c_str(), widestring.size());
+  inline std::string to_utf8(std::wstring_view widestring) {
+   return to_utf8(widestring.data(), widestring.size());
   }
 
-  std::wstring from_utf8(const std::string& utf8string);
+  std::wstring from_utf8(std::string_view utf8string);
 
   int utf8_length(const std::string& utf8string);
   int utf8_icmp(const std::string& a, const std::string& b, int n = 0);
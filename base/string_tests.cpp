@@ -183,6 +183,57 @@ TEST(String, Utf8DecodeDontCrash)
   }
 }
 
+TEST(String, Utf8ConversionLongRoundtrip)
+{
+  // Long mixed ASCII/multi-byte content to exercise the bulk ASCII
+  // fast path and its scalar tail
+  std::wstring wide;
+  for (int i=0; i<1000; ++i) {
+    wide += L"just some plain ascii text ";
+    wide += L"\x00e1\x00e9\x00ed";           // áéí
+    wide += L"\x65e5\x672c\x8a9e";           // 日本語
+  }
+
+  const std::string utf8 = to_utf8(wide);
+  EXPECT_EQ(wide, from_utf8(utf8));
+  EXPECT_EQ(utf8, to_utf8(from_utf8(utf8)));
+
+  // string_view overloads
+  EXPECT_EQ(wide, from_utf8(std::string_view(utf8)));
+  EXPECT_EQ(utf8, to_utf8(std::wstring_view(wide)));
+}
+
+TEST(String, DecodeAll)
+{
+  std::vector<int> chars;
+
+  utf8_decode::decode_all("hi", chars);
+  ASSERT_EQ(2, chars.size());
+  EXPECT_EQ('h', chars[0]);
+  EXPECT_EQ('i', chars[1]);
+
+  // 日本語 + long ASCII run for the bulk path
+  std::string str = "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E";
+  str += std::string(100, 'a');
+  utf8_decode::decode_all(str, chars);
+  ASSERT_EQ(103, chars.size());
+  EXPECT_EQ(0x65e5, chars[0]);
+  EXPECT_EQ(0x672c, chars[1]);
+  EXPECT_EQ(0x8a9e, chars[2]);
+  EXPECT_EQ('a', chars[3]);
+  EXPECT_EQ('a', chars[102]);
+
+  // Must match next() one decode at a time
+  utf8_decode dec(str);
+  for (int chr : chars)
+    EXPECT_EQ(chr, dec.next());
+  EXPECT_EQ(0, dec.next());
+
+  // Stops at invalid sequences like next() does
+  utf8_decode::decode_all("ab\x80zz", chars);
+  ASSERT_EQ(2, chars.size());
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
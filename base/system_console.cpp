@@ -11,6 +11,13 @@
 
 #include "base/system_console.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #ifdef LAF_WINDOWS
 
 // Windows needs some adjustments to the console if the process is
@@ -56,6 +63,7 @@ SystemConsole::SystemConsole()
 
 SystemConsole::~SystemConsole()
 {
+  flush();
   if (withConsole) {
     ::FreeConsole();
     withConsole = false;
@@ -64,6 +72,9 @@ SystemConsole::~SystemConsole()
 
 void SystemConsole::prepareShell()
 {
+  // Don't lose (or reorder) output buffered for the old console
+  flush();
+
   if (withConsole)
     ::FreeConsole();
 
@@ -90,9 +101,120 @@ void SystemConsole::prepareShell()
 namespace base {
 
 SystemConsole::SystemConsole() { }
-SystemConsole::~SystemConsole() { }
+SystemConsole::~SystemConsole() { flush(); }
 void SystemConsole::prepareShell() { }
 
 }
 
 #endif
+
+namespace base {
+
+namespace {
+
+// Shared buffer behind SystemConsole::write(): callers append under
+// a lock and one background flusher writes everything buffered since
+// the last tick with a single fwrite(), batching whole groups of
+// lines per write call.
+class ConsoleBuffer {
+public:
+  static ConsoleBuffer& instance() {
+    static ConsoleBuffer buf;
+    return buf;
+  }
+
+  void write(const char* data, const size_t size) {
+    std::string spill;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_buffer.append(data, size);
+
+      // If we outpace the flusher, the backlog is written from the
+      // calling thread so memory stays bounded.
+      if (m_buffer.size() >= kMaxBuffer)
+        spill = takeBuffer();
+      else if (!m_started) {
+        m_started = true;
+        m_thread = std::thread([this]{ flusher(); });
+      }
+    }
+    writeNow(spill);
+  }
+
+  void flush() {
+    std::string chunk;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      chunk = takeBuffer();
+    }
+    writeNow(chunk);
+    std::fflush(stdout);
+  }
+
+private:
+  ~ConsoleBuffer() {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+      m_thread.join();
+    flush();
+  }
+
+  void flusher() {
+    using namespace std::chrono_literals;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+      m_cv.wait_for(lock, 20ms, [this]{ return m_stop; });
+      if (m_buffer.empty())
+        continue;
+
+      const std::string chunk = takeBuffer();
+      lock.unlock();
+      writeNow(chunk);
+      lock.lock();
+    }
+  }
+
+  // m_mutex must be locked
+  std::string takeBuffer() {
+    std::string chunk = std::move(m_buffer);
+    m_buffer.clear();
+    return chunk;
+  }
+
+  static void writeNow(const std::string& chunk) {
+    if (!chunk.empty())
+      std::fwrite(chunk.data(), 1, chunk.size(), stdout);
+  }
+
+  static constexpr size_t kMaxBuffer = 256*1024;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::string m_buffer;
+  std::thread m_thread;
+  bool m_started = false;
+  bool m_stop = false;
+};
+
+} // anonymous namespace
+
+void SystemConsole::write(const char* data, size_t size)
+{
+  ConsoleBuffer::instance().write(data, size);
+}
+
+void SystemConsole::write(const std::string& text)
+{
+  ConsoleBuffer::instance().write(text.c_str(), text.size());
+}
+
+void SystemConsole::flush()
+{
+  ConsoleBuffer::instance().flush();
+}
+
+} // namespace base
@@ -8,6 +8,8 @@
 #define BASE_SYSTEM_CONSOLE_H_INCLUDED
 #pragma once
 
+#include <string>
+
 namespace base {
 
 // This class is needed only for Windows platform.
@@ -50,6 +52,20 @@ public:
   // process's stdin starts deattached from the parent process's
   // console. (On Unix-like systems it does nothing.)
   void prepareShell();
+
+  // Binary-safe bulk output: the data is appended to an internal
+  // buffer that a background flusher writes to stdout in one big
+  // chunk every few milliseconds, so printing thousands of progress
+  // lines costs a handful of write calls instead of one per line
+  // (console I/O is specially slow on Windows). Output written
+  // directly to stdout (e.g. an interactive prompt) still works:
+  // call flush() before it to keep everything in order
+  // (prepareShell() and the destructor flush automatically).
+  void write(const char* data, size_t size);
+  void write(const std::string& text);
+
+  // Writes any buffered output to stdout immediately.
+  void flush();
 };
 
 } // namespace base
@@ -15,9 +15,26 @@
 
 namespace base {
 
+bool task::future::completed() const
+{
+  ASSERT(m_state);
+  const std::unique_lock lock(m_state->mutex);
+  return m_state->completed;
+}
+
+void task::future::wait()
+{
+  ASSERT(m_state);
+  std::unique_lock<std::mutex> lock(m_state->mutex);
+  m_state->cv.wait(lock, [this]() -> bool {
+                           return m_state->completed;
+                         });
+}
+
 task::task()
   : m_running(false)
   , m_completed(false)
+  , m_pool(nullptr)
 {
 }
 
@@ -40,11 +57,79 @@ task_token& task::start(thread_pool& pool)
   m_running = true;
   m_completed = false;
   m_token.reset();
+  m_pool = &pool;
+  {
+    const std::unique_lock lock(m_contMutex);
+    m_finished = false;
+  }
 
   pool.execute([this]{ in_worker_thread(); });
   return m_token;
 }
 
+task::future task::then(func_t&& f)
+{
+  continuation c;
+  c.func = std::move(f);
+  c.state = std::make_shared<future::state>();
+
+  future result(c.state);
+
+  bool runNow = false;
+  {
+    const std::unique_lock lock(m_contMutex);
+    if (m_finished)
+      runNow = true;
+    else
+      m_continuations.push_back(std::move(c));
+  }
+
+  // The task already finished, schedule the continuation right away.
+  if (runNow) {
+    if (m_token.canceled())
+      c.state->token.cancel();
+
+    if (m_pool)
+      schedule_continuation(*m_pool, std::move(c));
+    else {
+      // The task was never started in a pool, run the continuation
+      // in the calling thread.
+      try {
+        if (!c.state->token.canceled())
+          c.func(c.state->token);
+      }
+      catch (const std::exception& ex) {
+        LOG(FATAL, "Exception running continuation: %s\n", ex.what());
+      }
+      {
+        const std::unique_lock lock(c.state->mutex);
+        c.state->completed = true;
+      }
+      c.state->cv.notify_all();
+    }
+  }
+
+  return result;
+}
+
+void task::schedule_continuation(thread_pool& pool, continuation&& c)
+{
+  pool.execute([c]() mutable {
+    try {
+      if (!c.state->token.canceled())
+        c.func(c.state->token);
+    }
+    catch (const std::exception& ex) {
+      LOG(FATAL, "Exception running continuation: %s\n", ex.what());
+    }
+    {
+      const std::unique_lock lock(c.state->mutex);
+      c.state->completed = true;
+    }
+    c.state->cv.notify_all();
+  });
+}
+
 void task::in_worker_thread()
 {
   try {
@@ -55,11 +140,29 @@ void task::in_worker_thread()
     LOG(FATAL, "Exception running task: %s\n", ex.what());
   }
 
+  // Steal the pending continuations before marking the task as
+  // completed: after m_completed is set the task instance can be
+  // deleted by the client at any time.
+  thread_pool* pool = m_pool;
+  const bool canceled = m_token.canceled();
+  std::vector<continuation> continuations;
+  {
+    const std::unique_lock lock(m_contMutex);
+    m_finished = true;
+    continuations.swap(m_continuations);
+  }
+
   m_running = false;
 
   // This must be the latest statement in the worker thread (see
   // task::complete() comment)
   m_completed = true;
+
+  for (auto& c : continuations) {
+    if (canceled)
+      c.state->token.cancel();
+    schedule_continuation(*pool, std::move(c));
+  }
 }
 
 } // namespace base
@@ -12,7 +12,12 @@
 #include "base/thread_pool.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace base {
 
@@ -31,7 +36,26 @@ namespace base {
     bool canceled() const { return m_canceled; }
     float progress() const { return m_progress; }
 
-    void cancel() { m_canceled = true; }
+    void cancel() {
+      {
+        const std::lock_guard lock(m_mutex);
+        m_canceled = true;
+      }
+      m_cv.notify_all();
+    }
+
+    // Cancellation-aware sleep: blocks the calling thread up to the
+    // given duration but wakes up immediately if the token is
+    // canceled from another thread, so long tasks can pace
+    // themselves without polling canceled() in a tight loop. Returns
+    // true if the token was canceled.
+    template<class Rep, class Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& timeout) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait_for(lock, timeout,
+                    [this]() -> bool { return m_canceled; });
+      return m_canceled;
+    }
     void set_progress(float p) {
       ASSERT(p >= 0.0f && p <= 1.0f);
       m_progress = m_progress_min
@@ -51,12 +75,48 @@ namespace base {
     std::atomic<bool> m_canceled;
     std::atomic<float> m_progress;
     float m_progress_min, m_progress_max;
+
+    // To implement the cancellation-aware wait_for()
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
   };
 
   class task {
   public:
     typedef std::function<void(task_token&)> func_t;
 
+    // Lightweight handle to wait for (or check the completion of) a
+    // continuation created with then(). It doesn't keep the original
+    // task alive, just the shared state of the continuation itself.
+    class future {
+      friend class task;
+    public:
+      future() { }
+
+      bool valid() const { return m_state != nullptr; }
+      bool completed() const;
+
+      // Blocks the calling thread until the continuation finishes
+      // (doesn't consume a worker thread of the pool).
+      void wait();
+
+      // Token of the continuation, can be used to cancel it before
+      // it runs, or to check its progress.
+      task_token& token() { ASSERT(m_state); return m_state->token; }
+
+    private:
+      struct state {
+        std::mutex mutex;
+        std::condition_variable cv;
+        task_token token;
+        bool completed = false;
+      };
+
+      future(const std::shared_ptr<state>& s) : m_state(s) { }
+
+      std::shared_ptr<state> m_state;
+    };
+
     task();
     ~task();
 
@@ -64,6 +124,14 @@ namespace base {
 
     task_token& start(thread_pool& pool);
 
+    // Chains a continuation that will be scheduled in the same
+    // thread_pool right after this task finishes, i.e. no worker
+    // thread is blocked nor we have to poll completed(). If the task
+    // token is canceled, the continuation token is canceled too (the
+    // continuation future still completes). Can be called several
+    // times to run independent continuations.
+    future then(func_t&& f);
+
     bool running() const { return m_running; }
 
     // Returns true when the task is completed (whether it was
@@ -73,12 +141,26 @@ namespace base {
     bool completed() const { return m_completed; }
 
   private:
+    struct continuation {
+      func_t func;
+      std::shared_ptr<future::state> state;
+    };
+
     void in_worker_thread();
+    static void schedule_continuation(thread_pool& pool, continuation&& c);
 
     std::atomic<bool> m_running;
     std::atomic<bool> m_completed;
     task_token m_token;
     func_t m_execute;
+
+    thread_pool* m_pool;
+    std::mutex m_contMutex;
+    // Both fields are guarded by m_contMutex. m_finished is like
+    // m_completed but is set before releasing the pending
+    // continuations, so then() cannot miss the completion.
+    bool m_finished = false;
+    std::vector<continuation> m_continuations;
   };
 
 } // namespace base
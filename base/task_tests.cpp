@@ -9,6 +9,9 @@
 #include "base/task.h"
 #include "base/thread_pool.h"
 
+#include <chrono>
+#include <thread>
+
 using namespace base;
 
 TEST(Task, Basic)
@@ -54,6 +57,68 @@ TEST(Task, MultiplePools)
   EXPECT_EQ(0, c);
 }
 
+TEST(Task, Continuations)
+{
+  thread_pool p(4);
+  std::atomic<int> c(0);
+
+  task t;
+  t.on_execute([&c](task_token&){ c = 1; });
+
+  // Chained before the task starts
+  task::future f1 = t.then([&c](task_token&){ c = c*10; });
+  t.start(p);
+  f1.wait();
+  EXPECT_EQ(10, c);
+  EXPECT_TRUE(f1.completed());
+
+  // Chained after the task completed
+  task::future f2 = t.then([&c](task_token&){ c = c+5; });
+  f2.wait();
+  EXPECT_EQ(15, c);
+}
+
+TEST(Task, CanceledTaskCancelsContinuations)
+{
+  thread_pool p(4);
+  std::atomic<int> c(0);
+
+  task t;
+  t.on_execute([](task_token& token){ token.cancel(); });
+  task::future f = t.then([&c](task_token&){ ++c; });
+  t.start(p);
+  f.wait();
+
+  // The continuation future completes but its function is not
+  // executed because its token was canceled.
+  EXPECT_TRUE(f.completed());
+  EXPECT_TRUE(f.token().canceled());
+  EXPECT_EQ(0, c);
+}
+
+TEST(Task, TokenWaitForWakesUpOnCancel)
+{
+  using namespace std::chrono_literals;
+
+  task_token token;
+
+  std::thread canceler([&token]{
+    std::this_thread::sleep_for(10ms);
+    token.cancel();
+  });
+
+  // Without the cancel this would sleep for one minute
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(token.wait_for(60s));
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, 30s);
+
+  canceler.join();
+
+  // An already canceled token doesn't wait at all
+  EXPECT_TRUE(token.wait_for(60s));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
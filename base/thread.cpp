@@ -22,8 +22,12 @@
   #include <pthread.h>     // Use pthread library in Unix-like systems
 
   #include <unistd.h>
+  #include <sys/resource.h>
   #include <sys/time.h>
   #include <algorithm>
+  #if !LAF_MACOS
+    #include <sched.h>
+  #endif
 #endif
 
 #if LAF_WINDOWS
@@ -89,6 +93,71 @@ void this_thread::sleep_for(double seconds)
 #endif
 }
 
+void this_thread::set_priority(const thread_priority priority)
+{
+#if LAF_WINDOWS
+
+  int value = THREAD_PRIORITY_NORMAL;
+  switch (priority) {
+    case thread_priority::low:    value = THREAD_PRIORITY_BELOW_NORMAL; break;
+    case thread_priority::normal: value = THREAD_PRIORITY_NORMAL; break;
+    case thread_priority::high:   value = THREAD_PRIORITY_ABOVE_NORMAL; break;
+  }
+  ::SetThreadPriority(GetCurrentThread(), value);
+
+#elif LAF_MACOS
+
+  // QoS classes are what the macOS scheduler uses to steer threads
+  // between P-cores and E-cores on Apple silicon.
+  qos_class_t qos = QOS_CLASS_DEFAULT;
+  switch (priority) {
+    case thread_priority::low:    qos = QOS_CLASS_UTILITY; break;
+    case thread_priority::normal: qos = QOS_CLASS_DEFAULT; break;
+    case thread_priority::high:   qos = QOS_CLASS_USER_INTERACTIVE; break;
+  }
+  pthread_set_qos_class_self_np(qos, 0);
+
+#else
+
+  // On Linux setpriority(PRIO_PROCESS, 0, ...) applies to the calling
+  // thread only. Lowering nice always works; raising it above 0 may
+  // need privileges and then this call silently does nothing.
+  int nice = 0;
+  switch (priority) {
+    case thread_priority::low:    nice = 10; break;
+    case thread_priority::normal: nice = 0; break;
+    case thread_priority::high:   nice = -10; break;
+  }
+  setpriority(PRIO_PROCESS, 0, nice);
+
+#endif
+}
+
+bool this_thread::pin_to_core(const int core)
+{
+#if LAF_WINDOWS
+
+  return (::SetThreadAffinityMask(GetCurrentThread(),
+                                  DWORD_PTR(1) << core) != 0);
+
+#elif LAF_MACOS
+
+  // macOS doesn't expose hard thread affinity (THREAD_AFFINITY_POLICY
+  // is only a cache-sharing hint and ignored on Apple silicon); use
+  // set_priority()/QoS to influence P/E-core placement instead.
+  (void)core;
+  return false;
+
+#else
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  return (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0);
+
+#endif
+}
+
 void this_thread::set_name(const std::string& name)
 {
 #if LAF_WINDOWS
@@ -12,6 +12,15 @@
 #include <string>
 
 namespace base {
+
+// Relative scheduling priority of a thread inside the process (see
+// this_thread::set_priority()).
+enum class thread_priority {
+  low,                          // Background work
+  normal,
+  high,                         // Latency-critical work
+};
+
 namespace this_thread {
 
 void yield();
@@ -19,6 +28,18 @@ void yield();
 // TODO replace with std::this_thread::sleep_for(std::chrono::seconds(...)) or similar
 void sleep_for(double seconds);
 
+// Sets the scheduling priority of the calling thread. Mapped to
+// SetThreadPriority() on Windows, QoS classes on macOS (which is also
+// what steers work between P/E-cores on hybrid CPUs), and the
+// per-thread nice value on Linux (raising it above normal may require
+// privileges and can fail silently).
+void set_priority(thread_priority priority);
+
+// Pins the calling thread to the given logical core (0-based).
+// Returns false where hard affinity isn't available (e.g. macOS only
+// takes scheduler hints).
+bool pin_to_core(int core);
+
 // Associates a name/description to the current thread. Useful for
 // debugging purposes. E.g. When we receive a crash dump from Sentry
 // we can identify a thread by its name.
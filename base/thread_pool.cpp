@@ -12,16 +12,85 @@
 #include "base/log.h"
 #include "base/thread_pool.h"
 
+#include <algorithm>
+
 namespace base {
 
+namespace {
+
+// Set when the current thread is a worker of a pool, so execute()
+// called from a worker pushes into its own queue (avoiding the
+// round-robin and keeping recursively created work local).
+thread_local thread_pool* tl_pool = nullptr;
+thread_local size_t tl_queueIndex = 0;
+
+} // anonymous namespace
+
 thread_pool::thread_pool(const size_t n)
+  : thread_pool(n, policy())
+{
+}
+
+thread_pool::thread_pool(const size_t n,
+                         const policy& pol)
   : m_running(true)
+  , m_policy(pol)
   , m_threads(n)
+  , m_dynamic(false)
+  , m_idleTimeout(0)
+  , m_alive(n, true)
+  , m_aliveCount(n)
+  , m_idleWorkers(0)
+  , m_pushQueue(0)
+  , m_workCount(0)
+  , m_queuedHighWater(0)
+  , m_executed(0)
+  , m_busyTime(std::make_unique<std::atomic<uint64_t>[]>(n))
+  , m_startTime(std::chrono::steady_clock::now())
   , m_doingWork(0)
 {
   const std::unique_lock lock(m_mutex);
+  m_queues.reserve(n);
+  for (size_t i=0; i<n; ++i) {
+    m_busyTime[i] = 0;
+    m_queues.push_back(std::make_unique<work_queue>());
+  }
   for (size_t i=0; i<n; ++i)
-    m_threads[i] = std::thread([this]{ worker(); });
+    m_threads[i] = std::thread([this, i]{ worker(i); });
+}
+
+thread_pool::thread_pool(const size_t n,
+                         const std::chrono::milliseconds idleTimeout)
+  : thread_pool(n, idleTimeout, policy())
+{
+}
+
+thread_pool::thread_pool(const size_t n,
+                         const std::chrono::milliseconds idleTimeout,
+                         const policy& pol)
+  : m_running(true)
+  , m_policy(pol)
+  , m_threads(n)
+  , m_dynamic(true)
+  , m_idleTimeout(idleTimeout)
+  , m_alive(n, false)
+  , m_aliveCount(0)
+  , m_idleWorkers(0)
+  , m_pushQueue(0)
+  , m_workCount(0)
+  , m_queuedHighWater(0)
+  , m_executed(0)
+  , m_busyTime(std::make_unique<std::atomic<uint64_t>[]>(n))
+  , m_startTime(std::chrono::steady_clock::now())
+  , m_doingWork(0)
+{
+  const std::unique_lock lock(m_mutex);
+  m_queues.reserve(n);
+  for (size_t i=0; i<n; ++i) {
+    m_busyTime[i] = 0;
+    m_queues.push_back(std::make_unique<work_queue>());
+  }
+  // Workers are spawned lazily from execute()
 }
 
 thread_pool::~thread_pool()
@@ -29,12 +98,136 @@ thread_pool::~thread_pool()
   join_all();
 }
 
-void thread_pool::execute(std::function<void()>&& func)
+void thread_pool::execute(std::function<void()>&& func,
+                          const priority pr)
 {
-  const std::unique_lock lock(m_mutex);
   ASSERT(m_running);
-  m_work.push(std::move(func));
-  m_cv.notify_one();
+  ASSERT(!m_queues.empty());
+
+  size_t i;
+  if (tl_pool == this)
+    i = tl_queueIndex;
+  else
+    i = m_pushQueue++ % m_queues.size();
+
+  {
+    const std::unique_lock lock(m_queues[i]->mutex);
+    m_queues[i]->work[int(pr)].push_back(std::move(func));
+  }
+  const int queued = ++m_workCount;
+  update_high_water(queued);
+
+  {
+    const std::unique_lock lock(m_mutex);
+    // In dynamic mode spawn a new worker if everybody is busy and we
+    // didn't reach the cap yet.
+    if (m_dynamic &&
+        m_running &&
+        m_idleWorkers == 0 &&
+        m_aliveCount < m_threads.size()) {
+      spawn_worker();
+    }
+    m_cv.notify_one();
+  }
+}
+
+void thread_pool::execute_batch(std::vector<std::function<void()>>&& funcs,
+                                const priority pr)
+{
+  ASSERT(m_running);
+  ASSERT(!m_queues.empty());
+
+  const size_t n = funcs.size();
+  if (n == 0)
+    return;
+
+  // Distribute the batch between the queues in contiguous slices,
+  // locking each queue just once.
+  const size_t nqueues = m_queues.size();
+  const size_t per = (n + nqueues - 1) / nqueues;
+  size_t next = 0;
+  for (size_t j=0; j<nqueues && next<n; ++j) {
+    const size_t i = m_pushQueue++ % nqueues;
+    const size_t end = std::min(n, next+per);
+
+    const std::unique_lock lock(m_queues[i]->mutex);
+    for (; next<end; ++next)
+      m_queues[i]->work[int(pr)].push_back(std::move(funcs[next]));
+  }
+  update_high_water(m_workCount += int(n));
+  funcs.clear();
+
+  {
+    const std::unique_lock lock(m_mutex);
+    if (m_dynamic && m_running) {
+      while (m_idleWorkers == 0 && m_aliveCount < m_threads.size())
+        spawn_worker();
+    }
+    m_cv.notify_all();
+  }
+}
+
+void thread_pool::update_high_water(const int queued)
+{
+  int highWater = m_queuedHighWater;
+  while (queued > highWater &&
+         !m_queuedHighWater.compare_exchange_weak(highWater, queued))
+    ;
+}
+
+thread_pool::stats thread_pool::get_stats() const
+{
+  stats result;
+  result.workers = m_threads.size();
+  result.queued = m_workCount;
+  result.queued_high_water = m_queuedHighWater;
+  result.executed = m_executed;
+
+  const double uptime =
+    std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - m_startTime).count();
+  if (uptime > 0.0)
+    result.tasks_per_second = double(result.executed) / uptime;
+
+  result.busy_time.resize(m_threads.size());
+  for (size_t i=0; i<m_threads.size(); ++i)
+    result.busy_time[i] = double(m_busyTime[i].load()) / 1e9;
+
+  {
+    const std::unique_lock lock(m_mutex);
+    result.alive_workers = m_aliveCount;
+    result.running = m_doingWork;
+  }
+  return result;
+}
+
+void thread_pool::log_stats() const
+{
+  const stats s = get_stats();
+  LOG(INFO, "POOL: %d/%d workers, %d queued (high-water %d), %d running, "
+            "%llu executed (%.1f tasks/sec)\n",
+      int(s.alive_workers), int(s.workers),
+      s.queued, s.queued_high_water, s.running,
+      (unsigned long long)s.executed, s.tasks_per_second);
+  for (size_t i=0; i<s.busy_time.size(); ++i)
+    LOG(INFO, "POOL:   worker %d busy %.3f secs\n", int(i), s.busy_time[i]);
+}
+
+void thread_pool::spawn_worker()
+{
+  for (size_t i=0; i<m_threads.size(); ++i) {
+    if (!m_alive[i]) {
+      // Collect the previous (already exited) worker of this slot
+      if (m_threads[i].joinable())
+        m_threads[i].join();
+
+      m_alive[i] = true;
+      ++m_aliveCount;
+      m_threads[i] = std::thread([this, i]{ worker(i); });
+      return;
+    }
+  }
+  ASSERT(false); // m_aliveCount said that there was a free slot
 }
 
 void thread_pool::wait_all()
@@ -43,7 +236,7 @@ void thread_pool::wait_all()
   m_cvWait.wait(lock, [this]() -> bool {
                         return
                           !m_running ||
-                          (m_work.empty() && m_doingWork == 0);
+                          (m_workCount == 0 && m_doingWork == 0);
                       });
 }
 
@@ -71,8 +264,52 @@ void thread_pool::join_all()
   }
 }
 
-void thread_pool::worker()
+bool thread_pool::pop_or_steal(const size_t i, std::function<void()>& func)
+{
+  const size_t n = m_queues.size();
+
+  // First our own queue (from the back, where we've just pushed),
+  // visiting high priority lanes first
+  {
+    work_queue& q = *m_queues[i];
+    const std::unique_lock lock(q.mutex);
+    for (int pr=0; pr<kPriorities; ++pr) {
+      if (!q.work[pr].empty()) {
+        func = std::move(q.work[pr].back());
+        q.work[pr].pop_back();
+        return true;
+      }
+    }
+  }
+
+  // Then try to steal from the other queues (from the front, the
+  // oldest/coldest work)
+  for (size_t j=1; j<n; ++j) {
+    work_queue& q = *m_queues[(i+j) % n];
+    const std::unique_lock lock(q.mutex);
+    for (int pr=0; pr<kPriorities; ++pr) {
+      if (!q.work[pr].empty()) {
+        func = std::move(q.work[pr].front());
+        q.work[pr].pop_front();
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void thread_pool::worker(const size_t i)
 {
+  tl_pool = this;
+  tl_queueIndex = i;
+
+  this_thread::set_name(m_policy.name + std::to_string(i));
+  if (m_policy.priority != thread_priority::normal)
+    this_thread::set_priority(m_policy.priority);
+  if (!m_policy.cores.empty())
+    this_thread::pin_to_core(m_policy.cores[i % m_policy.cores.size()]);
+
   bool running;
   {
     const std::unique_lock lock(m_mutex);
@@ -80,18 +317,42 @@ void thread_pool::worker()
   }
   while (running) {
     std::function<void()> func;
-    {
+    if (pop_or_steal(i, func)) {
+      {
+        const std::unique_lock lock(m_mutex);
+        ++m_doingWork;
+      }
+      --m_workCount;
+    }
+    else {
       std::unique_lock<std::mutex> lock(m_mutex);
-      m_cv.wait(lock, [this]() -> bool {
-                        return !m_running || !m_work.empty();
-                      });
+      ++m_idleWorkers;
+      bool haveWork = true;
+      if (m_dynamic) {
+        haveWork =
+          m_cv.wait_for(lock, m_idleTimeout,
+                        [this]() -> bool {
+                          return !m_running || m_workCount > 0;
+                        });
+      }
+      else {
+        m_cv.wait(lock, [this]() -> bool {
+                          return !m_running || m_workCount > 0;
+                        });
+      }
+      --m_idleWorkers;
       running = m_running;
-      if (m_running && !m_work.empty()) {
-        func = std::move(m_work.front());
-        ++m_doingWork;
-        m_work.pop();
+
+      // Idle for too long in dynamic mode, exit this worker (it
+      // will be respawned from execute() when needed).
+      if (m_dynamic && running && !haveWork) {
+        m_alive[i] = false;
+        --m_aliveCount;
+        return;
       }
+      continue;
     }
+    const auto chronoStart = std::chrono::steady_clock::now();
     try {
       if (func)
         func();
@@ -108,10 +369,20 @@ void thread_pool::worker()
 
     // Decrement m_doingWork only if we've incremented it
     if (func) {
+      m_busyTime[i] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - chronoStart).count();
+      ++m_executed;
+
       const std::unique_lock lock(m_mutex);
       --m_doingWork;
       m_cvWait.notify_all();
     }
+
+    {
+      const std::unique_lock lock(m_mutex);
+      running = m_running;
+    }
   }
 }
 
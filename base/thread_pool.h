@@ -8,10 +8,15 @@
 #define BASE_THREAD_POOL_H_INCLUDED
 #pragma once
 
+#include "base/thread.h"
+
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
 
@@ -19,27 +24,133 @@ namespace base {
 
   class thread_pool {
   public:
+    // Priority lanes for queued work. High priority work is always
+    // popped/stolen before normal one, and normal before low, so
+    // latency-sensitive tasks (e.g. an interactive preview) are not
+    // starved by long background jobs.
+    enum class priority {
+      high = 0,
+      normal = 1,
+      low = 2,
+    };
+    static constexpr int kPriorities = 3;
+
+    // Scheduling policy applied to every worker when it starts:
+    // worker i is named "<name><i>", gets the given OS scheduling
+    // priority, and (when "cores" is not empty) is pinned to
+    // cores[i % cores.size()], so e.g. a latency-critical render pool
+    // can be kept on performance cores while a background pool runs
+    // at low priority.
+    struct policy {
+      std::string name = "worker";
+      thread_priority priority = thread_priority::normal;
+      std::vector<int> cores;   // Empty = don't pin workers
+    };
+
+    // Creates a pool with n workers running from the start.
     thread_pool(const size_t n);
+    thread_pool(const size_t n,
+                const policy& pol);
+
+    // Creates a pool that spawns workers lazily (up to n) when there
+    // is a backlog of work and no idle worker, and where a worker
+    // that stays idle for the given timeout exits (freeing its
+    // resources, e.g. in long-running headless sessions).
+    thread_pool(const size_t n,
+                const std::chrono::milliseconds idleTimeout);
+    thread_pool(const size_t n,
+                const std::chrono::milliseconds idleTimeout,
+                const policy& pol);
+
     ~thread_pool();
 
-    void execute(std::function<void()>&& func);
+    void execute(std::function<void()>&& func,
+                 const priority pr = priority::normal);
+
+    // Enqueues a whole batch of work taking each queue lock just
+    // once and waking up the workers once, instead of paying one
+    // lock/notify round-trip per job.
+    void execute_batch(std::vector<std::function<void()>>&& funcs,
+                       const priority pr = priority::normal);
 
     // Waits until the queue is empty.
     void wait_all();
 
+    // Cheap snapshot of the pool activity, useful to tune pool sizes
+    // or to diagnose a stalled wait_all() from real data.
+    struct stats {
+      size_t workers = 0;          // Worker slots (the "n" of the ctor)
+      size_t alive_workers = 0;    // Spawned workers (dynamic mode)
+      int queued = 0;              // Queued (not yet popped) jobs
+      int queued_high_water = 0;   // Maximum of queued jobs ever seen
+      int running = 0;             // Jobs being executed right now
+      uint64_t executed = 0;       // Total of executed jobs
+      double tasks_per_second = 0.0; // executed/uptime
+      std::vector<double> busy_time; // Seconds each worker spent on jobs
+    };
+    stats get_stats() const;
+
+    // Emits the get_stats() snapshot through LOG(INFO).
+    void log_stats() const;
+
   private:
+    // Each worker has its own deque of pending work: the owner pushes
+    // and pops from the back (better cache locality for recursively
+    // submitted work), other workers steal from the front. This way
+    // workers don't contend on one global queue mutex.
+    struct work_queue {
+      std::mutex mutex;
+      std::deque<std::function<void()>> work[kPriorities];
+    };
+
     // Joins all threads without waiting the queue to be processed.
     void join_all();
 
+    // Spawns (or respawns) the worker of the i-th free slot. The
+    // caller must hold m_mutex.
+    void spawn_worker();
+
+    // Raises the queued jobs high-water mark to the given depth.
+    void update_high_water(const int queued);
+
     // Called for each worker thread.
-    void worker();
+    void worker(const size_t i);
+
+    // Tries to get work from the i-th queue, or to steal it from some
+    // other queue. Returns false if there is no work at all.
+    bool pop_or_steal(const size_t i, std::function<void()>& func);
 
     bool m_running;
+    const policy m_policy;
     std::vector<std::thread> m_threads;
-    std::mutex m_mutex;
+    std::vector<std::unique_ptr<work_queue>> m_queues;
+
+    // Dynamic mode: workers are spawned on demand and exit after
+    // being idle for m_idleTimeout. All these fields (except
+    // m_dynamic/m_idleTimeout which are immutable) are guarded by
+    // m_mutex.
+    const bool m_dynamic;
+    const std::chrono::milliseconds m_idleTimeout;
+    std::vector<bool> m_alive;
+    size_t m_aliveCount;
+    int m_idleWorkers;
+
+    // Round-robin cursor to distribute work pushed from threads that
+    // don't belong to the pool.
+    std::atomic<size_t> m_pushQueue;
+
+    // Number of queued (not yet popped) work items in all queues.
+    std::atomic<int> m_workCount;
+
+    // Instrumentation counters (see get_stats())
+    std::atomic<int> m_queuedHighWater;
+    std::atomic<uint64_t> m_executed;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_busyTime; // nanoseconds
+    std::chrono::steady_clock::time_point m_startTime;
+
+    mutable std::mutex m_mutex;
     std::condition_variable m_cv;
     std::condition_variable m_cvWait;
-    std::queue<std::function<void()>> m_work;
     int m_doingWork;
   };
 
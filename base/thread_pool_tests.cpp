@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 
+#include "base/thread.h"
 #include "base/thread_pool.h"
 
 #include <atomic>
@@ -23,6 +24,135 @@ TEST(ThreadPool, Basic)
   EXPECT_EQ(10000, c);
 }
 
+TEST(ThreadPool, WorkSubmittedFromWorkers)
+{
+  thread_pool p(4);
+  std::atomic<int> c(0);
+
+  // Each task submits more work from inside a worker thread, which
+  // goes to the worker own queue and can be stolen by idle workers.
+  for (int i=0; i<100; ++i) {
+    p.execute([&p, &c]{
+      for (int j=0; j<10; ++j)
+        p.execute([&c]{ ++c; });
+    });
+  }
+  p.wait_all();
+
+  EXPECT_EQ(1000, c);
+}
+
+TEST(ThreadPool, PriorityLanes)
+{
+  // One worker so the execution order is deterministic once the
+  // queue is filled.
+  thread_pool p(1);
+  std::mutex mutex;
+  std::vector<int> order;
+  std::condition_variable cv;
+  bool blocked = true;
+
+  // Block the only worker so we can fill the lanes.
+  p.execute([&]{
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&]{ return !blocked; });
+  });
+
+  p.execute([&]{ std::unique_lock lock(mutex); order.push_back(3); },
+            thread_pool::priority::low);
+  p.execute([&]{ std::unique_lock lock(mutex); order.push_back(2); },
+            thread_pool::priority::normal);
+  p.execute([&]{ std::unique_lock lock(mutex); order.push_back(1); },
+            thread_pool::priority::high);
+
+  {
+    std::unique_lock lock(mutex);
+    blocked = false;
+  }
+  cv.notify_one();
+  p.wait_all();
+
+  ASSERT_EQ(3, order.size());
+  EXPECT_EQ(1, order[0]);
+  EXPECT_EQ(2, order[1]);
+  EXPECT_EQ(3, order[2]);
+}
+
+TEST(ThreadPool, WorkerPolicy)
+{
+  thread_pool::policy pol;
+  pol.name = "render";
+  pol.priority = thread_priority::low;
+  thread_pool p(2, pol);
+
+  std::string name0;
+  p.execute([&name0]{ name0 = this_thread::get_name(); });
+  p.wait_all();
+  EXPECT_TRUE(name0 == "render0" || name0 == "render1") << name0;
+}
+
+TEST(ThreadPool, SingleWorker)
+{
+  thread_pool p(1);
+  std::atomic<int> c(0);
+  for (int i=0; i<100; ++i)
+    p.execute([&c]{ ++c; });
+  p.wait_all();
+
+  EXPECT_EQ(100, c);
+}
+
+TEST(ThreadPool, ExecuteBatch)
+{
+  thread_pool p(4);
+  std::atomic<int> c(0);
+
+  std::vector<std::function<void()>> funcs;
+  for (int i=0; i<1000; ++i)
+    funcs.push_back([&c]{ ++c; });
+
+  p.execute_batch(std::move(funcs));
+  p.wait_all();
+  EXPECT_EQ(1000, c);
+}
+
+TEST(ThreadPool, Stats)
+{
+  thread_pool p(4);
+  std::atomic<int> c(0);
+  for (int i=0; i<500; ++i)
+    p.execute([&c]{ ++c; });
+  p.wait_all();
+
+  const thread_pool::stats s = p.get_stats();
+  EXPECT_EQ(4, s.workers);
+  EXPECT_EQ(500, s.executed);
+  EXPECT_EQ(0, s.queued);
+  EXPECT_EQ(0, s.running);
+  EXPECT_GE(s.queued_high_water, 1);
+  EXPECT_GT(s.tasks_per_second, 0.0);
+  ASSERT_EQ(4, s.busy_time.size());
+}
+
+TEST(ThreadPool, DynamicPool)
+{
+  using namespace std::chrono_literals;
+
+  thread_pool p(4, 10ms);
+  std::atomic<int> c(0);
+  for (int i=0; i<1000; ++i)
+    p.execute([&c]{ ++c; });
+  p.wait_all();
+  EXPECT_EQ(1000, c);
+
+  // Workers exit after being idle and are respawned on new work
+  std::this_thread::sleep_for(100ms);
+  for (int i=0; i<100; ++i)
+    p.execute([&c]{ ++c; });
+  p.wait_all();
+  EXPECT_EQ(1100, c);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -14,7 +14,7 @@
 #if LAF_WINDOWS
   #include <windows.h>
 #else
-  #include <sys/time.h>
+  #include <time.h>
   #if __APPLE__
     #include <mach/mach_time.h>
   #endif
@@ -52,33 +52,43 @@ Time current_time()
 #endif
 }
 
-tick_t current_tick()
+uint64_t now_ns()
 {
 #if LAF_WINDOWS
-  // GetTickCount() is limited to the system timer resolution (from 10
-  // to 16 milliseconds), we prefer QueryPerformanceCounter().
-  LARGE_INTEGER counter, freq;
-  if (QueryPerformanceCounter(&counter) &&
-      // TODO Call QueryPerformanceFrequency() just one time
-      QueryPerformanceFrequency(&freq)) {
-    // TODO Some precision is lost, we could return float or double
-    return counter.QuadPart * 1000 / freq.QuadPart;
-  }
-  else
-    return GetTickCount();
+  // The performance counter frequency is fixed at boot, query it once.
+  static LARGE_INTEGER freq = { };
+  if (freq.QuadPart == 0)
+    QueryPerformanceFrequency(&freq);
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  // Whole seconds and the remainder converted separately to avoid
+  // overflowing the counter*10^9 product.
+  return uint64_t(counter.QuadPart / freq.QuadPart) * 1000000000ull +
+         uint64_t(counter.QuadPart % freq.QuadPart) * 1000000000ull / freq.QuadPart;
 #elif __APPLE__
   static mach_timebase_info_data_t timebase = { 0, 0 };
   if (timebase.denom == 0)
     (void)mach_timebase_info(&timebase);
-  return tick_t(double(mach_absolute_time()) * double(timebase.numer) / double(timebase.denom) / 1.0e6);
+  // Same split as above so t*numer doesn't overflow with long uptimes
+  const uint64_t t = mach_absolute_time();
+  return (t / timebase.denom) * timebase.numer +
+         (t % timebase.denom) * timebase.numer / timebase.denom;
 #else
-  // TODO use clock_gettime(CLOCK_MONOTONIC, &now); if it's possible
-  struct timeval now;
-  gettimeofday(&now, nullptr);
-  return now.tv_sec*1000 + now.tv_usec/1000;
+  // clock_gettime() is serviced by the vDSO (no syscall), so there
+  // is no need for a calibrated rdtsc fast path on top of it.
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return uint64_t(now.tv_sec)*1000000000ull + now.tv_nsec;
 #endif
 }
 
+tick_t current_tick()
+{
+  // Derived from the same monotonic clock, so ticks cannot jump
+  // backwards with wall-clock adjustments.
+  return now_ns() / 1000000;
+}
+
 Time& Time::addSeconds(const int seconds)
 {
   struct std::tm tm;
@@ -71,6 +71,11 @@ namespace base {
   Time current_time();
   tick_t current_tick();
 
+  // Monotonic nanoseconds, for profiling sub-millisecond stages
+  // (current_tick() quantizes everything to 1ms). Unrelated to the
+  // wall clock: only differences between two calls are meaningful.
+  uint64_t now_ns();
+
 }
 
 #endif
@@ -45,6 +45,20 @@ TEST(Time, Cmp)
   EXPECT_FALSE(Time(2019, 5, 2, 0, 0, 0) < Time(2018, 5, 2, 0, 0, 0));
 }
 
+TEST(Time, NowNs)
+{
+  const uint64_t a = now_ns();
+  const uint64_t b = now_ns();
+  EXPECT_LE(a, b);
+
+  // Granularity must be far below current_tick()'s millisecond: two
+  // samples spanning a trivial loop should differ by less than 1ms.
+  uint64_t c = now_ns();
+  while (c == now_ns())          // Wait for the clock to advance
+    ;
+  EXPECT_LT(now_ns() - c, 1000000u);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,94 @@
+// LAF Base Library
+// Copyright (c) 2022 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/utf8_decode.h"
+
+#include "base/ints.h"
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace base {
+
+size_t utf8_decode::decode_all(const std::string_view str, int* out)
+{
+  int* outBegin = out;
+  const char* p = str.data();
+  const char* end = p + str.size();
+
+  while (p < end) {
+#if defined(__SSE2__)
+    // Widen runs of ASCII 16 bytes at a time
+    while (end-p >= 16) {
+      const __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+      if (_mm_movemask_epi8(chunk) != 0)
+        break;
+      for (int i=0; i<16; ++i)
+        out[i] = uint8_t(p[i]);
+      p += 16;
+      out += 16;
+    }
+    if (p == end)
+      break;
+#endif
+
+    // Scalar decode of one code point (same logic/invalid cases as
+    // next())
+    int c = uint8_t(*p);
+    ++p;
+
+    if (c & 0b1000'0000) {
+      int n = 0;
+      int f = 0b0100'0000;
+      while (c & f) {
+        ++n;
+        f >>= 1;
+      }
+
+      if (n == 0)               // Invalid continuation byte alone
+        break;
+
+      c &= (0b0001'1111 >> (n-1));
+
+      bool valid = true;
+      while (n--) {
+        if (p == end) {         // Missing continuation bytes
+          valid = false;
+          break;
+        }
+        const int chr = uint8_t(*p);
+        if ((chr & 0b1100'0000) != 0b1000'0000) {
+          valid = false;        // Invalid continuation byte
+          break;
+        }
+        ++p;
+        c = (c << 6) | (chr & 0b0011'1111);
+      }
+      if (!valid)
+        break;
+    }
+
+    if (c == 0)                 // Embedded NUL ends the decoding
+      break;
+
+    *out++ = c;
+  }
+
+  return out - outBegin;
+}
+
+void utf8_decode::decode_all(const std::string_view str, std::vector<int>& out)
+{
+  out.resize(str.size());
+  out.resize(decode_all(str, out.data()));
+}
+
+} // namespace base
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace base {
 
@@ -27,6 +29,17 @@ namespace base {
       , m_end(str.end()) {
     }
 
+    // Decodes the whole string into a contiguous code point array in
+    // a single pass (out must have room for str.size() entries, the
+    // all-ASCII worst case). Returns the number of code points
+    // written. Stops at the first invalid sequence or embedded NUL,
+    // like next() does, so layout code can decode once and then work
+    // over the array.
+    static size_t decode_all(std::string_view str, int* out);
+
+    // Convenience variant filling a (reusable) vector.
+    static void decode_all(std::string_view str, std::vector<int>& out);
+
     iterator pos() const {
       return m_it;
     }
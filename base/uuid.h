@@ -10,6 +10,7 @@
 
 #include "base/ints.h"
 
+#include <cstddef>
 #include <cstring>
 
 // Uncomment if you want to debug the generation of the UUID, and the
@@ -29,6 +30,12 @@ namespace base {
 
     static Uuid Generate();
 
+    // Generates n UUIDs at once. On platforms where Generate() has a
+    // per-call cost (e.g. reading the system entropy source) this
+    // reads the entropy in bulk, so tagging thousands of objects
+    // doesn't pay that cost per UUID.
+    static void GenerateN(Uuid* uuids, size_t n);
+
     uint8_t operator[](int i) const { return m_data[i]; }
     bool operator==(const Uuid& b) const { return std::memcmp(m_data, b.m_data, 16) == 0; }
     bool operator!=(const Uuid& b) const { return !operator==(b); }
@@ -8,6 +8,8 @@
 
 #include "base/uuid.h"
 
+#include <vector>
+
 using namespace base;
 
 TEST(Uuid, Empty)
@@ -36,6 +38,22 @@ TEST(Uuid, Generate)
   }
 }
 
+TEST(Uuid, GenerateN)
+{
+  constexpr int N = 1000;
+  std::vector<Uuid> uuids(N);
+  Uuid::GenerateN(uuids.data(), uuids.size());
+
+  for (int i=0; i<N; ++i) {
+    // Version 4, RFC 4122 variant
+    EXPECT_EQ(0x40, uuids[i][6] & 0xf0);
+    EXPECT_EQ(0x80, uuids[i][8] & 0xc0);
+
+    for (int j=i+1; j<N; ++j)
+      ASSERT_NE(uuids[i], uuids[j]);
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -8,29 +8,67 @@
 #include "config.h"
 #endif
 
-#include "base/convert_to.h"
-#include "base/file_content.h"
+#include "base/file_handle.h"
 #include "base/uuid.h"
 
+#if LAF_BASE_TRACE_UUID
+  #include "base/convert_to.h"
+#endif
+
 #include <cstring>
+#include <mutex>
+#include <random>
 
 namespace base {
 
-Uuid Uuid::Generate()
+// Fills the buffer from a process-cached handle to the kernel CSPRNG
+// (instead of opening /proc/sys/kernel/random/uuid per UUID like we
+// did before).
+static void fill_random_bytes(uint8_t* data, const size_t size)
 {
-  Uuid uuid;
-  buffer buf = read_file_content("/proc/sys/kernel/random/uuid");
-  if (buf.size() >= 16) {
-    uuid = base::convert_to<Uuid>(std::string((const char*)buf.data()));
+  static std::mutex mutex;
+  const std::lock_guard lock(mutex);
+
+  static FileHandle urandom = open_file("/dev/urandom", "rb");
+  if (urandom &&
+      std::fread(data, 1, size, urandom.get()) == size)
+    return;
+
+  // Fallback for exotic setups without /dev/urandom
+  static std::mt19937_64 rng{ std::random_device{}() };
+  for (size_t i=0; i<size; ++i)
+    data[i] = uint8_t(rng());
+}
+
+void Uuid::GenerateN(Uuid* uuids, const size_t n)
+{
+  // Read the entropy in bulk (bounded chunks so huge batches don't
+  // need a huge temporary)
+  uint8_t chunk[16*256];
+  for (size_t i=0; i<n; ) {
+    const size_t count = (n-i < 256 ? n-i: 256);
+    fill_random_bytes(chunk, 16*count);
+
+    for (size_t j=0; j<count; ++j, ++i) {
+      uint8_t* bytes = uuids[i].bytes();
+      std::memcpy(bytes, chunk+16*j, 16);
+
+      // Random (v4) UUID with the RFC 4122 variant
+      bytes[6] = (bytes[6] & 0x0f) | 0x40;
+      bytes[8] = (bytes[8] & 0x3f) | 0x80;
 
 #if LAF_BASE_TRACE_UUID
-    if (buf[buf.size()-1] == '\n')
-      buf[buf.size()-1] = 0;
-    printf("convert_to  = \"%s\"\n"
-           "random/uuid = \"%s\"\n",
-           base::convert_to<std::string>(uuid).c_str(), buf.data());
+      printf("convert_to = \"%s\"\n",
+             base::convert_to<std::string>(uuids[i]).c_str());
 #endif
+    }
   }
+}
+
+Uuid Uuid::Generate()
+{
+  Uuid uuid;
+  GenerateN(&uuid, 1);
   return uuid;
 }
 
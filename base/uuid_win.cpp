@@ -53,4 +53,12 @@ Uuid Uuid::Generate()
   return uuid;
 }
 
+// CoCreateGuid() doesn't open any handle per call, so the batch
+// variant is just a loop.
+void Uuid::GenerateN(Uuid* uuids, const size_t n)
+{
+  for (size_t i=0; i<n; ++i)
+    uuids[i] = Generate();
+}
+
 } // namespace base
@@ -207,4 +207,82 @@ void hkey::delete_tree(const std::string& subkey)
     throw Win32Exception("Error deleting registry key");
 }
 
+void hkey::read_tree(HKEY key, const std::string& prefix, snapshot& out)
+{
+  DWORD nsubkeys = 0, maxKeyLen = 0;
+  DWORD nvalues = 0, maxNameLen = 0, maxDataLen = 0;
+  if (RegQueryInfoKeyW(key, nullptr, nullptr, nullptr,
+                       &nsubkeys, &maxKeyLen, nullptr,
+                       &nvalues, &maxNameLen, &maxDataLen,
+                       nullptr, nullptr) != ERROR_SUCCESS)
+    return;
+
+  // One pair of buffers sized for the biggest name/data of the key,
+  // reused through the whole enumeration (no per-value size query).
+  std::vector<wchar_t> name(maxNameLen+1);
+  std::vector<BYTE> data(maxDataLen+sizeof(wchar_t));
+
+  for (DWORD i=0; i<nvalues; ++i) {
+    DWORD nameLen = DWORD(name.size());
+    DWORD dataLen = maxDataLen;
+    DWORD type = 0;
+    if (RegEnumValueW(key, i, name.data(), &nameLen, nullptr,
+                      &type, data.data(), &dataLen) != ERROR_SUCCESS)
+      continue;
+
+    const std::string valueName =
+      prefix + to_utf8(std::wstring(name.data(), nameLen));
+    switch (type) {
+      case REG_SZ:
+      case REG_EXPAND_SZ:
+        // The stored data might lack the null terminator
+        data[dataLen] = data[dataLen+1] = 0;
+        out.m_strings[valueName] = to_utf8((const wchar_t*)data.data());
+        break;
+      case REG_DWORD:
+        if (dataLen >= sizeof(DWORD))
+          out.m_dwords[valueName] = *(const DWORD*)data.data();
+        break;
+    }
+  }
+
+  std::vector<wchar_t> keyName(maxKeyLen+1);
+  for (DWORD i=0; i<nsubkeys; ++i) {
+    DWORD keyLen = DWORD(keyName.size());
+    if (RegEnumKeyExW(key, i, keyName.data(), &keyLen,
+                      nullptr, nullptr, nullptr, nullptr) != ERROR_SUCCESS)
+      continue;
+
+    HKEY child = nullptr;
+    if (RegOpenKeyExW(key, keyName.data(), 0,
+                      KEY_READ, &child) != ERROR_SUCCESS)
+      continue;
+
+    read_tree(child,
+              prefix + to_utf8(std::wstring(keyName.data(), keyLen)) + "\\",
+              out);
+    RegCloseKey(child);
+  }
+}
+
+hkey::snapshot hkey::read_all(const std::string& subtree)
+{
+  snapshot result;
+  if (!m_hkey)
+    return result;
+
+  if (subtree.empty()) {
+    read_tree(m_hkey, std::string(), result);
+  }
+  else {
+    HKEY key = nullptr;
+    if (RegOpenKeyExW(m_hkey, from_utf8(subtree).c_str(), 0,
+                      KEY_READ, &key) == ERROR_SUCCESS) {
+      read_tree(key, std::string(), result);
+      RegCloseKey(key);
+    }
+  }
+  return result;
+}
+
 } // namespace base
@@ -14,6 +14,7 @@
 
 #include "base/disable_copying.h"
 
+#include <map>
 #include <string>
 #include <windows.h>
 
@@ -56,7 +57,43 @@ public:
   // keys are deleted but this hkey isn't (the root is kept).
   void delete_tree(const std::string& subkey);
 
+  // In-memory snapshot of all the values of a subtree (see
+  // read_all()). Values of children keys are addressed with their
+  // relative key path, e.g. "sub\\name". Lookups never touch the
+  // registry again and return an empty string/zero for missing
+  // values.
+  class snapshot {
+    friend class hkey;
+  public:
+    bool exists(const std::string& name) const {
+      return (m_strings.find(name) != m_strings.end() ||
+              m_dwords.find(name) != m_dwords.end());
+    }
+    std::string string(const std::string& name) const {
+      auto it = m_strings.find(name);
+      return (it != m_strings.end() ? it->second: std::string());
+    }
+    DWORD dword(const std::string& name) const {
+      auto it = m_dwords.find(name);
+      return (it != m_dwords.end() ? it->second: 0);
+    }
+
+  private:
+    std::map<std::string, std::string> m_strings;
+    std::map<std::string, DWORD> m_dwords;
+  };
+
+  // Reads every value of the given subtree ("" = this key) and of
+  // its children keys recursively with one enumeration pass
+  // (RegEnumValue over preallocated buffers) instead of one
+  // RegQueryValueEx round-trip per value, so loading dozens of
+  // configuration values costs one pass per subtree.
+  snapshot read_all(const std::string& subtree = std::string());
+
 private:
+  static void read_tree(HKEY key, const std::string& prefix,
+                        snapshot& out);
+
   HKEY m_hkey;
 
   DISABLE_COPYING(hkey);
@@ -0,0 +1,302 @@
+// LAF Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Windowed FPS/latency benchmark: renders scripted scenes (pan/zoom
+// blits, a text wall, many windows) and reports FPS, frame-time
+// percentiles and input-to-present latency, so platform backends can
+// be compared with one runnable baseline. For headless paint-pipeline
+// numbers see laf-os-benchmarks (os/benchmarks.cpp).
+//
+//   benchmark [frames-per-scene] [scene-name]
+
+#include "base/time.h"
+#include "gfx/hsv.h"
+#include "gfx/rgb.h"
+#include "os/os.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool g_quit = false;
+
+double percentile(std::vector<double> values, const double p)
+{
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  const size_t i = size_t(p * double(values.size()-1) + 0.5);
+  return values[i];
+}
+
+void report_series(const char* label, const std::vector<double>& values)
+{
+  if (values.empty())
+    return;
+  std::printf("  %s: p50=%.2f p95=%.2f p99=%.2f max=%.2f\n",
+              label,
+              percentile(values, 0.50),
+              percentile(values, 0.95),
+              percentile(values, 0.99),
+              *std::max_element(values.begin(), values.end()));
+}
+
+class Scene {
+public:
+  virtual ~Scene() { }
+  virtual const char* name() const = 0;
+  virtual void setup(os::System* system) = 0;
+  virtual void frame(int i) = 0;
+  virtual void teardown() = 0;
+};
+
+// Pans and zooms a big pre-rendered checkerboard into the window,
+// i.e. the viewport load of examples/panviewport.cpp without the user.
+class BlitScene : public Scene {
+public:
+  const char* name() const override { return "blits"; }
+
+  void setup(os::System* system) override {
+    m_window = system->makeWindow(800, 600);
+    m_window->setTitle("benchmark: blits");
+    m_window->setVisible(true);
+
+    m_sheet = system->makeSurface(1024, 1024);
+    os::SurfaceLock lock(m_sheet.get());
+    os::Paint p;
+    p.style(os::Paint::Fill);
+    for (int y=0; y<1024; y+=32) {
+      for (int x=0; x<1024; x+=32) {
+        gfx::Rgb rgb(gfx::Hsv(360.0 * ((x/32 + y/32) % 32) / 32.0, 0.7, 0.9));
+        p.color(((x ^ y) & 32) ? gfx::rgba(rgb.red(), rgb.green(), rgb.blue()):
+                                 gfx::rgba(24, 24, 24));
+        m_sheet->drawRect(gfx::Rect(x, y, 32, 32), p);
+      }
+    }
+  }
+
+  void frame(const int i) override {
+    os::Surface* surface = m_window->surface();
+    os::SurfaceLock lock(surface);
+
+    const double zoom = 1.5 + std::sin(i / 40.0);
+    const int w = int(m_sheet->width() / zoom);
+    const int h = int(m_sheet->height() / zoom);
+    const int x = int((m_sheet->width() - w) * (0.5 + 0.5*std::sin(i / 25.0)));
+    const int y = int((m_sheet->height() - h) * (0.5 + 0.5*std::cos(i / 31.0)));
+    surface->drawSurface(m_sheet.get(),
+                         gfx::Rect(x, y, w, h),
+                         surface->bounds());
+
+    m_window->invalidate();
+    m_window->swapBuffers();
+  }
+
+  void teardown() override {
+    m_sheet.reset();
+    m_window.reset();
+  }
+
+private:
+  os::WindowRef m_window;
+  os::SurfaceRef m_sheet;
+};
+
+// Fills the window with text lines each frame (the scrolling content
+// changes per frame so nothing can be cached between frames).
+class TextScene : public Scene {
+public:
+  const char* name() const override { return "text"; }
+
+  void setup(os::System* system) override {
+    m_window = system->makeWindow(800, 600);
+    m_window->setTitle("benchmark: text");
+    m_window->setVisible(true);
+  }
+
+  void frame(const int i) override {
+    os::Surface* surface = m_window->surface();
+    os::SurfaceLock lock(surface);
+
+    os::Paint p;
+    p.style(os::Paint::Fill);
+    p.color(gfx::rgba(32, 32, 32));
+    surface->drawRect(surface->bounds(), p);
+
+    p.color(gfx::rgba(255, 255, 200));
+    char buf[256];
+    for (int y=8; y<surface->height()-8; y+=16) {
+      std::snprintf(buf, sizeof(buf),
+                    "%04d The quick brown fox jumps over the lazy dog 0123456789",
+                    i + y);
+      os::draw_text(surface, nullptr, buf, gfx::Point(8, y), &p);
+    }
+
+    m_window->invalidate();
+    m_window->swapBuffers();
+  }
+
+  void teardown() override {
+    m_window.reset();
+  }
+
+private:
+  os::WindowRef m_window;
+};
+
+// Repaints several windows per frame (the multi-window cost is mostly
+// in the per-window present, not in the painting itself).
+class MultiWindowScene : public Scene {
+public:
+  const char* name() const override { return "windows"; }
+
+  void setup(os::System* system) override {
+    for (int i=0; i<4; ++i) {
+      os::WindowRef window = system->makeWindow(320, 240);
+      window->setTitle("benchmark: windows");
+      window->setVisible(true);
+      m_windows.push_back(window);
+    }
+  }
+
+  void frame(const int i) override {
+    for (size_t w=0; w<m_windows.size(); ++w) {
+      os::Window* window = m_windows[w].get();
+      os::Surface* surface = window->surface();
+      os::SurfaceLock lock(surface);
+
+      gfx::Rgb rgb(gfx::Hsv(std::fmod(4.0*i + 90.0*w, 360.0), 0.6, 0.8));
+      os::Paint p;
+      p.style(os::Paint::Fill);
+      p.color(gfx::rgba(rgb.red(), rgb.green(), rgb.blue()));
+      surface->drawRect(surface->bounds(), p);
+
+      window->invalidate();
+      window->swapBuffers();
+    }
+  }
+
+  void teardown() override {
+    m_windows.clear();
+  }
+
+private:
+  std::vector<os::WindowRef> m_windows;
+};
+
+// Drains pending events (so the windows stay responsive) and returns
+// the timestamp of the latency probe queued by run_scene(), if it was
+// delivered.
+base::tick_t pump_events(os::EventQueue* queue)
+{
+  base::tick_t probeTimestamp = 0;
+  os::Event ev;
+  while (true) {
+    queue->getEvent(ev, 0.0);
+    switch (ev.type()) {
+      case os::Event::None:
+        return probeTimestamp;
+      case os::Event::Callback:
+        probeTimestamp = ev.timestamp();
+        break;
+      case os::Event::CloseApp:
+      case os::Event::CloseWindow:
+        g_quit = true;
+        break;
+      case os::Event::KeyDown:
+        if (ev.scancode() == os::kKeyEsc)
+          g_quit = true;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void run_scene(os::System* system, Scene* scene, const int frames)
+{
+  os::EventQueue* queue = system->eventQueue();
+
+  scene->setup(system);
+  os::EventQueue::resetStats();
+
+  std::vector<double> frameMs;
+  std::vector<double> latencyMs;
+  frameMs.reserve(frames);
+  latencyMs.reserve(frames);
+
+  const int warmup = 30;
+  for (int i=0; i<warmup+frames && !g_quit; ++i) {
+    // Latency probe: an event queued like any input event; the
+    // input-to-present latency is the time from its creation to the
+    // moment the frame that saw it was presented.
+    os::Event probe;
+    probe.setType(os::Event::Callback);
+    queue->queueEvent(probe);
+
+    const base::tick_t probeTimestamp = pump_events(queue);
+
+    const uint64_t t0 = base::now_ns();
+    scene->frame(i);
+    const uint64_t t1 = base::now_ns();
+
+    if (i < warmup)
+      continue;
+    frameMs.push_back((t1 - t0) / 1000000.0);
+    if (probeTimestamp)
+      latencyMs.push_back(double(base::current_tick() - probeTimestamp));
+  }
+
+  const os::EventQueue::Stats stats = os::EventQueue::stats();
+  scene->teardown();
+
+  double totalMs = 0.0;
+  for (double ms : frameMs)
+    totalMs += ms;
+
+  std::printf("== %s ==\n", scene->name());
+  if (!frameMs.empty() && totalMs > 0.0)
+    std::printf("  frames: %d  fps: %.1f\n",
+                int(frameMs.size()),
+                1000.0 * frameMs.size() / totalMs);
+  report_series("frame time (ms)", frameMs);
+  report_series("input-to-present (ms)", latencyMs);
+  std::printf("  queue dwell (ms): p50=%.2f p99=%.2f max=%.2f (%d events)\n",
+              stats.dwellP50, stats.dwellP99, stats.dwellMax, stats.events);
+}
+
+} // anonymous namespace
+
+int app_main(int argc, char* argv[])
+{
+  const int frames = (argc > 1 ? std::atoi(argv[1]): 300);
+  const char* only = (argc > 2 ? argv[2]: nullptr);
+
+  os::SystemRef system = os::make_system();
+  system->setAppMode(os::AppMode::GUI);
+  system->finishLaunching();
+  system->activateApp();
+
+  BlitScene blits;
+  TextScene text;
+  MultiWindowScene windows;
+  Scene* scenes[] = { &blits, &text, &windows };
+
+  for (Scene* scene : scenes) {
+    if (only && std::string(only) != scene->name())
+      continue;
+    run_scene(system.get(), scene, frames);
+    if (g_quit)
+      break;
+  }
+
+  return 0;
+}
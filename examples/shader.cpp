@@ -14,6 +14,7 @@
   #error You need Skia with GPU support to compile this example
 #endif
 
+#include "base/thread_pool.h"
 #include "base/time.h"
 #include "os/skia/skia_surface.h"
 
@@ -126,6 +127,12 @@ int app_main(int argc, char* argv[])
   os::SystemRef system = os::make_system();
   system->setAppMode(os::AppMode::GUI);
 
+  // Persist the GPU-compiled shader between runs so only the first
+  // one pays the driver compile
+  base::thread_pool pool(1);
+  system->setShaderCacheDir("_shader_cache");
+  system->warmShaderCache(pool);
+
   ShaderWindow window(system.get());
 
   system->handleWindowResize = [&window](os::Window* win){
@@ -115,6 +115,7 @@ namespace ft {
       // Load new glyph
       m_glyph = m_face.cache().loadGlyph(m_face, glyphIndex, m_face.antialias());
       if (m_glyph) {
+        m_glyph->glyph_index = glyphIndex;
         m_glyph->bitmap = &FT_BitmapGlyph(m_glyph->ft_glyph)->bitmap;
         m_glyph->x = m_x
           + m_glyph->bearingX;
@@ -147,6 +148,20 @@ namespace ft {
     double m_x, m_y;
   };
 
+  // Metrics-only measurement: sums the shaped advances (HarfBuzz
+  // positions, which don't require loading glyph images) instead of
+  // going through ForEachGlyph, which rasterizes every glyph just to
+  // read its advance. Layout passes that measure hundreds of strings
+  // per frame never touch glyph bitmaps this way.
+  template<typename FaceFT>
+  int calc_text_width(FaceFT& face, const std::string& str) {
+    HBShaper<FaceFT> shaper(face, str);
+    double x = 0.0, y = 0.0;
+    while (shaper.next())
+      shaper.glyphAdvanceXY(nullptr, x, y);
+    return int(x);
+  }
+
   template<typename FaceFT>
   gfx::Rect calc_text_bounds(FaceFT& face, const std::string& str) {
     gfx::Rect bounds(0, 0, 0, 0);
@@ -34,16 +34,29 @@ namespace ft {
   public:
     typedef ft::Glyph Glyph;
 
-    FaceFT(FT_Face face) : m_face(face) {
+    FaceFT(FT_Face face)
+      : m_face(face)
+      , m_ftSize(nullptr) {
     }
 
     ~FaceFT() {
+      if (m_ftSize)
+        FT_Done_Size(m_ftSize);
       if (m_face)
         FT_Done_Face(m_face);
     }
 
-    operator FT_Face() { return m_face; }
-    FT_Face operator->() { return m_face; }
+    operator FT_Face() { activateSize(); return m_face; }
+    FT_Face operator->() { activateSize(); return m_face; }
+
+    // Activates our own FT_Size object: the FT_Face can be shared
+    // between several FaceFT wrappers at different sizes (see
+    // ft::Lib::open()), so every access to size-dependent state must
+    // go through this (the FT_Face conversions above already do it).
+    void activateSize() const {
+      if (m_ftSize)
+        FT_Activate_Size(m_ftSize);
+    }
 
     bool isValid() const {
       return (m_face != nullptr);
@@ -59,11 +72,15 @@ namespace ft {
     }
 
     void setSize(int size) {
+      if (!m_ftSize)
+        FT_New_Size(m_face, &m_ftSize);
+      activateSize();
       FT_Set_Pixel_Sizes(m_face, size, size);
       m_cache.invalidate();
     }
 
     double height() const {
+      activateSize();
       FT_Size_Metrics* metrics = &m_face->size->metrics;
       double em_size = 1.0 * m_face->units_per_EM;
       double y_scale = metrics->y_ppem / em_size;
@@ -71,6 +88,7 @@ namespace ft {
     }
 
     double ascender() const {
+      activateSize();
       FT_Size_Metrics* metrics = &m_face->size->metrics;
       double em_size = 1.0 * m_face->units_per_EM;
       double y_scale = metrics->y_ppem / em_size;
@@ -78,6 +96,7 @@ namespace ft {
     }
 
     double descender() const {
+      activateSize();
       FT_Size_Metrics* metrics = &m_face->size->metrics;
       double em_size = 1.0 * m_face->units_per_EM;
       double y_scale = metrics->y_ppem / em_size;
@@ -96,6 +115,7 @@ namespace ft {
 
   protected:
     FT_Face m_face;
+    FT_Size m_ftSize;           // Our size on the (shared) FT_Face
     bool m_antialias;
     Cache m_cache;
 
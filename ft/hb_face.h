@@ -21,6 +21,10 @@ namespace ft {
   class HBFace : public FaceFT {
   public:
     HBFace(FT_Face face) : FaceFT(face) {
+      // The hb_font_t callbacks read the tables through the
+      // (possibly shared, see ft::Lib::open()) FT_Face, so the
+      // parsed table data is not duplicated per size; only the
+      // cheap per-size state lives here.
       m_font = (face ? hb_ft_font_create((FT_Face)face, nullptr): nullptr);
     }
 
@@ -28,7 +32,19 @@ namespace ft {
       if (m_font) hb_font_destroy(m_font);
     }
 
-    hb_font_t* font() const { return m_font; }
+    void setSize(int size) {
+      FaceFT::setSize(size);
+      // Flush the hb_font_t caches (e.g. cached advances) that
+      // depend on the FT_Size
+      if (m_font)
+        hb_ft_font_changed(m_font);
+    }
+
+    hb_font_t* font() const {
+      // The callbacks read the active FT_Size of the shared FT_Face
+      this->activateSize();
+      return m_font;
+    }
 
   private:
     hb_font_t* m_font;
@@ -16,6 +16,28 @@
 
 namespace ft {
 
+  // One lazily-created hb_buffer_t per thread, reset and reused by
+  // every HBShaper of the thread: creating/destroying a buffer per
+  // shaped string is measurable overhead for the thousands of short
+  // labels shaped per frame.
+  class HBBuffer {
+  public:
+    ~HBBuffer() {
+      if (m_buf)
+        hb_buffer_destroy(m_buf);
+    }
+
+    hb_buffer_t* get() {
+      if (!m_buf)
+        m_buf = hb_buffer_create();
+      hb_buffer_reset(m_buf);
+      return m_buf;
+    }
+
+  private:
+    hb_buffer_t* m_buf = nullptr;
+  };
+
   template<typename HBFace>
   class HBShaper {
   public:
@@ -26,10 +48,18 @@ namespace ft {
       if (decode.is_end())
         return;
 
-      hb_buffer_t* buf = hb_buffer_create();
-      hb_buffer_t* chrBuf = hb_buffer_create();
+      static thread_local HBBuffer reusableBuf;
+      static thread_local HBBuffer reusableChrBuf;
+      hb_buffer_t* buf = reusableBuf.get();
+      hb_buffer_t* chrBuf = reusableChrBuf.get();
       hb_script_t script = HB_SCRIPT_UNKNOWN;
 
+      // One glyph per UTF-8 code point is the common case, so a
+      // single upfront reservation avoids regrowing the arrays as
+      // addBuffer() appends each run.
+      m_glyphInfo.reserve(str.size());
+      m_glyphPos.reserve(str.size());
+
       const auto begin = str.begin();
       while (true) {
         const auto pos = decode.pos();
@@ -53,9 +83,6 @@ namespace ft {
         hb_buffer_add(buf, chr, pos - begin);
       }
       addBuffer(buf, script);
-
-      hb_buffer_destroy(buf);
-      hb_buffer_destroy(chrBuf);
     }
 
     int next() {
@@ -22,12 +22,23 @@ Lib::Lib()
 
 Lib::~Lib()
 {
+  for (auto& it : m_faces)
+    FT_Done_Face(it.second);
+  m_faces.clear();
+
   if (m_ft)
     FT_Done_FreeType(m_ft);
 }
 
-FT_Face Lib::open(const std::string& filename)
+FT_Face Lib::open(const std::string& filename, const int index)
 {
+  auto it = m_faces.find(std::make_pair(filename, index));
+  if (it != m_faces.end()) {
+    // One new reference for the caller (undone by its FT_Done_Face())
+    FT_Reference_Face(it->second);
+    return it->second;
+  }
+
   FT_Stream stream = ft::open_stream(filename);
   FT_Open_Args args;
   memset(&args, 0, sizeof(args));
@@ -37,9 +48,15 @@ FT_Face Lib::open(const std::string& filename)
   LOG(VERBOSE, "FT: Loading font '%s'\n", filename.c_str());
 
   FT_Face face = nullptr;
-  const FT_Error err = FT_Open_Face(m_ft, &args, 0, &face);
-  if (!err)
+  const FT_Error err = FT_Open_Face(m_ft, &args, index, &face);
+  if (!err) {
     FT_Select_Charmap(face, FT_ENCODING_UNICODE);
+
+    // The caller keeps the FT_Open_Face() reference, this extra one
+    // belongs to the cache (released in ~Lib())
+    FT_Reference_Face(face);
+    m_faces[std::make_pair(filename, index)] = face;
+  }
   return face;
 }
 
@@ -11,7 +11,9 @@
 #include "base/disable_copying.h"
 #include "ft/freetype_headers.h"
 
+#include <map>
 #include <string>
+#include <utility>
 
 namespace ft {
 
@@ -22,10 +24,19 @@ namespace ft {
 
     operator FT_Library() { return m_ft; }
 
-    FT_Face open(const std::string& filename);
+    // Opens (or returns the cached) FT_Face of the given file, so
+    // opening the same font at several sizes loads and parses the
+    // file only once. Faces are cached by (filename, index) and
+    // shared through FreeType's reference counting: each caller
+    // receives its own reference and must FT_Done_Face() it as
+    // usual, the cache keeps an extra reference until the Lib is
+    // destroyed. Callers requesting different sizes on the same face
+    // must use their own FT_Size object (FaceFT does it).
+    FT_Face open(const std::string& filename, const int index = 0);
 
   private:
     FT_Library m_ft;
+    std::map<std::pair<std::string, int>, FT_Face> m_faces;
 
     DISABLE_COPYING(Lib);
   };
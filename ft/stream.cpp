@@ -7,36 +7,26 @@
 
 #include "ft/stream.h"
 
-#include "base/file_handle.h"
 #include "base/debug.h"
+#include "base/file_content.h"
 
 #include <ft2build.h>
 
-#define STREAM_FILE(stream) ((FILE*)(stream)->descriptor.pointer)
+#define STREAM_CONTENT(stream) ((base::mapped_file*)(stream)->descriptor.pointer)
 
 namespace ft {
 
+// The whole font file is exposed to FreeType as a single memory
+// block (FT_New_Memory_Face semantics): the read-callback stream
+// used before caused thousands of small seek+read calls at face-open
+// and per-glyph load on big CJK fonts, while with the mapping the
+// glyph table access goes straight to the page cache.
 static void ft_stream_close(FT_Stream stream)
 {
-  fclose(STREAM_FILE(stream));
+  delete STREAM_CONTENT(stream);
   free(stream);
 }
 
-static unsigned long ft_stream_io(FT_Stream stream,
-                                  unsigned long offset,
-                                  unsigned char* buffer,
-                                  unsigned long count)
-{
-  if (!count && offset > stream->size)
-    return 1;
-
-  FILE* file = STREAM_FILE(stream);
-  if (stream->pos != offset)
-    fseek(file, (long)offset, SEEK_SET);
-
-  return (unsigned long)fread(buffer, 1, count, file);
-}
-
 FT_Stream open_stream(const std::string& utf8Filename)
 {
   FT_Stream stream = nullptr;
@@ -47,27 +37,19 @@ FT_Stream open_stream(const std::string& utf8Filename)
 
   TRACE("FT: Loading font %s... ", utf8Filename.c_str());
 
-  FILE* file = base::open_file_raw(utf8Filename, "rb");
-  if (!file) {
-    free(stream);
-    TRACE("FAIL\n");
-    return nullptr;
-  }
-
-  fseek(file, 0, SEEK_END);
-  stream->size = (unsigned long)ftell(file);
-  if (!stream->size) {
-    fclose(file);
+  auto content = new base::mapped_file(base::map_file_content(utf8Filename));
+  if (content->empty()) {
+    delete content;
     free(stream);
     TRACE("FAIL\n");
     return nullptr;
   }
-  fseek(file, 0, SEEK_SET);
 
-  stream->descriptor.pointer = file;
-  stream->base = nullptr;
+  stream->descriptor.pointer = content;
+  stream->base = (unsigned char*)content->data();
+  stream->size = (unsigned long)content->size();
   stream->pos = 0;
-  stream->read = ft_stream_io;
+  stream->read = nullptr;       // Memory-based stream
   stream->close = ft_stream_close;
 
   TRACE("OK\n");
@@ -0,0 +1,175 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Microbenchmarks for the laf-gfx hot paths (run the
+// laf-gfx-benchmarks target, optionally passing a name substring to
+// filter). Same self-contained harness as base/benchmarks.cpp: each
+// benchmark receives the number of iterations to run and the harness
+// scales the count until the run is long enough to time reliably.
+
+#include "gfx/hsv.h"
+#include "gfx/rgb.h"
+
+#if LAF_WITH_REGION
+  #include "base/task.h"
+  #include "gfx/packing_rects.h"
+  #include "gfx/region.h"
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Benchmark {
+  std::string name;
+  std::function<void(size_t)> func;
+};
+
+std::vector<Benchmark>& benchmarks()
+{
+  static std::vector<Benchmark> list;
+  return list;
+}
+
+void add_benchmark(const std::string& name,
+                   std::function<void(size_t)> func)
+{
+  benchmarks().push_back({ name, std::move(func) });
+}
+
+double time_seconds(const std::function<void(size_t)>& func,
+                    const size_t iters)
+{
+  const auto start = std::chrono::steady_clock::now();
+  func(iters);
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void run_benchmark(const Benchmark& bench)
+{
+  // Scale the iteration count until the run takes at least ~200ms
+  size_t iters = 1;
+  double secs = time_seconds(bench.func, iters);
+  while (secs < 0.2 && iters < (size_t(1) << 40)) {
+    iters *= (secs < 0.01 ? 16: 2);
+    secs = time_seconds(bench.func, iters);
+  }
+
+  std::printf("%-32s %12.1f ns/iter\n",
+              bench.name.c_str(), 1e9 * secs / double(iters));
+}
+
+// Deterministic xorshift so every run (and every region backend)
+// measures exactly the same workload.
+uint32_t next_random(uint32_t& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+void register_benchmarks()
+{
+#if LAF_WITH_REGION
+  // Damage-region accumulation: union of 10k small dirty rects, the
+  // pattern generated by widget invalidation during a busy frame.
+  {
+    std::vector<gfx::Rect> dirty;
+    uint32_t seed = 0x12345678;
+    for (int i=0; i<10000; ++i) {
+      dirty.push_back(gfx::Rect(int(next_random(seed) % 4096),
+                                int(next_random(seed) % 4096),
+                                1 + int(next_random(seed) % 64),
+                                1 + int(next_random(seed) % 64)));
+    }
+    add_benchmark("Region/union_10k_rects", [dirty](size_t n) {
+      for (size_t i=0; i<n; ++i) {
+        gfx::Region damage;
+        for (const gfx::Rect& rc : dirty)
+          damage |= gfx::Region(rc);
+      }
+    });
+    add_benchmark("Region/intersect_clip", [dirty](size_t n) {
+      gfx::Region damage;
+      for (const gfx::Rect& rc : dirty)
+        damage |= gfx::Region(rc);
+      const gfx::Region clip(gfx::Rect(1024, 1024, 2048, 2048));
+      for (size_t i=0; i<n; ++i) {
+        gfx::Region result;
+        result.createIntersection(damage, clip);
+      }
+    });
+  }
+
+  // Texture atlas packing: 5k sprite-sized rectangles with both
+  // strategies (bestFit() grows the texture until everything fits).
+  {
+    std::vector<gfx::Size> sprites;
+    uint32_t seed = 0x87654321;
+    for (int i=0; i<5000; ++i) {
+      sprites.push_back(gfx::Size(8 + int(next_random(seed) % 56),
+                                  8 + int(next_random(seed) % 56)));
+    }
+    auto pack = [sprites](const gfx::PackingRects::Strategy strategy) {
+      gfx::PackingRects pr(0, 0, strategy);
+      for (const gfx::Size& sz : sprites)
+        pr.add(sz);
+      base::task_token token;
+      pr.bestFit(token);
+    };
+    add_benchmark("PackingRects/bestFit_skyline", [pack](size_t n) {
+      for (size_t i=0; i<n; ++i)
+        pack(gfx::PackingRects::Strategy::Skyline);
+    });
+    add_benchmark("PackingRects/bestFit_region", [pack](size_t n) {
+      for (size_t i=0; i<n; ++i)
+        pack(gfx::PackingRects::Strategy::Region);
+    });
+  }
+#endif // LAF_WITH_REGION
+
+  // Full-buffer color conversion: round-trip a 256K-pixel buffer
+  // through Rgb -> Hsv -> Rgb.
+  {
+    std::vector<gfx::Rgb> pixels;
+    uint32_t seed = 0xdeadbeef;
+    for (int i=0; i<256*1024; ++i) {
+      const uint32_t v = next_random(seed);
+      pixels.push_back(gfx::Rgb(v & 0xff, (v >> 8) & 0xff, (v >> 16) & 0xff));
+    }
+    add_benchmark("Hsv/round_trip_256k", [pixels](size_t n) {
+      int keep = 0;
+      for (size_t i=0; i<n; ++i) {
+        for (const gfx::Rgb& rgb : pixels)
+          keep += gfx::Rgb(gfx::Hsv(rgb)).red();
+      }
+      // Keep the result observable so the loop cannot be elided
+      if (keep == -1)
+        std::printf("\n");
+    });
+  }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  const std::string filter = (argc > 1 ? argv[1]: "");
+
+  register_benchmarks();
+  for (const Benchmark& bench : benchmarks()) {
+    if (filter.empty() ||
+        bench.name.find(filter) != std::string::npos)
+      run_benchmark(bench);
+  }
+  return 0;
+}
@@ -18,45 +18,45 @@ template<typename T>
 class BorderT
 {
 public:
-  BorderT() :
+  constexpr BorderT() :
     m_left(0),
     m_top(0),
     m_right(0),
     m_bottom(0) {
   }
 
-  BorderT(const T& left, const T& top, const T& right, const T& bottom) :
+  constexpr BorderT(const T& left, const T& top, const T& right, const T& bottom) :
     m_left(left),
     m_top(top),
     m_right(right),
     m_bottom(bottom) {
   }
 
-  explicit BorderT(const T& allSides) :
+  constexpr explicit BorderT(const T& allSides) :
     m_left(allSides),
     m_top(allSides),
     m_right(allSides),
     m_bottom(allSides) {
   }
 
-  T left() const { return m_left; };
-  T top() const { return m_top; };
-  T right() const { return m_right; };
-  T bottom() const { return m_bottom; };
+  constexpr T left() const { return m_left; };
+  constexpr T top() const { return m_top; };
+  constexpr T right() const { return m_right; };
+  constexpr T bottom() const { return m_bottom; };
 
-  T width() const { return m_left + m_right; };
-  T height() const { return m_top + m_bottom; };
+  constexpr T width() const { return m_left + m_right; };
+  constexpr T height() const { return m_top + m_bottom; };
 
-  void left(const T& left) { m_left = left; }
-  void top(const T& top) { m_top = top; }
-  void right(const T& right) { m_right = right; }
-  void bottom(const T& bottom) { m_bottom = bottom; }
+  constexpr void left(const T& left) { m_left = left; }
+  constexpr void top(const T& top) { m_top = top; }
+  constexpr void right(const T& right) { m_right = right; }
+  constexpr void bottom(const T& bottom) { m_bottom = bottom; }
 
-  SizeT<T> size() const {
+  constexpr SizeT<T> size() const {
     return SizeT<T>(m_left + m_right, m_top + m_bottom);
   }
 
-  const BorderT& operator+=(const BorderT& br) {
+  constexpr const BorderT& operator+=(const BorderT& br) {
     m_left += br.m_left;
     m_top += br.m_top;
     m_right += br.m_right;
@@ -64,7 +64,7 @@ public:
     return *this;
   }
 
-  const BorderT& operator-=(const BorderT& br) {
+  constexpr const BorderT& operator-=(const BorderT& br) {
     m_left -= br.m_left;
     m_top -= br.m_top;
     m_right -= br.m_right;
@@ -72,7 +72,7 @@ public:
     return *this;
   }
 
-  const BorderT& operator*=(const BorderT& br) {
+  constexpr const BorderT& operator*=(const BorderT& br) {
     m_left *= br.m_left;
     m_top *= br.m_top;
     m_right *= br.m_right;
@@ -80,7 +80,7 @@ public:
     return *this;
   }
 
-  const BorderT& operator/=(const BorderT& br) {
+  constexpr const BorderT& operator/=(const BorderT& br) {
     m_left /= br.m_left;
     m_top /= br.m_top;
     m_right /= br.m_right;
@@ -88,7 +88,7 @@ public:
     return *this;
   }
 
-  const BorderT& operator+=(const T& value) {
+  constexpr const BorderT& operator+=(const T& value) {
     m_left += value;
     m_top += value;
     m_right += value;
@@ -96,7 +96,7 @@ public:
     return *this;
   }
 
-  const BorderT& operator-=(const T& value) {
+  constexpr const BorderT& operator-=(const T& value) {
     m_left -= value;
     m_top -= value;
     m_right -= value;
@@ -104,7 +104,7 @@ public:
     return *this;
   }
 
-  const BorderT& operator*=(const T& value) {
+  constexpr const BorderT& operator*=(const T& value) {
     m_left *= value;
     m_top *= value;
     m_right *= value;
@@ -112,7 +112,7 @@ public:
     return *this;
   }
 
-  const BorderT& operator/=(const T& value) {
+  constexpr const BorderT& operator/=(const T& value) {
     m_left /= value;
     m_top /= value;
     m_right /= value;
@@ -120,73 +120,73 @@ public:
     return *this;
   }
 
-  BorderT operator+(const BorderT& br) const {
+  constexpr BorderT operator+(const BorderT& br) const {
     return BorderT(m_left + br.left(),
                    m_top + br.top(),
                    m_right + br.right(),
                    m_bottom + br.bottom());
   }
 
-  BorderT operator-(const BorderT& br) const {
+  constexpr BorderT operator-(const BorderT& br) const {
     return BorderT(m_left - br.left(),
                    m_top - br.top(),
                    m_right - br.right(),
                    m_bottom - br.bottom());
   }
 
-  BorderT operator*(const BorderT& br) const {
+  constexpr BorderT operator*(const BorderT& br) const {
     return BorderT(m_left * br.left(),
                    m_top * br.top(),
                    m_right * br.right(),
                    m_bottom * br.bottom());
   }
 
-  BorderT operator/(const BorderT& br) const {
+  constexpr BorderT operator/(const BorderT& br) const {
     return BorderT(m_left / br.left(),
                    m_top / br.top(),
                    m_right / br.right(),
                    m_bottom / br.bottom());
   }
 
-  BorderT operator+(const T& value) const {
+  constexpr BorderT operator+(const T& value) const {
     return BorderT(m_left + value,
                    m_top + value,
                    m_right + value,
                    m_bottom + value);
   }
 
-  BorderT operator-(const T& value) const {
+  constexpr BorderT operator-(const T& value) const {
     return BorderT(m_left - value,
                    m_top - value,
                    m_right - value,
                    m_bottom - value);
   }
 
-  BorderT operator*(const T& value) const {
+  constexpr BorderT operator*(const T& value) const {
     return BorderT(m_left * value,
                    m_top * value,
                    m_right * value,
                    m_bottom * value);
   }
 
-  BorderT operator/(const T& value) const {
+  constexpr BorderT operator/(const T& value) const {
     return BorderT(m_left / value,
                    m_top / value,
                    m_right / value,
                    m_bottom / value);
   }
 
-  BorderT operator-() const {
+  constexpr BorderT operator-() const {
     return BorderT(-m_left, -m_top, -m_right, -m_bottom);
   }
 
-  bool operator==(const BorderT& br) const {
+  constexpr bool operator==(const BorderT& br) const {
     return
       m_left == br.m_left && m_top == br.m_top &&
       m_right == br.m_right && m_bottom == br.m_bottom;
   }
 
-  bool operator!=(const BorderT& br) const {
+  constexpr bool operator!=(const BorderT& br) const {
     return
       m_left != br.m_left || m_top != br.m_top ||
       m_right != br.m_right || m_bottom != br.m_bottom;
@@ -13,6 +13,10 @@
 #include "gfx/rect.h"
 #include "gfx/size.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 namespace gfx {
 
   template<typename T>
@@ -131,6 +135,51 @@ namespace gfx {
 
   };
 
+  // Clips a whole batch of blits against the same available areas
+  // (e.g. tilemap rendering, where thousands of independent clips
+  // feed Surface::drawSurfaces()). Equivalent to calling clip() on
+  // each element, but written as branchless min/max so the compiler
+  // can vectorize the loop. Visible clips are compacted to the front
+  // of the array; returns how many there are.
+  template<typename T>
+  std::size_t clip_all(
+    ClipT<T>* clips, const std::size_t n,
+    const T avail_dst_w, const T avail_dst_h,
+    const T avail_src_w, const T avail_src_h) {
+    std::size_t out = 0;
+    for (std::size_t i=0; i<n; ++i) {
+      ClipT<T> c = clips[i];
+
+      // Cuts on each side, combined for src and dst (shifting x and
+      // shrinking w by the same amount keeps x+w constant, so the
+      // four cuts are independent and can be applied in one step).
+      const T lc = std::max(T(0), std::max(-c.src.x, -c.dst.x));
+      const T tc = std::max(T(0), std::max(-c.src.y, -c.dst.y));
+      const T rc = std::max(T(0), std::max(c.src.x + c.size.w - avail_src_w,
+                                           c.dst.x + c.size.w - avail_dst_w));
+      const T bc = std::max(T(0), std::max(c.src.y + c.size.h - avail_src_h,
+                                           c.dst.y + c.size.h - avail_dst_h));
+      c.src.x += lc; c.dst.x += lc; c.size.w -= lc + rc;
+      c.src.y += tc; c.dst.y += tc; c.size.h -= tc + bc;
+
+      clips[out] = c;
+      out += (c.size.w > T(0) && c.size.h > T(0) ? 1: 0);
+    }
+    return out;
+  }
+
+  // Convenience overload that drops the invisible clips from the
+  // vector, leaving it ready for Surface::drawSurfaces().
+  template<typename T>
+  void clip_all(
+    std::vector<ClipT<T>>& clips,
+    const T avail_dst_w, const T avail_dst_h,
+    const T avail_src_w, const T avail_src_h) {
+    clips.resize(clip_all(clips.data(), clips.size(),
+                          avail_dst_w, avail_dst_h,
+                          avail_src_w, avail_src_h));
+  }
+
   typedef ClipT<int> Clip;
   typedef ClipT<double> ClipF;
 
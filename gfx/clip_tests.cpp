@@ -97,6 +97,41 @@ TEST(ScaledClip, Zoom)
   EXPECT_EQ(Clip(0, 2, 2, 0, 3, 2), area);
 }
 
+TEST(ClipAll, MatchesClip)
+{
+  // clip_all() must agree element by element with clip() over a grid
+  // of positions around every edge.
+  std::vector<Clip> batch;
+  std::vector<Clip> expected;
+  for (int dx=-8; dx<=8; dx+=3)
+    for (int dy=-8; dy<=8; dy+=3)
+      for (int sx=-4; sx<=4; sx+=2)
+        for (int sy=-4; sy<=4; sy+=2)
+          batch.push_back(Clip(dx, dy, sx, sy, 7, 5));
+
+  for (const Clip& c : batch) {
+    Clip tmp = c;
+    if (tmp.clip(10, 12, 9, 6))
+      expected.push_back(tmp);
+  }
+
+  clip_all(batch, 10, 12, 9, 6);
+  ASSERT_EQ(expected.size(), batch.size());
+  for (size_t i=0; i<batch.size(); ++i)
+    EXPECT_EQ(expected[i], batch[i]);
+}
+
+TEST(ClipAll, AllRejected)
+{
+  Clip clips[] = {
+    Clip(100, 0, 0, 0, 8, 8),   // dst outside on the right
+    Clip(0, 0, 100, 0, 8, 8),   // src outside on the right
+    Clip(-8, 0, 0, 0, 8, 8),    // dst outside on the left
+    Clip(0, 0, 0, 0, 0, 8),     // empty
+  };
+  EXPECT_EQ(0, clip_all(clips, 4, 32, 32, 32, 32));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
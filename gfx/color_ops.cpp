@@ -0,0 +1,163 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gfx/color_ops.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace gfx {
+
+// Integer fixed-point RGB -> HSV (the classic 8-bit formulation:
+// hue sextants of ~43 units).
+static inline uint32_t rgb_to_hsv_pixel(const uint32_t px)
+{
+  const int r = px & 0xff;
+  const int g = (px >> 8) & 0xff;
+  const int b = (px >> 16) & 0xff;
+  const int M = std::max(r, std::max(g, b));
+  const int m = std::min(r, std::min(g, b));
+  const int c = M - m;
+
+  int h, s;
+  if (c == 0) {
+    h = s = 0; // Undefined hue because max == min
+  }
+  else {
+    if (M == r)
+      h = (256 + (43*(g - b) + (g >= b ? c/2: -c/2)) / c) & 0xff;
+    else if (M == g)
+      h = 85 + (43*(b - r) + (b >= r ? c/2: -c/2)) / c;
+    else
+      h = 171 + (43*(r - g) + (r >= g ? c/2: -c/2)) / c;
+    s = (255*c + M/2) / M;
+  }
+
+  return (px & 0xff000000) | (uint32_t(M) << 16) | (uint32_t(s) << 8) | uint32_t(h);
+}
+
+// Integer fixed-point HSV -> RGB
+static inline uint32_t hsv_to_rgb_pixel(const uint32_t px)
+{
+  const int h = px & 0xff;
+  const int s = (px >> 8) & 0xff;
+  const int v = (px >> 16) & 0xff;
+
+  int r, g, b;
+  if (s == 0) {
+    r = g = b = v;
+  }
+  else {
+    const int region = (h*6) >> 8;          // Sextant, 0..5
+    const int rem = (h*6) - (region << 8);  // Position inside it, 0..255
+    const int p = (v*(255 - s) + 127) / 255;
+    const int q = (v*(255 - (s*rem + 127)/255) + 127) / 255;
+    const int t = (v*(255 - (s*(255 - rem) + 127)/255) + 127) / 255;
+    switch (region) {
+      case 0:  r = v; g = t; b = p; break;
+      case 1:  r = q; g = v; b = p; break;
+      case 2:  r = p; g = v; b = t; break;
+      case 3:  r = p; g = q; b = v; break;
+      case 4:  r = t; g = p; b = v; break;
+      default: r = v; g = p; b = q; break;
+    }
+  }
+
+  return (px & 0xff000000) | (uint32_t(b) << 16) | (uint32_t(g) << 8) | uint32_t(r);
+}
+
+#if defined(__SSE2__)
+
+// Float RGB -> HSV for 4 pixels at a time. Same representation as the
+// fixed-point kernel (components can differ by 1 unit from rounding).
+static inline __m128i rgb_to_hsv_4px(const __m128i px)
+{
+  const __m128i byteMask = _mm_set1_epi32(0xff);
+  const __m128i alpha = _mm_and_si128(px, _mm_set1_epi32(0xff000000));
+
+  const __m128 r = _mm_cvtepi32_ps(_mm_and_si128(px, byteMask));
+  const __m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 8), byteMask));
+  const __m128 b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 16), byteMask));
+
+  const __m128 maxc = _mm_max_ps(r, _mm_max_ps(g, b));
+  const __m128 minc = _mm_min_ps(r, _mm_min_ps(g, b));
+  const __m128 c = _mm_sub_ps(maxc, minc);
+  const __m128 gray = _mm_cmpeq_ps(c, _mm_setzero_ps());
+
+  // Saturation: 255*c/max (division by zero is masked out with
+  // "gray" below)
+  const __m128 s = _mm_div_ps(_mm_mul_ps(c, _mm_set1_ps(255.0f)), maxc);
+
+  // Hue: pick the sextant formula of the maximum component (with
+  // red > green > blue priority on ties, like the scalar version)
+  const __m128 invc = _mm_div_ps(_mm_set1_ps(1.0f), c);
+  const __m128 maskR = _mm_cmpeq_ps(maxc, r);
+  const __m128 maskG = _mm_andnot_ps(maskR, _mm_cmpeq_ps(maxc, g));
+  const __m128 maskB = _mm_andnot_ps(_mm_or_ps(maskR, maskG),
+                                     _mm_cmpeq_ps(maxc, b));
+
+  __m128 hR = _mm_mul_ps(_mm_sub_ps(g, b), invc);
+  hR = _mm_add_ps(hR, _mm_and_ps(_mm_cmplt_ps(hR, _mm_setzero_ps()),
+                                 _mm_set1_ps(6.0f)));
+  const __m128 hG = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(b, r), invc),
+                               _mm_set1_ps(2.0f));
+  const __m128 hB = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(r, g), invc),
+                               _mm_set1_ps(4.0f));
+
+  __m128 h = _mm_or_ps(_mm_or_ps(_mm_and_ps(maskR, hR),
+                                 _mm_and_ps(maskG, hG)),
+                       _mm_and_ps(maskB, hB));
+  h = _mm_mul_ps(h, _mm_set1_ps(256.0f / 6.0f));
+
+  // Gray pixels have hue=0, saturation=0
+  h = _mm_andnot_ps(gray, h);
+  const __m128 s2 = _mm_andnot_ps(gray, s);
+
+  __m128i hi = _mm_cvtps_epi32(h);
+  // h' is in [0, 6) but rounding can still push the byte to 256
+  hi = _mm_and_si128(hi, byteMask);
+  const __m128i si = _mm_cvtps_epi32(s2);
+  const __m128i vi = _mm_cvtps_epi32(maxc);
+
+  return _mm_or_si128(alpha,
+         _mm_or_si128(_mm_slli_epi32(vi, 16),
+         _mm_or_si128(_mm_slli_epi32(si, 8), hi)));
+}
+
+#endif // __SSE2__
+
+void rgb_to_hsv(const uint32_t* in, const std::size_t n, uint32_t* out)
+{
+  std::size_t i = 0;
+
+#if defined(__SSE2__)
+  for (; i+4 <= n; i += 4) {
+    const __m128i px = _mm_loadu_si128((const __m128i*)(in+i));
+    _mm_storeu_si128((__m128i*)(out+i), rgb_to_hsv_4px(px));
+  }
+#endif
+
+  for (; i<n; ++i)
+    out[i] = rgb_to_hsv_pixel(in[i]);
+}
+
+void hsv_to_rgb(const uint32_t* in, const std::size_t n, uint32_t* out)
+{
+  // The fixed-point kernel is all small integer multiplications and
+  // already runs close to memory bandwidth, no SIMD variant needed so
+  // far.
+  for (std::size_t i=0; i<n; ++i)
+    out[i] = hsv_to_rgb_pixel(in[i]);
+}
+
+} // namespace gfx
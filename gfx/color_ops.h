@@ -0,0 +1,36 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_COLOR_OPS_H_INCLUDED
+#define GFX_COLOR_OPS_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+
+namespace gfx {
+
+  // Batch RGB<->HSV conversion over interleaved 32-bit pixel buffers
+  // (0xAABBGGRR byte order, i.e. red in the least significant byte).
+  // Converting one gfx::Hsv/gfx::Rgb at a time goes through
+  // double-precision math and takes hundreds of ms for a 4K frame;
+  // these kernels process whole buffers with SIMD/fixed-point math.
+  //
+  // HSV pixels pack the three components as bytes with hue scaled to
+  // the 0-255 range (i.e. 256 == 360 degrees, so each sextant is
+  // ~42.67 units), saturation/value in 0-255, and the alpha byte
+  // copied through untouched. Compared with the double-precision
+  // gfx::Hsv the byte components may differ by 1 unit from rounding.
+  //
+  // in/out can be the same buffer to convert in-place.
+
+  void rgb_to_hsv(const uint32_t* in, std::size_t n, uint32_t* out);
+  void hsv_to_rgb(const uint32_t* in, std::size_t n, uint32_t* out);
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,123 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/color_ops.h"
+#include "gfx/hsv.h"
+#include "gfx/rgb.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace gfx;
+
+static uint32_t make_px(int r, int g, int b, int a = 255)
+{
+  return (uint32_t(a) << 24) | (uint32_t(b) << 16) |
+         (uint32_t(g) << 8) | uint32_t(r);
+}
+
+TEST(ColorOps, RgbToHsvMatchesReference)
+{
+  // Compare the batch kernels with the double-precision gfx::Hsv over
+  // a spread of colors (enough pixels to exercise the SIMD main loop
+  // and the scalar tail).
+  std::vector<uint32_t> in;
+  for (int r=0; r<256; r+=17)
+    for (int g=0; g<256; g+=23)
+      for (int b=0; b<256; b+=29)
+        in.push_back(make_px(r, g, b, g ^ 0xff));
+
+  std::vector<uint32_t> out(in.size());
+  rgb_to_hsv(in.data(), in.size(), out.data());
+
+  for (std::size_t i=0; i<in.size(); ++i) {
+    const Hsv ref(Rgb(in[i] & 0xff, (in[i] >> 8) & 0xff, (in[i] >> 16) & 0xff));
+    const int refH = int(std::lround(ref.hue() * 256.0 / 360.0)) & 0xff;
+    const int refS = int(std::lround(ref.saturation() * 255.0));
+    const int refV = int(std::lround(ref.value() * 255.0));
+
+    const int h = out[i] & 0xff;
+    const int s = (out[i] >> 8) & 0xff;
+    const int v = (out[i] >> 16) & 0xff;
+
+    // Hue is circular (255 and 0 are neighbors)
+    const int dh = std::abs(h - refH);
+    EXPECT_LE(std::min(dh, 256 - dh), 2) << "i=" << i;
+    EXPECT_LE(std::abs(s - refS), 2) << "i=" << i;
+    EXPECT_LE(std::abs(v - refV), 1) << "i=" << i;
+
+    // Alpha is copied through
+    EXPECT_EQ(in[i] >> 24, out[i] >> 24) << "i=" << i;
+  }
+}
+
+TEST(ColorOps, Roundtrip)
+{
+  std::vector<uint32_t> in;
+  for (int r=0; r<256; r+=13)
+    for (int g=0; g<256; g+=19)
+      in.push_back(make_px(r, g, (r*g) & 0xff));
+
+  // In-place conversion is supported
+  std::vector<uint32_t> buf(in);
+  rgb_to_hsv(buf.data(), buf.size(), buf.data());
+  hsv_to_rgb(buf.data(), buf.size(), buf.data());
+
+  for (std::size_t i=0; i<in.size(); ++i) {
+    for (int shift : { 0, 8, 16 }) {
+      const int a = (in[i] >> shift) & 0xff;
+      const int b = (buf[i] >> shift) & 0xff;
+      // The 8-bit hue quantization loses some precision
+      EXPECT_LE(std::abs(a - b), 4) << "i=" << i << " shift=" << shift;
+    }
+    EXPECT_EQ(in[i] >> 24, buf[i] >> 24);
+  }
+}
+
+TEST(ColorOps, PrimaryColors)
+{
+  const uint32_t in[] = {
+    make_px(255, 0, 0),         // Red: h=0
+    make_px(0, 255, 0),         // Green: h=~85
+    make_px(0, 0, 255),         // Blue: h=~171
+    make_px(255, 255, 255),     // White: s=0, v=255
+    make_px(0, 0, 0),           // Black: v=0
+  };
+  uint32_t out[5];
+  rgb_to_hsv(in, 5, out);
+
+  EXPECT_EQ(0, out[0] & 0xff);
+  EXPECT_LE(std::abs(int(out[1] & 0xff) - 85), 1);
+  EXPECT_LE(std::abs(int(out[2] & 0xff) - 171), 1);
+  EXPECT_EQ(0, (out[3] >> 8) & 0xff);
+  EXPECT_EQ(255, (out[3] >> 16) & 0xff);
+  EXPECT_EQ(0, (out[4] >> 16) & 0xff);
+
+  uint32_t back[5];
+  hsv_to_rgb(out, 5, back);
+  for (int i=0; i<5; ++i) {
+    // (±2 per channel: pure green/blue hues fall between two 8-bit
+    // hue steps)
+    for (int shift : { 0, 8, 16 }) {
+      const int a = (in[i] >> shift) & 0xff;
+      const int b = (back[i] >> shift) & 0xff;
+      EXPECT_LE(std::abs(a - b), 2) << "i=" << i << " shift=" << shift;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -139,6 +139,114 @@ static bool nearly_equal(const ColorSpacePrimaries& u,
     && nearly_equal(u.by, v.by);
 }
 
+// Whether the transfer curve of the color space is known at this
+// level (for ICC profiles the curve is inside the profile and needs a
+// real CMM, for None it's whatever the display uses).
+static bool has_known_transfer_curve(const ColorSpace& cs)
+{
+  return (cs.type() == ColorSpace::sRGB ||
+          cs.type() == ColorSpace::RGB);
+}
+
+// Encoded [0, 1] -> linear [0, 1]
+static float to_linear(const ColorSpace& cs, const float x)
+{
+  if (const ColorSpaceTransferFn* fn = cs.transferFn()) {
+    if (x < fn->d)
+      return fn->c*x + fn->f;
+    return std::pow(fn->a*x + fn->b, fn->g) + fn->e;
+  }
+  if (cs.hasGamma())
+    return std::pow(x, cs.gamma());
+  // Plain sRGB curve
+  if (x < 0.04045f)
+    return x / 12.92f;
+  return std::pow((x + 0.055f) / 1.055f, 2.4f);
+}
+
+// Linear [0, 1] -> encoded [0, 1] (inverse of to_linear())
+static float from_linear(const ColorSpace& cs, const float y)
+{
+  if (const ColorSpaceTransferFn* fn = cs.transferFn()) {
+    // Invert each piece of the parametric function analytically; the
+    // pieces meet at x=d, i.e. y=c*d+f
+    if (y < fn->c*fn->d + fn->f)
+      return (fn->c != 0.0f ? (y - fn->f) / fn->c: 0.0f);
+    if (fn->a != 0.0f && fn->g != 0.0f)
+      return (std::pow(std::max(y - fn->e, 0.0f), 1.0f / fn->g) - fn->b) / fn->a;
+    return 0.0f;
+  }
+  if (cs.hasGamma())
+    return (cs.gamma() != 0.0f ? std::pow(y, 1.0f / cs.gamma()): 0.0f);
+  // Plain sRGB curve
+  if (y < 0.04045f / 12.92f)
+    return y * 12.92f;
+  return 1.055f * std::pow(y, 1.0f / 2.4f) - 0.055f;
+}
+
+void ColorSpace::buildLuts() const
+{
+  if (!has_known_transfer_curve(*this))
+    return; // Leave both tables empty
+
+  m_toLinearLut.resize(256);
+  for (int i=0; i<256; ++i)
+    m_toLinearLut[i] = std::clamp(to_linear(*this, float(i) / 255.0f),
+                                  0.0f, 1.0f);
+
+  m_fromLinearLut.resize(kFromLinearLutSize);
+  for (int i=0; i<kFromLinearLutSize; ++i) {
+    const float y = float(i) / float(kFromLinearLutSize-1);
+    const float x = std::clamp(from_linear(*this, y), 0.0f, 1.0f);
+    m_fromLinearLut[i] = uint8_t(std::lround(x * 255.0f));
+  }
+}
+
+const std::vector<float>& ColorSpace::toLinearLut() const
+{
+  std::call_once(m_lutsOnce, [this]{ buildLuts(); });
+  return m_toLinearLut;
+}
+
+const std::vector<uint8_t>& ColorSpace::fromLinearLut() const
+{
+  std::call_once(m_lutsOnce, [this]{ buildLuts(); });
+  return m_fromLinearLut;
+}
+
+bool ColorSpace::makeConversionLut(const ColorSpace& dst, uint8_t lut[256]) const
+{
+  const std::vector<float>& toLinear = toLinearLut();
+  const std::vector<uint8_t>& fromLinear = dst.fromLinearLut();
+  if (toLinear.empty() || fromLinear.empty())
+    return false;
+
+  for (int i=0; i<256; ++i) {
+    const int j = int(std::lround(toLinear[i] * (kFromLinearLutSize-1)));
+    lut[i] = fromLinear[j];
+  }
+  return true;
+}
+
+uint64_t ColorSpace::contentHash() const
+{
+  // FNV-1a over the content bytes
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const uint8_t* p, const size_t n) {
+    for (size_t i=0; i<n; ++i) {
+      hash ^= p[i];
+      hash *= 1099511628211ull;
+    }
+  };
+
+  const uint32_t head[2] = { uint32_t(m_type), uint32_t(m_flags) };
+  mix((const uint8_t*)head, sizeof(head));
+  mix((const uint8_t*)&m_gamma, sizeof(m_gamma));
+  if (!m_data.empty())
+    mix(m_data.data(), m_data.size());
+  return hash;
+}
+
 bool ColorSpace::nearlyEqual(const ColorSpace& that) const
 {
   if (m_type != that.m_type)
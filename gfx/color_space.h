@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -111,11 +112,47 @@ namespace gfx {
     bool operator!=(const ColorSpace& that) const = delete;
     bool nearlyEqual(const ColorSpace& that) const;
 
+    // Hash of the color space content: type, flags, gamma and the
+    // transfer/primaries/ICC payload (the name is not content), so
+    // backends can intern equal color spaces under one canonical
+    // instance. Spaces built from the same data hash the same;
+    // spaces equal only within the nearlyEqual() tolerance can still
+    // hash differently.
+    uint64_t contentHash() const;
+
+    // Precomputed transfer-function tables, built lazily on the first
+    // use and then cached on the object (the color space data is
+    // immutable after construction--only the name can change--so the
+    // cache never needs invalidation). Both tables are empty for
+    // None/ICC color spaces, where the transfer curve isn't known at
+    // this level, and the caller has to fall back to the full
+    // per-pixel conversion.
+
+    // (4096 steps keep the error within 1 encoded unit even in the
+    // dark end, where linear steps are tiny)
+    static constexpr int kFromLinearLutSize = 4096;
+
+    // Maps an encoded 8-bit channel to its linear value in [0.0, 1.0]
+    // (256 entries).
+    const std::vector<float>& toLinearLut() const;
+
+    // Maps a linear value quantized to kFromLinearLutSize steps back
+    // to the encoded 8-bit channel.
+    const std::vector<uint8_t>& fromLinearLut() const;
+
+    // Fills lut[256] with the composed per-channel conversion from
+    // this color space to dst (i.e. dst's encoding of this space's
+    // linear value), so converting a pixel buffer between two known
+    // spaces is three table lookups per pixel. Returns false when
+    // either side has no known transfer curve.
+    bool makeConversionLut(const ColorSpace& dst, uint8_t lut[256]) const;
+
     // This data can be used
     const std::vector<uint8_t>& rawData() const { return m_data; }
 
   private:
     bool has(const Flag flag) const { return (m_flags & int(flag)) == int(flag); }
+    void buildLuts() const;
 
     Type m_type;
     Flag m_flags;
@@ -123,6 +160,11 @@ namespace gfx {
     float m_gamma = 1.0f;
     // ColorSpacePrimaries + ColorSpaceTransferFn or raw ICC profile data
     std::vector<uint8_t> m_data;
+
+    // Cached transfer-function tables (see toLinearLut())
+    mutable std::once_flag m_lutsOnce;
+    mutable std::vector<float> m_toLinearLut;
+    mutable std::vector<uint8_t> m_fromLinearLut;
   };
 
 } // namespace gfx
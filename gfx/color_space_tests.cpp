@@ -0,0 +1,100 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/color_space.h"
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace gfx;
+
+TEST(ColorSpace, SRGBLuts)
+{
+  auto cs = ColorSpace::MakeSRGB();
+
+  const auto& toLinear = cs->toLinearLut();
+  ASSERT_EQ(256, toLinear.size());
+  EXPECT_EQ(0.0f, toLinear[0]);
+  EXPECT_EQ(1.0f, toLinear[255]);
+  // sRGB mid-gray: 128/255 -> ~0.2158 linear
+  EXPECT_NEAR(0.2158f, toLinear[128], 0.001f);
+
+  // fromLinearLut() inverts toLinearLut() within a quantization step
+  const auto& fromLinear = cs->fromLinearLut();
+  ASSERT_EQ(ColorSpace::kFromLinearLutSize, fromLinear.size());
+  for (int i=0; i<256; ++i) {
+    const int j = int(std::lround(toLinear[i] * (ColorSpace::kFromLinearLutSize-1)));
+    EXPECT_LE(std::abs(int(fromLinear[j]) - i), 1) << "i=" << i;
+  }
+}
+
+TEST(ColorSpace, LinearGammaLuts)
+{
+  auto cs = ColorSpace::MakeLinearSRGB();
+  const auto& toLinear = cs->toLinearLut();
+  ASSERT_EQ(256, toLinear.size());
+  for (int i=0; i<256; ++i)
+    EXPECT_NEAR(float(i) / 255.0f, toLinear[i], 0.0001f);
+}
+
+TEST(ColorSpace, ConversionLut)
+{
+  auto srgb = ColorSpace::MakeSRGB();
+  auto linear = ColorSpace::MakeLinearSRGB();
+
+  // sRGB -> sRGB composes to (almost) the identity
+  uint8_t lut[256];
+  ASSERT_TRUE(srgb->makeConversionLut(*srgb, lut));
+  for (int i=0; i<256; ++i)
+    EXPECT_LE(std::abs(int(lut[i]) - i), 1) << "i=" << i;
+
+  // sRGB -> linear: mid-gray gets darker
+  ASSERT_TRUE(srgb->makeConversionLut(*linear, lut));
+  EXPECT_EQ(0, lut[0]);
+  EXPECT_EQ(255, lut[255]);
+  EXPECT_NEAR(55, lut[128], 2);
+
+  // Unknown transfer curves cannot build tables
+  auto none = ColorSpace::MakeNone();
+  EXPECT_TRUE(none->toLinearLut().empty());
+  EXPECT_FALSE(none->makeConversionLut(*srgb, lut));
+  EXPECT_FALSE(srgb->makeConversionLut(*none, lut));
+}
+
+TEST(ColorSpace, ContentHash)
+{
+  auto srgb1 = ColorSpace::MakeSRGB();
+  auto srgb2 = ColorSpace::MakeSRGB();
+  auto linear = ColorSpace::MakeLinearSRGB();
+  auto none = ColorSpace::MakeNone();
+
+  EXPECT_EQ(srgb1->contentHash(), srgb2->contentHash());
+  EXPECT_NE(srgb1->contentHash(), linear->contentHash());
+  EXPECT_NE(srgb1->contentHash(), none->contentHash());
+
+  // The name is not part of the content
+  srgb2->setName("Other name");
+  EXPECT_EQ(srgb1->contentHash(), srgb2->contentHash());
+
+  const uint8_t icc1[] = { 1, 2, 3, 4 };
+  const uint8_t icc2[] = { 1, 2, 3, 5 };
+  EXPECT_EQ(ColorSpace::MakeICC(icc1, sizeof(icc1))->contentHash(),
+            ColorSpace::MakeICC(icc1, sizeof(icc1))->contentHash());
+  EXPECT_NE(ColorSpace::MakeICC(icc1, sizeof(icc1))->contentHash(),
+            ColorSpace::MakeICC(icc2, sizeof(icc2))->contentHash());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_GEOMETRY_IO_H_INCLUDED
+#define GFX_GEOMETRY_IO_H_INCLUDED
+#pragma once
+
+#include "base/config.h"
+#include "base/serialization.h"
+#include "gfx/border.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace gfx {
+
+  // Bulk binary serialization for arrays of geometry types: a 32-bit
+  // count followed by the packed little-endian int32 fields. On
+  // little-endian machines the payload is one write()/read() of the
+  // whole array instead of a function call per byte, which matters
+  // for region-heavy session data (thousands of rects).
+
+  namespace details {
+
+    template<typename T>
+    inline void write_geometry_array(std::ostream& os,
+                                     const T* data,
+                                     const std::size_t n) {
+      static_assert(sizeof(T) % sizeof(int32_t) == 0,
+                    "Geometry types must be packed int32 fields");
+      base::serialization::little_endian::write32(os, uint32_t(n));
+#ifdef LAF_LITTLE_ENDIAN
+      if (n > 0)
+        os.write((const char*)data, n*sizeof(T));
+#else
+      const int32_t* fields = (const int32_t*)data;
+      for (std::size_t i=0; i<n*(sizeof(T)/sizeof(int32_t)); ++i)
+        base::serialization::little_endian::write32(os, fields[i]);
+#endif
+    }
+
+    template<typename T>
+    inline bool read_geometry_array(std::istream& is, std::vector<T>& data) {
+      const uint32_t n = base::serialization::little_endian::read32(is);
+      if (!is)
+        return false;
+      data.resize(n);
+#ifdef LAF_LITTLE_ENDIAN
+      if (n > 0)
+        is.read((char*)data.data(), n*sizeof(T));
+#else
+      int32_t* fields = (int32_t*)data.data();
+      for (std::size_t i=0; i<n*(sizeof(T)/sizeof(int32_t)); ++i)
+        fields[i] = base::serialization::little_endian::read32(is);
+#endif
+      return !is.fail();
+    }
+
+    template<typename T>
+    inline void write_geometry_array(base::serialization::serializer& s,
+                                     const T* data,
+                                     const std::size_t n) {
+      s.write32(uint32_t(n));
+#ifdef LAF_LITTLE_ENDIAN
+      if (n > 0)
+        s.write_bytes((const uint8_t*)data, n*sizeof(T));
+#else
+      const int32_t* fields = (const int32_t*)data;
+      for (std::size_t i=0; i<n*(sizeof(T)/sizeof(int32_t)); ++i)
+        s.write32(fields[i]);
+#endif
+    }
+
+    template<typename T>
+    inline bool read_geometry_array(base::serialization::deserializer& d,
+                                    std::vector<T>& data) {
+      const uint32_t n = d.read32();
+      if (!d.ok() || n*sizeof(T) > d.remaining())
+        return false;
+      data.resize(n);
+#ifdef LAF_LITTLE_ENDIAN
+      if (n > 0)
+        d.read_bytes((uint8_t*)data.data(), n*sizeof(T));
+#else
+      int32_t* fields = (int32_t*)data.data();
+      for (std::size_t i=0; i<n*(sizeof(T)/sizeof(int32_t)); ++i)
+        fields[i] = d.read32();
+#endif
+      return d.ok();
+    }
+
+  } // namespace details
+
+#define LAF_GFX_DEFINE_BULK_IO(name, Type)                                   \
+  inline void write_##name(std::ostream& os,                                 \
+                           const Type* data, const std::size_t n) {          \
+    details::write_geometry_array(os, data, n);                              \
+  }                                                                          \
+  inline void write_##name(std::ostream& os, const std::vector<Type>& v) {   \
+    details::write_geometry_array(os, v.data(), v.size());                   \
+  }                                                                          \
+  inline bool read_##name(std::istream& is, std::vector<Type>& v) {          \
+    return details::read_geometry_array(is, v);                              \
+  }                                                                          \
+  inline void write_##name(base::serialization::serializer& s,               \
+                           const Type* data, const std::size_t n) {          \
+    details::write_geometry_array(s, data, n);                               \
+  }                                                                          \
+  inline void write_##name(base::serialization::serializer& s,               \
+                           const std::vector<Type>& v) {                     \
+    details::write_geometry_array(s, v.data(), v.size());                    \
+  }                                                                          \
+  inline bool read_##name(base::serialization::deserializer& d,              \
+                          std::vector<Type>& v) {                            \
+    return details::read_geometry_array(d, v);                               \
+  }
+
+  LAF_GFX_DEFINE_BULK_IO(rects, Rect)
+  LAF_GFX_DEFINE_BULK_IO(points, Point)
+  LAF_GFX_DEFINE_BULK_IO(sizes, Size)
+  LAF_GFX_DEFINE_BULK_IO(borders, Border)
+
+#undef LAF_GFX_DEFINE_BULK_IO
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,92 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/rect_io.h"
+#include "gfx/geometry_io.h"
+
+#include <sstream>
+
+using namespace gfx;
+
+TEST(GeometryIo, RectsStreamRoundtrip)
+{
+  std::vector<Rect> rects;
+  for (int i=0; i<1000; ++i)
+    rects.push_back(Rect(i, -i, i*3, i % 7));
+
+  std::stringstream ss;
+  write_rects(ss, rects);
+
+  std::vector<Rect> result;
+  EXPECT_TRUE(read_rects(ss, result));
+  EXPECT_EQ(rects, result);
+
+  // Truncated payloads fail instead of returning half an array
+  std::stringstream truncated(ss.str().substr(0, 100));
+  EXPECT_FALSE(read_rects(truncated, result));
+}
+
+TEST(GeometryIo, BufferRoundtrip)
+{
+  const std::vector<Point> points = { Point(1, 2), Point(-3, 4) };
+  const std::vector<Size> sizes = { Size(640, 480) };
+  const std::vector<Border> borders = { Border(1, 2, 3, 4) };
+
+  base::buffer buf;
+  base::serialization::serializer s(buf);
+  write_points(s, points);
+  write_sizes(s, sizes);
+  write_borders(s, borders);
+
+  base::serialization::deserializer d(buf);
+  std::vector<Point> points2;
+  std::vector<Size> sizes2;
+  std::vector<Border> borders2;
+  EXPECT_TRUE(read_points(d, points2));
+  EXPECT_TRUE(read_sizes(d, sizes2));
+  EXPECT_TRUE(read_borders(d, borders2));
+  EXPECT_EQ(points, points2);
+  EXPECT_EQ(sizes, sizes2);
+  EXPECT_EQ(borders, borders2);
+  EXPECT_EQ(0, d.remaining());
+
+  // A bogus count larger than the remaining bytes is rejected
+  base::buffer bogus = { 0xff, 0xff, 0xff, 0x7f, 1, 2, 3, 4 };
+  base::serialization::deserializer d2(bogus);
+  EXPECT_FALSE(read_points(d2, points2));
+}
+
+TEST(GeometryIo, PackedLayout)
+{
+  // One rect serializes as count + 4 little-endian int32 fields
+  const Rect rc(0x01020304, 0x11121314, 0x21222324, 0x31323334);
+  std::stringstream ss;
+  write_rects(ss, &rc, 1);
+
+  const std::string bytes = ss.str();
+  ASSERT_EQ(20, bytes.size());
+  const uint8_t expected[20] = {
+    1, 0, 0, 0,
+    0x04, 0x03, 0x02, 0x01,
+    0x14, 0x13, 0x12, 0x11,
+    0x24, 0x23, 0x22, 0x21,
+    0x34, 0x33, 0x32, 0x31,
+  };
+  for (int i=0; i<20; ++i)
+    EXPECT_EQ(expected[i], uint8_t(bytes[i])) << "i=" << i;
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -8,52 +8,172 @@
 #define GFX_MATRIX_NONE_H_INCLUDED
 #pragma once
 
+#include "gfx/point.h"
 #include "gfx/rect.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace gfx {
 
+  // Software 3x3 matrix with the same API and conventions as the
+  // SkMatrix wrapper in matrix_skia.h (row-major, concat order,
+  // degrees for rotations), so LAF_BACKEND=none builds can do real
+  // transformed rendering.
   class Matrix {
   public:
     Matrix() { }
 
-    static Matrix MakeScale(float sx, float sy) { return Matrix(); }
-    static Matrix MakeScale(float scale) { return Matrix(); }
-    static Matrix MakeTrans(float x, float y) { return Matrix(); }
+    static Matrix MakeScale(float sx, float sy) {
+      Matrix m;
+      m.setScale(sx, sy);
+      return m;
+    }
+
+    static Matrix MakeScale(float scale) {
+      return MakeScale(scale, scale);
+    }
+
+    static Matrix MakeTrans(float x, float y) {
+      Matrix m;
+      m.setTranslate(x, y);
+      return m;
+    }
+
     static Matrix MakeAll(float scaleX, float skewX,  float transX,
                           float skewY,  float scaleY, float transY,
                           float pers0, float pers1, float pers2) {
-      return Matrix();
-    }
-
-    Matrix& reset() { return *this; }
-    bool isIdentity() const { return true; }
-    bool isScaleTranslate() const { return false; }
-    bool isTranslate() const { return false; }
-
-    float getScaleX() const { return 1.0f; }
-    float getScaleY() const { return 1.0f; }
-    float getSkewY() const { return 0.0f; }
-    float getSkewX() const { return 0.0f; }
-    float getTranslateX() const { return 0.0f; }
-    float getTranslateY() const { return 0.0f; }
-    float getPerspX() const { return 0.0f; }
-    float getPerspY() const { return 0.0f; }
-
-    Matrix& setIdentity() { return *this; }
-    Matrix& setTranslate(float dx, float dy) { return *this; }
-    void setScale(float sx, float sy, float px, float py) { }
-    void setScale(float sx, float sy) { }
-    void setRotate(float degrees, float px, float py) { }
-    void setRotate(float degrees) { }
-    void setScaleTranslate(float sx, float sy, float tx, float ty) { }
-    Matrix& preTranslate(float dx, float dy) { return *this; }
-    Matrix& postTranslate(float dx, float dy) { return *this; }
-
-    Matrix& setConcat(const Matrix& a, const Matrix& b) { return *this; }
-    Matrix& preConcat(const Matrix& other) { return *this; }
-    Matrix& postConcat(const Matrix& other) { return *this; }
-
-    RectF mapRect(const RectF& src) const { return RectF(); }
+      Matrix m;
+      m.m_mat[0] = scaleX; m.m_mat[1] = skewX;  m.m_mat[2] = transX;
+      m.m_mat[3] = skewY;  m.m_mat[4] = scaleY; m.m_mat[5] = transY;
+      m.m_mat[6] = pers0;  m.m_mat[7] = pers1;  m.m_mat[8] = pers2;
+      return m;
+    }
+
+    Matrix& reset() { return setIdentity(); }
+
+    bool isIdentity() const {
+      return (isScaleTranslate() &&
+              m_mat[0] == 1.0f && m_mat[4] == 1.0f &&
+              m_mat[2] == 0.0f && m_mat[5] == 0.0f);
+    }
+    bool isScaleTranslate() const {
+      return (m_mat[1] == 0.0f && m_mat[3] == 0.0f &&
+              m_mat[6] == 0.0f && m_mat[7] == 0.0f && m_mat[8] == 1.0f);
+    }
+    bool isTranslate() const {
+      return (isScaleTranslate() &&
+              m_mat[0] == 1.0f && m_mat[4] == 1.0f);
+    }
+
+    float getScaleX() const { return m_mat[0]; }
+    float getScaleY() const { return m_mat[4]; }
+    float getSkewY() const { return m_mat[3]; }
+    float getSkewX() const { return m_mat[1]; }
+    float getTranslateX() const { return m_mat[2]; }
+    float getTranslateY() const { return m_mat[5]; }
+    float getPerspX() const { return m_mat[6]; }
+    float getPerspY() const { return m_mat[7]; }
+
+    Matrix& setIdentity() {
+      m_mat[0] = 1.0f; m_mat[1] = 0.0f; m_mat[2] = 0.0f;
+      m_mat[3] = 0.0f; m_mat[4] = 1.0f; m_mat[5] = 0.0f;
+      m_mat[6] = 0.0f; m_mat[7] = 0.0f; m_mat[8] = 1.0f;
+      return *this;
+    }
+
+    Matrix& setTranslate(float dx, float dy) {
+      setIdentity();
+      m_mat[2] = dx;
+      m_mat[5] = dy;
+      return *this;
+    }
+
+    void setScale(float sx, float sy, float px, float py) {
+      // Scale around the pivot: T(px, py) * S(sx, sy) * T(-px, -py)
+      setScaleTranslate(sx, sy, px - sx*px, py - sy*py);
+    }
+
+    void setScale(float sx, float sy) {
+      setScaleTranslate(sx, sy, 0.0f, 0.0f);
+    }
+
+    void setRotate(float degrees, float px, float py) {
+      const float rads = degrees * 3.14159265358979323846f / 180.0f;
+      const float c = std::cos(rads);
+      const float s = std::sin(rads);
+      m_mat[0] = c;    m_mat[1] = -s;   m_mat[2] = px - c*px + s*py;
+      m_mat[3] = s;    m_mat[4] = c;    m_mat[5] = py - s*px - c*py;
+      m_mat[6] = 0.0f; m_mat[7] = 0.0f; m_mat[8] = 1.0f;
+    }
+
+    void setRotate(float degrees) {
+      setRotate(degrees, 0.0f, 0.0f);
+    }
+
+    void setScaleTranslate(float sx, float sy, float tx, float ty) {
+      m_mat[0] = sx;   m_mat[1] = 0.0f; m_mat[2] = tx;
+      m_mat[3] = 0.0f; m_mat[4] = sy;   m_mat[5] = ty;
+      m_mat[6] = 0.0f; m_mat[7] = 0.0f; m_mat[8] = 1.0f;
+    }
+
+    Matrix& preTranslate(float dx, float dy) {
+      return preConcat(MakeTrans(dx, dy));
+    }
+
+    Matrix& postTranslate(float dx, float dy) {
+      return postConcat(MakeTrans(dx, dy));
+    }
+
+    // this = a * b (maps a point through b first, then a)
+    Matrix& setConcat(const Matrix& a, const Matrix& b) {
+      float r[9];
+      for (int row=0; row<3; ++row) {
+        for (int col=0; col<3; ++col) {
+          r[3*row+col] = (a.m_mat[3*row  ] * b.m_mat[col  ] +
+                          a.m_mat[3*row+1] * b.m_mat[col+3] +
+                          a.m_mat[3*row+2] * b.m_mat[col+6]);
+        }
+      }
+      std::copy(r, r+9, m_mat);
+      return *this;
+    }
+
+    Matrix& preConcat(const Matrix& other) {
+      return setConcat(*this, other);
+    }
+
+    Matrix& postConcat(const Matrix& other) {
+      return setConcat(other, *this);
+    }
+
+    PointF mapPoint(const PointF& p) const {
+      const double x = m_mat[0]*p.x + m_mat[1]*p.y + m_mat[2];
+      const double y = m_mat[3]*p.x + m_mat[4]*p.y + m_mat[5];
+      const double w = m_mat[6]*p.x + m_mat[7]*p.y + m_mat[8];
+      if (w != 1.0 && w != 0.0)
+        return PointF(x/w, y/w);
+      return PointF(x, y);
+    }
+
+    // Maps the four corners and returns their bounding box (like
+    // SkMatrix::mapRect()).
+    RectF mapRect(const RectF& src) const {
+      const PointF a = mapPoint(PointF(src.x, src.y));
+      const PointF b = mapPoint(PointF(src.x+src.w, src.y));
+      const PointF c = mapPoint(PointF(src.x, src.y+src.h));
+      const PointF d = mapPoint(PointF(src.x+src.w, src.y+src.h));
+      const double x1 = std::min(std::min(a.x, b.x), std::min(c.x, d.x));
+      const double y1 = std::min(std::min(a.y, b.y), std::min(c.y, d.y));
+      const double x2 = std::max(std::max(a.x, b.x), std::max(c.x, d.x));
+      const double y2 = std::max(std::max(a.y, b.y), std::max(c.y, d.y));
+      return RectF(x1, y1, x2-x1, y2-y1);
+    }
+
+  private:
+    float m_mat[9] = { 1.0f, 0.0f, 0.0f,
+                       0.0f, 1.0f, 0.0f,
+                       0.0f, 0.0f, 1.0f };
   };
 
 } // namespace gfx
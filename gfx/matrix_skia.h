@@ -114,6 +114,11 @@ namespace gfx {
       return *this;
     }
 
+    PointF mapPoint(const PointF& p) const {
+      const SkPoint r = m_skMatrix.mapXY(SkScalar(p.x), SkScalar(p.y));
+      return PointF(r.x(), r.y());
+    }
+
     RectF mapRect(const RectF& src) const {
       SkRect dst;
       m_skMatrix.mapRect(&dst, SkRect::MakeXYWH(SkScalar(src.x), SkScalar(src.y),
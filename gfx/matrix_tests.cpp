@@ -0,0 +1,91 @@
+// LAF Gfx Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/matrix.h"
+
+using namespace gfx;
+
+TEST(Matrix, Identity)
+{
+  Matrix m;
+  EXPECT_TRUE(m.isIdentity());
+  EXPECT_TRUE(m.isTranslate());
+  EXPECT_TRUE(m.isScaleTranslate());
+  EXPECT_EQ(1.0f, m.getScaleX());
+  EXPECT_EQ(0.0f, m.getTranslateX());
+}
+
+TEST(Matrix, ScaleTranslate)
+{
+  Matrix m = Matrix::MakeTrans(10.0f, 20.0f);
+  EXPECT_TRUE(m.isTranslate());
+  EXPECT_FALSE(m.isIdentity());
+  EXPECT_EQ(10.0f, m.getTranslateX());
+  EXPECT_EQ(20.0f, m.getTranslateY());
+
+  m = Matrix::MakeScale(2.0f, 3.0f);
+  EXPECT_TRUE(m.isScaleTranslate());
+  EXPECT_FALSE(m.isTranslate());
+
+  const RectF rc = m.mapRect(RectF(1.0, 1.0, 10.0, 10.0));
+  EXPECT_DOUBLE_EQ(2.0, rc.x);
+  EXPECT_DOUBLE_EQ(3.0, rc.y);
+  EXPECT_DOUBLE_EQ(20.0, rc.w);
+  EXPECT_DOUBLE_EQ(30.0, rc.h);
+}
+
+TEST(Matrix, ConcatOrder)
+{
+  // preConcat applies the new transform first, postConcat last
+  Matrix m = Matrix::MakeScale(2.0f);
+  m.preTranslate(5.0f, 0.0f);   // scale(translate(p))
+  PointF p = m.mapPoint(PointF(1.0, 0.0));
+  EXPECT_NEAR(12.0, p.x, 1e-4);
+
+  m = Matrix::MakeScale(2.0f);
+  m.postTranslate(5.0f, 0.0f);  // translate(scale(p))
+  p = m.mapPoint(PointF(1.0, 0.0));
+  EXPECT_NEAR(7.0, p.x, 1e-4);
+}
+
+TEST(Matrix, Rotate)
+{
+  Matrix m;
+  m.setRotate(90.0f);
+  const PointF p = m.mapPoint(PointF(1.0, 0.0));
+  EXPECT_NEAR(0.0, p.x, 1e-4);
+  EXPECT_NEAR(1.0, p.y, 1e-4);
+
+  // Rotating around a pivot keeps the pivot fixed
+  Matrix r;
+  r.setRotate(45.0f, 3.0f, 4.0f);
+  const PointF q = r.mapPoint(PointF(3.0, 4.0));
+  EXPECT_NEAR(3.0, q.x, 1e-4);
+  EXPECT_NEAR(4.0, q.y, 1e-4);
+}
+
+TEST(Matrix, ScalePivot)
+{
+  Matrix m;
+  m.setScale(2.0f, 2.0f, 10.0f, 10.0f);
+  const PointF fixedPt = m.mapPoint(PointF(10.0, 10.0));
+  EXPECT_NEAR(10.0, fixedPt.x, 1e-4);
+  EXPECT_NEAR(10.0, fixedPt.y, 1e-4);
+  const PointF other = m.mapPoint(PointF(11.0, 10.0));
+  EXPECT_NEAR(12.0, other.x, 1e-4);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
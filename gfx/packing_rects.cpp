@@ -11,6 +11,8 @@
 
 #include "gfx/packing_rects.h"
 
+#include "base/ints.h"
+#include "base/thread_pool.h"
 #include "gfx/region.h"
 #include "gfx/size.h"
 
@@ -94,8 +96,250 @@ bool PackingRects::pack(const Size& size,
     rectPtrs[i++] = &rc;
   std::sort(rectPtrs.begin(), rectPtrs.end(), by_area);
 
+  bool done = false;
+  switch (m_strategy) {
+    case Strategy::Skyline:
+      done = packSkyline(rectPtrs, token);
+      break;
+    case Strategy::Region:
+      done = packRegion(rectPtrs, token);
+      break;
+  }
+
+  // Keep the free space around for the incremental API
+  // (remove()/tryPlace())
+  if (done)
+    rebuildFreeRects();
+  else {
+    m_freeRects.clear();
+    m_freeRectsValid = false;
+  }
+  return done;
+}
+
+int PackingRects::packPages(const Size& pageSize,
+                            base::thread_pool& pool,
+                            base::task_token& token)
+{
+  m_pages = 0;
+  m_pageOf.assign(m_rects.size(), -1);
+  m_freeRects.clear();
+  m_freeRectsValid = false;
+
+  if (m_rects.empty())
+    return 0;
+
+  // Size-estimation pre-pass: the page count cannot be smaller than
+  // the total padded area divided by the usable area of one page, so
+  // we start directly from that lower bound instead of overflowing
+  // page after page and repacking the same set several times.
+  const int usableW = pageSize.w - 2*m_borderPadding + m_shapePadding;
+  const int usableH = pageSize.h - 2*m_borderPadding + m_shapePadding;
+  if (usableW <= 0 || usableH <= 0)
+    return 0;
+
+  uint64_t neededArea = 0;
+  for (const auto& rc : m_rects) {
+    if (rc.w + m_shapePadding > usableW ||
+        rc.h + m_shapePadding > usableH)
+      return 0;               // This rectangle cannot fit in any page
+    neededArea += uint64_t(rc.w + m_shapePadding) *
+                  uint64_t(rc.h + m_shapePadding);
+  }
+  const uint64_t pageArea = uint64_t(usableW) * uint64_t(usableH);
+  int npages = int((neededArea + pageArea - 1) / pageArea);
+
+  // Biggest rectangles first (same criterion used by pack())
+  std::vector<int> order(m_rects.size());
+  for (int i=0; i<int(order.size()); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+            [this](int a, int b) {
+              return m_rects[a].w*m_rects[a].h > m_rects[b].w*m_rects[b].h;
+            });
+
+  while (!token.canceled()) {
+    // Greedy area balancing: each rectangle goes to the page with the
+    // smallest assigned area so far.
+    std::vector<PackingRects> pagePackers;
+    pagePackers.reserve(npages);
+    for (int p=0; p<npages; ++p)
+      pagePackers.emplace_back(m_borderPadding, m_shapePadding, m_strategy);
+    std::vector<uint64_t> pageUsed(npages, 0);
+    std::vector<std::vector<int>> pageRects(npages);
+    for (int i : order) {
+      int best = 0;
+      for (int p=1; p<npages; ++p) {
+        if (pageUsed[p] < pageUsed[best])
+          best = p;
+      }
+      pagePackers[best].add(m_rects[i]);
+      pageRects[best].push_back(i);
+      pageUsed[best] += uint64_t(m_rects[i].w + m_shapePadding) *
+                        uint64_t(m_rects[i].h + m_shapePadding);
+    }
+
+    // Each page is an independent bin, pack all of them concurrently
+    std::vector<char> packed(npages, 0);
+    for (int p=0; p<npages; ++p) {
+      pool.execute(
+        [&pagePackers, &packed, &pageSize, &token, p]{
+          packed[p] = (pagePackers[p].pack(pageSize, token) ? 1: 0);
+        });
+    }
+    pool.wait_all();
+
+    if (token.canceled())
+      return 0;
+
+    bool done = true;
+    for (const char ok : packed)
+      done &= (ok != 0);
+    if (done) {
+      for (int p=0; p<npages; ++p) {
+        for (int j=0; j<int(pageRects[p].size()); ++j) {
+          const int i = pageRects[p][j];
+          m_rects[i] = pagePackers[p][j];
+          m_pageOf[i] = p;
+        }
+      }
+      m_pages = npages;
+      m_bounds = Rect(pageSize).shrink(m_borderPadding);
+      return npages;
+    }
+
+    // Some page overflowed (real packings don't reach 100% of
+    // occupancy with irregular sizes): redistribute over one more
+    // page and repack.
+    ++npages;
+  }
+
+  return 0;
+}
+
+// A horizontal segment of the skyline (the "roof" of the already
+// placed rectangles): [x, x+w) is covered up to the y coordinate.
+namespace {
+  struct SkylineSegment {
+    int x, y, w;
+  };
+}
+
+// Returns true if a rectangle of the given width/height fits with its
+// left side at skyline[index].x, and in that case returns in "y" the
+// (lowest possible) top coordinate of the placement.
+static bool skyline_fits(const std::vector<SkylineSegment>& skyline,
+                         const size_t index,
+                         const int w, const int h,
+                         const int binW, const int binH,
+                         int& y)
+{
+  const int x = skyline[index].x;
+  if (x + w > binW)
+    return false;
+
+  y = 0;
+  int remaining = w;
+  for (size_t i=index; remaining > 0; ++i) {
+    y = std::max(y, skyline[i].y);
+    if (y + h > binH)
+      return false;
+    remaining -= skyline[i].w;
+  }
+  return true;
+}
+
+// Raises the skyline with a new segment [x, x+w) at height y,
+// shrinking/removing the segments that it shadows.
+static void skyline_add_level(std::vector<SkylineSegment>& skyline,
+                              const size_t index,
+                              const int x, const int y, const int w)
+{
+  skyline.insert(skyline.begin() + index, SkylineSegment{ x, y, w });
+
+  const int right = x + w;
+  for (size_t i=index+1; i<skyline.size(); ) {
+    SkylineSegment& seg = skyline[i];
+    if (seg.x >= right)
+      break;
+    const int shrink = right - seg.x;
+    if (seg.w <= shrink) {
+      skyline.erase(skyline.begin() + i);
+    }
+    else {
+      seg.x += shrink;
+      seg.w -= shrink;
+      break;
+    }
+  }
+
+  // Merge adjacent segments with the same height
+  for (size_t i=0; i+1<skyline.size(); ) {
+    if (skyline[i].y == skyline[i+1].y) {
+      skyline[i].w += skyline[i+1].w;
+      skyline.erase(skyline.begin() + i+1);
+    }
+    else
+      ++i;
+  }
+}
+
+bool PackingRects::packSkyline(const std::vector<Rect*>& rectPtrs,
+                               base::task_token& token)
+{
+  // The <shapePadding> is handled growing each rectangle (and the bin)
+  // by the padding: this way rectangles keep the padding between each
+  // other but don't need it against the right/bottom borders, which
+  // matches what the Region strategy does placing the padded rectangle
+  // flush with the border.
+  const int binW = m_bounds.w + m_shapePadding;
+  const int binH = m_bounds.h + m_shapePadding;
+
+  std::vector<SkylineSegment> skyline;
+  skyline.push_back(SkylineSegment{ 0, 0, binW });
+
+  int i = 0;
+  for (auto* rcPtr : rectPtrs) {
+    if (token.canceled())
+      return false;
+    token.set_progress(float(i) / int(rectPtrs.size()));
+
+    gfx::Rect& rc = *rcPtr;
+    const int w = rc.w + m_shapePadding;
+    const int h = rc.h + m_shapePadding;
+
+    // Bottom-left heuristic: between all the candidate positions (the
+    // start of each skyline segment) choose the one with the lowest
+    // top, breaking ties with the lowest x.
+    int bestX = 0, bestY = 0;
+    size_t bestIndex = skyline.size();
+    for (size_t j=0; j<skyline.size(); ++j) {
+      int y;
+      if (skyline_fits(skyline, j, w, h, binW, binH, y) &&
+          (bestIndex == skyline.size() ||
+           y < bestY ||
+           (y == bestY && skyline[j].x < bestX))) {
+        bestIndex = j;
+        bestX = skyline[j].x;
+        bestY = y;
+      }
+    }
+    if (bestIndex == skyline.size())
+      return false; // There is not enough room for "rc"
+
+    rc = Rect(m_bounds.x + bestX, m_bounds.y + bestY, rc.w, rc.h);
+    skyline_add_level(skyline, bestIndex, bestX, bestY + h, w);
+    ++i;
+  }
+
+  return true;
+}
+
+bool PackingRects::packRegion(const std::vector<Rect*>& rectPtrs,
+                              base::task_token& token)
+{
   gfx::Region rgn(m_bounds);
-  i = 0;
+  int i = 0;
   for (auto* rcPtr : rectPtrs) {
     if (token.canceled())
       return false;
@@ -143,4 +387,112 @@ bool PackingRects::pack(const Size& size,
   return true;
 }
 
+// Removes the free rectangles that are fully contained in another one
+// (MaxRects keeps only maximal rectangles).
+static void prune_free_rects(PackingRects::Rects& freeRects)
+{
+  for (size_t i=0; i<freeRects.size(); ++i) {
+    for (size_t j=0; j<freeRects.size(); ) {
+      if (i != j && freeRects[i].contains(freeRects[j])) {
+        freeRects.erase(freeRects.begin() + j);
+        if (i > j)
+          --i;
+      }
+      else
+        ++j;
+    }
+  }
+}
+
+// Splits every free rectangle that overlaps the just-used one into
+// its (up to four) maximal remainders.
+void PackingRects::splitFreeRects(const Rect& used)
+{
+  Rects result;
+  for (const Rect& fr : m_freeRects) {
+    if (!fr.intersects(used)) {
+      result.push_back(fr);
+      continue;
+    }
+    if (used.x > fr.x)
+      result.push_back(Rect(fr.x, fr.y, used.x - fr.x, fr.h));
+    if (used.x2() < fr.x2())
+      result.push_back(Rect(used.x2(), fr.y, fr.x2() - used.x2(), fr.h));
+    if (used.y > fr.y)
+      result.push_back(Rect(fr.x, fr.y, fr.w, used.y - fr.y));
+    if (used.y2() < fr.y2())
+      result.push_back(Rect(fr.x, used.y2(), fr.w, fr.y2() - used.y2()));
+  }
+  m_freeRects = std::move(result);
+  prune_free_rects(m_freeRects);
+}
+
+void PackingRects::rebuildFreeRects()
+{
+  // Same convention used by packSkyline(): rectangles and bin grown
+  // by <shapePadding>, in coordinates relative to m_bounds.
+  m_freeRects.clear();
+  m_freeRects.push_back(Rect(0, 0,
+                             m_bounds.w + m_shapePadding,
+                             m_bounds.h + m_shapePadding));
+  for (const Rect& rc : m_rects) {
+    splitFreeRects(Rect(rc.x - m_bounds.x,
+                        rc.y - m_bounds.y,
+                        rc.w + m_shapePadding,
+                        rc.h + m_shapePadding));
+  }
+  m_freeRectsValid = true;
+}
+
+void PackingRects::remove(const int i)
+{
+  const Rect rc = m_rects[i];
+  m_rects.erase(m_rects.begin() + i);
+
+  if (!m_freeRectsValid)
+    return; // No successful pack() yet, nothing to give back
+
+  // Give the space back to the free list. Freed space is not merged
+  // with adjacent free rectangles beyond the containment pruning, so
+  // the reuse is approximate: when tryPlace() starts failing the
+  // caller does the full repack anyway.
+  m_freeRects.push_back(Rect(rc.x - m_bounds.x,
+                             rc.y - m_bounds.y,
+                             rc.w + m_shapePadding,
+                             rc.h + m_shapePadding));
+  prune_free_rects(m_freeRects);
+}
+
+bool PackingRects::tryPlace(const Size& sz, Rect* placed)
+{
+  if (!m_freeRectsValid)
+    return false; // Never packed, the caller must do the full pack()
+
+  const int w = sz.w + m_shapePadding;
+  const int h = sz.h + m_shapePadding;
+
+  // Best-area-fit: the free rectangle that leaves the smallest waste
+  size_t best = m_freeRects.size();
+  for (size_t i=0; i<m_freeRects.size(); ++i) {
+    const Rect& fr = m_freeRects[i];
+    if (w <= fr.w && h <= fr.h &&
+        (best == m_freeRects.size() ||
+         fr.w*fr.h < m_freeRects[best].w*m_freeRects[best].h)) {
+      best = i;
+    }
+  }
+  if (best == m_freeRects.size())
+    return false; // Time for a full repack
+
+  const Rect rc(m_bounds.x + m_freeRects[best].x,
+                m_bounds.y + m_freeRects[best].y,
+                sz.w, sz.h);
+  splitFreeRects(Rect(rc.x - m_bounds.x,
+                      rc.y - m_bounds.y, w, h));
+  m_rects.push_back(rc);
+  if (placed)
+    *placed = rc;
+  return true;
+}
+
 } // namespace gfx
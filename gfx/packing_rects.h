@@ -19,9 +19,24 @@ namespace gfx {
   // TODO add support for rotations
   class PackingRects {
   public:
-    PackingRects(int borderPadding = 0, int shapePadding = 0) :
+    // Packing algorithm used by pack()/bestFit():
+    // * Skyline: bottom-left skyline heuristic, places each rectangle
+    //   scanning a list of "roof" segments, fast enough for atlases
+    //   with thousands of sprites.
+    // * Region: original algorithm, scans every candidate position
+    //   against the already-used region. Slower (quadratic on the
+    //   number of placed rectangles) but can reuse holes that the
+    //   skyline leaves behind, so it's kept as a fallback.
+    enum class Strategy {
+      Skyline,
+      Region,
+    };
+
+    PackingRects(int borderPadding = 0, int shapePadding = 0,
+                 Strategy strategy = Strategy::Skyline) :
       m_borderPadding(borderPadding),
-      m_shapePadding(shapePadding) {
+      m_shapePadding(shapePadding),
+      m_strategy(strategy) {
     }
 
     typedef std::vector<Rect> Rects;
@@ -53,12 +68,67 @@ namespace gfx {
     // Returns the bounds of the packed area.
     const Rect& bounds() const { return m_bounds; }
 
+    // Multi-bin packing: splits the rectangles across several pages
+    // of the given fixed size and packs all pages concurrently on the
+    // given thread pool. A size-estimation pre-pass (total padded
+    // area vs. usable page area) chooses the initial page count, so
+    // overflowing one page doesn't mean repacking the same set
+    // several times. Returns the number of pages used, or 0 if the
+    // task was canceled or some rectangle is bigger than a page.
+    //
+    // After a successful call each rectangle is in coordinates
+    // relative to its own page, which can be known with pageOf().
+    int packPages(const Size& pageSize,
+                  base::thread_pool& pool,
+                  base::task_token& token);
+
+    // Number of pages of the last successful packPages() call.
+    int pages() const { return m_pages; }
+
+    // Page where the i-th rectangle was placed by packPages().
+    int pageOf(int i) const { return m_pageOf[i]; }
+
+    // Incremental repacking: after a successful pack() the remaining
+    // free space is tracked, so updating one sprite doesn't need a
+    // full repack of the atlas.
+
+    // Removes the i-th rectangle returning its space to the free
+    // list (following rectangles shift their index down by one).
+    void remove(int i);
+
+    // Tries to place a new rectangle in the current free space
+    // (including the space freed by remove()). On success it's
+    // appended at the end (index size()-1) and true is returned. On
+    // failure nothing changes and the caller should do a full
+    // bestFit()/pack() again.
+    bool tryPlace(const Size& sz, Rect* placed = nullptr);
+
   private:
+    bool packSkyline(const std::vector<Rect*>& rectPtrs,
+                     base::task_token& token);
+    bool packRegion(const std::vector<Rect*>& rectPtrs,
+                    base::task_token& token);
+    void rebuildFreeRects();
+    void splitFreeRects(const Rect& used);
+
     int m_borderPadding;
     int m_shapePadding;
+    Strategy m_strategy;
 
     Rect m_bounds;
     Rects m_rects;
+
+    // Free space of the last successful pack() in bin coordinates
+    // (relative to m_bounds origin, rectangles/bin grown by
+    // m_shapePadding), kept as maximal-rectangles for tryPlace().
+    // Only meaningful while m_freeRectsValid (i.e. after a
+    // successful pack()).
+    Rects m_freeRects;
+    bool m_freeRectsValid = false;
+
+    // Result of the last packPages() call (page per rectangle).
+    int m_pages = 0;
+    std::vector<int> m_pageOf;
   };
 
 } // namespace gfx
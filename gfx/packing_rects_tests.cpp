@@ -13,6 +13,7 @@
 
 #if LAF_WITH_REGION
 
+#include "base/thread_pool.h"
 #include "gfx/packing_rects.h"
 #include "gfx/rect_io.h"
 #include "gfx/size.h"
@@ -120,6 +121,152 @@ TEST(PackingRects, BorderAndShapePadding)
   EXPECT_EQ(Rect(10, 216, 200, 100), pr[2]);
 }
 
+TEST(PackingRects, StrategiesGiveValidPackings)
+{
+  base::task_token token;
+
+  for (auto strategy : { PackingRects::Strategy::Skyline,
+                         PackingRects::Strategy::Region }) {
+    PackingRects pr(0, 2, strategy);
+    for (int i=0; i<100; ++i)
+      pr.add(Size(5 + (i*13) % 40,
+                  5 + (i*7) % 32));
+
+    Size size = pr.bestFit(token);
+    EXPECT_TRUE(pr.pack(size, token));
+
+    // All rectangles must be inside the bounds and cannot overlap
+    // (considering the shape padding) between each other.
+    for (auto it=pr.begin(); it != pr.end(); ++it) {
+      EXPECT_TRUE(pr.bounds().contains(*it));
+      for (auto it2=it+1; it2 != pr.end(); ++it2) {
+        Rect padded(*it);
+        padded.w += 2;
+        padded.h += 2;
+        EXPECT_FALSE(padded.intersects(*it2));
+      }
+    }
+  }
+}
+
+TEST(PackingRects, IncrementalRemoveAndPlace)
+{
+  base::task_token token;
+  PackingRects pr;
+  pr.add(Size(100, 100));
+  pr.add(Size(100, 100));
+  pr.add(Size(100, 100));
+  pr.add(Size(100, 100));
+  EXPECT_TRUE(pr.pack(Size(200, 200), token));
+
+  // The atlas is full, a new rect cannot be placed...
+  EXPECT_FALSE(pr.tryPlace(Size(100, 100)));
+
+  // ...but it can reuse the space of a removed one
+  const Rect freed = pr[1];
+  pr.remove(1);
+  EXPECT_EQ(3, pr.size());
+
+  Rect placed;
+  EXPECT_TRUE(pr.tryPlace(Size(100, 100), &placed));
+  EXPECT_EQ(freed, placed);
+  EXPECT_EQ(placed, pr[3]);
+
+  // A bigger rect doesn't fit and asks for the full repack
+  EXPECT_FALSE(pr.tryPlace(Size(101, 100)));
+}
+
+TEST(PackingRects, IncrementalPlaceInVoidSpace)
+{
+  base::task_token token;
+  PackingRects pr;
+  pr.add(Size(30, 30));
+  EXPECT_TRUE(pr.pack(Size(40, 40), token));
+
+  // Fits in the remaining L-shaped space
+  Rect placed;
+  EXPECT_TRUE(pr.tryPlace(Size(10, 40), &placed));
+  EXPECT_EQ(Rect(30, 0, 10, 40), placed);
+  EXPECT_FALSE(placed.intersects(pr[0]));
+  EXPECT_FALSE(pr.tryPlace(Size(40, 10)));
+}
+
+TEST(PackingRects, RegionStrategy)
+{
+  // The original algorithm is still selectable.
+  base::task_token token;
+  PackingRects pr(0, 0, PackingRects::Strategy::Region);
+  pr.add(Size(256, 128));
+  pr.add(Size(256, 120));
+  EXPECT_TRUE(pr.pack(Size(256, 256), token));
+
+  EXPECT_EQ(Rect(0, 0, 256, 128), pr[0]);
+  EXPECT_EQ(Rect(0, 128, 256, 120), pr[1]);
+}
+
+TEST(PackingRects, PackPages)
+{
+  base::task_token token;
+  base::thread_pool pool(4);
+
+  PackingRects pr;
+  for (int i=0; i<8; ++i)
+    pr.add(Size(100, 100));
+
+  // 8 rectangles of 100x100 need exactly two 200x200 pages
+  EXPECT_EQ(2, pr.packPages(Size(200, 200), pool, token));
+  EXPECT_EQ(2, pr.pages());
+
+  // Every rectangle is inside its page and doesn't overlap other
+  // rectangles of the same page
+  for (int i=0; i<int(pr.size()); ++i) {
+    EXPECT_TRUE(pr.pageOf(i) >= 0 && pr.pageOf(i) < pr.pages());
+    EXPECT_TRUE(Rect(0, 0, 200, 200).contains(pr[i]));
+    for (int j=i+1; j<int(pr.size()); ++j) {
+      if (pr.pageOf(i) == pr.pageOf(j))
+        EXPECT_FALSE(pr[i].intersects(pr[j]));
+    }
+  }
+}
+
+TEST(PackingRects, PackPagesIrregularSizes)
+{
+  base::task_token token;
+  base::thread_pool pool(4);
+
+  PackingRects pr(2, 1);
+  for (int i=0; i<200; ++i)
+    pr.add(Size(5 + (i*13) % 60,
+                5 + (i*7) % 48));
+
+  const int npages = pr.packPages(Size(128, 128), pool, token);
+  ASSERT_GT(npages, 0);
+
+  const Rect pageBounds = Rect(128, 128).shrink(2);
+  for (int i=0; i<int(pr.size()); ++i) {
+    EXPECT_TRUE(pageBounds.contains(pr[i]));
+    for (int j=i+1; j<int(pr.size()); ++j) {
+      if (pr.pageOf(i) == pr.pageOf(j)) {
+        Rect padded(pr[i]);
+        padded.w += 1;
+        padded.h += 1;
+        EXPECT_FALSE(padded.intersects(pr[j]));
+      }
+    }
+  }
+}
+
+TEST(PackingRects, PackPagesRectBiggerThanPage)
+{
+  base::task_token token;
+  base::thread_pool pool(2);
+
+  PackingRects pr;
+  pr.add(Size(300, 100));
+  EXPECT_EQ(0, pr.packPages(Size(200, 200), pool, token));
+  EXPECT_EQ(0, pr.pages());
+}
+
 #endif  // LAF_WITH_REGION
 
 int main(int argc, char** argv)
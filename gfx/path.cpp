@@ -0,0 +1,54 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gfx/path.h"
+
+#include <memory>
+#include <vector>
+
+namespace gfx {
+
+namespace {
+
+// Per-thread freelist of Path objects (no lock needed). Capped so a
+// burst of live paths doesn't pin memory forever.
+const std::size_t kMaxPooledPaths = 128;
+thread_local std::vector<std::unique_ptr<Path>> pathPool;
+
+} // anonymous namespace
+
+PooledPath::PooledPath()
+{
+  if (!pathPool.empty()) {
+    m_path = pathPool.back().release();
+    pathPool.pop_back();
+  }
+  else {
+    m_path = new Path;
+  }
+}
+
+PooledPath::~PooledPath()
+{
+  if (!m_path)
+    return; // Moved-from handle
+
+  if (pathPool.size() < kMaxPooledPaths) {
+    // rewind() clears the path but keeps its allocated storage, which
+    // is the whole point of pooling
+    m_path->rewind();
+    pathPool.push_back(std::unique_ptr<Path>(m_path));
+  }
+  else {
+    delete m_path;
+  }
+}
+
+} // namespace gfx
@@ -14,4 +14,48 @@
   #include "gfx/path_none.h"
 #endif
 
+#include <utility>
+
+namespace gfx {
+
+  // RAII handle over a Path borrowed from a per-thread freelist. The
+  // UI builds/destroys thousands of short-lived paths per frame for
+  // widget outlines, and each fresh SkPath churns its ref-counted
+  // internal storage; a pooled path is rewound on release (rewind()
+  // keeps the allocated storage), so steady-state usage stops hitting
+  // the allocator. Use it exactly like a scoped Path:
+  //
+  //   gfx::PooledPath path;
+  //   path->rect(bounds);
+  //   surface->strokePath(*path, paint);
+  //
+  // The handle (and the Path it references) must not outlive the
+  // thread that created it.
+  class PooledPath {
+  public:
+    PooledPath();
+    ~PooledPath();
+
+    PooledPath(PooledPath&& other) noexcept : m_path(other.m_path) {
+      other.m_path = nullptr;
+    }
+    PooledPath& operator=(PooledPath&& other) noexcept {
+      std::swap(m_path, other.m_path);
+      return *this;
+    }
+
+    PooledPath(const PooledPath&) = delete;
+    PooledPath& operator=(const PooledPath&) = delete;
+
+    Path& operator*() { return *m_path; }
+    const Path& operator*() const { return *m_path; }
+    Path* operator->() { return m_path; }
+    const Path* operator->() const { return m_path; }
+
+  private:
+    Path* m_path;
+  };
+
+} // namespace gfx
+
 #endif
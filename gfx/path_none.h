@@ -8,33 +8,311 @@
 #define GFX_PATH_NONE_H_INCLUDED
 #pragma once
 
+#include "base/ints.h"
+#include "gfx/matrix.h"
 #include "gfx/point.h"
 #include "gfx/rect.h"
 
-namespace gfx {
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
-  class Matrix;
+namespace gfx {
 
+  // Software path for LAF_BACKEND=none builds: stores verbs/points
+  // with the same building API as the SkPath wrapper in path_skia.h,
+  // plus a scanline rasterizer (rasterize()) so headless builds can
+  // fill transformed shapes without Skia.
   class Path {
   public:
     Path() { }
-    Path& reset() { return *this; }
-    Path& rewind() { return *this; }
-    bool isEmpty() const { return true; }
-    Path& moveTo(float x, float y) { return *this; }
-    Path& moveTo(const Point& p) { return *this; }
-    Path& lineTo(float x, float y) { return *this; }
-    Path& lineTo(const Point& p) { return *this; }
-    Path& cubicTo(float dx1, float dy1, float dx2, float dy2, float dx3, float dy3) { return *this; }
-    Path& oval(const Rect& rc) { return *this; }
-    Path& rect(const Rect& rc) { return *this; }
-    Path& roundedRect(const Rect& rc, float rx, float ry) { return *this; }
-    Path& close() { return *this; }
-    void offset(float dx, float dy, Path* dst) const { }
-    void offset(float dx, float dy) { }
-    void transform(const Matrix& matrix, Path* dst) { }
-    void transform(const Matrix& matrix) { }
-    RectF bounds() const { return RectF(); }
+
+    Path& reset() {
+      rewind();
+      m_verbs.shrink_to_fit();
+      m_points.shrink_to_fit();
+      return *this;
+    }
+
+    Path& rewind() {
+      m_verbs.clear();
+      m_points.clear();
+      return *this;
+    }
+
+    bool isEmpty() const {
+      return m_verbs.empty();
+    }
+
+    Path& moveTo(float x, float y) {
+      m_verbs.push_back(Verb::Move);
+      m_points.push_back(PointF(x, y));
+      return *this;
+    }
+
+    Path& moveTo(const Point& p) {
+      return moveTo(float(p.x), float(p.y));
+    }
+
+    Path& lineTo(float x, float y) {
+      m_verbs.push_back(Verb::Line);
+      m_points.push_back(PointF(x, y));
+      return *this;
+    }
+
+    Path& lineTo(const Point& p) {
+      return lineTo(float(p.x), float(p.y));
+    }
+
+    Path& cubicTo(float dx1, float dy1, float dx2, float dy2, float dx3, float dy3) {
+      m_verbs.push_back(Verb::Cubic);
+      m_points.push_back(PointF(dx1, dy1));
+      m_points.push_back(PointF(dx2, dy2));
+      m_points.push_back(PointF(dx3, dy3));
+      return *this;
+    }
+
+    Path& oval(const Rect& rc) {
+      // Four cubic arcs approximating a quarter circle each
+      const double kappa = 0.552284749830793398;
+      const double cx = rc.x + rc.w/2.0;
+      const double cy = rc.y + rc.h/2.0;
+      const double rx = rc.w/2.0;
+      const double ry = rc.h/2.0;
+      const double ox = rx*kappa;
+      const double oy = ry*kappa;
+      moveTo(float(cx+rx), float(cy));
+      cubicTo(float(cx+rx), float(cy+oy), float(cx+ox), float(cy+ry), float(cx), float(cy+ry));
+      cubicTo(float(cx-ox), float(cy+ry), float(cx-rx), float(cy+oy), float(cx-rx), float(cy));
+      cubicTo(float(cx-rx), float(cy-oy), float(cx-ox), float(cy-ry), float(cx), float(cy-ry));
+      cubicTo(float(cx+ox), float(cy-ry), float(cx+rx), float(cy-oy), float(cx+rx), float(cy));
+      return close();
+    }
+
+    Path& rect(const Rect& rc) {
+      moveTo(float(rc.x), float(rc.y));
+      lineTo(float(rc.x+rc.w), float(rc.y));
+      lineTo(float(rc.x+rc.w), float(rc.y+rc.h));
+      lineTo(float(rc.x), float(rc.y+rc.h));
+      return close();
+    }
+
+    Path& roundedRect(const Rect& rc, float rx, float ry) {
+      rx = std::min(rx, rc.w/2.0f);
+      ry = std::min(ry, rc.h/2.0f);
+      if (rx <= 0.0f || ry <= 0.0f)
+        return rect(rc);
+
+      const float kappa = 0.552284749830793398f;
+      const float ox = rx*kappa;
+      const float oy = ry*kappa;
+      const float x1 = float(rc.x), y1 = float(rc.y);
+      const float x2 = float(rc.x+rc.w), y2 = float(rc.y+rc.h);
+      moveTo(x1+rx, y1);
+      lineTo(x2-rx, y1);
+      cubicTo(x2-rx+ox, y1, x2, y1+ry-oy, x2, y1+ry);
+      lineTo(x2, y2-ry);
+      cubicTo(x2, y2-ry+oy, x2-rx+ox, y2, x2-rx, y2);
+      lineTo(x1+rx, y2);
+      cubicTo(x1+rx-ox, y2, x1, y2-ry+oy, x1, y2-ry);
+      lineTo(x1, y1+ry);
+      cubicTo(x1, y1+ry-oy, x1+rx-ox, y1, x1+rx, y1);
+      return close();
+    }
+
+    Path& close() {
+      m_verbs.push_back(Verb::Close);
+      return *this;
+    }
+
+    void offset(float dx, float dy, Path* dst) const {
+      *dst = *this;
+      dst->offset(dx, dy);
+    }
+
+    void offset(float dx, float dy) {
+      for (PointF& p : m_points) {
+        p.x += dx;
+        p.y += dy;
+      }
+    }
+
+    void transform(const Matrix& matrix, Path* dst) {
+      *dst = *this;
+      dst->transform(matrix);
+    }
+
+    void transform(const Matrix& matrix) {
+      for (PointF& p : m_points)
+        p = matrix.mapPoint(p);
+    }
+
+    RectF bounds() const {
+      if (isEmpty())
+        return RectF();
+
+      std::vector<std::vector<PointF>> contours;
+      flatten(contours);
+
+      double x1 = 0.0, y1 = 0.0, x2 = 0.0, y2 = 0.0;
+      bool first = true;
+      for (const auto& contour : contours) {
+        for (const PointF& p : contour) {
+          if (first) {
+            x1 = x2 = p.x;
+            y1 = y2 = p.y;
+            first = false;
+          }
+          else {
+            x1 = std::min(x1, p.x);
+            y1 = std::min(y1, p.y);
+            x2 = std::max(x2, p.x);
+            y2 = std::max(y2, p.y);
+          }
+        }
+      }
+      return RectF(x1, y1, x2-x1, y2-y1);
+    }
+
+    // Scanline-fills the path (nonzero winding, pixel-center
+    // sampling, no anti-aliasing), calling fn(x, y, w) for each
+    // horizontal run of covered pixels, top-down and left-to-right.
+    // Open contours are closed implicitly.
+    template<typename SpanFn>
+    void rasterize(SpanFn&& fn) const {
+      std::vector<std::vector<PointF>> contours;
+      flatten(contours);
+
+      // Edges normalized to y0 < y1, keeping the original direction
+      // for the winding count
+      struct Edge {
+        double x0, y0, x1, y1;
+        int dir;
+      };
+      std::vector<Edge> edges;
+      double minY = 0.0, maxY = 0.0;
+      bool first = true;
+      for (const auto& contour : contours) {
+        const size_t n = contour.size();
+        for (size_t i=0; i<n; ++i) {
+          PointF a = contour[i];
+          PointF b = contour[(i+1) % n]; // implicit closing edge
+          if (a.y == b.y)
+            continue;
+          int dir = 1;
+          if (a.y > b.y) {
+            std::swap(a, b);
+            dir = -1;
+          }
+          edges.push_back(Edge{ a.x, a.y, b.x, b.y, dir });
+          if (first) {
+            minY = a.y;
+            maxY = b.y;
+            first = false;
+          }
+          else {
+            minY = std::min(minY, a.y);
+            maxY = std::max(maxY, b.y);
+          }
+        }
+      }
+      if (edges.empty())
+        return;
+
+      struct Crossing {
+        double x;
+        int dir;
+      };
+      std::vector<Crossing> crossings;
+      const int yBegin = int(std::floor(minY));
+      const int yEnd = int(std::ceil(maxY));
+      for (int y=yBegin; y<yEnd; ++y) {
+        const double yc = y + 0.5;
+        crossings.clear();
+        for (const Edge& e : edges) {
+          if (e.y0 <= yc && yc < e.y1) {
+            crossings.push_back(
+              Crossing{ e.x0 + (yc-e.y0)*(e.x1-e.x0)/(e.y1-e.y0), e.dir });
+          }
+        }
+        std::sort(crossings.begin(), crossings.end(),
+                  [](const Crossing& a, const Crossing& b) {
+                    return a.x < b.x;
+                  });
+
+        int winding = 0;
+        double spanX = 0.0;
+        for (const Crossing& c : crossings) {
+          if (winding == 0)
+            spanX = c.x;
+          winding += c.dir;
+          if (winding == 0) {
+            // Pixels whose center falls inside [spanX, c.x)
+            const int x1 = int(std::ceil(spanX - 0.5));
+            const int x2 = int(std::ceil(c.x - 0.5));
+            if (x2 > x1)
+              fn(x1, y, x2-x1);
+          }
+        }
+      }
+    }
+
+  private:
+    enum class Verb : uint8_t {
+      Move,
+      Line,
+      Cubic,
+      Close,
+    };
+
+    // Flattens the path into polyline contours (cubics are
+    // subdivided uniformly, finer the longer their control polygon).
+    void flatten(std::vector<std::vector<PointF>>& contours) const {
+      const PointF* pt = m_points.data();
+      PointF last(0.0, 0.0);
+      for (const Verb verb : m_verbs) {
+        switch (verb) {
+          case Verb::Move:
+            contours.emplace_back();
+            contours.back().push_back(last = *pt++);
+            break;
+          case Verb::Line:
+            if (contours.empty())
+              contours.emplace_back();
+            contours.back().push_back(last = *pt++);
+            break;
+          case Verb::Cubic: {
+            const PointF p1 = pt[0];
+            const PointF p2 = pt[1];
+            const PointF p3 = pt[2];
+            pt += 3;
+            if (contours.empty())
+              contours.emplace_back();
+
+            const double len =
+              (std::hypot(p1.x-last.x, p1.y-last.y) +
+               std::hypot(p2.x-p1.x, p2.y-p1.y) +
+               std::hypot(p3.x-p2.x, p3.y-p2.y));
+            const int steps = std::clamp(1 + int(len/4.0), 4, 64);
+            for (int i=1; i<=steps; ++i) {
+              const double t = double(i)/steps;
+              const double u = 1.0-t;
+              contours.back().push_back(
+                PointF(u*u*u*last.x + 3*u*u*t*p1.x + 3*u*t*t*p2.x + t*t*t*p3.x,
+                       u*u*u*last.y + 3*u*u*t*p1.y + 3*u*t*t*p2.y + t*t*t*p3.y));
+            }
+            last = p3;
+            break;
+          }
+          case Verb::Close:
+            // Contours are closed implicitly by the consumers
+            break;
+        }
+      }
+    }
+
+    std::vector<Verb> m_verbs;
+    std::vector<PointF> m_points;
   };
 
 } // namespace gfx
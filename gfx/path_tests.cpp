@@ -0,0 +1,148 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/path.h"
+
+using namespace gfx;
+
+TEST(Path, PooledPathReusesStorage)
+{
+  // Warm up the pool and remember which Path object it holds
+  Path* recycled = nullptr;
+  {
+    PooledPath path;
+    path->moveTo(0.0f, 0.0f);
+    path->lineTo(10.0f, 10.0f);
+    recycled = &*path;
+  }
+
+  // The next pooled path is the same (rewound) object
+  {
+    PooledPath path;
+    EXPECT_EQ(recycled, &*path);
+    EXPECT_TRUE(path->isEmpty());
+  }
+
+  // Two live handles can't share one path
+  {
+    PooledPath a, b;
+    EXPECT_NE(&*a, &*b);
+  }
+}
+
+TEST(Path, PooledPathMove)
+{
+  PooledPath a;
+  Path* p = &*a;
+  PooledPath b(std::move(a));
+  EXPECT_EQ(p, &*b);
+
+  PooledPath c;
+  c = std::move(b);
+  EXPECT_EQ(p, &*c);
+}
+
+#if !defined(LAF_SKIA)
+
+// The software Path of the none backend can build, transform and
+// rasterize shapes by itself.
+
+TEST(Path, NoneBackendBounds)
+{
+  Path path;
+  EXPECT_TRUE(path.isEmpty());
+  path.rect(Rect(2, 3, 10, 20));
+  EXPECT_FALSE(path.isEmpty());
+
+  const RectF bounds = path.bounds();
+  EXPECT_DOUBLE_EQ(2.0, bounds.x);
+  EXPECT_DOUBLE_EQ(3.0, bounds.y);
+  EXPECT_DOUBLE_EQ(10.0, bounds.w);
+  EXPECT_DOUBLE_EQ(20.0, bounds.h);
+
+  path.offset(1.0f, -1.0f);
+  EXPECT_DOUBLE_EQ(3.0, path.bounds().x);
+  EXPECT_DOUBLE_EQ(2.0, path.bounds().y);
+}
+
+TEST(Path, NoneBackendTransform)
+{
+  Path path;
+  path.rect(Rect(0, 0, 10, 10));
+  path.transform(Matrix::MakeScale(2.0f));
+
+  const RectF bounds = path.bounds();
+  EXPECT_DOUBLE_EQ(20.0, bounds.w);
+  EXPECT_DOUBLE_EQ(20.0, bounds.h);
+}
+
+TEST(Path, NoneBackendRasterizeRect)
+{
+  Path path;
+  path.rect(Rect(2, 1, 5, 3));
+
+  // A rectangle rasterizes to one span per row covering exactly its
+  // pixels
+  int rows = 0;
+  path.rasterize([&rows](int x, int y, int w) {
+    EXPECT_EQ(2, x);
+    EXPECT_EQ(5, w);
+    EXPECT_EQ(1 + rows, y);
+    ++rows;
+  });
+  EXPECT_EQ(3, rows);
+}
+
+TEST(Path, NoneBackendRasterizeHole)
+{
+  // Two nested rects with opposite winding leave a hole
+  Path path;
+  path.moveTo(0.0f, 0.0f);
+  path.lineTo(10.0f, 0.0f);
+  path.lineTo(10.0f, 10.0f);
+  path.lineTo(0.0f, 10.0f);
+  path.close();
+  path.moveTo(3.0f, 3.0f);
+  path.lineTo(3.0f, 7.0f);
+  path.lineTo(7.0f, 7.0f);
+  path.lineTo(7.0f, 3.0f);
+  path.close();
+
+  int pixels = 0;
+  path.rasterize([&pixels](int x, int y, int w) {
+    pixels += w;
+    // Nothing inside the hole
+    EXPECT_TRUE(y < 3 || y >= 7 || x+w <= 3 || x >= 7);
+  });
+  EXPECT_EQ(100 - 16, pixels);
+}
+
+TEST(Path, NoneBackendRasterizeOval)
+{
+  Path path;
+  path.oval(Rect(0, 0, 100, 100));
+
+  int pixels = 0;
+  path.rasterize([&pixels](int x, int y, int w) {
+    pixels += w;
+  });
+  // Close to pi*r^2
+  EXPECT_NEAR(7854, pixels, 100);
+}
+
+#endif // !LAF_SKIA
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -23,37 +23,37 @@ class RectT {
 public:
   T x, y, w, h;
 
-  T x2() const { return x+w; }
-  T y2() const { return y+h; }
+  constexpr T x2() const { return x+w; }
+  constexpr T y2() const { return y+h; }
 
   // Creates a new empty rectangle with the origin in 0,0.
-  RectT() : x(0), y(0), w(0), h(0) {
+  constexpr RectT() : x(0), y(0), w(0), h(0) {
   }
 
   // Creates a new rectangle with the specified size with the origin in 0,0.
-  RectT(const T& w, const T& h) :
+  constexpr RectT(const T& w, const T& h) :
     x(0), y(0),
     w(w), h(h) {
   }
 
   // Creates a new rectangle with the specified size with the origin in 0,0.
-  explicit RectT(const SizeT<T>& size) :
+  constexpr explicit RectT(const SizeT<T>& size) :
     x(0), y(0),
     w(size.w), h(size.h) {
   }
 
-  RectT(const RectT<T>& rect) :
+  constexpr RectT(const RectT<T>& rect) :
     x(rect.x), y(rect.y),
     w(rect.w), h(rect.h) {
   }
 
   template<typename U>
-  RectT(const RectT<U>& rect) :
+  constexpr RectT(const RectT<U>& rect) :
     x(static_cast<T>(rect.x)), y(static_cast<T>(rect.y)),
     w(static_cast<T>(rect.w)), h(static_cast<T>(rect.h)) {
   }
 
-  RectT(const PointT<T>& point, const SizeT<T>& size) :
+  constexpr RectT(const PointT<T>& point, const SizeT<T>& size) :
     x(point.x), y(point.y),
     w(size.w), h(size.h) {
   }
@@ -71,10 +71,11 @@ public:
   //
   // See that point2 isn't included in the rectangle, it's like the
   // point returned by point2() member function.
-  RectT(const PointT<T>& point1, const PointT<T>& point2) {
+  constexpr RectT(const PointT<T>& point1, const PointT<T>& point2)
+    : x(0), y(0), w(0), h(0) { // (members must be initialized for constexpr)
     PointT<T> leftTop = point1;
     PointT<T> rightBottom = point2;
-    T t;
+    T t = T(0);
 
     if (leftTop.x > rightBottom.x) {
       t = leftTop.x;
@@ -94,81 +95,81 @@ public:
     this->h = rightBottom.y - leftTop.y;
   }
 
-  RectT(const T& x, const T& y, const T& w, const T& h) : x(x), y(y), w(w), h(h) {
+  constexpr RectT(const T& x, const T& y, const T& w, const T& h) : x(x), y(y), w(w), h(h) {
   }
 
   // Verifies if the width and/or height of the rectangle are less or
   // equal than zero.
-  bool isEmpty() const {
+  constexpr bool isEmpty() const {
     return (w <= 0 || h <= 0);
   }
 
   // Returns the middle point of the rectangle (x+w/2, y+h/2).
-  PointT<T> center() const {
+  constexpr PointT<T> center() const {
     return PointT<T>(x+w/2, y+h/2);
   }
 
   // Returns the point in the upper-left corner (that is inside the
   // rectangle).
-  PointT<T> origin() const {
+  constexpr PointT<T> origin() const {
     return PointT<T>(x, y);
   }
 
   // Returns point in the lower-right corner that is outside the
   // rectangle (x+w, y+h).
-  PointT<T> point2() const {
+  constexpr PointT<T> point2() const {
     return PointT<T>(x+w, y+h);
   }
 
-  SizeT<T> size() const {
+  constexpr SizeT<T> size() const {
     return SizeT<T>(w, h);
   }
 
-  RectT& setOrigin(const PointT<T>& pt) {
+  constexpr RectT& setOrigin(const PointT<T>& pt) {
     x = pt.x;
     y = pt.y;
     return *this;
   }
 
-  RectT& setSize(const SizeT<T>& sz) {
+  constexpr RectT& setSize(const SizeT<T>& sz) {
     w = sz.w;
     h = sz.h;
     return *this;
   }
 
   // Moves the rectangle origin in the specified delta.
-  RectT& offset(const T& dx, const T& dy) {
+  constexpr RectT& offset(const T& dx, const T& dy) {
     x += dx;
     y += dy;
     return *this;
   }
 
   template<typename U>
-  RectT& offset(const PointT<U>& delta) {
+  constexpr RectT& offset(const PointT<U>& delta) {
     x += delta.x;
     y += delta.y;
     return *this;
   }
 
-  RectT& inflate(const T& delta) {
+  constexpr RectT& inflate(const T& delta) {
     w += delta;
     h += delta;
     return *this;
   }
 
-  RectT& inflate(const T& dw, const T& dh) {
+  constexpr RectT& inflate(const T& dw, const T& dh) {
     w += dw;
     h += dh;
     return *this;
   }
 
-  RectT& inflate(const SizeT<T>& delta) {
+  constexpr RectT& inflate(const SizeT<T>& delta) {
     w += delta.w;
     h += delta.h;
     return *this;
   }
 
-  RectT& enlarge(const T& unit) {
+  constexpr RectT& enlarge(const T& unit) {
     x -= unit;
     y -= unit;
     w += unit*2;
@@ -176,7 +177,7 @@ public:
     return *this;
   }
 
-  RectT& enlarge(const BorderT<T>& br) {
+  constexpr RectT& enlarge(const BorderT<T>& br) {
     x -= br.left();
     y -= br.top();
     w += br.left() + br.right();
@@ -184,19 +185,19 @@ public:
     return *this;
   }
 
-  RectT& enlargeXW(const T& unit) {
+  constexpr RectT& enlargeXW(const T& unit) {
     x -= unit;
     w += unit*2;
     return *this;
   }
 
-  RectT& enlargeYH(const T& unit) {
+  constexpr RectT& enlargeYH(const T& unit) {
     y -= unit;
     h += unit*2;
     return *this;
   }
 
-  RectT& shrink(const T& unit) {
+  constexpr RectT& shrink(const T& unit) {
     x += unit;
     y += unit;
     w -= unit*2;
@@ -204,7 +205,7 @@ public:
     return *this;
   }
 
-  RectT& shrink(const BorderT<T>& br) {
+  constexpr RectT& shrink(const BorderT<T>& br) {
     x += br.left();
     y += br.top();
     w -= br.left() + br.right();
@@ -240,20 +241,20 @@ public:
   }
 
   // Returns true if this rectangle encloses the pt point.
-  bool contains(const PointT<T>& pt) const {
+  constexpr bool contains(const PointT<T>& pt) const {
     return
       pt.x >= x && pt.x < x+w &&
       pt.y >= y && pt.y < y+h;
   }
 
-  bool contains(const T& u, const T& v) const {
+  constexpr bool contains(const T& u, const T& v) const {
     return
       u >= x && u < x+w &&
       v >= y && v < y+h;
   }
 
   // Returns true if this rectangle entirely contains the rc rectangle.
-  bool contains(const RectT& rc) const {
+  constexpr bool contains(const RectT& rc) const {
     if (isEmpty() || rc.isEmpty())
       return false;
 
@@ -264,7 +265,7 @@ public:
 
   // Returns true if the intersection between this rectangle with rc
   // rectangle is not empty.
-  bool intersects(const RectT& rc) const {
+  constexpr bool intersects(const RectT& rc) const {
     if (isEmpty() || rc.isEmpty())
       return false;
 
@@ -274,7 +275,7 @@ public:
   }
 
   // Returns the union rectangle between this and rc rectangle.
-  RectT createUnion(const RectT& rc) const {
+  constexpr RectT createUnion(const RectT& rc) const {
     if (isEmpty())
       return rc;
     if (rc.isEmpty())
@@ -286,7 +287,7 @@ public:
   }
 
   // Returns the intersection rectangle between this and rc rectangles.
-  RectT createIntersection(const RectT& rc) const {
+  constexpr RectT createIntersection(const RectT& rc) const {
     if (intersects(rc))
       return RectT(PointT<T>(x > rc.x ? x: rc.x,
                              y > rc.y ? y: rc.y),
@@ -295,17 +296,17 @@ public:
     return RectT();
   }
 
-  const RectT& operator+=(const BorderT<T>& br) {
+  constexpr const RectT& operator+=(const BorderT<T>& br) {
     enlarge(br);
     return *this;
   }
 
-  const RectT& operator-=(const BorderT<T>& br) {
+  constexpr const RectT& operator-=(const BorderT<T>& br) {
     shrink(br);
     return *this;
   }
 
-  RectT& operator*=(const T factor) {
+  constexpr RectT& operator*=(const T factor) {
     x *= factor;
     y *= factor;
     w *= factor;
@@ -313,7 +314,7 @@ public:
     return *this;
   }
 
-  RectT& operator/=(const T factor) {
+  constexpr RectT& operator/=(const T factor) {
     x /= factor;
     y /= factor;
     w /= factor;
@@ -321,7 +322,7 @@ public:
     return *this;
   }
 
-  RectT& operator*=(const SizeT<T>& size) {
+  constexpr RectT& operator*=(const SizeT<T>& size) {
     x *= size.w;
     y *= size.h;
     w *= size.w;
@@ -329,7 +330,7 @@ public:
     return *this;
   }
 
-  RectT& operator/=(const SizeT<T>& size) {
+  constexpr RectT& operator/=(const SizeT<T>& size) {
     x /= size.w;
     y /= size.h;
     w /= size.w;
@@ -337,63 +338,63 @@ public:
     return *this;
   }
 
-  const RectT& operator|=(const RectT& rc) {
+  constexpr const RectT& operator|=(const RectT& rc) {
     return *this = createUnion(rc);
   }
 
-  const RectT& operator&=(const RectT& rc) {
+  constexpr const RectT& operator&=(const RectT& rc) {
     return *this = createIntersection(rc);
   }
 
-  RectT operator+(const BorderT<T>& br) const {
+  constexpr RectT operator+(const BorderT<T>& br) const {
     return RectT(*this).enlarge(br);
   }
 
-  RectT operator-(const BorderT<T>& br) const {
+  constexpr RectT operator-(const BorderT<T>& br) const {
     return RectT(*this).shrink(br);
   }
 
-  RectT operator|(const RectT& other) const {
+  constexpr RectT operator|(const RectT& other) const {
     return createUnion(other);
   }
 
-  RectT operator&(const RectT& other) const {
+  constexpr RectT operator&(const RectT& other) const {
     return createIntersection(other);
   }
 
-  RectT operator*(const T factor) const {
+  constexpr RectT operator*(const T factor) const {
     return RectT(x*factor, y*factor,
                  w*factor, h*factor);
   }
 
-  RectT operator*(const SizeT<T>& size) const {
+  constexpr RectT operator*(const SizeT<T>& size) const {
     return RectT(x*size.w, y*size.h,
                  w*size.w, h*size.h);
   }
 
-  RectT operator/(const T scale) const {
+  constexpr RectT operator/(const T scale) const {
     return RectT(x/scale, y/scale,
                  w/scale, h/scale);
   }
 
-  RectT operator/(const SizeT<T>& size) const {
+  constexpr RectT operator/(const SizeT<T>& size) const {
     return RectT(x/size.w, y/size.h,
                  w/size.w, h/size.h);
   }
 
-  bool operator==(const RectT& rc) const {
+  constexpr bool operator==(const RectT& rc) const {
     return
       x == rc.x && w == rc.w &&
       y == rc.y && h == rc.h;
   }
 
-  bool operator!=(const RectT& rc) const {
+  constexpr bool operator!=(const RectT& rc) const {
     return
       x != rc.x || w != rc.w ||
       y != rc.y || h != rc.h;
   }
 
-  RectT& fitIn(const RectT& bounds) {
+  constexpr RectT& fitIn(const RectT& bounds) {
     if (w < h) {
       w = w * bounds.h / h;
       x = bounds.x + bounds.w/2 - w/2;
@@ -0,0 +1,180 @@
+// LAF Gfx Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gfx/rect_index.h"
+
+#include <algorithm>
+
+namespace gfx {
+
+namespace {
+
+// Reasonable cell for typical widget sizes when there is nothing to
+// measure yet.
+const int kDefaultCellSize = 64;
+
+// Grid cell containing the coordinate (floor division, so negative
+// coordinates work too).
+inline int cell_of(const int v, const int cellSize)
+{
+  return (v >= 0 ? v/cellSize: (v+1)/cellSize - 1);
+}
+
+} // anonymous namespace
+
+RectIndex::RectIndex()
+  : m_cellSize(kDefaultCellSize)
+{
+}
+
+void RectIndex::build(const Rect* rects, const std::size_t n)
+{
+  m_rects.clear();
+  m_freeIds.clear();
+  m_cells.clear();
+  m_count = 0;
+
+  // Cell size ~ average rectangle side, so most rectangles land in a
+  // few cells and most cells hold a few rectangles.
+  long long total = 0;
+  std::size_t measured = 0;
+  for (std::size_t i=0; i<n; ++i) {
+    if (!rects[i].isEmpty()) {
+      total += std::max(rects[i].w, rects[i].h);
+      ++measured;
+    }
+  }
+  m_cellSize = (measured > 0 ? std::max(8, int(total / measured)):
+                               kDefaultCellSize);
+
+  m_rects.reserve(n);
+  for (std::size_t i=0; i<n; ++i)
+    add(rects[i]);
+}
+
+int RectIndex::add(const Rect& bounds)
+{
+  int id;
+  if (!m_freeIds.empty()) {
+    id = m_freeIds.back();
+    m_freeIds.pop_back();
+  }
+  else {
+    id = int(m_rects.size());
+    m_rects.push_back(Item());
+  }
+  m_rects[id].bounds = bounds;
+  m_rects[id].valid = true;
+  ++m_count;
+  insertInCells(id, bounds);
+  return id;
+}
+
+void RectIndex::remove(const int id)
+{
+  removeFromCells(id, m_rects[id].bounds);
+  m_rects[id].valid = false;
+  m_freeIds.push_back(id);
+  --m_count;
+}
+
+void RectIndex::update(const int id, const Rect& bounds)
+{
+  removeFromCells(id, m_rects[id].bounds);
+  m_rects[id].bounds = bounds;
+  insertInCells(id, bounds);
+}
+
+void RectIndex::query(const Point& pt, std::vector<int>& ids) const
+{
+  // A point falls in exactly one cell, so no deduplication is needed
+  const auto it = m_cells.find(cellKey(cell_of(pt.x, m_cellSize),
+                                       cell_of(pt.y, m_cellSize)));
+  if (it == m_cells.end())
+    return;
+
+  const std::size_t first = ids.size();
+  for (const int id : it->second) {
+    if (m_rects[id].valid &&
+        m_rects[id].bounds.contains(pt)) {
+      ids.push_back(id);
+    }
+  }
+  std::sort(ids.begin()+first, ids.end());
+}
+
+void RectIndex::query(const Rect& rc, std::vector<int>& ids) const
+{
+  if (rc.isEmpty())
+    return;
+
+  const std::size_t first = ids.size();
+  const int cx1 = cell_of(rc.x, m_cellSize);
+  const int cy1 = cell_of(rc.y, m_cellSize);
+  const int cx2 = cell_of(rc.x2()-1, m_cellSize);
+  const int cy2 = cell_of(rc.y2()-1, m_cellSize);
+
+  for (int cy=cy1; cy<=cy2; ++cy) {
+    for (int cx=cx1; cx<=cx2; ++cx) {
+      const auto it = m_cells.find(cellKey(cx, cy));
+      if (it == m_cells.end())
+        continue;
+      for (const int id : it->second) {
+        if (m_rects[id].valid &&
+            m_rects[id].bounds.intersects(rc)) {
+          ids.push_back(id);
+        }
+      }
+    }
+  }
+
+  // A rectangle spanning several cells is reported once per cell;
+  // sort+unique the new portion of the output.
+  std::sort(ids.begin()+first, ids.end());
+  ids.erase(std::unique(ids.begin()+first, ids.end()), ids.end());
+}
+
+void RectIndex::insertInCells(const int id, const Rect& rc)
+{
+  if (rc.isEmpty())
+    return;
+
+  const int cx1 = cell_of(rc.x, m_cellSize);
+  const int cy1 = cell_of(rc.y, m_cellSize);
+  const int cx2 = cell_of(rc.x2()-1, m_cellSize);
+  const int cy2 = cell_of(rc.y2()-1, m_cellSize);
+  for (int cy=cy1; cy<=cy2; ++cy)
+    for (int cx=cx1; cx<=cx2; ++cx)
+      m_cells[cellKey(cx, cy)].push_back(id);
+}
+
+void RectIndex::removeFromCells(const int id, const Rect& rc)
+{
+  if (rc.isEmpty())
+    return;
+
+  const int cx1 = cell_of(rc.x, m_cellSize);
+  const int cy1 = cell_of(rc.y, m_cellSize);
+  const int cx2 = cell_of(rc.x2()-1, m_cellSize);
+  const int cy2 = cell_of(rc.y2()-1, m_cellSize);
+  for (int cy=cy1; cy<=cy2; ++cy) {
+    for (int cx=cx1; cx<=cx2; ++cx) {
+      const auto it = m_cells.find(cellKey(cx, cy));
+      if (it == m_cells.end())
+        continue;
+      auto& cell = it->second;
+      cell.erase(std::remove(cell.begin(), cell.end(), id), cell.end());
+      if (cell.empty())
+        m_cells.erase(it);
+    }
+  }
+}
+
+} // namespace gfx
@@ -0,0 +1,74 @@
+// LAF Gfx Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_RECT_INDEX_H_INCLUDED
+#define GFX_RECT_INDEX_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx {
+
+  // Uniform-grid spatial index over rectangles for hit-testing (e.g.
+  // picking the widgets under the mouse without testing every widget
+  // bounds on each mouse move). Rectangles are identified by the int
+  // id returned from add() (ids are dense and reused after remove()),
+  // queries report ids in increasing order. The grid cell size is
+  // derived from the average rectangle size on build(), so a point
+  // query touches one cell with a handful of candidates.
+  class RectIndex {
+  public:
+    RectIndex();
+
+    // Rebuilds the index from scratch with the given rectangles
+    // (assigned ids 0..n-1), sizing the grid for them.
+    void build(const Rect* rects, std::size_t n);
+    void build(const std::vector<Rect>& rects) {
+      build(rects.data(), rects.size());
+    }
+
+    // Incremental updates
+    int add(const Rect& bounds);
+    void remove(int id);
+    void update(int id, const Rect& bounds);
+
+    std::size_t size() const { return m_count; }
+    const Rect& bounds(int id) const { return m_rects[id].bounds; }
+
+    // Appends to "ids" the id of each rectangle containing the point
+    // / overlapping the rect.
+    void query(const Point& pt, std::vector<int>& ids) const;
+    void query(const Rect& rc, std::vector<int>& ids) const;
+
+  private:
+    struct Item {
+      Rect bounds;
+      bool valid = false;
+    };
+
+    void insertInCells(int id, const Rect& rc);
+    void removeFromCells(int id, const Rect& rc);
+
+    static uint64_t cellKey(const int cx, const int cy) {
+      return ((uint64_t(uint32_t(cx)) << 32) | uint64_t(uint32_t(cy)));
+    }
+
+    std::vector<Item> m_rects;
+    std::vector<int> m_freeIds;
+    std::unordered_map<uint64_t, std::vector<int>> m_cells;
+    std::size_t m_count = 0;
+    int m_cellSize;
+  };
+
+} // namespace gfx
+
+#endif
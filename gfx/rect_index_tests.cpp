@@ -0,0 +1,140 @@
+// LAF Gfx Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/rect_index.h"
+
+using namespace gfx;
+
+TEST(RectIndex, PointQuery)
+{
+  std::vector<Rect> rects = {
+    Rect(0, 0, 10, 10),
+    Rect(5, 5, 10, 10),
+    Rect(100, 100, 20, 20),
+  };
+  RectIndex index;
+  index.build(rects);
+  EXPECT_EQ(3, index.size());
+
+  std::vector<int> ids;
+  index.query(Point(7, 7), ids);
+  ASSERT_EQ(2, ids.size());
+  EXPECT_EQ(0, ids[0]);
+  EXPECT_EQ(1, ids[1]);
+
+  ids.clear();
+  index.query(Point(50, 50), ids);
+  EXPECT_TRUE(ids.empty());
+
+  ids.clear();
+  index.query(Point(110, 110), ids);
+  ASSERT_EQ(1, ids.size());
+  EXPECT_EQ(2, ids[0]);
+}
+
+TEST(RectIndex, RectQueryDeduplicates)
+{
+  // One big rect spans many grid cells but must be reported once
+  std::vector<Rect> rects = {
+    Rect(0, 0, 1000, 1000),
+    Rect(10, 10, 5, 5),
+  };
+  RectIndex index;
+  index.build(rects);
+
+  std::vector<int> ids;
+  index.query(Rect(0, 0, 500, 500), ids);
+  ASSERT_EQ(2, ids.size());
+  EXPECT_EQ(0, ids[0]);
+  EXPECT_EQ(1, ids[1]);
+}
+
+TEST(RectIndex, IncrementalUpdates)
+{
+  RectIndex index;
+  const int a = index.add(Rect(0, 0, 10, 10));
+  const int b = index.add(Rect(20, 0, 10, 10));
+  EXPECT_EQ(2, index.size());
+
+  std::vector<int> ids;
+  index.query(Point(5, 5), ids);
+  ASSERT_EQ(1, ids.size());
+  EXPECT_EQ(a, ids[0]);
+
+  // Moving a rect moves its hits
+  index.update(a, Rect(40, 0, 10, 10));
+  ids.clear();
+  index.query(Point(5, 5), ids);
+  EXPECT_TRUE(ids.empty());
+  ids.clear();
+  index.query(Point(45, 5), ids);
+  ASSERT_EQ(1, ids.size());
+  EXPECT_EQ(a, ids[0]);
+
+  // Removed rects disappear and their id is reused
+  index.remove(b);
+  EXPECT_EQ(1, index.size());
+  ids.clear();
+  index.query(Point(25, 5), ids);
+  EXPECT_TRUE(ids.empty());
+  EXPECT_EQ(b, index.add(Rect(20, 0, 10, 10)));
+}
+
+TEST(RectIndex, MatchesLinearScan)
+{
+  // Pseudo-random layout: every query must agree with a brute-force
+  // Rect::contains()/intersects() scan
+  std::vector<Rect> rects;
+  uint32_t seed = 123456789;
+  auto next = [&seed]{ return (seed = seed*1103515245 + 12345) >> 16; };
+  for (int i=0; i<500; ++i) {
+    rects.push_back(Rect(int(next() % 800) - 100,
+                         int(next() % 800) - 100,
+                         1 + int(next() % 120),
+                         1 + int(next() % 80)));
+  }
+  RectIndex index;
+  index.build(rects);
+
+  for (int i=0; i<100; ++i) {
+    const Point pt(int(next() % 900) - 150, int(next() % 900) - 150);
+    std::vector<int> ids;
+    index.query(pt, ids);
+
+    std::vector<int> expected;
+    for (int j=0; j<int(rects.size()); ++j) {
+      if (rects[j].contains(pt))
+        expected.push_back(j);
+    }
+    EXPECT_EQ(expected, ids);
+  }
+
+  for (int i=0; i<50; ++i) {
+    const Rect rc(int(next() % 900) - 150, int(next() % 900) - 150,
+                  1 + int(next() % 200), 1 + int(next() % 200));
+    std::vector<int> ids;
+    index.query(rc, ids);
+
+    std::vector<int> expected;
+    for (int j=0; j<int(rects.size()); ++j) {
+      if (rects[j].intersects(rc))
+        expected.push_back(j);
+    }
+    EXPECT_EQ(expected, ids);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
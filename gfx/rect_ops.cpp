@@ -0,0 +1,202 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gfx/rect_ops.h"
+
+#include "gfx/point.h"
+
+#include <climits>
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace gfx {
+
+#if defined(__SSE2__)
+
+static_assert(sizeof(Rect) == 4*sizeof(int32_t),
+              "SIMD kernels assume a Rect is four packed int32");
+
+// SSE2 doesn't have 32-bit integer min/max, emulate them with a
+// compare + blend.
+static inline __m128i min_epi32(const __m128i a, const __m128i b)
+{
+  const __m128i m = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a));
+}
+
+static inline __m128i max_epi32(const __m128i a, const __m128i b)
+{
+  const __m128i m = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+
+// Loads 4 rects and transposes them into x/y/w/h vectors (one rect
+// per lane).
+static inline void load_rects_4(const Rect* rects,
+                                __m128i& x, __m128i& y,
+                                __m128i& w, __m128i& h)
+{
+  const __m128i r0 = _mm_loadu_si128((const __m128i*)(rects+0));
+  const __m128i r1 = _mm_loadu_si128((const __m128i*)(rects+1));
+  const __m128i r2 = _mm_loadu_si128((const __m128i*)(rects+2));
+  const __m128i r3 = _mm_loadu_si128((const __m128i*)(rects+3));
+  const __m128i t0 = _mm_unpacklo_epi32(r0, r1); // x0 x1 y0 y1
+  const __m128i t1 = _mm_unpacklo_epi32(r2, r3); // x2 x3 y2 y3
+  const __m128i t2 = _mm_unpackhi_epi32(r0, r1); // w0 w1 h0 h1
+  const __m128i t3 = _mm_unpackhi_epi32(r2, r3); // w2 w3 h2 h3
+  x = _mm_unpacklo_epi64(t0, t1);
+  y = _mm_unpackhi_epi64(t0, t1);
+  w = _mm_unpacklo_epi64(t2, t3);
+  h = _mm_unpackhi_epi64(t2, t3);
+}
+
+// Transposes the x/y/w/h vectors back and stores 4 rects.
+static inline void store_rects_4(Rect* rects,
+                                 const __m128i x, const __m128i y,
+                                 const __m128i w, const __m128i h)
+{
+  const __m128i t0 = _mm_unpacklo_epi32(x, y); // x0 y0 x1 y1
+  const __m128i t1 = _mm_unpackhi_epi32(x, y); // x2 y2 x3 y3
+  const __m128i t2 = _mm_unpacklo_epi32(w, h); // w0 h0 w1 h1
+  const __m128i t3 = _mm_unpackhi_epi32(w, h); // w2 h2 w3 h3
+  _mm_storeu_si128((__m128i*)(rects+0), _mm_unpacklo_epi64(t0, t2));
+  _mm_storeu_si128((__m128i*)(rects+1), _mm_unpackhi_epi64(t0, t2));
+  _mm_storeu_si128((__m128i*)(rects+2), _mm_unpacklo_epi64(t1, t3));
+  _mm_storeu_si128((__m128i*)(rects+3), _mm_unpackhi_epi64(t1, t3));
+}
+
+// Mask of lanes whose rect is empty (w <= 0 or h <= 0)
+static inline __m128i empty_mask(const __m128i w, const __m128i h)
+{
+  const __m128i one = _mm_set1_epi32(1);
+  return _mm_or_si128(_mm_cmpgt_epi32(one, w),
+                      _mm_cmpgt_epi32(one, h));
+}
+
+#endif // __SSE2__
+
+Rect union_all(const Rect* rects, const std::size_t n)
+{
+  int x1 = INT_MAX, y1 = INT_MAX;
+  int x2 = INT_MIN, y2 = INT_MIN;
+  std::size_t i = 0;
+
+#if defined(__SSE2__)
+  if (n >= 4) {
+    // Accumulate the min/max of 4 rects per iteration, replacing the
+    // coordinates of empty rects with the min/max identities.
+    __m128i minX = _mm_set1_epi32(INT_MAX), minY = minX;
+    __m128i maxX = _mm_set1_epi32(INT_MIN), maxY = maxX;
+    for (; i+4 <= n; i += 4) {
+      __m128i x, y, w, h;
+      load_rects_4(rects+i, x, y, w, h);
+
+      const __m128i empty = empty_mask(w, h);
+      const __m128i vmax = _mm_set1_epi32(INT_MAX);
+      const __m128i vmin = _mm_set1_epi32(INT_MIN);
+
+      minX = min_epi32(minX, _mm_or_si128(_mm_and_si128(empty, vmax),
+                                          _mm_andnot_si128(empty, x)));
+      minY = min_epi32(minY, _mm_or_si128(_mm_and_si128(empty, vmax),
+                                          _mm_andnot_si128(empty, y)));
+      maxX = max_epi32(maxX, _mm_or_si128(_mm_and_si128(empty, vmin),
+                                          _mm_andnot_si128(empty, _mm_add_epi32(x, w))));
+      maxY = max_epi32(maxY, _mm_or_si128(_mm_and_si128(empty, vmin),
+                                          _mm_andnot_si128(empty, _mm_add_epi32(y, h))));
+    }
+
+    // Horizontal reduction of the 4 lanes
+    int32_t lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, minX);
+    for (int j=0; j<4; ++j) x1 = std::min(x1, lanes[j]);
+    _mm_storeu_si128((__m128i*)lanes, minY);
+    for (int j=0; j<4; ++j) y1 = std::min(y1, lanes[j]);
+    _mm_storeu_si128((__m128i*)lanes, maxX);
+    for (int j=0; j<4; ++j) x2 = std::max(x2, lanes[j]);
+    _mm_storeu_si128((__m128i*)lanes, maxY);
+    for (int j=0; j<4; ++j) y2 = std::max(y2, lanes[j]);
+  }
+#endif
+
+  for (; i<n; ++i) {
+    const Rect& rc = rects[i];
+    if (rc.isEmpty())
+      continue;
+    x1 = std::min(x1, rc.x);
+    y1 = std::min(y1, rc.y);
+    x2 = std::max(x2, rc.x2());
+    y2 = std::max(y2, rc.y2());
+  }
+
+  if (x2 <= x1 || y2 <= y1)
+    return Rect(); // All rectangles were empty
+  return Rect(x1, y1, x2-x1, y2-y1);
+}
+
+std::size_t intersect_each(Rect* rects, const std::size_t n, const Rect& clip)
+{
+  std::size_t left = 0;
+  std::size_t i = 0;
+
+  if (clip.isEmpty()) {
+    for (; i<n; ++i)
+      rects[i] = Rect();
+    return 0;
+  }
+
+#if defined(__SSE2__)
+  if (n >= 4) {
+    const __m128i clipX1 = _mm_set1_epi32(clip.x);
+    const __m128i clipY1 = _mm_set1_epi32(clip.y);
+    const __m128i clipX2 = _mm_set1_epi32(clip.x2());
+    const __m128i clipY2 = _mm_set1_epi32(clip.y2());
+
+    for (; i+4 <= n; i += 4) {
+      __m128i x, y, w, h;
+      load_rects_4(rects+i, x, y, w, h);
+
+      const __m128i wasEmpty = empty_mask(w, h);
+      const __m128i x1 = max_epi32(x, clipX1);
+      const __m128i y1 = max_epi32(y, clipY1);
+      const __m128i x2 = min_epi32(_mm_add_epi32(x, w), clipX2);
+      const __m128i y2 = min_epi32(_mm_add_epi32(y, h), clipY2);
+
+      __m128i newW = _mm_sub_epi32(x2, x1);
+      __m128i newH = _mm_sub_epi32(y2, y1);
+
+      // Rects without intersection (or already empty) become
+      // Rect(0, 0, 0, 0), like Rect::createIntersection()
+      const __m128i empty = _mm_or_si128(wasEmpty, empty_mask(newW, newH));
+      store_rects_4(rects+i,
+                    _mm_andnot_si128(empty, x1),
+                    _mm_andnot_si128(empty, y1),
+                    _mm_andnot_si128(empty, newW),
+                    _mm_andnot_si128(empty, newH));
+
+      // empty has -1 in each empty lane: count survivors from the sum
+      int32_t lanes[4];
+      _mm_storeu_si128((__m128i*)lanes, empty);
+      left += 4 + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+  }
+#endif
+
+  for (; i<n; ++i) {
+    rects[i] = rects[i].createIntersection(clip);
+    if (!rects[i].isEmpty())
+      ++left;
+  }
+
+  return left;
+}
+
+} // namespace gfx
@@ -0,0 +1,44 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_RECT_OPS_H_INCLUDED
+#define GFX_RECT_OPS_H_INCLUDED
+#pragma once
+
+#include "gfx/rect.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace gfx {
+
+  // Batch rectangle operations for code that processes thousands of
+  // rectangles per frame (e.g. a damage tracker), vectorized with
+  // SIMD where available. Semantics match the per-rect
+  // Rect::createUnion()/createIntersection().
+
+  // Returns the bounding union of all the given rectangles (empty
+  // rectangles are ignored, like in Rect::createUnion()).
+  Rect union_all(const Rect* rects, std::size_t n);
+
+  inline Rect union_all(const std::vector<Rect>& rects) {
+    return union_all(rects.data(), rects.size());
+  }
+
+  // Clips each rectangle in-place with the given clip rectangle.
+  // Rectangles that don't intersect the clip become empty
+  // (Rect(0, 0, 0, 0), like Rect::createIntersection() returns).
+  // Returns the number of non-empty rectangles left, e.g. to build a
+  // gfx::Region from the survivors.
+  std::size_t intersect_each(Rect* rects, std::size_t n, const Rect& clip);
+
+  inline std::size_t intersect_each(std::vector<Rect>& rects, const Rect& clip) {
+    return intersect_each(rects.data(), rects.size(), clip);
+  }
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,100 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/point.h"
+#include "gfx/rect_io.h"
+#include "gfx/rect_ops.h"
+
+#include <vector>
+
+using namespace gfx;
+
+TEST(RectOps, UnionAll)
+{
+  EXPECT_EQ(Rect(), union_all(nullptr, 0));
+
+  std::vector<Rect> rects = {
+    Rect(10, 10, 5, 5),
+    Rect(),                     // Empty rects are ignored
+    Rect(-3, 2, 4, 1),
+    Rect(0, 0, 1, 30),
+    Rect(20, 20, 0, 10),        // w=0, also empty
+    Rect(7, -8, 2, 2),
+  };
+  EXPECT_EQ(Rect(-3, -8, 18, 38), union_all(rects));
+
+  // Matches chaining Rect::createUnion() for any count (exercises the
+  // SIMD main loop and the scalar tail)
+  for (int n=1; n<=35; ++n) {
+    std::vector<Rect> batch;
+    Rect expected;
+    for (int i=0; i<n; ++i) {
+      Rect rc(i*7 - 50, i*3 - 20, i % 5, (i+2) % 7);
+      batch.push_back(rc);
+      expected = expected.createUnion(rc);
+    }
+    // (if every rect was empty union_all() returns Rect() while the
+    // createUnion() chain keeps the last operand, so compare
+    // emptiness in that case)
+    if (expected.isEmpty())
+      EXPECT_TRUE(union_all(batch).isEmpty()) << "n=" << n;
+    else
+      EXPECT_EQ(expected, union_all(batch)) << "n=" << n;
+  }
+}
+
+TEST(RectOps, IntersectEach)
+{
+  const Rect clip(0, 0, 100, 100);
+  std::vector<Rect> rects = {
+    Rect(-10, -10, 20, 20),     // Partially inside
+    Rect(40, 40, 10, 10),       // Fully inside
+    Rect(200, 200, 10, 10),     // Fully outside
+    Rect(),                     // Already empty
+    Rect(90, 90, 50, 50),       // Partially inside
+  };
+  EXPECT_EQ(3, intersect_each(rects, clip));
+  EXPECT_EQ(Rect(0, 0, 10, 10), rects[0]);
+  EXPECT_EQ(Rect(40, 40, 10, 10), rects[1]);
+  EXPECT_EQ(Rect(), rects[2]);
+  EXPECT_EQ(Rect(), rects[3]);
+  EXPECT_EQ(Rect(90, 90, 10, 10), rects[4]);
+
+  // Empty clip empties everything
+  std::vector<Rect> rects2 = { Rect(1, 1, 5, 5), Rect(2, 2, 3, 3) };
+  EXPECT_EQ(0, intersect_each(rects2, Rect()));
+  EXPECT_EQ(Rect(), rects2[0]);
+  EXPECT_EQ(Rect(), rects2[1]);
+
+  // Matches Rect::createIntersection() for any count
+  const Rect clip2(-5, -5, 60, 44);
+  for (int n=1; n<=35; ++n) {
+    std::vector<Rect> batch, expected;
+    std::size_t expectedLeft = 0;
+    for (int i=0; i<n; ++i) {
+      Rect rc(i*9 - 60, i*5 - 30, (i*3) % 40, (i*7) % 33);
+      batch.push_back(rc);
+      expected.push_back(rc.createIntersection(clip2));
+      if (!expected.back().isEmpty())
+        ++expectedLeft;
+    }
+    EXPECT_EQ(expectedLeft, intersect_each(batch, clip2)) << "n=" << n;
+    for (int i=0; i<n; ++i)
+      EXPECT_EQ(expected[i], batch[i]) << "n=" << n << " i=" << i;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
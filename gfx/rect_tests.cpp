@@ -12,9 +12,11 @@
 #include <gtest/gtest.h>
 
 #include "gfx/border.h"
+#include "gfx/point.h"
 #include "gfx/rect.h"
 #include "gfx/rect_io.h"
 #include "gfx/size.h"
+#include "gfx/table.h"
 
 using namespace std;
 using namespace gfx;
@@ -64,6 +66,28 @@ TEST(Rect, Floor)
   EXPECT_EQ(gfx::Rect(-1, -1, 1, 2), gfx::RectF(-0.25, -0.75, 1, 2).floor());
 }
 
+TEST(Rect, Constexpr)
+{
+  // The geometry types can build compile-time tables (e.g. fixed
+  // skin metrics); evaluated here at compile time on purpose.
+  constexpr Rect rc(10, 20, 30, 40);
+  static_assert(rc.x2() == 40 && rc.y2() == 60, "x2/y2");
+  static_assert(!rc.isEmpty(), "isEmpty");
+  static_assert(rc.contains(gfx::Point(10, 20)), "contains");
+  static_assert(!rc.contains(40, 20), "contains x2");
+  static_assert((rc & Rect(0, 0, 15, 25)) == Rect(10, 20, 5, 5), "intersection");
+  static_assert((rc | Rect(0, 0, 5, 5)) == Rect(0, 0, 40, 60), "union");
+  static_assert(rc.center() == gfx::Point(25, 40), "center");
+  static_assert((rc*2).w == 60, "scale");
+  static_assert((Rect(rc) - Border(5)).w == 20, "shrink");
+  EXPECT_EQ(40, rc.x2());
+
+  constexpr auto table = gfx::make_table<4>(
+    [](std::size_t i) { return Rect(0, 0, 10*int(i), 10); });
+  static_assert(table[3].w == 30, "make_table");
+  EXPECT_EQ(30, table[3].w);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,100 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gfx/region.h"
+
+#include "base/thread_pool.h"
+#include "gfx/point.h"
+
+#include <utility>
+
+namespace gfx {
+
+// Backend-independent: works through bands()/operator|=(), so the
+// same coalescing behavior is shared by the pixman/Skia/HRGN regions.
+void Region::simplify(const std::size_t maxRects)
+{
+  if (maxRects == 0 || size() <= maxRects)
+    return;
+
+  if (maxRects == 1) {
+    *this = Region(bounds());
+    return;
+  }
+
+  // First level of coalescing: one bounding box per band. Bands are
+  // vertically disjoint, so this alone usually collapses thousands of
+  // fragmented spans into a handful of boxes.
+  const RegionBands& view = bands();
+  std::vector<Rect> boxes;
+  boxes.reserve(view.bands().size());
+  for (const RegionBands::Band& band : view.bands()) {
+    const RegionBands::Span& first = view.spans()[band.spanBegin];
+    const RegionBands::Span& last = view.spans()[band.spanEnd-1];
+    boxes.push_back(Rect(first.x, band.y,
+                         last.x + last.w - first.x, band.h));
+  }
+
+  // Still over the cap: merge adjacent band boxes pairwise (halving
+  // the count per pass) until we fit. Each merge only grows the
+  // covered area, keeping the over-approximation guarantee.
+  while (boxes.size() > maxRects) {
+    std::vector<Rect> merged;
+    merged.reserve((boxes.size()+1)/2);
+    for (std::size_t i=0; i+1<boxes.size(); i+=2)
+      merged.push_back(boxes[i].createUnion(boxes[i+1]));
+    if (boxes.size() & 1)
+      merged.push_back(boxes.back());
+    boxes.swap(merged);
+  }
+
+  clear();
+  for (const Rect& rc : boxes)
+    operator|=(rc);
+}
+
+// Backend-independent too: each merge of the tree goes through
+// operator|=() of the specific backend.
+Region Region::unionAll(Region* regions, const std::size_t n,
+                        base::thread_pool* pool)
+{
+  if (n == 0)
+    return Region();
+
+  // Pairwise merge tree: at each level region i swallows region
+  // i+stride. Merges of the same level are independent, so with a
+  // pool each level runs concurrently (the tree has log2(n) levels
+  // instead of the n-1 serialized passes of a left fold).
+  for (std::size_t stride=1; stride<n; stride*=2) {
+    const std::size_t step = 2*stride;
+    if (pool && n > step) {
+      for (std::size_t i=0; i+stride<n; i+=step) {
+        pool->execute(
+          [regions, i, stride]{
+            regions[i] |= regions[i+stride];
+          });
+      }
+      pool->wait_all();
+    }
+    else {
+      for (std::size_t i=0; i+stride<n; i+=step)
+        regions[i] |= regions[i+stride];
+    }
+  }
+  return std::move(regions[0]);
+}
+
+Region Region::unionAll(std::vector<Region>& regions,
+                        base::thread_pool* pool)
+{
+  return unionAll(regions.data(), regions.size(), pool);
+}
+
+} // namespace gfx
@@ -0,0 +1,78 @@
+// LAF Gfx Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_REGION_BANDS_H_INCLUDED
+#define GFX_REGION_BANDS_H_INCLUDED
+#pragma once
+
+#include "gfx/rect.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace gfx {
+
+  // Band/span-oriented view of a Region: the rows of x-intervals that
+  // the underlying region implementation (pixman/Skia/HRGN) already
+  // stores, flattened into two plain arrays so a software blitter can
+  // walk spans every frame without going through Region::iterator.
+  // Get it with Region::bands(), which caches the view and only
+  // rebuilds it after the Region was mutated.
+  class RegionBands {
+  public:
+    struct Span {
+      int x, w;
+    };
+    // A row of spans: [spanBegin, spanEnd) indexes into spans().
+    struct Band {
+      int y, h;
+      std::size_t spanBegin, spanEnd;
+    };
+
+    const std::vector<Band>& bands() const { return m_bands; }
+    const std::vector<Span>& spans() const { return m_spans; }
+    bool empty() const { return m_bands.empty(); }
+
+    // Calls fn(const Rect&) for each span, top-down and
+    // left-to-right.
+    template<typename Fn>
+    void forEachSpan(Fn&& fn) const {
+      for (const Band& band : m_bands)
+        for (std::size_t i=band.spanBegin; i<band.spanEnd; ++i)
+          fn(Rect(m_spans[i].x, band.y, m_spans[i].w, band.h));
+    }
+
+    // Rebuilds the view from a sequence of region rectangles (already
+    // sorted top-down/left-to-right, as every Region backend
+    // guarantees): consecutive rectangles sharing the same y/h are
+    // grouped in one band.
+    template<typename Iterator>
+    void rebuild(Iterator it, const Iterator end) {
+      m_bands.clear();
+      m_spans.clear();
+      for (; it != end; ++it) {
+        const Rect rc = *it;
+        if (!m_bands.empty() &&
+            m_bands.back().y == rc.y &&
+            m_bands.back().h == rc.h) {
+          m_bands.back().spanEnd = m_spans.size()+1;
+        }
+        else {
+          m_bands.push_back(Band{ rc.y, rc.h,
+                                  m_spans.size(), m_spans.size()+1 });
+        }
+        m_spans.push_back(Span{ rc.x, rc.w });
+      }
+    }
+
+  private:
+    std::vector<Band> m_bands;
+    std::vector<Span> m_spans;
+  };
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,91 @@
+// LAF Gfx Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_REGION_IO_H_INCLUDED
+#define GFX_REGION_IO_H_INCLUDED
+#pragma once
+
+#include "base/serialization.h"
+#include "gfx/region.h"
+
+#include <iostream>
+
+namespace gfx {
+
+  // Compact binary encoding of a Region, written straight from the
+  // band/span view of the backend boxes (Region::bands()) instead of
+  // flattening to a rect vector. Coordinates are delta-encoded
+  // (band y against the previous band, span x against the end of the
+  // previous span in the band) and stored as LEB128 varints, so the
+  // typical damage region costs a few bytes per rectangle.
+  //
+  // Layout: varuint bandCount, then per band: varint dy, varuint h,
+  // varuint spanCount, and per span: varint dx, varuint w.
+
+  inline void write_region(std::ostream& os, const Region& rgn)
+  {
+    using namespace base::serialization;
+
+    const RegionBands& view = rgn.bands();
+    write_varuint(os, view.bands().size());
+
+    int prevY = 0;
+    for (const RegionBands::Band& band : view.bands()) {
+      write_varint(os, band.y - prevY);
+      write_varuint(os, band.h);
+      write_varuint(os, band.spanEnd - band.spanBegin);
+      prevY = band.y;
+
+      int prevX = 0;
+      for (std::size_t i=band.spanBegin; i<band.spanEnd; ++i) {
+        const RegionBands::Span& span = view.spans()[i];
+        write_varint(os, span.x - prevX);
+        write_varuint(os, span.w);
+        prevX = span.x + span.w;
+      }
+    }
+  }
+
+  // Reads a region written by write_region(). Returns false (leaving
+  // the region in a valid but unspecified state) if the stream ends
+  // mid-encoding.
+  inline bool read_region(std::istream& is, Region& rgn)
+  {
+    using namespace base::serialization;
+
+    rgn.clear();
+
+    const uint64_t bandCount = read_varuint(is);
+    if (!is)
+      return false;
+
+    int prevY = 0;
+    for (uint64_t b=0; b<bandCount; ++b) {
+      const int y = prevY + int(read_varint(is));
+      const int h = int(read_varuint(is));
+      const uint64_t spanCount = read_varuint(is);
+      prevY = y;
+
+      int prevX = 0;
+      for (uint64_t s=0; s<spanCount; ++s) {
+        const int x = prevX + int(read_varint(is));
+        const int w = int(read_varuint(is));
+        prevX = x + w;
+
+        if (!is)
+          return false;
+
+        rgn |= Rect(x, y, w, h);
+      }
+      if (!is)
+        return false;
+    }
+    return true;
+  }
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,100 @@
+// LAF Gfx Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#if LAF_WITH_REGION
+
+#include "gfx/region_io.h"
+
+#include <sstream>
+#include <vector>
+
+using namespace gfx;
+
+// The Region backends don't define operator==, so regions are
+// compared by their exact rectangle decomposition.
+static std::vector<Rect> region_rects(const Region& rgn)
+{
+  return std::vector<Rect>(rgn.begin(), rgn.end());
+}
+
+static Region roundtrip(const Region& rgn, bool* ok = nullptr)
+{
+  std::stringstream ss;
+  write_region(ss, rgn);
+  Region out;
+  const bool res = read_region(ss, out);
+  if (ok)
+    *ok = res;
+  return out;
+}
+
+TEST(RegionIO, Empty)
+{
+  bool ok = false;
+  Region out = roundtrip(Region(), &ok);
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(out.isEmpty());
+}
+
+TEST(RegionIO, SingleRect)
+{
+  bool ok = false;
+  Region rgn(Rect(5, 10, 15, 20));
+  Region out = roundtrip(rgn, &ok);
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(rgn.bounds(), out.bounds());
+  EXPECT_EQ(region_rects(rgn), region_rects(out));
+}
+
+TEST(RegionIO, ComplexRegion)
+{
+  Region rgn(Rect(0, 0, 100, 100));
+  rgn |= Region(Rect(150, 20, 30, 200));
+  rgn -= Region(Rect(40, 40, 20, 20));
+  rgn |= Region(Rect(-64, -32, 10, 10));
+
+  bool ok = false;
+  Region out = roundtrip(rgn, &ok);
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(rgn.bounds(), out.bounds());
+  EXPECT_EQ(region_rects(rgn), region_rects(out));
+}
+
+TEST(RegionIO, CompactEncoding)
+{
+  // One rectangle with small coordinates costs a handful of bytes
+  // (vs 16 bytes for four raw int32s).
+  std::stringstream ss;
+  write_region(ss, Region(Rect(1, 2, 3, 4)));
+  EXPECT_GE(8, ss.str().size());
+}
+
+TEST(RegionIO, TruncatedStream)
+{
+  std::stringstream ss;
+  write_region(ss, Region(Rect(5, 10, 15, 20)));
+
+  const std::string bytes = ss.str();
+  for (size_t n=0; n<bytes.size(); ++n) {
+    std::stringstream truncated(bytes.substr(0, n));
+    Region out(Rect(0, 0, 1, 1));
+    EXPECT_FALSE(read_region(truncated, out));
+  }
+}
+
+#endif // LAF_WITH_REGION
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
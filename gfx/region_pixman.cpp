@@ -17,6 +17,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 
 namespace gfx {
 
@@ -39,6 +40,12 @@ Region::Region(const Region& copy)
   pixman_region32_copy(&m_region, &copy.m_region);
 }
 
+Region::Region(Region&& other) noexcept
+{
+  pixman_region32_init(&m_region);
+  std::swap(m_region, other.m_region);
+}
+
 Region::Region(const Rect& rect)
 {
   if (!rect.isEmpty())
@@ -47,6 +54,12 @@ Region::Region(const Rect& rect)
     pixman_region32_init(&m_region);
 }
 
+Region::Region(details::Region&& handle) noexcept
+{
+  pixman_region32_init(&m_region);
+  std::swap(m_region, handle);
+}
+
 Region::~Region()
 {
   pixman_region32_fini(&m_region);
@@ -60,15 +73,44 @@ Region& Region::operator=(const Rect& rect)
   }
   else
     pixman_region32_clear(&m_region);
+  m_bandsDirty = true;
   return *this;
 }
 
 Region& Region::operator=(const Region& copy)
 {
   pixman_region32_copy(&m_region, &copy.m_region);
+  m_bandsDirty = true;
+  return *this;
+}
+
+Region& Region::operator=(Region&& other) noexcept
+{
+  std::swap(m_region, other.m_region);
+  m_bandsDirty = true;
+  return *this;
+}
+
+Region& Region::operator|=(const Rect& b)
+{
+  pixman_region32_union_rect(&m_region, &m_region, b.x, b.y, b.w, b.h);
+  m_bandsDirty = true;
   return *this;
 }
 
+Region& Region::operator&=(const Rect& b)
+{
+  pixman_region32_intersect_rect(&m_region, &m_region, b.x, b.y, b.w, b.h);
+  m_bandsDirty = true;
+  return *this;
+}
+
+Region& Region::operator-=(const Rect& b)
+{
+  // pixman doesn't have a subtract-with-rect variant
+  return operator-=(Region(b));
+}
+
 Region::iterator Region::begin()
 {
   iterator it;
@@ -122,36 +164,63 @@ Rect Region::bounds() const
   return to_rect(*pixman_region32_extents(&m_region));
 }
 
+std::size_t Region::memSize() const
+{
+  // The boxes live in the struct itself for simple regions or in one
+  // heap block (header + capacity*boxes) for complex ones
+  std::size_t bytes = sizeof(m_region);
+  if (isComplex() && m_region.data) {
+    bytes += sizeof(*m_region.data)
+           + m_region.data->size*sizeof(pixman_box32);
+  }
+  return bytes;
+}
+
+const RegionBands& Region::bands() const
+{
+  if (m_bandsDirty) {
+    m_bands.rebuild(begin(), end());
+    m_bandsDirty = false;
+  }
+  return m_bands;
+}
+
 void Region::clear()
 {
   pixman_region32_clear(&m_region);
+  m_bandsDirty = true;
 }
 
 void Region::offset(int dx, int dy)
 {
   pixman_region32_translate(&m_region, dx, dy);
+  m_bandsDirty = true;
 }
 
 void Region::offset(const PointT<int>& delta)
 {
   pixman_region32_translate(&m_region, delta.x, delta.y);
+  m_bandsDirty = true;
 }
 
 Region& Region::createIntersection(const Region& a, const Region& b)
 {
   pixman_region32_intersect(&m_region, &a.m_region, &b.m_region);
+  m_bandsDirty = true;
   return *this;
 }
 
 Region& Region::createUnion(const Region& a, const Region& b)
 {
   pixman_region32_union(&m_region, &a.m_region, &b.m_region);
+  m_bandsDirty = true;
   return *this;
 }
 
 Region& Region::createSubtraction(const Region& a, const Region& b)
 {
   pixman_region32_subtract(&m_region, &a.m_region, &b.m_region);
+  m_bandsDirty = true;
   return *this;
 }
 
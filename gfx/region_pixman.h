@@ -10,9 +10,14 @@
 #pragma once
 
 #include "gfx/rect.h"
+#include "gfx/region_bands.h"
 
 #include <vector>
 
+namespace base {
+  class thread_pool;
+}
+
 namespace gfx {
 
   template<typename T> class PointT;
@@ -77,9 +82,15 @@ namespace gfx {
 
     Region();
     Region(const Region& copy);
+    Region(Region&& other) noexcept;
     explicit Region(const Rect& rect);
+    // Adopts the given backend region handle (the handle is left
+    // empty), so a region built directly with the pixman API can be
+    // wrapped without copying it.
+    explicit Region(details::Region&& handle) noexcept;
     Region& operator=(const Rect& rect);
     Region& operator=(const Region& copy);
+    Region& operator=(Region&& other) noexcept;
     ~Region();
 
     iterator begin();
@@ -93,6 +104,30 @@ namespace gfx {
     std::size_t size() const;
     Rect bounds() const;
 
+    // Cached band/span view of the region, rebuilt lazily after each
+    // mutation (see RegionBands).
+    const RegionBands& bands() const;
+
+    // Approximate bytes used by the backend region storage (useful
+    // with size() to monitor damage-region fragmentation).
+    std::size_t memSize() const;
+
+    // Coalesces the region to a bounded over-approximation of at most
+    // maxRects rectangles (covering at least the original area), so
+    // long-lived damage regions can't degrade every union to O(boxes).
+    // Regions already under the cap are left untouched.
+    void simplify(std::size_t maxRects);
+
+    // Unions all the given regions into one with a pairwise merge
+    // tree, running each level of merges concurrently when a thread
+    // pool is given, so gathering per-tile damage from a
+    // multi-threaded renderer doesn't serialize on N createUnion()
+    // passes. The input regions are consumed (left moved-from).
+    static Region unionAll(Region* regions, std::size_t n,
+                           base::thread_pool* pool = nullptr);
+    static Region unionAll(std::vector<Region>& regions,
+                           base::thread_pool* pool = nullptr);
+
     void clear();
 
     void offset(int dx, int dy);
@@ -110,8 +145,18 @@ namespace gfx {
     Region& operator&=(const Region& b) { return createIntersection(*this, b); }
     Region& operator-=(const Region& b) { return createSubtraction(*this, b); }
 
+    // In-place operations with a rectangle, without creating a
+    // temporary Region (dirty-rect accumulation is a per-event hot
+    // path).
+    Region& operator+=(const Rect& b) { return operator|=(b); }
+    Region& operator|=(const Rect& b);
+    Region& operator&=(const Rect& b);
+    Region& operator-=(const Rect& b);
+
   private:
     mutable details::Region m_region;
+    mutable RegionBands m_bands;
+    mutable bool m_bandsDirty = true;
   };
 
 } // namespace gfx
@@ -34,12 +34,14 @@ Region::Region(const Rect& rect)
 Region& Region::operator=(const Rect& rect)
 {
   m_region.setRect(SkIRect::MakeXYWH(rect.x, rect.y, rect.w, rect.h));
+  m_bandsDirty = true;
   return *this;
 }
 
 Region& Region::operator=(const Region& copy)
 {
   m_region = copy.m_region;
+  m_bandsDirty = true;
   return *this;
 }
 
@@ -72,6 +74,25 @@ Rect Region::bounds() const
   return to_rect(m_region.getBounds());
 }
 
+std::size_t Region::memSize() const
+{
+  // Approximation: SkRegion doesn't expose its run array size, but
+  // its storage is proportional to the number of boxes
+  std::size_t bytes = sizeof(m_region);
+  if (isComplex())
+    bytes += size()*sizeof(SkIRect);
+  return bytes;
+}
+
+const RegionBands& Region::bands() const
+{
+  if (m_bandsDirty) {
+    m_bands.rebuild(begin(), end());
+    m_bandsDirty = false;
+  }
+  return m_bands;
+}
+
 Region::Overlap Region::contains(const Rect& rect) const
 {
   auto rc = SkIRect::MakeXYWH(rect.x, rect.y, rect.w, rect.h);
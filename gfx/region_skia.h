@@ -10,11 +10,16 @@
 
 #include "gfx/point.h"
 #include "gfx/rect.h"
+#include "gfx/region_bands.h"
 
 #include <vector>
 
 #include "include/core/SkRegion.h"
 
+namespace base {
+  class thread_pool;
+}
+
 namespace gfx {
 
   template<typename T> class PointT;
@@ -72,9 +77,23 @@ namespace gfx {
 
     Region();
     Region(const Region& copy);
+    Region(Region&& other) noexcept {
+      m_region.swap(other.m_region);
+    }
     explicit Region(const Rect& rect);
+    // Adopts the given backend region handle (the handle is left
+    // empty), so a region built directly with the Skia API can be
+    // wrapped without copying it.
+    explicit Region(SkRegion&& skRegion) noexcept {
+      m_region.swap(skRegion);
+    }
     Region& operator=(const Rect& rect);
     Region& operator=(const Region& copy);
+    Region& operator=(Region&& other) noexcept {
+      m_region.swap(other.m_region);
+      m_bandsDirty = true;
+      return *this;
+    }
 
     iterator begin();
     iterator end();
@@ -91,30 +110,60 @@ namespace gfx {
 
     Rect bounds() const;
 
+    // Cached band/span view of the region, rebuilt lazily after each
+    // mutation (see RegionBands).
+    const RegionBands& bands() const;
+
+    // Approximate bytes used by the backend region storage (useful
+    // with size() to monitor damage-region fragmentation).
+    std::size_t memSize() const;
+
+    // Coalesces the region to a bounded over-approximation of at most
+    // maxRects rectangles (covering at least the original area), so
+    // long-lived damage regions can't degrade every union to O(boxes).
+    // Regions already under the cap are left untouched.
+    void simplify(std::size_t maxRects);
+
+    // Unions all the given regions into one with a pairwise merge
+    // tree, running each level of merges concurrently when a thread
+    // pool is given, so gathering per-tile damage from a
+    // multi-threaded renderer doesn't serialize on N createUnion()
+    // passes. The input regions are consumed (left moved-from).
+    static Region unionAll(Region* regions, std::size_t n,
+                           base::thread_pool* pool = nullptr);
+    static Region unionAll(std::vector<Region>& regions,
+                           base::thread_pool* pool = nullptr);
+
     void clear() {
       m_region.setEmpty();
+      m_bandsDirty = true;
     }
 
     void offset(int dx, int dy) {
       m_region.translate(dx, dy);
+      m_bandsDirty = true;
     }
 
     void offset(const PointT<int>& delta) {
       m_region.translate(delta.x, delta.y);
+      m_bandsDirty = true;
     }
 
     Region& createIntersection(const Region& a, const Region& b) {
       m_region.op(a.m_region, b.m_region, SkRegion::kIntersect_Op);
+      m_bandsDirty = true;
       return *this;
     }
 
     Region& createUnion(const Region& a, const Region& b) {
       m_region.op(a.m_region, b.m_region, SkRegion::kUnion_Op);
+      m_bandsDirty = true;
       return *this;
     }
 
     Region& createSubtraction(const Region& a, const Region& b) {
       m_region.op(a.m_region, b.m_region, SkRegion::kDifference_Op);
+      m_bandsDirty = true;
       return *this;
     }
 
@@ -128,8 +177,30 @@ namespace gfx {
     Region& operator&=(const Region& b) { return createIntersection(*this, b); }
     Region& operator-=(const Region& b) { return createSubtraction(*this, b); }
 
+    // In-place operations with a rectangle, without creating a
+    // temporary Region (dirty-rect accumulation is a per-event hot
+    // path).
+    Region& operator+=(const Rect& b) { return operator|=(b); }
+    Region& operator|=(const Rect& b) {
+      m_region.op(SkIRect::MakeXYWH(b.x, b.y, b.w, b.h), SkRegion::kUnion_Op);
+      m_bandsDirty = true;
+      return *this;
+    }
+    Region& operator&=(const Rect& b) {
+      m_region.op(SkIRect::MakeXYWH(b.x, b.y, b.w, b.h), SkRegion::kIntersect_Op);
+      m_bandsDirty = true;
+      return *this;
+    }
+    Region& operator-=(const Rect& b) {
+      m_region.op(SkIRect::MakeXYWH(b.x, b.y, b.w, b.h), SkRegion::kDifference_Op);
+      m_bandsDirty = true;
+      return *this;
+    }
+
   private:
     mutable details::Region m_region;
+    mutable RegionBands m_bands;
+    mutable bool m_bandsDirty = true;
   };
 
 } // namespace gfx
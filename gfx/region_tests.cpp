@@ -13,6 +13,7 @@
 
 #if LAF_WITH_REGION
 
+#include "base/thread_pool.h"
 #include "gfx/point.h"
 #include "gfx/rect_io.h"
 #include "gfx/region.h"
@@ -124,6 +125,141 @@ TEST(Region, Iterators)
   EXPECT_EQ(2, c);
 }
 
+TEST(Region, InPlaceRectOps)
+{
+  Region a(Rect(0, 0, 32, 32));
+  a |= Rect(32, 0, 32, 32);
+  EXPECT_EQ(Rect(0, 0, 64, 32), a.bounds());
+
+  a &= Rect(16, 0, 64, 32);
+  EXPECT_EQ(Rect(16, 0, 48, 32), a.bounds());
+
+  a -= Rect(16, 0, 16, 32);
+  EXPECT_EQ(Rect(32, 0, 32, 32), a.bounds());
+  EXPECT_TRUE(a.isRect());
+}
+
+TEST(Region, Move)
+{
+  Region a(Rect(1, 2, 3, 4));
+  Region b(std::move(a));
+  EXPECT_EQ(Rect(1, 2, 3, 4), b.bounds());
+  EXPECT_TRUE(a.isEmpty());
+
+  Region c;
+  c = std::move(b);
+  EXPECT_EQ(Rect(1, 2, 3, 4), c.bounds());
+}
+
+TEST(Region, Bands)
+{
+  // L-shaped region: one 64x32 band on top, one 32x32 band below
+  Region a;
+  a.createUnion(a, Region(Rect(0, 0, 32, 64)));
+  a.createUnion(a, Region(Rect(0, 0, 64, 32)));
+
+  const RegionBands& bands = a.bands();
+  ASSERT_EQ(2, bands.bands().size());
+  EXPECT_EQ(0, bands.bands()[0].y);
+  EXPECT_EQ(32, bands.bands()[0].h);
+  EXPECT_EQ(32, bands.bands()[1].y);
+  EXPECT_EQ(32, bands.bands()[1].h);
+
+  std::vector<Rect> rects;
+  bands.forEachSpan([&rects](const Rect& rc) { rects.push_back(rc); });
+  ASSERT_EQ(2, rects.size());
+  EXPECT_EQ(Rect(0, 0, 64, 32), rects[0]);
+  EXPECT_EQ(Rect(0, 32, 32, 32), rects[1]);
+
+  // The cached view is invalidated on mutation
+  a -= Region(Rect(0, 32, 32, 32));
+  EXPECT_EQ(1, a.bands().bands().size());
+
+  a.clear();
+  EXPECT_TRUE(a.bands().empty());
+}
+
+TEST(Region, Simplify)
+{
+  // Checkerboard: the classic worst case for damage regions
+  Region a;
+  for (int y=0; y<16; ++y)
+    for (int x=0; x<16; ++x)
+      if ((x+y) & 1)
+        a |= Rect(x*8, y*8, 8, 8);
+  const std::size_t fragmented = a.size();
+  const std::size_t fragmentedBytes = a.memSize();
+  EXPECT_GT(fragmented, std::size_t(100));
+  EXPECT_GT(fragmentedBytes, std::size_t(0));
+
+  // Under the cap: untouched
+  Region b = a;
+  b.simplify(1024);
+  EXPECT_EQ(fragmented, b.size());
+
+  // Over the cap: bounded over-approximation that still covers the
+  // original region
+  b.simplify(8);
+  EXPECT_LE(b.size(), std::size_t(8));
+  EXPECT_LE(b.memSize(), fragmentedBytes);
+  Region uncovered;
+  uncovered.createSubtraction(a, b);
+  EXPECT_TRUE(uncovered.isEmpty());
+
+  // maxRects=1 collapses to the bounds
+  b.simplify(1);
+  EXPECT_TRUE(b.isRect());
+  EXPECT_EQ(a.bounds(), b.bounds());
+}
+
+TEST(Region, UnionAll)
+{
+  // Per-tile damage like a 16-thread tile renderer would produce
+  auto makeTiles = []{
+    std::vector<Region> tiles;
+    for (int i=0; i<16; ++i) {
+      Region rgn(Rect(i*10, 0, 10, 10));
+      rgn |= Rect(i*10, 20, 5, 5);
+      tiles.push_back(std::move(rgn));
+    }
+    return tiles;
+  };
+
+  auto equalRegions = [](const Region& a, const Region& b) {
+    Region d1, d2;
+    d1.createSubtraction(a, b);
+    d2.createSubtraction(b, a);
+    return d1.isEmpty() && d2.isEmpty();
+  };
+
+  // Sequential left fold as the reference result
+  Region expected;
+  {
+    auto tiles = makeTiles();
+    for (const Region& rgn : tiles)
+      expected |= rgn;
+  }
+
+  // Merge tree without a pool
+  {
+    auto tiles = makeTiles();
+    EXPECT_TRUE(equalRegions(expected, Region::unionAll(tiles)));
+  }
+
+  // Merge tree with a pool
+  {
+    base::thread_pool pool(4);
+    auto tiles = makeTiles();
+    EXPECT_TRUE(equalRegions(expected, Region::unionAll(tiles, &pool)));
+  }
+
+  // Degenerate cases
+  EXPECT_TRUE(Region::unionAll(nullptr, 0).isEmpty());
+  Region one(Rect(1, 2, 3, 4));
+  EXPECT_TRUE(equalRegions(Region(Rect(1, 2, 3, 4)),
+                           Region::unionAll(&one, 1)));
+}
+
 #endif  // LAF_WITH_REGION
 
 int main(int argc, char** argv)
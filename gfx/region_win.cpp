@@ -11,6 +11,7 @@
 #include "gfx/region.h"
 
 #include <cassert>
+#include <utility>
 
 namespace gfx {
 
@@ -25,11 +26,26 @@ Region::Region(const Region& copy)
   CombineRgn(m_hrgn, copy.m_hrgn, nullptr, RGN_COPY);
 }
 
+Region::Region(Region&& other) noexcept
+  : m_hrgn(other.m_hrgn)
+  , m_data(other.m_data)
+{
+  // Keep the moved-from region usable (every Region owns a valid
+  // handle)
+  other.m_hrgn = CreateRectRgn(0, 0, 0, 0);
+  other.m_data = nullptr;
+}
+
 Region::Region(const Rect& rect)
   : m_hrgn(CreateRectRgn(rect.x, rect.y, rect.x2(), rect.y2()))
 {
 }
 
+Region::Region(HRGN hrgn)
+  : m_hrgn(hrgn ? hrgn: CreateRectRgn(0, 0, 0, 0))
+{
+}
+
 Region& Region::operator=(const Rect& rect)
 {
   resetData();
@@ -44,6 +60,15 @@ Region& Region::operator=(const Region& copy)
   return *this;
 }
 
+Region& Region::operator=(Region&& other) noexcept
+{
+  std::swap(m_hrgn, other.m_hrgn);
+  std::swap(m_data, other.m_data);
+  m_bandsDirty = true;
+  other.m_bandsDirty = true;
+  return *this;
+}
+
 Region::~Region()
 {
   resetData();
@@ -90,6 +115,21 @@ std::size_t Region::size() const
   return m_data->rdh.nCount;
 }
 
+std::size_t Region::memSize() const
+{
+  fillData();
+  return sizeof(RGNDATAHEADER) + m_data->rdh.nRgnSize;
+}
+
+const RegionBands& Region::bands() const
+{
+  if (m_bandsDirty) {
+    m_bands.rebuild(begin(), end());
+    m_bandsDirty = false;
+  }
+  return m_bands;
+}
+
 void Region::clear()
 {
   resetData();
@@ -149,6 +189,9 @@ Region::Overlap Region::contains(const Rect& rect) const
 
 void Region::resetData() const
 {
+  // Every mutation goes through here, so it also invalidates the
+  // cached band view.
+  m_bandsDirty = true;
   if (m_data) {
     delete[] m_data;
     m_data = nullptr;
@@ -10,11 +10,16 @@
 
 #include "gfx/point.h"
 #include "gfx/rect.h"
+#include "gfx/region_bands.h"
 
 #include <vector>
 
 #include <windows.h>
 
+namespace base {
+  class thread_pool;
+}
+
 namespace gfx {
 
   template<typename T> class PointT;
@@ -69,9 +74,14 @@ namespace gfx {
 
     Region();
     Region(const Region& copy);
+    Region(Region&& other) noexcept;
     explicit Region(const Rect& rect);
+    // Adopts the ownership of the given region handle (a null handle
+    // creates an empty region).
+    explicit Region(HRGN hrgn);
     Region& operator=(const Rect& rect);
     Region& operator=(const Region& copy);
+    Region& operator=(Region&& other) noexcept;
     ~Region();
 
     iterator begin();
@@ -87,6 +97,30 @@ namespace gfx {
 
     Rect bounds() const;
 
+    // Cached band/span view of the region, rebuilt lazily after each
+    // mutation (see RegionBands).
+    const RegionBands& bands() const;
+
+    // Approximate bytes used by the backend region storage (useful
+    // with size() to monitor damage-region fragmentation).
+    std::size_t memSize() const;
+
+    // Coalesces the region to a bounded over-approximation of at most
+    // maxRects rectangles (covering at least the original area), so
+    // long-lived damage regions can't degrade every union to O(boxes).
+    // Regions already under the cap are left untouched.
+    void simplify(std::size_t maxRects);
+
+    // Unions all the given regions into one with a pairwise merge
+    // tree, running each level of merges concurrently when a thread
+    // pool is given, so gathering per-tile damage from a
+    // multi-threaded renderer doesn't serialize on N createUnion()
+    // passes. The input regions are consumed (left moved-from).
+    static Region unionAll(Region* regions, std::size_t n,
+                           base::thread_pool* pool = nullptr);
+    static Region unionAll(std::vector<Region>& regions,
+                           base::thread_pool* pool = nullptr);
+
     void clear();
 
     void offset(int dx, int dy);
@@ -106,12 +140,22 @@ namespace gfx {
     Region& operator&=(const Region& b) { return createIntersection(*this, b); }
     Region& operator-=(const Region& b) { return createSubtraction(*this, b); }
 
+    // In-place operations with a rectangle. GDI always needs an HRGN
+    // operand so a temporary region for the rectangle is created, but
+    // *this is still mutated in-place.
+    Region& operator+=(const Rect& b) { return operator|=(b); }
+    Region& operator|=(const Rect& b) { return createUnion(*this, Region(b)); }
+    Region& operator&=(const Rect& b) { return createIntersection(*this, Region(b)); }
+    Region& operator-=(const Rect& b) { return createSubtraction(*this, Region(b)); }
+
   private:
     void resetData() const;
     void fillData() const;
 
     HRGN m_hrgn = nullptr;
     mutable LPRGNDATA m_data = nullptr;
+    mutable RegionBands m_bands;
+    mutable bool m_bandsDirty = true;
   };
 
 } // namespace gfx
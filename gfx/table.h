@@ -0,0 +1,34 @@
+// LAF Gfx Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_TABLE_H_INCLUDED
+#define GFX_TABLE_H_INCLUDED
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace gfx {
+
+  // Builds a std::array by evaluating fn(index) for each index.
+  // With a constexpr fn the whole table is computed at compile time
+  // and baked into the binary, so fixed skin metrics or palette
+  // ramps stop being computed at startup:
+  //
+  //   constexpr auto alphaRamp = gfx::make_table<256>(
+  //     [](std::size_t i) { return gfx::rgba(0, 0, 0, int(i)); });
+  //
+  template<std::size_t N, typename Fn>
+  constexpr auto make_table(Fn fn) {
+    std::array<decltype(fn(std::size_t(0))), N> table{};
+    for (std::size_t i=0; i<N; ++i)
+      table[i] = fn(i);
+    return table;
+  }
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,195 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Headless benchmarks for the paint pipeline: scripted frames of
+// blits, nine-patches and text runs (roughly the UI load of
+// examples/allevents.cpp) drawn into off-screen surfaces, so the
+// numbers can be collected in CI or on a customer machine without
+// opening a window. Same self-contained harness as
+// base/benchmarks.cpp, reporting ns/op and, where it applies, the
+// pixel throughput.
+
+#include "os/os.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Benchmark {
+  std::string name;
+  std::function<void(size_t)> func;
+  double pixelsPerIter = 0.0;   // To report throughput when it applies
+};
+
+std::vector<Benchmark>& benchmarks()
+{
+  static std::vector<Benchmark> list;
+  return list;
+}
+
+void add_benchmark(const std::string& name,
+                   std::function<void(size_t)> func,
+                   const double pixelsPerIter = 0.0)
+{
+  benchmarks().push_back({ name, std::move(func), pixelsPerIter });
+}
+
+double time_seconds(const std::function<void(size_t)>& func,
+                    const size_t iters)
+{
+  const auto start = std::chrono::steady_clock::now();
+  func(iters);
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void run_benchmark(const Benchmark& bench)
+{
+  // Scale the iteration count until the run takes at least ~200ms
+  size_t iters = 1;
+  double secs = time_seconds(bench.func, iters);
+  while (secs < 0.2 && iters < (size_t(1) << 40)) {
+    iters *= (secs < 0.01 ? 16: 2);
+    secs = time_seconds(bench.func, iters);
+  }
+
+  const double nsPerIter = 1e9 * secs / double(iters);
+  if (bench.pixelsPerIter > 0.0) {
+    const double mpixPerSec =
+      (bench.pixelsPerIter * double(iters) / secs) / 1.0e6;
+    std::printf("%-32s %12.1f ns/op %10.1f Mpix/s\n",
+                bench.name.c_str(), nsPerIter, mpixPerSec);
+  }
+  else {
+    std::printf("%-32s %12.1f ns/op\n",
+                bench.name.c_str(), nsPerIter);
+  }
+}
+
+void register_benchmarks(os::System* system)
+{
+  // A full HD "window" back buffer plus the sources every frame
+  // composites from: a widget skin sheet and a sprite-sized canvas.
+  const int kFrameW = 1920, kFrameH = 1080;
+  os::SurfaceRef frame = system->makeSurface(kFrameW, kFrameH);
+  os::SurfaceRef canvas = system->makeSurface(512, 512);
+  os::SurfaceRef skin = system->makeSurface(64, 64);
+  {
+    os::SurfaceLock lock(skin.get());
+    os::Paint p;
+    p.style(os::Paint::Fill);
+    p.color(gfx::rgba(128, 128, 144));
+    skin->drawRect(skin->bounds(), p);
+    p.style(os::Paint::Stroke);
+    p.color(gfx::rgba(32, 32, 40));
+    skin->drawRect(skin->bounds(), p);
+  }
+  {
+    os::SurfaceLock lock(canvas.get());
+    os::Paint p;
+    p.style(os::Paint::Fill);
+    for (int y=0; y<512; y+=8) {
+      p.color(gfx::rgba(y & 0xff, 255 - (y & 0xff), 128));
+      canvas->drawRect(gfx::Rect(0, y, 512, 8), p);
+    }
+  }
+
+  // Full-buffer clear, the start of every repaint
+  add_benchmark("Surface/clear_1080p", [frame](size_t n) {
+    os::SurfaceLock lock(frame.get());
+    os::Paint p;
+    p.style(os::Paint::Fill);
+    p.color(gfx::rgba(48, 48, 48));
+    for (size_t i=0; i<n; ++i)
+      frame->drawRect(frame->bounds(), p);
+  }, double(kFrameW)*kFrameH);
+
+  // Opaque same-size blit (the swap-buffers path)
+  {
+    os::SurfaceRef back = system->makeSurface(kFrameW, kFrameH);
+    add_benchmark("Surface/blit_1080p", [frame, back](size_t n) {
+      os::SurfaceLock lock(frame.get());
+      os::SurfaceLock lock2(back.get());
+      for (size_t i=0; i<n; ++i)
+        frame->blitTo(back.get(), 0, 0, 0, 0, kFrameW, kFrameH);
+    }, double(kFrameW)*kFrameH);
+  }
+
+  // Zoomed sprite view: 512x512 canvas stretched x2 with both filters
+  for (const bool linear : { false, true }) {
+    os::Sampling sampling;
+    if (linear)
+      sampling = os::Sampling(os::Sampling::Filter::Linear);
+    add_benchmark(linear ? "Surface/stretch_x2_linear":
+                           "Surface/stretch_x2_nearest",
+                  [frame, canvas, sampling](size_t n) {
+      os::SurfaceLock lock(frame.get());
+      os::SurfaceLock lock2(canvas.get());
+      for (size_t i=0; i<n; ++i) {
+        frame->drawSurface(canvas.get(),
+                           canvas->bounds(),
+                           gfx::Rect(0, 0, 1024, 1024),
+                           sampling, nullptr);
+      }
+    }, 1024.0*1024.0);
+  }
+
+  // Widget chrome: 100 nine-patch buttons per "frame"
+  add_benchmark("Surface/nine_patch_100", [frame, skin](size_t n) {
+    os::SurfaceLock lock(frame.get());
+    os::SurfaceLock lock2(skin.get());
+    for (size_t i=0; i<n; ++i) {
+      for (int j=0; j<100; ++j) {
+        frame->drawSurfaceNine(skin.get(),
+                               skin->bounds(),
+                               gfx::Rect(8, 8, 48, 48),
+                               gfx::Rect(10 + 18*(j%10), 10 + 90*(j/10),
+                                         170, 80),
+                               true, nullptr);
+      }
+    }
+  });
+
+  // Text runs with the default font, like the event log that
+  // allevents.cpp repaints on every event
+  add_benchmark("DrawText/event_log_32_lines", [frame](size_t n) {
+    os::SurfaceLock lock(frame.get());
+    os::Paint p;
+    p.color(gfx::rgba(255, 255, 255));
+    for (size_t i=0; i<n; ++i) {
+      for (int j=0; j<32; ++j) {
+        os::draw_text(frame.get(), nullptr,
+                      "mouseMove (320, 240) buttons=Left mods=Ctrl",
+                      gfx::Point(8, 8 + 16*j), &p);
+      }
+    }
+  });
+}
+
+} // anonymous namespace
+
+int app_main(int argc, char* argv[])
+{
+  os::SystemRef system = os::make_system();
+  system->setAppMode(os::AppMode::CLI);
+
+  const std::string filter = (argc > 1 ? argv[1]: "");
+
+  register_benchmarks(system.get());
+  for (const Benchmark& bench : benchmarks()) {
+    if (filter.empty() ||
+        bench.name.find(filter) != std::string::npos)
+      run_benchmark(bench);
+  }
+
+  // Drop the captured surfaces before the system goes away
+  benchmarks().clear();
+  return 0;
+}
@@ -0,0 +1,124 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/capabilities.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_IX86)
+  #define LAF_CPU_X86 1
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #else
+    #include <cpuid.h>
+  #endif
+#elif defined(__arm__) && defined(__linux__)
+  #include <asm/hwcap.h>
+  #include <sys/auxv.h>
+#endif
+
+namespace os {
+
+#if LAF_CPU_X86
+
+static void cpuid(const uint32_t leaf, const uint32_t subleaf,
+                  uint32_t regs[4])
+{
+#ifdef _MSC_VER
+  int r[4];
+  __cpuidex(r, int(leaf), int(subleaf));
+  for (int i=0; i<4; ++i)
+    regs[i] = uint32_t(r[i]);
+#else
+  __get_cpuid_count(leaf, subleaf,
+                    &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+}
+
+static uint64_t xgetbv0()
+{
+#ifdef _MSC_VER
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (uint64_t(edx) << 32) | eax;
+#endif
+}
+
+static CpuFeatures detect_cpu_features()
+{
+  int features = int(CpuFeatures::NoFeatures);
+
+  uint32_t regs[4] = { 0, 0, 0, 0 };
+  cpuid(0, 0, regs);
+  const uint32_t maxLeaf = regs[0];
+  if (maxLeaf < 1)
+    return CpuFeatures::NoFeatures;
+
+  cpuid(1, 0, regs);
+  const uint32_t ecx = regs[2];
+  if (ecx & (1u << 19))         // SSE4.1
+    features |= int(CpuFeatures::SSE4);
+
+  // AVX needs CPU support *and* the OS saving the wider registers on
+  // context switches (OSXSAVE + the XCR0 state bits).
+  const bool osxsave = (ecx & (1u << 27)) != 0;
+  const bool avxCpu = (ecx & (1u << 28)) != 0;
+  if (osxsave && avxCpu && maxLeaf >= 7) {
+    const uint64_t xcr0 = xgetbv0();
+    const bool ymmSaved = ((xcr0 & 0x6) == 0x6);
+    const bool zmmSaved = ((xcr0 & 0xe6) == 0xe6);
+
+    cpuid(7, 0, regs);
+    const uint32_t ebx = regs[1];
+    if (ymmSaved && (ebx & (1u << 5)))    // AVX2
+      features |= int(CpuFeatures::AVX2);
+    if (zmmSaved && (ebx & (1u << 16)))   // AVX-512F
+      features |= int(CpuFeatures::AVX512);
+  }
+
+  return CpuFeatures(features);
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+static CpuFeatures detect_cpu_features()
+{
+  // NEON (Advanced SIMD) is part of the AArch64 baseline.
+  return CpuFeatures::NEON;
+}
+
+#elif defined(__arm__) && defined(__linux__)
+
+static CpuFeatures detect_cpu_features()
+{
+  if (getauxval(AT_HWCAP) & HWCAP_NEON)
+    return CpuFeatures::NEON;
+  return CpuFeatures::NoFeatures;
+}
+
+#else
+
+static CpuFeatures detect_cpu_features()
+{
+  return CpuFeatures::NoFeatures;
+}
+
+#endif
+
+CpuFeatures cpu_features()
+{
+  static const CpuFeatures features = detect_cpu_features();
+  return features;
+}
+
+} // namespace os
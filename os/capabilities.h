@@ -40,6 +40,48 @@ namespace os {
     CanStartWindowResize = 64
   };
 
+  // CPU SIMD features detected at runtime (see cpu_features()), so
+  // blit/conversion kernels can select the widest safe path once at
+  // startup instead of being limited to the baseline the binary was
+  // compiled for.
+  enum class CpuFeatures {
+    // Not "None": X.h defines it as a macro and this header ends up
+    // included after <X11/Xlib.h> in the X11 backend
+    NoFeatures = 0,
+    SSE4 = 1,                   // SSE4.1
+    AVX2 = 2,                   // Implies the OS saves YMM state
+    AVX512 = 4,                 // AVX-512F, with ZMM state saved
+    NEON = 8,
+  };
+
+  // Returns the features of the CPU we are running on (detected once,
+  // then cached).
+  CpuFeatures cpu_features();
+
+  inline bool has_cpu_feature(const CpuFeatures feature) {
+    return (int(cpu_features()) & int(feature)) == int(feature);
+  }
+
+  // Picks the widest of the given kernel entry points supported by
+  // this CPU (pass nullptr for the variants that don't exist). The
+  // scalar fallback must always be provided. E.g.:
+  //
+  //   static auto kernel = select_cpu_kernel(&convert_scalar,
+  //                                          &convert_sse4,
+  //                                          &convert_avx2);
+  template<typename Fn>
+  Fn select_cpu_kernel(const Fn scalar,
+                       const Fn sse4 = nullptr,
+                       const Fn avx2 = nullptr,
+                       const Fn avx512 = nullptr,
+                       const Fn neon = nullptr) {
+    if (avx512 && has_cpu_feature(CpuFeatures::AVX512)) return avx512;
+    if (avx2 && has_cpu_feature(CpuFeatures::AVX2)) return avx2;
+    if (sse4 && has_cpu_feature(CpuFeatures::SSE4)) return sse4;
+    if (neon && has_cpu_feature(CpuFeatures::NEON)) return neon;
+    return scalar;
+  }
+
 } // namespace os
 
 #endif
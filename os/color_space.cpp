@@ -0,0 +1,50 @@
+// LAF OS Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/color_space.h"
+
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace os {
+
+// Pixels per job for convertRgbaParallel(). Big enough to amortize
+// the queueing overhead, small enough to balance the load between
+// workers (256KB of RGBA pixels per chunk).
+static const int kConvertChunkSize = 64*1024;
+
+bool ColorSpaceConversion::convertRgbaParallel(uint32_t* dst, const uint32_t* src,
+                                               int n, base::thread_pool& pool)
+{
+  // Small spans don't pay for the round-trip to the workers.
+  if (n <= kConvertChunkSize)
+    return convertRgba(dst, src, n);
+
+  std::atomic<bool> ok(true);
+  std::vector<std::function<void()>> jobs;
+  jobs.reserve((n + kConvertChunkSize-1) / kConvertChunkSize);
+  for (int i=0; i<n; i+=kConvertChunkSize) {
+    const int len = std::min(kConvertChunkSize, n-i);
+    jobs.push_back(
+      [this, dst, src, i, len, &ok]{
+        if (!convertRgba(dst+i, src+i, len))
+          ok = false;
+      });
+  }
+  pool.execute_batch(std::move(jobs));
+  pool.wait_all();
+  return ok;
+}
+
+} // namespace os
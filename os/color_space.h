@@ -13,6 +13,10 @@
 
 #include <cstdint>
 
+namespace base {
+  class thread_pool;
+}
+
 namespace os {
 
   class ColorSpace;
@@ -32,6 +36,16 @@ namespace os {
     virtual bool convertRgba(uint32_t* dst, const uint32_t* src, int n) = 0;
     // Transform grayscale pixels (without alpha) between two color spaces.
     virtual bool convertGray(uint8_t* dst, const uint8_t* src, int n) = 0;
+
+    // Like convertRgba() but chunking the span over the thread pool
+    // (joining before returning), so converting a whole document
+    // between display profiles uses all the cores instead of pegging
+    // one. Every pixel is independent, so the backend's convertRgba()
+    // just has to be callable concurrently over disjoint chunks (the
+    // Skia one is: it keeps no per-call mutable state). Returns false
+    // if any chunk failed.
+    virtual bool convertRgbaParallel(uint32_t* dst, const uint32_t* src,
+                                     int n, base::thread_pool& pool);
   };
 
 } // namespace os
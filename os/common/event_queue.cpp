@@ -17,12 +17,109 @@
   #include "os/x11/event_queue.h"
 #endif
 
+#include "base/time.h"
+#include "os/event_recorder.h"
+
+#include <atomic>
+
 namespace os {
 
 EventQueueImpl g_queue;
+static bool g_coalescePointerEvents = false;
+
+// Histogram of queue dwell times with one bucket per millisecond
+// (dwell times over the last bucket are clamped into it). Updated
+// with relaxed atomics so the consumer thread records and any thread
+// can read a consistent-enough snapshot through stats().
+static const int kDwellBuckets = 256;
+static std::atomic<uint32_t> g_dwellHistogram[kDwellBuckets];
+static std::atomic<uint32_t> g_dwellMax(0);
 
 EventQueue* EventQueue::instance() {
   return &g_queue;
 }
 
+// static
+void EventQueue::setCoalescePointerEvents(bool state) {
+  g_coalescePointerEvents = state;
+}
+
+// static
+bool EventQueue::coalescePointerEvents() {
+  return g_coalescePointerEvents;
+}
+
+// static
+void EventQueue::recordDwellTime(base::tick_t eventTimestamp) {
+  const base::tick_t now = base::current_tick();
+  const uint32_t msecs = (now > eventTimestamp ?
+                          uint32_t(now - eventTimestamp): 0);
+
+  const int bucket = (msecs < kDwellBuckets ? msecs: kDwellBuckets-1);
+  g_dwellHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+  uint32_t max = g_dwellMax.load(std::memory_order_relaxed);
+  while (msecs > max &&
+         !g_dwellMax.compare_exchange_weak(max, msecs,
+                                           std::memory_order_relaxed))
+    ;
+}
+
+// static
+EventQueue::Stats EventQueue::stats() {
+  uint32_t counts[kDwellBuckets];
+  uint64_t total = 0;
+  for (int i=0; i<kDwellBuckets; ++i) {
+    counts[i] = g_dwellHistogram[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+
+  Stats stats;
+  stats.events = int(total);
+  stats.dwellMax = double(g_dwellMax.load(std::memory_order_relaxed));
+  if (total == 0)
+    return stats;
+
+  // Walk the histogram accumulating events until we pass each
+  // percentile rank.
+  const uint64_t rank50 = (total+1) / 2;
+  const uint64_t rank99 = total - total/100;
+  uint64_t accum = 0;
+  bool p50Found = false;
+  for (int i=0; i<kDwellBuckets; ++i) {
+    accum += counts[i];
+    if (!p50Found && accum >= rank50) {
+      stats.dwellP50 = double(i);
+      p50Found = true;
+    }
+    if (accum >= rank99) {
+      stats.dwellP99 = double(i);
+      break;
+    }
+  }
+  return stats;
+}
+
+// static
+void EventQueue::resetStats() {
+  for (int i=0; i<kDwellBuckets; ++i)
+    g_dwellHistogram[i].store(0, std::memory_order_relaxed);
+  g_dwellMax.store(0, std::memory_order_relaxed);
+}
+
+// Hooked recorder (see os/event_recorder.h), touched only from the
+// consumer thread.
+static EventRecorder* g_recorder = nullptr;
+
+// static
+void EventQueue::setRecorder(EventRecorder* recorder) {
+  g_recorder = recorder;
+}
+
+// static
+void EventQueue::recordEvent(const Event& ev) {
+  if (g_recorder)
+    g_recorder->record(ev);
+}
+
 } // namespace os
@@ -15,20 +15,33 @@
 #include "ft/algorithm.h"
 #include "gfx/point.h"
 #include "gfx/size.h"
+#include "os/common/glyph_cache.h"
+
+#include <algorithm>
 
 namespace os {
 
+// Max number of entries in the FreeTypeFont glyph bitmap cache. A
+// couple of UI font sizes fit comfortably, and at ~height² bytes per
+// glyph the worst case stays in the hundreds of KB.
+static const int kMaxCachedGlyphs = 512;
+
 FreeTypeFont::FreeTypeFont(ft::Lib& lib,
                            const char* filename,
                            const int height)
   : m_face(lib.open(filename))
+  , m_filename(filename)
+  , m_size(height)
 {
-  if (m_face.isValid())
+  if (m_face.isValid()) {
     m_face.setSize(height);
+    loadPersistentGlyphs();
+  }
 }
 
 FreeTypeFont::~FreeTypeFont()
 {
+  savePersistentGlyphs();
 }
 
 bool FreeTypeFont::isValid() const
@@ -48,7 +61,8 @@ int FreeTypeFont::height() const
 
 int FreeTypeFont::textLength(const std::string& str) const
 {
-  return ft::calc_text_bounds(m_face, str).w;
+  // Metrics-only path: doesn't rasterize any glyph
+  return ft::calc_text_width(m_face, str);
 }
 
 bool FreeTypeFont::isScalable() const
@@ -58,12 +72,22 @@ bool FreeTypeFont::isScalable() const
 
 void FreeTypeFont::setSize(int size)
 {
+  savePersistentGlyphs();
   m_face.setSize(size);
+  m_size = size;
+  m_glyphBitmaps.clear();
+  m_glyphBitmapIndex.clear();
+  loadPersistentGlyphs();
 }
 
 void FreeTypeFont::setAntialias(bool antialias)
 {
+  savePersistentGlyphs();
   m_face.setAntialias(antialias);
+  m_antialias = antialias;
+  m_glyphBitmaps.clear();
+  m_glyphBitmapIndex.clear();
+  loadPersistentGlyphs();
 }
 
 bool FreeTypeFont::hasCodePoint(int codepoint) const
@@ -71,6 +95,93 @@ bool FreeTypeFont::hasCodePoint(int codepoint) const
   return m_face.hasCodePoint(codepoint);
 }
 
+const FreeTypeFont::GlyphBitmap&
+FreeTypeFont::glyphBitmap(const FT_UInt glyphIndex,
+                          const FT_Bitmap* bitmap) const
+{
+  auto it = m_glyphBitmapIndex.find(glyphIndex);
+  if (it != m_glyphBitmapIndex.end()) {
+    // Move the entry to the most recently used position
+    m_glyphBitmaps.splice(m_glyphBitmaps.begin(),
+                          m_glyphBitmaps, it->second);
+    return it->second->second;
+  }
+
+  GlyphBitmap gbmp;
+  gbmp.width = int(bitmap->width);
+  gbmp.rows = int(bitmap->rows);
+  gbmp.alpha.resize(gbmp.width * gbmp.rows);
+
+  for (int v=0; v<gbmp.rows; ++v) {
+    const uint8_t* p = bitmap->buffer + v*bitmap->pitch;
+    uint8_t* dst = gbmp.alpha.data() + v*gbmp.width;
+
+    if (bitmap->pixel_mode == FT_PIXEL_MODE_GRAY) {
+      std::copy(p, p+gbmp.width, dst);
+    }
+    else if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
+      for (int u=0; u<gbmp.width; ++u)
+        dst[u] = ((p[u/8] & (1 << (7 - u%8))) ? 255: 0);
+    }
+  }
+
+  m_glyphBitmaps.emplace_front(glyphIndex, std::move(gbmp));
+  m_glyphBitmapIndex[glyphIndex] = m_glyphBitmaps.begin();
+  m_cacheDirty = true;
+
+  if (int(m_glyphBitmaps.size()) > kMaxCachedGlyphs) {
+    m_glyphBitmapIndex.erase(m_glyphBitmaps.back().first);
+    m_glyphBitmaps.pop_back();
+  }
+
+  return m_glyphBitmaps.front().second;
+}
+
+void FreeTypeFont::loadPersistentGlyphs()
+{
+  std::vector<CachedGlyph> glyphs;
+  if (!load_cached_glyphs(m_filename, m_size, m_antialias, glyphs))
+    return;
+
+  // Entries are stored most recently used first: preload in reverse
+  // so the hottest glyph of the previous run ends at the front of the
+  // LRU list again.
+  for (auto it=glyphs.rbegin(), end=glyphs.rend(); it != end; ++it) {
+    if (int(m_glyphBitmaps.size()) >= kMaxCachedGlyphs)
+      break;
+    if (m_glyphBitmapIndex.find(it->glyphIndex) != m_glyphBitmapIndex.end())
+      continue;
+
+    GlyphBitmap gbmp;
+    gbmp.width = it->width;
+    gbmp.rows = it->rows;
+    gbmp.alpha = std::move(it->alpha);
+
+    m_glyphBitmaps.emplace_front(it->glyphIndex, std::move(gbmp));
+    m_glyphBitmapIndex[it->glyphIndex] = m_glyphBitmaps.begin();
+  }
+}
+
+void FreeTypeFont::savePersistentGlyphs() const
+{
+  if (!m_cacheDirty || font_cache_dir().empty())
+    return;
+
+  std::vector<CachedGlyph> glyphs;
+  glyphs.reserve(m_glyphBitmaps.size());
+  for (const auto& entry : m_glyphBitmaps) { // Most recently used first
+    CachedGlyph glyph;
+    glyph.glyphIndex = entry.first;
+    glyph.width = entry.second.width;
+    glyph.rows = entry.second.rows;
+    glyph.alpha = entry.second.alpha;
+    glyphs.push_back(std::move(glyph));
+  }
+
+  if (save_cached_glyphs(m_filename, m_size, m_antialias, glyphs))
+    m_cacheDirty = false;
+}
+
 Ref<FreeTypeFont> load_free_type_font(ft::Lib& lib,
                                       const char* filename,
                                       const int height)
@@ -11,8 +11,15 @@
 
 #include "ft/hb_face.h"
 #include "ft/lib.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
 #include "os/font.h"
 
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
 namespace os {
   class Font;
 
@@ -20,6 +27,30 @@ namespace os {
   public:
     using Face = ft::Face;
 
+    // 8-bpp coverage rows of one rasterized glyph, already expanded
+    // from the FreeType bitmap (GRAY or MONO), so the text drawing
+    // loop is a plain alpha blit without per-pixel pixel_mode
+    // branches.
+    struct GlyphBitmap {
+      int width = 0;
+      int rows = 0;
+      std::vector<uint8_t> alpha; // width*rows coverage values (0-255)
+
+      const uint8_t* row(int y) const {
+        return alpha.data() + y*width;
+      }
+    };
+
+    // One positioned glyph of a text run, as accumulated by
+    // os::draw_text() and consumed by the CPU compositing loop or
+    // the GPU glyph atlas path.
+    struct RunGlyph {
+      FT_UInt glyphIndex;
+      const GlyphBitmap* coverage;
+      gfx::Rect bounds;         // Clipped destination bounds
+      gfx::Point orig;          // Unclipped origin, to index coverage
+    };
+
     FreeTypeFont(ft::Lib& lib,
                  const char* filename,
                  const int height);
@@ -34,10 +65,37 @@ namespace os {
     void setAntialias(bool antialias) override;
     bool hasCodePoint(int codepoint) const override;
 
+    // Returns the coverage bitmap for the given glyph, expanding the
+    // FreeType bitmap just the first time. The key is the glyph
+    // index, and the whole cache is discarded when the size or
+    // antialias state changes, so an entry always matches the current
+    // (glyph index, size, antialias) combination. Least recently used
+    // entries are evicted when the cache is full, so a returned
+    // reference stays valid only until kMaxCachedGlyphs other glyphs
+    // are requested (i.e. don't keep it across draw_text() calls).
+    const GlyphBitmap& glyphBitmap(const FT_UInt glyphIndex,
+                                   const FT_Bitmap* bitmap) const;
+
     Face& face() { return m_face; }
 
   private:
+    using GlyphBitmapList = std::list<std::pair<FT_UInt, GlyphBitmap>>;
+
+    // Persistent glyph cache (see os/common/glyph_cache.h): preloads
+    // the bitmaps rasterized by previous runs for the current
+    // (size, antialias) state, and saves the hot entries back when
+    // the state changes or the font is destroyed. No-ops while
+    // font_cache_dir() is empty.
+    void loadPersistentGlyphs();
+    void savePersistentGlyphs() const;
+
     mutable Face m_face;
+    std::string m_filename;
+    int m_size;
+    bool m_antialias = false;
+    mutable bool m_cacheDirty = false;
+    mutable GlyphBitmapList m_glyphBitmaps; // Most recently used first
+    mutable std::map<FT_UInt, GlyphBitmapList::iterator> m_glyphBitmapIndex;
   };
 
   Ref<FreeTypeFont> load_free_type_font(ft::Lib& lib,
@@ -13,6 +13,10 @@
 #include "gfx/color.h"
 #include "os/surface.h"
 
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
 namespace os {
 
 namespace {
@@ -50,6 +54,123 @@ inline gfx::Color blend(const gfx::Color backdrop, gfx::Color src)
   return gfx::rgba(Rr, Rg, Rb, Ra);
 }
 
+// True when a 32-bit surface stores its pixels exactly like
+// gfx::Color, so rows returned by getData() can be blended directly.
+inline bool is_gfx_color_layout(const SurfaceFormatData& f)
+{
+  return (f.format == kRgbaSurfaceFormat &&
+          f.bitsPerPixel == 32 &&
+          f.redShift == gfx::ColorRShift &&
+          f.greenShift == gfx::ColorGShift &&
+          f.blueShift == gfx::ColorBShift &&
+          f.alphaShift == gfx::ColorAShift);
+}
+
+#if defined(__SSE2__)
+
+// Truncating division replicated in float: quotients of 8-bit
+// channel math are never close enough to an integer for the float
+// rounding to cross it, so trunc(fl(n/d)) == n/d in C.
+inline __m128i div_trunc(const __m128 num, const __m128 den)
+{
+  return _mm_cvttps_epi32(_mm_div_ps(num, den));
+}
+
+// Blends 4 gfx::Color pixels against a constant source color (Sr, Sg,
+// Sb splats) with a per-lane source alpha, bit-exact with the scalar
+// blend() above (the float math reproduces its integer rounding).
+inline __m128i blend_4px(const __m128i backdrop,
+                         const __m128 Sr, const __m128 Sg, const __m128 Sb,
+                         const __m128 Sa)
+{
+  const __m128i byteMask = _mm_set1_epi32(0xff);
+  const __m128i Bri = _mm_and_si128(_mm_srli_epi32(backdrop, gfx::ColorRShift), byteMask);
+  const __m128i Bgi = _mm_and_si128(_mm_srli_epi32(backdrop, gfx::ColorGShift), byteMask);
+  const __m128i Bbi = _mm_and_si128(_mm_srli_epi32(backdrop, gfx::ColorBShift), byteMask);
+  const __m128i Bai = _mm_srli_epi32(backdrop, gfx::ColorAShift);
+  const __m128 Br = _mm_cvtepi32_ps(Bri);
+  const __m128 Bg = _mm_cvtepi32_ps(Bgi);
+  const __m128 Bb = _mm_cvtepi32_ps(Bbi);
+  const __m128 Ba = _mm_cvtepi32_ps(Bai);
+
+  // Ra = Ba + Sa - MUL_UN8(Ba, Sa) (MUL_UN8 is a*b/255 rounded to
+  // nearest, which is what cvtps gives us)
+  const __m128i Rai =
+    _mm_sub_epi32(_mm_add_epi32(Bai, _mm_cvtps_epi32(Sa)),
+                  _mm_cvtps_epi32(_mm_mul_ps(_mm_mul_ps(Ba, Sa),
+                                             _mm_set1_ps(1.0f/255.0f))));
+
+  // Ra >= max(Ba, Sa), so it's 0 only when both alphas are 0 and the
+  // (Sx-Bx)*Sa numerators vanish anyway; clamping avoids the division
+  // by zero.
+  const __m128 Ra = _mm_max_ps(_mm_cvtepi32_ps(Rai), _mm_set1_ps(1.0f));
+
+  const __m128i Rri = _mm_add_epi32(
+    Bri, div_trunc(_mm_mul_ps(_mm_sub_ps(Sr, Br), Sa), Ra));
+  const __m128i Rgi = _mm_add_epi32(
+    Bgi, div_trunc(_mm_mul_ps(_mm_sub_ps(Sg, Bg), Sa), Ra));
+  const __m128i Rbi = _mm_add_epi32(
+    Bbi, div_trunc(_mm_mul_ps(_mm_sub_ps(Sb, Bb), Sa), Ra));
+
+  return _mm_or_si128(
+    _mm_or_si128(_mm_slli_epi32(Rri, gfx::ColorRShift),
+                 _mm_slli_epi32(Rgi, gfx::ColorGShift)),
+    _mm_or_si128(_mm_slli_epi32(Rbi, gfx::ColorBShift),
+                 _mm_slli_epi32(Rai, gfx::ColorAShift)));
+}
+
+#endif // __SSE2__
+
+// Span version of the inner loop of drawColoredRgbaSurface(): blends
+// the constant bg and then fg modulated by the per-pixel coverage
+// taken from the src alpha channel, writing directly into a dst row.
+inline void blend_colored_span(uint32_t* dst, const uint32_t* src,
+                               const int w,
+                               const gfx::Color fg, const gfx::Color bg,
+                               const uint32_t srcAlphaMask,
+                               const uint32_t srcAlphaShift)
+{
+  int u = 0;
+
+#if defined(__SSE2__)
+  const __m128 fgR = _mm_set1_ps(gfx::getr(fg));
+  const __m128 fgG = _mm_set1_ps(gfx::getg(fg));
+  const __m128 fgB = _mm_set1_ps(gfx::getb(fg));
+  const __m128 bgR = _mm_set1_ps(gfx::getr(bg));
+  const __m128 bgG = _mm_set1_ps(gfx::getg(bg));
+  const __m128 bgB = _mm_set1_ps(gfx::getb(bg));
+  const __m128 bgA = _mm_set1_ps(gfx::geta(bg));
+  const __m128i aMask = _mm_set1_epi32(srcAlphaMask);
+  const __m128i aShift = _mm_cvtsi32_si128(int(srcAlphaShift));
+
+  for (; u+4 <= w; u+=4) {
+    __m128i d = _mm_loadu_si128((const __m128i*)(dst+u));
+    if (gfx::geta(bg) > 0)
+      d = blend_4px(d, bgR, bgG, bgB, bgA);
+
+    const __m128i s = _mm_loadu_si128((const __m128i*)(src+u));
+    const __m128 coverage = _mm_cvtepi32_ps(
+      _mm_srl_epi32(_mm_and_si128(s, aMask), aShift));
+    d = blend_4px(d, fgR, fgG, fgB, coverage);
+
+    _mm_storeu_si128((__m128i*)(dst+u), d);
+  }
+#endif
+
+  for (; u<w; ++u) {
+    gfx::Color dstColor = dst[u];
+    if (gfx::geta(bg) > 0)
+      dstColor = blend(dstColor, bg);
+
+    const uint32_t a = ((src[u] & srcAlphaMask) >> srcAlphaShift);
+    if (a > 0)
+      dstColor = blend(dstColor, gfx::rgba(gfx::getr(fg),
+                                           gfx::getg(fg),
+                                           gfx::getb(fg), a));
+    dst[u] = dstColor;
+  }
+}
+
 } // anoynmous namespace
 
 template<typename Base>
@@ -63,15 +184,32 @@ public:
                    src->width(), src->height()))
       return;
 
-    SurfaceFormatData format;
-    src->getFormat(&format);
+    const SurfacePixels srcView = src->pixels();
+    const SurfaceFormatData& format = srcView.format;
 
+    ASSERT(srcView.valid());
     ASSERT(format.format == kRgbaSurfaceFormat);
     ASSERT(format.bitsPerPixel == 32);
 
+    // Fast path: when this surface stores gfx::Color values we can
+    // blend whole rows in place (SIMD when available) instead of
+    // going through the getPixel()/putPixel() virtual calls for each
+    // pixel. This is the inner loop of all text drawing.
+    const SurfacePixels dstView = this->pixels();
+    if (dstView.valid() && is_gfx_color_layout(dstView.format)) {
+      for (int v=0; v<clip.size.h; ++v) {
+        const uint32_t* srcRow = srcView.row32(clip.src.y+v) + clip.src.x;
+        uint32_t* dstRow = dstView.row32(clip.dst.y+v) + clip.dst.x;
+        blend_colored_span(dstRow, srcRow, clip.size.w,
+                           fg, bg,
+                           format.alphaMask, format.alphaShift);
+      }
+      return;
+    }
+
+    // Exotic formats: original per-pixel path
     for (int v=0; v<clip.size.h; ++v) {
-      const uint32_t* ptr = (const uint32_t*)src->getData(
-        clip.src.x, clip.src.y+v);
+      const uint32_t* ptr = srcView.row32(clip.src.y+v) + clip.src.x;
 
       for (int u=0; u<clip.size.w; ++u) {
         gfx::Color dstColor = this->getPixel(clip.dst.x+u, clip.dst.y+v);
@@ -0,0 +1,176 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/common/glyph_cache.h"
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/serialization.h"
+#include "base/time.h"
+
+#include <cstdio>
+
+namespace os {
+
+using namespace base::serialization;
+
+namespace {
+
+// "LFGC" magic + format version at the start of every cache file.
+// Bump kFormatVersion when the layout changes.
+const uint32_t kMagic = 0x4347464C;
+const uint32_t kFormatVersion = 1;
+
+// Sanity limit for one glyph bitmap read from disk (a corrupted
+// file must not make us allocate gigabytes).
+const size_t kMaxGlyphBytes = 1 << 24;
+
+std::string g_fontCacheDir;
+
+// Identity of the font file: FNV-1a over its path, size and
+// modification time. Cheaper than hashing the content (fonts are
+// regular app resources, replaced together with their mtime) and
+// enough to discard the cache when the font changes.
+uint64_t font_identity_hash(const std::string& fontFilename)
+{
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const void* data, const size_t n) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i=0; i<n; ++i) {
+      hash ^= p[i];
+      hash *= 1099511628211ull;
+    }
+  };
+
+  mix(fontFilename.data(), fontFilename.size());
+
+  const uint64_t size = base::file_size(fontFilename);
+  mix(&size, sizeof(size));
+
+  const base::Time time = base::get_modification_time(fontFilename);
+  const int t[6] = { time.year, time.month, time.day,
+                     time.hour, time.minute, time.second };
+  mix(t, sizeof(t));
+
+  return hash;
+}
+
+// Cache file name derived from the font path and the size/antialias
+// combination (not from the font identity, so an updated font
+// overwrites its old cache instead of leaking a stale file).
+std::string cache_filename(const std::string& fontFilename,
+                           const int size, const bool antialias)
+{
+  uint64_t hash = 14695981039346656037ull;
+  for (const char chr : fontFilename) {
+    hash ^= uint8_t(chr);
+    hash *= 1099511628211ull;
+  }
+
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "glyphs-%016llx-%d%c.lafcache",
+                (unsigned long long)hash, size, (antialias ? 'a': 'm'));
+  return base::join_path(g_fontCacheDir, buf);
+}
+
+} // anonymous namespace
+
+void set_font_cache_dir(const std::string& dir)
+{
+  g_fontCacheDir = dir;
+}
+
+const std::string& font_cache_dir()
+{
+  return g_fontCacheDir;
+}
+
+bool load_cached_glyphs(const std::string& fontFilename,
+                        const int size, const bool antialias,
+                        std::vector<CachedGlyph>& glyphs)
+{
+  glyphs.clear();
+  if (g_fontCacheDir.empty() || !base::is_file(fontFilename))
+    return false;
+
+  const base::mapped_file file =
+    base::map_file_content(cache_filename(fontFilename, size, antialias));
+  if (file.empty())
+    return false;
+
+  deserializer d(file.data(), file.size());
+  if (d.read32() != kMagic ||
+      d.read32() != kFormatVersion ||
+      d.read64() != font_identity_hash(fontFilename))
+    return false;
+
+  const size_t count = size_t(d.read_varuint());
+  for (size_t i=0; i<count && d.ok(); ++i) {
+    CachedGlyph glyph;
+    glyph.glyphIndex = uint32_t(d.read_varuint());
+    glyph.width = int(d.read_varuint());
+    glyph.rows = int(d.read_varuint());
+
+    const size_t n = size_t(glyph.width) * size_t(glyph.rows);
+    if (n > kMaxGlyphBytes) {
+      glyphs.clear();
+      return false;
+    }
+
+    glyph.alpha.resize(n);
+    if (d.read_bytes(glyph.alpha.data(), n) != n)
+      break;
+
+    glyphs.push_back(std::move(glyph));
+  }
+
+  if (!d.ok() || glyphs.size() != count) {
+    glyphs.clear();
+    return false;
+  }
+  return !glyphs.empty();
+}
+
+bool save_cached_glyphs(const std::string& fontFilename,
+                        const int size, const bool antialias,
+                        const std::vector<CachedGlyph>& glyphs)
+{
+  if (g_fontCacheDir.empty() || glyphs.empty() || !base::is_file(fontFilename))
+    return false;
+
+  try {
+    if (!base::is_directory(g_fontCacheDir))
+      base::make_all_directories(g_fontCacheDir);
+  }
+  catch (const std::exception&) {
+    return false;
+  }
+
+  base::buffer buf;
+  serializer s(buf);
+  s.write32(kMagic);
+  s.write32(kFormatVersion);
+  s.write64(font_identity_hash(fontFilename));
+  s.write_varuint(glyphs.size());
+  for (const CachedGlyph& glyph : glyphs) {
+    s.write_varuint(glyph.glyphIndex);
+    s.write_varuint(glyph.width);
+    s.write_varuint(glyph.rows);
+    s.write_bytes(glyph.alpha.data(), glyph.alpha.size());
+  }
+
+  // A glyph cache is expendable: don't pay any flush for it
+  return base::atomic_write_file(
+    cache_filename(fontFilename, size, antialias),
+    buf.data(), buf.size(),
+    base::durability::none);
+}
+
+} // namespace os
@@ -0,0 +1,48 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_GLYPH_CACHE_H_INCLUDED
+#define OS_COMMON_GLYPH_CACHE_H_INCLUDED
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace os {
+
+  // Directory for the persistent glyph caches written by
+  // FreeTypeFont. Disabled (no file is read or written) until the
+  // client sets a directory, as only the client knows the right
+  // per-user cache location of the app.
+  void set_font_cache_dir(const std::string& dir);
+  const std::string& font_cache_dir();
+
+  // One rasterized glyph as stored on disk (same 8-bpp coverage
+  // layout as FreeTypeFont::GlyphBitmap).
+  struct CachedGlyph {
+    uint32_t glyphIndex = 0;
+    int width = 0;
+    int rows = 0;
+    std::vector<uint8_t> alpha; // width*rows coverage values (0-255)
+  };
+
+  // Loads/saves the rasterized glyphs of one (font file, pixel size,
+  // antialias) combination. The cache file records a hash of the font
+  // file identity (path, size, modification time), so a replaced font
+  // never serves stale bitmaps; the file is memory-mapped on load.
+  // load_cached_glyphs() returns false (with an empty output) when
+  // the cache is disabled, missing or stale.
+  bool load_cached_glyphs(const std::string& fontFilename,
+                          int size, bool antialias,
+                          std::vector<CachedGlyph>& glyphs);
+  bool save_cached_glyphs(const std::string& fontFilename,
+                          int size, bool antialias,
+                          const std::vector<CachedGlyph>& glyphs);
+
+} // namespace os
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "base/memory.h"
 #include "base/string.h"
+#include "os/startup.h"
 
 #if LAF_WINDOWS
   #include <windows.h>
@@ -25,6 +26,7 @@ extern int app_main(int argc, char* argv[]);
 #if LAF_WINDOWS
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
                     PWSTR lpCmdLine, int nCmdShow) {
+  os::mark_startup_phase("main");
   int argc = __argc;
   char** argv;
   if (__wargv && argc > 0) {
@@ -41,6 +43,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
 }
 
 int wmain(int argc, wchar_t* wargv[], wchar_t* envp[]) {
+  os::mark_startup_phase("main");
   char** argv;
   if (wargv && argc > 0) {
     argv = new char*[argc];
@@ -57,6 +60,7 @@ int wmain(int argc, wchar_t* wargv[], wchar_t* envp[]) {
 #endif
 
 int main(int argc, char* argv[]) {
+  os::mark_startup_phase("main");
 #if LAF_MACOS
   os::AppOSX app;
   if (!app.init())
@@ -64,5 +68,6 @@ int main(int argc, char* argv[]) {
 #elif LAF_LINUX
   const os::X11 x11;
 #endif
+  os::mark_startup_phase("platform-init");
   return app_main(argc, argv);
 }
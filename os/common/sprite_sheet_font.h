@@ -10,6 +10,8 @@
 #pragma once
 
 #include "base/debug.h"
+#include "base/fstream_path.h"
+#include "base/serialization.h"
 #include "base/string.h"
 #include "base/utf8_decode.h"
 #include "gfx/rect.h"
@@ -17,6 +19,8 @@
 #include "os/ref.h"
 #include "os/surface.h"
 
+#include <algorithm>
+#include <fstream>
 #include <vector>
 
 namespace os {
@@ -57,10 +61,8 @@ public:
   }
 
   bool hasCodePoint(int codepoint) const override {
-    codepoint -= (int)' ';
-    return (codepoint >= 0 &&
-            codepoint < (int)m_chars.size() &&
-            !m_chars[codepoint].isEmpty());
+    const Glyph* glyph = findGlyph(codepoint);
+    return (glyph && !glyph->bounds.isEmpty());
   }
 
   Surface* sheetSurface() const {
@@ -68,11 +70,10 @@ public:
   }
 
   gfx::Rect getCharBounds(int chr) const {
-    chr -= (int)' ';
-    if (chr >= 0 && chr < (int)m_chars.size())
-      return m_chars[chr];
-    if (chr != 128)
-      return getCharBounds(128);
+    if (const Glyph* glyph = findGlyph(chr))
+      return glyph->bounds;
+    if (chr != 128 + (int)' ')
+      return getCharBounds(128 + (int)' ');
     return gfx::Rect();
   }
 
@@ -84,15 +85,116 @@ public:
     gfx::Rect bounds(0, 0, 1, 1);
     gfx::Rect charBounds;
 
+    int codepoint = (int)' ';
     while (font->findChar(sur.get(), sur->width(), sur->height(), bounds, charBounds)) {
-      font->m_chars.push_back(charBounds);
+      font->m_glyphs.push_back(Glyph{ codepoint++, charBounds });
       bounds.x += bounds.w;
     }
 
+    // Pin the sheet as a GPU texture so glyphs are blitted as
+    // texture sub-rect quads on accelerated windows instead of
+    // re-uploading the pixels per draw (no-op without a GPU window)
+    sur->precacheTexture();
+
+    return font;
+  }
+
+  // Like fromSurface() but trying a serialized glyph index first (a
+  // sidecar file next to the sheet image), so known sheets load
+  // without re-scanning the pixel boundaries. When the sidecar is
+  // missing or doesn't match the sheet (e.g. another scale), the
+  // sheet is scanned as usual and the sidecar is (re)written.
+  static FontRef fromSurface(const SurfaceRef& sur,
+                             const std::string& indexFilename) {
+    {
+      std::ifstream is(FSTREAM_PATH(indexFilename), std::ios::binary);
+      if (is) {
+        auto font = make_ref<SpriteSheetFont>();
+        font->m_sheet = sur;
+        if (font->readIndex(is)) {
+          sur->precacheTexture();
+          return font;
+        }
+      }
+    }
+
+    FontRef font = fromSurface(sur);
+    if (font) {
+      std::ofstream os(FSTREAM_PATH(indexFilename), std::ios::binary);
+      if (os)
+        static_cast<SpriteSheetFont*>(font.get())->writeIndex(os);
+    }
     return font;
   }
 
 private:
+  // One entry in the glyph index. The index is a flat array sorted
+  // by codepoint (binary searched), so sparse Unicode ranges don't
+  // need a dense codepoint-offset table.
+  struct Glyph {
+    int codepoint;
+    gfx::Rect bounds;
+  };
+
+  const Glyph* findGlyph(int codepoint) const {
+    auto it = std::lower_bound(
+      m_glyphs.begin(), m_glyphs.end(), codepoint,
+      [](const Glyph& glyph, int codepoint) {
+        return glyph.codepoint < codepoint;
+      });
+    if (it != m_glyphs.end() && it->codepoint == codepoint)
+      return &(*it);
+    return nullptr;
+  }
+
+  void writeIndex(std::ostream& os) const {
+    using namespace base::serialization;
+    using namespace base::serialization::little_endian;
+
+    write32(os, kIndexMagic);
+    write32(os, kIndexVersion);
+    write32(os, m_sheet->width());
+    write32(os, m_sheet->height());
+    write32(os, uint32_t(m_glyphs.size()));
+    for (const Glyph& glyph : m_glyphs) {
+      write32(os, uint32_t(glyph.codepoint));
+      write16(os, uint16_t(glyph.bounds.x));
+      write16(os, uint16_t(glyph.bounds.y));
+      write16(os, uint16_t(glyph.bounds.w));
+      write16(os, uint16_t(glyph.bounds.h));
+    }
+  }
+
+  bool readIndex(std::istream& is) {
+    using namespace base::serialization;
+    using namespace base::serialization::little_endian;
+
+    if (read32(is) != kIndexMagic ||
+        read32(is) != kIndexVersion ||
+        int(read32(is)) != m_sheet->width() ||
+        int(read32(is)) != m_sheet->height())
+      return false;
+
+    const uint32_t n = read32(is);
+    m_glyphs.reserve(n);
+    for (uint32_t i=0; i<n; ++i) {
+      Glyph glyph;
+      glyph.codepoint = int(read32(is));
+      glyph.bounds.x = read16(is);
+      glyph.bounds.y = read16(is);
+      glyph.bounds.w = read16(is);
+      glyph.bounds.h = read16(is);
+
+      // Entries must be sorted by codepoint for findGlyph()
+      if (is.fail() ||
+          (!m_glyphs.empty() && m_glyphs.back().codepoint >= glyph.codepoint)) {
+        m_glyphs.clear();
+        return false;
+      }
+      m_glyphs.push_back(glyph);
+    }
+    return !m_glyphs.empty();
+  }
 
   bool findChar(const Surface* sur, int width, int height,
                 gfx::Rect& bounds, gfx::Rect& charBounds) {
@@ -134,8 +236,14 @@ private:
   }
 
 private:
+  // Sidecar glyph index format: magic, version, sheet size (to
+  // invalidate stale indexes, e.g. when the scale changes), and the
+  // sorted (codepoint, bounds) entries.
+  static constexpr uint32_t kIndexMagic = 0x54464C53; // 'SLFT'
+  static constexpr uint32_t kIndexVersion = 1;
+
   Ref<Surface> m_sheet;
-  std::vector<gfx::Rect> m_chars;
+  std::vector<Glyph> m_glyphs; // Sorted by codepoint
 };
 
 } // namespace os
@@ -0,0 +1,159 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_SURFACE_FORMAT_CONVERT_H
+#define OS_COMMON_SURFACE_FORMAT_CONVERT_H
+#pragma once
+
+#include "base/ints.h"
+#include "os/surface_format.h"
+
+#include <cstring>
+
+namespace os {
+
+// Converts spans of 32-bit pixels between two channel layouts. The
+// conversion is resolved once in the constructor instead of
+// re-deriving masks/shifts per pixel: identical layouts become one
+// memcpy, pairs of byte-aligned layouts (RGBA/BGRA/ARGB/ABGR in any
+// combination) run a fixed-shift loop the compiler can vectorize,
+// and anything else falls back to a generic mask/shift loop with
+// channel-width rescaling.
+class SurfaceFormatConverter {
+public:
+  SurfaceFormatConverter(const SurfaceFormatData& src,
+                         const SurfaceFormatData& dst)
+    : m_src(src)
+    , m_dst(dst) {
+    if (same_layout(src, dst))
+      m_fn = &copy_fn;
+    else if (Fn fn = select_shuffle(src, dst))
+      m_fn = fn;
+    else
+      m_fn = &generic_fn;
+  }
+
+  // Converts n pixels. The buffers must not overlap (converting a
+  // buffer onto itself, dst == src, is fine).
+  void operator()(uint32_t* dst, const uint32_t* src, const int n) const {
+    m_fn(*this, dst, src, n);
+  }
+
+private:
+  using Fn = void(*)(const SurfaceFormatConverter&,
+                     uint32_t*, const uint32_t*, int);
+
+  static bool same_layout(const SurfaceFormatData& a,
+                          const SurfaceFormatData& b) {
+    return (a.redMask == b.redMask && a.redShift == b.redShift &&
+            a.greenMask == b.greenMask && a.greenShift == b.greenShift &&
+            a.blueMask == b.blueMask && a.blueShift == b.blueShift &&
+            a.alphaMask == b.alphaMask && a.alphaShift == b.alphaShift);
+  }
+
+  // True when the format stores one byte per channel at the given
+  // shifts.
+  static bool is_layout(const SurfaceFormatData& f,
+                        const int r, const int g, const int b, const int a) {
+    return (f.bitsPerPixel == 32 &&
+            f.redShift == uint32_t(r) && f.redMask == (0xffu << r) &&
+            f.greenShift == uint32_t(g) && f.greenMask == (0xffu << g) &&
+            f.blueShift == uint32_t(b) && f.blueMask == (0xffu << b) &&
+            f.alphaShift == uint32_t(a) && f.alphaMask == (0xffu << a));
+  }
+
+  static void copy_fn(const SurfaceFormatConverter&,
+                      uint32_t* dst, const uint32_t* src, const int n) {
+    if (dst != src)
+      std::memcpy(dst, src, 4*size_t(n));
+  }
+
+  template<int sR, int sG, int sB, int sA,
+           int dR, int dG, int dB, int dA>
+  static void shuffle_fn(const SurfaceFormatConverter&,
+                         uint32_t* dst, const uint32_t* src, const int n) {
+    for (int i=0; i<n; ++i) {
+      const uint32_t c = src[i];
+      dst[i] = ((((c >> sR) & 0xff) << dR) |
+                (((c >> sG) & 0xff) << dG) |
+                (((c >> sB) & 0xff) << dB) |
+                (((c >> sA) & 0xff) << dA));
+    }
+  }
+
+  template<int sR, int sG, int sB, int sA>
+  static Fn select_shuffle_dst(const SurfaceFormatData& d) {
+    if (is_layout(d, 0, 8, 16, 24)) return &shuffle_fn<sR, sG, sB, sA, 0, 8, 16, 24>;
+    if (is_layout(d, 16, 8, 0, 24)) return &shuffle_fn<sR, sG, sB, sA, 16, 8, 0, 24>;
+    if (is_layout(d, 8, 16, 24, 0)) return &shuffle_fn<sR, sG, sB, sA, 8, 16, 24, 0>;
+    if (is_layout(d, 24, 16, 8, 0)) return &shuffle_fn<sR, sG, sB, sA, 24, 16, 8, 0>;
+    return nullptr;
+  }
+
+  static Fn select_shuffle(const SurfaceFormatData& s,
+                           const SurfaceFormatData& d) {
+    if (is_layout(s, 0, 8, 16, 24)) return select_shuffle_dst<0, 8, 16, 24>(d);
+    if (is_layout(s, 16, 8, 0, 24)) return select_shuffle_dst<16, 8, 0, 24>(d);
+    if (is_layout(s, 8, 16, 24, 0)) return select_shuffle_dst<8, 16, 24, 0>(d);
+    if (is_layout(s, 24, 16, 8, 0)) return select_shuffle_dst<24, 16, 8, 0>(d);
+    return nullptr;
+  }
+
+  // One channel of the generic path: rescales between channel widths
+  // (e.g. 5 -> 8 bits); a channel missing in the source (zero mask,
+  // commonly alpha) saturates in the destination.
+  static uint32_t channel(const uint32_t c,
+                          const uint32_t sMask, const uint32_t sShift,
+                          const uint32_t dMask, const uint32_t dShift) {
+    const uint32_t sMax = (sMask >> sShift);
+    const uint32_t dMax = (dMask >> dShift);
+    if (sMax == 0)
+      return dMask;
+    uint32_t v = ((c & sMask) >> sShift);
+    if (sMax != dMax)
+      v = (v*dMax + sMax/2) / sMax;
+    return ((v << dShift) & dMask);
+  }
+
+  static void generic_fn(const SurfaceFormatConverter& self,
+                         uint32_t* dst, const uint32_t* src, const int n) {
+    const SurfaceFormatData& s = self.m_src;
+    const SurfaceFormatData& d = self.m_dst;
+    for (int i=0; i<n; ++i) {
+      const uint32_t c = src[i];
+      dst[i] = (channel(c, s.redMask, s.redShift, d.redMask, d.redShift) |
+                channel(c, s.greenMask, s.greenShift, d.greenMask, d.greenShift) |
+                channel(c, s.blueMask, s.blueShift, d.blueMask, d.blueShift) |
+                channel(c, s.alphaMask, s.alphaShift, d.alphaMask, d.alphaShift));
+    }
+  }
+
+  Fn m_fn;
+  SurfaceFormatData m_src;
+  SurfaceFormatData m_dst;
+};
+
+// Layout of native cursor/icon pixel buffers (alpha in the top byte,
+// then red, green, blue), shared by the Windows and X11 back-ends.
+inline SurfaceFormatData argb_format_data() {
+  SurfaceFormatData f;
+  f.format = kRgbaSurfaceFormat;
+  f.premultipliedAlpha = false;
+  f.bitsPerPixel = 32;
+  f.redShift = 16;
+  f.greenShift = 8;
+  f.blueShift = 0;
+  f.alphaShift = 24;
+  f.redMask = 0x00ff0000;
+  f.greenMask = 0x0000ff00;
+  f.blueMask = 0x000000ff;
+  f.alphaMask = 0xff000000;
+  return f;
+}
+
+} // namespace os
+
+#endif
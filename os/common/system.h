@@ -28,9 +28,13 @@
 #include "os/common/sprite_sheet_font.h"
 #include "os/event_queue.h"
 #include "os/menus.h"
+#include "os/surface.h"
+#include "os/surface_format.h"
 #include "os/system.h"
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace os {
 
@@ -84,13 +88,89 @@ public:
     return EventQueue::instance();
   }
 
+  // The screen topology is cached because these are called by
+  // per-frame DPI/layout logic and the backends query the OS each
+  // time (monitor enumeration, workarea properties, etc.). The cache
+  // is dropped by invalidateScreens() when the OS notifies a display
+  // change.
+  ScreenRef mainScreen() override {
+    if (!m_mainScreen)
+      m_mainScreen = onMainScreen();
+    return m_mainScreen;
+  }
+
+  void listScreens(ScreenList& list) override {
+    if (!m_screensCached) {
+      m_screens.clear();
+      onListScreens(m_screens);
+      m_screensCached = true;
+    }
+    for (auto& screen : m_screens)
+      list.push_back(screen);
+  }
+
+  // Called by the backends when the OS reports a change in the
+  // monitor topology (WM_DISPLAYCHANGE, a ConfigureNotify on the X11
+  // root window, NSApplicationDidChangeScreenParameters...): drops
+  // the cached screens and notifies the client with an
+  // Event::ScreenChange.
+  void invalidateScreens() {
+    m_screensCached = false;
+    m_screens.clear();
+    m_mainScreen.reset();
+
+    Event ev;
+    ev.setType(Event::ScreenChange);
+    queue_event(ev);
+  }
+
+  // Cursors built from a surface are cached: switching tools flips
+  // between the same few cursors dozens of times per second, and
+  // rebuilding one uploads the pixels to the X server (or allocates
+  // GDI objects) every time. The key includes a hash of the pixel
+  // content, so redrawing the cursor surface with different content
+  // just misses the cache, and stale entries fall out of the LRU.
+  Ref<Cursor> makeCursor(const Surface* surface,
+                         const gfx::Point& focus,
+                         const int scale) override {
+    ASSERT(surface);
+    if (!surface)
+      return nullptr;
+
+    const uint64_t hash = hashCursorSurface(surface);
+    for (auto it=m_cursorCache.begin(); it!=m_cursorCache.end(); ++it) {
+      if (it->hash == hash &&
+          it->focus == focus &&
+          it->scale == scale) {
+        // Move the entry to the front (most recently used).
+        CursorCacheEntry entry = std::move(*it);
+        m_cursorCache.erase(it);
+        m_cursorCache.insert(m_cursorCache.begin(), std::move(entry));
+        return m_cursorCache.front().cursor;
+      }
+    }
+
+    Ref<Cursor> cursor = onMakeCursor(surface, focus, scale);
+    if (cursor) {
+      m_cursorCache.insert(m_cursorCache.begin(),
+                           CursorCacheEntry{ hash, focus, scale, cursor });
+      if (int(m_cursorCache.size()) > kCursorCacheSize)
+        m_cursorCache.pop_back();
+    }
+    return cursor;
+  }
+
   FontRef loadSpriteSheetFont(const char* filename, int scale) override {
     SurfaceRef sheet = loadRgbaSurface(filename);
     FontRef font = nullptr;
     if (sheet) {
       sheet->applyScale(scale);
       sheet->setImmutable();
-      font = SpriteSheetFont::fromSurface(sheet);
+      // The sidecar glyph index avoids re-scanning the sheet pixels
+      // on every startup (it's keyed by the scaled sheet size, so
+      // one file per filename is enough)
+      font = SpriteSheetFont::fromSurface(sheet,
+                                          std::string(filename) + ".glyphs");
     }
     return font;
   }
@@ -106,21 +186,34 @@ public:
   }
 
   KeyModifiers keyModifiers() override {
+    // One keyboard snapshot instead of ten isKeyPressed() queries
+    const KeyStates states = keyStates();
     return
       (KeyModifiers)
-      ((isKeyPressed(kKeyLShift) ||
-        isKeyPressed(kKeyRShift) ? kKeyShiftModifier: 0) |
-       (isKeyPressed(kKeyLControl) ||
-        isKeyPressed(kKeyRControl) ? kKeyCtrlModifier: 0) |
-       (isKeyPressed(kKeyAlt) ? kKeyAltModifier: 0) |
-       (isKeyPressed(kKeyAltGr) ? (kKeyCtrlModifier | kKeyAltModifier): 0) |
-       (isKeyPressed(kKeyCommand) ? kKeyCmdModifier: 0) |
-       (isKeyPressed(kKeySpace) ? kKeySpaceModifier: 0) |
-       (isKeyPressed(kKeyLWin) ||
-        isKeyPressed(kKeyRWin) ? kKeyWinModifier: 0));
+      ((states.isPressed(kKeyLShift) ||
+        states.isPressed(kKeyRShift) ? kKeyShiftModifier: 0) |
+       (states.isPressed(kKeyLControl) ||
+        states.isPressed(kKeyRControl) ? kKeyCtrlModifier: 0) |
+       (states.isPressed(kKeyAlt) ? kKeyAltModifier: 0) |
+       (states.isPressed(kKeyAltGr) ? (kKeyCtrlModifier | kKeyAltModifier): 0) |
+       (states.isPressed(kKeyCommand) ? kKeyCmdModifier: 0) |
+       (states.isPressed(kKeySpace) ? kKeySpaceModifier: 0) |
+       (states.isPressed(kKeyLWin) ||
+        states.isPressed(kKeyRWin) ? kKeyWinModifier: 0));
   }
 
 protected:
+  // Builds the native cursor (called by makeCursor() on a cache
+  // miss).
+  virtual Ref<Cursor> onMakeCursor(const Surface* surface,
+                                   const gfx::Point& focus,
+                                   const int scale) = 0;
+
+  // Query the OS for the screen topology (called by
+  // mainScreen()/listScreens() when the cache is empty).
+  virtual ScreenRef onMainScreen() = 0;
+  virtual void onListScreens(ScreenList& list) = 0;
+
   // This must be called in the final class that derived from
   // CommonSystem, because clearing the list of events can generate
   // events on windows that will depend on the platform-specific
@@ -146,10 +239,53 @@ protected:
     //      EventQueue::instance() comment on laf/os/event_queue.h).
     eventQueue()->clearEvents();
 
+    // Release the cached cursors/screens while the platform-specific
+    // System (and its native connections, e.g. the X11 display) is
+    // alive.
+    m_cursorCache.clear();
+    m_screens.clear();
+    m_mainScreen.reset();
+
     set_instance(nullptr);
   }
 
 private:
+  struct CursorCacheEntry {
+    uint64_t hash;
+    gfx::Point focus;
+    int scale;
+    Ref<Cursor> cursor;
+  };
+
+  // FNV-1a over the surface dimensions and pixels.
+  static uint64_t hashCursorSurface(const Surface* surface) {
+    SurfaceFormatData format;
+    surface->getFormat(&format);
+
+    const int w = surface->width();
+    const int h = surface->height();
+    const int rowBytes = w*format.bitsPerPixel/8;
+
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const uint8_t v) {
+      hash = (hash ^ v) * 1099511628211ull;
+    };
+    mix(uint8_t(w)); mix(uint8_t(w >> 8));
+    mix(uint8_t(h)); mix(uint8_t(h >> 8));
+    for (int y=0; y<h; ++y) {
+      const uint8_t* row = surface->getData(0, y);
+      for (int i=0; i<rowBytes; ++i)
+        mix(row[i]);
+    }
+    return hash;
+  }
+
+  static const int kCursorCacheSize = 16;
+
+  std::vector<CursorCacheEntry> m_cursorCache;
+  ScreenList m_screens;
+  ScreenRef m_mainScreen;
+  bool m_screensCached = false;
   Ref<NativeDialogs> m_nativeDialogs;
 #ifdef LAF_FREETYPE
   std::unique_ptr<ft::Lib> m_ft;
@@ -0,0 +1,138 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_WINDOW_EVENT_QUEUE_H
+#define OS_COMMON_WINDOW_EVENT_QUEUE_H
+#pragma once
+
+#include "base/concurrent_queue.h"
+#include "base/time.h"
+#include "os/event.h"
+#include "os/event_queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace os {
+
+// Queue that receives the events of one window (see
+// Window::setUseDedicatedEventQueue()), consumed by the thread
+// running that window's event loop. Unlike the platform queue it
+// doesn't pump native messages (the platform queue keeps doing that
+// on its own thread and the events are routed here), so getEvent()
+// is just a condition-variable wait.
+class WindowEventQueue : public EventQueue {
+public:
+  void queueEvent(const Event& ev) override {
+    if (filterEvent(ev))
+      return;
+    {
+      // The push must happen under the mutex: a notify issued
+      // between the getEvent() predicate check and its block would
+      // be lost, leaving the consumer asleep with an event queued
+      const std::lock_guard lock(m_mutex);
+      m_events.push(ev);
+    }
+    m_wakeup.notify_one();
+  }
+
+  void getEvent(Event& ev, double timeout) override {
+    ev.setType(Event::None);
+
+    std::unique_lock lock(m_mutex);
+    const auto hasEvents = [this]{
+      return (hasPendingEvent() || !m_events.empty());
+    };
+
+    const base::tick_t until =
+      (timeout == kWithoutTimeout ? 0:
+       base::current_tick() + base::tick_t(timeout*1000.0));
+
+    while (!hasEvents()) {
+      const base::tick_t now = base::current_tick();
+
+      // Convert expired timers into Timer events (several missed
+      // expirations coalesce into one, as in the platform queues)
+      // and find the next expiration to bound the wait below.
+      base::tick_t nextDue = 0;
+      for (auto& [timerId, timer] : m_timers) {
+        if (timer.due <= now) {
+          timer.due = now + timer.interval;
+          Event timerEv;
+          timerEv.setType(Event::Timer);
+          timerEv.setTimerId(timerId);
+          if (!filterEvent(timerEv))
+            m_events.push(timerEv);
+        }
+        if (nextDue == 0 || timer.due < nextDue)
+          nextDue = timer.due;
+      }
+      if (hasEvents())
+        break;
+
+      if (timeout != kWithoutTimeout && now >= until)
+        break;
+
+      if (timeout == kWithoutTimeout && !nextDue) {
+        m_wakeup.wait(lock, hasEvents);
+      }
+      else {
+        base::tick_t wakeAt = nextDue;
+        if (timeout != kWithoutTimeout && (!wakeAt || until < wakeAt))
+          wakeAt = until;
+        m_wakeup.wait_for(lock, std::chrono::milliseconds(wakeAt - now),
+                          hasEvents);
+      }
+    }
+    popEvent(m_events, ev);
+  }
+
+  void clearEvents() override {
+    const std::lock_guard lock(m_mutex);
+    m_events.clear();
+    clearPendingEvent();
+  }
+
+  void discardIf(const EventFilter& pred) override {
+    const std::lock_guard lock(m_mutex);
+    discardEvents(m_events, pred);
+  }
+
+  // Timers of a dedicated queue tick locally, driven by the
+  // getEvent() wait deadline, instead of being registered as native
+  // timers of the platform queue (whose Timer events would be
+  // consumed by the platform queue thread, not by this window's).
+  void addTimer(int intervalMsecs, int timerId) override {
+    const std::lock_guard lock(m_mutex);
+    m_timers[timerId] = Timer{ base::tick_t(intervalMsecs),
+                               base::current_tick() + intervalMsecs };
+  }
+
+  void removeTimer(int timerId) override {
+    const std::lock_guard lock(m_mutex);
+    m_timers.erase(timerId);
+  }
+
+private:
+  struct Timer {
+    base::tick_t interval;      // Milliseconds between expirations
+    base::tick_t due;           // Tick of the next expiration
+  };
+
+  base::concurrent_queue<Event> m_events;
+  std::map<int, Timer> m_timers;
+
+  // Guards the consumer-side state of EventQueue (pending coalesced
+  // event) and the getEvent() wait.
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+};
+
+} // namespace os
+
+#endif
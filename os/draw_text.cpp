@@ -18,6 +18,13 @@
 #include "os/common/generic_surface.h"
 #include "os/common/sprite_sheet_font.h"
 
+#if LAF_SKIA
+  #include "os/skia/skia_glyph_atlas.h"
+  #include "os/skia/skia_surface.h"
+#endif
+
+#include <vector>
+
 namespace os {
 
 gfx::Rect draw_text(Surface* surface, Font* font,
@@ -37,11 +44,8 @@ retry:;
     //      same in the drawing code of sprite sheet font
     while (const uint32_t code = decode.next()) {
       if (code && !font->hasCodePoint(code)) {
-        Font* newFont = font->fallback();
-
-        // Search a valid fallback
-        while (newFont && !newFont->hasCodePoint(code))
-          newFont = newFont->fallback();
+        // Search a valid fallback (cached per codepoint)
+        Font* newFont = font->fallbackForCodePoint(code);
         if (!newFont)
           break;
 
@@ -63,11 +67,11 @@ retry:;
       SpriteSheetFont* ssFont = static_cast<SpriteSheetFont*>(font);
       Surface* sheet = ssFont->sheetSurface();
 
-      if (surface) {
-        sheet->lock();
-        surface->lock();
-      }
-
+      // Batch the whole text as one run: the delegate gets one
+      // preDrawRun() call with all the per-glyph data instead of
+      // three virtual calls per character.
+      GlyphRun run;
+      std::vector<gfx::Rect> sheetBounds; // Glyph bounds inside the sheet
       decode = base::utf8_decode(text);
       while (true) {
         const int i = decode.pos() - text.begin();
@@ -76,30 +80,37 @@ retry:;
           break;
 
         const gfx::Rect charBounds = ssFont->getCharBounds(chr);
-        const gfx::Rect outCharBounds(x, y, charBounds.w, charBounds.h);
-
-        if (delegate)
-          delegate->preProcessChar(i, chr, fg, bg, outCharBounds);
-
-        if (delegate && !delegate->preDrawChar(outCharBounds))
-          break;
-
-        if (!charBounds.isEmpty()) {
-          if (surface)
-            surface->drawColoredRgbaSurface(sheet, fg, bg, gfx::Clip(x, y, charBounds));
-        }
-
-        textBounds |= outCharBounds;
-        if (delegate)
-          delegate->postDrawChar(outCharBounds);
+        run.glyphs.push_back(
+          GlyphRun::Glyph{ i, chr, gfx::Rect(x, y, charBounds.w, charBounds.h) });
+        sheetBounds.push_back(charBounds);
 
         x += charBounds.w;
       }
 
-      if (surface) {
+      bool draw = true;
+      if (delegate)
+        draw = delegate->preDrawRun(run, fg, bg);
+
+      if (surface && draw && !run.glyphs.empty()) {
+        sheet->lock();
+        surface->lock();
+        for (size_t i=0; i<run.glyphs.size(); ++i) {
+          if (!sheetBounds[i].isEmpty()) {
+            surface->drawColoredRgbaSurface(
+              sheet, fg, bg,
+              gfx::Clip(run.glyphs[i].bounds.x,
+                        run.glyphs[i].bounds.y, sheetBounds[i]));
+          }
+        }
         surface->unlock();
         sheet->unlock();
       }
+
+      for (const GlyphRun::Glyph& glyph : run.glyphs)
+        textBounds |= glyph.bounds;
+
+      if (delegate)
+        delegate->postDrawRun(run, textBounds);
       break;
     }
 
@@ -108,13 +119,25 @@ retry:;
       const int fg_alpha = gfx::geta(fg);
 
       gfx::Rect clipBounds;
-      os::SurfaceFormatData fd;
       if (surface) {
         clipBounds = surface->getClipBounds();
-        surface->getFormat(&fd);
         surface->lock();
       }
 
+      // Positioned glyphs of the whole text: accumulated first and
+      // then composited in a single pass over the destination rows,
+      // so a long label pays the setup (lock, clip, format) once
+      // instead of once per character.
+      std::vector<FreeTypeFont::RunGlyph> run;
+
+      // Per-glyph data for the delegate (one preDrawRun() call for
+      // the whole text), with, for each entry, the bounds that
+      // accumulate into textBounds and its index inside "run" (-1
+      // when the glyph has no pixels to composite).
+      GlyphRun glyphRun;
+      std::vector<gfx::Rect> drawnBounds;
+      std::vector<int> pixelIndex;
+
       ft::ForEachGlyph<FreeTypeFont::Face> feg(ttFont->face(), text);
       while (feg.next()) {
         gfx::Rect origDstBounds;
@@ -126,72 +149,99 @@ retry:;
             int(glyph->endX) - int(glyph->startX),
             int(glyph->bitmap->rows) ? int(glyph->bitmap->rows): 1);
 
-        if (delegate) {
-          delegate->preProcessChar(
-            feg.charIndex(),
-            feg.unicodeChar(),
-            fg, bg, origDstBounds);
+        glyphRun.glyphs.push_back(
+          GlyphRun::Glyph{ feg.charIndex(),
+                           feg.unicodeChar(),
+                           origDstBounds });
+
+        gfx::Rect bmpBounds;
+        int pix = -1;
+        if (glyph) {
+          bmpBounds = gfx::Rect(x + int(glyph->x),
+                                y + int(glyph->y),
+                                int(glyph->bitmap->width),
+                                int(glyph->bitmap->rows));
+
+          gfx::Rect dstBounds = bmpBounds;
+          if (surface)
+            dstBounds &= clipBounds;
+
+          if (surface && !dstBounds.isEmpty()) {
+            // Cached 8-bpp coverage of this glyph, expanded from the
+            // FreeType bitmap only the first time it's drawn
+            pix = int(run.size());
+            run.push_back(
+              FreeTypeFont::RunGlyph{
+                glyph->glyph_index,
+                &ttFont->glyphBitmap(glyph->glyph_index, glyph->bitmap),
+                dstBounds,
+                bmpBounds.origin() });
+          }
+
+          if (!bmpBounds.w) bmpBounds.w = 1;
+          if (!bmpBounds.h) bmpBounds.h = 1;
+        }
+        drawnBounds.push_back(bmpBounds);
+        pixelIndex.push_back(pix);
+      }
+
+      bool draw = true;
+      if (delegate)
+        draw = delegate->preDrawRun(glyphRun, fg, bg);
+
+      // If the delegate truncated the run, drop the pixel glyphs of
+      // the removed entries too
+      if (glyphRun.glyphs.size() < pixelIndex.size()) {
+        size_t keep = 0;
+        for (size_t i=0; i<glyphRun.glyphs.size(); ++i) {
+          if (pixelIndex[i] >= 0)
+            keep = size_t(pixelIndex[i])+1;
         }
+        run.resize(keep);
+      }
+      if (!draw)
+        run.clear();
 
-        if (!glyph)
-          continue;
+      for (size_t i=0; i<glyphRun.glyphs.size(); ++i) {
+        if (!drawnBounds[i].isEmpty())
+          textBounds |= drawnBounds[i];
+      }
 
-        if (delegate && !delegate->preDrawChar(origDstBounds))
-          break;
+      // Composite the whole run in one pass over the destination
+      // rows. The view is invalid e.g. for a SkiaSurface with a
+      // nullptr m_bitmap (when GPU-acceleration is enabled).
+      const SurfacePixels view = (surface ? surface->pixels():
+                                            SurfacePixels());
+#if LAF_SKIA
+      if (!run.empty() && !view.valid() && surface) {
+        // GPU-backed surface without directly accessible pixels:
+        // draw the run as textured quads from the shared glyph atlas
+        draw_glyph_run_with_atlas(static_cast<SkiaSurface*>(surface),
+                                  ttFont, run, fg, bg);
+      }
+      else
+#endif
+      if (!run.empty() && view.valid()) {
+        const SurfaceFormatData& fd = view.format;
 
-        origDstBounds.x = x + int(glyph->x);
-        origDstBounds.w = int(glyph->bitmap->width);
-        origDstBounds.h = int(glyph->bitmap->rows);
-
-        gfx::Rect dstBounds = origDstBounds;
-        if (surface)
-          dstBounds &= clipBounds;
-
-        if (surface && !dstBounds.isEmpty()) {
-          const int clippedRows = dstBounds.y - origDstBounds.y;
-          int dst_y = dstBounds.y;
-          int t;
-          for (int v=0; v<dstBounds.h; ++v, ++dst_y) {
-            int bit = 0;
-            const uint8_t* p = glyph->bitmap->buffer
-              + (v+clippedRows)*glyph->bitmap->pitch;
-            int dst_x = dstBounds.x;
-            uint32_t* dst_address =
-              (uint32_t*)surface->getData(dst_x, dst_y);
-
-            // TODO maybe if we are trying to draw in a SkiaSurface with a nullptr m_bitmap
-            //      (when GPU-acceleration is enabled)
-            if (!dst_address)
-              break;
-
-            // Skip first clipped pixels
-            for (int u=0; u<dstBounds.x-origDstBounds.x; ++u) {
-              if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_GRAY) {
-                ++p;
-              }
-              else if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
-                if (++bit == 8) {
-                  bit = 0;
-                  ++p;
-                }
-              }
-            }
+        gfx::Rect runBounds;
+        for (const FreeTypeFont::RunGlyph& g : run)
+          runBounds |= g.bounds;
+
+        int t;
+        for (int dst_y=runBounds.y; dst_y<runBounds.y2(); ++dst_y) {
+          for (const FreeTypeFont::RunGlyph& g : run) {
+            if (dst_y < g.bounds.y || dst_y >= g.bounds.y2())
+              continue;
+
+            const uint8_t* p = g.coverage->row(dst_y - g.orig.y)
+              + (g.bounds.x - g.orig.x);
+            uint32_t* dst_address = view.row32(dst_y) + g.bounds.x;
 
-            for (int u=0; u<dstBounds.w; ++u, ++dst_x) {
-              ASSERT(clipBounds.contains(gfx::Point(dst_x, dst_y)));
-
-              int alpha;
-              if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_GRAY) {
-                alpha = *(p++);
-              }
-              else if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
-                alpha = ((*p) & (1 << (7 - (bit++))) ? 255: 0);
-                if (bit == 8) {
-                  bit = 0;
-                  ++p;
-                }
-              }
+            for (int u=0; u<g.bounds.w; ++u) {
+              ASSERT(clipBounds.contains(gfx::Point(g.bounds.x+u, dst_y)));
 
+              const int alpha = *(p++);
               const uint32_t backdrop = *dst_address;
               const gfx::Color backdropColor =
                 gfx::rgba(
@@ -219,16 +269,13 @@ retry:;
             }
           }
         }
-
-        if (!origDstBounds.w) origDstBounds.w = 1;
-        if (!origDstBounds.h) origDstBounds.h = 1;
-        textBounds |= origDstBounds;
-        if (delegate)
-          delegate->postDrawChar(origDstBounds);
       }
 
       if (surface)
         surface->unlock();
+
+      if (delegate)
+        delegate->postDrawRun(glyphRun, textBounds);
       break;
     }
 
@@ -12,6 +12,9 @@
 #include "base/string.h"
 #include "gfx/color.h"
 #include "gfx/fwd.h"
+#include "gfx/rect.h"
+
+#include <vector>
 
 namespace os {
 
@@ -21,11 +24,59 @@ namespace os {
 
   enum class TextAlign { Left, Center, Right };
 
+  // A run of glyphs drawn with uniform style (the same fg/bg
+  // colors), with its per-glyph data batched in arrays as passed to
+  // DrawTextDelegate::preDrawRun().
+  struct GlyphRun {
+    struct Glyph {
+      int index;          // UTF-8 byte index of the char in the string
+      int codepoint;
+      gfx::Rect bounds;   // Bounds where the glyph will be drawn
+    };
+    std::vector<Glyph> glyphs;
+  };
+
   class DrawTextDelegate {
   public:
     virtual ~DrawTextDelegate() { }
 
-    // This is called before drawing the character.
+    // Run-level protocol: draw_text() processes the whole text and
+    // calls preDrawRun() once with all the per-glyph data, so
+    // delegates don't serialize glyph batching on three virtual
+    // calls per character. Changing fg/bg applies to the whole run,
+    // and run.glyphs can be truncated to stop the process at some
+    // glyph. Returning false processes the run (bounds, callbacks)
+    // without drawing it.
+    //
+    // The default implementation replays the per-character protocol
+    // below, so delegates overriding only those member functions
+    // keep working unchanged (at the cost of the per-character
+    // virtual dispatch).
+    virtual bool preDrawRun(GlyphRun& run,
+                            gfx::Color& fg,
+                            gfx::Color& bg) {
+      size_t n = 0;
+      for (const GlyphRun::Glyph& glyph : run.glyphs) {
+        preProcessChar(glyph.index, glyph.codepoint, fg, bg, glyph.bounds);
+        if (!preDrawChar(glyph.bounds))
+          break;
+        postDrawChar(glyph.bounds);
+        ++n;
+      }
+      if (n < run.glyphs.size())
+        run.glyphs.resize(n);
+      return true;
+    }
+
+    // Called after the (possibly truncated) run was drawn, with the
+    // final bounds of the whole text.
+    virtual void postDrawRun(const GlyphRun& run,
+                             const gfx::Rect& bounds) {
+      // Do nothing
+    }
+
+    // Per-character protocol, called from the default preDrawRun()
+    // implementation before drawing each character.
     virtual void preProcessChar(const int index,
                                 const int codepoint,
                                 gfx::Color& fg,
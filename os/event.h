@@ -10,6 +10,7 @@
 #pragma once
 
 #include "base/paths.h"
+#include "base/time.h"
 #include "gfx/point.h"
 #include "gfx/size.h"
 #include "os/keys.h"
@@ -17,6 +18,8 @@
 #include "os/window.h"
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 #pragma push_macro("None")
 #undef None // Undefine the X11 None macro
@@ -60,6 +63,24 @@ namespace os {
       // Pinch gesture with fingers to zoom in/out
       TouchMagnify,
       Callback,
+
+      // Frame tick aligned with the display refresh, requested with
+      // Window::requestFrame()
+      Frame,
+
+      // Periodic tick of a timer registered with
+      // EventQueue::addTimer() (the timer is identified by timerId())
+      Timer,
+
+      // The window visibility state changed (see
+      // Window::visibility()), e.g. it was minimized or completely
+      // covered by other windows, so painting work can be skipped.
+      VisibilityChange,
+
+      // The screen topology changed (monitors added/removed or the
+      // resolution/workarea changed), System::listScreens() and
+      // System::mainScreen() will return fresh values.
+      ScreenChange,
     };
 
     enum MouseButton {
@@ -71,6 +92,18 @@ namespace os {
       X2Button,
     };
 
+    // One intermediate pointer sample attached to a MouseMove event,
+    // either preserved when consecutive events are coalesced
+    // (EventQueue::setCoalescePointerEvents()) or reported by the
+    // platform as intra-frame motion history, so painting code can
+    // still interpolate strokes through the intermediate
+    // positions/pressures.
+    struct PointerSample {
+      gfx::Point position;
+      float pressure = 0.0f;
+      base::tick_t tick = 0;    // Same clock as Event::timestamp()
+    };
+
     Event() : m_type(None),
               m_window(nullptr),
               m_scancode(kKeyNil),
@@ -82,12 +115,16 @@ namespace os {
               m_pointerType(PointerType::Unknown),
               m_button(NoneButton),
               m_magnification(0.0f),
-              m_pressure(0.0f) {
+              m_pressure(0.0f),
+              m_timestamp(base::current_tick()) {
     }
 
     Type type() const { return m_type; }
     const WindowRef& window() const { return m_window; }
-    const base::paths& files() const { return m_files; }
+    const base::paths& files() const {
+      static const base::paths empty;
+      return (m_payload ? m_payload->files: empty);
+    }
     // TODO Rename this to virtualKey(), which is the real
     // meaning. Then we need another kind of "scan code" with the
     // position in the keyboard, which might be useful to identify
@@ -108,13 +145,60 @@ namespace os {
 
     PointerType pointerType() const { return m_pointerType; }
     MouseButton button() const { return m_button; }
+    int timerId() const { return m_timerId; }
     float magnification() const { return m_magnification; }
     float pressure() const { return m_pressure; }
 
+    // Monotonic tick (base::current_tick(), in milliseconds) of the
+    // moment the event was created, i.e. when the platform message
+    // was received and converted. Used to measure how long the event
+    // sat in the queue (EventQueue::stats()). Coalesced events keep
+    // the timestamp of the oldest merged event.
+    base::tick_t timestamp() const { return m_timestamp; }
+
+    // Samples of the events that were coalesced into this one, oldest
+    // first (the event's own position/pressure is the newest
+    // sample). Empty unless EventQueue::setCoalescePointerEvents()
+    // was enabled.
+    const std::vector<PointerSample>& history() const { return m_history; }
+    void addHistorySample(const PointerSample& sample) { m_history.push_back(sample); }
+
+    // Tries to merge this (older, already queued) event with a newer
+    // one: this event takes the newer data and keeps its own samples
+    // in history(). Returns false when the events cannot be coalesced
+    // (different type, window or input state).
+    bool coalesceWith(const Event& newer) {
+      if (m_type != newer.m_type ||
+          m_window != newer.m_window ||
+          m_modifiers != newer.m_modifiers)
+        return false;
+
+      switch (m_type) {
+
+        case MouseMove:
+          if (m_pointerType != newer.m_pointerType ||
+              m_button != newer.m_button)
+            return false;
+          m_history.push_back(PointerSample{ m_position, m_pressure, m_timestamp });
+          m_history.insert(m_history.end(),
+                           newer.m_history.begin(),
+                           newer.m_history.end());
+          m_position = newer.m_position;
+          m_pressure = newer.m_pressure;
+          return true;
+
+        case TouchMagnify:
+          m_position = newer.m_position;
+          m_magnification += newer.m_magnification;
+          return true;
+      }
+      return false;
+    }
+
     void setType(Type type) { m_type = type; }
     void setWindow(const WindowRef& window) { m_window = window; }
-    void setFiles(const base::paths& files) { m_files = files; }
-    void setCallback(std::function<void()>&& func) { m_callback = std::move(func); }
+    void setFiles(const base::paths& files) { payload().files = files; }
+    void setCallback(std::function<void()>&& func) { payload().callback = std::move(func); }
 
     void setScancode(KeyScancode scancode) { m_scancode = scancode; }
     void setModifiers(KeyModifiers modifiers) { m_modifiers = modifiers; }
@@ -128,14 +212,33 @@ namespace os {
     void setButton(MouseButton button) { m_button = button; }
     void setMagnification(float magnification) { m_magnification = magnification; }
     void setPressure(float pressure) { m_pressure = pressure; }
+    void setTimestamp(base::tick_t timestamp) { m_timestamp = timestamp; }
+    void setTimerId(int timerId) { m_timerId = timerId; }
 
-    void execCallback() { if (m_callback) m_callback(); }
+    void execCallback() {
+      if (m_payload && m_payload->callback)
+        m_payload->callback();
+    }
 
   private:
+    // The DropFiles/Callback payloads are rare and heavy (a vector of
+    // strings, a std::function), so they live out-of-line shared
+    // between copies of the event: hot mouse/key events stay flat and
+    // copying a queued event never duplicates them.
+    struct Payload {
+      base::paths files;
+      std::function<void()> callback;
+    };
+
+    Payload& payload() {
+      if (!m_payload)
+        m_payload = std::make_shared<Payload>();
+      return *m_payload;
+    }
+
     Type m_type;
     WindowRef m_window;
-    base::paths m_files;
-    std::function<void()> m_callback;
+    std::shared_ptr<Payload> m_payload;
     KeyScancode m_scancode;
     KeyModifiers m_modifiers;
     int m_unicodeChar;
@@ -150,8 +253,17 @@ namespace os {
     // For TouchMagnify event
     float m_magnification;
 
+    // For Timer event (see EventQueue::addTimer())
+    int m_timerId = 0;
+
     // Pressure of stylus used in mouse-like events
     float m_pressure;
+
+    // Samples of coalesced events (see coalesceWith())
+    std::vector<PointerSample> m_history;
+
+    // Creation tick, see timestamp()
+    base::tick_t m_timestamp;
   };
 
 } // namespace os
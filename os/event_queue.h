@@ -9,14 +9,26 @@
 #define OS_EVENT_QUEUE_H_INCLUDED
 #pragma once
 
+#include "os/event.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 namespace os {
 
-  class Event;
+  class EventRecorder;
 
   class EventQueue {
   public:
     static constexpr const double kWithoutTimeout = -1.0;
 
+    // Predicate over events, returns true for the events that must be
+    // dropped/discarded.
+    using EventFilter = std::function<bool(const Event&)>;
+
     virtual ~EventQueue() { }
 
     // Wait for a new event. We can specify a timeout in seconds to
@@ -36,6 +48,62 @@ namespace os {
     // alive.
     virtual void clearEvents() = 0;
 
+    // Sets a filter evaluated in queueEvent(): events for which it
+    // returns true are dropped at the source, so e.g. a modal
+    // operation can discard mouse-move storms without paying to
+    // dequeue them one by one. Reset with nullptr. The filter is
+    // called from the producer thread.
+    void setFilter(EventFilter filter) {
+      const std::lock_guard lock(m_filterMutex);
+      m_hasFilter = (filter != nullptr);
+      m_filter = std::move(filter);
+    }
+
+    // Registers a native timer (timerfd/SetTimer/NSTimer depending on
+    // the platform) that queues an Event::Timer with the given id
+    // every interval, so many timers coalesce into the one
+    // kernel-managed wait of getEvent() instead of costing a spurious
+    // wakeup per tick. Adding a timer with an id already in use
+    // replaces its interval. Both functions must be called from the
+    // same thread that runs getEvent().
+    virtual void addTimer(int intervalMsecs, int timerId) = 0;
+    virtual void removeTimer(int timerId) = 0;
+
+    // Discards the already queued events for which the predicate
+    // returns true, a finer-grained version of clearEvents(). Must be
+    // called from the consumer (UI) thread; events queued from other
+    // threads while discarding are kept but can end up after the
+    // surviving ones.
+    virtual void discardIf(const EventFilter& pred) = 0;
+
+    // Enables/disables coalescing of consecutive MouseMove/
+    // TouchMagnify events for the same window in queueEvent(), so
+    // high-rate tablets don't flood the queue faster than the UI can
+    // drain it (each event allocation/pop has a cost, and painting
+    // code only needs the latest state plus the intermediate samples,
+    // available in Event::history()). Disabled by default as some
+    // clients expect one event per input report.
+    static void setCoalescePointerEvents(bool state);
+    static bool coalescePointerEvents();
+
+    // Queue dwell-time statistics: milliseconds between the event
+    // creation (Event::timestamp(), stamped when the platform message
+    // is received) and the moment getEvent() delivers it. This is the
+    // number to look at when diagnosing input lag reports.
+    struct Stats {
+      int events = 0;           // Events delivered since resetStats()
+      double dwellP50 = 0.0;    // Median dwell time (msecs)
+      double dwellP99 = 0.0;    // 99th percentile dwell time (msecs)
+      double dwellMax = 0.0;    // Longest dwell time seen (msecs)
+    };
+    static Stats stats();
+    static void resetStats();
+
+    // Hooks a recorder (see os/event_recorder.h) that receives every
+    // event delivered by getEvent(), or nullptr to stop recording.
+    // Must be called from the consumer (UI) thread.
+    static void setRecorder(EventRecorder* recorder);
+
     // Deprecated old method. We should remove this line after some
     // releases. It's here to avoid calling getEvent(Event&, double)
     // even when we use a bool 2nd argument.
@@ -46,6 +114,84 @@ namespace os {
     // file is queued in application:openFile:, code which is executed
     // before the user's main() code.
     static EventQueue* instance();
+
+  protected:
+    // Pops the next event from the given queue, merging consecutive
+    // coalescible pointer events when coalescePointerEvents() is
+    // enabled. Must be called only from the consumer (UI) thread: the
+    // first non-coalescible event popped while merging is kept as a
+    // pending event for the next call.
+    template<typename Queue>
+    bool popEvent(Queue& queue, Event& ev) {
+      if (m_hasPendingEvent) {
+        ev = std::move(m_pendingEvent);
+        m_hasPendingEvent = false;
+      }
+      else if (!queue.try_pop(ev))
+        return false;
+
+      recordDwellTime(ev.timestamp());
+      recordEvent(ev);
+
+      if (coalescePointerEvents()) {
+        Event next;
+        while (queue.try_pop(next)) {
+          if (!ev.coalesceWith(next)) {
+            m_pendingEvent = std::move(next);
+            m_hasPendingEvent = true;
+            break;
+          }
+        }
+      }
+      return true;
+    }
+
+    // Applies discardIf() over the given queue and the pending event.
+    template<typename Queue>
+    void discardEvents(Queue& queue, const EventFilter& pred) {
+      if (m_hasPendingEvent && pred(m_pendingEvent))
+        m_hasPendingEvent = false;
+
+      std::vector<Event> kept;
+      Event ev;
+      while (queue.try_pop(ev)) {
+        if (!pred(ev))
+          kept.push_back(std::move(ev));
+      }
+      queue.push_all(kept.begin(), kept.end());
+    }
+
+    // Returns true if the event must be dropped at queueEvent() time
+    // (see setFilter()).
+    bool filterEvent(const Event& ev) {
+      if (!m_hasFilter)
+        return false;
+      const std::lock_guard lock(m_filterMutex);
+      return (m_filter && m_filter(ev));
+    }
+
+    bool hasPendingEvent() const { return m_hasPendingEvent; }
+    void clearPendingEvent() { m_hasPendingEvent = false; }
+
+    // Accumulates the dwell time of an event created at the given
+    // tick into the stats() histogram.
+    static void recordDwellTime(base::tick_t eventTimestamp);
+
+    // Forwards the delivered event to the hooked recorder, if any
+    // (see setRecorder()).
+    static void recordEvent(const Event& ev);
+
+  private:
+    // Event popped ahead while coalescing, touched only by the
+    // consumer thread in popEvent().
+    Event m_pendingEvent;
+    bool m_hasPendingEvent = false;
+
+    // Enqueue-time filter (see setFilter()). The atomic flag keeps
+    // the common no-filter case lock-free.
+    std::mutex m_filterMutex;
+    EventFilter m_filter;
+    std::atomic<bool> m_hasFilter{false};
   };
 
   inline void queue_event(const Event& ev) {
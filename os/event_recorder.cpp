@@ -0,0 +1,168 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/event_recorder.h"
+
+#include "base/serialization.h"
+#include "base/thread.h"
+#include "os/event_queue.h"
+
+namespace os {
+
+using namespace base::serialization;
+using namespace base::serialization::little_endian;
+
+// Log header: magic + format version, bumped when the per-event
+// layout below changes.
+static const uint32_t kEventLogMagic = 0x4546414C; // "LAFE"
+static const uint16_t kEventLogVersion = 1;
+
+bool EventRecorder::start(const std::string& filename)
+{
+  stop();
+  m_stream.open(filename, std::ofstream::binary);
+  if (!m_stream)
+    return false;
+
+  write32(m_stream, kEventLogMagic);
+  write16(m_stream, kEventLogVersion);
+
+  EventQueue::setRecorder(this);
+  return true;
+}
+
+void EventRecorder::stop()
+{
+  if (!isRecording())
+    return;
+
+  EventQueue::setRecorder(nullptr);
+  m_stream.close();
+}
+
+void EventRecorder::record(const Event& ev)
+{
+  // A std::function cannot be serialized, and None events carry
+  // nothing worth replaying.
+  if (ev.type() == Event::Callback ||
+      ev.type() == Event::None)
+    return;
+
+  write8(m_stream, uint8_t(ev.type()));
+  write64(m_stream, uint64_t(ev.timestamp()));
+  write32(m_stream, uint32_t(ev.scancode()));
+  write32(m_stream, uint32_t(ev.modifiers()));
+  write32(m_stream, uint32_t(ev.unicodeChar()));
+  write8(m_stream, ev.isDeadKey() ? 1: 0);
+  write32(m_stream, uint32_t(ev.repeat()));
+  write32(m_stream, uint32_t(ev.position().x));
+  write32(m_stream, uint32_t(ev.position().y));
+  write32(m_stream, uint32_t(ev.wheelDelta().x));
+  write32(m_stream, uint32_t(ev.wheelDelta().y));
+  write8(m_stream, ev.preciseWheel() ? 1: 0);
+  write8(m_stream, uint8_t(ev.pointerType()));
+  write8(m_stream, uint8_t(ev.button()));
+  write32(m_stream, uint32_t(ev.timerId()));
+  write_float(m_stream, ev.magnification());
+  write_float(m_stream, ev.pressure());
+
+  if (ev.type() == Event::DropFiles) {
+    const base::paths& files = ev.files();
+    write32(m_stream, uint32_t(files.size()));
+    for (const std::string& file : files) {
+      write32(m_stream, uint32_t(file.size()));
+      m_stream.write(file.c_str(), file.size());
+    }
+  }
+}
+
+bool EventPlayer::open(const std::string& filename)
+{
+  m_stream.open(filename, std::ifstream::binary);
+  if (!m_stream)
+    return false;
+
+  if (read32(m_stream) != kEventLogMagic ||
+      read16(m_stream) != kEventLogVersion) {
+    m_stream.close();
+    return false;
+  }
+  return true;
+}
+
+bool EventPlayer::next(Event& ev)
+{
+  const uint8_t type = read8(m_stream);
+  if (!m_stream || m_stream.eof())
+    return false;
+
+  ev = Event();
+  ev.setType(Event::Type(type));
+  ev.setWindow(m_window);
+  ev.setTimestamp(base::tick_t(read64(m_stream)));
+  ev.setScancode(KeyScancode(read32(m_stream)));
+  ev.setModifiers(KeyModifiers(read32(m_stream)));
+  ev.setUnicodeChar(int(read32(m_stream)));
+  ev.setDeadKey(read8(m_stream) != 0);
+  ev.setRepeat(int(read32(m_stream)));
+  gfx::Point pos;
+  pos.x = int(read32(m_stream));
+  pos.y = int(read32(m_stream));
+  ev.setPosition(pos);
+  gfx::Point wheel;
+  wheel.x = int(read32(m_stream));
+  wheel.y = int(read32(m_stream));
+  ev.setWheelDelta(wheel);
+  ev.setPreciseWheel(read8(m_stream) != 0);
+  ev.setPointerType(PointerType(read8(m_stream)));
+  ev.setButton(Event::MouseButton(read8(m_stream)));
+  ev.setTimerId(int(read32(m_stream)));
+  ev.setMagnification(read_float(m_stream));
+  ev.setPressure(read_float(m_stream));
+
+  if (ev.type() == Event::DropFiles) {
+    base::paths files;
+    const uint32_t n = read32(m_stream);
+    for (uint32_t i=0; i<n && m_stream; ++i) {
+      std::string file(read32(m_stream), 0);
+      m_stream.read(&file[0], file.size());
+      files.push_back(std::move(file));
+    }
+    ev.setFiles(files);
+  }
+  return bool(m_stream);
+}
+
+void EventPlayer::play(EventQueue* queue,
+                       const bool keepPacing)
+{
+  if (!queue)
+    queue = EventQueue::instance();
+
+  Event ev;
+  base::tick_t recordedPrev = 0;
+  bool first = true;
+  while (next(ev)) {
+    if (keepPacing && !first) {
+      const base::tick_t gap = ev.timestamp() - recordedPrev;
+      if (gap > 0)
+        base::this_thread::sleep_for(double(gap) / 1000.0);
+    }
+    recordedPrev = ev.timestamp();
+    first = false;
+
+    // Re-stamp the event so dwell-time stats measure this run, not
+    // the recorded session.
+    ev.setTimestamp(base::current_tick());
+    queue->queueEvent(ev);
+  }
+}
+
+} // namespace os
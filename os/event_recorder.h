@@ -0,0 +1,82 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_EVENT_RECORDER_H_INCLUDED
+#define OS_EVENT_RECORDER_H_INCLUDED
+#pragma once
+
+#include "os/event.h"
+
+#include <fstream>
+#include <string>
+
+namespace os {
+
+  class EventQueue;
+
+  // Records the stream of events delivered by EventQueue::getEvent()
+  // into a compact binary log (one flat entry per event plus its
+  // timestamp), so a user-reported lag session can be captured and
+  // replayed later as a reproducible benchmark:
+  //
+  //   os::EventRecorder recorder;
+  //   recorder.start("session.laf-events");  // ...run the session...
+  //   recorder.stop();
+  //
+  // Callback events are skipped (a std::function cannot be
+  // serialized) and window references are not stored: EventPlayer
+  // re-targets every replayed event to one window of your choice.
+  class EventRecorder {
+  public:
+    ~EventRecorder() { stop(); }
+
+    // Starts appending every delivered event to the given file
+    // (hooks this recorder into the EventQueue). Returns false if the
+    // file cannot be created.
+    bool start(const std::string& filename);
+    void stop();
+    bool isRecording() const { return m_stream.is_open(); }
+
+    // Called by EventQueue for each delivered event.
+    void record(const Event& ev);
+
+  private:
+    std::ofstream m_stream;
+  };
+
+  // Replays a log captured by EventRecorder, re-injecting the events
+  // through EventQueue::queueEvent() either with the original pacing
+  // (sleeping the recorded gap between consecutive events) or
+  // as-fast-as-possible for throughput testing.
+  class EventPlayer {
+  public:
+    // Returns false if the file cannot be opened or is not an event
+    // log.
+    bool open(const std::string& filename);
+
+    // Window assigned to the replayed events (the log doesn't store
+    // window references).
+    void setWindow(const WindowRef& window) { m_window = window; }
+
+    // Reads the next event from the log. Returns false at the end of
+    // the log.
+    bool next(Event& ev);
+
+    // Replays the whole log into the given queue (the instance() one
+    // if nullptr). With keepPacing the original gaps between events
+    // are reproduced sleeping between injections; without it the
+    // events are queued back-to-back.
+    void play(EventQueue* queue = nullptr,
+              bool keepPacing = true);
+
+  private:
+    std::ifstream m_stream;
+    WindowRef m_window;
+  };
+
+} // namespace os
+
+#endif
@@ -12,6 +12,7 @@
 #include "base/ints.h"
 #include "os/ref.h"
 
+#include <map>
 #include <string>
 
 namespace os {
@@ -45,10 +46,30 @@ namespace os {
     }
     void setFallback(Font* font) {
       m_fallback = font;
+      m_fallbackForCodePoint.clear();
+    }
+
+    // Returns the first font of this fallback chain (starting with
+    // this font itself) that can draw the given codepoint, or
+    // nullptr when no font of the chain has it. The result is
+    // memoized, so mixed-script strings walk the chain calling
+    // hasCodePoint() once per codepoint instead of on every draw.
+    Font* fallbackForCodePoint(int codepoint) {
+      auto it = m_fallbackForCodePoint.find(codepoint);
+      if (it != m_fallbackForCodePoint.end())
+        return it->second;
+
+      Font* font = this;
+      while (font && !font->hasCodePoint(codepoint))
+        font = font->fallback();
+
+      m_fallbackForCodePoint[codepoint] = font;
+      return font;
     }
 
   private:
     Font* m_fallback;
+    std::map<int, Font*> m_fallbackForCodePoint;
   };
 
 } // namespace os
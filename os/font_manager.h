@@ -11,7 +11,13 @@
 #include "os/font_style_set.h"
 #include "os/ref.h"
 
+#include <functional>
 #include <string>
+#include <vector>
+
+namespace base {
+  class thread_pool;
+}
 
 namespace os {
 
@@ -23,6 +29,29 @@ namespace os {
     virtual std::string familyName(int index) const = 0;
     virtual Ref<FontStyleSet> familyStyleSet(int index) const = 0;
     virtual Ref<FontStyleSet> matchFamily(const std::string& familyName) const = 0;
+
+    // Starts enumerating the system font families on the given
+    // thread pool instead of blocking the first caller (machines
+    // with thousands of fonts take seconds to scan). Families become
+    // available progressively: countFamilies() grows while the scan
+    // advances and familyName()/familyStyleSet() can be used for any
+    // index below it. onDone is called from the worker thread when
+    // the whole list is ready. The base implementation is for
+    // backends that enumerate lazily anyway: it just calls onDone.
+    virtual void enumerateFamiliesAsync(base::thread_pool& pool,
+                                        std::function<void()> onDone) {
+      if (onDone)
+        onDone();
+    }
+
+    // Resolves and caches the style sets of the given families (and
+    // their common style matches) in a background thread, so later
+    // matchFamily()/matchStyle() calls from the draw path are served
+    // from the cache without fontconfig/DirectWrite round-trips. The
+    // base implementation does nothing (for backends that don't
+    // cache matches).
+    virtual void prefetchFamilies(const std::vector<std::string>& families,
+                                  base::thread_pool& pool) { }
   };
 
 } // namespace os
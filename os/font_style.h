@@ -65,6 +65,9 @@ namespace os {
     Width width() const { return Width((m_value >> 16) & 0xFF); }
     Slant slant() const { return Slant((m_value >> 24) & 0xFF); }
 
+    // Raw packed value (useful as cache key)
+    constexpr uint32_t value() const { return m_value; }
+
     static constexpr FontStyle Normal() {
       return FontStyle(Weight::Normal, Width::Normal, Slant::Upright);
     }
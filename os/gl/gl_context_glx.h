@@ -14,6 +14,9 @@
 #include <X11/Xlib.h>
 #undef None
 
+#include <algorithm>
+#include <vector>
+
 namespace os {
 
 class GLContextGLX : public GLContext {
@@ -37,9 +40,16 @@ public:
     if (!vi)
       return false;
 
-    m_glCtx = glXCreateContext(m_display, vi, nullptr, GL_TRUE);
+    // Create the context in the same share group of the other
+    // windows, so textures/programs (and the GrDirectContext that
+    // SkiaGL builds on top of them) are shared between all of them.
+    auto& group = shareGroup();
+    m_glCtx = glXCreateContext(m_display, vi,
+                               (!group.empty() ? group.front(): nullptr),
+                               GL_TRUE);
     if (!m_glCtx)
       return false;
+    group.push_back(m_glCtx);
 
     glClearStencil(0);
     glClearColor(0, 0, 0, 0);
@@ -59,6 +69,8 @@ public:
 
   void destroyGLContext() override {
     if (m_glCtx) {
+      auto& group = shareGroup();
+      group.erase(std::find(group.begin(), group.end(), m_glCtx));
       glXDestroyContext(m_display, m_glCtx);
       m_glCtx = nullptr;
     }
@@ -73,6 +85,13 @@ public:
   }
 
 private:
+  // All the live GLX contexts: new contexts share object names with
+  // the first one of the group.
+  static std::vector<GLXContext>& shareGroup() {
+    static std::vector<GLXContext> group;
+    return group;
+  }
+
   ::Display* m_display = nullptr;
   ::Window m_window = 0;
   GLXContext m_glCtx = nullptr;
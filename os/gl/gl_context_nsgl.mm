@@ -10,6 +10,7 @@
 
 #include "os/gl/gl_context_nsgl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include <OpenGL/gl.h>
@@ -17,6 +18,16 @@
 
 namespace os {
 
+// All the live NSOpenGLContexts: new contexts are created sharing
+// object names with the first one of the group, so textures/programs
+// (and the GrDirectContext that SkiaGL builds on top of them) are
+// shared between all the windows.
+static std::vector<NSOpenGLContext*>& share_group()
+{
+  static std::vector<NSOpenGLContext*> group;
+  return group;
+}
+
 GLContextNSGL::GLContextNSGL()
 {
 }
@@ -66,10 +77,12 @@ bool GLContextNSGL::createGLContext()
   if (!nsPixelFormat)
     return false;
 
+  auto& group = share_group();
   m_nsgl = [[NSOpenGLContext alloc] initWithFormat:nsPixelFormat
-                                      shareContext:nil];
+                                      shareContext:(!group.empty() ? group.front(): nil)];
   if (!m_nsgl)
     return false;
+  group.push_back(m_nsgl);
 
   GLint swapInterval = 0;   // disable vsync
   [m_nsgl setValues:&swapInterval forParameter:NSOpenGLCPSwapInterval];
@@ -82,7 +95,11 @@ bool GLContextNSGL::createGLContext()
 
 void GLContextNSGL::destroyGLContext()
 {
-  m_nsgl = nil;
+  if (m_nsgl) {
+    auto& group = share_group();
+    group.erase(std::find(group.begin(), group.end(), m_nsgl));
+    m_nsgl = nil;
+  }
 }
 
 void GLContextNSGL::makeCurrent()
@@ -13,6 +13,9 @@
 
 #include <windows.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace os {
 
 class GLContextWGL : public GLContext {
@@ -64,12 +67,22 @@ public:
       return false;
     }
 
+    // Put the context in the same share group of the other windows,
+    // so textures/programs (and the GrDirectContext that SkiaGL
+    // builds on top of them) are shared between all of them.
+    auto& group = shareGroup();
+    if (!group.empty())
+      wglShareLists(group.front(), m_glrc);
+    group.push_back(m_glrc);
+
     ReleaseDC(m_hwnd, hdc);
     return true;
   }
 
   void destroyGLContext() override {
     if (m_glrc) {
+      auto& group = shareGroup();
+      group.erase(std::find(group.begin(), group.end(), m_glrc));
       wglMakeCurrent(nullptr, nullptr);
       wglDeleteContext(m_glrc);
       m_glrc = nullptr;
@@ -89,6 +102,13 @@ public:
   }
 
 private:
+  // All the live WGL contexts: new contexts share object names with
+  // the first one of the group (wglShareLists()).
+  static std::vector<HGLRC>& shareGroup() {
+    static std::vector<HGLRC> group;
+    return group;
+  }
+
   HWND m_hwnd;
   HGLRC m_glrc;
 };
@@ -8,6 +8,8 @@
 #define OS_KEYS_H_INCLUDED
 #pragma once
 
+#include <bitset>
+
 namespace os {
 
   enum KeyModifiers {
@@ -160,6 +162,24 @@ namespace os {
     kKeyScancodes    = 127
   };
 
+  // Snapshot of the pressed state of the whole keyboard, taken by
+  // System::keyStates() with a single query, so code that tests
+  // dozens of shortcuts per frame doesn't pay one system round-trip
+  // per key.
+  class KeyStates {
+  public:
+    bool isPressed(const KeyScancode scancode) const {
+      return (scancode >= 0 && scancode < kKeyScancodes ?
+              m_pressed[scancode]: false);
+    }
+    void setPressed(const KeyScancode scancode, const bool pressed) {
+      if (scancode >= 0 && scancode < kKeyScancodes)
+        m_pressed[scancode] = pressed;
+    }
+  private:
+    std::bitset<kKeyScancodes> m_pressed;
+  };
+
 } // namespace os
 
 #endif
@@ -0,0 +1,42 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_MTL_CONTEXT_INCLUDED
+#define OS_MTL_CONTEXT_INCLUDED
+#pragma once
+
+#include "gfx/size.h"
+
+namespace os {
+
+// Device/queue/layer triplet used to present a SkiaWindowBase with
+// the Metal backend (WindowSpec::GpuBackend::Metal). The handles are
+// exposed as raw pointers (id<MTLDevice>, id<MTLCommandQueue>,
+// CAMetalLayer*) so this header can be included from pure C++
+// translation units, the same trick Skia uses with GrMTLHandle.
+class MtlContext {
+public:
+  virtual ~MtlContext() { }
+  virtual bool isValid() { return false; }
+  virtual bool createContext() { return false; }
+  virtual void destroyContext() { }
+  virtual void* device() const { return nullptr; }
+  virtual void* queue() const { return nullptr; }
+  virtual void* layer() const { return nullptr; }
+
+  // Matches the CAMetalLayer drawable size to the window backing
+  // store size (in real pixels).
+  virtual void setDrawableSize(const gfx::Size& size) { }
+
+  // Schedules the presentation of a CAMetalDrawable acquired with
+  // SkiaMtl::beginFrame() (the frame's commands must be already
+  // submitted). Takes ownership of the handle.
+  virtual void present(void* drawable) { }
+};
+
+} // namespace os
+
+#endif
@@ -0,0 +1,40 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_MTL_CONTEXT_OSX_INCLUDED
+#define OS_MTL_CONTEXT_OSX_INCLUDED
+#pragma once
+
+#include "os/mtl/mtl_context.h"
+
+namespace os {
+
+class MtlContextOSX : public MtlContext {
+public:
+  MtlContextOSX();
+  ~MtlContextOSX();
+
+  void setView(id view);
+
+  bool isValid() override;
+  bool createContext() override;
+  void destroyContext() override;
+  void* device() const override;
+  void* queue() const override;
+  void* layer() const override;
+  void setDrawableSize(const gfx::Size& size) override;
+  void present(void* drawable) override;
+
+private:
+  id m_device = nullptr; // id<MTLDevice>
+  id m_queue = nullptr;  // id<MTLCommandQueue>
+  id m_layer = nullptr;  // CAMetalLayer
+  id m_view = nullptr;   // NSView
+};
+
+} // namespace os
+
+#endif
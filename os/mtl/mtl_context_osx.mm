@@ -0,0 +1,120 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/mtl/mtl_context_osx.h"
+
+#include <Cocoa/Cocoa.h>
+#include <Metal/Metal.h>
+#include <QuartzCore/CAMetalLayer.h>
+
+namespace os {
+
+MtlContextOSX::MtlContextOSX()
+{
+}
+
+MtlContextOSX::~MtlContextOSX()
+{
+  destroyContext();
+}
+
+void MtlContextOSX::setView(id view)
+{
+  m_view = view;
+  if (m_layer && view) {
+    NSView* v = (NSView*)view;
+    [v setWantsLayer:YES];
+    v.layer = (CAMetalLayer*)m_layer;
+  }
+}
+
+bool MtlContextOSX::isValid()
+{
+  return (m_device != nullptr);
+}
+
+bool MtlContextOSX::createContext()
+{
+  if (m_device)
+    return true;
+
+  id<MTLDevice> device = MTLCreateSystemDefaultDevice();
+  if (!device)
+    return false;
+
+  id<MTLCommandQueue> queue = [device newCommandQueue];
+  if (!queue)
+    return false;
+
+  CAMetalLayer* layer = [CAMetalLayer layer];
+  layer.device = device;
+  layer.pixelFormat = MTLPixelFormatBGRA8Unorm;
+  layer.framebufferOnly = YES;
+  // Frames are presented from SkiaWindowBase::swapBuffers() (not
+  // from a display link), so present as soon as the command buffer
+  // is scheduled.
+  layer.presentsWithTransaction = NO;
+
+  m_device = device;
+  m_queue = queue;
+  m_layer = layer;
+
+  if (m_view)
+    setView(m_view);
+  return true;
+}
+
+void MtlContextOSX::destroyContext()
+{
+  if (m_view && m_layer) {
+    NSView* v = (NSView*)m_view;
+    if (v.layer == m_layer)
+      v.layer = nil;
+  }
+  m_layer = nullptr;
+  m_queue = nullptr;
+  m_device = nullptr;
+}
+
+void* MtlContextOSX::device() const
+{
+  return (__bridge void*)m_device;
+}
+
+void* MtlContextOSX::queue() const
+{
+  return (__bridge void*)m_queue;
+}
+
+void* MtlContextOSX::layer() const
+{
+  return (__bridge void*)m_layer;
+}
+
+void MtlContextOSX::setDrawableSize(const gfx::Size& size)
+{
+  if (m_layer)
+    ((CAMetalLayer*)m_layer).drawableSize = CGSizeMake(size.w, size.h);
+}
+
+void MtlContextOSX::present(void* drawable)
+{
+  if (!m_queue || !drawable)
+    return;
+
+  // SkSurface::MakeFromCAMetalLayer() returned the drawable handle
+  // retained, __bridge_transfer releases it when we are done.
+  id<CAMetalDrawable> mtlDrawable = (__bridge_transfer id<CAMetalDrawable>)drawable;
+  id<MTLCommandBuffer> cmdBuffer = [(id<MTLCommandQueue>)m_queue commandBuffer];
+  [cmdBuffer presentDrawable:mtlDrawable];
+  [cmdBuffer commit];
+}
+
+} // namespace os
@@ -50,6 +50,14 @@ namespace os {
   public:
     virtual ~NativeDialogs() { }
     virtual FileDialogRef makeFileDialog() = 0;
+
+    // Warms up whatever the native file dialog needs on a background
+    // thread (e.g. the COM class + shell extensions on Windows, the
+    // zenity/kdialog detection on Linux). Call it at idle after
+    // startup so the first user-visible dialog opens instantly. It's
+    // just a hint: safe to call several times, and dialogs work the
+    // same without it.
+    virtual void preloadFileDialog() { }
   };
 
 } // namespace os
@@ -41,7 +41,8 @@ public:
   Window* defaultWindow() override { return nullptr; }
   Ref<Window> makeWindow(const WindowSpec& spec) override { return nullptr; }
   Ref<Surface> makeSurface(int width, int height,
-                           const os::ColorSpaceRef& colorSpace) override { return nullptr; }
+                           const os::ColorSpaceRef& colorSpace,
+                           const SurfaceFlags flags) override { return nullptr; }
   Ref<Surface> makeRgbaSurface(int width, int height,
                                const os::ColorSpaceRef& colorSpace) override { return nullptr; }
   Ref<Surface> loadSurface(const char* filename) override { return nullptr; }
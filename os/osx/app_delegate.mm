@@ -15,6 +15,7 @@
 
 #include "base/fs.h"
 #include "os/event.h"
+#include "os/common/system.h"
 #include "os/event_queue.h"
 #include "os/osx/app.h"
 #include "os/osx/view.h"
@@ -96,6 +97,14 @@
     [ViewOSX updateKeyFlags:event];
 }
 
+- (void)applicationDidChangeScreenParameters:(NSNotification*)notification
+{
+  // Monitors were added/removed or changed their resolution, refresh
+  // the cached screens.
+  if (auto* sys = dynamic_cast<os::CommonSystem*>(os::instance()))
+    sys->invalidateScreens();
+}
+
 - (BOOL)application:(NSApplication*)app openFiles:(NSArray*)filenames
 {
   // TODO similar to generate_drop_files_from_nsarray() but with a
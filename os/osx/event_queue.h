@@ -13,7 +13,10 @@
 #include "os/event.h"
 #include "os/event_queue.h"
 
+#include <CoreFoundation/CoreFoundation.h>
+
 #include <atomic>
+#include <map>
 
 namespace os {
 
@@ -24,11 +27,21 @@ public:
   void getEvent(Event& ev, double timeout) override;
   void queueEvent(const Event& ev) override;
   void clearEvents() override;
+  void discardIf(const EventFilter& pred) override;
+  void addTimer(int intervalMsecs, int timerId) override;
+  void removeTimer(int timerId) override;
 
 private:
   void wakeUpQueue();
 
-  base::concurrent_queue<Event> m_events;
+  // Timers registered with addTimer(), scheduled on the main run loop
+  // so they fire inside the nextEventMatchingMask wait of getEvent().
+  std::map<int, CFRunLoopTimerRef> m_timers;
+
+  // Lock-free ring so the hot queueEvent()/getEvent() path costs a
+  // couple of atomics per event instead of a mutex round-trip. When
+  // the ring is full push() applies backpressure.
+  base::concurrent_queue<Event, base::queue_policy::lock_free> m_events{1024};
   std::atomic<bool> m_sleeping;
 };
 
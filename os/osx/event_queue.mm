@@ -74,7 +74,7 @@ void EventQueueOSX::getEvent(Event& ev, double timeout)
       }
     } while (event);
 
-    if (!m_events.try_pop(ev)) {
+    if (!popEvent(m_events, ev)) {
       if (timeout == kWithoutTimeout)
         EV_TRACE("EV: Waiting for events\n");
 
@@ -99,6 +99,9 @@ void EventQueueOSX::getEvent(Event& ev, double timeout)
 
 void EventQueueOSX::queueEvent(const Event& ev)
 {
+  if (filterEvent(ev))
+    return;
+
   if (m_sleeping) {
     // Wake up the macOS event queue. This is necessary in case that we
     // change the display color profile from macOS settings: the
@@ -136,7 +139,49 @@ void EventQueueOSX::wakeUpQueue()
 
 void EventQueueOSX::clearEvents()
 {
+  clearPendingEvent();
   m_events.clear();
 }
 
+void EventQueueOSX::discardIf(const EventFilter& pred)
+{
+  discardEvents(m_events, pred);
+}
+
+void EventQueueOSX::addTimer(int intervalMsecs, int timerId)
+{
+  removeTimer(timerId);
+
+  const CFTimeInterval interval = intervalMsecs / 1000.0;
+  CFRunLoopTimerContext context;
+  memset(&context, 0, sizeof(context));
+  context.info = (void*)(intptr_t)timerId;
+
+  CFRunLoopTimerRef timer =
+    CFRunLoopTimerCreate(kCFAllocatorDefault,
+                         CFAbsoluteTimeGetCurrent() + interval,
+                         interval, 0, 0,
+                         [](CFRunLoopTimerRef, void* info) {
+                           Event ev;
+                           ev.setType(Event::Timer);
+                           ev.setTimerId(int((intptr_t)info));
+                           queue_event(ev);
+                         },
+                         &context);
+  if (timer) {
+    CFRunLoopAddTimer(CFRunLoopGetMain(), timer, kCFRunLoopCommonModes);
+    m_timers[timerId] = timer;
+  }
+}
+
+void EventQueueOSX::removeTimer(int timerId)
+{
+  auto it = m_timers.find(timerId);
+  if (it != m_timers.end()) {
+    CFRunLoopTimerInvalidate(it->second);
+    CFRelease(it->second);
+    m_timers.erase(it);
+  }
+}
+
 } // namespace os
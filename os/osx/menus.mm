@@ -14,8 +14,12 @@
 #include "os/osx/menus.h"
 #include "os/shortcut.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace os {
   class MenuItemOSX;
+  class MenuOSX;
 }
 
 @interface NSMenuOSX : NSMenu
@@ -32,11 +36,27 @@ namespace os {
 - (void)validateLafMenuItem;
 @end
 
+// Materializes the items of a MenuOSX the first time Cocoa needs
+// them (when the menu is about to open, or when it's searching for a
+// key equivalent). This way makeMenuItem()/addItem() just record a
+// description and building an app with hundreds of menu items doesn't
+// pay one native call per item at startup.
+@interface NSMenuDelegateOSX : NSObject<NSMenuDelegate> {
+@public
+  os::MenuOSX* menu;
+}
+- (void)menuNeedsUpdate:(NSMenu*)nsMenu;
+@end
+
 namespace os {
 
 extern bool g_keyEquivalentUsed;
 NSMenuItem* g_standardEditMenuItem = nullptr;
 
+// The native NSMenuItem is not created in the constructor: the item
+// starts as a lightweight description (the MenuItemInfo + pending
+// state changes) and handle() materializes it on demand, when the
+// menu that contains it is opened for the first time.
 class MenuItemOSX : public MenuItem {
 public:
   MenuItemOSX(const MenuItemInfo& info);
@@ -47,21 +67,33 @@ public:
   void setChecked(bool state) override;
   void setShortcut(const Shortcut& shortcut) override;
   void setAsStandardEditMenuItem() override;
-  NSMenuItem* handle() { return m_handle; }
+  NSMenuItem* handle();
 
   // Called by NSMenuItemOSX.executeMenuItem
   void execute();
   void validate();
 
 private:
+  void materialize();
   void syncTitle();
 
+  MenuItemInfo m_info;
   NSMenuItem* m_handle;
   MenuRef m_submenu;
   std::function<void()> m_execute;
   std::function<void(os::MenuItem*)> m_validate;
+
+  // State changed before the materialization, applied to the native
+  // item when it's created.
+  bool m_enabled;
+  bool m_checked;
+  bool m_standardEditMenuItem;
 };
 
+// Like MenuItemOSX, the menu keeps its items as descriptions
+// (m_items) and only creates the native NSMenu shell when some parent
+// needs the handle; the items themselves are materialized by
+// NSMenuDelegateOSX on the first open of the menu.
 class MenuOSX : public Menu {
 public:
   MenuOSX();
@@ -69,9 +101,16 @@ public:
   void addItem(const MenuItemRef& item) override;
   void insertItem(const int index, const MenuItemRef& item) override;
   void removeItem(const MenuItemRef& item) override;
-  NSMenu* handle() { return m_handle; }
+  NSMenu* handle();
+
+  // Called by NSMenuDelegateOSX.menuNeedsUpdate
+  void materializeItems();
+
 private:
-  NSMenu* m_handle;
+  NSMenuOSX* m_handle;
+  NSMenuDelegateOSX* m_delegate;
+  std::vector<MenuItemRef> m_items;
+  bool m_itemsMaterialized;
 };
 
 } // namespace os
@@ -120,21 +159,47 @@ private:
 }
 @end
 
+@implementation NSMenuDelegateOSX
+- (void)menuNeedsUpdate:(NSMenu*)nsMenu
+{
+  if (menu)
+    menu->materializeItems();
+}
+@end
+
 namespace os {
 
 //////////////////////////////////////////////////////////////////////
 // os::MenuItem impl
 
 MenuItemOSX::MenuItemOSX(const MenuItemInfo& info)
-  : m_handle(nullptr)
+  : m_info(info)
+  , m_handle(nullptr)
   , m_submenu(nullptr)
+  , m_execute(info.execute)
+  , m_validate(info.validate)
+  , m_enabled(true)
+  , m_checked(false)
+  , m_standardEditMenuItem(false)
+{
+  // The native item is created lazily in materialize()
+}
+
+NSMenuItem* MenuItemOSX::handle()
 {
-  switch (info.type) {
+  if (!m_handle)
+    materialize();
+  return m_handle;
+}
+
+void MenuItemOSX::materialize()
+{
+  switch (m_info.type) {
 
     case MenuItemInfo::Normal: {
       SEL sel = nil;
       id target = nil;
-      switch (info.action) {
+      switch (m_info.action) {
 
         case MenuItemInfo::UserDefined:
           sel = @selector(executeMenuItem:);
@@ -173,16 +238,14 @@ MenuItemOSX::MenuItemOSX(const MenuItemInfo& info)
 
       m_handle =
         [[NSMenuItemOSX alloc:AddRef(this)]
-            initWithTitle:[NSString stringWithUTF8String:info.text.c_str()]
+            initWithTitle:[NSString stringWithUTF8String:m_info.text.c_str()]
                    action:sel
             keyEquivalent:@""];
 
       m_handle.target = target;
-      m_execute = info.execute;
-      m_validate = info.validate;
 
-      if (!info.shortcut.isEmpty())
-        setShortcut(info.shortcut);
+      if (!m_info.shortcut.isEmpty())
+        setShortcut(m_info.shortcut);
       break;
     }
 
@@ -190,6 +253,20 @@ MenuItemOSX::MenuItemOSX(const MenuItemInfo& info)
       m_handle = [NSMenuItem separatorItem];
       break;
   }
+
+  // Apply the state changed before the materialization
+  if (!m_enabled)
+    m_handle.enabled = false;
+  if (m_checked)
+    m_handle.state = NSOnState;
+  if (m_standardEditMenuItem)
+    g_standardEditMenuItem = m_handle;
+  if (m_submenu) {
+    // Only the NSMenu shell of the submenu is created here, its items
+    // are materialized when the submenu is open for the first time.
+    [m_handle setSubmenu:((MenuOSX*)m_submenu.get())->handle()];
+    syncTitle();
+  }
 }
 
 MenuItemOSX::~MenuItemOSX()
@@ -208,18 +285,25 @@ MenuItemOSX::~MenuItemOSX()
 
 void MenuItemOSX::setText(const std::string& text)
 {
-  [m_handle setTitle:[NSString stringWithUTF8String:text.c_str()]];
-  syncTitle();
+  m_info.text = text;
+  if (m_handle) {
+    [m_handle setTitle:[NSString stringWithUTF8String:text.c_str()]];
+    syncTitle();
+  }
 }
 
 void MenuItemOSX::setSubmenu(const MenuRef& submenu)
 {
   if (m_submenu) {
-    ASSERT(m_handle.submenu == ((MenuOSX*)m_submenu.get())->handle());
+    ASSERT(!m_handle ||
+           m_handle.submenu == ((MenuOSX*)m_submenu.get())->handle());
     m_submenu.reset();
   }
 
   m_submenu = submenu;
+  if (!m_handle)
+    return;                 // Attached when the item is materialized
+
   if (submenu) {
     [m_handle setSubmenu:((MenuOSX*)submenu.get())->handle()];
     syncTitle();
@@ -230,11 +314,17 @@ void MenuItemOSX::setSubmenu(const MenuRef& submenu)
 
 void MenuItemOSX::setEnabled(bool state)
 {
-  m_handle.enabled = state;
+  m_enabled = state;
+  if (m_handle)
+    m_handle.enabled = state;
 }
 
 void MenuItemOSX::setChecked(bool state)
 {
+  m_checked = state;
+  if (!m_handle)
+    return;
+
   if (state)
     m_handle.state = NSOnState;
   else
@@ -243,6 +333,10 @@ void MenuItemOSX::setChecked(bool state)
 
 void MenuItemOSX::setShortcut(const Shortcut& shortcut)
 {
+  m_info.shortcut = shortcut;
+  if (!m_handle)
+    return;
+
   KeyModifiers mods = shortcut.modifiers();
   NSEventModifierFlags nsFlags = 0;
   if (mods & kKeyShiftModifier) nsFlags |= NSEventModifierFlagShift;
@@ -264,7 +358,9 @@ void MenuItemOSX::setShortcut(const Shortcut& shortcut)
 
 void MenuItemOSX::setAsStandardEditMenuItem()
 {
-  g_standardEditMenuItem = m_handle;
+  m_standardEditMenuItem = true;
+  if (m_handle)
+    g_standardEditMenuItem = m_handle;
 }
 
 void MenuItemOSX::execute()
@@ -292,12 +388,20 @@ void MenuItemOSX::syncTitle()
 // os::Menu impl
 
 MenuOSX::MenuOSX()
+  : m_handle(nullptr)
+  , m_delegate(nullptr)
+  , m_itemsMaterialized(false)
 {
-  m_handle = [[NSMenuOSX alloc] init];
+  // The native NSMenu is created lazily in handle()
 }
 
 MenuOSX::~MenuOSX()
 {
+  // The NSMenu can outlive this object through the native retain
+  // chain, so cut the back reference used to materialize items.
+  if (m_delegate)
+    m_delegate->menu = nullptr;
+
 #if 0 // TODO dispose existent items
   std::vector<NSMenuItem*> items;
   for (int i=0, c=m_handle.itemArray.count; i<c; ++i) {
@@ -316,20 +420,62 @@ MenuOSX::~MenuOSX()
 void MenuOSX::addItem(const MenuItemRef& item)
 {
   ASSERT(item);
-  [m_handle addItem:((MenuItemOSX*)item.get())->handle()];
+  if (m_itemsMaterialized)
+    [m_handle addItem:((MenuItemOSX*)item.get())->handle()];
+  else
+    m_items.push_back(item);
 }
 
 void MenuOSX::insertItem(const int index, const MenuItemRef& item)
 {
   ASSERT(item);
-  [m_handle insertItem:((MenuItemOSX*)item.get())->handle()
-               atIndex:index];
+  if (m_itemsMaterialized) {
+    [m_handle insertItem:((MenuItemOSX*)item.get())->handle()
+                 atIndex:index];
+  }
+  else
+    m_items.insert(m_items.begin() + index, item);
 }
 
 void MenuOSX::removeItem(const MenuItemRef& item)
 {
   ASSERT(item);
-  [m_handle removeItem:((MenuItemOSX*)item.get())->handle()];
+  if (m_itemsMaterialized)
+    [m_handle removeItem:((MenuItemOSX*)item.get())->handle()];
+  else {
+    auto it = std::find(m_items.begin(), m_items.end(), item);
+    if (it != m_items.end())
+      m_items.erase(it);
+  }
+}
+
+NSMenu* MenuOSX::handle()
+{
+  if (!m_handle) {
+    m_handle = [[NSMenuOSX alloc] init];
+
+    // Cocoa calls menuNeedsUpdate: when the menu is about to open
+    // and when it's looking for a key equivalent, so the shortcuts
+    // of still-unmaterialized items keep working.
+    m_delegate = [[NSMenuDelegateOSX alloc] init];
+    m_delegate->menu = this;
+    m_handle.delegate = m_delegate;
+  }
+  return m_handle;
+}
+
+void MenuOSX::materializeItems()
+{
+  if (m_itemsMaterialized)
+    return;
+  m_itemsMaterialized = true;
+
+  // From now on the native menu is the source of truth; the items
+  // are kept alive by the NSMenu -> NSMenuItemOSX retain chain.
+  std::vector<MenuItemRef> items;
+  items.swap(m_items);
+  for (const MenuItemRef& item : items)
+    [handle() addItem:((MenuItemOSX*)item.get())->handle()];
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -351,8 +497,15 @@ MenuItemRef MenusOSX::makeMenuItem(const MenuItemInfo& info)
 
 void MenusOSX::setAppMenu(const MenuRef& menu)
 {
-  if (menu)
-    [NSApp setMainMenu:((MenuOSX*)menu.get())->handle()];
+  if (menu) {
+    // The menu bar titles must be visible right away, so the
+    // top-level items (and the NSMenu shells of their submenus) are
+    // materialized here; the contents of each submenu are still
+    // deferred until its first open.
+    auto menuOSX = (MenuOSX*)menu.get();
+    menuOSX->materializeItems();
+    [NSApp setMainMenu:menuOSX->handle()];
+  }
   else
     [NSApp setMainMenu:nil];
 }
@@ -18,6 +18,7 @@
 namespace os {
 
 bool osx_is_key_pressed(KeyScancode scancode);
+KeyStates osx_key_states();
 int osx_get_unicode_from_scancode(KeyScancode scancode);
 
 // By default the NSView will be created with a CALayer for backing
@@ -65,11 +66,15 @@ public:
     return osx_is_key_pressed(scancode);
   }
 
+  KeyStates keyStates() override {
+    return osx_key_states();
+  }
+
   int getUnicodeFromScancode(KeyScancode scancode) override {
     return osx_get_unicode_from_scancode(scancode);
   }
 
-  CursorRef makeCursor(const Surface* surface,
+  CursorRef onMakeCursor(const Surface* surface,
                        const gfx::Point& focus,
                        const int scale) override;
 
@@ -77,8 +82,8 @@ public:
   void setMousePosition(const gfx::Point& screenPosition) override;
   gfx::Color getColorFromScreen(const gfx::Point& screenPosition) const override;
 
-  ScreenRef mainScreen() override;
-  void listScreens(ScreenList& list) override;
+  ScreenRef onMainScreen() override;
+  void onListScreens(ScreenList& list) override;
 
 private:
   MenusRef m_menus;
@@ -35,7 +35,7 @@ SystemOSX::~SystemOSX()
   destroyInstance();
 }
 
-CursorRef SystemOSX::makeCursor(const Surface* surface,
+CursorRef SystemOSX::onMakeCursor(const Surface* surface,
                                 const gfx::Point& focus,
                                 const int scale)
 {
@@ -144,12 +144,12 @@ gfx::Color SystemOSX::getColorFromScreen(const gfx::Point& screenPosition) const
   return color;
 }
 
-ScreenRef SystemOSX::mainScreen()
+ScreenRef SystemOSX::onMainScreen()
 {
   return make_ref<ScreenOSX>([NSScreen mainScreen]);
 }
 
-void SystemOSX::listScreens(ScreenList& list)
+void SystemOSX::onListScreens(ScreenList& list)
 {
   auto screens = [NSScreen screens];
   for (NSScreen* screen : screens)
@@ -107,6 +107,16 @@ bool osx_is_key_pressed(KeyScancode scancode)
     return false;
 }
 
+KeyStates osx_key_states()
+{
+  // g_pressedKeys is maintained from the NSEvent stream, so the
+  // whole snapshot is a plain copy without any system call.
+  KeyStates states;
+  for (int i=kKeyNil+1; i<kKeyScancodes; ++i)
+    states.setPressed(KeyScancode(i), g_pressedKeys[i] != 0);
+  return states;
+}
+
 int osx_get_unicode_from_scancode(KeyScancode scancode)
 {
   if (scancode >= 0 && scancode < kKeyScancodes)
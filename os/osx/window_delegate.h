@@ -67,6 +67,31 @@ namespace os {
 
 - (void)windowDidMiniaturize:(NSNotification*)notification
 {
+  if (m_impl)
+    m_impl->setVisibility(os::WindowVisibility::Minimized);
+}
+
+- (void)windowDidDeminiaturize:(NSNotification*)notification
+{
+  if (m_impl)
+    m_impl->setVisibility(os::WindowVisibility::Visible);
+}
+
+- (void)windowDidChangeOcclusionState:(NSNotification*)notification
+{
+  if (!m_impl)
+    return;
+
+  // The occlusion state tells us when the window gets completely
+  // covered by other windows, so callers can skip rendering frames
+  // that nobody would see.
+  NSWindow* window = notification.object;
+  if (([window occlusionState] & NSWindowOcclusionStateVisible) == 0) {
+    if (![window isMiniaturized])
+      m_impl->setVisibility(os::WindowVisibility::Occluded);
+  }
+  else
+    m_impl->setVisibility(os::WindowVisibility::Visible);
 }
 
 - (void)windowWillEnterFullScreen:(NSNotification*)notification
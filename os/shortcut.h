@@ -10,6 +10,9 @@
 
 #include "os/keys.h"
 
+#include <cstdint>
+#include <unordered_map>
+
 namespace os {
 
   class Shortcut {
@@ -30,6 +33,41 @@ namespace os {
     KeyModifiers m_modifiers;
   };
 
+  // Compiled set of shortcuts for O(1) matching against key events:
+  // instead of comparing an incoming keystroke with a whole shortcut
+  // list linearly, register each shortcut once with a caller-defined
+  // id (e.g. an index into the command list) and resolve the pressed
+  // combination with a single hash lookup.
+  class ShortcutSet {
+  public:
+    // Returned by match() when no shortcut matches.
+    static constexpr int kNoMatch = -1;
+
+    // Registers the shortcut with the given id (>= 0). A later add()
+    // of the same (unicode, modifiers) combination overwrites the id.
+    void add(const Shortcut& shortcut, const int id) {
+      if (!shortcut.isEmpty())
+        m_map[key(shortcut.unicode(), shortcut.modifiers())] = id;
+    }
+
+    void clear() { m_map.clear(); }
+
+    // Returns the id of the shortcut matching the pressed
+    // combination (e.g. Event::unicodeChar()/modifiers() of a
+    // KeyDown event), or kNoMatch.
+    int match(const int unicode, const KeyModifiers modifiers) const {
+      const auto it = m_map.find(key(unicode, modifiers));
+      return (it != m_map.end() ? it->second: kNoMatch);
+    }
+
+  private:
+    static uint64_t key(const int unicode, const KeyModifiers modifiers) {
+      return (uint64_t(modifiers) << 32) | uint32_t(unicode);
+    }
+
+    std::unordered_map<uint64_t, int> m_map;
+  };
+
 } // namespace os
 
 #endif
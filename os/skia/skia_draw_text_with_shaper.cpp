@@ -20,9 +20,82 @@
 #include "include/core/SkCanvas.h"
 
 #include <cfloat>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
 
 namespace os {
 
+namespace {
+
+// Shaped-text cache: SkShaper runs full HarfBuzz shaping (script
+// itemization, BiDi, glyph positioning) on each call, and UI labels
+// repeat the same strings frame after frame, so the resulting
+// SkTextBlob (glyph ids + positions + cluster map) is cached per
+// (typeface, size, text). The typeface is keyed by its uniqueID()
+// and not by pointer, so a destroyed font whose address is reused
+// cannot alias an old entry. Least recently used entries are evicted
+// when the cache is full.
+const int kMaxShapedTexts = 256;
+
+using ShapedTextKey = std::tuple<uint32_t, SkScalar, std::string>;
+using ShapedTextList = std::list<std::pair<ShapedTextKey, sk_sp<SkTextBlob>>>;
+
+// g_shapedTextsMutex guards the cache and the shared SkShaper
+// (drawing can come from several threads painting into different
+// surfaces).
+std::mutex g_shapedTextsMutex;
+ShapedTextList g_shapedTexts;   // Most recently used first
+std::map<ShapedTextKey, ShapedTextList::iterator> g_shapedTextIndex;
+
+sk_sp<SkTextBlob> get_shaped_text(const std::string& text,
+                                  const SkFont& skFont)
+{
+  const ShapedTextKey key(skFont.getTypeface() ?
+                            skFont.getTypeface()->uniqueID(): 0,
+                          skFont.getSize(),
+                          text);
+
+  const std::lock_guard lock(g_shapedTextsMutex);
+  auto it = g_shapedTextIndex.find(key);
+  if (it != g_shapedTextIndex.end()) {
+    // Move the entry to the most recently used position
+    g_shapedTexts.splice(g_shapedTexts.begin(),
+                         g_shapedTexts, it->second);
+    return it->second->second;
+  }
+
+  // One SkShaper instance reused for all the texts (creating it
+  // loads the HarfBuzz/BiDi machinery)
+  static auto shaper = SkShaper::Make();
+
+  sk_sp<SkTextBlob> textBlob;
+  if (shaper) {
+    SkTextBlobBuilderRunHandler builder(text.c_str(), { 0, 0 });
+    shaper->shape(text.c_str(), text.size(), skFont, true, FLT_MAX, &builder);
+    textBlob = builder.makeBlob();
+  }
+  else {
+    textBlob = SkTextBlob::MakeFromText(text.c_str(), text.size(), skFont,
+                                        SkTextEncoding::kUTF8);
+  }
+
+  g_shapedTexts.emplace_front(key, textBlob);
+  g_shapedTextIndex[key] = g_shapedTexts.begin();
+
+  if (int(g_shapedTexts.size()) > kMaxShapedTexts) {
+    g_shapedTextIndex.erase(g_shapedTexts.back().first);
+    g_shapedTexts.pop_back();
+  }
+
+  return textBlob;
+}
+
+} // anonymous namespace
+
 void draw_text_with_shaper(
   Surface* surface, Font* font,
   const std::string& text,
@@ -33,16 +106,7 @@ void draw_text_with_shaper(
 {
   // SkFont skFont(SkTypeface::MakeFromFile("/Library/Fonts/Arial Unicode.ttf"), SkIntToScalar(24));
   SkFont skFont(SkTypeface::MakeDefault(), SkIntToScalar(24));
-  sk_sp<SkTextBlob> textBlob;
-  auto shaper = SkShaper::Make();
-  if (shaper) {
-    SkTextBlobBuilderRunHandler builder(text.c_str(), { 0, 0 });
-    shaper->shape(text.c_str(), text.size(), skFont, true, FLT_MAX, &builder);
-    textBlob = builder.makeBlob();
-  }
-  else {
-    textBlob = SkTextBlob::MakeFromText(text.c_str(), text.size(), skFont, SkTextEncoding::kUTF8);
-  }
+  sk_sp<SkTextBlob> textBlob = get_shaped_text(text, skFont);
 
   if (textBlob)
     static_cast<SkiaSurface*>(surface)->canvas()
@@ -10,12 +10,26 @@
 
 #include "os/font_manager.h"
 
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/serialization.h"
+#include "base/thread_pool.h"
+#include "base/time.h"
+#include "os/common/glyph_cache.h"
 #include "os/font_style.h"
 
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
 
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace os {
 
 class SkiaTypeface : public Typeface {
@@ -62,14 +76,28 @@ public:
   }
 
   TypefaceRef matchStyle(const FontStyle& style) override {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_matches.find(style.value());
+    if (it != m_matches.end())
+      return it->second;
+
     SkFontStyle skStyle((SkFontStyle::Weight)style.weight(),
                         (SkFontStyle::Width)style.width(),
                         (SkFontStyle::Slant)style.slant());
-    return make_ref<SkiaTypeface>(m_skSet->matchStyle(skStyle));
+    auto typeface = make_ref<SkiaTypeface>(m_skSet->matchStyle(skStyle));
+    m_matches[style.value()] = typeface;
+    return typeface;
   }
 
 private:
   sk_sp<SkFontStyleSet> m_skSet;
+
+  // matchStyle() results with the typeface refs held, so resolving
+  // the same (family, style) on every label style change doesn't hit
+  // the system font manager again
+  std::mutex m_mutex;
+  std::unordered_map<uint32_t, TypefaceRef> m_matches;
 };
 
 class SkiaFontManager : public FontManager {
@@ -82,25 +110,241 @@ public:
   }
 
   int countFamilies() const override {
+    if (m_scanStarted) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return int(m_families.size());
+    }
     return m_skFontMgr->countFamilies();
   }
 
   std::string familyName(int i) const override {
+    if (m_scanStarted) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (i >= 0 && i < int(m_families.size()))
+        return m_families[i].first;
+      return std::string();
+    }
     SkString name;
     m_skFontMgr->getFamilyName(i, &name);
     return std::string(name.c_str());
   }
 
   Ref<FontStyleSet> familyStyleSet(int i) const override {
+    if (m_scanStarted) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (i >= 0 && i < int(m_families.size())) {
+        auto& entry = m_families[i];
+        // Families restored from the persistent cache resolve their
+        // style set lazily on the first request
+        if (!entry.second) {
+          entry.second = make_ref<SkiaFontStyleSet>(
+            m_skFontMgr->matchFamily(entry.first.c_str()));
+        }
+        return entry.second;
+      }
+      return nullptr;
+    }
     return make_ref<SkiaFontStyleSet>(m_skFontMgr->createStyleSet(i));
   }
 
   Ref<FontStyleSet> matchFamily(const std::string& familyName) const override {
-    return make_ref<SkiaFontStyleSet>(m_skFontMgr->matchFamily(familyName.c_str()));
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Cached sets are returned so their matchStyle() caches
+    // accumulate instead of dying with each temporary set.
+    auto it = m_matchedFamilies.find(familyName);
+    if (it != m_matchedFamilies.end())
+      return it->second;
+
+    auto set = make_ref<SkiaFontStyleSet>(m_skFontMgr->matchFamily(familyName.c_str()));
+    m_matchedFamilies[familyName] = set;
+    return set;
+  }
+
+  void enumerateFamiliesAsync(base::thread_pool& pool,
+                              std::function<void()> onDone) override {
+    // Already scanning (or scanned): the accessors are serving the
+    // progressive list, just don't scan twice
+    if (m_scanStarted.exchange(true)) {
+      if (onDone)
+        onDone();
+      return;
+    }
+
+    // Warm start: serve the family list persisted by the previous
+    // run immediately (the scan below still runs and replaces it, so
+    // a stale cache only survives until the scan finishes)
+    const bool warmStart = loadFamiliesFromCache();
+
+    // The ref keeps this manager alive until the scan finishes
+    Ref<FontManager> self = AddRef((FontManager*)this);
+    pool.execute(
+      [this, self, onDone, warmStart]{
+        const int n = m_skFontMgr->countFamilies();
+        std::vector<std::pair<std::string, Ref<FontStyleSet>>> families;
+        families.reserve(n);
+        for (int i=0; i<n; ++i) {
+          SkString name;
+          m_skFontMgr->getFamilyName(i, &name);
+          auto styleSet = make_ref<SkiaFontStyleSet>(m_skFontMgr->createStyleSet(i));
+          families.push_back(std::make_pair(std::string(name.c_str()),
+                                            styleSet));
+
+          // Cold start: publish each family as soon as it's
+          // enumerated (the accessors serve the progressive list)
+          if (!warmStart) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_families.push_back(families.back());
+          }
+        }
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_families.swap(families);
+        }
+        saveFamiliesToCache();
+        if (onDone)
+          onDone();
+      });
+  }
+
+  void prefetchFamilies(const std::vector<std::string>& families,
+                        base::thread_pool& pool) override {
+    // The ref keeps this manager alive until the prefetch finishes
+    Ref<FontManager> self = AddRef((FontManager*)this);
+    pool.execute(
+      [this, self, families]{
+        for (const auto& name : families) {
+          Ref<FontStyleSet> set = matchFamily(name);
+          if (!set)
+            continue;
+
+          // Warm the common UI styles so label style changes don't
+          // leave the cache
+          for (const FontStyle style : { FontStyle::Normal(),
+                                         FontStyle::Bold(),
+                                         FontStyle::Italic(),
+                                         FontStyle::BoldItalic() }) {
+            set->matchStyle(style);
+          }
+        }
+      });
   }
 
 private:
+  // Persistent family list (font_cache_dir()/families.lafcache): the
+  // family names of the previous run keyed by a hash of the system
+  // font directories' mtimes. Only a fast-start hint: the background
+  // scan always re-enumerates and replaces/rewrites it.
+  static constexpr uint32_t kFamiliesCacheMagic = 0x4346464C; // "LFFC"
+  static constexpr uint32_t kFamiliesCacheVersion = 1;
+
+  static uint64_t fontDirsHash() {
+    std::vector<std::string> dirs;
+#if LAF_WINDOWS
+    if (const char* windir = std::getenv("WINDIR"))
+      dirs.push_back(base::join_path(windir, "Fonts"));
+#elif LAF_MACOS
+    dirs.push_back("/System/Library/Fonts");
+    dirs.push_back("/Library/Fonts");
+#else
+    dirs.push_back("/usr/share/fonts");
+    dirs.push_back("/usr/local/share/fonts");
+    if (const char* home = std::getenv("HOME")) {
+      dirs.push_back(base::join_path(home, ".fonts"));
+      dirs.push_back(base::join_path(home, ".local/share/fonts"));
+    }
+#endif
+
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, const size_t n) {
+      const uint8_t* p = (const uint8_t*)data;
+      for (size_t i=0; i<n; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+      }
+    };
+    for (const std::string& dir : dirs) {
+      if (!base::is_directory(dir))
+        continue;
+      mix(dir.data(), dir.size());
+      const base::Time time = base::get_modification_time(dir);
+      const int t[6] = { time.year, time.month, time.day,
+                         time.hour, time.minute, time.second };
+      mix(t, sizeof(t));
+    }
+    return hash;
+  }
+
+  bool loadFamiliesFromCache() {
+    if (font_cache_dir().empty())
+      return false;
+
+    const base::mapped_file file = base::map_file_content(
+      base::join_path(font_cache_dir(), "families.lafcache"));
+    if (file.empty())
+      return false;
+
+    base::serialization::deserializer d(file.data(), file.size());
+    if (d.read32() != kFamiliesCacheMagic ||
+        d.read32() != kFamiliesCacheVersion ||
+        d.read64() != fontDirsHash())
+      return false;
+
+    const size_t count = size_t(d.read_varuint());
+    std::vector<std::pair<std::string, Ref<FontStyleSet>>> families;
+    families.reserve(count);
+    for (size_t i=0; i<count && d.ok(); ++i) {
+      const size_t len = size_t(d.read_varuint());
+      if (len > 1024)
+        return false;
+      std::string name(len, 0);
+      if (d.read_bytes((uint8_t*)name.data(), len) != len)
+        return false;
+      families.push_back(std::make_pair(std::move(name), nullptr));
+    }
+    if (!d.ok() || families.size() != count || families.empty())
+      return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_families.swap(families);
+    return true;
+  }
+
+  void saveFamiliesToCache() const {
+    if (font_cache_dir().empty())
+      return;
+
+    base::buffer buf;
+    base::serialization::serializer s(buf);
+    s.write32(kFamiliesCacheMagic);
+    s.write32(kFamiliesCacheVersion);
+    s.write64(fontDirsHash());
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      s.write_varuint(m_families.size());
+      for (const auto& entry : m_families) {
+        s.write_varuint(entry.first.size());
+        s.write_bytes((const uint8_t*)entry.first.data(),
+                      entry.first.size());
+      }
+    }
+    base::atomic_write_file(
+      base::join_path(font_cache_dir(), "families.lafcache"),
+      buf.data(), buf.size(),
+      base::durability::none);
+  }
+
   sk_sp<SkFontMgr> m_skFontMgr;
+
+  // Families collected by enumerateFamiliesAsync() (used by the
+  // accessors above as soon as the scan starts). Mutable because
+  // familyStyleSet() resolves cached entries lazily.
+  mutable std::mutex m_mutex;
+  mutable std::vector<std::pair<std::string, Ref<FontStyleSet>>> m_families;
+  std::atomic<bool> m_scanStarted{false};
+
+  // matchFamily() cache (guarded by m_mutex)
+  mutable std::unordered_map<std::string, Ref<FontStyleSet>> m_matchedFamilies;
 };
 
 } // namespace os
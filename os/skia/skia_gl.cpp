@@ -10,6 +10,7 @@
 
 #include "base/log.h"
 #include "os/skia/skia_gl.h"
+#include "os/skia/skia_shader_cache.h"
 
 #if SK_SUPPORT_GPU
 
@@ -17,8 +18,32 @@
 #include "include/core/SkSurfaceCharacterization.h"
 #include "src/gpu/gl/GrGLDefines.h"
 
+#include <string>
+
+// Timer-query tokens, not covered by GrGLDefines.h
+#ifndef GR_GL_TIME_ELAPSED
+  #define GR_GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GR_GL_QUERY_RESULT_AVAILABLE
+  #define GR_GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+#ifndef GR_GL_QUERY_RESULT
+  #define GR_GL_QUERY_RESULT 0x8866
+#endif
+
 namespace os {
 
+// GrDirectContext shared between all the SkiaGL instances: the
+// platform GLContexts are created in the same share group (see
+// GLContextGLX/WGL/NSGL), so one GrDirectContext can serve every
+// window and multi-window setups share the glyph atlas, uploaded
+// images and compiled programs instead of duplicating them per
+// window. g_users counts the attached windows to abandon the context
+// only when the last one detaches.
+static sk_sp<const GrGLInterface> g_glInterfaces;
+static sk_sp<GrDirectContext> g_grCtx;
+static int g_users = 0;
+
 SkiaGL::SkiaGL()
 {
 }
@@ -28,6 +53,13 @@ bool SkiaGL::attachGL()
   if (m_grCtx)
     return true;
 
+  if (g_grCtx) {
+    m_glInterfaces = g_glInterfaces;
+    m_grCtx = g_grCtx;
+    ++g_users;
+    return true;
+  }
+
   try {
     m_glInterfaces = GrGLMakeNativeInterface();
     if (!m_glInterfaces) {
@@ -36,13 +68,32 @@ bool SkiaGL::attachGL()
       return false;
     }
 
-    m_grCtx = GrDirectContext::MakeGL(m_glInterfaces);
+    // Tag the shader cache with the driver identity before the
+    // context starts compiling programs (see SkiaShaderCache)
+    if (const auto& getString = m_glInterfaces->fFunctions.fGetString) {
+      std::string identity;
+      for (const GrGLenum token : { GR_GL_VENDOR, GR_GL_RENDERER, GR_GL_VERSION }) {
+        if (const GrGLubyte* str = getString(token)) {
+          identity += (const char*)str;
+          identity += '\n';
+        }
+      }
+      SkiaShaderCache::instance().setDriverIdentity(identity);
+    }
+
+    GrContextOptions grOptions;
+    grOptions.fPersistentCache = &SkiaShaderCache::instance();
+    m_grCtx = GrDirectContext::MakeGL(m_glInterfaces, grOptions);
     if (!m_grCtx) {
       LOG(ERROR, "OS: Cannot create GrContext\n");
       detachGL();
       return false;
     }
 
+    g_glInterfaces = m_glInterfaces;
+    g_grCtx = m_grCtx;
+    g_users = 1;
+
     LOG("OS: Using OpenGL backend\n");
   }
   catch (const std::exception& ex) {
@@ -53,10 +104,68 @@ bool SkiaGL::attachGL()
   return true;
 }
 
+void SkiaGL::beginFrameTiming()
+{
+  if (!m_glInterfaces)
+    return;
+  const auto& f = m_glInterfaces->fFunctions;
+  if (!f.fGenQueries || !f.fBeginQuery || !f.fEndQuery ||
+      !f.fGetQueryObjectuiv || !f.fGetQueryObjectui64v)
+    return;                     // Timer queries not supported
+
+  if (!m_queries[0])
+    f.fGenQueries(kFrameQueries, m_queries);
+
+  // Harvest finished queries oldest-first, without blocking: a
+  // result that isn't ready yet is read on a later frame.
+  while (m_queriesPending > 0) {
+    GrGLuint available = 0;
+    f.fGetQueryObjectuiv(m_queries[m_queryTail],
+                         GR_GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      break;
+    GrGLuint64 ns = 0;
+    f.fGetQueryObjectui64v(m_queries[m_queryTail],
+                           GR_GL_QUERY_RESULT, &ns);
+    m_timing.gpuMsecs = double(ns) / 1.0e6;
+    m_queryTail = (m_queryTail+1) % kFrameQueries;
+    --m_queriesPending;
+  }
+
+  // All queries in flight: skip timing this frame rather than stall
+  if (m_queriesPending == kFrameQueries)
+    return;
+
+  f.fBeginQuery(GR_GL_TIME_ELAPSED, m_queries[m_queryHead]);
+  m_queryOpen = true;
+}
+
+void SkiaGL::endFrameTiming()
+{
+  if (!m_queryOpen)
+    return;
+  m_glInterfaces->fFunctions.fEndQuery(GR_GL_TIME_ELAPSED);
+  m_queryHead = (m_queryHead+1) % kFrameQueries;
+  ++m_queriesPending;
+  m_queryOpen = false;
+}
+
 void SkiaGL::detachGL()
 {
+  if (m_queries[0] && m_glInterfaces &&
+      m_glInterfaces->fFunctions.fDeleteQueries) {
+    m_glInterfaces->fFunctions.fDeleteQueries(kFrameQueries, m_queries);
+    for (int i=0; i<kFrameQueries; ++i)
+      m_queries[i] = 0;
+    m_queryHead = m_queryTail = m_queriesPending = 0;
+    m_queryOpen = false;
+  }
   if (m_grCtx) {
-    m_grCtx->abandonContext();
+    if (--g_users == 0) {
+      g_grCtx.reset(nullptr);
+      g_glInterfaces.reset(nullptr);
+      m_grCtx->abandonContext();
+    }
     m_grCtx.reset(nullptr);
   }
   m_glInterfaces.reset(nullptr);
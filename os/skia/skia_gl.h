@@ -31,6 +31,10 @@ public:
   GrDirectContext* grCtx() const { return m_grCtx.get(); };
   const GrGLInterface* glInterfaces() const { return m_glInterfaces.get(); };
 
+  // Attaches/detaches this instance to the GrDirectContext shared by
+  // all windows (created the first time). The caller's GL context
+  // must be current and belong to the share group built by the
+  // platform GLContext implementations.
   bool attachGL();
   void detachGL();
 
@@ -41,11 +45,37 @@ public:
   sk_sp<SkSurface> backbufferSurface() const { return m_backbufferSurface; }
   sk_sp<SkSurface> surface() const { return m_surface; }
 
+  // GPU frame timing with GL timer queries (see
+  // Window::gpuFrameTiming()). beginFrameTiming() opens a
+  // GL_TIME_ELAPSED query over the frame's GPU commands (and harvests
+  // the results of previous frames without blocking),
+  // endFrameTiming() closes it before the buffer swap, and
+  // recordSyncStall() stores how long the CPU waited in
+  // flush/swap. All three must run with the GL context current.
+  struct FrameTiming {
+    double gpuMsecs = -1.0;     // Newest harvested GPU frame time
+    double syncMsecs = 0.0;     // CPU stall of the last flush+swap
+  };
+  void beginFrameTiming();
+  void endFrameTiming();
+  void recordSyncStall(const double msecs) { m_timing.syncMsecs = msecs; }
+  FrameTiming frameTiming() const { return m_timing; }
+
 private:
+  // Ring of in-flight timer queries so reading results never stalls
+  // waiting for the GPU (a result is harvested a few frames later).
+  static constexpr int kFrameQueries = 4;
+
   sk_sp<const GrGLInterface> m_glInterfaces;
   sk_sp<GrDirectContext> m_grCtx;
   sk_sp<SkSurface> m_backbufferSurface;
   sk_sp<SkSurface> m_surface;
+  unsigned m_queries[kFrameQueries] = { 0, 0, 0, 0 };
+  int m_queryHead = 0;          // Next query to begin
+  int m_queryTail = 0;          // Oldest pending query
+  int m_queriesPending = 0;
+  bool m_queryOpen = false;
+  FrameTiming m_timing;
 
   DISABLE_COPYING(SkiaGL);
 };
@@ -0,0 +1,165 @@
+// LAF OS Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/skia/skia_glyph_atlas.h"
+
+#include "base/task.h"
+#include "os/skia/skia_helpers.h"
+#include "os/skia/skia_surface.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkRSXform.h"
+
+#include <algorithm>
+
+namespace os {
+
+// Initial/maximum side of the A8 atlas texture. 512x512 holds the
+// whole working set of a couple of UI font sizes; the cap keeps the
+// worst case at 16MB of coverage.
+static const int kInitialAtlasSide = 512;
+static const int kMaxAtlasSide = 4096;
+
+// Padding between glyphs so linear sampling doesn't bleed the
+// neighbor coverage.
+static const int kGlyphPadding = 1;
+
+// static
+SkiaGlyphAtlas* SkiaGlyphAtlas::instance()
+{
+  static SkiaGlyphAtlas atlas;
+  return &atlas;
+}
+
+SkiaGlyphAtlas::SkiaGlyphAtlas()
+{
+  reset(kInitialAtlasSide);
+}
+
+void SkiaGlyphAtlas::reset(const int side)
+{
+  m_side = side;
+  ++m_generation;
+  m_glyphs.clear();
+
+  // pack() without rectangles just initializes the free space for
+  // the incremental tryPlace() calls
+  m_packing = gfx::PackingRects(0, kGlyphPadding);
+  base::task_token token;
+  m_packing.pack(gfx::Size(m_side, m_side), token);
+
+  m_bitmap.allocPixels(SkImageInfo::MakeA8(m_side, m_side));
+  m_bitmap.eraseColor(0);
+  m_image.reset();
+}
+
+const gfx::Rect* SkiaGlyphAtlas::glyphRect(
+  const FreeTypeFont* font,
+  const FT_UInt glyphIndex,
+  const FreeTypeFont::GlyphBitmap& coverage)
+{
+  const Key key(font, glyphIndex);
+  auto it = m_glyphs.find(key);
+  if (it != m_glyphs.end())
+    return &it->second;
+
+  gfx::Rect rc;
+  while (!m_packing.tryPlace(gfx::Size(coverage.width, coverage.rows), &rc)) {
+    if (m_side >= kMaxAtlasSide)
+      return nullptr;
+    // Double the atlas and let glyphs re-upload lazily as they are
+    // requested again
+    reset(m_side*2);
+  }
+
+  for (int v=0; v<coverage.rows; ++v) {
+    std::copy(coverage.row(v),
+              coverage.row(v) + coverage.width,
+              m_bitmap.getAddr8(rc.x, rc.y+v));
+  }
+  m_image.reset();
+
+  return &m_glyphs.insert(std::make_pair(key, rc)).first->second;
+}
+
+SkImage* SkiaGlyphAtlas::image()
+{
+  if (!m_image)
+    m_image = SkImage::MakeFromRaster(m_bitmap.pixmap(), nullptr, nullptr);
+  return m_image.get();
+}
+
+void draw_glyph_run_with_atlas(SkiaSurface* surface,
+                               const FreeTypeFont* font,
+                               const std::vector<FreeTypeFont::RunGlyph>& run,
+                               const gfx::Color fg,
+                               const gfx::Color bg)
+{
+  SkiaGlyphAtlas* atlas = SkiaGlyphAtlas::instance();
+
+  std::vector<SkRSXform> xforms;
+  std::vector<SkRect> tex;
+  xforms.reserve(run.size());
+  tex.reserve(run.size());
+
+  // Collect the quads, restarting if placing a new glyph forced an
+  // atlas repack that invalidated the rects collected so far
+  int generation;
+  do {
+    generation = atlas->generation();
+    xforms.clear();
+    tex.clear();
+
+    for (const FreeTypeFont::RunGlyph& g : run) {
+      if (g.coverage->width <= 0 || g.coverage->rows <= 0)
+        continue;               // Blank glyphs (spaces) have no quad
+
+      const gfx::Rect* rc = atlas->glyphRect(font, g.glyphIndex, *g.coverage);
+      if (!rc)
+        continue;               // Doesn't fit even the biggest atlas
+
+      // The destination bounds are already clipped: source the same
+      // sub-rectangle of the glyph
+      tex.push_back(SkRect::MakeXYWH(rc->x + (g.bounds.x - g.orig.x),
+                                     rc->y + (g.bounds.y - g.orig.y),
+                                     g.bounds.w, g.bounds.h));
+      xforms.push_back(SkRSXform::Make(1.0f, 0.0f,
+                                       SkScalar(g.bounds.x),
+                                       SkScalar(g.bounds.y)));
+    }
+  } while (generation != atlas->generation());
+
+  SkCanvas& canvas = surface->canvas();
+
+  if (gfx::geta(bg) > 0) {
+    SkPaint bgPaint;
+    bgPaint.setColor(to_skia(bg));
+    for (const FreeTypeFont::RunGlyph& g : run)
+      canvas.drawIRect(SkIRect::MakeXYWH(g.bounds.x, g.bounds.y,
+                                         g.bounds.w, g.bounds.h),
+                       bgPaint);
+  }
+
+  if (tex.empty())
+    return;
+
+  // The atlas is alpha-only, so the quads take the paint color
+  // modulated by the sampled coverage
+  SkPaint paint;
+  paint.setColor(to_skia(fg));
+  canvas.drawAtlas(atlas->image(),
+                   xforms.data(), tex.data(), nullptr,
+                   int(tex.size()),
+                   SkBlendMode::kSrcOver,
+                   SkSamplingOptions(),
+                   nullptr, &paint);
+}
+
+} // namespace os
@@ -0,0 +1,79 @@
+// LAF OS Library
+// Copyright (C) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_SKIA_SKIA_GLYPH_ATLAS_INCLUDED
+#define OS_SKIA_SKIA_GLYPH_ATLAS_INCLUDED
+#pragma once
+
+#include "gfx/color.h"
+#include "gfx/packing_rects.h"
+#include "os/common/freetype_font.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkImage.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace os {
+
+class SkiaSurface;
+
+// Single A8 texture with the rasterized FreeType glyph coverages
+// packed by gfx::PackingRects (skyline strategy, incremental
+// tryPlace() per new glyph), so GPU-backed surfaces can draw whole
+// text runs as textured quads in one drawAtlas() call instead of
+// compositing CPU-side and re-uploading the result. When the atlas
+// fills up it's doubled (up to a cap) and repacked lazily: glyphs
+// are re-uploaded as they are requested again.
+class SkiaGlyphAtlas {
+public:
+  static SkiaGlyphAtlas* instance();
+
+  // Returns the atlas bounds of the given glyph, packing and
+  // uploading its coverage on demand, or nullptr when the glyph
+  // doesn't fit even in the biggest atlas. The pointer (and any
+  // previously returned one) is invalidated when generation()
+  // changes.
+  const gfx::Rect* glyphRect(const FreeTypeFont* font,
+                             const FT_UInt glyphIndex,
+                             const FreeTypeFont::GlyphBitmap& coverage);
+
+  // Bumped each time the atlas is repacked (glyph rects from older
+  // generations are no longer valid).
+  int generation() const { return m_generation; }
+
+  // Zero-copy SkImage wrapper over the atlas pixels (rebuilt after
+  // each new glyph upload, so Skia re-uploads the texture only when
+  // the atlas changed).
+  SkImage* image();
+
+private:
+  SkiaGlyphAtlas();
+  void reset(int side);
+
+  using Key = std::pair<const FreeTypeFont*, FT_UInt>;
+
+  std::map<Key, gfx::Rect> m_glyphs;
+  gfx::PackingRects m_packing;
+  SkBitmap m_bitmap;
+  sk_sp<SkImage> m_image;
+  int m_side;
+  int m_generation = 0;
+};
+
+// Draws an accumulated text run (os::draw_text()) as textured quads
+// sourced from the shared glyph atlas.
+void draw_glyph_run_with_atlas(SkiaSurface* surface,
+                               const FreeTypeFont* font,
+                               const std::vector<FreeTypeFont::RunGlyph>& run,
+                               const gfx::Color fg,
+                               const gfx::Color bg);
+
+} // namespace os
+
+#endif
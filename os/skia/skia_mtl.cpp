@@ -0,0 +1,117 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "base/log.h"
+#include "os/skia/skia_mtl.h"
+
+#if SK_SUPPORT_GPU && LAF_MACOS
+
+#include "os/mtl/mtl_context.h"
+
+#include "include/gpu/mtl/GrMtlBackendContext.h"
+#include "include/gpu/mtl/GrMtlTypes.h"
+
+#include <algorithm>
+
+namespace os {
+
+SkiaMtl::SkiaMtl()
+{
+}
+
+bool SkiaMtl::attachMtl(MtlContext* ctx)
+{
+  if (m_grCtx)
+    return true;
+
+  if (!ctx || !ctx->isValid())
+    return false;
+
+  GrMtlBackendContext backendCtx;
+  backendCtx.fDevice.retain((GrMTLHandle)ctx->device());
+  backendCtx.fQueue.retain((GrMTLHandle)ctx->queue());
+
+  m_grCtx = GrDirectContext::MakeMetal(backendCtx);
+  if (!m_grCtx) {
+    LOG(ERROR, "OS: Cannot create Metal GrContext\n");
+    return false;
+  }
+
+  LOG("OS: Using Metal backend\n");
+  return true;
+}
+
+void SkiaMtl::detachMtl()
+{
+  m_surface.reset();
+  m_colorSpace.reset();
+  m_grCtx.reset();
+}
+
+bool SkiaMtl::createRenderTarget(const gfx::Size& size,
+                                 const int scale,
+                                 sk_sp<SkColorSpace> colorSpace)
+{
+  if (!m_grCtx)
+    return false;
+
+  // The drawing surface is always offscreen (even with scale=1): the
+  // CAMetalDrawable wrapped in beginFrame() is only valid during one
+  // frame, so it cannot be exposed as Window::surface().
+  SkImageInfo info = SkImageInfo::Make(
+    std::max(1, size.w / scale),
+    std::max(1, size.h / scale),
+    kN32_SkColorType,
+    kOpaque_SkAlphaType,
+    colorSpace);
+
+  m_colorSpace = colorSpace;
+  m_surface =
+    SkSurface::MakeRenderTarget(
+      m_grCtx.get(), SkBudgeted::kNo, info);
+
+  return (m_surface != nullptr);
+}
+
+sk_sp<SkSurface> SkiaMtl::beginFrame(MtlContext* ctx, void** drawable)
+{
+  *drawable = nullptr;
+  if (!m_grCtx || !ctx || !ctx->layer())
+    return nullptr;
+
+  GrMTLHandle drawableHandle = nullptr;
+  sk_sp<SkSurface> backbuffer =
+    SkSurface::MakeFromCAMetalLayer(
+      m_grCtx.get(),
+      (GrMTLHandle)ctx->layer(),
+      kTopLeft_GrSurfaceOrigin,
+      1,                        // Sample count
+      kBGRA_8888_SkColorType,
+      m_colorSpace,
+      nullptr,                  // Surface props
+      &drawableHandle);
+
+  *drawable = (void*)drawableHandle;
+  return backbuffer;
+}
+
+void SkiaMtl::endFrame(MtlContext* ctx, void* drawable)
+{
+  if (m_grCtx)
+    m_grCtx->flushAndSubmit();
+
+  // MtlContext::present() takes the ownership of the drawable handle.
+  if (ctx && drawable)
+    ctx->present(drawable);
+}
+
+} // namespace os
+
+#endif // SK_SUPPORT_GPU && LAF_MACOS
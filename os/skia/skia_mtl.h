@@ -0,0 +1,77 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_SKIA_SKIA_MTL_INCLUDED
+#define OS_SKIA_SKIA_MTL_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "gfx/size.h"
+
+#if SK_SUPPORT_GPU && LAF_MACOS
+  #include "include/core/SkColorSpace.h"
+  #include "include/core/SkRefCnt.h"
+  #include "include/core/SkSurface.h"
+  #include "include/gpu/GrDirectContext.h"
+#endif
+
+namespace os {
+
+class MtlContext;
+
+#if SK_SUPPORT_GPU && LAF_MACOS
+
+// Skia side of the Metal window backend: the GrDirectContext built
+// on top of an MtlContext and the offscreen render target exposed as
+// Window::surface(). Unlike GL there is no persistent backbuffer,
+// each frame wraps a transient CAMetalDrawable between beginFrame()
+// and endFrame().
+class SkiaMtl {
+public:
+  SkiaMtl();
+
+  bool hasCtx() const { return m_grCtx != nullptr; }
+  GrDirectContext* grCtx() const { return m_grCtx.get(); }
+
+  bool attachMtl(MtlContext* ctx);
+  void detachMtl();
+
+  // Creates the offscreen surface (of size/scale) where the client
+  // code draws; SkiaWindowBase::swapBuffers() scales it into the
+  // drawable.
+  bool createRenderTarget(const gfx::Size& size,
+                          const int scale,
+                          sk_sp<SkColorSpace> colorSpace);
+
+  sk_sp<SkSurface> surface() const { return m_surface; }
+
+  // Wraps the next CAMetalDrawable of the layer in a SkSurface.
+  // Returns nullptr if the drawable cannot be acquired (e.g. all the
+  // drawables are still in flight). The handle filled in "drawable"
+  // must be given back to endFrame().
+  sk_sp<SkSurface> beginFrame(MtlContext* ctx, void** drawable);
+
+  // Submits the frame's commands and schedules the drawable
+  // presentation.
+  void endFrame(MtlContext* ctx, void* drawable);
+
+private:
+  sk_sp<GrDirectContext> m_grCtx;
+  sk_sp<SkSurface> m_surface;
+  sk_sp<SkColorSpace> m_colorSpace;
+
+  DISABLE_COPYING(SkiaMtl);
+};
+
+#else // !SK_SUPPORT_GPU || !LAF_MACOS
+
+class SkiaMtl { };
+
+#endif
+
+} // namespace os
+
+#endif
@@ -0,0 +1,207 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/skia/skia_shader_cache.h"
+
+#if SK_SUPPORT_GPU
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/serialization.h"
+#include "base/thread_pool.h"
+
+#include "include/core/SkData.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace os {
+
+using namespace base::serialization;
+
+namespace {
+
+// "LFSC" magic + format version at the start of every entry file
+const uint32_t kMagic = 0x4353464C;
+const uint32_t kFormatVersion = 1;
+
+// Sanity limit for one entry read from disk
+const size_t kMaxEntryBytes = 1 << 26;
+
+uint64_t fnv1a(uint64_t hash, const void* data, const size_t n)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  for (size_t i=0; i<n; ++i) {
+    hash ^= p[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// Extracts the payload of a serialized entry, checking that its full
+// key matches (the file name only carries a hash of it). Returns an
+// empty buffer on mismatch/corruption.
+base::buffer entry_payload(const base::buffer& content,
+                           const SkData& key)
+{
+  deserializer d(content.data(), content.size());
+  if (d.read32() != kMagic ||
+      d.read32() != kFormatVersion)
+    return base::buffer();
+
+  const size_t keyLen = size_t(d.read_varuint());
+  if (keyLen != key.size() || keyLen > kMaxEntryBytes)
+    return base::buffer();
+  base::buffer keyBytes(keyLen);
+  if (d.read_bytes(keyBytes.data(), keyLen) != keyLen ||
+      std::memcmp(keyBytes.data(), key.data(), keyLen) != 0)
+    return base::buffer();
+
+  const size_t dataLen = size_t(d.read_varuint());
+  if (dataLen == 0 || dataLen > kMaxEntryBytes)
+    return base::buffer();
+  base::buffer data(dataLen);
+  if (d.read_bytes(data.data(), dataLen) != dataLen || !d.ok())
+    return base::buffer();
+  return data;
+}
+
+} // anonymous namespace
+
+// static
+SkiaShaderCache& SkiaShaderCache::instance()
+{
+  static SkiaShaderCache cache;
+  return cache;
+}
+
+void SkiaShaderCache::setDir(const std::string& dir)
+{
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_dir = dir;
+}
+
+void SkiaShaderCache::setDriverIdentity(const std::string& identity)
+{
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_driverIdentity = identity;
+}
+
+void SkiaShaderCache::warm(base::thread_pool& pool)
+{
+  pool.execute(
+    [this]{
+      std::string dir;
+      {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        dir = m_dir;
+      }
+      if (dir.empty() || !base::is_directory(dir))
+        return;
+
+      for (const std::string& fn : base::list_files(dir)) {
+        if (base::get_file_extension(fn) != "lafcache" ||
+            fn.compare(0, 7, "shader-") != 0)
+          continue;
+
+        base::buffer content =
+          base::read_file_content(base::join_path(dir, fn));
+        if (content.empty() || content.size() > kMaxEntryBytes)
+          continue;
+
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries[fn] = std::move(content);
+      }
+    });
+}
+
+sk_sp<SkData> SkiaShaderCache::load(const SkData& key)
+{
+  std::string dir, fn;
+  base::buffer content;
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_dir.empty())
+      return nullptr;
+    dir = m_dir;
+    fn = entryFilename(key);
+
+    auto it = m_entries.find(fn);
+    if (it != m_entries.end())
+      content = it->second;     // Warmed or stored in this session
+  }
+
+  if (content.empty()) {
+    content = base::read_file_content(base::join_path(dir, fn));
+    if (content.empty() || content.size() > kMaxEntryBytes)
+      return nullptr;
+  }
+
+  const base::buffer data = entry_payload(content, key);
+  if (data.empty())
+    return nullptr;
+  return SkData::MakeWithCopy(data.data(), data.size());
+}
+
+void SkiaShaderCache::store(const SkData& key, const SkData& data)
+{
+  std::string dir, fn;
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_dir.empty() || data.size() == 0 || data.size() > kMaxEntryBytes)
+      return;
+    dir = m_dir;
+    fn = entryFilename(key);
+  }
+
+  try {
+    if (!base::is_directory(dir))
+      base::make_all_directories(dir);
+  }
+  catch (const std::exception&) {
+    return;
+  }
+
+  base::buffer buf;
+  serializer s(buf);
+  s.write32(kMagic);
+  s.write32(kFormatVersion);
+  s.write_varuint(key.size());
+  s.write_bytes((const uint8_t*)key.data(), key.size());
+  s.write_varuint(data.size());
+  s.write_bytes((const uint8_t*)data.data(), data.size());
+
+  // A shader cache is expendable: don't pay any flush for it
+  if (base::atomic_write_file(base::join_path(dir, fn),
+                              buf.data(), buf.size(),
+                              base::durability::none)) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[fn] = std::move(buf);
+  }
+}
+
+std::string SkiaShaderCache::entryFilename(const SkData& key) const
+{
+  // The driver identity participates in the hash, so a driver update
+  // misses (and eventually replaces) the entries of the old driver
+  uint64_t hash = 14695981039346656037ull;
+  hash = fnv1a(hash, m_driverIdentity.data(), m_driverIdentity.size());
+  hash = fnv1a(hash, key.data(), key.size());
+
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "shader-%016llx.lafcache",
+                (unsigned long long)hash);
+  return buf;
+}
+
+} // namespace os
+
+#endif // SK_SUPPORT_GPU
@@ -0,0 +1,69 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_SKIA_SKIA_SHADER_CACHE_INCLUDED
+#define OS_SKIA_SKIA_SHADER_CACHE_INCLUDED
+#pragma once
+
+#include "include/core/SkTypes.h"
+
+#if SK_SUPPORT_GPU
+
+#include "base/buffer.h"
+
+#include "include/gpu/GrContextOptions.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace base {
+  class thread_pool;
+}
+
+namespace os {
+
+// Persistent cache of GPU-compiled shader programs, plugged into the
+// GrDirectContext as GrContextOptions::fPersistentCache. The driver
+// compile of a runtime effect costs 100-300ms the first time it's
+// drawn; with this cache the compiled program of a previous run is
+// handed back to Skia instead, so shader-based filters don't hitch
+// on first use in every process. Entries are keyed by the Skia
+// program key hashed together with the driver identity
+// (vendor/renderer/version), so a driver update naturally misses the
+// old entries. Disabled while no directory is set.
+class SkiaShaderCache : public GrContextOptions::PersistentCache {
+public:
+  static SkiaShaderCache& instance();
+
+  void setDir(const std::string& dir);
+  void setDriverIdentity(const std::string& identity);
+
+  // Reads every cached program into memory on the pool, so the first
+  // load() of each program during startup painting is a map lookup
+  // instead of disk I/O.
+  void warm(base::thread_pool& pool);
+
+  // GrContextOptions::PersistentCache impl
+  sk_sp<SkData> load(const SkData& key) override;
+  void store(const SkData& key, const SkData& data) override;
+
+private:
+  std::string entryFilename(const SkData& key) const;
+
+  std::mutex m_mutex;
+  std::string m_dir;
+  std::string m_driverIdentity;
+  // Entry file name -> serialized entry content (warmed or stored in
+  // this session)
+  std::map<std::string, base::buffer> m_entries;
+};
+
+} // namespace os
+
+#endif // SK_SUPPORT_GPU
+
+#endif
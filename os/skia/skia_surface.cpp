@@ -12,6 +12,8 @@
 #include "os/skia/skia_surface.h"
 
 #include "base/file_handle.h"
+#include "base/shared_memory.h"
+#include "base/thread_pool.h"
 #include "gfx/path.h"
 #include "os/skia/skia_helpers.h"
 #include "os/system.h"
@@ -19,6 +21,9 @@
 #include "include/codec/SkCodec.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
+#include "include/core/SkMallocPixelRef.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixelRef.h"
 #include "include/core/SkStream.h"
 #include "include/private/SkColorData.h"
@@ -28,10 +33,27 @@
   #include "include/gpu/GrBackendSurface.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 namespace os {
 
+// Tile side for drawTiled(). Big enough to amortize the per-tile
+// canvas setup, small enough to balance uneven workloads on a 4K
+// destination.
+static const int kRenderTileSize = 256;
+
+// Draw statistics (see Surface::stats()): the counting expressions
+// compile to nothing without the LAF_SURFACE_STATS flag.
+#ifdef LAF_SURFACE_STATS
+  #define SURFACE_STAT(code) code
+#else
+  #define SURFACE_STAT(code)
+#endif
+
 SkiaSurface::SkiaSurface()
   : m_surface(nullptr)
   , m_colorSpace(nullptr)
@@ -57,7 +79,31 @@ SkiaSurface::~SkiaSurface()
   destroy();
 }
 
-void SkiaSurface::create(int width, int height, const os::ColorSpaceRef& cs)
+// Allocates the pixels of "bmp" for the given logical "info", with
+// storage for capacityWidth x capacityHeight pixels (the extra
+// rows/columns are reachable later through SkiaSurface::tryResize()).
+static bool alloc_bitmap(SkBitmap& bmp, const SkImageInfo& info,
+                         int capacityWidth, int capacityHeight)
+{
+  capacityWidth = std::max(capacityWidth, info.width());
+  capacityHeight = std::max(capacityHeight, info.height());
+  if (capacityWidth == info.width() &&
+      capacityHeight == info.height())
+    return bmp.tryAllocPixels(info);
+
+  const SkImageInfo capacityInfo = info.makeWH(capacityWidth, capacityHeight);
+  sk_sp<SkPixelRef> ref =
+    SkMallocPixelRef::MakeAllocate(capacityInfo, capacityInfo.minRowBytes());
+  if (!ref)
+    return false;
+
+  bmp.setInfo(info, ref->rowBytes());
+  bmp.setPixelRef(std::move(ref), 0, 0);
+  return true;
+}
+
+void SkiaSurface::create(int width, int height, const os::ColorSpaceRef& cs,
+                         int capacityWidth, int capacityHeight)
 {
   destroy();
 
@@ -68,15 +114,17 @@ void SkiaSurface::create(int width, int height, const os::ColorSpaceRef& cs)
   m_colorSpace = cs;
 
   SkBitmap bmp;
-  if (!bmp.tryAllocPixels(
-        SkImageInfo::MakeN32(width, height, kOpaque_SkAlphaType, skColorSpace())))
+  if (!alloc_bitmap(
+        bmp, SkImageInfo::MakeN32(width, height, kOpaque_SkAlphaType, skColorSpace()),
+        capacityWidth, capacityHeight))
     throw base::Exception("Cannot create Skia surface");
 
   bmp.eraseColor(SK_ColorTRANSPARENT);
   swapBitmap(bmp);
 }
 
-void SkiaSurface::createRgba(int width, int height, const os::ColorSpaceRef& cs)
+void SkiaSurface::createRgba(int width, int height, const os::ColorSpaceRef& cs,
+                             int capacityWidth, int capacityHeight)
 {
   destroy();
 
@@ -87,14 +135,54 @@ void SkiaSurface::createRgba(int width, int height, const os::ColorSpaceRef& cs)
   m_colorSpace = cs;
 
   SkBitmap bmp;
-  if (!bmp.tryAllocPixels(
-        SkImageInfo::MakeN32Premul(width, height, skColorSpace())))
+  if (!alloc_bitmap(
+        bmp, SkImageInfo::MakeN32Premul(width, height, skColorSpace()),
+        capacityWidth, capacityHeight))
     throw base::Exception("Cannot create Skia surface");
 
   bmp.eraseColor(SK_ColorTRANSPARENT);
   swapBitmap(bmp);
 }
 
+bool SkiaSurface::tryResize(int width, int height)
+{
+  ASSERT(width > 0);
+  ASSERT(height > 0);
+
+  if (m_surface || m_bitmap.isNull())
+    return false;
+
+  // Immutable pixels can be shared with other surfaces
+  // (shareImmutable()), never reconfigure them in-place.
+  if (m_bitmap.isImmutable())
+    return false;
+
+  SkPixelRef* ref = m_bitmap.pixelRef();
+  if (!ref ||
+      size_t(width)*m_bitmap.bytesPerPixel() > ref->rowBytes() ||
+      height > ref->height())
+    return false;
+
+  const int oldW = m_bitmap.width();
+  const int oldH = m_bitmap.height();
+  if (width == oldW && height == oldH)
+    return true;
+
+  SkBitmap bmp;
+  bmp.setInfo(m_bitmap.info().makeWH(width, height), ref->rowBytes());
+  bmp.setPixelRef(sk_ref_sp(ref), 0, 0);
+
+  // The overlapping area keeps its content for free (same addresses,
+  // same stride), we just clear the strips exposed by growing.
+  if (width > oldW)
+    bmp.erase(SK_ColorTRANSPARENT, SkIRect::MakeLTRB(oldW, 0, width, height));
+  if (height > oldH)
+    bmp.erase(SK_ColorTRANSPARENT, SkIRect::MakeLTRB(0, oldH, std::min(width, oldW), height));
+
+  swapBitmap(bmp);
+  return true;
+}
+
 void SkiaSurface::destroy()
 {
   if (!m_surface) {
@@ -145,6 +233,192 @@ void SkiaSurface::setImmutable()
     m_bitmap.setImmutable();
 }
 
+SurfaceRef SkiaSurface::shareImmutable()
+{
+  // GPU-backed and empty surfaces cannot share their raster storage
+  if (m_surface || m_bitmap.isNull())
+    return nullptr;
+
+  // The immutable flag lives in the SkPixelRef, so it covers this
+  // surface and every shared copy at once.
+  setImmutable();
+
+  auto sur = make_ref<SkiaSurface>();
+  sur->m_colorSpace = m_colorSpace;
+
+  // Shallow copy: shares the refcounted SkPixelRef, not the pixels
+  SkBitmap shared(m_bitmap);
+  sur->swapBitmap(shared);
+  return sur;
+}
+
+namespace {
+
+// Layout of a shareSnapshot() shared-memory segment: this header
+// followed by height*rowBytes of N32 premultiplied pixels.
+struct SnapshotHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t rowBytes;
+};
+
+const uint32_t kSnapshotMagic = 0x5353464C; // "LFSS"
+const uint32_t kSnapshotVersion = 1;
+
+class SkiaSurfaceSnapshot : public SurfaceSnapshot {
+public:
+  SkiaSurfaceSnapshot(base::shared_memory&& shm,
+                      const int width, const int height)
+    : m_shm(std::move(shm))
+    , m_width(width)
+    , m_height(height) {
+  }
+  const std::string& name() const override { return m_shm.name(); }
+  int width() const override { return m_width; }
+  int height() const override { return m_height; }
+private:
+  base::shared_memory m_shm;
+  int m_width;
+  int m_height;
+};
+
+} // anonymous namespace
+
+SurfaceSnapshotRef SkiaSurface::shareSnapshot()
+{
+  // GPU-backed and empty surfaces don't keep their pixels in CPU
+  // memory
+  if (m_surface || m_bitmap.isNull() || !m_bitmap.getPixels())
+    return nullptr;
+
+  const size_t pixelBytes = m_bitmap.computeByteSize();
+  base::shared_memory shm = base::create_shared_memory(
+    base::make_shared_memory_name("laf-snapshot"),
+    sizeof(SnapshotHeader) + pixelBytes);
+  if (!shm.valid())
+    return nullptr;
+
+  SnapshotHeader header;
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  header.width = uint32_t(m_bitmap.width());
+  header.height = uint32_t(m_bitmap.height());
+  header.rowBytes = uint32_t(m_bitmap.rowBytes());
+  std::memcpy(shm.data(), &header, sizeof(header));
+  std::memcpy(shm.data() + sizeof(header), m_bitmap.getPixels(), pixelBytes);
+
+  return make_ref<SkiaSurfaceSnapshot>(std::move(shm),
+                                       m_bitmap.width(),
+                                       m_bitmap.height());
+}
+
+// static
+SurfaceRef SkiaSurface::importSnapshot(const char* name)
+{
+  auto shm = std::make_unique<base::shared_memory>(
+    base::open_shared_memory(name));
+  if (!shm->valid() || shm->size() < sizeof(SnapshotHeader))
+    return nullptr;
+
+  SnapshotHeader header;
+  std::memcpy(&header, shm->data(), sizeof(header));
+  if (header.magic != kSnapshotMagic ||
+      header.version != kSnapshotVersion ||
+      header.width == 0 || header.height == 0 ||
+      header.rowBytes < header.width*4 ||
+      shm->size() - sizeof(header) < size_t(header.rowBytes)*header.height)
+    return nullptr;
+
+  // The bitmap points straight into the shared mapping (no copy) and
+  // keeps it alive through the release proc. Immutable: the view is
+  // read-only, drawing on it detaches a private copy (ensureMutable()).
+  SkBitmap bm;
+  if (!bm.installPixels(SkImageInfo::MakeN32Premul(header.width, header.height),
+                        (void*)(shm->data() + sizeof(header)),
+                        header.rowBytes,
+                        [](void*, void* context) {
+                          delete (base::shared_memory*)context;
+                        },
+                        shm.get()))
+    return nullptr;
+  shm.release();                // Now owned by the release proc
+  bm.setImmutable();
+
+  auto sur = make_ref<SkiaSurface>();
+  sur->swapBitmap(bm);
+  return sur;
+}
+
+void SkiaSurface::ensureMutable()
+{
+  if (m_surface || m_recording ||
+      m_bitmap.isNull() || !m_bitmap.isImmutable())
+    return;
+
+  // Copy-on-write: the pixels can be shared with other surfaces
+  // (shareImmutable()), so detach a private mutable copy before
+  // modifying them.
+  SkBitmap copy;
+  if (!copy.tryAllocPixels(m_bitmap.info()))
+    throw base::Exception("Cannot create Skia surface");
+  m_bitmap.readPixels(copy.pixmap(), 0, 0);
+  swapBitmap(copy);
+}
+
+void SkiaSurface::readPixelsAsync(const gfx::Rect& rc,
+                                  ReadPixelsCallback callback)
+{
+  ASSERT(callback);
+  const gfx::Rect bounds = (rc & this->bounds());
+  if (bounds.isEmpty()) {
+    callback(nullptr, 0);
+    return;
+  }
+
+  if (m_surface) {
+    // GPU-backed surface: queue the readback behind the pending
+    // draws instead of draining the pipeline with a synchronous
+    // readPixels(). Skia delivers the result when the GPU work is
+    // done and the context is pumped again (flush/submit/
+    // checkAsyncWorkCompletion()), which happens on every present.
+    struct ReadContext {
+      ReadPixelsCallback callback;
+    };
+    auto* ctx = new ReadContext{ std::move(callback) };
+
+    m_surface->asyncRescaleAndReadPixels(
+      SkImageInfo::MakeN32Premul(bounds.w, bounds.h, skColorSpace()),
+      SkIRect::MakeXYWH(bounds.x, bounds.y, bounds.w, bounds.h),
+      SkSurface::RescaleGamma::kSrc,
+      SkSurface::RescaleMode::kNearest,
+      [](SkSurface::ReadPixelsContext context,
+         std::unique_ptr<const SkSurface::AsyncReadResult> result) {
+        std::unique_ptr<ReadContext> ctx(
+          static_cast<ReadContext*>(context));
+        if (result && result->count() > 0) {
+          ctx->callback(static_cast<const uint8_t*>(result->data(0)),
+                        int(result->rowBytes(0)));
+        }
+        else
+          ctx->callback(nullptr, 0);
+      },
+      ctx);
+
+    // Submit the queued commands (without waiting for them) so the
+    // readback completes even if no frame is presented afterwards.
+    flushAndSubmit();
+    return;
+  }
+
+  // Raster surface: the pixels are already on the CPU
+  if (const uint8_t* data = getData(bounds.x, bounds.y))
+    callback(data, int(m_bitmap.rowBytes()));
+  else
+    callback(nullptr, 0);
+}
+
 int SkiaSurface::getSaveCount() const
 {
   return m_canvas->getSaveCount();
@@ -161,6 +435,8 @@ gfx::Rect SkiaSurface::getClipBounds() const
 void SkiaSurface::saveClip()
 {
   m_canvas->save();
+  SURFACE_STAT(m_stats.maxSaveDepth = std::max(
+    m_stats.maxSaveDepth, uint32_t(m_canvas->getSaveCount())));
 }
 
 void SkiaSurface::restoreClip()
@@ -182,6 +458,8 @@ void SkiaSurface::clipPath(const gfx::Path& path)
 void SkiaSurface::save()
 {
   m_canvas->save();
+  SURFACE_STAT(m_stats.maxSaveDepth = std::max(
+    m_stats.maxSaveDepth, uint32_t(m_canvas->getSaveCount())));
 }
 
 void SkiaSurface::concat(const gfx::Matrix& matrix)
@@ -212,6 +490,7 @@ gfx::Matrix SkiaSurface::matrix() const
 void SkiaSurface::lock()
 {
   ASSERT(m_lock >= 0);
+  SURFACE_STAT(++m_stats.locks);
   if (m_lock++ == 0) {
     // TODO add mutex!
     // m_bitmap is always locked
@@ -226,6 +505,38 @@ void SkiaSurface::unlock()
   }
 }
 
+DrawListRef SkiaSurface::record(const gfx::Rect& bounds,
+                                const std::function<void(Surface&)>& draw)
+{
+  SkPictureRecorder recorder;
+  SkCanvas* recordingCanvas =
+    recorder.beginRecording(SkRect::Make(to_skia(bounds)));
+
+  // Redirect every draw call into the recording canvas: nothing
+  // touches the pixels until playback(). Direct pixel access
+  // (putPixel() over a raster surface, getData()) bypasses m_canvas
+  // and is not recorded.
+  SkCanvas* oldCanvas = m_canvas;
+  m_canvas = recordingCanvas;
+  m_recording = true;
+  draw(*this);
+  m_recording = false;
+  m_canvas = oldCanvas;
+
+  return make_ref<SkiaDrawList>(recorder.finishRecordingAsPicture());
+}
+
+void SkiaSurface::playback(const DrawListRef& list)
+{
+  if (!list)
+    return;
+
+  ensureMutable();
+  const auto& picture = static_cast<SkiaDrawList*>(list.get())->picture();
+  m_canvas->drawPicture(picture);
+  damage(picture->cullRect());
+}
+
 void SkiaSurface::applyScale(int scaleFactor)
 {
   ASSERT(!m_surface);
@@ -248,6 +559,108 @@ void SkiaSurface::applyScale(int scaleFactor)
                        &paint, SkCanvas::kStrict_SrcRectConstraint);
 
   swapBitmap(result);
+  addDamage(this->bounds());
+}
+
+// Deep copy: dst gets its own pixel storage with the content of src.
+static bool copy_bitmap(SkBitmap& dst, const SkBitmap& src)
+{
+  if (!dst.tryAllocPixels(src.info()))
+    return false;
+  return src.readPixels(dst.pixmap(), 0, 0);
+}
+
+void SkiaSurface::captureScaleOrigin()
+{
+  if (m_scaledVariants)
+    return;
+
+  // Snapshot the current content as the scale-1 origin. Edits made
+  // to the surface after this point are not reflected in the cache
+  // (skin surfaces are loaded once and then only read).
+  auto variants = std::make_unique<ScaledVariants>();
+  if (!copy_bitmap(variants->origin, m_bitmap))
+    throw base::Exception("Cannot create temporary Skia surface to change scale");
+  variants->origin.setImmutable();
+  m_scaledVariants = std::move(variants);
+}
+
+SkBitmap SkiaSurface::scaledVariant(const int scaleFactor)
+{
+  ASSERT(m_scaledVariants);
+  ScaledVariants& variants = *m_scaledVariants;
+  {
+    const std::lock_guard<std::mutex> lock(variants.mutex);
+    auto it = variants.scaled.find(scaleFactor);
+    if (it != variants.scaled.end())
+      return it->second;        // Shares the cached pixels, cheap
+  }
+
+  // Resample outside the lock so precacheScales() workers can build
+  // different scales at the same time.
+  SkBitmap result;
+  if (!result.tryAllocPixels(
+        variants.origin.info().makeWH(
+          variants.origin.width()*scaleFactor,
+          variants.origin.height()*scaleFactor)))
+    throw base::Exception("Cannot create temporary Skia surface to change scale");
+
+  SkPaint paint;
+  paint.setBlendMode(SkBlendMode::kSrc);
+
+  SkCanvas canvas(result);
+  SkRect srcRect = SkRect::Make(SkIRect::MakeWH(variants.origin.width(),
+                                                variants.origin.height()));
+  SkRect dstRect = SkRect::Make(SkIRect::MakeWH(result.width(), result.height()));
+  canvas.drawImageRect(SkImage::MakeFromRaster(variants.origin.pixmap(), nullptr, nullptr),
+                       srcRect, dstRect, SkSamplingOptions(),
+                       &paint, SkCanvas::kStrict_SrcRectConstraint);
+  result.setImmutable();
+
+  const std::lock_guard<std::mutex> lock(variants.mutex);
+  auto it = variants.scaled.find(scaleFactor);
+  if (it == variants.scaled.end()) // Another worker might have won the race
+    it = variants.scaled.emplace(scaleFactor, std::move(result)).first;
+  return it->second;
+}
+
+void SkiaSurface::applyScaleCached(const int scaleFactor)
+{
+  ASSERT(!m_surface);
+
+  captureScaleOrigin();
+
+  const SkBitmap variant =
+    (scaleFactor == 1 ? m_scaledVariants->origin:
+                        scaledVariant(scaleFactor));
+
+  // The surface keeps its own copy of the pixels so drawing over it
+  // afterwards can't corrupt the cached variant.
+  SkBitmap result;
+  if (!copy_bitmap(result, variant))
+    throw base::Exception("Cannot create temporary Skia surface to change scale");
+
+  swapBitmap(result);
+  addDamage(this->bounds());
+}
+
+void SkiaSurface::precacheScales(const std::vector<int>& scales,
+                                 base::thread_pool& pool)
+{
+  ASSERT(!m_surface);
+
+  captureScaleOrigin();
+
+  std::vector<std::function<void()>> jobs;
+  jobs.reserve(scales.size());
+  for (const int scale : scales) {
+    if (scale > 1)
+      jobs.push_back([this, scale]{ scaledVariant(scale); });
+  }
+  if (jobs.empty())
+    return;
+  pool.execute_batch(std::move(jobs));
+  pool.wait_all();
 }
 
 void* SkiaSurface::nativeHandle()
@@ -257,7 +670,11 @@ void* SkiaSurface::nativeHandle()
 
 void SkiaSurface::clear()
 {
+  ensureMutable();
   m_canvas->clear(0);
+  addDamage(bounds());
+  SURFACE_STAT(++m_stats.clears);
+  SURFACE_STAT(m_stats.pixelsFilled += uint64_t(width()) * height());
 }
 
 uint8_t* SkiaSurface::getData(int x, int y) const
@@ -270,6 +687,7 @@ uint8_t* SkiaSurface::getData(int x, int y) const
 void SkiaSurface::getFormat(SurfaceFormatData* formatData) const
 {
   formatData->format = kRgbaSurfaceFormat;
+  formatData->premultipliedAlpha = (m_bitmap.alphaType() == kPremul_SkAlphaType);
   formatData->bitsPerPixel = 8*m_bitmap.bytesPerPixel();
 
   switch (m_bitmap.colorType()) {
@@ -352,6 +770,7 @@ gfx::Color SkiaSurface::getPixel(int x, int y) const
 
 void SkiaSurface::putPixel(gfx::Color color, int x, int y)
 {
+  ensureMutable();
   if (m_surface) {
     m_paint.setColor(to_skia(color));
     m_canvas->drawPoint(SkIntToScalar(x), SkIntToScalar(y), m_paint);
@@ -374,13 +793,25 @@ void SkiaSurface::putPixel(gfx::Color color, int x, int y)
                    SkIRect::MakeXYWH(x, y, 1, 1));
 #endif
   }
+
+  damage(SkRect::MakeXYWH(SkIntToScalar(x), SkIntToScalar(y), 1, 1));
+  SURFACE_STAT(++m_stats.putPixels);
+  SURFACE_STAT(++m_stats.pixelsFilled);
 }
 
 void SkiaSurface::drawLine(const float x0, const float y0,
                            const float x1, const float y1,
                            const Paint& paint)
 {
+  ensureMutable();
   m_canvas->drawLine(x0, y0, x1, y1, paint.skPaint());
+  damage(SkRect::MakeLTRB(std::min(x0, x1), std::min(y0, y1),
+                          std::max(x0, x1), std::max(y0, y1)),
+         std::max(1.0f, paint.skPaint().getStrokeWidth()));
+  SURFACE_STAT(++m_stats.lines);
+  SURFACE_STAT(m_stats.pixelsFilled += uint64_t(
+    std::max({ 1.0f, std::fabs(x1-x0), std::fabs(y1-y0) }) *
+    std::max(1.0f, paint.skPaint().getStrokeWidth())));
 }
 
 void SkiaSurface::drawRect(const gfx::RectF& rc,
@@ -389,28 +820,73 @@ void SkiaSurface::drawRect(const gfx::RectF& rc,
   if (rc.isEmpty())
     return;
 
+  ensureMutable();
   if (paint.style() == Paint::Style::Stroke)
     m_canvas->drawRect(to_skia_fix(rc), paint.skPaint());
   else
     m_canvas->drawRect(to_skia(rc), paint.skPaint());
+  damage(to_skia(rc), paint.skPaint().getStrokeWidth());
+  SURFACE_STAT(++m_stats.rects);
+  SURFACE_STAT(m_stats.pixelsFilled += uint64_t(rc.w * rc.h));
+}
+
+void SkiaSurface::drawRects(const gfx::RectF* rects, const int n,
+                            const Paint& paint)
+{
+  // All the rectangles go in one path so Skia rasterizes them in a
+  // single draw call (and overlaps don't double-blend).
+  const bool fix = (paint.style() == Paint::Style::Stroke);
+  SkPath path;
+  for (int i=0; i<n; ++i) {
+    if (rects[i].isEmpty())
+      continue;
+    path.addRect(fix ? to_skia_fix(rects[i]):
+                       to_skia(rects[i]));
+    SURFACE_STAT(++m_stats.rects);
+    SURFACE_STAT(m_stats.pixelsFilled +=
+                 uint64_t(rects[i].w * rects[i].h));
+  }
+  if (!path.isEmpty()) {
+    ensureMutable();
+    m_canvas->drawPath(path, paint.skPaint());
+    damage(path.getBounds(), paint.skPaint().getStrokeWidth());
+  }
 }
 
 void SkiaSurface::drawCircle(const float cx, const float cy,
                              const float radius,
                              const Paint& paint)
 {
+  ensureMutable();
   m_canvas->drawCircle(cx, cy, radius, paint.skPaint());
+  damage(SkRect::MakeLTRB(cx-radius, cy-radius, cx+radius, cy+radius),
+         paint.skPaint().getStrokeWidth());
+  SURFACE_STAT(++m_stats.shapes);
+  SURFACE_STAT(m_stats.pixelsFilled += uint64_t(4.0f * radius * radius));
 }
 
 void SkiaSurface::drawPath(const gfx::Path& path,
                            const Paint& paint)
 {
+  ensureMutable();
   m_canvas->drawPath(path.skPath(), paint.skPaint());
+  damage(path.skPath().getBounds(), paint.skPaint().getStrokeWidth());
+  SURFACE_STAT(++m_stats.shapes);
+  SURFACE_STAT(m_stats.pixelsFilled += uint64_t(
+    path.skPath().getBounds().width() *
+    path.skPath().getBounds().height()));
 }
 
 void SkiaSurface::blitTo(Surface* _dst, int srcx, int srcy, int dstx, int dsty, int width, int height) const
 {
+  auto dstSurface = static_cast<SkiaSurface*>(_dst);
+  dstSurface->addDamage(gfx::Rect(dstx, dsty, width, height) & dstSurface->bounds());
+  SURFACE_STAT(++dstSurface->m_stats.blits);
+  SURFACE_STAT(dstSurface->m_stats.pixelsFilled +=
+               uint64_t(width) * height);
+
   auto dst = static_cast<SkiaSurface*>(_dst);
+  dst->ensureMutable();
 
   SkRect srcRect = SkRect::MakeXYWH(srcx, srcy, width, height);
   SkRect dstRect = SkRect::Make(SkIRect::MakeXYWH(dstx, dsty, width, height));
@@ -431,7 +907,7 @@ void SkiaSurface::blitTo(Surface* _dst, int srcx, int srcy, int dstx, int dsty,
 
   if (!m_bitmap.empty()) {
     dst->m_canvas->drawImageRect(
-      SkImage::MakeFromRaster(m_bitmap.pixmap(), nullptr, nullptr),
+      getOrCreateRasterImage(),
       srcRect, dstRect,
       SkSamplingOptions(),
       &paint, SkCanvas::kStrict_SrcRectConstraint);
@@ -448,18 +924,27 @@ void SkiaSurface::blitTo(Surface* _dst, int srcx, int srcy, int dstx, int dsty,
 
 void SkiaSurface::scrollTo(const gfx::Rect& rc, int dx, int dy)
 {
+  if (m_scrollMode == ScrollMode::Translate) {
+    scrollTranslate(rc, dx, dy);
+    return;
+  }
+
   int w = width();
   int h = height();
   gfx::Clip clip(rc.x+dx, rc.y+dy, rc);
   if (!clip.clip(w, h, w, h))
     return;
 
+  addDamage(gfx::Rect(clip.dst.x, clip.dst.y, clip.size.w, clip.size.h));
+
   if (m_surface) {
     SurfaceLock lock(this);
     blitTo(this, clip.src.x, clip.src.y, clip.dst.x, clip.dst.y, clip.size.w, clip.size.h);
     return;
   }
 
+  ensureMutable();
+
   int bytesPerPixel = m_bitmap.bytesPerPixel();
   int rowBytes = (int)m_bitmap.rowBytes();
   int rowDelta;
@@ -488,6 +973,31 @@ void SkiaSurface::scrollTo(const gfx::Rect& rc, int dx, int dy)
   m_bitmap.notifyPixelsChanged();
 }
 
+void SkiaSurface::scrollTranslate(const gfx::Rect& rc, int dx, int dy)
+{
+  const int w = width();
+  const int h = height();
+  if (w == 0 || h == 0)
+    return;
+
+  // Keep the origin wrapped so the present path can split the
+  // content in at most two bands per axis
+  m_scrollOrigin.x = ((m_scrollOrigin.x + dx) % w + w) % w;
+  m_scrollOrigin.y = ((m_scrollOrigin.y + dy) % h + h) % h;
+
+  // Only the strip exposed by the scroll has to be redrawn
+  if (dx > 0)
+    addDamage(gfx::Rect(rc.x, rc.y, std::min(dx, rc.w), rc.h) & bounds());
+  else if (dx < 0)
+    addDamage(gfx::Rect(rc.x2()-std::min(-dx, rc.w), rc.y,
+                        std::min(-dx, rc.w), rc.h) & bounds());
+  if (dy > 0)
+    addDamage(gfx::Rect(rc.x, rc.y, rc.w, std::min(dy, rc.h)) & bounds());
+  else if (dy < 0)
+    addDamage(gfx::Rect(rc.x, rc.y2()-std::min(-dy, rc.h),
+                        rc.w, std::min(-dy, rc.h)) & bounds());
+}
+
 void SkiaSurface::drawSurface(const Surface* src, int dstx, int dsty)
 {
   gfx::Clip clip(dstx, dsty, 0, 0, src->width(), src->height());
@@ -524,6 +1034,28 @@ void SkiaSurface::drawSurface(const Surface* src,
     (paint ? paint->skPaint(): skSrcPaint));
 }
 
+void SkiaSurface::drawSurfaces(const SurfaceBlit* blits, const int n,
+                               const Sampling& sampling,
+                               const os::Paint* paint)
+{
+  // Convert the paint/sampling state once for the whole batch
+  SkPaint skSrcPaint;
+  skSrcPaint.setBlendMode(SkBlendMode::kSrc);
+
+  SkSamplingOptions skSampling;
+  to_skia(sampling, skSampling);
+
+  const SkPaint& skPaint = (paint ? paint->skPaint(): skSrcPaint);
+  for (int i=0; i<n; ++i) {
+    skDrawSurface(
+      blits[i].surface,
+      blits[i].src,
+      blits[i].dst,
+      skSampling,
+      skPaint);
+  }
+}
+
 void SkiaSurface::drawRgbaSurface(const Surface* src, int dstx, int dsty)
 {
   gfx::Clip clip(dstx, dsty, 0, 0, src->width(), src->height());
@@ -560,6 +1092,7 @@ void SkiaSurface::drawColoredRgbaSurface(const Surface* src, gfx::Color fg, gfx:
   SkPaint paint;
   paint.setBlendMode(SkBlendMode::kSrcOver);
 
+  ensureMutable();
   if (gfx::geta(bg) > 0) {
     SkPaint paint;
     paint.setColor(to_skia(bg));
@@ -586,8 +1119,16 @@ void SkiaSurface::drawSurfaceNine(os::Surface* surface,
                                   const bool drawCenter,
                                   const os::Paint* paint)
 {
-  SkIRect srcRect = SkIRect::MakeXYWH(src.x, src.y, src.w, src.h);
+  ensureMutable();
+
+  auto srcSurface = (SkiaSurface*)surface;
+  const NineSliceLattice& ns = srcSurface->nineSliceLattice(src, center, drawCenter);
+
   SkRect dstRect = SkRect::Make(SkIRect::MakeXYWH(dst.x, dst.y, dst.w, dst.h));
+  dstRect.fLeft += ns.dl;
+  dstRect.fTop += ns.dt;
+  dstRect.fRight += ns.dr;
+  dstRect.fBottom += ns.db;
 
   SkPaint skPaint;
   skPaint.setBlendMode(SkBlendMode::kSrcOver);
@@ -598,100 +1139,267 @@ void SkiaSurface::drawSurfaceNine(os::Surface* surface,
     skPaint.setColorFilter(colorFilter);
   }
 
-  int xdivs[2] = { src.x+center.x, src.x+center.x2() };
-  int ydivs[2] = { src.y+center.y, src.y+center.y2() };
-  SkCanvas::Lattice::RectType rectTypes[9] =
-    { SkCanvas::Lattice::kDefault,
-      SkCanvas::Lattice::kDefault,
-      SkCanvas::Lattice::kDefault,
-      SkCanvas::Lattice::kDefault,
-      (drawCenter ? SkCanvas::Lattice::kDefault:
-                    SkCanvas::Lattice::kTransparent),
-      SkCanvas::Lattice::kDefault,
-      SkCanvas::Lattice::kDefault,
-      SkCanvas::Lattice::kDefault,
-      SkCanvas::Lattice::kDefault };
+  SkCanvas::Lattice lattice;
+  lattice.fXDivs = ns.xdivs;
+  lattice.fYDivs = ns.ydivs;
+  lattice.fRectTypes = ns.rectTypes;
+  lattice.fXCount = 2;
+  lattice.fYCount = 2;
+  lattice.fBounds = &ns.srcRect;
+  lattice.fColors = nullptr;
+
+  damage(dstRect);
+  SURFACE_STAT(++m_stats.blits);
+  SURFACE_STAT(m_stats.pixelsFilled +=
+               uint64_t(dstRect.width() * dstRect.height()));
+
+#if SK_SUPPORT_GPU
+  if (auto srcImage = srcSurface->getOrCreateTextureImage()) {
+    m_canvas->drawImageLattice(
+      srcImage, lattice, dstRect,
+      SkFilterMode::kNearest,
+      &skPaint);
+    return;
+  }
+#endif
+
+  m_canvas->drawImageLattice(
+    srcSurface->getOrCreateRasterImage(),
+    lattice, dstRect,
+    SkFilterMode::kNearest,
+    &skPaint);
+}
+
+const SkiaSurface::NineSliceLattice& SkiaSurface::nineSliceLattice(
+  const gfx::Rect& src,
+  const gfx::Rect& center,
+  const bool drawCenter) const
+{
+  for (const NineSliceLattice& l : m_nineSlices) {
+    if (l.src == src &&
+        l.center == center &&
+        l.drawCenter == drawCenter)
+      return l;
+  }
+
+  // Keep the cache small: a skin sheet has a handful of slice
+  // definitions, if we overflow we just recompute
+  if (m_nineSlices.size() >= 8)
+    m_nineSlices.erase(m_nineSlices.begin());
+
+  NineSliceLattice l;
+  l.src = src;
+  l.center = center;
+  l.drawCenter = drawCenter;
+  l.xdivs[0] = src.x+center.x;
+  l.xdivs[1] = src.x+center.x2();
+  l.ydivs[0] = src.y+center.y;
+  l.ydivs[1] = src.y+center.y2();
+  for (int i=0; i<9; ++i)
+    l.rectTypes[i] = SkCanvas::Lattice::kDefault;
+  if (!drawCenter)
+    l.rectTypes[4] = SkCanvas::Lattice::kTransparent;
+  l.srcRect = SkIRect::MakeXYWH(src.x, src.y, src.w, src.h);
+  l.dl = l.dt = l.dr = l.db = 0;
 
   // Without left side
   if (center.x == 0) {
-    srcRect.fLeft -= 1;
-    dstRect.fLeft -= 1;
-    rectTypes[0] =
-      rectTypes[3] =
-      rectTypes[6] = SkCanvas::Lattice::kTransparent;
+    l.srcRect.fLeft -= 1;
+    l.dl = -1;
+    l.rectTypes[0] =
+      l.rectTypes[3] =
+      l.rectTypes[6] = SkCanvas::Lattice::kTransparent;
   }
 
   // Without right side
   if (center.x2() == src.w) {
-    srcRect.fRight += 1;
-    dstRect.fRight += 1;
-    rectTypes[2] =
-      rectTypes[5] =
-      rectTypes[8] = SkCanvas::Lattice::kTransparent;
+    l.srcRect.fRight += 1;
+    l.dr = 1;
+    l.rectTypes[2] =
+      l.rectTypes[5] =
+      l.rectTypes[8] = SkCanvas::Lattice::kTransparent;
   }
 
   // Without top side
   if (center.y == 0) {
-    srcRect.fTop -= 1;
-    dstRect.fTop -= 1;
-    rectTypes[0] =
-      rectTypes[1] =
-      rectTypes[2] = SkCanvas::Lattice::kTransparent;
+    l.srcRect.fTop -= 1;
+    l.dt = -1;
+    l.rectTypes[0] =
+      l.rectTypes[1] =
+      l.rectTypes[2] = SkCanvas::Lattice::kTransparent;
   }
 
   // Without bottom side
   if (center.y2() == src.h) {
-    srcRect.fBottom += 1;
-    srcRect.fBottom += 1;
-    rectTypes[6] =
-      rectTypes[7] =
-      rectTypes[8] = SkCanvas::Lattice::kTransparent;
+    l.srcRect.fBottom += 2;
+    l.rectTypes[6] =
+      l.rectTypes[7] =
+      l.rectTypes[8] = SkCanvas::Lattice::kTransparent;
   }
 
-  SkCanvas::Lattice lattice;
-  lattice.fXDivs = xdivs;
-  lattice.fYDivs = ydivs;
-  lattice.fRectTypes = rectTypes;
-  lattice.fXCount = 2;
-  lattice.fYCount = 2;
-  lattice.fBounds = &srcRect;
-  lattice.fColors = nullptr;
+  m_nineSlices.push_back(l);
+  return m_nineSlices.back();
+}
 
-#if SK_SUPPORT_GPU
-  if (auto srcImage = ((SkiaSurface*)surface)->getOrCreateTextureImage()) {
-    m_canvas->drawImageLattice(
-      srcImage, lattice, dstRect,
-      SkFilterMode::kNearest,
-      &skPaint);
+const SkImage* SkiaSurface::getOrCreateRasterImage() const
+{
+  if (!m_rasterImage)
+    m_rasterImage = SkImage::MakeFromRaster(m_bitmap.pixmap(), nullptr, nullptr);
+  return m_rasterImage.get();
+}
+
+const SkImage* SkiaSurface::getOrCreateMipmapImage() const
+{
+  const std::lock_guard<std::mutex> lock(m_mipmapMutex);
+  const uint32_t genID = m_bitmap.getGenerationID();
+  if (!m_mipmapImage || m_mipmapGenID != genID) {
+    sk_sp<SkImage> baseImage = SkImage::MakeFromRaster(m_bitmap.pixmap(), nullptr, nullptr);
+    if (!baseImage)
+      return nullptr;
+    m_mipmapImage = baseImage->withDefaultMipmaps();
+    m_mipmapGenID = genID;
+  }
+  return m_mipmapImage.get();
+}
+
+void SkiaSurface::precacheMipmaps(base::thread_pool& pool)
+{
+  if (m_surface || m_bitmap.isNull())
+    return;
+
+  // Keep the surface alive while the worker builds the chain.
+  pool.execute([self = base::AddRef(this)]{ self->getOrCreateMipmapImage(); });
+}
+
+void SkiaSurface::drawTiled(const gfx::Rect& rc,
+                            base::thread_pool& pool,
+                            const std::function<void(SkCanvas&, const gfx::Rect&)>& render)
+{
+  const gfx::Rect bounds = (rc & this->bounds());
+  if (bounds.isEmpty())
+    return;
+
+  ensureMutable();
+  addDamage(bounds);
+
+  // Split the destination into tiles
+  std::vector<gfx::Rect> tiles;
+  for (int y=bounds.y; y<bounds.y2(); y+=kRenderTileSize)
+    for (int x=bounds.x; x<bounds.x2(); x+=kRenderTileSize)
+      tiles.push_back(gfx::Rect(x, y, kRenderTileSize, kRenderTileSize) & bounds);
+
+  // A canvas owned by a SkSurface (e.g. GPU-backed) cannot be used
+  // from several threads: render the tiles sequentially with a
+  // per-tile clip instead.
+  if (m_surface || m_bitmap.isNull()) {
+    for (const gfx::Rect& tile : tiles) {
+      m_canvas->save();
+      m_canvas->clipRect(SkRect::Make(to_skia(tile)));
+      render(*m_canvas, tile);
+      m_canvas->restore();
+    }
     return;
   }
-#endif
 
-  m_canvas->drawImageLattice(
-    SkImage::MakeFromRaster(((SkiaSurface*)surface)->m_bitmap.pixmap(), nullptr, nullptr).get(),
-    lattice, dstRect,
-    SkFilterMode::kNearest,
-    &skPaint);
+  // Raster surface: every worker draws through its own SkCanvas over
+  // a disjoint subset of the shared pixels, so no synchronization is
+  // needed beyond the final join.
+  std::vector<std::function<void()>> jobs;
+  jobs.reserve(tiles.size());
+  for (const gfx::Rect& tile : tiles) {
+    jobs.push_back(
+      [this, tile, &render]{
+        SkBitmap tileBitmap;
+        if (!m_bitmap.extractSubset(&tileBitmap, to_skia(tile)))
+          return;
+        SkCanvas tileCanvas(tileBitmap);
+        // Keep the callback in surface coordinates
+        tileCanvas.translate(SkIntToScalar(-tile.x),
+                             SkIntToScalar(-tile.y));
+        render(tileCanvas, tile);
+      });
+  }
+  pool.execute_batch(std::move(jobs));
+  pool.wait_all();
+}
+
+void SkiaSurface::damage(const SkRect& rc, const float outset)
+{
+  if (!trackingDamage())
+    return;
+  SkRect local = rc;
+  if (outset > 0.0f)
+    local.outset(outset, outset);
+  const SkIRect dev = m_canvas->getTotalMatrix().mapRect(local).roundOut();
+  addDamage(gfx::Rect(dev.x(), dev.y(), dev.width(), dev.height()) & bounds());
 }
 
 void SkiaSurface::swapBitmap(SkBitmap& other)
 {
   ASSERT(!m_surface);
   m_bitmap.swap(other);
+  m_rasterImage.reset();
+  {
+    const std::lock_guard<std::mutex> lock(m_mipmapMutex);
+    m_mipmapImage.reset();
+  }
+#if SK_SUPPORT_GPU
+  // Release the VRAM copy now instead of keeping it alive until the
+  // next draw notices the generation change
+  m_image.reset();
+#endif
   delete m_canvas;
   m_canvas = new SkCanvas(m_bitmap);
 }
 
-// static
-Ref<Surface> SkiaSurface::loadSurface(const char* filename)
+bool SkiaSurface::migrateBackingStore(sk_sp<SkSurface> newSurface)
 {
-  FILE* f = base::open_file_raw(filename, "rb");
-  if (!f)
-    return nullptr;
+  if (newSurface) {
+    // To GPU: draw the current content into the new render target.
+    sk_sp<SkImage> snapshot;
+    if (m_surface)
+      snapshot = m_surface->makeImageSnapshot();
+    else if (!m_bitmap.isNull())
+      snapshot = SkImage::MakeFromBitmap(m_bitmap);
+    if (snapshot)
+      newSurface->getCanvas()->drawImage(snapshot, 0, 0);
+
+    if (!m_surface)
+      delete m_canvas;          // The raster canvas is owned by us
+    m_bitmap.reset();
+    m_rasterImage.reset();
+    {
+      const std::lock_guard<std::mutex> lock(m_mipmapMutex);
+      m_mipmapImage.reset();
+    }
+    m_surface = newSurface;
+    m_canvas = m_surface->getCanvas();
+    return true;
+  }
+  else {
+    // To CPU: read the pixels back into a raster bitmap.
+    if (!m_surface)
+      return true;              // Already raster
+
+    SkBitmap bmp;
+    if (!alloc_bitmap(
+          bmp, SkImageInfo::MakeN32Premul(width(), height(), skColorSpace()),
+          0, 0))
+      return false;
+
+    if (!m_surface->readPixels(bmp, 0, 0))
+      return false;
+
+    m_surface.reset();
+    m_canvas = nullptr;         // Was owned by the SkSurface
+    swapBitmap(bmp);
+    return true;
+  }
+}
 
-  std::unique_ptr<SkCodec> codec(
-    SkCodec::MakeFromStream(
-      std::unique_ptr<SkFILEStream>(new SkFILEStream(f))));
+// static
+static SurfaceRef decode_with_codec(std::unique_ptr<SkCodec> codec)
+{
   if (!codec)
     return nullptr;
 
@@ -711,6 +1419,28 @@ Ref<Surface> SkiaSurface::loadSurface(const char* filename)
   return sur;
 }
 
+Ref<Surface> SkiaSurface::loadSurface(const char* filename)
+{
+  FILE* f = base::open_file_raw(filename, "rb");
+  if (!f)
+    return nullptr;
+
+  return decode_with_codec(
+    SkCodec::MakeFromStream(
+      std::unique_ptr<SkFILEStream>(new SkFILEStream(f))));
+}
+
+Ref<Surface> SkiaSurface::decodeSurface(const uint8_t* data, const size_t size)
+{
+  if (!data || size == 0)
+    return nullptr;
+
+  // The SkData doesn't copy the content, the caller keeps it alive
+  // during this call
+  return decode_with_codec(
+    SkCodec::MakeFromData(SkData::MakeWithoutCopy(data, size)));
+}
+
 void SkiaSurface::skDrawSurface(
   const Surface* src,
   const gfx::Clip& clip,
@@ -745,22 +1475,40 @@ void SkiaSurface::skDrawSurface(
   const SkSamplingOptions& sampling,
   const SkPaint& paint)
 {
+  ensureMutable();
+  damage(dstRect);
+  SURFACE_STAT(++m_stats.blits);
+  SURFACE_STAT(m_stats.pixelsFilled +=
+               uint64_t(dstRect.width() * dstRect.height()));
+
 #if SK_SUPPORT_GPU
   src->flush();
-  if (auto srcImage = src->getOrCreateTextureImage()) {
-    m_canvas->drawImageRect(
-      srcImage,
-      srcRect,
-      dstRect,
-      sampling,
-      &paint,
-      SkCanvas::kStrict_SrcRectConstraint);
-    return;
+  // Texture images can only be sampled by GPU-backed destinations (a
+  // raster canvas cannot read them back).
+  if (m_surface) {
+    if (auto srcImage = src->getOrCreateTextureImage()) {
+      m_canvas->drawImageRect(
+        srcImage,
+        srcRect,
+        dstRect,
+        sampling,
+        &paint,
+        SkCanvas::kStrict_SrcRectConstraint);
+      return;
+    }
   }
 #endif
 
+  // Draws that downscale with mipmapping consume the cached chain so
+  // the source is not re-filtered from full resolution every call.
+  const SkImage* srcImage = nullptr;
+  if (sampling.mipmap != SkMipmapMode::kNone)
+    srcImage = src->getOrCreateMipmapImage();
+  if (!srcImage)
+    srcImage = src->getOrCreateRasterImage();
+
   m_canvas->drawImageRect(
-    SkImage::MakeFromRaster(src->m_bitmap.pixmap(), nullptr, nullptr),
+    srcImage,
     srcRect,
     dstRect,
     sampling,
@@ -768,6 +1516,13 @@ void SkiaSurface::skDrawSurface(
     SkCanvas::kStrict_SrcRectConstraint);
 }
 
+void SkiaSurface::precacheTexture()
+{
+#if SK_SUPPORT_GPU
+  getOrCreateTextureImage();
+#endif
+}
+
 #if SK_SUPPORT_GPU
 
 const SkImage* SkiaSurface::getOrCreateTextureImage() const
@@ -777,11 +1532,21 @@ const SkImage* SkiaSurface::getOrCreateTextureImage() const
   if (!win || !win->sk_grCtx())
     return nullptr;
 
-  if (m_image && m_image->isValid(win->sk_grCtx()))
+  // The uploaded texture is reused only while the pixels haven't
+  // changed: the bitmap generation id bumps on every canvas draw, so
+  // static content (toolbars, panels) uploads once and then draws
+  // from VRAM every frame, while a mutated surface re-uploads on its
+  // next draw. As with the mipmap chain, raw writes through
+  // getData() don't bump the id.
+  const uint32_t genID = m_bitmap.getGenerationID();
+  if (m_image && m_textureGenID == genID &&
+      m_image->isValid(win->sk_grCtx()))
     return m_image.get();
   if (uploadBitmapAsTexture() &&
-      m_image && m_image->isValid(win->sk_grCtx()))
+      m_image && m_image->isValid(win->sk_grCtx())) {
+    m_textureGenID = genID;
     return m_image.get();
+  }
   return nullptr;
 }
 
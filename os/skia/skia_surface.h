@@ -17,21 +17,55 @@
 #include "os/skia/skia_color_space.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkSurface.h"
 
 #include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace base {
+  class thread_pool;
+}
 
 namespace os {
 
+// Display list baked by SkiaSurface::record(): a thin wrapper over
+// the recorded SkPicture.
+class SkiaDrawList : public DrawList {
+public:
+  SkiaDrawList(const sk_sp<SkPicture>& picture) : m_picture(picture) { }
+  const sk_sp<SkPicture>& picture() const { return m_picture; }
+private:
+  sk_sp<SkPicture> m_picture;
+};
+
 class SkiaSurface final : public Surface {
 public:
   SkiaSurface();
   SkiaSurface(const sk_sp<SkSurface>& surface);
   ~SkiaSurface();
 
-  void create(int width, int height, const os::ColorSpaceRef& cs);
-  void createRgba(int width, int height, const os::ColorSpaceRef& cs);
+  // The capacity parameters (when greater than width/height) allocate
+  // extra pixel storage so a later tryResize() to a size that still
+  // fits can reconfigure the surface without reallocating it.
+  void create(int width, int height, const os::ColorSpaceRef& cs,
+              int capacityWidth = 0, int capacityHeight = 0);
+  void createRgba(int width, int height, const os::ColorSpaceRef& cs,
+                  int capacityWidth = 0, int capacityHeight = 0);
+
+  // Resizes the surface in-place when the new size fits in the
+  // allocated pixel storage (see the capacity arguments of create()).
+  // The overlapping area keeps its pixels (the stride doesn't change)
+  // and the strips exposed by growing are cleared. Returns false when
+  // a full create() is needed.
+  bool tryResize(int width, int height);
+
   void destroy();
 
   void flush() const;
@@ -43,6 +77,10 @@ public:
   const ColorSpaceRef& colorSpace() const override;
   bool isDirectToScreen() const override;
   void setImmutable() override;
+  SurfaceRef shareImmutable() override;
+  SurfaceSnapshotRef shareSnapshot() override;
+  void readPixelsAsync(const gfx::Rect& rc,
+                       ReadPixelsCallback callback) override;
   int getSaveCount() const override;
   gfx::Rect getClipBounds() const override;
   void saveClip() override;
@@ -57,7 +95,20 @@ public:
   gfx::Matrix matrix() const override;
   void lock() override;
   void unlock() override;
+#ifdef LAF_SURFACE_STATS
+  SurfaceStats stats() const override { return m_stats; }
+  void resetStats() override { m_stats = SurfaceStats(); }
+#endif
+  DrawListRef record(const gfx::Rect& bounds,
+                     const std::function<void(Surface&)>& draw) override;
+  void playback(const DrawListRef& list) override;
+
   void applyScale(int scaleFactor) override;
+  void applyScaleCached(int scaleFactor) override;
+  void precacheScales(const std::vector<int>& scales,
+                      base::thread_pool& pool) override;
+  void precacheMipmaps(base::thread_pool& pool) override;
+  void precacheTexture() override;
 
   void* nativeHandle() override;
 
@@ -75,6 +126,9 @@ public:
   void drawRect(const gfx::RectF& rc,
                 const Paint& paint) override;
 
+  void drawRects(const gfx::RectF* rects, int n,
+                 const Paint& paint) override;
+
   void drawCircle(const float cx, const float cy,
                   const float radius,
                   const Paint& paint) override;
@@ -84,12 +138,39 @@ public:
 
   void blitTo(Surface* _dst, int srcx, int srcy, int dstx, int dsty, int width, int height) const override;
   void scrollTo(const gfx::Rect& rc, int dx, int dy) override;
+
+  // How scrollTo() moves the content.
+  enum class ScrollMode {
+    // Memmoves the pixel rows (default).
+    Copy,
+    // Zero-copy: scrollTo() just shifts a virtual origin and adds
+    // the exposed strip to the damage, leaving the pixels where they
+    // are. Meant to be combined with setTrackDamage(): the present
+    // path reads scrollOrigin() and blits the content as two wrapped
+    // bands, and the app only redraws the damage. On a 4K window
+    // this replaces a ~33MB memmove per scroll step with pure
+    // bookkeeping.
+    Translate,
+  };
+
+  void setScrollMode(const ScrollMode mode) { m_scrollMode = mode; }
+  ScrollMode scrollMode() const { return m_scrollMode; }
+
+  // Accumulated virtual origin (Translate mode), already wrapped to
+  // the surface size: the pixel that Copy mode would show at (0, 0)
+  // lives at this position in the backing store.
+  gfx::Point scrollOrigin() const { return m_scrollOrigin; }
+  void resetScrollOrigin() { m_scrollOrigin = gfx::Point(0, 0); }
+
   void drawSurface(const Surface* src, int dstx, int dsty) override;
   void drawSurface(const Surface* src,
                    const gfx::Rect& srcRect,
                    const gfx::Rect& dstRect,
                    const Sampling& sampling,
                    const os::Paint* paint) override;
+  void drawSurfaces(const SurfaceBlit* blits, int n,
+                    const Sampling& sampling,
+                    const os::Paint* paint) override;
   void drawRgbaSurface(const Surface* src, int dstx, int dsty) override;
   void drawRgbaSurface(const Surface* src, int srcx, int srcy, int dstx, int dsty, int w, int h) override;
   void drawColoredRgbaSurface(const Surface* src, gfx::Color fg, gfx::Color bg, const gfx::Clip& clipbase) override;
@@ -100,6 +181,19 @@ public:
                        const bool drawCenter,
                        const os::Paint* paint) override;
 
+  // Splits rc into tiles and runs render(canvas, tileBounds) for each
+  // one on the given thread pool, joining before returning, so a
+  // full-window effect can use all the cores instead of pegging the
+  // UI thread. Each worker draws through its own SkCanvas over a
+  // disjoint subset of the raster pixels (tileBounds is already
+  // applied as clip, and the canvas uses surface coordinates); the
+  // callback must not touch shared mutable state. On GPU-backed
+  // surfaces the tiles are rendered sequentially with a per-tile
+  // clip instead.
+  void drawTiled(const gfx::Rect& rc,
+                 base::thread_pool& pool,
+                 const std::function<void(SkCanvas&, const gfx::Rect&)>& render);
+
   bool isValid() const {
     return !m_bitmap.isNull();
   }
@@ -112,7 +206,18 @@ public:
 
   void swapBitmap(SkBitmap& other);
 
+  // Replaces the backing store keeping this object alive (so
+  // Window::surface() pointers stay stable) for the live GPU/CPU
+  // switch (System::setGpuAcceleration()): with a SkSurface the
+  // current content is drawn into the new render target, with
+  // nullptr the content is read back into a raster bitmap. Returns
+  // false if the content cannot be transferred (the old backing
+  // store is left untouched).
+  bool migrateBackingStore(sk_sp<SkSurface> newSurface);
+
   static SurfaceRef loadSurface(const char* filename);
+  static SurfaceRef decodeSurface(const uint8_t* data, size_t size);
+  static SurfaceRef importSnapshot(const char* name);
 
 private:
   void skDrawSurface(
@@ -133,6 +238,70 @@ private:
     const SkSamplingOptions& sampling,
     const SkPaint& paint);
 
+  // Copy-on-write detach: if the pixels are immutable (and possibly
+  // shared with other surfaces through shareImmutable()), replaces
+  // them with a private mutable copy. Called at the beginning of
+  // every operation that modifies the pixels.
+  void ensureMutable();
+
+  // Maps rc through the current canvas matrix and accumulates the
+  // result with Surface::addDamage(). outset grows the local-space
+  // bounds first (e.g. to cover a stroke width).
+  void damage(const SkRect& rc, float outset = 0.0f);
+
+  // scrollTo() in ScrollMode::Translate
+  void scrollTranslate(const gfx::Rect& rc, int dx, int dy);
+
+  // Cached slice geometry for drawSurfaceNine(), stored on the
+  // source/skin surface and keyed by the slice definition, so
+  // repeated nine-patch draws from the same sheet skip re-deriving
+  // the lattice. It only depends on geometry, never on the pixels,
+  // so it doesn't need invalidation.
+  struct NineSliceLattice {
+    gfx::Rect src, center;
+    bool drawCenter;
+    int xdivs[2], ydivs[2];
+    SkCanvas::Lattice::RectType rectTypes[9];
+    SkIRect srcRect;
+    int dl, dt, dr, db;         // Per-side adjustment of the dst rect
+  };
+  const NineSliceLattice& nineSliceLattice(const gfx::Rect& src,
+                                           const gfx::Rect& center,
+                                           bool drawCenter) const;
+
+  // Cache for applyScaleCached()/precacheScales(): the content the
+  // surface had on the first call (the scale-1 origin) plus one
+  // pre-scaled copy per visited scale. The bitmaps are deep copies
+  // that don't share storage with m_bitmap, so precacheScales()
+  // workers can build variants while the UI thread reads the surface.
+  struct ScaledVariants {
+    SkBitmap origin;                // Content at scale 1
+    std::map<int, SkBitmap> scaled; // One entry per visited scale (>= 2)
+    std::mutex mutex;               // Guards "scaled"
+  };
+
+  // Captures the origin if this is the first call (see ScaledVariants).
+  void captureScaleOrigin();
+
+  // Returns the cached copy for the given scale, resampling the
+  // origin and caching the result the first time. Thread-safe.
+  SkBitmap scaledVariant(int scaleFactor);
+
+  // Cached zero-copy SkImage wrapper over m_bitmap: it shares the
+  // pixels (so pixel edits are visible through it) and only has to
+  // be rebuilt when the backing storage is replaced (swapBitmap()).
+  const SkImage* getOrCreateRasterImage() const;
+
+  // Cached mipmapped SkImage used by skDrawSurface() when the
+  // sampling asks for a mipmap mode, so thumbnail strips stop
+  // re-downscaling the same full-resolution surface each frame.
+  // Unlike m_rasterImage the chain is a pixel copy, so it's keyed by
+  // the bitmap generation id and rebuilt when the content changed
+  // (raw writes through getData() don't bump the id, only canvas
+  // draws do). Thread-safe: precacheMipmaps() builds it from a
+  // worker. Returns nullptr if the chain cannot be built.
+  const SkImage* getOrCreateMipmapImage() const;
+
 #if SK_SUPPORT_GPU
   const SkImage* getOrCreateTextureImage() const;
   bool uploadBitmapAsTexture() const;
@@ -145,14 +314,34 @@ private:
   }
 
   SkBitmap m_bitmap;
+  mutable sk_sp<SkImage> m_rasterImage;
+  mutable sk_sp<SkImage> m_mipmapImage;
+  mutable uint32_t m_mipmapGenID = 0;
+  mutable std::mutex m_mipmapMutex;
+  mutable std::vector<NineSliceLattice> m_nineSlices;
 #if SK_SUPPORT_GPU
+  // GPU texture copy of m_bitmap, keyed by the bitmap generation id
+  // (see getOrCreateTextureImage())
   mutable sk_sp<SkImage> m_image;
+  mutable uint32_t m_textureGenID = 0;
 #endif
   sk_sp<SkSurface> m_surface;
   ColorSpaceRef m_colorSpace;
   SkCanvas* m_canvas;
   SkPaint m_paint;
   std::atomic<int> m_lock;
+  // record() in progress: m_canvas belongs to the SkPictureRecorder
+  // and nothing touches the pixels, so ensureMutable() must not
+  // replace it.
+  bool m_recording = false;
+  ScrollMode m_scrollMode = ScrollMode::Copy;
+  gfx::Point m_scrollOrigin;
+  std::unique_ptr<ScaledVariants> m_scaledVariants;
+#ifdef LAF_SURFACE_STATS
+  // Draw counters (see Surface::stats()), mutable so const paths
+  // (blitTo()) can account too.
+  mutable SurfaceStats m_stats;
+#endif
 
 };
 
@@ -14,7 +14,10 @@
 #include "os/common/system.h"
 #include "os/skia/skia_color_space.h"
 #include "os/skia/skia_font_manager.h"
+#include "os/skia/skia_shader_cache.h"
 #include "os/skia/skia_surface.h"
+#include "os/skia/skia_tiled_surface.h"
+#include "os/startup.h"
 #include "os/skia/skia_window.h"
 #include "os/window_spec.h"
 
@@ -35,6 +38,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace os {
 
@@ -71,7 +77,14 @@ public:
   }
 
   void setGpuAcceleration(bool state) override {
+    if (m_gpuAcceleration == state)
+      return;
     m_gpuAcceleration = state;
+
+    // Migrate already created windows to the new rendering mode (new
+    // windows just pick up the flag when their surface is created).
+    for (SkiaWindow* window : SkiaWindow::liveWindows())
+      window->onGpuAccelerationChange();
   }
 
   void setTabletAPI(TabletAPI api) override {
@@ -97,7 +110,15 @@ public:
   }
 
   SurfaceRef makeSurface(int width, int height,
-                         const os::ColorSpaceRef& colorSpace) override {
+                         const os::ColorSpaceRef& colorSpace,
+                         const SurfaceFlags flags) override {
+#if SK_SUPPORT_GPU
+    if ((int(flags) & int(SurfaceFlags::TryGpu)) == int(SurfaceFlags::TryGpu) &&
+        m_gpuAcceleration) {
+      if (SurfaceRef sur = makeGpuSurface(width, height, colorSpace))
+        return sur;
+    }
+#endif
     auto sur = make_ref<SkiaSurface>();
     sur->create(width, height, colorSpace);
     return sur;
@@ -114,13 +135,37 @@ public:
     return SkiaSurface::loadSurface(filename);
   }
 
+  SurfaceRef decodeSurface(const uint8_t* data, size_t size) override {
+    return SkiaSurface::decodeSurface(data, size);
+  }
+
   SurfaceRef loadRgbaSurface(const char* filename) override {
     return loadSurface(filename);
   }
 
+  Ref<TiledSurface> loadTiledSurface(const char* filename) override {
+    return SkiaTiledSurface::load(filename);
+  }
+
+  SurfaceRef importSurfaceSnapshot(const char* name) override {
+    return SkiaSurface::importSnapshot(name);
+  }
+
+#if SK_SUPPORT_GPU
+  void setShaderCacheDir(const std::string& dir) override {
+    SkiaShaderCache::instance().setDir(dir);
+  }
+
+  void warmShaderCache(base::thread_pool& pool) override {
+    SkiaShaderCache::instance().warm(pool);
+  }
+#endif
+
   FontManager* fontManager() override {
-    if (!m_fontManager)
+    if (!m_fontManager) {
       m_fontManager.reset(new SkiaFontManager);
+      mark_startup_phase("font-manager");
+    }
     return m_fontManager.get();
   }
 
@@ -139,7 +184,22 @@ public:
   }
 
   os::ColorSpaceRef makeColorSpace(const gfx::ColorSpaceRef& cs) override {
-    return os::make_ref<SkiaColorSpace>(cs);
+    if (!cs)
+      return nullptr;
+
+    // Interning cache: color spaces with equal content share one
+    // canonical os::ColorSpace instance, so the per-blit color space
+    // checks in SkiaSurface compare pointers instead of ICC
+    // payloads.
+    const uint64_t hash = cs->contentHash();
+    const std::lock_guard lock(m_colorSpacesMutex);
+    auto& bucket = m_colorSpaces[hash];
+    for (const os::ColorSpaceRef& other : bucket) {
+      if (other->gfxColorSpace()->nearlyEqual(*cs))
+        return other;
+    }
+    bucket.push_back(os::make_ref<SkiaColorSpace>(cs));
+    return bucket.back();
   }
 
   Ref<ColorSpaceConversion> convertBetweenColorSpace(
@@ -162,10 +222,48 @@ public:
   }
 
 private:
+#if SK_SUPPORT_GPU
+  // Offscreen surface allocated on the GrDirectContext of the default
+  // window, so compositing between GPU surfaces (and blitting them to
+  // the window backbuffer) stays in VRAM instead of going through a
+  // CPU readback. Returns nullptr when there is no GPU-accelerated
+  // window to take the context from.
+  SurfaceRef makeGpuSurface(int width, int height,
+                            const os::ColorSpaceRef& colorSpace) {
+    Window* window = defaultWindow();
+    if (!window || !window->isGpuAccelerated())
+      return nullptr;
+
+    GrDirectContext* grCtx = window->sk_grCtx();
+    if (!grCtx)
+      return nullptr;
+
+    SkImageInfo info = SkImageInfo::Make(
+      width, height,
+      kN32_SkColorType,
+      kPremul_SkAlphaType,
+      (colorSpace ? static_cast<SkiaColorSpace*>(colorSpace.get())->skColorSpace():
+                    nullptr));
+
+    sk_sp<SkSurface> skSurface =
+      SkSurface::MakeRenderTarget(grCtx, SkBudgeted::kYes, info);
+    if (!skSurface)
+      return nullptr;
+
+    return make_ref<SkiaSurface>(skSurface);
+  }
+#endif
+
   SkiaWindow* m_defaultWindow;
   Ref<FontManager> m_fontManager;
   bool m_gpuAcceleration;
   ColorSpaceRef m_windowCS;
+
+  // Canonical color space instances interned by makeColorSpace(),
+  // keyed by content hash (each bucket resolves collisions with
+  // nearlyEqual()).
+  mutable std::mutex m_colorSpacesMutex;
+  std::unordered_map<uint64_t, std::vector<os::ColorSpaceRef>> m_colorSpaces;
 };
 
 } // namespace os
@@ -0,0 +1,195 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/skia/skia_tiled_surface.h"
+
+#include "base/debug.h"
+#include "os/skia/skia_surface.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace os {
+
+namespace {
+
+// Default limit of decoded strip bytes kept alive (enough for a few
+// 4K viewports worth of rows).
+const size_t kDefaultCacheLimit = 64 * 1024 * 1024;
+
+// Target decoded size of one strip. Full-width strips are the unit
+// the scanline decoder supports, so only the row count is tunable.
+const size_t kTargetStripBytes = 1 * 1024 * 1024;
+
+SkImageInfo n32_info(const SkCodec* codec)
+{
+  return codec->getInfo()
+    .makeColorType(kN32_SkColorType)
+    .makeAlphaType(kPremul_SkAlphaType);
+}
+
+} // anonymous namespace
+
+// static
+Ref<TiledSurface> SkiaTiledSurface::load(const char* filename)
+{
+  base::mapped_file file = base::map_file_content(filename);
+  if (file.empty())
+    return nullptr;
+
+  // The SkData doesn't copy the mapped content, m_file keeps it
+  // alive for the whole codec lifetime
+  std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(
+    SkData::MakeWithoutCopy(file.data(), file.size()));
+  if (!codec)
+    return nullptr;
+
+  // Probe the scanline API here so an unsupported codec makes the
+  // caller fall back to the whole-image loadSurface() path. Bottom-up
+  // orders (BMP) would break the forward skip/seek logic below.
+  if (codec->startScanlineDecode(n32_info(codec.get())) != SkCodec::kSuccess ||
+      codec->getScanlineOrder() != SkCodec::kTopDown_SkScanlineOrder)
+    return nullptr;
+
+  return make_ref<SkiaTiledSurface>(std::move(file), std::move(codec));
+}
+
+SkiaTiledSurface::SkiaTiledSurface(base::mapped_file&& file,
+                                   std::unique_ptr<SkCodec> codec)
+  : m_file(std::move(file))
+  , m_codec(std::move(codec))
+  , m_cacheLimit(kDefaultCacheLimit)
+{
+  const SkImageInfo info = m_codec->getInfo();
+  m_width = info.width();
+  m_height = info.height();
+
+  const size_t rowBytes = std::max<size_t>(size_t(m_width) * 4, 1);
+  m_stripRows = int(std::clamp<size_t>(kTargetStripBytes / rowBytes, 16, 1024));
+}
+
+void SkiaTiledSurface::drawInto(Surface* dst,
+                                const gfx::Rect& srcRect,
+                                const gfx::Rect& dstRect,
+                                const os::Sampling& sampling,
+                                const os::Paint* paint)
+{
+  const gfx::Rect src = srcRect & bounds();
+  if (src.isEmpty() || srcRect.isEmpty() || dstRect.isEmpty())
+    return;
+
+  // Scale of the original request, so the clipped src maps to the
+  // right portion of dstRect
+  const double sx = double(dstRect.w) / double(srcRect.w);
+  const double sy = double(dstRect.h) / double(srcRect.h);
+
+  const int firstStrip = src.y / m_stripRows;
+  const int lastStrip = (src.y2()-1) / m_stripRows;
+  for (int strip=firstStrip; strip<=lastStrip; ++strip) {
+    Surface* sur = stripSurface(strip);
+    if (!sur)
+      continue;
+
+    const int stripY = strip*m_stripRows;
+    const int top = std::max(src.y, stripY);
+    const int bottom = std::min(src.y2(), stripY + sur->height());
+    if (bottom <= top)
+      continue;
+
+    // Each destination boundary is rounded once with the same
+    // formula, so two adjacent strips share the exact same edge and
+    // scaling doesn't open seams between them.
+    const int dstX1 = int(std::lround(dstRect.x + (src.x - srcRect.x)*sx));
+    const int dstX2 = int(std::lround(dstRect.x + (src.x2() - srcRect.x)*sx));
+    const int dstY1 = int(std::lround(dstRect.y + (top - srcRect.y)*sy));
+    const int dstY2 = int(std::lround(dstRect.y + (bottom - srcRect.y)*sy));
+    if (dstX2 <= dstX1 || dstY2 <= dstY1)
+      continue;
+
+    dst->drawSurface(sur,
+                     gfx::Rect(src.x, top - stripY, src.w, bottom - top),
+                     gfx::Rect(dstX1, dstY1, dstX2 - dstX1, dstY2 - dstY1),
+                     sampling, paint);
+  }
+}
+
+void SkiaTiledSurface::setCacheLimit(const size_t bytes)
+{
+  m_cacheLimit = bytes;
+  evict();
+}
+
+Surface* SkiaTiledSurface::stripSurface(const int strip)
+{
+  auto it = m_stripIndex.find(strip);
+  if (it != m_stripIndex.end()) {
+    // Move the entry to the most recently used position
+    m_strips.splice(m_strips.begin(), m_strips, it->second);
+    return it->second->surface.get();
+  }
+
+  const int y = strip*m_stripRows;
+  const int rows = std::min(m_stripRows, m_height - y);
+  ASSERT(rows > 0);
+
+  SkBitmap bm;
+  if (!bm.tryAllocPixels(n32_info(m_codec.get()).makeWH(m_width, rows)))
+    return nullptr;
+
+  // The codec streams rows top-down: seeking backwards restarts the
+  // sequential decode, seeking forward just skips rows.
+  if (m_nextScanline > y) {
+    if (m_codec->startScanlineDecode(n32_info(m_codec.get())) != SkCodec::kSuccess)
+      return nullptr;
+    m_nextScanline = 0;
+  }
+  if (m_nextScanline < y) {
+    m_codec->skipScanlines(y - m_nextScanline);
+    m_nextScanline = y;
+  }
+
+  const int decoded = m_codec->getScanlines(bm.getPixels(), rows, bm.rowBytes());
+  m_nextScanline += decoded;
+  if (decoded < rows) {
+    // Truncated/corrupted file: show the missing rows as transparent
+    // instead of uninitialized memory
+    std::memset((uint8_t*)bm.getPixels() + size_t(decoded)*bm.rowBytes(),
+                0, size_t(rows - decoded)*bm.rowBytes());
+  }
+
+  const size_t bytes = bm.computeByteSize();
+  auto sur = make_ref<SkiaSurface>();
+  sur->swapBitmap(bm);
+
+  m_strips.push_front(Strip{ strip, bytes, sur });
+  m_stripIndex[strip] = m_strips.begin();
+  m_cacheBytes += bytes;
+  evict();
+  return sur.get();
+}
+
+void SkiaTiledSurface::evict()
+{
+  // Keep at least the most recently decoded strip so a limit smaller
+  // than one strip still makes progress
+  while (m_cacheBytes > m_cacheLimit && m_strips.size() > 1) {
+    const Strip& back = m_strips.back();
+    m_cacheBytes -= back.bytes;
+    m_stripIndex.erase(back.index);
+    m_strips.pop_back();
+  }
+}
+
+} // namespace os
@@ -0,0 +1,79 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_SKIA_SKIA_TILED_SURFACE_INCLUDED
+#define OS_SKIA_SKIA_TILED_SURFACE_INCLUDED
+#pragma once
+
+#include "base/file_content.h"
+#include "os/surface.h"
+#include "os/tiled_surface.h"
+
+#include "include/codec/SkCodec.h"
+
+#include <list>
+#include <map>
+#include <memory>
+
+namespace os {
+
+// TiledSurface over SkCodec. The compressed file stays mapped with
+// base::map_file_content() and rows are decoded in full-width strips
+// with the scanline API, because the common codecs (PNG, JPEG) only
+// stream rows top-down and cannot seek to an arbitrary tile. Decoded
+// strips live in a byte-bounded LRU cache; panning down just decodes
+// the next strips, panning up restarts the sequential decode.
+class SkiaTiledSurface : public TiledSurface {
+public:
+  // Returns nullptr if the file cannot be opened or the codec
+  // doesn't support top-down scanline decoding.
+  static Ref<TiledSurface> load(const char* filename);
+
+  SkiaTiledSurface(base::mapped_file&& file,
+                   std::unique_ptr<SkCodec> codec);
+
+  int width() const override { return m_width; }
+  int height() const override { return m_height; }
+
+  void drawInto(Surface* dst,
+                const gfx::Rect& srcRect,
+                const gfx::Rect& dstRect,
+                const os::Sampling& sampling,
+                const os::Paint* paint) override;
+
+  size_t cacheBytes() const override { return m_cacheBytes; }
+  size_t cacheLimit() const override { return m_cacheLimit; }
+  void setCacheLimit(size_t bytes) override;
+
+private:
+  // Rows [strip*m_stripRows, strip*m_stripRows+rows) as a decoded
+  // surface, from the cache or decoding them now. Returns nullptr if
+  // the decode fails.
+  Surface* stripSurface(int strip);
+  void evict();
+
+  struct Strip {
+    int index;
+    size_t bytes;               // Decoded size (to account eviction)
+    SurfaceRef surface;
+  };
+  using StripList = std::list<Strip>;
+
+  base::mapped_file m_file;     // Keeps the SkData content alive
+  std::unique_ptr<SkCodec> m_codec;
+  int m_width = 0;
+  int m_height = 0;
+  int m_stripRows = 0;          // Rows per strip
+  int m_nextScanline = 0;       // Next row the sequential decoder emits
+  size_t m_cacheBytes = 0;
+  size_t m_cacheLimit;
+  StripList m_strips;           // Most recently used first
+  std::map<int, StripList::iterator> m_stripIndex;
+};
+
+} // namespace os
+
+#endif
@@ -18,17 +18,38 @@
 #include "os/skia/skia_surface.h"
 #include "os/system.h"
 
+#include <algorithm>
+
 namespace os {
 
+// Windows are created/destroyed from the UI thread only (like
+// m_defaultWindow in SkiaSystem), so the list needs no lock.
+static std::vector<SkiaWindow*> g_liveWindows;
+
 SkiaWindow::SkiaWindow(const WindowSpec& spec)
   : SkiaWindowPlatform(spec)
   , m_nativeCursor(NativeCursor::Arrow)
 {
+  g_liveWindows.push_back(this);
   setScale(spec.scale());
   setCursor(m_nativeCursor);
   initializeSurface();
 }
 
+SkiaWindow::~SkiaWindow()
+{
+  auto it = std::find(g_liveWindows.begin(), g_liveWindows.end(), this);
+  ASSERT(it != g_liveWindows.end());
+  if (it != g_liveWindows.end())
+    g_liveWindows.erase(it);
+}
+
+// static
+const std::vector<SkiaWindow*>& SkiaWindow::liveWindows()
+{
+  return g_liveWindows;
+}
+
 int SkiaWindow::width() const
 {
   return clientSize().w;
@@ -29,6 +29,8 @@
 #include "os/native_cursor.h"
 #include "os/skia/skia_color_space.h"
 
+#include <vector>
+
 namespace os {
 
 class SkiaSurface;
@@ -37,6 +39,12 @@ class WindowSpec;
 class SkiaWindow : public SkiaWindowPlatform {
 public:
   SkiaWindow(const WindowSpec& spec);
+  ~SkiaWindow();
+
+  // All windows currently alive, in creation order. Used by
+  // SkiaSystem to apply system-wide switches (like the GPU
+  // acceleration flag) to every window, not just the default one.
+  static const std::vector<SkiaWindow*>& liveWindows();
 
   // Returns the real and current window's size (without scale applied).
   int width() const override;
@@ -8,16 +8,23 @@
 #define OS_SKIA_SKIA_WINDOW_BASE_INCLUDED
 #pragma once
 
+#include "base/chrono.h"
+#include "gfx/region.h"
 #include "os/event.h"
 #include "os/event_queue.h"
 #include "os/gl/gl_context.h"
+#include "os/mtl/mtl_context.h"
 #include "os/skia/skia_gl.h"
+#include "os/skia/skia_mtl.h"
 #include "os/skia/skia_surface.h"
+#include "os/startup.h"
 #include "os/system.h"
 #include "os/window.h"
 
 #include "include/core/SkCanvas.h"
 
+#include <algorithm>
+
 #if SK_SUPPORT_GPU
   #if LAF_WINDOWS
     #include <windows.h>
@@ -76,28 +83,65 @@ public:
       return;
     }
 
-    m_backend = Backend::NONE;
-    m_surface.reset();
-
+    // Fast path for live resizing: raster surfaces are allocated in
+    // kResizeChunk steps, so most resize ticks just reconfigure the
+    // surface to a sub-rect of the already allocated pixels (keeping
+    // the overlapping content) instead of allocating+clearing
+    // megabytes per mouse movement.
+    if (m_backend == Backend::NONE &&
 #if SK_SUPPORT_GPU
-    // Re-create OpenGL context
-    m_gl.detachGL();
-    if (m_glCtx->isValid())
-      m_glCtx->destroyGLContext();
+        !os::instance()->gpuAcceleration() &&
+#endif
+        m_surface &&
+        m_surface->tryResize(newSize.w, newSize.h)) {
+      return;
+    }
 
-    // GPU-accelerated surface
-    if (os::instance()->gpuAcceleration()) {
-      m_glCtx->createGLContext();
+    m_backend = Backend::NONE;
 
-      if (m_glCtx->isValid()) {
-        m_glCtx->makeCurrent();
+    // Keep the old surface alive to preserve its content in the new one.
+    Ref<SkiaSurface> oldSurface = m_surface;
+    m_surface.reset();
 
-        if (m_gl.attachGL() &&
-            m_gl.createRenderTarget(
+#if SK_SUPPORT_GPU
+  #if LAF_MACOS
+    if (m_mtlCtx) {
+      // Unlike GL, the Metal device/queue survive resizes: we just
+      // resize the layer and re-create the offscreen render target.
+      if (os::instance()->gpuAcceleration() &&
+          (m_mtlCtx->isValid() || m_mtlCtx->createContext()) &&
+          m_mtl.attachMtl(m_mtlCtx.get())) {
+        m_mtlCtx->setDrawableSize(size);
+        if (m_mtl.createRenderTarget(
               size, this->scale(),
               ((SkiaColorSpace*)colorSpace().get())->skColorSpace())) {
-          m_surface = make_ref<SkiaSurface>(m_gl.surface());
-          m_backend = Backend::GL;
+          m_surface = make_ref<SkiaSurface>(m_mtl.surface());
+          m_backend = Backend::METAL;
+        }
+      }
+    }
+    else
+  #endif
+    {
+      // Re-create OpenGL context
+      m_gl.detachGL();
+      if (m_glCtx->isValid())
+        m_glCtx->destroyGLContext();
+
+      // GPU-accelerated surface
+      if (os::instance()->gpuAcceleration()) {
+        m_glCtx->createGLContext();
+
+        if (m_glCtx->isValid()) {
+          m_glCtx->makeCurrent();
+
+          if (m_gl.attachGL() &&
+              m_gl.createRenderTarget(
+                size, this->scale(),
+                ((SkiaColorSpace*)colorSpace().get())->skColorSpace())) {
+            m_surface = make_ref<SkiaSurface>(m_gl.surface());
+            m_backend = Backend::GL;
+          }
         }
       }
     }
@@ -107,11 +151,106 @@ public:
     if (!m_surface) {
       m_surface = make_ref<SkiaSurface>();
 
+      // Round the allocation up to the next kResizeChunk step so the
+      // next grow is handled in-place by tryResize() above.
+      const int capW = (newSize.w + kResizeChunk-1) / kResizeChunk * kResizeChunk;
+      const int capH = (newSize.h + kResizeChunk-1) / kResizeChunk * kResizeChunk;
+
       if (T::isTransparent())
-        m_surface->createRgba(newSize.w, newSize.h, m_colorSpace);
+        m_surface->createRgba(newSize.w, newSize.h, m_colorSpace, capW, capH);
+      else
+        m_surface->create(newSize.w, newSize.h, m_colorSpace, capW, capH);
+
+      // Blit the overlapping area of the old surface so the window
+      // doesn't flash to the background color until the next redraw.
+      if (oldSurface && oldSurface->isValid()) {
+        oldSurface->blitTo(m_surface.get(), 0, 0, 0, 0,
+                           std::min(oldSurface->width(), newSize.w),
+                           std::min(oldSurface->height(), newSize.h));
+      }
+    }
+  }
+
+  // Live switch between GPU/CPU rendering without recreating the
+  // window (see System::setGpuAcceleration()): rebuilds the backing
+  // target in the new mode and transfers the current frame, keeping
+  // the same SkiaSurface object so Window::surface() pointers stay
+  // valid and there is no window flash.
+  void onGpuAccelerationChange() {
+#if SK_SUPPORT_GPU
+    if (!m_initialized || !m_surface)
+      return;
+
+    const bool gpu = os::instance()->gpuAcceleration();
+    if (gpu == (m_backend != Backend::NONE))
+      return;
+
+    if (gpu) {
+      // CPU -> GPU: create the context/render target (like
+      // resizeSkiaSurface() does) and migrate the raster content
+      // into it.
+      const gfx::Size size = this->clientSize();
+      sk_sp<SkSurface> target;
+      Backend newBackend = Backend::NONE;
+
+  #if LAF_MACOS
+      if (m_mtlCtx) {
+        if ((m_mtlCtx->isValid() || m_mtlCtx->createContext()) &&
+            m_mtl.attachMtl(m_mtlCtx.get())) {
+          m_mtlCtx->setDrawableSize(size);
+          if (m_mtl.createRenderTarget(
+                size, this->scale(),
+                ((SkiaColorSpace*)colorSpace().get())->skColorSpace())) {
+            target = m_mtl.surface();
+            newBackend = Backend::METAL;
+          }
+        }
+      }
+      else
+  #endif
+      {
+        m_glCtx->createGLContext();
+        if (m_glCtx->isValid()) {
+          m_glCtx->makeCurrent();
+          if (m_gl.attachGL() &&
+              m_gl.createRenderTarget(
+                size, this->scale(),
+                ((SkiaColorSpace*)colorSpace().get())->skColorSpace())) {
+            target = m_gl.surface();
+            newBackend = Backend::GL;
+          }
+        }
+      }
+
+      if (target && m_surface->migrateBackingStore(target))
+        m_backend = newBackend;
+    }
+    else {
+      // GPU -> CPU: read the frame back into a raster bitmap (with
+      // the context still alive) and then release the GPU resources.
+  #if LAF_MACOS
+      if (!m_mtlCtx)
+  #endif
+        m_glCtx->makeCurrent();
+
+      if (!m_surface->migrateBackingStore(nullptr))
+        return;
+
+  #if LAF_MACOS
+      if (m_mtlCtx)
+        m_mtl.detachMtl();
       else
-        m_surface->create(newSize.w, newSize.h, m_colorSpace);
+  #endif
+      {
+        m_gl.detachGL();
+        if (m_glCtx->isValid())
+          m_glCtx->destroyGLContext();
+      }
+      m_backend = Backend::NONE;
     }
+
+    this->invalidate();
+#endif // SK_SUPPORT_GPU
   }
 
   // Returns the main surface to draw into this window.
@@ -120,6 +259,40 @@ public:
     return m_surface.get();
   }
 
+  // Zero-copy handoff: a raster surface of the right size is adopted
+  // as the new backing store (the present path reads its pixels
+  // directly) and the previous backing is returned as the render
+  // target for the next frame. GPU windows and mismatched sizes fall
+  // back to the generic blit.
+  SurfaceRef present(const SurfaceRef& surface) override {
+    if (m_backend == Backend::NONE &&
+        m_surface &&
+        surface &&
+        surface.get() != m_surface.get() &&
+        surface->width() == m_surface->width() &&
+        surface->height() == m_surface->height()) {
+      Ref<SkiaSurface> previous = m_surface;
+      m_surface = base::AddRef(static_cast<SkiaSurface*>(surface.get()));
+      this->invalidate();
+      return previous;
+    }
+    return Window::present(surface);
+  }
+
+  // Invalidates just the part of the backing surface that changed
+  // since the last call (requires surface()->setTrackDamage(true)),
+  // so idle repaints like a cursor blink present only the damaged
+  // rects instead of re-uploading the whole frame.
+  void invalidateDamage() {
+    if (m_surface && m_surface->trackingDamage()) {
+      const gfx::Region damage = m_surface->takeDamage();
+      if (!damage.isEmpty())
+        this->invalidateRegion(damage);
+    }
+    else
+      this->invalidate();
+  }
+
   // Overrides the colorSpace() method to return the cached/stored
   // color space in this instance (instead of asking for the color
   // space to the screen as T::colorSpace() should do).
@@ -146,7 +319,14 @@ public:
   }
 
   void swapBuffers() override {
+    mark_startup_phase("first-paint");
 #if SK_SUPPORT_GPU
+  #if LAF_MACOS
+    if (m_backend == Backend::METAL) {
+      swapBuffersMtl();
+      return;
+    }
+  #endif
     if (m_backend == Backend::NONE ||
         !m_gl.backbufferSurface() ||
         !m_glCtx->isValid())
@@ -157,6 +337,7 @@ public:
       return;
 
     m_glCtx->makeCurrent();
+    m_gl.beginFrameTiming();
 
     // Draw the small (unscaled) surface to the backbuffer surface
     // scaling it to the this->scale() factor.
@@ -174,14 +355,35 @@ public:
       dstCanvas->restore();
     }
 
+    // The timer query measures the GPU cost of the frame's commands;
+    // the Chrono measures how long the CPU stalls in flush+swap.
+    base::Chrono syncChrono;
     surface->flushAndSubmit();
+
+    // Deliver the results of finished Surface::readPixelsAsync()
+    // readbacks (polls the fences, doesn't wait).
+    if (GrDirectContext* grCtx = m_gl.grCtx())
+      grCtx->checkAsyncWorkCompletion();
+
+    m_gl.endFrameTiming();
     m_glCtx->swapBuffers();
+    m_gl.recordSyncStall(1000.0 * syncChrono.elapsed());
 #endif // SK_SUPPORT_GPU
   }
 
+  Window::GpuFrameTiming gpuFrameTiming() const override {
+    Window::GpuFrameTiming timing;
+#if SK_SUPPORT_GPU
+    const SkiaGL::FrameTiming t = m_gl.frameTiming();
+    timing.gpuMsecs = t.gpuMsecs;
+    timing.syncMsecs = t.syncMsecs;
+#endif
+    return timing;
+  }
+
   bool isGpuAccelerated() const override {
 #if SK_SUPPORT_GPU
-    return (m_backend == Backend::GL);
+    return (m_backend != Backend::NONE);
 #else
     return false;
 #endif
@@ -189,6 +391,10 @@ public:
 
 #if SK_SUPPORT_GPU
   GrDirectContext* sk_grCtx() const override {
+  #if LAF_MACOS
+    if (m_mtl.hasCtx())
+      return m_mtl.grCtx();
+  #endif
     return m_gl.grCtx();
   }
 #endif
@@ -197,6 +403,7 @@ protected:
   void initializeSurface() {
     m_initialized = true;
     resetSkiaSurface();
+    mark_startup_phase("first-window");
   }
 
   void onResize(const gfx::Size& sz) override {
@@ -221,6 +428,9 @@ protected:
     NONE,
 #if SK_SUPPORT_GPU
     GL,
+  #if LAF_MACOS
+    METAL,
+  #endif
 #endif
   };
 
@@ -229,9 +439,61 @@ protected:
 #if SK_SUPPORT_GPU
   std::unique_ptr<GLContext> m_glCtx;
   SkiaGL m_gl;
+  #if LAF_MACOS
+  // Metal presentation path (WindowSpec::GpuBackend), exclusive with
+  // m_glCtx: the platform window creates one or the other.
+  std::unique_ptr<MtlContext> m_mtlCtx;
+  SkiaMtl m_mtl;
+  #endif
 #endif
 
 private:
+#if SK_SUPPORT_GPU && LAF_MACOS
+  void swapBuffersMtl() {
+    if (!m_mtlCtx ||
+        !m_mtlCtx->isValid() ||
+        !m_mtl.surface())
+      return;
+
+    // Measures how long the CPU stalls acquiring the drawable and
+    // submitting the frame (GPU time needs Metal timestamp queries,
+    // not implemented yet, see Window::gpuFrameTiming()).
+    base::Chrono syncChrono;
+
+    void* drawable = nullptr;
+    sk_sp<SkSurface> backbuffer = m_mtl.beginFrame(m_mtlCtx.get(), &drawable);
+    if (!backbuffer)
+      return;
+
+    // Draw the small (unscaled) surface to the drawable scaling it
+    // to the this->scale() factor.
+    SkSamplingOptions sampling;
+    SkPaint paint;
+
+    SkCanvas* dstCanvas = backbuffer->getCanvas();
+    dstCanvas->save();
+    dstCanvas->scale(SkScalar(this->scale()),
+                     SkScalar(this->scale()));
+    m_mtl.surface()->draw(
+      dstCanvas,
+      0.0, 0.0, sampling, &paint);
+    dstCanvas->restore();
+
+    m_mtl.endFrame(m_mtlCtx.get(), drawable);
+
+    // Deliver the results of finished Surface::readPixelsAsync()
+    // readbacks (polls the fences, doesn't wait).
+    if (GrDirectContext* grCtx = m_mtl.grCtx())
+      grCtx->checkAsyncWorkCompletion();
+
+    m_gl.recordSyncStall(1000.0 * syncChrono.elapsed());
+  }
+#endif
+
+  // Allocation granularity of the raster backing surface (see
+  // resizeSkiaSurface()).
+  static constexpr int kResizeChunk = 256;
+
   Backend m_backend = Backend::NONE;
   // Flag used to avoid accessing to an invalid m_surface in the first
   // SkiaWindow::resize() call when the window is created (as the
@@ -28,7 +28,7 @@ public:
 
   void setFullscreen(bool state) override;
 
-  void invalidateRegion(const gfx::Region& rgn) override;
+  void onInvalidateRegion(const gfx::Region& rgn) override;
 
   std::string getLayout() override { return ""; }
   void setLayout(const std::string& layout) override { }
@@ -19,6 +19,7 @@
 #include "os/event.h"
 #include "os/event_queue.h"
 #include "os/gl/gl_context_nsgl.h"
+#include "os/mtl/mtl_context_osx.h"
 #include "os/osx/event_queue.h"
 #include "os/osx/view.h"
 #include "os/skia/skia_color_space.h"
@@ -41,7 +42,12 @@ namespace os {
 SkiaWindowOSX::SkiaWindowOSX(const WindowSpec& spec)
 {
 #if SK_SUPPORT_GPU
-  m_glCtx = std::make_unique<GLContextNSGL>();
+  // Metal is the platform fast path (GpuBackend::Default), NSGL is
+  // kept for GpuBackend::OpenGL.
+  if (spec.gpuBackend() == WindowSpec::GpuBackend::OpenGL)
+    m_glCtx = std::make_unique<GLContextNSGL>();
+  else
+    m_mtlCtx = std::make_unique<MtlContextOSX>();
 #endif
 
   m_closing = false;
@@ -49,8 +55,14 @@ SkiaWindowOSX::SkiaWindowOSX(const WindowSpec& spec)
   initColorSpace();
 
 #if SK_SUPPORT_GPU
-  auto nsgl = (GLContextNSGL*)m_glCtx.get();
-  nsgl->setView([m_nsWindow contentView]);
+  if (m_glCtx) {
+    auto nsgl = (GLContextNSGL*)m_glCtx.get();
+    nsgl->setView([m_nsWindow contentView]);
+  }
+  else {
+    auto mtl = (MtlContextOSX*)m_mtlCtx.get();
+    mtl->setView([m_nsWindow contentView]);
+  }
 #endif
 }
 
@@ -68,7 +80,7 @@ void SkiaWindowOSX::setFullscreen(bool state)
   WindowOSX::setFullscreen(state);
 }
 
-void SkiaWindowOSX::invalidateRegion(const gfx::Region& rgn)
+void SkiaWindowOSX::onInvalidateRegion(const gfx::Region& rgn)
 {
   switch (backend()) {
 
@@ -108,6 +120,10 @@ void SkiaWindowOSX::invalidateRegion(const gfx::Region& rgn)
       m_gl.glInterfaces()->fFunctions.fFlush();
       break;
 
+    case Backend::METAL:
+      // Nothing to do, the frame is presented in swapBuffers().
+      break;
+
 #endif
 
   }
@@ -146,6 +162,10 @@ void SkiaWindowOSX::onDrawRect(const gfx::Rect& rect)
     case Backend::GL:
       m_gl.glInterfaces()->fFunctions.fFlush();
       break;
+
+    case Backend::METAL:
+      // Nothing to do, the frame is presented in swapBuffers().
+      break;
 #endif
   }
 }
@@ -157,6 +177,10 @@ void SkiaWindowOSX::onWindowChanged()
     auto nsgl = (GLContextNSGL*)m_glCtx.get();
     nsgl->setView([m_nsWindow contentView]);
   }
+  else if (m_mtlCtx) {
+    auto mtl = (MtlContextOSX*)m_mtlCtx.get();
+    mtl->setView([m_nsWindow contentView]);
+  }
 #endif
 }
 
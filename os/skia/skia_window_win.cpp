@@ -34,6 +34,8 @@ SkiaWindowWin::SkiaWindowWin(const WindowSpec& spec)
   : SkiaWindowBase<WindowWin>(spec)
 {
 #if SK_SUPPORT_GPU
+  // TODO Support WindowSpec::GpuBackend::Angle (Direct3D 11 through
+  //      ANGLE's EGL), right now every backend falls back to WGL.
   m_glCtx = std::make_unique<GLContextWGL>((HWND)nativeHandle());
 #endif
   initColorSpace();
@@ -55,10 +57,10 @@ void SkiaWindowWin::onPaint(HDC hdc)
   }
 }
 
-void SkiaWindowWin::invalidateRegion(const gfx::Region& rgn)
+void SkiaWindowWin::onInvalidateRegion(const gfx::Region& rgn)
 {
   if (!isTransparent())
-    return WindowWin::invalidateRegion(rgn);
+    return WindowWin::onInvalidateRegion(rgn);
 
   // Special logic for transparent (WS_EX_LAYERED) windows: we call
   // UpdateLayeredWindowIndirect() because we want to present the RGBA
@@ -80,7 +82,11 @@ void SkiaWindowWin::invalidateRegion(const gfx::Region& rgn)
   HWND hwnd = (HWND)nativeHandle();
   HDC hdc = GetDC(nullptr);
   HBITMAP hbmpScaled = CreateCompatibleBitmap(hdc, sw, sh);
-  HBITMAP hbmp = CreateBitmap(w, h, 1, 32, (void*)bitmap.getPixels());
+  // Create the GDI bitmap as wide as the row stride (which can be
+  // larger than the bitmap width for chunk-allocated surfaces), the
+  // AlphaBlend() below reads just the w x h area anyway.
+  HBITMAP hbmp = CreateBitmap(int(bitmap.rowBytes()/bitmap.bytesPerPixel()),
+                              h, 1, 32, (void*)bitmap.getPixels());
   HDC srcHdcScaled = CreateCompatibleDC(hdc);
   HDC srcHdc = CreateCompatibleDC(hdc);
   SelectObject(srcHdcScaled, hbmpScaled);
@@ -148,21 +154,46 @@ void SkiaWindowWin::paintHDC(HDC hdc)
 
   const SkBitmap& bitmap = surface->bitmap();
 
+  // The DIB width is the row stride in pixels, which can be larger
+  // than the bitmap width when the bitmap is a view over a
+  // chunk-allocated surface (see SkiaSurface::tryResize()).
+  ASSERT(bitmap.rowBytes() % bitmap.bytesPerPixel() == 0);
+  const int stride = int(bitmap.rowBytes() / bitmap.bytesPerPixel());
+
   BITMAPINFO bmi;
   memset(&bmi, 0, sizeof(bmi));
   bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-  bmi.bmiHeader.biWidth = bitmap.width();
+  bmi.bmiHeader.biWidth = stride;
   bmi.bmiHeader.biHeight = -bitmap.height();
   bmi.bmiHeader.biPlanes = 1;
   bmi.bmiHeader.biBitCount = 32;
   bmi.bmiHeader.biCompression = BI_RGB;
   bmi.bmiHeader.biSizeImage = 0;
 
-  ASSERT(bitmap.width() * bitmap.bytesPerPixel() == bitmap.rowBytes());
+  // Blit only the damaged bound: BeginPaint() clips the HDC to the
+  // invalid region (built rect by rect in invalidateRegion()), so the
+  // clip box tells us which part of the frame actually has to reach
+  // the screen (e.g. a blinking cursor doesn't re-upload a whole 4K
+  // frame).
+  RECT clip;
+  if (GetClipBox(hdc, &clip) == NULLREGION)
+    return;
+
+  const int s = scale();
+  gfx::Rect src(clip.left / s,
+                clip.top / s,
+                0, 0);
+  src.w = (clip.right + s-1) / s - src.x;
+  src.h = (clip.bottom + s-1) / s - src.y;
+  src &= gfx::Rect(0, 0, bitmap.width(), bitmap.height());
+  if (src.isEmpty())
+    return;
 
   int ret = StretchDIBits(hdc,
-    0, 0, bitmap.width()*scale(), bitmap.height()*scale(),
-    0, 0, bitmap.width(), bitmap.height(),
+    src.x*s, src.y*s, src.w*s, src.h*s,
+    // Even for top-down DIBs (negative biHeight) the origin of the
+    // source rect is measured from the bottom-left corner.
+    src.x, bitmap.height() - src.y - src.h, src.w, src.h,
     bitmap.getPixels(),
     &bmi, DIB_RGB_COLORS, SRCCOPY);
   (void)ret;
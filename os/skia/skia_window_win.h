@@ -24,7 +24,7 @@ class SkiaWindowWin : public SkiaWindowBase<WindowWin> {
 public:
   SkiaWindowWin(const WindowSpec& spec);
 
-  void invalidateRegion(const gfx::Region& rgn) override;
+  void onInvalidateRegion(const gfx::Region& rgn) override;
 
 private:
   void onPaint(HDC hdc) override;
@@ -22,8 +22,96 @@
 
 #include "include/core/SkBitmap.h"
 
+#include <X11/extensions/XShm.h>
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <cstring>
+
 namespace os {
 
+// One XImage whose pixels live in a SysV shared-memory segment
+// attached by both us and the X server, so XShmPutImage() just tells
+// the server to read the segment instead of copying the whole buffer
+// through the socket.
+class SkiaWindowX11::ShmImage {
+public:
+  static std::unique_ptr<ShmImage> create(::Display* display,
+                                          const int width,
+                                          const int height) {
+    std::unique_ptr<ShmImage> shm(new ShmImage);
+    shm->m_display = display;
+
+    const int screen = DefaultScreen(display);
+    shm->m_image = XShmCreateImage(display,
+                                   DefaultVisual(display, screen),
+                                   DefaultDepth(display, screen),
+                                   ZPixmap, nullptr,
+                                   &shm->m_info, width, height);
+    if (!shm->m_image)
+      return nullptr;
+
+    shm->m_info.shmid = shmget(IPC_PRIVATE,
+                               shm->m_image->bytes_per_line * height,
+                               IPC_CREAT | 0600);
+    if (shm->m_info.shmid < 0)
+      return nullptr;
+
+    shm->m_info.shmaddr = shm->m_image->data =
+      (char*)shmat(shm->m_info.shmid, nullptr, 0);
+    if (shm->m_info.shmaddr == (char*)-1) {
+      shm->m_info.shmaddr = nullptr;
+      shmctl(shm->m_info.shmid, IPC_RMID, nullptr);
+      return nullptr;
+    }
+
+    shm->m_info.readOnly = True;
+    if (!XShmAttach(display, &shm->m_info)) {
+      // The destructor will shmdt(), the RMID makes the kernel
+      // reclaim the segment on that last detach.
+      shmctl(shm->m_info.shmid, IPC_RMID, nullptr);
+      return nullptr;
+    }
+    shm->m_attached = true;
+
+    // Mark the segment for deletion now so the kernel reclaims it as
+    // soon as both sides detach (even if we crash).
+    shmctl(shm->m_info.shmid, IPC_RMID, nullptr);
+    return shm;
+  }
+
+  ~ShmImage() {
+    if (m_attached)
+      XShmDetach(m_display, &m_info);
+    if (m_image)
+      XDestroyImage(m_image); // Doesn't free the data of SHM images
+    if (m_info.shmaddr)
+      shmdt(m_info.shmaddr);
+  }
+
+  int width() const { return m_image->width; }
+  int height() const { return m_image->height; }
+  int bytesPerLine() const { return m_image->bytes_per_line; }
+  char* data() { return m_image->data; }
+
+  void put(::Window window, ::GC gc, const gfx::Rect& rc) {
+    XShmPutImage(m_display, window, gc, m_image,
+                 rc.x, rc.y, rc.x, rc.y, rc.w, rc.h, False);
+    // Wait until the server read the segment, we are going to write
+    // it again on the next paint.
+    XSync(m_display, False);
+  }
+
+private:
+  ShmImage() { memset(&m_info, 0, sizeof(m_info)); }
+
+  ::Display* m_display = nullptr;
+  XImage* m_image = nullptr;
+  XShmSegmentInfo m_info;
+  bool m_attached = false;
+};
+
 namespace {
 
 bool convert_skia_bitmap_to_ximage(const SkBitmap& bitmap, XImage& image)
@@ -39,7 +127,10 @@ bool convert_skia_bitmap_to_ximage(const SkBitmap& bitmap, XImage& image)
   image.bitmap_bit_order = LSBFirst;
   image.bitmap_pad = bpp;
   image.depth = (bitmap.alphaType() == kPremul_SkAlphaType ? 32: 24);
-  image.bytes_per_line = bitmap.rowBytes() - 4*bitmap.width();
+  // Full row stride, which can be larger than 4*width when the
+  // bitmap is a view over a chunk-allocated surface (see
+  // SkiaSurface::tryResize()).
+  image.bytes_per_line = bitmap.rowBytes();
   image.bits_per_pixel = bpp;
 
   return (XInitImage(&image) ? true: false);
@@ -56,6 +147,28 @@ SkiaWindowX11::SkiaWindowX11(const WindowSpec& spec)
   initColorSpace();
 }
 
+SkiaWindowX11::~SkiaWindowX11()
+{
+}
+
+SkiaWindowX11::ShmImage* SkiaWindowX11::shmImage()
+{
+  const gfx::Size size = this->clientSize();
+  if (m_shm &&
+      (m_shm->width() != size.w ||
+       m_shm->height() != size.h)) {
+    m_shm.reset();
+    m_shmTried = false;
+  }
+
+  if (!m_shm && !m_shmTried) {
+    m_shmTried = true;
+    if (XShmQueryExtension(x11display()))
+      m_shm = ShmImage::create(x11display(), size.w, size.h);
+  }
+  return m_shm.get();
+}
+
 void SkiaWindowX11::onPaint(const gfx::Rect& rc)
 {
 #if SK_SUPPORT_GPU
@@ -67,6 +180,48 @@ void SkiaWindowX11::onPaint(const gfx::Rect& rc)
   const SkBitmap& bitmap = surface->bitmap();
 
   int scale = this->scale();
+
+  // Present through the MIT-SHM image when available.
+  if (ShmImage* shm = shmImage()) {
+    if (scale == 1) {
+      // Copy just the painted rows into the shared segment.
+      const char* src = (const char*)bitmap.getPixels()
+        + rc.y*bitmap.rowBytes() + rc.x*bitmap.bytesPerPixel();
+      char* dst = shm->data()
+        + rc.y*shm->bytesPerLine() + rc.x*bitmap.bytesPerPixel();
+      for (int v=0; v<rc.h; ++v) {
+        std::memcpy(dst, src, rc.w*bitmap.bytesPerPixel());
+        src += bitmap.rowBytes();
+        dst += shm->bytesPerLine();
+      }
+      shm->put(x11window(), gc(), rc);
+      return;
+    }
+    else {
+      // Scale the painted rect directly into the shared segment,
+      // without the intermediate m_buffer of the XPutImage path.
+      SkBitmap shmBitmap;
+      if (shmBitmap.installPixels(
+            SkImageInfo::Make(shm->width(), shm->height(),
+                              bitmap.info().colorType(),
+                              bitmap.info().alphaType()),
+            shm->data(), shm->bytesPerLine())) {
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+
+        SkCanvas canvas(shmBitmap);
+        SkRect srcRect = SkRect::Make(SkIRect::MakeXYWH(rc.x/scale, rc.y/scale, rc.w/scale, rc.h/scale));
+        SkRect dstRect = SkRect::Make(SkIRect::MakeXYWH(rc.x, rc.y, rc.w, rc.h));
+        canvas.drawImageRect(SkImage::MakeFromRaster(bitmap.pixmap(), nullptr, nullptr),
+                             srcRect, dstRect, SkSamplingOptions(),
+                             &paint, SkCanvas::kStrict_SrcRectConstraint);
+
+        shm->put(x11window(), gc(), rc);
+        return;
+      }
+    }
+  }
+
   if (scale == 1) {
     XImage image;
     if (convert_skia_bitmap_to_ximage(bitmap, image)) {
@@ -16,6 +16,7 @@
 #include "os/skia/skia_window_base.h"
 #include "os/x11/window.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -24,6 +25,7 @@ namespace os {
 class SkiaWindowX11 : public SkiaWindowBase<WindowX11> {
 public:
   SkiaWindowX11(const WindowSpec& spec);
+  ~SkiaWindowX11();
 
   std::string getLayout() override { return ""; }
   void setLayout(const std::string& layout) override { }
@@ -31,6 +33,15 @@ public:
 private:
   void onPaint(const gfx::Rect& rc) override;
 
+  // MIT-SHM image shared with the X server to present raster frames
+  // without pushing the pixels through the X socket on each paint
+  // (nullptr when the extension is not available, in which case we
+  // fall back to XPutImage()).
+  class ShmImage;
+  ShmImage* shmImage();
+
+  std::unique_ptr<ShmImage> m_shm;
+  bool m_shmTried = false;
   std::vector<uint8_t> m_buffer;
 
   DISABLE_COPYING(SkiaWindowX11);
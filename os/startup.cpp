@@ -0,0 +1,75 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/startup.h"
+
+#include "base/time.h"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace os {
+
+namespace {
+
+struct Mark {
+  const char* name;
+  uint64_t time;                // base::now_ns()
+};
+
+std::mutex g_mutex;
+std::vector<Mark> g_marks;
+
+} // anonymous namespace
+
+void mark_startup_phase(const char* name)
+{
+  const uint64_t now = base::now_ns();
+
+  const std::lock_guard<std::mutex> lock(g_mutex);
+  for (const Mark& mark : g_marks) {
+    if (std::strcmp(mark.name, name) == 0)
+      return;                   // Already marked, keep the first time
+  }
+  g_marks.push_back(Mark{ name, now });
+}
+
+std::vector<StartupPhase> startup_phases()
+{
+  const std::lock_guard<std::mutex> lock(g_mutex);
+
+  std::vector<StartupPhase> phases;
+  phases.reserve(g_marks.size());
+  for (const Mark& mark : g_marks) {
+    StartupPhase phase;
+    phase.name = mark.name;
+    phase.msecsFromStart = double(mark.time - g_marks.front().time) / 1.0e6;
+    phase.msecsFromPrev =
+      (phases.empty() ? 0.0:
+                        phase.msecsFromStart - phases.back().msecsFromStart);
+    phases.push_back(phase);
+  }
+  return phases;
+}
+
+std::string startup_report()
+{
+  std::string report;
+  char line[256];
+  for (const StartupPhase& phase : startup_phases()) {
+    std::snprintf(line, sizeof(line), "%10.1f ms (+%.1f ms) %s\n",
+                  phase.msecsFromStart, phase.msecsFromPrev, phase.name);
+    report += line;
+  }
+  return report;
+}
+
+} // namespace os
@@ -0,0 +1,43 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_STARTUP_H_INCLUDED
+#define OS_STARTUP_H_INCLUDED
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace os {
+
+  // Timeline of the startup phases up to the first painted window,
+  // to attribute slow time-to-first-window reports (Skia init? font
+  // enumeration? window creation?). laf marks its own phases ("main",
+  // "platform-init", "system-created", "font-manager",
+  // "first-window", "first-paint") and the app can add its own.
+  //
+  // A phase is recorded only the first time its name is marked, so
+  // call sites on repeating paths (e.g. every swapBuffers()) don't
+  // need their own first-time guard. The name must be a string
+  // literal (only the pointer is stored).
+  void mark_startup_phase(const char* name);
+
+  struct StartupPhase {
+    const char* name;
+    double msecsFromStart;      // Since the first recorded mark
+    double msecsFromPrev;       // Since the previous mark
+  };
+
+  // Phases recorded so far, in the order they were marked.
+  std::vector<StartupPhase> startup_phases();
+
+  // Multi-line human-readable version of startup_phases(), ready to
+  // log or attach to a perf report.
+  std::string startup_report();
+
+} // namespace os
+
+#endif
@@ -14,13 +14,20 @@
 #include "gfx/color.h"
 #include "gfx/point.h"
 #include "gfx/rect.h"
+#include "gfx/region.h"
 #include "os/color_space.h"
 #include "os/paint.h"
 #include "os/ref.h"
 #include "os/sampling.h"
 #include "os/surface_format.h"
 
+#include <functional>
 #include <string>
+#include <vector>
+
+namespace base {
+  class thread_pool;
+}
 
 namespace gfx {
   class Matrix;
@@ -35,6 +42,80 @@ namespace os {
   class SurfaceLock;
   using SurfaceRef = Ref<Surface>;
 
+  class DrawList;
+  using DrawListRef = Ref<DrawList>;
+
+  // Opaque display list baked by Surface::record(): a reusable
+  // sequence of draw commands that can be replayed over a surface
+  // with one Surface::playback() call.
+  class DrawList : public RefCount {
+  public:
+    virtual ~DrawList() { }
+  };
+
+  // POD view over the pixels of a surface: everything a software
+  // blit loop needs (base address, stride, and pixel format) resolved
+  // once up-front, so the inner loops don't pay a virtual call per
+  // row. The view is valid only while the surface is locked
+  // (SurfaceLock) and until it's resized or destroyed.
+  struct SurfacePixels {
+    uint8_t* base = nullptr;    // Address of the top-left pixel
+    int rowBytes = 0;           // Distance in bytes between rows
+    SurfaceFormatData format;
+
+    // False for surfaces without directly accessible pixels
+    // (e.g. GPU-backed surfaces).
+    bool valid() const { return base != nullptr; }
+
+    uint8_t* row(int y) const {
+      return base + y*rowBytes;
+    }
+    uint32_t* row32(int y) const {
+      return (uint32_t*)(base + y*rowBytes);
+    }
+  };
+
+  // Per-surface draw statistics (see Surface::stats()): how many draw
+  // calls of each kind ran since the last resetStats(), and an
+  // approximation of the pixel volume they filled, to tell apart
+  // call-bound and fill-rate-bound slow frames. The counters are
+  // compiled in only when the LAF_SURFACE_STATS preprocessor flag is
+  // defined (like LAF_MEMLEAK); without it stats() returns zeros and
+  // the draw paths don't pay anything.
+  struct SurfaceStats {
+    uint32_t clears = 0;        // clear() calls
+    uint32_t putPixels = 0;     // putPixel() calls
+    uint32_t lines = 0;         // drawLine() calls
+    uint32_t rects = 0;         // drawRect()/drawRects() calls
+    uint32_t shapes = 0;        // drawCircle()/drawPath() calls
+    uint32_t blits = 0;         // blitTo()/drawSurface() family calls
+    uint64_t pixelsFilled = 0;  // Approx. pixels written by the above
+                                // (local-space bounding boxes)
+    uint32_t locks = 0;         // lock() calls
+    uint32_t maxSaveDepth = 0;  // Deepest save()/saveClip() nesting
+  };
+
+  // One source -> destination blit for Surface::drawSurfaces().
+  struct SurfaceBlit {
+    const Surface* surface = nullptr;
+    gfx::Rect src;
+    gfx::Rect dst;
+  };
+
+  // Handle of a pixel snapshot published in a shared-memory segment
+  // with Surface::shareSnapshot(). Send name() to the helper process
+  // through your IPC channel and keep this reference alive until the
+  // peer imported it with System::importSurfaceSnapshot() (the
+  // segment name dies with the last reference).
+  class SurfaceSnapshot : public RefCount {
+  public:
+    virtual ~SurfaceSnapshot() { }
+    virtual const std::string& name() const = 0;
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+  };
+  using SurfaceSnapshotRef = Ref<SurfaceSnapshot>;
+
   class Surface : public RefCount {
   public:
     virtual ~Surface() { }
@@ -48,6 +129,44 @@ namespace os {
     // in the future. E.g. useful for sprite sheets/texture atlases.
     virtual void setImmutable() = 0;
 
+    // Returns a new surface that shares the pixels of this one
+    // without copying them. Both surfaces become immutable, and
+    // trying to draw on any of them detaches a private copy of the
+    // pixels first (copy-on-write), so one skin sheet/texture atlas
+    // can be handed to several windows and caches without being
+    // duplicated. Can return nullptr if the backend cannot share the
+    // pixel storage (e.g. a GPU-backed surface). Raw writes through
+    // getData() bypass the copy-on-write detach.
+    virtual SurfaceRef shareImmutable() = 0;
+
+    // Publishes an immutable copy of the current pixels in a named
+    // shared-memory segment so a helper process (thumbnailer,
+    // exporter) can import them as a zero-copy surface with
+    // System::importSurfaceSnapshot(), instead of receiving them
+    // serialized through a pipe. The one copy happens here, into the
+    // segment; the importer maps the same pages. Returns nullptr if
+    // the backend cannot export the pixel storage (e.g. a GPU-backed
+    // surface) or the segment cannot be created.
+    virtual SurfaceSnapshotRef shareSnapshot() { return nullptr; }
+
+    // Callback for readPixelsAsync(): "pixels" points to the
+    // top-left pixel of the requested rectangle (rows separated by
+    // "rowBytes" bytes, same pixel format as the surface, see
+    // getFormat()) and is valid only during the call. On failure it
+    // receives nullptr.
+    using ReadPixelsCallback =
+      std::function<void(const uint8_t* pixels, int rowBytes)>;
+
+    // Reads the pixels of rc without stalling on the GPU pipeline:
+    // the readback is queued behind the pending draws and the
+    // callback runs when the data is available (for GPU-backed
+    // surfaces that's usually during a later flush, e.g. the next
+    // present; for raster surfaces it runs before returning). Meant
+    // for eyedropper/screenshot-style features that would otherwise
+    // pay a synchronous glReadPixels-style flush mid-frame.
+    virtual void readPixelsAsync(const gfx::Rect& rc,
+                                 ReadPixelsCallback callback) = 0;
+
     virtual int getSaveCount() const = 0;
     virtual gfx::Rect getClipBounds() const = 0;
     virtual void saveClip() = 0;
@@ -65,11 +184,33 @@ namespace os {
     virtual void lock() = 0;
     virtual void unlock() = 0;
 
+    // Draw statistics accumulated since the last resetStats() (all
+    // zeros unless the backend was compiled with LAF_SURFACE_STATS).
+    // Typically reset at the start of a frame and read at the end.
+    virtual SurfaceStats stats() const { return SurfaceStats(); }
+    virtual void resetStats() { }
+
     virtual void clear() = 0;
 
     virtual uint8_t* getData(int x, int y) const = 0;
     virtual void getFormat(SurfaceFormatData* formatData) const = 0;
 
+    // Resolves getData()/getFormat() once into a SurfacePixels view,
+    // so pixel loops can iterate rows through plain pointer
+    // arithmetic. Check valid() before using it.
+    SurfacePixels pixels() const {
+      SurfacePixels view;
+      view.base = getData(0, 0);
+      if (view.base) {
+        getFormat(&view.format);
+        if (height() > 1)
+          view.rowBytes = int(getData(0, 1) - view.base);
+        else
+          view.rowBytes = width() * (view.format.bitsPerPixel/8);
+      }
+      return view;
+    }
+
     virtual gfx::Color getPixel(int x, int y) const = 0;
     virtual void putPixel(gfx::Color color, int x, int y) = 0;
 
@@ -106,6 +247,23 @@ namespace os {
                paint);
     }
 
+    // Draws a batch of rectangles with one paint, so backends can set
+    // up their drawing state once instead of paying the per-call
+    // overhead (virtual dispatch + canvas checks) for each rectangle
+    // of a grid or tilemap. Overlapping rectangles are painted as one
+    // shape (each pixel is touched once even with a semi-transparent
+    // paint).
+    virtual void drawRects(const gfx::RectF* rects, int n,
+                           const os::Paint& paint) {
+      for (int i=0; i<n; ++i)
+        drawRect(rects[i], paint);
+    }
+
+    void drawRects(const std::vector<gfx::RectF>& rects,
+                   const os::Paint& paint) {
+      drawRects(rects.data(), int(rects.size()), paint);
+    }
+
     virtual void drawCircle(float cx, float cy, float radius,
                             const os::Paint& paint) = 0;
 
@@ -133,6 +291,23 @@ namespace os {
                              const gfx::Rect& dstRect,
                              const os::Sampling& sampling = os::Sampling(),
                              const os::Paint* paint = nullptr) = 0;
+    // Draws a batch of blits converting the sampling/paint state just
+    // once (see drawRects()). All the blits use the drawSurface()
+    // semantics (kSrc blending when paint is nullptr).
+    virtual void drawSurfaces(const SurfaceBlit* blits, int n,
+                              const os::Sampling& sampling = os::Sampling(),
+                              const os::Paint* paint = nullptr) {
+      for (int i=0; i<n; ++i)
+        drawSurface(blits[i].surface, blits[i].src, blits[i].dst,
+                    sampling, paint);
+    }
+
+    void drawSurfaces(const std::vector<SurfaceBlit>& blits,
+                      const os::Sampling& sampling = os::Sampling(),
+                      const os::Paint* paint = nullptr) {
+      drawSurfaces(blits.data(), int(blits.size()), sampling, paint);
+    }
+
     virtual void drawRgbaSurface(const Surface* src, int dstx, int dsty) = 0;
     virtual void drawRgbaSurface(const Surface* src, int srcx, int srcy, int dstx, int dsty, int width, int height) = 0;
     virtual void drawColoredRgbaSurface(const Surface* src, gfx::Color fg, gfx::Color bg, const gfx::Clip& clip) = 0;
@@ -143,8 +318,97 @@ namespace os {
                                  bool drawCenter,
                                  const os::Paint* paint) = 0;
 
+    // Records the draw calls that "draw" performs over this surface
+    // into a reusable display list without touching the pixels, so
+    // static UI chrome can be baked once and then replayed every
+    // frame with a single playback() call instead of re-executing
+    // hundreds of virtual draw calls. Only drawing goes into the
+    // list: direct pixel access (putPixel()/getData()) is not
+    // recorded. The default implementation doesn't record anything:
+    // it runs "draw" immediately over the pixels and returns nullptr
+    // (playback() of a null list is a no-op), so callers work the
+    // same on backends without display lists.
+    virtual DrawListRef record(const gfx::Rect& bounds,
+                               const std::function<void(Surface&)>& draw) {
+      draw(*this);
+      return nullptr;
+    }
+
+    // Replays a list baked by record() over this surface. The list
+    // can come from any surface of the same backend.
+    virtual void playback(const DrawListRef& list) { }
+
     virtual void applyScale(int scaleFactor) = 0;
+
+    // DPI-change fast path over applyScale(): the first call
+    // snapshots the current content as the scale-1 "origin", and
+    // every visited scale keeps a cached pre-scaled copy, so dragging
+    // a window between monitors of different DPI swaps an
+    // already-built bitmap instead of resampling dozens of skin
+    // surfaces synchronously. Unlike applyScale(), the factor is
+    // relative to the origin (calling it twice with 2 leaves the
+    // surface at 2x, not 4x). Edits made to the surface after the
+    // first call are not reflected in the cached copies. The default
+    // implementation just falls back to applyScale().
+    virtual void applyScaleCached(int scaleFactor) {
+      applyScale(scaleFactor);
+    }
+
+    // Builds the applyScaleCached() copies for the given scales in
+    // parallel on the thread pool (joining before returning), e.g. at
+    // load time for the scales of the connected monitors. No-op in
+    // backends without a variant cache.
+    virtual void precacheScales(const std::vector<int>& scales,
+                                base::thread_pool& pool) { }
+
+    // Builds the mipmap chain consumed by drawSurface() when the
+    // sampling asks for Sampling::Mipmap != None, on a worker of the
+    // thread pool (without joining), so the first zoomed-out draw of
+    // a big surface doesn't pay the downscale on the UI thread.
+    // No-op in backends without a mipmap cache.
+    virtual void precacheMipmaps(base::thread_pool& pool) { }
+
+    // Pins the surface content as a GPU texture so later draws into
+    // accelerated windows sample the resident texture instead of
+    // re-uploading the pixels (e.g. the glyph sheet of a
+    // SpriteSheetFont, blitted dozens of times per frame). No-op
+    // when there is no accelerated window or in backends without a
+    // texture cache; the texture is still created lazily on the
+    // first draw in that case.
+    virtual void precacheTexture() { }
+
     virtual void* nativeHandle() = 0;
+
+    // Opt-in damage tracking: when enabled, backends accumulate the
+    // device-space bounds of every mutation into a region, so the
+    // present path can upload/blit only what actually changed in the
+    // frame instead of the whole surface (e.g. passing the damage to
+    // Window::invalidateRegion()).
+    void setTrackDamage(const bool track) {
+      m_trackDamage = track;
+      if (!track)
+        m_damage.clear();
+    }
+    bool trackingDamage() const { return m_trackDamage; }
+
+    // Returns the damage accumulated since the last call and resets
+    // it for the next frame.
+    gfx::Region takeDamage() {
+      gfx::Region rgn(std::move(m_damage));
+      return rgn;
+    }
+
+  protected:
+    // Called by backends after each mutation with the affected
+    // device-space bounds (already clipped to the surface)
+    void addDamage(const gfx::Rect& bounds) {
+      if (m_trackDamage && !bounds.isEmpty())
+        m_damage |= bounds;
+    }
+
+  private:
+    bool m_trackDamage = false;
+    gfx::Region m_damage;
   };
 
   class SurfaceLock {
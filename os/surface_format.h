@@ -16,6 +16,12 @@ namespace os {
 
   struct SurfaceFormatData {
     SurfaceFormat format;
+    // True when the RGB components are stored premultiplied by the
+    // alpha (the native mode of RGBA surfaces, so compositing doesn't
+    // pay a per-pixel conversion on every draw). Code reading or
+    // writing raw pixels through Surface::getData() must convert at
+    // that boundary when it needs straight alpha.
+    bool premultipliedAlpha;
     uint32_t bitsPerPixel;
     uint32_t redShift;
     uint32_t greenShift;
@@ -10,19 +10,137 @@
 #endif
 
 #include "base/debug.h"
+#include "base/file_content.h"
+#include "base/thread_pool.h"
 #include "os/ref.h"
+#include "os/startup.h"
+#include "os/surface.h"
 #include "os/system.h"
+#include "os/window.h"
+#include "os/window_spec.h"
+
+#include <algorithm>
 
 namespace os {
 
+// Max number of backings kept alive for makePooledSurface(). Enough
+// for the transient compositing surfaces of one frame without
+// pinning too much pixel memory.
+static const int kMaxPooledSurfaces = 16;
+
+// Max number of hidden windows kept alive for makePopupWindow().
+// Native windows are heavier than surfaces, and more than a couple
+// of simultaneous popups is rare.
+static const int kMaxPooledWindows = 4;
+
+Ref<Surface> System::makePooledSurface(int width, int height,
+                                       const os::ColorSpaceRef& colorSpace)
+{
+  // Reuse a free backing of the same size/color space (a surface is
+  // free when the pool holds its only reference)
+  for (const Ref<Surface>& sur : m_surfacePool) {
+    if (sur->ref_count() == 1 &&
+        sur->width() == width &&
+        sur->height() == height &&
+        sur->colorSpace().get() == colorSpace.get()) {
+      return sur;
+    }
+  }
+
+  Ref<Surface> sur = makeRgbaSurface(width, height, colorSpace);
+  if (sur && int(m_surfacePool.size()) < kMaxPooledSurfaces)
+    m_surfacePool.push_back(sur);
+  return sur;
+}
+
+// True if makePopupWindow() can recycle a pooled window for the
+// given spec: everything else in a WindowSpec shapes the native
+// frame created with the window and cannot be respec'd afterwards.
+static bool is_poolable_spec(const WindowSpec& spec)
+{
+  return (spec.borderless() && spec.floating() && !spec.titled());
+}
+
+void System::prewarmPopupWindows(int count)
+{
+  WindowSpec spec(16, 16);
+  spec.titled(false);
+  spec.borderless(true);
+  spec.floating(true);
+  spec.resizable(false);
+  spec.maximizable(false);
+  spec.minimizable(false);
+  spec.position(WindowSpec::Position::Frame);
+  spec.frame(gfx::Rect(0, 0, 16, 16));
+
+  count = std::min(count, kMaxPooledWindows);
+  while (int(m_windowPool.size()) < count) {
+    WindowRef win = makeWindow(spec);
+    if (!win)
+      break;
+    m_windowPool.push_back(win);
+  }
+}
+
+WindowRef System::makePopupWindow(const WindowSpec& spec)
+{
+  if (is_poolable_spec(spec)) {
+    // Claim a free prewarmed window (a window is free when the pool
+    // holds its only reference) and respec it: for a borderless
+    // window resizing/moving is all that's left of the creation path
+    for (const WindowRef& win : m_windowPool) {
+      if (win->ref_count() == 1 && !win->isVisible()) {
+        if (win->scale() != spec.scale())
+          win->setScale(spec.scale());
+        const gfx::Rect frame =
+          (!spec.frame().isEmpty() ? spec.frame():
+                                     spec.contentRect());
+        if (!frame.isEmpty() && win->frame() != frame)
+          win->setFrame(frame);
+        return win;
+      }
+    }
+  }
+
+  WindowRef win = makeWindow(spec);
+  if (win && is_poolable_spec(spec) &&
+      int(m_windowPool.size()) < kMaxPooledWindows) {
+    m_windowPool.push_back(win);
+  }
+  return win;
+}
+
 static System* g_system = nullptr;
 
 System* make_system_impl();   // Defined on each back-end
 
+SurfaceFuture System::loadSurfaceAsync(const std::string& filename,
+                                       base::thread_pool& pool)
+{
+  auto result = std::make_shared<Ref<Surface>>();
+  auto task = new base::task;
+  task->on_execute(
+    [this, filename, result](base::task_token& token) {
+      // The mapping stays alive for the whole decode, so the decoder
+      // reads straight from the page cache without an owned copy
+      const base::mapped_file content = base::map_file_content(filename);
+      if (content.empty() || token.canceled())
+        return;
+      *result = decodeSurface(content.data(), content.size());
+    });
+  // The continuation owns the task lifetime; callers wait on its
+  // future
+  base::task::future done = task->then(
+    [task](base::task_token&) { delete task; });
+  task->start(pool);
+  return SurfaceFuture(std::move(done), result);
+}
+
 SystemRef make_system()
 {
   ASSERT(!g_system);
   g_system = make_system_impl();
+  mark_startup_phase("system-created");
   return SystemRef(g_system);
 }
 
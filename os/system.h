@@ -9,6 +9,7 @@
 #define OS_SYSTEM_H_INCLUDED
 #pragma once
 
+#include "base/task.h"
 #include "gfx/fwd.h"
 #include "os/app_mode.h"
 #include "os/capabilities.h"
@@ -16,6 +17,7 @@
 #include "os/keys.h"
 #include "os/ref.h"
 #include "os/screen.h"
+#include "os/tiled_surface.h"
 #include "os/window.h"
 #include "os/window_spec.h"
 
@@ -38,6 +40,53 @@ namespace os {
 
   using SystemRef = Ref<System>;
 
+  // Pending result of System::loadSurfaceAsync(): a copyable handle
+  // to wait for (or poll) the decoded surface.
+  class SurfaceFuture {
+  public:
+    SurfaceFuture() { }
+
+    bool valid() const { return m_done.valid(); }
+
+    // True when the decode finished, i.e. get() will not block.
+    bool ready() const { return m_done.completed(); }
+
+    // Waits until the decode finishes and returns the surface
+    // (nullptr if the file couldn't be read or decoded).
+    Ref<Surface> get() {
+      m_done.wait();
+      return *m_result;
+    }
+
+  private:
+    friend class System;
+
+    SurfaceFuture(base::task::future&& done,
+                  const std::shared_ptr<Ref<Surface>>& result)
+      : m_done(std::move(done))
+      , m_result(result) { }
+
+    base::task::future m_done;
+    std::shared_ptr<Ref<Surface>> m_result;
+  };
+
+  // Flags to hint how System::makeSurface() should allocate the
+  // surface.
+  enum class SurfaceFlags {
+    // Not "None": X.h defines it as a macro and this header is
+    // included after <X11/Xlib.h> in the X11 backend
+    NoFlags = 0,
+
+    // Try to allocate the surface on the GPU (when GPU acceleration
+    // is enabled and the backend supports it), so drawSurface()
+    // between GPU surfaces and the window backbuffer doesn't need a
+    // CPU readback. Falls back to a raster surface silently. GPU
+    // surfaces don't give access to their pixels (getData() returns
+    // nullptr), so use this flag only for intermediate surfaces that
+    // are just composited.
+    TryGpu = 1,
+  };
+
   // TODO why we just don't return nullptr if the window creation fails?
   //      maybe an error handler function?
   class WindowCreationException : public std::runtime_error {
@@ -125,6 +174,12 @@ namespace os {
       return (int(capabilities()) & int(c)) == int(c);
     }
 
+    // Runtime-detected CPU SIMD features, so pixel kernels can
+    // dispatch to the widest safe path (see
+    // os::select_cpu_kernel()). Backend-independent, same result as
+    // os::cpu_features().
+    CpuFeatures cpuFeatures() const { return cpu_features(); }
+
     // Sets the specific API to use to process tablet/stylus/pen
     // messages.
     //
@@ -161,11 +216,87 @@ namespace os {
       return makeWindow(WindowSpec(contentWidth, contentHeight, scale));
     }
 
-    virtual Ref<Surface> makeSurface(int width, int height, const os::ColorSpaceRef& colorSpace = nullptr) = 0;
+    // Pre-creates up to "count" hidden borderless floating windows
+    // (the spec of tooltips/preview popups) during startup, so the
+    // first makePopupWindow() calls skip the native window + surface
+    // + context setup (tens of ms) and showing a popup is just a
+    // move/resize/show.
+    void prewarmPopupWindows(int count);
+
+    // Returns a window for a transient popup, claiming a prewarmed
+    // hidden window when the spec allows it (borderless floating,
+    // respec'd to the requested frame and scale) or creating a new
+    // one with makeWindow(). The window comes hidden, like any new
+    // window. A poolable window returns to the pool when the caller
+    // drops its reference: hide it (setVisible(false)) before
+    // releasing it, the pool keeps it alive.
+    WindowRef makePopupWindow(const WindowSpec& spec);
+
+    virtual Ref<Surface> makeSurface(int width, int height,
+                                     const os::ColorSpaceRef& colorSpace = nullptr,
+                                     const SurfaceFlags flags = SurfaceFlags::NoFlags) = 0;
     virtual Ref<Surface> makeRgbaSurface(int width, int height, const os::ColorSpaceRef& colorSpace = nullptr) = 0;
+
+    // Returns a transient RGBA surface taken from a size-bucketed
+    // pool, so compositing surfaces that are created and destroyed
+    // every frame stop churning the allocator and page-fault path. A
+    // pooled surface becomes reusable as soon as the caller drops its
+    // reference, and it's NOT cleared when recycled: the caller is
+    // expected to paint over the old content (or call clear()).
+    Ref<Surface> makePooledSurface(int width, int height,
+                                   const os::ColorSpaceRef& colorSpace = nullptr);
+
+    // Decodes an image file content already loaded in memory (same
+    // formats as loadSurface()). The data only has to stay valid
+    // during this call. Returns nullptr if the backend cannot decode
+    // from memory.
+    virtual Ref<Surface> decodeSurface(const uint8_t* data, size_t size) {
+      return nullptr;
+    }
+
+    // Asynchronous loadSurface(): memory-maps the file
+    // (base::map_file_content(), so pages stream in on demand) and
+    // decodes it on the given thread pool, so startup can load dozens
+    // of skin images in parallel instead of serially on the UI
+    // thread. Once started the decode always runs to completion.
+    SurfaceFuture loadSurfaceAsync(const std::string& filename,
+                                   base::thread_pool& pool);
     virtual Ref<Surface> loadSurface(const char* filename) = 0;
     virtual Ref<Surface> loadRgbaSurface(const char* filename) = 0;
 
+    // Opens an image file as a tiled source: the compressed file
+    // stays memory-mapped and tiles are decoded on demand when drawn
+    // (see os::TiledSurface), so huge reference images don't have to
+    // fit decoded in RAM. Returns nullptr when the backend or the
+    // file format cannot decode incrementally (fall back to
+    // loadSurface() in that case).
+    virtual Ref<TiledSurface> loadTiledSurface(const char* filename) {
+      return nullptr;
+    }
+
+    // Sets the directory where the backend persists GPU-compiled
+    // shader programs between runs, so runtime shader effects don't
+    // pay the driver compile (100-300ms) on first use in every
+    // process. Entries are keyed by program + driver identity, so a
+    // driver update just misses the stale ones. Empty (the default)
+    // disables the cache. No-op on backends without GPU shaders.
+    virtual void setShaderCacheDir(const std::string& dir) { }
+
+    // Preloads the persisted shader programs into memory on the
+    // given pool, so the first paint that needs them doesn't do disk
+    // I/O. Call it right after setShaderCacheDir() during startup.
+    virtual void warmShaderCache(base::thread_pool& pool) { }
+
+    // Imports a snapshot published with Surface::shareSnapshot() by
+    // another process as a read-only surface over the shared pixels
+    // (no copy: both processes map the same pages). The publisher
+    // must keep its SurfaceSnapshot reference alive until this call
+    // returns. Returns nullptr if the name doesn't exist or doesn't
+    // contain a valid snapshot.
+    virtual Ref<Surface> importSurfaceSnapshot(const char* name) {
+      return nullptr;
+    }
+
     // Creates a new cursor with the given surface.
     //
     // Warning: On Windows there is a limit of 10,000 GDI objects per
@@ -185,6 +316,18 @@ namespace os {
     // Returns true if the the given scancode key is pressed/actived.
     virtual bool isKeyPressed(KeyScancode scancode) = 0;
 
+    // Returns the pressed state of every scancode in one snapshot
+    // (one XQueryKeymap/GetKeyboardState round-trip instead of one
+    // query per key), for code that checks many shortcuts per frame.
+    // The default implementation just polls each scancode with
+    // isKeyPressed().
+    virtual KeyStates keyStates() {
+      KeyStates states;
+      for (int i=0; i<kKeyScancodes; ++i)
+        states.setPressed(KeyScancode(i), isKeyPressed(KeyScancode(i)));
+      return states;
+    }
+
     // Returns the active pressed modifiers.
     virtual KeyModifiers keyModifiers() = 0;
 
@@ -248,6 +391,15 @@ namespace os {
     // vendor (company name, etc.)
     virtual void setWintabDelegate(void* delegate) { }
 #endif
+
+  private:
+    // Recycled backings for makePooledSurface() (the pool entry is
+    // the only reference to a free surface)
+    std::vector<Ref<Surface>> m_surfacePool;
+
+    // Prewarmed/recycled hidden windows for makePopupWindow() (the
+    // pool entry is the only reference to a free window)
+    std::vector<WindowRef> m_windowPool;
   };
 
   SystemRef make_system();
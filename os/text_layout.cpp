@@ -0,0 +1,185 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "os/text_layout.h"
+
+#include "base/debug.h"
+#include "os/draw_text.h"
+
+#include <algorithm>
+
+namespace os {
+
+TextLayout::TextLayout(Font* font, const int wrapWidth)
+  : m_font(AddRef(font))
+  , m_wrapWidth(wrapWidth)
+{
+  ASSERT(font);
+}
+
+void TextLayout::setText(const std::string& text)
+{
+  m_text = text;
+  m_lines.clear();
+  layoutRange(0, m_text.size(), 0);
+}
+
+void TextLayout::setWrapWidth(const int wrapWidth)
+{
+  if (m_wrapWidth == wrapWidth)
+    return;
+
+  // A wrapping change can move every line break
+  m_wrapWidth = wrapWidth;
+  m_lines.clear();
+  layoutRange(0, m_text.size(), 0);
+}
+
+void TextLayout::replaceRange(size_t pos, size_t removed,
+                              const std::string& inserted)
+{
+  pos = std::min(pos, m_text.size());
+  removed = std::min(removed, m_text.size() - pos);
+
+  // Paragraph boundaries ("\n") limit how far an edit can move line
+  // breaks: word wrapping never crosses them, so the relayout scope
+  // is just the paragraphs intersecting the edited range.
+  size_t paraStart = 0;
+  if (pos > 0) {
+    const size_t nl = m_text.rfind('\n', pos-1);
+    if (nl != std::string::npos)
+      paraStart = nl+1;
+  }
+  size_t paraEndOld = m_text.find('\n', pos+removed);
+  if (paraEndOld == std::string::npos)
+    paraEndOld = m_text.size();
+
+  m_text.replace(pos, removed, inserted);
+
+  const std::ptrdiff_t delta =
+    std::ptrdiff_t(inserted.size()) - std::ptrdiff_t(removed);
+  const size_t paraEndNew = size_t(std::ptrdiff_t(paraEndOld) + delta);
+
+  // Drop the lines of the affected paragraphs (their starts are in
+  // [paraStart, paraEndOld]) and shift the byte offsets of the
+  // following ones.
+  auto first = std::lower_bound(
+    m_lines.begin(), m_lines.end(), paraStart,
+    [](const Line& line, const size_t pos) {
+      return line.start < pos;
+    });
+  const int insertAt = int(first - m_lines.begin());
+
+  auto last = first;
+  while (last != m_lines.end() && last->start <= paraEndOld)
+    ++last;
+  last = m_lines.erase(first, last);
+  for (auto it=last; it!=m_lines.end(); ++it)
+    it->start = size_t(std::ptrdiff_t(it->start) + delta);
+
+  layoutRange(paraStart, paraEndNew, insertAt);
+}
+
+std::string TextLayout::lineText(const int i) const
+{
+  const Line& line = m_lines[i];
+  return m_text.substr(line.start, line.length);
+}
+
+int TextLayout::lineHeight() const
+{
+  return m_font->height();
+}
+
+gfx::Size TextLayout::size() const
+{
+  int w = 0;
+  for (const Line& line : m_lines)
+    w = std::max(w, line.width);
+  return gfx::Size(w, lineHeight() * std::max(1, lineCount()));
+}
+
+gfx::Rect TextLayout::draw(Surface* surface,
+                           const gfx::Color fg, const gfx::Color bg,
+                           const gfx::Point& pos,
+                           DrawTextDelegate* delegate) const
+{
+  gfx::Rect bounds;
+  const int h = lineHeight();
+  int y = pos.y;
+  for (int i=0; i<lineCount(); ++i) {
+    bounds |= draw_text(surface, m_font.get(), lineText(i),
+                        fg, bg, pos.x, y, delegate);
+    y += h;
+  }
+  return bounds;
+}
+
+void TextLayout::layoutRange(const size_t start, const size_t end,
+                             const int insertAt)
+{
+  std::vector<Line> lines;
+  size_t paraStart = start;
+  while (true) {
+    size_t paraEnd = m_text.find('\n', paraStart);
+    if (paraEnd == std::string::npos || paraEnd > end)
+      paraEnd = end;
+
+    wrapParagraph(paraStart, paraEnd, lines);
+
+    if (paraEnd >= end)
+      break;
+    paraStart = paraEnd+1;      // Skip the "\n"
+  }
+  m_lines.insert(m_lines.begin() + insertAt,
+                 lines.begin(), lines.end());
+}
+
+void TextLayout::wrapParagraph(const size_t start, const size_t end,
+                               std::vector<Line>& out) const
+{
+  if (m_wrapWidth <= 0 || start == end) {
+    out.push_back(Line{ start, end-start, measure(start, end-start) });
+    return;
+  }
+
+  const int spaceW = m_font->textLength(" ");
+  size_t lineStart = start;
+  int lineW = 0;                // Width without the trailing space
+  size_t i = start;
+  while (i < end) {
+    // Next word [i, wordEnd)
+    size_t wordEnd = i;
+    while (wordEnd < end && m_text[wordEnd] != ' ')
+      ++wordEnd;
+    const int wordW = measure(i, wordEnd-i);
+
+    if (lineW > 0 && lineW + spaceW + wordW > m_wrapWidth) {
+      // Close the current line before this word (the separator
+      // space stays unpainted at the break)
+      out.push_back(Line{ lineStart, i-1-lineStart, lineW });
+      lineStart = i;
+      lineW = wordW;
+    }
+    else {
+      lineW += (lineW > 0 ? spaceW: 0) + wordW;
+    }
+
+    i = wordEnd+1;              // Skip the separator space
+  }
+  out.push_back(Line{ lineStart, end-lineStart, lineW });
+}
+
+int TextLayout::measure(const size_t start, const size_t length) const
+{
+  return m_font->textLength(m_text.substr(start, length));
+}
+
+} // namespace os
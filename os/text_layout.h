@@ -0,0 +1,89 @@
+// LAF OS Library
+// Copyright (c) 2023 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_TEXT_LAYOUT_H_INCLUDED
+#define OS_TEXT_LAYOUT_H_INCLUDED
+#pragma once
+
+#include "gfx/color.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+#include "os/font.h"
+#include "os/ref.h"
+
+#include <string>
+#include <vector>
+
+namespace os {
+
+  class DrawTextDelegate;
+  class Surface;
+
+  // Multiline layout on top of the single-line draw_text(): splits
+  // the text in lines (explicit "\n" breaks plus optional word
+  // wrapping to a fixed width) and caches the line breaks and
+  // measured widths. replaceRange() relayouts only the paragraphs
+  // that intersect the edited range, so editors and long console
+  // views pay O(change) instead of O(document) per keystroke.
+  // Measuring goes through the Font (HarfBuzz shaping for FreeType
+  // fonts).
+  class TextLayout {
+  public:
+    // A laid out line: a byte range of text() plus its measured
+    // width. The height is uniform (lineHeight()).
+    struct Line {
+      size_t start;             // Byte offset inside text()
+      size_t length;            // Length in bytes (without the "\n")
+      int width;                // Measured width in pixels
+    };
+
+    // wrapWidth <= 0 disables word wrapping (lines break only on
+    // "\n"). Words wider than wrapWidth are not broken mid-word.
+    TextLayout(Font* font, int wrapWidth = 0);
+
+    Font* font() const { return m_font.get(); }
+    const std::string& text() const { return m_text; }
+    int wrapWidth() const { return m_wrapWidth; }
+
+    void setText(const std::string& text);
+    void setWrapWidth(int wrapWidth);
+
+    // Replaces the [pos, pos+removed) byte range with "inserted",
+    // relayouting only the paragraphs touching the range.
+    void replaceRange(size_t pos, size_t removed,
+                      const std::string& inserted);
+
+    int lineCount() const { return int(m_lines.size()); }
+    const Line& line(int i) const { return m_lines[i]; }
+    std::string lineText(int i) const;
+    int lineHeight() const;
+    gfx::Size size() const;
+
+    // Draws the laid out lines with draw_text() (the surface can be
+    // nullptr just to process the delegate callbacks).
+    gfx::Rect draw(Surface* surface,
+                   gfx::Color fg, gfx::Color bg,
+                   const gfx::Point& pos,
+                   DrawTextDelegate* delegate = nullptr) const;
+
+  private:
+    // Re-splits the [start, end) byte range in lines, inserting them
+    // at the insertAt position of m_lines
+    void layoutRange(size_t start, size_t end, int insertAt);
+    void wrapParagraph(size_t start, size_t end,
+                       std::vector<Line>& out) const;
+    int measure(size_t start, size_t length) const;
+
+    Ref<Font> m_font;
+    int m_wrapWidth;
+    std::string m_text;
+    std::vector<Line> m_lines;
+  };
+
+} // namespace os
+
+#endif
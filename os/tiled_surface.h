@@ -0,0 +1,58 @@
+// LAF OS Library
+// Copyright (c) 2023  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_TILED_SURFACE_H_INCLUDED
+#define OS_TILED_SURFACE_H_INCLUDED
+#pragma once
+
+#include "gfx/rect.h"
+#include "gfx/size.h"
+#include "os/paint.h"
+#include "os/ref.h"
+#include "os/sampling.h"
+
+namespace os {
+
+  class Surface;
+
+  // Read-only image that is decoded on demand instead of all at
+  // once: the backend keeps the compressed file memory-mapped and
+  // rasterizes only the tiles touched by drawInto(), holding them in
+  // a byte-bounded LRU cache. Viewing a huge reference image costs
+  // memory proportional to the visible area instead of the full
+  // width*height*4 of loadSurface().
+  class TiledSurface : public RefCount {
+  public:
+    virtual ~TiledSurface() { }
+
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+
+    gfx::Size size() const { return gfx::Size(width(), height()); }
+    gfx::Rect bounds() const { return gfx::Rect(0, 0, width(), height()); }
+
+    // Draws srcRect (in image coordinates) scaled into dstRect of the
+    // given surface, with the same semantics as the drawSurface()
+    // rectangle overload. Tiles intersecting srcRect are decoded
+    // first if they aren't cached yet.
+    virtual void drawInto(Surface* dst,
+                          const gfx::Rect& srcRect,
+                          const gfx::Rect& dstRect,
+                          const os::Sampling& sampling = os::Sampling(),
+                          const os::Paint* paint = nullptr) = 0;
+
+    // Bytes currently held by decoded tiles, and the limit the LRU
+    // cache evicts down to.
+    virtual size_t cacheBytes() const = 0;
+    virtual size_t cacheLimit() const = 0;
+    virtual void setCacheLimit(size_t bytes) = 0;
+  };
+
+  using TiledSurfaceRef = Ref<TiledSurface>;
+
+} // namespace os
+
+#endif
@@ -17,43 +17,131 @@
 
 #include "base/time.h"
 
+// Available since Windows 10 1803 (older SDK headers don't define it)
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 namespace os {
 
+EventQueueWin::~EventQueueWin()
+{
+  if (m_waitTimer)
+    CloseHandle((HANDLE)m_waitTimer);
+}
+
+void* EventQueueWin::waitTimer()
+{
+  if (!m_waitTimer && !m_waitTimerUnavailable) {
+    // A high-resolution timer gives sub-ms wakeup precision without
+    // raising the global timer resolution (timeBeginPeriod(1)) and
+    // its power cost.
+    m_waitTimer = CreateWaitableTimerExW(
+      nullptr, nullptr,
+      CREATE_WAITABLE_TIMER_HIGH_RESOLUTION | CREATE_WAITABLE_TIMER_MANUAL_RESET,
+      TIMER_ALL_ACCESS);
+    if (!m_waitTimer)
+      m_waitTimerUnavailable = true;
+  }
+  return m_waitTimer;
+}
+
 void EventQueueWin::queueEvent(const Event& ev)
 {
+  if (filterEvent(ev))
+    return;
+
   m_events.push(ev);
 }
 
 void EventQueueWin::clearEvents()
 {
+  clearPendingEvent();
   m_events.clear();
 }
 
+void EventQueueWin::discardIf(const EventFilter& pred)
+{
+  discardEvents(m_events, pred);
+}
+
+void EventQueueWin::addTimer(int intervalMsecs, int timerId)
+{
+  removeTimer(timerId);
+
+  // Thread timer (no HWND): its WM_TIMER messages are converted into
+  // Timer events in getEvent().
+  const UINT_PTR winTimerId = SetTimer(nullptr, 0, UINT(intervalMsecs), nullptr);
+  if (winTimerId)
+    m_timers[timerId] = winTimerId;
+}
+
+void EventQueueWin::removeTimer(int timerId)
+{
+  auto it = m_timers.find(timerId);
+  if (it != m_timers.end()) {
+    KillTimer(nullptr, it->second);
+    m_timers.erase(it);
+  }
+}
+
 void EventQueueWin::getEvent(Event& ev, double timeout)
 {
-  const base::tick_t untilTick = base::current_tick() + timeout*1000.0;
+  const uint64_t untilNs = base::now_ns() + uint64_t(timeout*1.0e9);
   MSG msg;
 
   ev.setWindow(nullptr);
 
-  while (m_events.empty()) {
+  while (!hasPendingEvent() && m_events.empty()) {
     BOOL res;
 
     if (timeout == kWithoutTimeout) {
       res = GetMessage(&msg, nullptr, 0, 0);
     }
     else {
-      const base::tick_t now = base::current_tick();
-      if (untilTick > now) {
-        const base::tick_t msecs = (untilTick - now);
-        MsgWaitForMultipleObjects(0, nullptr, FALSE,
-                                  (DWORD)msecs, // Milliseconds to wait
-                                  QS_ALLINPUT | QS_ALLPOSTMESSAGE);
+      const uint64_t now = base::now_ns();
+      if (untilNs > now) {
+        const uint64_t remainingNs = untilNs - now;
+        HANDLE timer = (HANDLE)waitTimer();
+        if (timer) {
+          // Relative due time in 100ns units: the wait wakes within
+          // microseconds of the deadline instead of the default
+          // ~15ms timer granularity that ruins animation pacing.
+          LARGE_INTEGER dueTime;
+          dueTime.QuadPart = -LONGLONG(remainingNs / 100);
+          if (dueTime.QuadPart == 0)
+            dueTime.QuadPart = -1;
+          SetWaitableTimer(timer, &dueTime, 0, nullptr, nullptr, FALSE);
+          MsgWaitForMultipleObjects(1, &timer, FALSE, INFINITE,
+                                    QS_ALLINPUT | QS_ALLPOSTMESSAGE);
+        }
+        else {
+          // Fallback: millisecond rounding with the default timer
+          // resolution
+          MsgWaitForMultipleObjects(0, nullptr, FALSE,
+                                    DWORD(remainingNs / 1000000),
+                                    QS_ALLINPUT | QS_ALLPOSTMESSAGE);
+        }
       }
       res = PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE);
     }
 
     if (res) {
+      // Timers registered with addTimer() post WM_TIMER messages with
+      // a null hwnd: convert them directly into Timer events.
+      if (msg.message == WM_TIMER && !msg.hwnd) {
+        for (const auto& [timerId, winTimerId] : m_timers) {
+          if (winTimerId == msg.wParam) {
+            Event timerEv;
+            timerEv.setType(Event::Timer);
+            timerEv.setTimerId(timerId);
+            queueEvent(timerEv);
+            break;
+          }
+        }
+        continue;
+      }
+
       // Avoid transforming WM_KEYDOWN/UP into WM_DEADCHAR/WM_CHAR
       // messages. Dead keys are converted manually in the
       // WM_KEYDOWN processing on our WindowWin<T> class.
@@ -72,7 +160,7 @@ void EventQueueWin::getEvent(Event& ev, double timeout)
       break;
   }
 
-  if (!m_events.try_pop(ev)) {
+  if (!popEvent(m_events, ev)) {
     ev.setType(Event::None);
   }
 }
@@ -13,18 +13,40 @@
 #include "os/event.h"
 #include "os/event_queue.h"
 
+#include <map>
 #include <queue>
 
 namespace os {
 
 class EventQueueWin : public EventQueue {
 public:
+  ~EventQueueWin();
+
   void queueEvent(const Event& ev) override;
   void getEvent(Event& ev, double timeout) override;
   void clearEvents();
+  void discardIf(const EventFilter& pred) override;
+  void addTimer(int intervalMsecs, int timerId) override;
+  void removeTimer(int timerId) override;
 
 private:
-  base::concurrent_queue<Event> m_events;
+  // High-resolution waitable timer (HANDLE) used by getEvent() to
+  // honor sub-millisecond timeouts without the default ~15ms timer
+  // resolution jitter (see waitTimer() in event_queue.cpp). Created
+  // lazily; null with m_waitTimerUnavailable set when the OS doesn't
+  // support it (pre-1803 Windows 10).
+  void* waitTimer();
+  void* m_waitTimer = nullptr;
+  bool m_waitTimerUnavailable = false;
+
+  // Timers registered with addTimer() (timer id -> thread timer id
+  // returned by SetTimer()), converted to Timer events when their
+  // WM_TIMER messages are received in getEvent().
+  std::map<int, uintptr_t> m_timers;
+  // Lock-free ring so the hot queueEvent()/getEvent() path costs a
+  // couple of atomics per event instead of a mutex round-trip. When
+  // the ring is full push() applies backpressure.
+  base::concurrent_queue<Event, base::queue_policy::lock_free> m_events{1024};
 };
 
 using EventQueueImpl = EventQueueWin;
@@ -10,6 +10,8 @@
 
 #include "os/win/keys.h"
 
+#include <algorithm>
+
 namespace os {
 
 KeyScancode win32vk_to_scancode(int vk)
@@ -344,18 +346,65 @@ bool win_is_key_pressed(KeyScancode scancode)
     return false;
 }
 
+KeyStates win_key_states()
+{
+  // One GetKeyboardState() call for the whole keyboard instead of a
+  // GetAsyncKeyState() per key. This is the state synchronized with
+  // the message queue of the calling thread, which is what a
+  // shortcut checker running in the UI thread wants anyway.
+  KeyStates states;
+  BYTE keystate[256];
+  if (!GetKeyboardState(keystate))
+    return states;
+
+  for (int i=kKeyNil+1; i<kKeyScancodes; ++i) {
+    const KeyScancode scancode = KeyScancode(i);
+    const int vk = scancode_to_win32vk(scancode);
+    if (vk)
+      states.setPressed(scancode, (keystate[vk] & 0x80) != 0);
+  }
+  return states;
+}
+
 int win_get_unicode_from_scancode(KeyScancode scancode)
 {
   int vk = scancode_to_win32vk(scancode);
-  if (vk && (GetAsyncKeyState(vk) & 0x8000 ? true: false)) {
+  if (!vk || !(GetAsyncKeyState(vk) & 0x8000))
+    return 0;
+
+  // Cached virtual key -> unicode table: ToUnicode() is expensive
+  // (and stateful with dead keys), so each key is resolved once and
+  // the result kept until the keyboard layout or the modifier state
+  // changes. Fewer ToUnicode() calls also means less interference
+  // with a pending dead-key sequence.
+  static HKL cachedLayout = nullptr;
+  static int cachedModifiers = -1;
+  static int cachedUnicode[256];
+  static bool cachedKnown[256];
+
+  const HKL layout = GetKeyboardLayout(0);
+  const int modifiers =
+    ((GetAsyncKeyState(VK_SHIFT) & 0x8000 ? 1: 0) |
+     (GetAsyncKeyState(VK_CONTROL) & 0x8000 ? 2: 0) |
+     (GetAsyncKeyState(VK_MENU) & 0x8000 ? 4: 0));
+  if (layout != cachedLayout || modifiers != cachedModifiers) {
+    cachedLayout = layout;
+    cachedModifiers = modifiers;
+    std::fill(cachedKnown, cachedKnown+256, false);
+  }
+
+  if (!cachedKnown[vk]) {
+    int chr = 0;
     VkToUnicode tu;
     if (tu) {
       tu.toUnicode(vk, 0);
       if (tu.size() > 0)
-        return tu[0];
+        chr = tu[0];
     }
+    cachedUnicode[vk] = chr;
+    cachedKnown[vk] = true;
   }
-  return 0;
+  return cachedUnicode[vk];
 }
 
 } // namespace os
@@ -21,7 +21,9 @@
 #include <windows.h>
 #include <shobjidl.h>
 
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace os {
@@ -366,4 +368,28 @@ FileDialogRef NativeDialogsWin::makeFileDialog()
   return make_ref<FileDialogWin32>();
 }
 
+void NativeDialogsWin::preloadFileDialog()
+{
+  // Creating (and immediately releasing) one IFileDialog loads the
+  // COM class and the shell extensions into the process, which is
+  // what makes the first dialog slow. We do it on a background
+  // thread just to pull the DLLs in: the object is not reused, the
+  // real dialogs are still created in the UI thread by
+  // makeFileDialog().
+  static std::once_flag once;
+  std::call_once(once, [] {
+    std::thread([] {
+      if (SUCCEEDED(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED))) {
+        {
+          base::ComPtr<IFileDialog> dlg;
+          CoCreateInstance(CLSID_FileOpenDialog,
+                           nullptr, CLSCTX_INPROC_SERVER,
+                           IID_PPV_ARGS(&dlg));
+        }
+        CoUninitialize();
+      }
+    }).detach();
+  });
+}
+
 } // namespace os
@@ -17,6 +17,7 @@ namespace os {
   public:
     NativeDialogsWin();
     FileDialogRef makeFileDialog() override;
+    void preloadFileDialog() override;
   };
 
 } // namespace os
@@ -11,13 +11,16 @@
 #include "os/win/system.h"
 
 #include "gfx/color.h"
+#include "os/common/surface_format_convert.h"
 #include "os/win/screen.h"
 
 #include <limits>
+#include <vector>
 
 namespace os {
 
 bool win_is_key_pressed(KeyScancode scancode);
+KeyStates win_key_states();
 int win_get_unicode_from_scancode(KeyScancode scancode);
 
 static const gfx::Point kUnknownPos(std::numeric_limits<int>::min(),
@@ -119,7 +122,7 @@ public:
   HBITMAP hmonobmp() {
     if (!m_hmonobmp) {
       // We must fill the mask bitmap with ones to avoid issues when a cursor is fully
-      // transparent. Before this change we were returning a "no cursor" from makeCursor
+      // transparent. Before this change we were returning a "no cursor" from onMakeCursor
       // when the cursor was fully transparent to avoid showing a black bitmap as the
       // cursor. But then the following issue was found:
       // https://github.com/aseprite/aseprite/issues/3989 (which is about the mouse
@@ -180,12 +183,17 @@ bool SystemWin::isKeyPressed(KeyScancode scancode)
   return win_is_key_pressed(scancode);
 }
 
+KeyStates SystemWin::keyStates()
+{
+  return win_key_states();
+}
+
 int SystemWin::getUnicodeFromScancode(KeyScancode scancode)
 {
   return win_get_unicode_from_scancode(scancode);
 }
 
-CursorRef SystemWin::makeCursor(const os::Surface* surface,
+CursorRef SystemWin::onMakeCursor(const os::Surface* surface,
                                 const gfx::Point& focus,
                                 const int scale)
 {
@@ -206,22 +214,21 @@ CursorRef SystemWin::makeCursor(const os::Surface* surface,
   if (!g_cursor_cache.recreate(sz))
     return nullptr;
 
+  // Convert each source row once (the converter resolves the layouts
+  // up front) and then just replicate pixels for the scale.
+  const SurfaceFormatConverter convert(format, argb_format_data());
+  std::vector<uint32_t> row(surface->width());
   uint32_t* bits = g_cursor_cache.bits();
+  int lastSrcY = -1;
   for (int y=0; y<sz.h; ++y) {
-    const uint32_t* ptr = (const uint32_t*)surface->getData(0, (sz.h-1-y)/scale);
-    for (int x=0, u=0; x<sz.w; ++x, ++bits) {
-      uint32_t c = *ptr;
-      uint32_t a = ((c & format.alphaMask) >> format.alphaShift);
-
-      *bits = (a << 24) |
-        (((c & format.redMask  ) >> format.redShift  ) << 16) |
-        (((c & format.greenMask) >> format.greenShift) << 8) |
-        (((c & format.blueMask ) >> format.blueShift ));
-      if (++u == scale) {
-        u = 0;
-        ++ptr;
-      }
+    const int srcY = (sz.h-1-y)/scale;
+    if (srcY != lastSrcY) {
+      convert(row.data(), (const uint32_t*)surface->getData(0, srcY),
+              surface->width());
+      lastSrcY = srcY;
     }
+    for (int x=0; x<sz.w; ++x, ++bits)
+      *bits = row[x/scale];
   }
 
   ICONINFO ii;
@@ -267,7 +274,7 @@ gfx::Color SystemWin::getColorFromScreen(const gfx::Point& screenPosition) const
                    GetBValue(c));
 }
 
-ScreenRef SystemWin::mainScreen()
+ScreenRef SystemWin::onMainScreen()
 {
   // This is one of three possible ways to get the primary monitor
   // https://devblogs.microsoft.com/oldnewthing/20141106-00/?p=43683
@@ -287,7 +294,7 @@ static BOOL CALLBACK list_screen_enumproc(HMONITOR monitor,
   return TRUE;
 }
 
-void SystemWin::listScreens(ScreenList& list)
+void SystemWin::onListScreens(ScreenList& list)
 {
   EnumDisplayMonitors(
     nullptr, nullptr,
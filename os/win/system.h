@@ -30,9 +30,10 @@ public:
   TabletAPI tabletAPI() const override { return m_tabletAPI; }
 
   bool isKeyPressed(KeyScancode scancode) override;
+  KeyStates keyStates() override;
   int getUnicodeFromScancode(KeyScancode scancode) override;
 
-  CursorRef makeCursor(const Surface* surface,
+  CursorRef onMakeCursor(const Surface* surface,
                        const gfx::Point& focus,
                        const int scale) override;
 
@@ -40,8 +41,8 @@ public:
   void setMousePosition(const gfx::Point& screenPosition) override;
   gfx::Color getColorFromScreen(const gfx::Point& screenPosition) const override;
 
-  ScreenRef mainScreen() override;
-  void listScreens(ScreenList& list) override;
+  ScreenRef onMainScreen() override;
+  void onListScreens(ScreenList& list) override;
 
   void setWintabDelegate(void* delegate) override {
     m_wintabApi.setDelegate((WintabAPI::Delegate*)delegate);
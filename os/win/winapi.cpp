@@ -25,6 +25,7 @@ WinAPI::WinAPI()
     GET_PROC(m_user32, IsMouseInPointerEnabled);
     GET_PROC(m_user32, GetPointerInfo);
     GET_PROC(m_user32, GetPointerPenInfo);
+    GET_PROC(m_user32, GetPointerPenInfoHistory);
     GET_PROC(m_user32, SetProcessDpiAwarenessContext);
   }
   if (m_ninput) {
@@ -20,6 +20,7 @@ namespace os {
   typedef BOOL (WINAPI* IsMouseInPointerEnabled_Func)(void);
   typedef BOOL (WINAPI* GetPointerInfo_Func)(UINT32 pointerId, POINTER_INFO* pointerInfo);
   typedef BOOL (WINAPI* GetPointerPenInfo_Func)(UINT32 pointerId, POINTER_PEN_INFO* penInfo);
+  typedef BOOL (WINAPI* GetPointerPenInfoHistory_Func)(UINT32 pointerId, UINT32* entriesCount, POINTER_PEN_INFO* penInfo);
 
   typedef HRESULT (WINAPI* CreateInteractionContext_Func)(HINTERACTIONCONTEXT* interactionContext);
   typedef HRESULT (WINAPI* DestroyInteractionContext_Func)(HINTERACTIONCONTEXT interactionContext);
@@ -60,6 +61,7 @@ namespace os {
     IsMouseInPointerEnabled_Func IsMouseInPointerEnabled = nullptr;
     GetPointerInfo_Func GetPointerInfo = nullptr;
     GetPointerPenInfo_Func GetPointerPenInfo = nullptr;
+    GetPointerPenInfoHistory_Func GetPointerPenInfoHistory = nullptr;
 
     // InteractionContext introduced on Windows 8
     CreateInteractionContext_Func CreateInteractionContext = nullptr;
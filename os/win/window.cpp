@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include "base/base.h"
 #include "base/debug.h"
@@ -314,6 +315,8 @@ WindowWin::WindowWin(const WindowSpec& spec)
 
 WindowWin::~WindowWin()
 {
+  stopRenderThread();
+
   auto sys = system();
 
   // If this assert fails it's highly probable that an os::WindowRef
@@ -709,7 +712,7 @@ void WindowWin::performWindowAction(const WindowAction action,
   }
 }
 
-void WindowWin::invalidateRegion(const gfx::Region& rgn)
+void WindowWin::onInvalidateRegion(const gfx::Region& rgn)
 {
 #if 1 // Invalidating the region generates a flicker in Aseprite's
       // BrushPreview, because it looks like regions are then painted
@@ -754,6 +757,76 @@ void WindowWin::invalidateRegion(const gfx::Region& rgn)
 #endif
 }
 
+void WindowWin::setRenderThread(bool state)
+{
+  if (state == m_renderThread.joinable())
+    return;
+
+  if (state) {
+    m_renderQuit = false;
+    m_renderThread = std::thread([this]{ renderThreadProc(); });
+  }
+  else
+    stopRenderThread();
+}
+
+void WindowWin::stopRenderThread()
+{
+  if (!m_renderThread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_renderMutex);
+    m_renderQuit = true;
+  }
+  m_renderCondVar.notify_one();
+  m_renderThread.join();
+}
+
+void WindowWin::renderThreadProc()
+{
+  std::unique_lock<std::mutex> lock(m_renderMutex);
+  while (true) {
+    m_renderCondVar.wait(
+      lock, [this]{ return m_renderQuit || !m_renderDamage.isEmpty(); });
+    if (m_renderQuit)
+      break;
+
+    gfx::Region damage;
+    std::swap(damage, m_renderDamage);
+
+    // Blit without the lock so WM_PAINT can keep accumulating damage
+    // for the next frame meanwhile.
+    lock.unlock();
+
+    HDC hdc = GetDC(m_hwnd);
+    if (hdc) {
+      // Clip the DC to the accumulated damage so onPaint() (which
+      // asks GetClipBox() for the dirty area) presents just the
+      // rects that changed, like a regular WM_PAINT DC.
+      HRGN hrgn = nullptr;
+      for (const gfx::Rect& rc : damage) {
+        HRGN rcHrgn = CreateRectRgn(rc.x, rc.y, rc.x2(), rc.y2());
+        if (!hrgn)
+          hrgn = rcHrgn;
+        else {
+          CombineRgn(hrgn, hrgn, rcHrgn, RGN_OR);
+          DeleteObject(rcHrgn);
+        }
+      }
+      if (hrgn) {
+        SelectClipRgn(hdc, hrgn);
+        DeleteObject(hrgn);
+      }
+
+      onPaint(hdc);
+      ReleaseDC(m_hwnd, hdc);
+    }
+
+    lock.lock();
+  }
+}
+
 std::string WindowWin::getLayout()
 {
   WINDOWPLACEMENT wp;
@@ -1060,6 +1133,13 @@ LRESULT WindowWin::wndProc(UINT msg, WPARAM wparam, LPARAM lparam)
       }
       break;
 
+    case WM_DISPLAYCHANGE:
+      // The screen resolution or the monitor topology changed,
+      // refresh the cached screens.
+      if (auto sys = system())
+        sys->invalidateScreens();
+      break;
+
     case WM_PAINT:
       if (m_isCreated) {
         PAINTSTRUCT ps;
@@ -1070,7 +1150,21 @@ LRESULT WindowWin::wndProc(UINT msg, WPARAM wparam, LPARAM lparam)
         // some GDI leaks in the program).
         ASSERT(hdc);
 
-        onPaint(hdc);
+        if (m_renderThread.joinable()) {
+          // Just validate the window and let the render thread blit
+          // the dirty rect, the message loop continues immediately.
+          {
+            std::lock_guard<std::mutex> lock(m_renderMutex);
+            m_renderDamage |= gfx::Rect(ps.rcPaint.left,
+                                        ps.rcPaint.top,
+                                        ps.rcPaint.right - ps.rcPaint.left,
+                                        ps.rcPaint.bottom - ps.rcPaint.top);
+          }
+          m_renderCondVar.notify_one();
+        }
+        else
+          onPaint(hdc);
+
         EndPaint(m_hwnd, &ps);
         return true;
       }
@@ -1131,6 +1225,11 @@ LRESULT WindowWin::wndProc(UINT msg, WPARAM wparam, LPARAM lparam)
 
     case WM_SIZE:
       if (m_isCreated) {
+        if (wparam == SIZE_MINIMIZED)
+          setVisibility(WindowVisibility::Minimized);
+        else if (visibility() == WindowVisibility::Minimized)
+          setVisibility(WindowVisibility::Visible);
+
         gfx::Size newSize(GET_X_LPARAM(lparam),
                           GET_Y_LPARAM(lparam));
 
@@ -1609,6 +1708,12 @@ LRESULT WindowWin::wndProc(UINT msg, WPARAM wparam, LPARAM lparam)
 
       ev.setType(Event::MouseMove);
 
+      // Attach the coalesced pen samples of this pointer frame so
+      // high-report-rate pens don't need one message-loop iteration
+      // per sample.
+      if (pi.pointerType == PT_PEN)
+        attachPointerFrameHistory(ev, pi);
+
       if (m_touch && pi.pointerType == PT_TOUCH) {
         TOUCH_TRACE("POINTERUPDATE canBeMouse=%d asMouse=%d\n",
                     m_touch->canBeMouse,
@@ -1923,12 +2028,20 @@ LRESULT WindowWin::wndProc(UINT msg, WPARAM wparam, LPARAM lparam)
       if (m_packets.size() < api.packetQueueSize())
         m_packets.resize(api.packetQueueSize());
 
+      // The driver posts one WT_PACKET message per packet, so after
+      // the bulk WTPacketsGet() below the message queue still holds
+      // one (stale) message for each drained packet, and a 200Hz pen
+      // costs one message-loop iteration per packet. Remove those
+      // pending messages before draining: a packet queued in between
+      // is drained right here and its message just finds an empty
+      // queue later (n == 0, harmless).
+      MSG msg;
+      while (PeekMessage(&msg, m_hwnd, WT_PACKET, WT_PACKET, PM_REMOVE))
+        ;
+
       int n = api.packets(ctx, m_packets.size(), &m_packets[0]);
       MOUSE_TRACE("WT_PACKET packets=%d\n", n);
 
-      // It looks like that we can process the whole queue with
-      // WTPacketsGet() but we will receive one WT_PACKET for each
-      // packet anyway (even when the queue is empty).
       if (n == 0)
         break;
 
@@ -2085,6 +2198,44 @@ bool WindowWin::pointerEvent(WPARAM wparam, Event& ev, POINTER_INFO& pi)
   return true;
 }
 
+void WindowWin::attachPointerFrameHistory(Event& ev, const POINTER_INFO& pi)
+{
+  auto& winApi = system()->winApi();
+  if (!winApi.GetPointerPenInfoHistory)
+    return;
+
+  // First call to get the number of coalesced samples (Windows
+  // coalesces WM_POINTERUPDATE messages when we don't pump the
+  // message loop fast enough, keeping the intermediate samples in the
+  // history of the last message).
+  UINT32 entries = 0;
+  if (!winApi.GetPointerPenInfoHistory(pi.pointerId, &entries, nullptr) ||
+      entries < 2)
+    return;
+
+  std::vector<POINTER_PEN_INFO> history(entries);
+  if (!winApi.GetPointerPenInfoHistory(pi.pointerId, &entries, history.data()))
+    return;
+
+  ABS_CLIENT_RC(rc);
+
+  // The history is reported newest-first and entry 0 is the current
+  // sample (already in the event itself), attach the older samples in
+  // chronological order.
+  for (UINT32 i=entries; i>1; ) {
+    const POINTER_PEN_INFO& ppi = history[--i];
+
+    Event::PointerSample sample;
+    sample.position.x = (ppi.pointerInfo.ptPixelLocation.x - rc.left) / m_scale;
+    sample.position.y = (ppi.pointerInfo.ptPixelLocation.y - rc.top) / m_scale;
+    sample.pressure = std::clamp(float(ppi.pressure) / 1024.0f, 0.0f, 1.0f);
+    // Both clocks count milliseconds, so we can re-anchor the message
+    // time of the sample to the event timestamp epoch.
+    sample.tick = ev.timestamp() - (pi.dwTime - ppi.pointerInfo.dwTime);
+    ev.addHistorySample(sample);
+  }
+}
+
 void WindowWin::handleMouseMove(Event& ev)
 {
   if (!m_hasMouse) {
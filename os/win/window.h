@@ -10,6 +10,7 @@
 #pragma once
 
 #include "base/time.h"
+#include "gfx/region.h"
 #include "gfx/size.h"
 #include "os/color_space.h"
 #include "os/event.h"
@@ -18,7 +19,11 @@
 #include "os/screen.h"
 #include "os/win/wintab.h"
 
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+
 #include <windows.h>
 #include <interactioncontext.h>
 
@@ -62,7 +67,7 @@ namespace os {
     bool setCursor(const CursorRef& cursor) override;
     void performWindowAction(const WindowAction action,
                              const Event* event) override;
-    void invalidateRegion(const gfx::Region& rgn) override;
+    void onInvalidateRegion(const gfx::Region& rgn) override;
     std::string getLayout() override;
 
     void setLayout(const std::string& layout) override;
@@ -70,6 +75,15 @@ namespace os {
     void setInterpretOneFingerGestureAsMouseMovement(bool state) override;
     void onTabletAPIChange();
 
+    // Enables/disables presenting frames from a dedicated render
+    // thread. When enabled, WM_PAINT just validates the window and
+    // hands the dirty rect to the thread, which blits the surface
+    // with onPaint() while the message loop keeps processing
+    // input/resize messages (a slow present of a big frame doesn't
+    // stall them anymore). invalidateRegion() works as usual.
+    void setRenderThread(bool state);
+    bool renderThread() const { return m_renderThread.joinable(); }
+
     NativeHandle nativeHandle() const override { return m_hwnd; }
 
   private:
@@ -78,6 +92,7 @@ namespace os {
     LRESULT wndProc(UINT msg, WPARAM wparam, LPARAM lparam);
     void mouseEvent(LPARAM lparam, Event& ev);
     bool pointerEvent(WPARAM wparam, Event& ev, POINTER_INFO& pi);
+    void attachPointerFrameHistory(Event& ev, const POINTER_INFO& pi);
     void handleMouseMove(Event& ev);
     void handleMouseLeave();
     void handlePointerButtonChange(Event& ev, POINTER_INFO& pi);
@@ -96,6 +111,9 @@ namespace os {
     void openWintabCtx();
     void closeWintabCtx();
 
+    void stopRenderThread();
+    void renderThreadProc();
+
     // Informs the taskbar that we are going (or exiting) the
     // fullscreen mode so it doesn't popup if it's hidden.
     void notifyFullScreenStateToShell();
@@ -243,6 +261,14 @@ namespace os {
     static std::vector<PACKET> m_packets;
     static Event m_lastWintabEvent;
 
+    // Render-thread mode (see setRenderThread()). The damage region
+    // is in physical pixels and is protected by m_renderMutex.
+    std::thread m_renderThread;
+    std::mutex m_renderMutex;
+    std::condition_variable m_renderCondVar;
+    gfx::Region m_renderDamage;
+    bool m_renderQuit = false;
+
     // Flags
     bool m_fullscreen;
     bool m_titled;
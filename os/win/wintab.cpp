@@ -378,14 +378,18 @@ bool WintabAPI::loadWintab()
     return false;
   }
 
-  WTInfo = base::get_dll_proc<WTInfoW_Func>(m_wintabLib, "WTInfoW");
-  WTOpen = base::get_dll_proc<WTOpenW_Func>(m_wintabLib, "WTOpenW");
-  WTClose = base::get_dll_proc<WTClose_Func>(m_wintabLib, "WTClose");
-  WTPacketsGet = base::get_dll_proc<WTPacketsGet_Func>(m_wintabLib, "WTPacketsGet");
-  WTPacket = base::get_dll_proc<WTPacket_Func>(m_wintabLib, "WTPacket");
-  WTOverlap = base::get_dll_proc<WTOverlap_Func>(m_wintabLib, "WTOverlap");
-  WTQueueSizeGet = base::get_dll_proc<WTQueueSizeGet_Func>(m_wintabLib, "WTQueueSizeGet");
-  WTQueueSizeSet = base::get_dll_proc<WTQueueSizeSet_Func>(m_wintabLib, "WTQueueSizeSet");
+  base::dll_proc_item procs[] = {
+    { "WTInfoW",        (base::dll_proc*)&WTInfo },
+    { "WTOpenW",        (base::dll_proc*)&WTOpen },
+    { "WTClose",        (base::dll_proc*)&WTClose },
+    { "WTPacketsGet",   (base::dll_proc*)&WTPacketsGet },
+    { "WTPacket",       (base::dll_proc*)&WTPacket },
+    { "WTOverlap",      (base::dll_proc*)&WTOverlap },
+    { "WTQueueSizeGet", (base::dll_proc*)&WTQueueSizeGet },
+    { "WTQueueSizeSet", (base::dll_proc*)&WTQueueSizeSet },
+  };
+  base::get_dll_procs(m_wintabLib, procs,
+                      sizeof(procs)/sizeof(procs[0]));
   if (!WTInfo || !WTOpen || !WTClose || !WTPacket ||
       !WTQueueSizeGet || !WTQueueSizeSet) {
     LOG(ERROR, "PEN: wintab32.dll does not contain all required functions\n");
@@ -10,13 +10,123 @@
 
 #include "os/window.h"
 
+#include "base/thread_pool.h"
+#include "base/time.h"
 #include "gfx/rect.h"
 #include "gfx/region.h"
+#include "os/common/window_event_queue.h"
 #include "os/event.h"
 #include "os/event_queue.h"
+#include "os/surface.h"
+#include "os/system.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace os {
 
+namespace {
+
+// Delivers Event::Frame ticks aligned to the display refresh period
+// for the windows that called requestFrame(). One shared thread
+// sleeps until the next frame boundary and queues one event per
+// requested window (requests are one-shot and duplicates are
+// collapsed), so animation loops don't render frames that never reach
+// the screen.
+//
+// TODO drive this clock with the real vblank source of each platform
+//      (CVDisplayLink on macOS, DWM on Windows, Present on X11)
+//      instead of a steady timer at the common 60Hz refresh rate.
+class FrameScheduler {
+public:
+  static FrameScheduler* instance() {
+    static FrameScheduler scheduler;
+    return &scheduler;
+  }
+
+  ~FrameScheduler() {
+    {
+      const std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  void requestFrame(Window* window) {
+    {
+      const std::lock_guard lock(m_mutex);
+      for (const WindowRef& other : m_requests) {
+        if (other.get() == window)
+          return;               // Already requested for the next frame
+      }
+      m_requests.push_back(AddRef(window));
+
+      // Start the thread lazily so programs that never call
+      // requestFrame() don't pay for it.
+      if (!m_thread.joinable())
+        m_thread = std::thread([this]{ run(); });
+    }
+    m_cv.notify_one();
+  }
+
+private:
+  void run() {
+    const base::tick_t start = base::current_tick();
+
+    std::unique_lock lock(m_mutex);
+    while (!m_stop) {
+      if (m_requests.empty()) {
+        m_cv.wait(lock, [this]{ return m_stop || !m_requests.empty(); });
+        continue;
+      }
+
+      // Sleep until the next frame boundary. A wakeup before the
+      // boundary (a new request) just loops to wait the remainder, so
+      // all the requests accumulated during the period are delivered
+      // in the same tick.
+      const base::tick_t now = base::current_tick();
+      const base::tick_t untilNext = kFramePeriod - ((now - start) % kFramePeriod);
+      m_cv.wait_for(lock, std::chrono::milliseconds(untilNext));
+      if (m_stop)
+        break;
+      if (base::current_tick() - now < untilNext)
+        continue;
+
+      std::vector<WindowRef> requests;
+      requests.swap(m_requests);
+
+      lock.unlock();
+      for (const WindowRef& window : requests) {
+        Event ev;
+        ev.setType(Event::Frame);
+        ev.setWindow(window);
+        queue_event(ev);
+      }
+      lock.lock();
+    }
+  }
+
+  // Display refresh period (60Hz).
+  static constexpr base::tick_t kFramePeriod = 1000 / 60;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::thread m_thread;
+  std::vector<WindowRef> m_requests;
+  bool m_stop = false;
+};
+
+} // anonymous namespace
+
+Window::~Window()
+{
+}
+
 gfx::Rect Window::bounds() const
 {
   return gfx::Rect(0, 0, width(), height());
@@ -27,6 +137,49 @@ void Window::invalidate()
   invalidateRegion(gfx::Region(bounds()));
 }
 
+void Window::invalidateRegion(const gfx::Region& rgn)
+{
+  if (m_batchInvalidations)
+    m_pendingInvalidations |= rgn;
+  else
+    onInvalidateRegion(rgn);
+}
+
+void Window::setBatchInvalidations(const bool batch)
+{
+  if (m_batchInvalidations == batch)
+    return;
+  m_batchInvalidations = batch;
+  if (!batch)
+    flushInvalidations();
+}
+
+void Window::flushInvalidations()
+{
+  if (m_pendingInvalidations.isEmpty())
+    return;
+  const gfx::Region rgn(std::move(m_pendingInvalidations));
+  onInvalidateRegion(rgn);
+}
+
+SurfaceRef Window::present(const SurfaceRef& surface)
+{
+  // Generic fallback: copy the rendered frame into the window
+  // surface (backends that can adopt the surface directly override
+  // this to skip the blit).
+  if (surface && surface.get() != this->surface()) {
+    surface->blitTo(this->surface(), 0, 0, 0, 0,
+                    surface->width(), surface->height());
+  }
+  invalidate();
+  return surface;
+}
+
+void Window::requestFrame()
+{
+  FrameScheduler::instance()->requestFrame(this);
+}
+
 gfx::Point Window::pointToScreen(const gfx::Point& clientPosition) const
 {
   gfx::Point res = clientPosition;
@@ -43,11 +196,49 @@ gfx::Point Window::pointFromScreen(const gfx::Point& screenPosition) const
   return res;
 }
 
+void Window::setVisibility(WindowVisibility visibility)
+{
+  if (m_visibility == visibility)
+    return;
+  m_visibility = visibility;
+
+  Event ev;
+  ev.setType(Event::VisibilityChange);
+  queueEvent(ev);
+}
+
 void Window::queueEvent(os::Event& ev)
 {
   onQueueEvent(ev);
 }
 
+EventQueue* Window::eventQueue() const
+{
+  return (m_eventQueue ? m_eventQueue.get():
+                         EventQueue::instance());
+}
+
+void Window::setUseDedicatedEventQueue(const bool state)
+{
+  if (state == bool(m_eventQueue))
+    return;
+
+  if (state) {
+    m_eventQueue = std::make_unique<WindowEventQueue>();
+  }
+  else {
+    // Move the still-queued events back to the global (merged) queue
+    Event ev;
+    while (true) {
+      m_eventQueue->getEvent(ev, 0.0);
+      if (ev.type() == Event::None)
+        break;
+      EventQueue::instance()->queueEvent(ev);
+    }
+    m_eventQueue.reset();
+  }
+}
+
 void Window::onQueueEvent(Event& ev)
 {
   // Some events are used more than one time (e.g. to send MouseEnter
@@ -58,7 +249,41 @@ void Window::onQueueEvent(Event& ev)
     ASSERT(ev.window().get() == this);
   }
 
-  os::queue_event(ev);
+  eventQueue()->queueEvent(ev);
+}
+
+void paint_windows_concurrently(
+  const std::vector<WindowRef>& windows,
+  std::vector<SurfaceRef>& buffers,
+  const std::function<void(Window*, Surface*)>& paintJob,
+  base::thread_pool& pool)
+{
+  buffers.resize(windows.size());
+
+  // Launch one render job per window, each into its own raster
+  // buffer so jobs never touch a window or each other's pixels.
+  for (size_t i=0; i<windows.size(); ++i) {
+    Window* window = windows[i].get();
+    const int w = window->surface()->width();
+    const int h = window->surface()->height();
+    if (!buffers[i] ||
+        buffers[i]->width() != w ||
+        buffers[i]->height() != h) {
+      buffers[i] = os::instance()->makeSurface(w, h, window->colorSpace());
+    }
+    Surface* buffer = buffers[i].get();
+    pool.execute([window, buffer, &paintJob]{
+      paintJob(window, buffer);
+    });
+  }
+  pool.wait_all();
+
+  // Presentation stays on the calling (event loop) thread: window
+  // backends are not thread-safe. Raster backends adopt the buffer
+  // as the new backing store and return the previous one, so the
+  // swap-chain keeps recycling the same two surfaces per window.
+  for (size_t i=0; i<windows.size(); ++i)
+    buffers[i] = windows[i]->present(buffers[i]);
 }
 
 } // namespace os
@@ -18,11 +18,17 @@
 #include "os/surface_list.h"
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #pragma push_macro("None")
 #undef None // Undefine the X11 None macro
 
+namespace base {
+  class thread_pool;
+}
+
 #if LAF_SKIA && SK_SUPPORT_GPU
 class GrDirectContext;
 #endif
@@ -30,6 +36,7 @@ class GrDirectContext;
 namespace os {
 
   class Event;
+  class EventQueue;
   class Surface;
   class Window;
   using WindowRef = Ref<Window>;
@@ -47,6 +54,14 @@ namespace os {
     ResizeFromBottomRight,
   };
 
+  // How much of the window content can be seen on the screen. See
+  // os::Window::visibility.
+  enum class WindowVisibility {
+    Visible,    // At least a part of the window is on the screen
+    Occluded,   // Completely covered by other windows
+    Minimized,  // Iconified or hidden
+  };
+
   // Possible areas for hit testing. See os::Window::handleHitTest.
   enum class Hit {
     None,
@@ -70,7 +85,7 @@ namespace os {
   public:
     typedef void* NativeHandle;
 
-    virtual ~Window() { }
+    virtual ~Window();
 
     // Real rectangle of this window (including title bar, etc.) in
     // the screen. (The scale is not involved.)
@@ -105,6 +120,16 @@ namespace os {
     // Returns true if the window is visible in the screen.
     virtual bool isVisible() const = 0;
 
+    // Current visibility of the window content as reported by the OS
+    // (NSWindowOcclusionState, X11 VisibilityNotify, minimization).
+    // Occluded/Minimized windows can skip rendering entirely: an
+    // Event::VisibilityChange is queued each time this value changes.
+    WindowVisibility visibility() const { return m_visibility; }
+
+    // Used by the backends to report the new visibility state
+    // (queues the Event::VisibilityChange if it changed).
+    void setVisibility(WindowVisibility visibility);
+
     // Shows or hides the window (doesn't destroy it).
     virtual void setVisible(bool visible) = 0;
 
@@ -114,13 +139,60 @@ namespace os {
     // Invalidates part of the window to be redraw in the future by
     // the OS painting messages. The region must be in non-scaled
     // coordinates.
-    virtual void invalidateRegion(const gfx::Region& rgn) = 0;
+    // Invalidates the given region (in client coordinates) so the
+    // backend repaints/presents it. With setBatchInvalidations(true)
+    // the regions just accumulate and flushInvalidations() sends the
+    // union with one platform call, so a widget tree invalidating
+    // dozens of rects per frame doesn't pay one InvalidateRgn (or
+    // equivalent) round-trip each.
+    void invalidateRegion(const gfx::Region& rgn);
     void invalidate();
 
+    // Turning batching off flushes what is pending.
+    void setBatchInvalidations(bool batch);
+
+    // Sends the accumulated region (if any) to the backend. Call it
+    // once per event-loop turn (e.g. after dispatching the frame).
+    void flushInvalidations();
+
+    // Swap-chain style presentation: makes the given surface (which
+    // must have the same size as surface()) the content shown by the
+    // window and invalidates it, returning the surface to render the
+    // next frame into. Backends that can adopt the surface directly
+    // (raster Skia windows) swap it in as the new backing store
+    // without any pixel copy and return the previous one, so
+    // ping-ponging between the passed and returned surfaces gives
+    // double buffering without the final full-frame blit. The
+    // default implementation copies into surface() and returns the
+    // same surface, so callers work unchanged on other backends.
+    virtual SurfaceRef present(const SurfaceRef& surface);
+
+    // Requests one Event::Frame for this window aligned with the
+    // display refresh, delivered through the os::EventQueue. The
+    // request is one-shot: call it again from the Frame event handler
+    // to get a continuous animation loop that doesn't render frames
+    // faster than the display can show them.
+    virtual void requestFrame();
+
     // GPU-related functions
     virtual bool isGpuAccelerated() const = 0;
     virtual void swapBuffers() = 0;
 
+    // Timing of the last GPU-presented frame, measured with GL timer
+    // queries: CPU-side timers stop at submit, so this is the only
+    // way to tell GPU-bound from CPU-bound frames. gpuMsecs is
+    // harvested asynchronously and refers to a frame a few
+    // swapBuffers() back; it stays negative while no result is
+    // available (software backend, or timer queries unsupported).
+    struct GpuFrameTiming {
+      double gpuMsecs = -1.0;   // GPU time of one frame
+      double syncMsecs = 0.0;   // CPU stall in flush+swap of the last
+                                // frame
+    };
+    virtual GpuFrameTiming gpuFrameTiming() const {
+      return GpuFrameTiming();
+    }
+
     // Focus the window to receive the keyboard input by default.
     virtual void activate() = 0;
     virtual void maximize() = 0;
@@ -159,6 +231,22 @@ namespace os {
     // this window if it's not set).
     void queueEvent(os::Event& ev);
 
+    // Queue that receives this window's events: the global
+    // EventQueue::instance() by default (all windows merged in one
+    // consumer), or a dedicated per-window queue after
+    // setUseDedicatedEventQueue(true).
+    EventQueue* eventQueue() const;
+
+    // Routes this window's events to a dedicated queue consumed
+    // through eventQueue()->getEvent(), so a thread per window can
+    // run its own event loop and a slow handler in one window doesn't
+    // delay the input of the others. Windows that don't opt in keep
+    // sharing the global queue as before (the merged view). Disabling
+    // it moves the still-queued events back to the global queue; do
+    // that before dropping the last WindowRef (queued events keep a
+    // reference to the window).
+    void setUseDedicatedEventQueue(bool state);
+
     // Performs the user action to move or resize the window. It's
     // useful in case that you want to design your own regions to
     // resize or move/drag the window.
@@ -207,10 +295,36 @@ namespace os {
   protected:
     virtual void onQueueEvent(Event& ev);
 
+    // Platform-specific invalidation (called by invalidateRegion()
+    // directly, or by flushInvalidations() with the accumulated
+    // region when batching is enabled).
+    virtual void onInvalidateRegion(const gfx::Region& rgn) = 0;
+
   private:
     void* m_userData;
+    std::unique_ptr<EventQueue> m_eventQueue; // Dedicated queue (or nullptr)
+    WindowVisibility m_visibility = WindowVisibility::Visible;
+    bool m_batchInvalidations = false;
+    gfx::Region m_pendingInvalidations;
   };
 
+  // Renders several windows in parallel and presents them serially.
+  // For each window the paint job is executed on the given thread
+  // pool with a raster buffer of the window client size (buffers[i]
+  // is reused between frames when the size still matches, allocated
+  // with the window color space otherwise); jobs must draw only into
+  // the buffer they receive. When all jobs finished, each buffer is
+  // presented with Window::present() from the calling thread (window
+  // backends are not thread-safe), replacing buffers[i] with the
+  // returned surface for the next frame. So a multi-window frame
+  // costs max(render) plus the presentations instead of the sum of
+  // every render.
+  void paint_windows_concurrently(
+    const std::vector<WindowRef>& windows,
+    std::vector<SurfaceRef>& buffers,
+    const std::function<void(Window*, Surface*)>& paintJob,
+    base::thread_pool& pool);
+
 } // namespace os
 
 #pragma pop_macro("None")
@@ -26,6 +26,15 @@ namespace os {
       Center,
     };
 
+    // GPU API used to present the window when GPU acceleration is
+    // enabled (ignored for raster windows).
+    enum class GpuBackend {
+      Default,       // Fast path of each platform: Metal on macOS, OpenGL elsewhere
+      OpenGL,        // WGL/GLX/NSGL context
+      Metal,         // CAMetalLayer presentation (macOS only)
+      Angle,         // Direct3D 11 through ANGLE's EGL (Windows only, not implemented yet, falls back to OpenGL)
+    };
+
     WindowSpec() {
     }
 
@@ -35,6 +44,7 @@ namespace os {
     }
 
     Position position() const { return m_position; }
+    GpuBackend gpuBackend() const { return m_gpuBackend; }
     bool titled() const { return m_titled; }
     bool borderless() const { return m_borderless; }
     bool closable() const { return m_closable; }
@@ -48,6 +58,7 @@ namespace os {
     Window* parent() const { return m_parent; }
 
     void position(const Position p) { m_position = p; }
+    void gpuBackend(const GpuBackend b) { m_gpuBackend = b; }
     void titled(const bool s) { m_titled = s; }
     void borderless(const bool s) { m_borderless = s; }
     void closable(const bool s) { m_closable = s; }
@@ -70,6 +81,7 @@ namespace os {
 
   private:
     Position m_position = Position::Default;
+    GpuBackend m_gpuBackend = GpuBackend::Default;
     bool m_titled = true;
     bool m_borderless = false;
     bool m_closable = true;
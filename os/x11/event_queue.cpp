@@ -12,11 +12,18 @@
 #include "os/x11/event_queue.h"
 
 #include "base/thread.h"
+#include "os/common/system.h"
+#include "os/x11/keys.h"
 #include "os/x11/window.h"
 
 #include <X11/Xlib.h>
 
-#include <sys/select.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <vector>
 
 #define EV_TRACE(...)
 
@@ -67,26 +74,86 @@ const char* get_event_name(XEvent& event)
 }
 #endif
 
-void wait_file_descriptor_for_reading(int fd, base::tick_t timeoutMilliseconds)
+} // anonymous namespace
+
+EventQueueX11::EventQueueX11()
 {
-  fd_set fds;
-  FD_ZERO(&fds);
-  FD_SET(fd, &fds);
+  m_wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
 
-  timeval timeout;
-  timeout.tv_sec = timeoutMilliseconds / 1000;
-  timeout.tv_usec = ((timeoutMilliseconds % 1000) * 1000);
+EventQueueX11::~EventQueueX11()
+{
+  for (const auto& [timerId, fd] : m_timers)
+    close(fd);
 
-  // First argument must be set to the highest-numbered file
-  // descriptor in any of the three sets, plus 1.
-  select(fd+1, &fds, nullptr, nullptr, &timeout);
+  if (m_wakeupFd >= 0)
+    close(m_wakeupFd);
 }
 
-} // anonymous namespace
+void EventQueueX11::addTimer(int intervalMsecs, int timerId)
+{
+  removeTimer(timerId);
+
+  const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd < 0)
+    return;
+
+  itimerspec spec;
+  spec.it_interval.tv_sec = intervalMsecs / 1000;
+  spec.it_interval.tv_nsec = (intervalMsecs % 1000) * 1000000;
+  spec.it_value = spec.it_interval;
+  timerfd_settime(fd, 0, &spec, nullptr);
+
+  m_timers[timerId] = fd;
+}
+
+void EventQueueX11::removeTimer(int timerId)
+{
+  auto it = m_timers.find(timerId);
+  if (it != m_timers.end()) {
+    close(it->second);
+    m_timers.erase(it);
+  }
+}
+
+void EventQueueX11::checkTimers()
+{
+  for (const auto& [timerId, fd] : m_timers) {
+    uint64_t expirations = 0;
+    if (read(fd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+        expirations > 0) {
+      // Several missed expirations coalesce into one Timer event.
+      Event ev;
+      ev.setType(Event::Timer);
+      ev.setTimerId(timerId);
+      queueEvent(ev);
+    }
+  }
+}
 
 void EventQueueX11::queueEvent(const Event& ev)
 {
+  if (filterEvent(ev))
+    return;
+
   m_events.push(ev);
+
+  // Wake up a getEvent() blocked on poll() (e.g. when this event was
+  // queued from a background thread and there is no X11 traffic).
+  if (m_waiting)
+    wakeUp();
+}
+
+void EventQueueX11::wakeUp()
+{
+  if (m_wakeupFd >= 0) {
+    const uint64_t counter = 1;
+    if (write(m_wakeupFd, &counter, sizeof(counter)) < 0) {
+      // The write can only fail if the eventfd counter is about to
+      // overflow, in which case the getEvent() thread is already
+      // awake anyway.
+    }
+  }
 }
 
 void EventQueueX11::getEvent(Event& ev, double timeout)
@@ -96,34 +163,68 @@ void EventQueueX11::getEvent(Event& ev, double timeout)
   ev.setWindow(nullptr);
 
   ::Display* display = X11::instance()->display();
-  XSync(display, False);
 
+  // XPending() flushes the output buffer and reads everything already
+  // available in the connection, without the per-call round-trip to
+  // the server that XSync() implied here before.
   XEvent event;
-  int events = XEventsQueued(display, QueuedAlready);
-  if (events == 0) {
-    if (timeout == kWithoutTimeout) {
-      // Wait for a XEvent only if we have an empty queue of os::Event
-      // (so there is no more events to process in our own queue).
-      if (m_events.empty())
-        events = 1;
-      else
-        events = 0;
-    }
-    else if (timeout > 0.0) {
-      // Wait timeout (waiting the X11 connection file description for
-      // a read operation). We've to use this method to wait for
-      // events with timeout because we don't have a X11 function like
-      // XNextEvent() with a timeout.
+  int events = XPending(display);
+
+  // Convert already-expired timers into Timer events even when there
+  // is X11 traffic keeping us out of the poll() below.
+  checkTimers();
+
+  if (events == 0 && isEmpty() && timeout != 0.0) {
+    // Nothing to process: block on the X connection fd (and the
+    // eventfd used by queueEvent() wakeups) until there is traffic or
+    // the timeout expires, instead of waking up periodically.
+    int waitMsecs;
+    if (timeout == kWithoutTimeout)
+      waitMsecs = -1;           // Wait forever
+    else {
       const base::tick_t timeoutMsecs = base::tick_t(timeout * 1000.0);
       const base::tick_t elapsedMsecs = base::current_tick() - startTime;
-      if (int(timeoutMsecs - elapsedMsecs) > 0) {
-        const int connFileDesc = ConnectionNumber(display);
-        wait_file_descriptor_for_reading(connFileDesc,
-                                         timeoutMsecs - elapsedMsecs);
+      waitMsecs = (timeoutMsecs > elapsedMsecs ?
+                   int(timeoutMsecs - elapsedMsecs): 0);
+    }
+
+    m_waiting = true;
+    // Re-check for events queued just before setting m_waiting (a
+    // producer that saw m_waiting == false doesn't write the eventfd).
+    if (isEmpty()) {
+      std::vector<pollfd> fds(2 + m_timers.size());
+      fds[0].fd = ConnectionNumber(display);
+      fds[0].events = POLLIN;
+      fds[0].revents = 0;
+      fds[1].fd = m_wakeupFd;   // poll() ignores fds < 0
+      fds[1].events = POLLIN;
+      fds[1].revents = 0;
+      int i = 2;
+      for (const auto& [timerId, fd] : m_timers) {
+        fds[i].fd = fd;
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+        ++i;
+      }
+      poll(fds.data(), nfds_t(fds.size()), waitMsecs);
+
+      if (fds[1].revents & POLLIN) {
+        // Consume the wakeup counter
+        uint64_t counter = 0;
+        if (read(m_wakeupFd, &counter, sizeof(counter)) < 0) {
+          // Non-blocking read, EAGAIN if the counter was already
+          // consumed.
+        }
       }
 
-      events = XEventsQueued(display, QueuedAlready);
+      // Convert the timerfds that woke us up into Timer events
+      checkTimers();
     }
+    m_waiting = false;
+
+    // Drain all the XEvents that arrived while we were waiting in one
+    // batch.
+    events = XPending(display);
   }
 
   // If the user is not converting dead keys it means that we are not
@@ -165,7 +266,7 @@ void EventQueueX11::getEvent(Event& ev, double timeout)
     }
   }
 
-  if (!m_events.try_pop(ev)) {
+  if (!popEvent(m_events, ev)) {
 #pragma push_macro("None")
 #undef None // Undefine the X11 None macro
     ev.setType(Event::None);
@@ -175,9 +276,15 @@ void EventQueueX11::getEvent(Event& ev, double timeout)
 
 void EventQueueX11::clearEvents()
 {
+  clearPendingEvent();
   m_events.clear();
 }
 
+void EventQueueX11::discardIf(const EventFilter& pred)
+{
+  discardEvents(m_events, pred);
+}
+
 void EventQueueX11::processX11Event(XEvent& event)
 {
   EV_TRACE("XEvent: %s (%d)\n", get_event_name(event), event.type);
@@ -186,6 +293,22 @@ void EventQueueX11::processX11Event(XEvent& event)
   // In MappingNotify the window can be nullptr
   if (window)
     window->processX11Event(event);
+  else if (event.type == ConfigureNotify) {
+    // A ConfigureNotify without a WindowX11 comes from the root
+    // window (we selected StructureNotifyMask on it in the X11
+    // ctor): the screen resolution/topology changed.
+    if (auto* sys = dynamic_cast<CommonSystem*>(os::instance()))
+      sys->invalidateScreens();
+  }
+  else if (event.type == MappingNotify) {
+    // The keyboard layout changed: update the Xlib client-side
+    // mapping table and our cached key translation tables.
+    if (event.xmapping.request == MappingKeyboard ||
+        event.xmapping.request == MappingModifier) {
+      XRefreshKeyboardMapping(&event.xmapping);
+      x11_refresh_keyboard_mapping();
+    }
+  }
 }
 
 } // namespace os
@@ -14,22 +14,44 @@
 #include "os/event_queue.h"
 #include "os/x11/x11.h"
 
+#include <atomic>
 #include <deque>
+#include <map>
 
 namespace os {
 
 class EventQueueX11 : public EventQueue {
 public:
+  EventQueueX11();
+  ~EventQueueX11();
+
   void queueEvent(const Event& ev) override;
   void getEvent(Event& ev, double timeout) override;
   void clearEvents() override;
+  void discardIf(const EventFilter& pred) override;
+  void addTimer(int intervalMsecs, int timerId) override;
+  void removeTimer(int timerId) override;
 
-  bool isEmpty() const { return m_events.empty(); }
+  bool isEmpty() const { return !hasPendingEvent() && m_events.empty(); }
 
 private:
   void processX11Event(XEvent& event);
-
-  base::concurrent_queue<Event> m_events;
+  void wakeUp();
+  void checkTimers();
+
+  // Lock-free ring so the hot queueEvent()/getEvent() path costs a
+  // couple of atomics per event instead of a mutex round-trip. When
+  // the ring is full push() applies backpressure.
+  base::concurrent_queue<Event, base::queue_policy::lock_free> m_events{1024};
+
+  // eventfd written by queueEvent() to wake up a getEvent() call
+  // blocked on poll() when events are queued from other threads.
+  int m_wakeupFd = -1;
+  std::atomic<bool> m_waiting{false};
+
+  // Timers registered with addTimer() (timer id -> timerfd), polled
+  // together with the X connection fd in getEvent().
+  std::map<int, int> m_timers;
 };
 
 using EventQueueImpl = EventQueueX11;
@@ -19,8 +19,13 @@ namespace os {
   KeyScancode x11_keysym_to_scancode(KeySym keysym);
   KeySym x11_keysym_to_scancode(KeyScancode scancode);
   bool x11_is_key_pressed(KeyScancode scancode);
+  KeyStates x11_key_states();
   int x11_get_unicode_from_scancode(KeyScancode scancode);
 
+  // Called when the keyboard layout changes (MappingNotify) to
+  // invalidate the cached translation tables.
+  void x11_refresh_keyboard_mapping();
+
   KeyModifiers get_modifiers_from_x(int xeventState);
 
 } // namespace os
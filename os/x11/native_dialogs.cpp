@@ -20,6 +20,8 @@
 
 #include <cstdio>              // popen/pclose()
 #include <cstring>
+#include <mutex>
+#include <thread>
 
 namespace os {
 
@@ -205,7 +207,10 @@ public:
   }
 
   static bool AreCLIToolsAvailable() {
-    if (s_cliTool == CLITool::Unknown) {
+    // call_once() so the detection can also run from the
+    // NativeDialogsX11::preloadFileDialog() background thread.
+    static std::once_flag once;
+    std::call_once(once, [] {
       FILE* f = popen("zenity --version", "r");
       if (f && pclose(f) == 0) {
         s_cliTool = CLITool::Zenity;
@@ -217,7 +222,7 @@ public:
         else
           s_cliTool = CLITool::NotFound;
       }
-    }
+    });
     return (s_cliTool > CLITool::NotFound);
   }
 
@@ -242,4 +247,11 @@ FileDialogRef NativeDialogsX11::makeFileDialog()
   return nullptr;
 }
 
+void NativeDialogsX11::preloadFileDialog()
+{
+  // The first makeFileDialog() pays a couple of popen() calls to
+  // detect zenity/kdialog, run the detection at idle instead.
+  std::thread([]{ FileDialogX11::AreCLIToolsAvailable(); }).detach();
+}
+
 } // namespace os
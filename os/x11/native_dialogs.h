@@ -16,6 +16,7 @@ namespace os {
   public:
     NativeDialogsX11();
     FileDialogRef makeFileDialog() override;
+    void preloadFileDialog() override;
   };
 
 } // namespace os
@@ -10,6 +10,7 @@
 
 #include "os/x11/system.h"
 
+#include "os/common/surface_format_convert.h"
 #include "os/x11/cursor.h"
 
 #include <X11/Xcursor/Xcursor.h>
@@ -17,6 +18,7 @@
 
 #include <algorithm>
 #include <array>
+#include <vector>
 
 namespace os {
 
@@ -135,7 +137,7 @@ CursorRef SystemX11::getNativeCursor(NativeCursor cursor)
   return g_nativeCursors[i] = make_ref<CursorX11>(xcursor);
 }
 
-CursorRef SystemX11::makeCursor(const Surface* surface,
+CursorRef SystemX11::onMakeCursor(const Surface* surface,
                                 const gfx::Point& focus,
                                 const int scale)
 {
@@ -159,21 +161,21 @@ CursorRef SystemX11::makeCursor(const Surface* surface,
   ::Cursor xcursor = None;
   ::XcursorImage* image = g_cachedCursorImage.recreate(w, h);
   if (image != None) {
+    // Convert each source row once (the converter resolves the
+    // layouts up front) and then just replicate pixels for the scale.
+    const SurfaceFormatConverter convert(format, argb_format_data());
+    std::vector<uint32_t> row(surface->width());
     XcursorPixel* dst = image->pixels;
+    int lastSrcY = -1;
     for (int y=0; y<h; ++y) {
-      const uint32_t* src = (const uint32_t*)surface->getData(0, y/scale);
-      for (int x=0, u=0; x<w; ++x, ++dst) {
-        const uint32_t c = *src;
-        *dst =
-          (((c & format.alphaMask) >> format.alphaShift) << 24) |
-          (((c & format.redMask  ) >> format.redShift  ) << 16) |
-          (((c & format.greenMask) >> format.greenShift) << 8) |
-          (((c & format.blueMask ) >> format.blueShift ));
-        if (++u == scale) {
-          u = 0;
-          ++src;
-        }
+      const int srcY = y/scale;
+      if (srcY != lastSrcY) {
+        convert(row.data(), (const uint32_t*)surface->getData(0, srcY),
+                surface->width());
+        lastSrcY = srcY;
       }
+      for (int x=0; x<w; ++x, ++dst)
+        *dst = row[x/scale];
     }
 
     // We have to limit the focus position inside the cursor area to
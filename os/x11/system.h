@@ -26,13 +26,17 @@ public:
     return x11_is_key_pressed(scancode);
   }
 
+  KeyStates keyStates() override {
+    return x11_key_states();
+  }
+
   int getUnicodeFromScancode(KeyScancode scancode) override {
     return x11_get_unicode_from_scancode(scancode);
   }
 
   CursorRef getNativeCursor(NativeCursor cursor);
 
-  CursorRef makeCursor(const Surface* surface,
+  CursorRef onMakeCursor(const Surface* surface,
                        const gfx::Point& focus,
                        const int scale) override;
 
@@ -73,12 +77,12 @@ public:
     return gfx::ColorNone;
   }
 
-  ScreenRef mainScreen() override {
+  ScreenRef onMainScreen() override {
     return make_ref<ScreenX11>(
       XDefaultScreen(X11::instance()->display()));
   }
 
-  void listScreens(ScreenList& list) override {
+  void onListScreens(ScreenList& list) override {
     const int nscreen = XScreenCount(X11::instance()->display());
     for (int screen=0; screen<nscreen; screen++)
       list.push_back(make_ref<ScreenX11>(screen));
@@ -20,6 +20,7 @@
 #include "gfx/border.h"
 #include "gfx/rect.h"
 #include "gfx/region.h"
+#include "os/common/surface_format_convert.h"
 #include "os/event.h"
 #include "os/event_queue.h"
 #include "os/surface.h"
@@ -260,7 +261,7 @@ WindowX11::WindowX11(::Display* display, const WindowSpec& spec)
   swa.event_mask = (StructureNotifyMask | ExposureMask | PropertyChangeMask |
                     EnterWindowMask | LeaveWindowMask | FocusChangeMask |
                     ButtonPressMask | ButtonReleaseMask | PointerMotionMask |
-                    KeyPressMask | KeyReleaseMask);
+                    KeyPressMask | KeyReleaseMask | VisibilityChangeMask);
   if (m_transparent) {
     // If one of these attributes is not specified, XCreateWindow()
     // will crash/fail with a BadMatch error.
@@ -631,20 +632,17 @@ void WindowX11::setIcons(const SurfaceList& icons)
     SurfaceFormatData format;
     icon->getFormat(&format);
 
+    const SurfaceFormatConverter convert(format, argb_format_data());
+    std::vector<uint32_t> row(w);
+
     std::vector<unsigned long> data(w*h+2);
     int i = 0;
     data[i++] = w;
     data[i++] = h;
     for (int y=0; y<h; ++y) {
-      const uint32_t* p = (const uint32_t*)icon->getData(0, y);
-      for (int x=0; x<w; ++x, ++p) {
-        const uint32_t c = *p;
-        data[i++] =
-          (((c & format.blueMask ) >> format.blueShift )      ) |
-          (((c & format.greenMask) >> format.greenShift) <<  8) |
-          (((c & format.redMask  ) >> format.redShift  ) << 16) |
-          (((c & format.alphaMask) >> format.alphaShift) << 24);
-      }
+      convert(row.data(), (const uint32_t*)icon->getData(0, y), w);
+      for (int x=0; x<w; ++x)
+        data[i++] = row[x];
     }
 
     const Atom _NET_WM_ICON = XInternAtom(m_display, "_NET_WM_ICON", False);
@@ -752,13 +750,17 @@ void WindowX11::setMousePosition(const gfx::Point& position)
                position.x*m_scale, position.y*m_scale);
 }
 
-void WindowX11::invalidateRegion(const gfx::Region& rgn)
+void WindowX11::onInvalidateRegion(const gfx::Region& rgn)
 {
-  const gfx::Rect bounds = rgn.bounds();
-  onPaint(gfx::Rect(bounds.x*m_scale,
-                    bounds.y*m_scale,
-                    bounds.w*m_scale,
-                    bounds.h*m_scale));
+  // Present each rectangle of the region instead of its bounds (two
+  // small distant rects would otherwise re-upload almost the whole
+  // window).
+  for (const gfx::Rect& rc : rgn) {
+    onPaint(gfx::Rect(rc.x*m_scale,
+                      rc.y*m_scale,
+                      rc.w*m_scale,
+                      rc.h*m_scale));
+  }
 }
 
 bool WindowX11::setCursor(NativeCursor nativeCursor)
@@ -996,6 +998,12 @@ void WindowX11::getX11FrameExtents()
 void WindowX11::processX11Event(XEvent& event)
 {
   auto* xinput = X11::instance()->xinput();
+  if (xinput->handlePresenceEvent(event)) {
+    // A device was plugged/unplugged: refresh the cached device list
+    // and the extension events selected on this window.
+    xinput->selectExtensionEvents(m_display, m_window);
+    return;
+  }
   if (xinput->handleExtensionEvent(event)) {
     Event ev;
     xinput->convertExtensionEvent(event, ev, m_scale,
@@ -1024,6 +1032,25 @@ void WindowX11::processX11Event(XEvent& event)
       break;
     }
 
+    case VisibilityNotify:
+      // The X server tells us when the window gets completely
+      // covered by other windows, so callers can skip rendering
+      // frames that nobody would see.
+      setVisibility(event.xvisibility.state == VisibilityFullyObscured ?
+                      WindowVisibility::Occluded:
+                      WindowVisibility::Visible);
+      break;
+
+    case MapNotify:
+      setVisibility(WindowVisibility::Visible);
+      break;
+
+    case UnmapNotify:
+      // The window was iconified (or hidden), there is nothing to
+      // paint until the next MapNotify.
+      setVisibility(WindowVisibility::Minimized);
+      break;
+
     case KeyPress:
     case KeyRelease: {
       Event ev;
@@ -71,7 +71,7 @@ public:
   void captureMouse() override;
   void releaseMouse() override;
   void setMousePosition(const gfx::Point& position) override;
-  void invalidateRegion(const gfx::Region& rgn) override;
+  void onInvalidateRegion(const gfx::Region& rgn) override;
   bool setCursor(NativeCursor cursor) override;
   bool setCursor(const CursorRef& cursor) override;
 
@@ -40,6 +40,14 @@ X11::X11()
 
   m_display = XOpenDisplay(nullptr);
   m_xim = XOpenIM(m_display, nullptr, nullptr, nullptr);
+
+  if (m_display) {
+    // Ask for ConfigureNotify events on the root window, which the
+    // server sends when the screen resolution/topology changes (used
+    // to refresh the cached System::listScreens()).
+    XSelectInput(m_display, XDefaultRootWindow(m_display),
+                 StructureNotifyMask);
+  }
 }
 
 X11::~X11()
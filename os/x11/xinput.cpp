@@ -54,6 +54,11 @@ void XInput::load(::Display* display)
   XOpenDevice = base::get_dll_proc<XOpenDevice_Func>(m_xi, "XOpenDevice");
   XCloseDevice = base::get_dll_proc<XCloseDevice_Func>(m_xi, "XCloseDevice");
   XSelectExtensionEvent = base::get_dll_proc<XSelectExtensionEvent_Func>(m_xi, "XSelectExtensionEvent");
+  // Optional, only needed for the motion history of MouseMove events.
+  XGetDeviceMotionEvents = base::get_dll_proc<XGetDeviceMotionEvents_Func>(m_xi, "XGetDeviceMotionEvents");
+  XFreeDeviceMotionEvents = base::get_dll_proc<XFreeDeviceMotionEvents_Func>(m_xi, "XFreeDeviceMotionEvents");
+  // Optional, only needed to detect plugged/unplugged devices.
+  XiGetDevicePresenceNotifyEvent = base::get_dll_proc<XiGetDevicePresenceNotifyEvent_Func>(m_xi, "_XiGetDevicePresenceNotifyEvent");
 
   if (!XListInputDevices ||
       !XFreeDeviceList ||
@@ -67,6 +72,31 @@ void XInput::load(::Display* display)
     return;
   }
 
+  // Expansion of the DevicePresence() macro, which calls
+  // _XiGetDevicePresenceNotifyEvent() directly (we load it
+  // dynamically).
+  if (XiGetDevicePresenceNotifyEvent) {
+    m_presenceEventType = XiGetDevicePresenceNotifyEvent(display);
+    m_presenceEventClass = XEventClass(0x10000 | _devicePresence);
+  }
+
+  // The device enumeration itself is deferred to the first
+  // selectExtensionEvents() call (see ensureDevices()).
+}
+
+void XInput::ensureDevices(::Display* display)
+{
+  if (!m_xi || m_devicesScanned)
+    return;
+  m_devicesScanned = true;
+
+  // Rescan after a presence event: drop the previous device handles
+  // and capabilities.
+  closeDevices(display);
+  m_info.clear();
+  m_eventClasses.clear();
+  m_eventTypes.clear();
+
   int ndevices = 0;
   auto* devices = XListInputDevices(display, &ndevices);
   if (!devices)
@@ -122,10 +152,15 @@ void XInput::load(::Display* display)
       info.pointerType = pointerType;
       info.minPressure = valuator->axes[2].min_value;
       info.maxPressure = valuator->axes[2].max_value;
+      info.minX = valuator->axes[0].min_value;
+      info.maxX = valuator->axes[0].max_value;
+      info.minY = valuator->axes[1].min_value;
+      info.maxY = valuator->axes[1].max_value;
 
       XDevice* device = XOpenDevice(display, devInfo->id);
       if (!device)
         continue;
+      info.device = device;
 
       XEventClass eventClass;
       int eventType;
@@ -152,6 +187,11 @@ void XInput::unload(::Display* display)
   if (!m_xi)
     return;
 
+  closeDevices(display);
+}
+
+void XInput::closeDevices(::Display* display)
+{
   for (XDevice* dev : m_openDevices)
     XCloseDevice(display, dev);
   m_openDevices.clear();
@@ -162,10 +202,18 @@ void XInput::selectExtensionEvents(::Display* display, ::Window window)
   if (!m_xi)
     return;
 
+  ensureDevices(display);
+
+  std::vector<XEventClass> eventClasses = m_eventClasses;
+  if (m_presenceEventClass)
+    eventClasses.push_back(m_presenceEventClass);
+  if (eventClasses.empty())
+    return;
+
   ASSERT(XSelectExtensionEvent);
   XSelectExtensionEvent(display, window,
-                        m_eventClasses.data(),
-                        int(m_eventClasses.size()));
+                        eventClasses.data(),
+                        int(eventClasses.size()));
 }
 
 bool XInput::handleExtensionEvent(const XEvent& xevent)
@@ -175,6 +223,22 @@ bool XInput::handleExtensionEvent(const XEvent& xevent)
           m_eventTypes[xevent.type] != Event::None);
 }
 
+bool XInput::handlePresenceEvent(const XEvent& xevent)
+{
+  if (!m_xi ||
+      !m_presenceEventType ||
+      xevent.type != m_presenceEventType)
+    return false;
+
+  // Each window receives its own copy of this notification, only the
+  // first one invalidates the cache.
+  if (xevent.xany.serial != m_lastPresenceSerial) {
+    m_lastPresenceSerial = xevent.xany.serial;
+    m_devicesScanned = false;
+  }
+  return true;
+}
+
 void XInput::convertExtensionEvent(const XEvent& xevent,
                                    Event& ev,
                                    int scale,
@@ -233,6 +297,79 @@ void XInput::convertExtensionEvent(const XEvent& xevent,
     }
     ev.setPointerType(info.pointerType);
   }
+
+  if (ev.type() == Event::MouseMove)
+    attachMotionHistory(xevent, ev, scale);
+}
+
+void XInput::attachMotionHistory(const XEvent& xevent, Event& ev, int scale)
+{
+  if (!XGetDeviceMotionEvents || !XFreeDeviceMotionEvents)
+    return;
+
+  const auto* motion = (const XDeviceMotionEvent*)&xevent;
+  auto it = m_info.find(motion->deviceid);
+  if (it == m_info.end())
+    return;
+
+  Info& info = it->second;
+  const Time lastTime = info.lastMotionTime;
+  info.lastMotionTime = motion->time;
+
+  // Query the history only for continuous motion (inside one stroke),
+  // and when we know the axis ranges to map device coordinates.
+  if (!info.device ||
+      lastTime == 0 ||
+      lastTime >= motion->time ||
+      motion->time - lastTime > 500 ||
+      info.maxX <= info.minX ||
+      info.maxY <= info.minY)
+    return;
+
+  int nEvents = 0;
+  int mode;
+  int axisCount = 0;
+  XDeviceTimeCoord* coords =
+    XGetDeviceMotionEvents(motion->display, info.device,
+                           lastTime+1, motion->time-1,
+                           &nEvents, &mode, &axisCount);
+  if (!coords)
+    return;
+
+  if (axisCount >= 3) {
+    // Absolute tablets map the whole axis range to the whole screen
+    // (root coordinates); this event is the anchor to convert root
+    // coordinates to window coordinates.
+    ::Display* display = motion->display;
+    const int screenW = DisplayWidth(display, DefaultScreen(display));
+    const int screenH = DisplayHeight(display, DefaultScreen(display));
+    const int winDx = motion->x - motion->x_root;
+    const int winDy = motion->y - motion->y_root;
+
+    for (int i=0; i<nEvents; ++i) {
+      const XDeviceTimeCoord& c = coords[i];
+
+      Event::PointerSample sample;
+      sample.position.x =
+        ((c.data[0] - info.minX) * screenW /
+         (info.maxX - info.minX) + winDx) / scale;
+      sample.position.y =
+        ((c.data[1] - info.minY) * screenH /
+         (info.maxY - info.minY) + winDy) / scale;
+      if (info.minPressure != info.maxPressure) {
+        sample.pressure =
+          float(c.data[2] - info.minPressure) /
+          float(info.maxPressure - info.minPressure);
+      }
+      // Both clocks count milliseconds, so we can re-anchor the X
+      // server time of the sample to the event timestamp epoch.
+      sample.tick = ev.timestamp() - (motion->time - c.time);
+
+      ev.addHistorySample(sample);
+    }
+  }
+
+  XFreeDeviceMotionEvents(coords);
 }
 
 void XInput::addEvent(int type, XEventClass eventClass, Event::Type ourEventype)
@@ -29,12 +29,18 @@ class XInput {
   typedef XDevice* (*XOpenDevice_Func)(::Display*, XID);
   typedef int (*XCloseDevice_Func)(::Display*, XDevice*);
   typedef int (*XSelectExtensionEvent_Func)(::Display*, ::Window, XEventClass*, int);
+  typedef XDeviceTimeCoord* (*XGetDeviceMotionEvents_Func)(::Display*, XDevice*, Time, Time, int*, int*, int*);
+  typedef void (*XFreeDeviceMotionEvents_Func)(XDeviceTimeCoord*);
+  typedef int (*XiGetDevicePresenceNotifyEvent_Func)(::Display*);
 
   XListInputDevices_Func XListInputDevices;
   XFreeDeviceList_Func XFreeDeviceList;
   XOpenDevice_Func XOpenDevice;
   XCloseDevice_Func XCloseDevice;
   XSelectExtensionEvent_Func XSelectExtensionEvent;
+  XGetDeviceMotionEvents_Func XGetDeviceMotionEvents;
+  XFreeDeviceMotionEvents_Func XFreeDeviceMotionEvents;
+  XiGetDevicePresenceNotifyEvent_Func XiGetDevicePresenceNotifyEvent;
 
 public:
   ~XInput();
@@ -44,21 +50,53 @@ public:
 
   void selectExtensionEvents(::Display* display, ::Window window);
   bool handleExtensionEvent(const XEvent& xevent);
+  // Returns true if the given event is a XI device presence
+  // notification (a device was plugged/unplugged). In that case the
+  // cached device list is marked as stale and the caller has to
+  // re-select the extension events on its window.
+  bool handlePresenceEvent(const XEvent& xevent);
   void convertExtensionEvent(const XEvent& xevent,
                              Event& ev,
                              int scale,
                              Time& time);
 
 private:
+  // Enumerates and opens the tablet devices the first time a window
+  // selects the extension events (so mouse-only sessions never pay
+  // the XOpenDevice round-trips), and again after a presence event
+  // marked the cached list as stale. The capabilities in m_info are
+  // shared by all windows.
+  void ensureDevices(::Display* display);
+  void closeDevices(::Display* display);
   void addEvent(int type, XEventClass eventClass, Event::Type ourEventype);
 
+  // Attaches the intra-frame motion history of the device (samples
+  // reported by the X server between the previous and this motion
+  // event) to the given MouseMove event, so the stroke renderer gets
+  // the full device report rate without one event-loop iteration per
+  // sample.
+  void attachMotionHistory(const XEvent& xevent, Event& ev, int scale);
+
   struct Info {
     PointerType pointerType;
     int minPressure = 0;
     int maxPressure = 1000;
+    // Axis ranges of the device (to map motion history samples, which
+    // come in device coordinates, to screen coordinates).
+    int minX = 0, maxX = 0;
+    int minY = 0, maxY = 0;
+    XDevice* device = nullptr;
+    Time lastMotionTime = 0;
   };
 
   base::dll m_xi = nullptr;
+  bool m_devicesScanned = false;
+  int m_presenceEventType = 0;
+  XEventClass m_presenceEventClass = 0;
+  // Serial of the last processed presence event (each window with the
+  // presence class selected receives its own copy of the same
+  // notification, we rescan the devices just once).
+  unsigned long m_lastPresenceSerial = 0;
   std::vector<XDevice*> m_openDevices;
   std::map<XID, Info> m_info;
   std::vector<XEventClass> m_eventClasses;